@@ -59,6 +59,14 @@ std::string GetCommandFilePath() { return GetIPCDirectory() + "command.txt"; }
 
 std::string GetStateFilePath() { return GetIPCDirectory() + "state.txt"; }
 
+std::string GetProfileFilePath() { return GetIPCDirectory() + "profile.txt"; }
+
+std::string GetProfileRequestPath() { return GetIPCDirectory() + "profile_request.txt"; }
+
+std::string GetTraceFilePath() { return GetIPCDirectory() + "trace.json"; }
+
+std::string GetTraceRequestPath() { return GetIPCDirectory() + "trace_request.txt"; }
+
 void Initialize() {
   if (s_initialized)
     return;
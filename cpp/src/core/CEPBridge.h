@@ -43,4 +43,14 @@ std::string GetIPCDirectory();
 std::string GetCommandFilePath();
 std::string GetStateFilePath();
 
+// Profiler report (written by the plugin, read by the panel) and the
+// panel's dump request (presence = dump now)
+std::string GetProfileFilePath();
+std::string GetProfileRequestPath();
+
+// Tracer output (Chrome trace_event JSON) and the panel's start / stop
+// request (presence = toggle)
+std::string GetTraceFilePath();
+std::string GetTraceRequestPath();
+
 } // namespace CEPBridge
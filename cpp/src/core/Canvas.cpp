@@ -0,0 +1,486 @@
+/*****************************************************************************
+ * Canvas.cpp
+ *
+ * Software rasterizer, PNG writer and GDI+ backend (see Canvas.h)
+ *****************************************************************************/
+
+#include "Canvas.h"
+
+#ifdef MSWindows
+#include "RenderContext.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CANVAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Canvas {
+
+#ifdef CANVAS_SSE2
+static bool s_simd = true;
+#else
+static bool s_simd = false;
+#endif
+
+bool HasSimd() {
+#ifdef CANVAS_SSE2
+  return true;
+#else
+  return false;
+#endif
+}
+
+void SetSimdEnabled(bool enabled) { s_simd = enabled && HasSimd(); }
+
+void Surface::Resize(int width, int height) {
+  m_width = width > 0 ? width : 0;
+  m_height = height > 0 ? height : 0;
+  m_pixels.assign((size_t)m_width * m_height, 0);
+}
+
+void Surface::Clear(Pixel color) { std::fill(m_pixels.begin(), m_pixels.end(), color); }
+
+void Surface::CopyFrom(const Surface &source, int x, int y) {
+  for (int row = 0; row < m_height; row++) {
+    Pixel *dst = Row(row);
+    std::fill(dst, dst + m_width, 0);
+    int sy = y + row;
+    if (sy < 0 || sy >= source.m_height)
+      continue;
+    int x0 = std::max(0, -x), x1 = std::min(m_width, source.m_width - x);
+    if (x0 < x1)
+      std::copy(source.Row(sy) + x + x0, source.Row(sy) + x + x1, dst + x0);
+  }
+}
+
+/*****************************************************************************
+ * Spans
+ *****************************************************************************/
+static void FillSpan(Pixel *dst, int count, Pixel color) {
+  int i = 0;
+#ifdef CANVAS_SSE2
+  if (s_simd) {
+    __m128i value = _mm_set1_epi32((int)color);
+    for (; i + 4 <= count; i += 4)
+      _mm_storeu_si128((__m128i *)(dst + i), value);
+  }
+#endif
+  for (; i < count; i++)
+    dst[i] = color;
+}
+
+static void BlendSpan(Pixel *dst, int count, Pixel color) {
+  uint32_t alpha = color >> 24;
+  if (alpha == 255) {
+    FillSpan(dst, count, color);
+    return;
+  }
+  if (alpha == 0)
+    return;
+  int i = 0;
+#ifdef CANVAS_SSE2
+  if (s_simd) {
+    // Same arithmetic as BlendPixel, 4 pixels (16 channels) per step
+    __m128i zero = _mm_setzero_si128();
+    __m128i inv = _mm_set1_epi16((short)(255 - alpha));
+    __m128i round = _mm_set1_epi16(128);
+    __m128i src = _mm_set1_epi32((int)color);
+    for (; i + 4 <= count; i += 4) {
+      __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+      __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv), round);
+      __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv), round);
+      lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+      hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+      _mm_storeu_si128((__m128i *)(dst + i), _mm_add_epi8(_mm_packus_epi16(lo, hi), src));
+    }
+  }
+#endif
+  for (; i < count; i++)
+    dst[i] = BlendPixel(dst[i], color);
+}
+
+// Coverage 0..1 of a pixel by `color`
+static inline void BlendCoverage(Pixel *dst, Pixel color, float coverage) {
+  uint32_t cover = (uint32_t)(coverage * 255.0f + 0.5f);
+  if (cover == 0)
+    return;
+  *dst = BlendPixel(*dst, cover >= 255 ? color : ScalePixel(color, cover));
+}
+
+// Integer rect clipped to the surface; false if empty
+static bool Clip(const Surface &surface, int &x, int &y, int &width, int &height) {
+  int right = std::min(x + width, surface.Width());
+  int bottom = std::min(y + height, surface.Height());
+  x = std::max(x, 0);
+  y = std::max(y, 0);
+  width = right - x;
+  height = bottom - y;
+  return width > 0 && height > 0;
+}
+
+void FillRect(Surface &surface, int x, int y, int width, int height, Pixel color) {
+  if (!Clip(surface, x, y, width, height))
+    return;
+  for (int row = y; row < y + height; row++)
+    FillSpan(surface.Row(row) + x, width, color);
+}
+
+void BlendRect(Surface &surface, int x, int y, int width, int height, Pixel color) {
+  if (!Clip(surface, x, y, width, height))
+    return;
+  for (int row = y; row < y + height; row++)
+    BlendSpan(surface.Row(row) + x, width, color);
+}
+
+/*****************************************************************************
+ * Anti-aliased shapes
+ *
+ * Coverage of a pixel = clamp(0.5 - d, 0, 1), d = signed distance from the
+ * pixel center to the shape edge (negative inside). Convex shapes scan each
+ * row in from both ends until full coverage; the inside is one solid span.
+ *****************************************************************************/
+static inline float Coverage(float distance) {
+  return distance <= -0.5f ? 1.0f : (distance >= 0.5f ? 0.0f : 0.5f - distance);
+}
+
+template <typename Distance>
+static void FillConvex(Surface &surface, float left, float top, float right, float bottom,
+                       Pixel color, Distance distance) {
+  int x0 = std::max((int)std::floor(left) - 1, 0);
+  int y0 = std::max((int)std::floor(top) - 1, 0);
+  int x1 = std::min((int)std::ceil(right) + 1, surface.Width());
+  int y1 = std::min((int)std::ceil(bottom) + 1, surface.Height());
+  for (int y = y0; y < y1; y++) {
+    Pixel *row = surface.Row(y);
+    float py = (float)y + 0.5f;
+    int lo = x0, hi = x1 - 1;
+    for (; lo <= hi; lo++) {
+      float coverage = Coverage(distance((float)lo + 0.5f, py));
+      if (coverage >= 1.0f)
+        break;
+      BlendCoverage(row + lo, color, coverage);
+    }
+    for (; hi > lo; hi--) {
+      float coverage = Coverage(distance((float)hi + 0.5f, py));
+      if (coverage >= 1.0f)
+        break;
+      BlendCoverage(row + hi, color, coverage);
+    }
+    if (lo <= hi)
+      BlendSpan(row + lo, hi - lo + 1, color);
+  }
+}
+
+void FillRoundRect(Surface &surface, float x, float y, float width, float height, float radius,
+                   Pixel color) {
+  if (width <= 0 || height <= 0)
+    return;
+  float halfW = width * 0.5f, halfH = height * 0.5f;
+  float r = std::max(0.0f, std::min(radius, std::min(halfW, halfH)));
+  float cx = x + halfW, cy = y + halfH;
+  FillConvex(surface, x, y, x + width, y + height, color, [=](float px, float py) {
+    float qx = std::fabs(px - cx) - (halfW - r);
+    float qy = std::fabs(py - cy) - (halfH - r);
+    float ox = std::max(qx, 0.0f), oy = std::max(qy, 0.0f);
+    return std::sqrt(ox * ox + oy * oy) + std::min(std::max(qx, qy), 0.0f) - r;
+  });
+}
+
+void FillEllipse(Surface &surface, float x, float y, float width, float height, Pixel color) {
+  if (width <= 0 || height <= 0)
+    return;
+  float rx = width * 0.5f, ry = height * 0.5f;
+  float cx = x + rx, cy = y + ry;
+  FillConvex(surface, x, y, x + width, y + height, color, [=](float px, float py) {
+    // First-order distance: f / |grad f|, f = (dx/rx)^2 + (dy/ry)^2 - 1
+    float nx = (px - cx) / rx, ny = (py - cy) / ry;
+    float f = nx * nx + ny * ny - 1.0f;
+    float gx = 2.0f * nx / rx, gy = 2.0f * ny / ry;
+    float grad = std::sqrt(gx * gx + gy * gy);
+    return grad > 1e-6f ? f / grad : -std::min(rx, ry);
+  });
+}
+
+void DrawEllipse(Surface &surface, float x, float y, float width, float height, float penWidth,
+                 Pixel color) {
+  if (width <= 0 || height <= 0)
+    return;
+  // Closed polyline, ~4 px segments
+  float rx = width * 0.5f, ry = height * 0.5f;
+  float cx = x + rx, cy = y + ry;
+  int segments = std::max(12, std::min(96, (int)std::ceil(3.14159265f * (rx + ry) / 4.0f)));
+  std::vector<float> points((size_t)(segments + 1) * 2);
+  for (int i = 0; i <= segments; i++) {
+    float angle = 6.28318531f * (float)(i % segments) / segments;
+    points[i * 2] = cx + rx * std::cos(angle);
+    points[i * 2 + 1] = cy + ry * std::sin(angle);
+  }
+  DrawPolyline(surface, points.data(), segments + 1, penWidth, color);
+}
+
+// Distance from (px, py) to segment a-b
+static inline float SegmentDistance(float px, float py, float ax, float ay, float bx, float by) {
+  float dx = bx - ax, dy = by - ay;
+  float lengthSq = dx * dx + dy * dy;
+  float t = lengthSq > 0 ? ((px - ax) * dx + (py - ay) * dy) / lengthSq : 0.0f;
+  t = std::max(0.0f, std::min(1.0f, t));
+  float ex = px - (ax + t * dx), ey = py - (ay + t * dy);
+  return std::sqrt(ex * ex + ey * ey);
+}
+
+void DrawLine(Surface &surface, float x0, float y0, float x1, float y1, float width, Pixel color) {
+  float half = std::max(width, 1.0f) * 0.5f;
+  FillConvex(surface, std::min(x0, x1) - half, std::min(y0, y1) - half, std::max(x0, x1) + half,
+             std::max(y0, y1) + half, color, [=](float px, float py) {
+               return SegmentDistance(px, py, x0, y0, x1, y1) - half;
+             });
+}
+
+void DrawPolyline(Surface &surface, const float *xy, int pointCount, float width, Pixel color) {
+  if (pointCount < 2)
+    return;
+  if (pointCount == 2) {
+    DrawLine(surface, xy[0], xy[1], xy[2], xy[3], width, color);
+    return;
+  }
+  float half = std::max(width, 1.0f) * 0.5f;
+  float left = xy[0], top = xy[1], right = xy[0], bottom = xy[1];
+  for (int i = 1; i < pointCount; i++) {
+    left = std::min(left, xy[i * 2]);
+    right = std::max(right, xy[i * 2]);
+    top = std::min(top, xy[i * 2 + 1]);
+    bottom = std::max(bottom, xy[i * 2 + 1]);
+  }
+  // Not convex: every pixel of the box, nearest segment
+  int x0 = std::max((int)std::floor(left - half) - 1, 0);
+  int y0 = std::max((int)std::floor(top - half) - 1, 0);
+  int x1 = std::min((int)std::ceil(right + half) + 1, surface.Width());
+  int y1 = std::min((int)std::ceil(bottom + half) + 1, surface.Height());
+  float reach = half + 0.5f;
+  for (int y = y0; y < y1; y++) {
+    Pixel *row = surface.Row(y);
+    float py = (float)y + 0.5f;
+    for (int x = x0; x < x1; x++) {
+      float px = (float)x + 0.5f;
+      float nearest = reach;
+      for (int i = 0; i + 1 < pointCount; i++) {
+        const float *a = xy + i * 2;
+        // Segment box rejection
+        if (px < std::min(a[0], a[2]) - reach || px > std::max(a[0], a[2]) + reach ||
+            py < std::min(a[1], a[3]) - reach || py > std::max(a[1], a[3]) + reach)
+          continue;
+        nearest = std::min(nearest, SegmentDistance(px, py, a[0], a[1], a[2], a[3]));
+      }
+      if (nearest < reach)
+        BlendCoverage(row + x, color, Coverage(nearest - half));
+    }
+  }
+}
+
+void DrawBezier(Surface &surface, float x0, float y0, float x1, float y1, float x2, float y2,
+                float x3, float y3, float width, Pixel color) {
+  float hull = std::hypot(x1 - x0, y1 - y0) + std::hypot(x2 - x1, y2 - y1) +
+               std::hypot(x3 - x2, y3 - y2);
+  int segments = std::max(1, std::min(64, (int)std::ceil(hull / 4.0f)));
+  std::vector<float> points((size_t)(segments + 1) * 2);
+  for (int i = 0; i <= segments; i++) {
+    float t = (float)i / segments, u = 1.0f - t;
+    float b0 = u * u * u, b1 = 3 * u * u * t, b2 = 3 * u * t * t, b3 = t * t * t;
+    points[i * 2] = b0 * x0 + b1 * x1 + b2 * x2 + b3 * x3;
+    points[i * 2 + 1] = b0 * y0 + b1 * y1 + b2 * y2 + b3 * y3;
+  }
+  DrawPolyline(surface, points.data(), segments + 1, width, color);
+}
+
+/*****************************************************************************
+ * Text
+ *****************************************************************************/
+class BoxText : public TextRenderer {
+public:
+  float Measure(const wchar_t *text, float size) override {
+    size_t length = 0;
+    while (text && text[length])
+      length++;
+    return (float)length * size * 0.55f;
+  }
+
+  void Draw(Surface &surface, float x, float y, const wchar_t *text, float size,
+            Pixel color) override {
+    float advance = size * 0.55f;
+    for (size_t i = 0; text && text[i]; i++, x += advance) {
+      wchar_t c = text[i];
+      if (c == L' ')
+        continue;
+      // Capitals / digits are taller than lowercase
+      bool tall = (c >= L'A' && c <= L'Z') || (c >= L'0' && c <= L'9');
+      float glyphTop = y + size * (tall ? 0.15f : 0.35f);
+      BlendRect(surface, (int)std::lround(x + advance * 0.1f), (int)std::lround(glyphTop),
+                (int)std::lround(advance * 0.75f), (int)std::lround(y + size * 0.85f - glyphTop),
+                color);
+    }
+  }
+};
+
+static BoxText s_boxText;
+static TextRenderer *s_textRenderer = &s_boxText;
+
+TextRenderer &SoftwareText() { return s_boxText; }
+
+void SetTextRenderer(TextRenderer *renderer) {
+  s_textRenderer = renderer ? renderer : &s_boxText;
+}
+
+float MeasureString(const wchar_t *text, float size) {
+  return s_textRenderer->Measure(text, size);
+}
+
+void DrawString(Surface &surface, float x, float y, const wchar_t *text, float size, Pixel color) {
+  s_textRenderer->Draw(surface, x, y, text, size, color);
+}
+
+/*****************************************************************************
+ * PNG
+ *****************************************************************************/
+static uint32_t Crc32(const uint8_t *data, size_t size, uint32_t crc = 0) {
+  static uint32_t table[256];
+  static bool ready = false;
+  if (!ready) {
+    for (uint32_t n = 0; n < 256; n++) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; k++)
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      table[n] = c;
+    }
+    ready = true;
+  }
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++)
+    crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+static void PutBigEndian(std::vector<uint8_t> &out, uint32_t value) {
+  out.push_back((uint8_t)(value >> 24));
+  out.push_back((uint8_t)(value >> 16));
+  out.push_back((uint8_t)(value >> 8));
+  out.push_back((uint8_t)value);
+}
+
+static void PutChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data) {
+  PutBigEndian(out, (uint32_t)data.size());
+  size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  PutBigEndian(out, Crc32(&out[start], out.size() - start));
+}
+
+std::vector<uint8_t> EncodePng(const Surface &surface) {
+  int width = surface.Width(), height = surface.Height();
+
+  // Scanlines: filter 0 + straight RGBA
+  std::vector<uint8_t> raw;
+  raw.reserve((size_t)height * (width * 4 + 1));
+  for (int y = 0; y < height; y++) {
+    raw.push_back(0);
+    const Pixel *row = surface.Row(y);
+    for (int x = 0; x < width; x++) {
+      uint32_t a = row[x] >> 24;
+      uint32_t channels[3] = {(row[x] >> 16) & 0xFF, (row[x] >> 8) & 0xFF, row[x] & 0xFF};
+      for (uint32_t c : channels)
+        raw.push_back((uint8_t)(a ? std::min<uint32_t>(255, (c * 255 + a / 2) / a) : 0));
+      raw.push_back((uint8_t)a);
+    }
+  }
+
+  // zlib stream of stored blocks
+  std::vector<uint8_t> zlib = {0x78, 0x01};
+  size_t offset = 0;
+  do {
+    size_t size = std::min<size_t>(raw.size() - offset, 65535);
+    bool last = offset + size == raw.size();
+    zlib.push_back(last ? 1 : 0);
+    zlib.push_back((uint8_t)size);
+    zlib.push_back((uint8_t)(size >> 8));
+    zlib.push_back((uint8_t)~size);
+    zlib.push_back((uint8_t)(~size >> 8));
+    zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + size);
+    offset += size;
+  } while (offset < raw.size());
+  uint32_t s1 = 1, s2 = 0;
+  for (uint8_t byte : raw) {
+    s1 = (s1 + byte) % 65521;
+    s2 = (s2 + s1) % 65521;
+  }
+  PutBigEndian(zlib, (s2 << 16) | s1);
+
+  static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  std::vector<uint8_t> png(SIGNATURE, SIGNATURE + 8);
+  std::vector<uint8_t> header;
+  PutBigEndian(header, (uint32_t)width);
+  PutBigEndian(header, (uint32_t)height);
+  header.insert(header.end(), {8, 6, 0, 0, 0}); // 8 bit RGBA, no interlace
+  PutChunk(png, "IHDR", header);
+  PutChunk(png, "IDAT", zlib);
+  PutChunk(png, "IEND", std::vector<uint8_t>());
+  return png;
+}
+
+bool WritePng(const Surface &surface, const std::string &path) {
+  std::vector<uint8_t> png = EncodePng(surface);
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  bool ok = fwrite(png.data(), 1, png.size(), file) == png.size();
+  return fclose(file) == 0 && ok;
+}
+
+/*****************************************************************************
+ * GDI+ backend
+ *****************************************************************************/
+#ifdef MSWindows
+
+void Blit(const Surface &surface, HDC target, int x, int y) {
+  if (surface.Width() == 0 || surface.Height() == 0)
+    return;
+  // Wraps the pixels (GDI+ only reads them)
+  Gdiplus::Bitmap bitmap(surface.Width(), surface.Height(), surface.Width() * 4,
+                         PixelFormat32bppPARGB, (BYTE *)const_cast<Pixel *>(surface.Data()));
+  Gdiplus::Graphics graphics(target);
+  graphics.DrawImage(&bitmap, x, y, surface.Width(), surface.Height());
+}
+
+float GdiplusText::Measure(const wchar_t *text, float size) {
+  Gdiplus::Bitmap bitmap(1, 1, PixelFormat32bppPARGB);
+  Gdiplus::Graphics graphics(&bitmap);
+  Gdiplus::RectF bounds;
+  graphics.MeasureString(text, -1, RenderContext::Font(size), Gdiplus::PointF(0, 0), &bounds);
+  return bounds.Width;
+}
+
+void GdiplusText::Draw(Surface &surface, float x, float y, const wchar_t *text, float size,
+                       Pixel color) {
+  if (surface.Width() == 0 || surface.Height() == 0)
+    return;
+  uint32_t a = color >> 24;
+  if (a == 0)
+    return;
+  // GDI+ brushes take straight alpha
+  auto straight = [a](uint32_t c) { return (BYTE)std::min<uint32_t>(255, (c * 255 + a / 2) / a); };
+  Gdiplus::Color textColor((BYTE)a, straight((color >> 16) & 0xFF), straight((color >> 8) & 0xFF),
+                           straight(color & 0xFF));
+  Gdiplus::Bitmap bitmap(surface.Width(), surface.Height(), surface.Width() * 4,
+                         PixelFormat32bppPARGB, (BYTE *)surface.Data());
+  Gdiplus::Graphics graphics(&bitmap);
+  graphics.SetTextRenderingHint(Gdiplus::TextRenderingHintAntiAlias); // No ClearType on alpha
+  graphics.DrawString(text, -1, RenderContext::Font(size), Gdiplus::PointF(x, y),
+                      RenderContext::Brush(textColor));
+}
+
+#endif // MSWindows
+
+} // namespace Canvas
@@ -0,0 +1,188 @@
+/*****************************************************************************
+ * Canvas.h
+ *
+ * Platform-neutral software 2D canvas
+ *
+ * Panels drawn straight to GDI / GDI+ can only be seen (and timed) inside
+ * AE on Windows. Canvas rasterizes into a plain pixel surface instead; the
+ * result is either blitted to a window (GDI+ backend, Windows) or written
+ * to PNG (software backend, any platform: bench / CI). The grid window
+ * (GridPaint) and the control panel (ControlPaint) render through it.
+ *
+ *   Canvas::Surface surface(280, 420);
+ *   surface.Clear(Canvas::Argb(255, 30, 30, 36));
+ *   Canvas::FillRoundRect(surface, 4, 40, 272, 28, 4, Canvas::Argb(255, 50, 50, 60));
+ *   Canvas::DrawLine(surface, 10, 10, 60, 30, 1.5f, Canvas::Argb(255, 74, 158, 255));
+ *   Canvas::DrawString(surface, 30, 44, L"Gaussian Blur", 12, Canvas::Argb(255, 220, 220, 220));
+ *   Canvas::Blit(surface, hdc, 0, 0);           // Windows
+ *   Canvas::WritePng(surface, "panel.png");      // Headless
+ *
+ * Pixels are premultiplied ARGB (0xAARRGGBB, BGRA in memory like a 32 bpp
+ * DIB / PixelFormat32bppPARGB). Drawing is source-over; shapes and lines
+ * are anti-aliased from per-pixel coverage, rectangles on integer pixels
+ * are not. Solid spans use SSE2 when the compiler targets it (x64 always),
+ * with a scalar path that gives the same pixels.
+ *
+ * Text is abstract (TextRenderer): the default software renderer draws a
+ * box per character with a fixed advance, enough for layout and cost; on
+ * Windows GdiplusText renders real glyphs into the same surface.
+ *
+ * Not thread-safe per surface; the text renderer setting is global (main
+ * thread).
+ *****************************************************************************/
+
+#pragma once
+
+#include "GdiPlusIncludes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Canvas {
+
+typedef uint32_t Pixel; // Premultiplied 0xAARRGGBB
+
+// Straight alpha components -> premultiplied pixel
+inline Pixel Argb(uint32_t a, uint32_t r, uint32_t g, uint32_t b) {
+  r = (r * a + 127) / 255;
+  g = (g * a + 127) / 255;
+  b = (b * a + 127) / 255;
+  return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// x * a / 255, rounded (exact for 0..255 * 0..255)
+inline uint32_t MulDiv255(uint32_t x, uint32_t a) {
+  uint32_t t = x * a + 128;
+  return (t + (t >> 8)) >> 8;
+}
+
+// Source-over of one premultiplied pixel (reference for the SIMD spans)
+inline Pixel BlendPixel(Pixel dst, Pixel src) {
+  uint32_t inv = 255 - (src >> 24);
+  uint32_t a = (src >> 24) + MulDiv255(dst >> 24, inv);
+  uint32_t r = ((src >> 16) & 0xFF) + MulDiv255((dst >> 16) & 0xFF, inv);
+  uint32_t g = ((src >> 8) & 0xFF) + MulDiv255((dst >> 8) & 0xFF, inv);
+  uint32_t b = (src & 0xFF) + MulDiv255(dst & 0xFF, inv);
+  return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// Premultiplied pixel scaled by a coverage (0..255)
+inline Pixel ScalePixel(Pixel color, uint32_t coverage) {
+  return (MulDiv255(color >> 24, coverage) << 24) |
+         (MulDiv255((color >> 16) & 0xFF, coverage) << 16) |
+         (MulDiv255((color >> 8) & 0xFF, coverage) << 8) | MulDiv255(color & 0xFF, coverage);
+}
+
+class Surface {
+public:
+  Surface() = default;
+  Surface(int width, int height) { Resize(width, height); }
+
+  // Contents are cleared to transparent
+  void Resize(int width, int height);
+  void Clear(Pixel color);
+  // This surface's size of `source` at (x, y), no blending (outside: transparent)
+  void CopyFrom(const Surface &source, int x, int y);
+
+  int Width() const { return m_width; }
+  int Height() const { return m_height; }
+  Pixel *Row(int y) { return &m_pixels[(size_t)y * m_width]; }
+  const Pixel *Row(int y) const { return &m_pixels[(size_t)y * m_width]; }
+  Pixel At(int x, int y) const { return m_pixels[(size_t)y * m_width + x]; }
+  Pixel *Data() { return m_pixels.data(); }
+  const Pixel *Data() const { return m_pixels.data(); }
+  size_t Bytes() const { return m_pixels.size() * sizeof(Pixel); }
+
+private:
+  int m_width = 0;
+  int m_height = 0;
+  std::vector<Pixel> m_pixels;
+};
+
+// SSE2 spans (compiled in when the target has SSE2); disable to time the
+// scalar path
+bool HasSimd();
+void SetSimdEnabled(bool enabled);
+
+/*****************************************************************************
+ * Primitives (clipped to the surface)
+ *****************************************************************************/
+
+// Replace pixels (no blending)
+void FillRect(Surface &surface, int x, int y, int width, int height, Pixel color);
+
+// Source-over a solid color
+void BlendRect(Surface &surface, int x, int y, int width, int height, Pixel color);
+
+// Anti-aliased rounded rectangle (radius 0: a rectangle with AA edges)
+void FillRoundRect(Surface &surface, float x, float y, float width, float height, float radius,
+                   Pixel color);
+
+// Anti-aliased ellipse inside the given box
+void FillEllipse(Surface &surface, float x, float y, float width, float height, Pixel color);
+
+// Anti-aliased ellipse outline centered on the box edge
+void DrawEllipse(Surface &surface, float x, float y, float width, float height, float penWidth,
+                 Pixel color);
+
+// Anti-aliased line, round caps
+void DrawLine(Surface &surface, float x0, float y0, float x1, float y1, float width, Pixel color);
+
+// Anti-aliased open polyline, round joins (each pixel blended once)
+void DrawPolyline(Surface &surface, const float *xy, int pointCount, float width, Pixel color);
+
+// Cubic bezier, flattened to a polyline (~4 px segments)
+void DrawBezier(Surface &surface, float x0, float y0, float x1, float y1, float x2, float y2,
+                float x3, float y3, float width, Pixel color);
+
+/*****************************************************************************
+ * Text
+ *****************************************************************************/
+
+class TextRenderer {
+public:
+  virtual ~TextRenderer() = default;
+  // Advance width of `text` in pixels
+  virtual float Measure(const wchar_t *text, float size) = 0;
+  // (x, y): top-left of the line box (height = size)
+  virtual void Draw(Surface &surface, float x, float y, const wchar_t *text, float size,
+                    Pixel color) = 0;
+};
+
+// Box per character, advance 0.55 * size (spaces are blank)
+TextRenderer &SoftwareText();
+
+// NULL: SoftwareText()
+void SetTextRenderer(TextRenderer *renderer);
+
+// (Not DrawText / MeasureText: windows.h macros)
+float MeasureString(const wchar_t *text, float size);
+void DrawString(Surface &surface, float x, float y, const wchar_t *text, float size, Pixel color);
+
+/*****************************************************************************
+ * Backends
+ *****************************************************************************/
+
+// Straight-alpha RGBA PNG (stored deflate blocks: fast, larger files)
+std::vector<uint8_t> EncodePng(const Surface &surface);
+bool WritePng(const Surface &surface, const std::string &path);
+
+#ifdef MSWindows
+
+// Composite the surface onto a DC at (x, y) with GDI+ (PARGB, no copy)
+void Blit(const Surface &surface, HDC target, int x, int y);
+
+// Real glyphs: GDI+ DrawString into the surface (Segoe UI, pooled fonts:
+// needs RenderContext::Acquire)
+class GdiplusText : public TextRenderer {
+public:
+  float Measure(const wchar_t *text, float size) override;
+  void Draw(Surface &surface, float x, float y, const wchar_t *text, float size,
+            Pixel color) override;
+};
+
+#endif // MSWindows
+
+} // namespace Canvas
@@ -0,0 +1,458 @@
+/*****************************************************************************
+ * CatalogCache.cpp
+ *
+ * Persistent, memory-mapped catalogs (see CatalogCache.h)
+ *****************************************************************************/
+
+#include "CatalogCache.h"
+#include "ScriptBuilder.h"
+#include "WireFormat.h"
+
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#ifdef MSWindows
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CatalogCache {
+
+namespace fs = std::filesystem;
+
+static const char MAGIC[4] = {'A', 'S', 'C', 'C'};
+
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t fieldCount;
+  uint32_t recordCount;
+  uint32_t poolUnits;
+  uint32_t reserved;
+  uint64_t fingerprint;
+  char hostBuild[HOST_BUILD_BYTES];
+  char language[LANGUAGE_BYTES];
+};
+static_assert(sizeof(FileHeader) == 64, "catalog header must stay 64 bytes");
+
+static const size_t REF_BYTES = 2 * sizeof(uint32_t);
+
+static std::string_view HeaderText(const char *text, size_t capacity) {
+  size_t n = 0;
+  while (n < capacity && text[n])
+    n++;
+  return std::string_view(text, n);
+}
+
+static void CopyHeaderText(char *out, size_t capacity, std::string_view text) {
+  memset(out, 0, capacity);
+  memcpy(out, text.data(), text.size() < capacity ? text.size() : capacity);
+}
+
+void AppendUtf16(std::u16string &out, std::string_view utf8) {
+  const unsigned char *s = (const unsigned char *)utf8.data();
+  for (size_t i = 0; i < utf8.size();) {
+    unsigned cp = ScriptBuilder::detail::DecodeUtf8(s, utf8.size(), i);
+    if (cp > 0xFFFF) {
+      cp -= 0x10000;
+      out += (char16_t)(0xD800 + (cp >> 10));
+      out += (char16_t)(0xDC00 + (cp & 0x3FF));
+    } else {
+      out += (char16_t)cp;
+    }
+  }
+}
+
+std::u16string ToUtf16(std::string_view utf8) {
+  std::u16string out;
+  out.reserve(utf8.size());
+  AppendUtf16(out, utf8);
+  return out;
+}
+
+uint64_t Hash64(const void *data, size_t size, uint64_t seed) {
+  const unsigned char *p = (const unsigned char *)data;
+  uint64_t h = seed;
+  for (size_t i = 0; i < size; i++) {
+    h ^= p[i];
+    h *= 0x100000001b3ULL;
+  }
+  return h;
+}
+
+// ---------------------------------------------------------------------------
+// Builder
+// ---------------------------------------------------------------------------
+
+Builder::Builder(uint32_t fieldCount)
+    : m_fieldCount(fieldCount < 1 ? 1
+                   : fieldCount > WireFormat::MAX_FIELDS
+                       ? (uint32_t)WireFormat::MAX_FIELDS
+                       : fieldCount) {}
+
+void Builder::Intern(std::u16string_view text) {
+  // Keyed by hash; candidates are compared against the pool (no key copies)
+  uint64_t hash = Hash64(text.data(), text.size() * sizeof(char16_t));
+  auto range = m_interned.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    uint32_t offset = (uint32_t)(it->second >> 32);
+    uint32_t length = (uint32_t)it->second;
+    if (length == text.size() &&
+        std::u16string_view(m_pool.data() + offset, length) == text) {
+      m_refs.push_back(offset);
+      m_refs.push_back(length);
+      return;
+    }
+  }
+
+  uint32_t offset = (uint32_t)m_pool.size();
+  uint32_t length = (uint32_t)text.size();
+  m_pool.append(text.data(), text.size());
+  m_interned.emplace(hash, ((uint64_t)offset << 32) | length);
+  m_refs.push_back(offset);
+  m_refs.push_back(length);
+}
+
+void Builder::AddRecord(const std::string_view *fields) {
+  for (uint32_t f = 0; f < m_fieldCount; f++) {
+    m_scratch.clear();
+    AppendUtf16(m_scratch, fields[f]);
+    Intern(m_scratch);
+  }
+  m_recordCount++;
+}
+
+void Builder::AddRecord(const std::u16string_view *fields) {
+  for (uint32_t f = 0; f < m_fieldCount; f++)
+    Intern(fields[f]);
+  m_recordCount++;
+}
+
+size_t Builder::AddFromWire(std::string_view wire) {
+  WireFormat::Reader reader(wire);
+  std::string_view fields[WireFormat::MAX_FIELDS];
+  size_t added = 0;
+  while (reader.Next()) {
+    if (reader.FieldCount() < m_fieldCount)
+      continue;
+    for (uint32_t f = 0; f < m_fieldCount; f++)
+      fields[f] = reader.String(f);
+    AddRecord(fields);
+    added++;
+  }
+  return added;
+}
+
+std::vector<uint8_t> Builder::Finish(const Key &key) const {
+  FileHeader header;
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = FORMAT_VERSION;
+  header.fieldCount = m_fieldCount;
+  header.recordCount = m_recordCount;
+  header.poolUnits = (uint32_t)m_pool.size();
+  header.reserved = 0;
+  header.fingerprint = key.fingerprint;
+  CopyHeaderText(header.hostBuild, HOST_BUILD_BYTES, key.hostBuild);
+  CopyHeaderText(header.language, LANGUAGE_BYTES, key.language);
+
+  size_t refBytes = m_refs.size() * sizeof(uint32_t);
+  size_t poolBytes = m_pool.size() * sizeof(char16_t);
+  std::vector<uint8_t> image(sizeof(header) + refBytes + poolBytes);
+  memcpy(image.data(), &header, sizeof(header));
+  if (refBytes)
+    memcpy(image.data() + sizeof(header), m_refs.data(), refBytes);
+  if (poolBytes)
+    memcpy(image.data() + sizeof(header) + refBytes, m_pool.data(), poolBytes);
+  return image;
+}
+
+// ---------------------------------------------------------------------------
+// Catalog
+// ---------------------------------------------------------------------------
+
+static const FileHeader *Header(const uint8_t *data) {
+  return reinterpret_cast<const FileHeader *>(data);
+}
+
+bool Catalog::Validate() const {
+  if (!m_data || m_size < sizeof(FileHeader))
+    return false;
+  const FileHeader *h = Header(m_data);
+  if (memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      h->version != FORMAT_VERSION || h->fieldCount < 1 ||
+      h->fieldCount > WireFormat::MAX_FIELDS)
+    return false;
+  uint64_t expected = sizeof(FileHeader) +
+                      (uint64_t)h->recordCount * h->fieldCount * REF_BYTES +
+                      (uint64_t)h->poolUnits * sizeof(char16_t);
+  return expected == m_size;
+}
+
+bool Catalog::Open(const fs::path &path) {
+  Close();
+
+#ifdef MSWindows
+  HANDLE file = CreateFileW(path.c_str(), GENERIC_READ,
+                            FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(FileHeader)) {
+    CloseHandle(file);
+    return false;
+  }
+  HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+  CloseHandle(file); // The mapping keeps the file open
+  if (!mapping)
+    return false;
+  const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (!view) {
+    CloseHandle(mapping);
+    return false;
+  }
+  m_mapping = mapping;
+  m_data = static_cast<const uint8_t *>(view);
+  m_size = (size_t)size.QuadPart;
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(FileHeader)) {
+    close(fd);
+    return false;
+  }
+  void *view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // The mapping keeps the file open
+  if (view == MAP_FAILED)
+    return false;
+  m_data = static_cast<const uint8_t *>(view);
+  m_size = (size_t)st.st_size;
+#endif
+  m_mapped = true;
+
+  if (!Validate()) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+bool Catalog::Adopt(std::vector<uint8_t> image) {
+  Close();
+  m_image = std::move(image);
+  m_data = m_image.data();
+  m_size = m_image.size();
+  if (!Validate()) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void Catalog::Close() {
+  if (m_mapped && m_data) {
+#ifdef MSWindows
+    UnmapViewOfFile(m_data);
+    if (m_mapping)
+      CloseHandle((HANDLE)m_mapping);
+#else
+    munmap(const_cast<uint8_t *>(m_data), m_size);
+#endif
+  }
+  m_data = nullptr;
+  m_size = 0;
+  m_mapping = nullptr;
+  m_mapped = false;
+  m_image.clear();
+  m_image.shrink_to_fit();
+}
+
+void Catalog::MoveFrom(Catalog &other) {
+  // Vector storage moves with its buffer, so m_data stays valid
+  m_image = std::move(other.m_image);
+  m_data = other.m_data;
+  m_size = other.m_size;
+  m_mapping = other.m_mapping;
+  m_mapped = other.m_mapped;
+
+  other.m_data = nullptr;
+  other.m_size = 0;
+  other.m_mapping = nullptr;
+  other.m_mapped = false;
+}
+
+bool Catalog::SetKey(const Key &key) {
+  if (!IsOpen() || m_mapped)
+    return false;
+  FileHeader *h = reinterpret_cast<FileHeader *>(m_image.data());
+  h->fingerprint = key.fingerprint;
+  CopyHeaderText(h->hostBuild, HOST_BUILD_BYTES, key.hostBuild);
+  CopyHeaderText(h->language, LANGUAGE_BYTES, key.language);
+  return true;
+}
+
+bool Catalog::Matches(const Key &key, bool checkFingerprint) const {
+  if (!IsOpen())
+    return false;
+  std::string_view build = key.hostBuild;
+  std::string_view language = key.language;
+  if (build.size() > HOST_BUILD_BYTES)
+    build = build.substr(0, HOST_BUILD_BYTES);
+  if (language.size() > LANGUAGE_BYTES)
+    language = language.substr(0, LANGUAGE_BYTES);
+  return HostBuild() == build && Language() == language &&
+         (!checkFingerprint || Fingerprint() == key.fingerprint);
+}
+
+std::string_view Catalog::HostBuild() const {
+  return IsOpen() ? HeaderText(Header(m_data)->hostBuild, HOST_BUILD_BYTES)
+                  : std::string_view();
+}
+
+std::string_view Catalog::Language() const {
+  return IsOpen() ? HeaderText(Header(m_data)->language, LANGUAGE_BYTES)
+                  : std::string_view();
+}
+
+uint64_t Catalog::Fingerprint() const {
+  return IsOpen() ? Header(m_data)->fingerprint : 0;
+}
+
+uint32_t Catalog::RecordCount() const {
+  return IsOpen() ? Header(m_data)->recordCount : 0;
+}
+
+uint32_t Catalog::FieldCount() const {
+  return IsOpen() ? Header(m_data)->fieldCount : 0;
+}
+
+std::u16string_view Catalog::Field(uint32_t record, uint32_t field) const {
+  if (!IsOpen())
+    return std::u16string_view();
+  const FileHeader *h = Header(m_data);
+  if (record >= h->recordCount || field >= h->fieldCount)
+    return std::u16string_view();
+
+  const uint32_t *refs =
+      reinterpret_cast<const uint32_t *>(m_data + sizeof(FileHeader));
+  size_t ref = ((size_t)record * h->fieldCount + field) * 2;
+  uint32_t offset = refs[ref];
+  uint32_t length = refs[ref + 1];
+  if (offset > h->poolUnits || length > h->poolUnits - offset)
+    return std::u16string_view();
+
+  const char16_t *pool = reinterpret_cast<const char16_t *>(
+      m_data + sizeof(FileHeader) +
+      (size_t)h->recordCount * h->fieldCount * REF_BYTES);
+  return std::u16string_view(pool + offset, length);
+}
+
+static const bool WIDE_IS_UTF16 = sizeof(wchar_t) == 2;
+
+size_t Catalog::FieldInto(uint32_t record, uint32_t field, wchar_t *out,
+                          size_t outCount) const {
+  if (!out || outCount == 0)
+    return 0;
+  std::u16string_view s = Field(record, field);
+  size_t n = 0;
+  for (size_t i = 0; i < s.size(); i++) {
+    char16_t u = s[i];
+    bool pair = u >= 0xD800 && u <= 0xDBFF && i + 1 < s.size() &&
+                s[i + 1] >= 0xDC00 && s[i + 1] <= 0xDFFF;
+    if (pair && WIDE_IS_UTF16) {
+      // Never split a surrogate pair at the buffer end
+      if (n + 2 >= outCount)
+        break;
+      out[n++] = (wchar_t)u;
+      out[n++] = (wchar_t)s[++i];
+    } else {
+      if (n + 1 >= outCount)
+        break;
+      if (pair) {
+        out[n++] = (wchar_t)(0x10000 + ((u - 0xD800) << 10) + (s[i + 1] - 0xDC00));
+        i++;
+      } else {
+        out[n++] = (wchar_t)u;
+      }
+    }
+  }
+  out[n] = L'\0';
+  return n;
+}
+
+std::wstring Catalog::WideField(uint32_t record, uint32_t field) const {
+  std::u16string_view s = Field(record, field);
+  std::wstring out(s.size() + 1, L'\0');
+  out.resize(FieldInto(record, field, &out[0], out.size()));
+  return out;
+}
+
+// ---------------------------------------------------------------------------
+// Files
+// ---------------------------------------------------------------------------
+
+bool WriteFile(const fs::path &path, const uint8_t *data, size_t size) {
+  std::error_code ec;
+  if (path.has_parent_path())
+    fs::create_directories(path.parent_path(), ec);
+
+  fs::path temp = path;
+  temp += ".tmp";
+  {
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+    out.write(reinterpret_cast<const char *>(data), (std::streamsize)size);
+    if (!out)
+      return false;
+  }
+  fs::rename(temp, path, ec);
+  if (ec) {
+    fs::remove(temp, ec);
+    return false;
+  }
+  return true;
+}
+
+uint64_t HashFolderListing(const std::vector<std::string> &utf8Folders) {
+  uint64_t sum = 0;
+  uint64_t count = 0;
+  for (const std::string &folder : utf8Folders) {
+    std::error_code ec;
+    fs::path root = fs::u8path(folder);
+    if (!fs::is_directory(root, ec))
+      continue;
+
+    fs::recursive_directory_iterator it(
+        root, fs::directory_options::skip_permission_denied, ec);
+    fs::recursive_directory_iterator end;
+    for (; !ec && it != end; it.increment(ec)) {
+      std::error_code entryEc;
+      if (!it->is_regular_file(entryEc))
+        continue;
+      std::string name = it->path().u8string();
+      uint64_t size = (uint64_t)it->file_size(entryEc);
+      int64_t mtime =
+          (int64_t)it->last_write_time(entryEc).time_since_epoch().count();
+
+      uint64_t h = Hash64(name.data(), name.size());
+      h = Hash64(&size, sizeof(size), h);
+      h = Hash64(&mtime, sizeof(mtime), h);
+      // Sum of per-entry hashes: independent of directory walk order
+      sum += h;
+      count++;
+    }
+  }
+  uint64_t h = Hash64(&sum, sizeof(sum));
+  return Hash64(&count, sizeof(count), h);
+}
+
+} // namespace CatalogCache
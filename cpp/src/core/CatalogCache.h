@@ -0,0 +1,175 @@
+/*****************************************************************************
+ * CatalogCache.h
+ *
+ * Persistent, memory-mapped catalogs (effects list, fonts list)
+ *
+ * A catalog is a table of string records (e.g. name / matchName / category)
+ * built once from a script result and saved next to settings.json. Later
+ * sessions map the file and read it in place, so startup never has to run
+ * the catalog script again while the cache key still matches.
+ *
+ * File layout (little-endian):
+ *   Header       fixed 64 bytes (magic, version, counts, key)
+ *   Field refs   recordCount * fieldCount * {uint32 offset, uint32 length}
+ *   String pool  UTF-16 code units, each distinct string stored once
+ *
+ * Reads are bounds-checked per field, so a damaged file can only yield
+ * empty strings, never an out-of-range read.
+ *
+ * Platform-neutral: Windows file mapping / POSIX mmap.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace CatalogCache {
+
+// Bump when the file layout changes (older files are then ignored)
+const uint32_t FORMAT_VERSION = 1;
+
+// Key text limits (stored in the fixed header, longer text is cut)
+const size_t HOST_BUILD_BYTES = 24;
+const size_t LANGUAGE_BYTES = 8;
+
+/**
+ * Cache identity
+ * hostBuild/language must match to use a cache at all; the fingerprint
+ * (plugin folder listing, font list) is revalidated after loading.
+ */
+struct Key {
+  std::string hostBuild; // app.version
+  std::string language;  // app.isoLanguage
+  uint64_t fingerprint = 0;
+};
+
+/**
+ * Builds a catalog image (the exact file bytes)
+ *   CatalogCache::Builder builder(3);
+ *   builder.AddFromWire(result.View());
+ *   std::vector<uint8_t> image = builder.Finish(key);
+ */
+class Builder {
+public:
+  explicit Builder(uint32_t fieldCount);
+
+  // Append one record of fieldCount UTF-8 strings
+  void AddRecord(const std::string_view *fields);
+
+  // Append one record of fieldCount UTF-16 strings (copy from a Catalog)
+  void AddRecord(const std::u16string_view *fields);
+
+  // Append every wire record (first fieldCount string fields each)
+  // @return records added
+  size_t AddFromWire(std::string_view wire);
+
+  uint32_t RecordCount() const { return m_recordCount; }
+
+  std::vector<uint8_t> Finish(const Key &key) const;
+
+private:
+  void Intern(std::u16string_view text);
+
+  uint32_t m_fieldCount;
+  uint32_t m_recordCount = 0;
+  std::vector<uint32_t> m_refs; // offset, length pairs
+  std::u16string m_pool;
+  std::u16string m_scratch;
+  std::unordered_multimap<uint64_t, uint64_t> m_interned; // hash -> offset<<32 | length
+};
+
+/**
+ * Read-only catalog over a mapped file or an in-memory image. Move-only.
+ */
+class Catalog {
+public:
+  Catalog() = default;
+  ~Catalog() { Close(); }
+  Catalog(Catalog &&other) noexcept { MoveFrom(other); }
+  Catalog &operator=(Catalog &&other) noexcept {
+    if (this != &other) {
+      Close();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+  Catalog(const Catalog &) = delete;
+  Catalog &operator=(const Catalog &) = delete;
+
+  // Map a cache file; false if missing, unreadable or not a valid catalog
+  bool Open(const std::filesystem::path &path);
+
+  // Take ownership of a Builder image (releases any mapping first)
+  bool Adopt(std::vector<uint8_t> image);
+
+  void Close();
+  bool IsOpen() const { return m_data != nullptr; }
+
+  // Re-stamp the key of an adopted image (false for mapped files)
+  bool SetKey(const Key &key);
+
+  // True if backed by a mapped file (not an adopted image)
+  bool IsMapped() const { return m_mapped; }
+
+  // hostBuild/language (and the fingerprint if checkFingerprint) match
+  bool Matches(const Key &key, bool checkFingerprint) const;
+
+  std::string_view HostBuild() const;
+  std::string_view Language() const;
+  uint64_t Fingerprint() const;
+
+  uint32_t RecordCount() const;
+  uint32_t FieldCount() const;
+
+  // Field text ("" if out of range or damaged)
+  std::u16string_view Field(uint32_t record, uint32_t field) const;
+
+  // Field copied into a wchar_t buffer; returns units written
+  size_t FieldInto(uint32_t record, uint32_t field, wchar_t *out,
+                   size_t outCount) const;
+  std::wstring WideField(uint32_t record, uint32_t field) const;
+
+  // Whole file bytes (for writing an adopted image to disk)
+  const uint8_t *Data() const { return m_data; }
+  size_t Size() const { return m_size; }
+
+private:
+  void MoveFrom(Catalog &other);
+  bool Validate() const;
+
+  const uint8_t *m_data = nullptr;
+  size_t m_size = 0;
+  std::vector<uint8_t> m_image; // Adopt() storage
+  void *m_mapping = nullptr;    // Platform mapping handle (Windows)
+  bool m_mapped = false;
+};
+
+/**
+ * Write an image atomically (temp file + rename)
+ * Close any Catalog mapping the same path before writing (Windows).
+ */
+bool WriteFile(const std::filesystem::path &path, const uint8_t *data,
+               size_t size);
+
+/**
+ * Order-independent hash of the folder trees' listings (relative path,
+ * size, modification time of every file). Missing folders hash as empty.
+ * Slow on large trees: run off the main thread.
+ */
+uint64_t HashFolderListing(const std::vector<std::string> &utf8Folders);
+
+// UTF-8 -> UTF-16 (invalid sequences become U+FFFD)
+void AppendUtf16(std::u16string &out, std::string_view utf8);
+std::u16string ToUtf16(std::string_view utf8);
+
+// FNV-1a 64
+uint64_t Hash64(const void *data, size_t size,
+                uint64_t seed = 0xcbf29ce484222325ULL);
+
+} // namespace CatalogCache
@@ -0,0 +1,119 @@
+/*****************************************************************************
+ * ContextCache.cpp
+ *
+ * Shared selection / context snapshot (see ContextCache.h)
+ *****************************************************************************/
+
+#include "ContextCache.h"
+#include "WireFormat.h"
+
+#include <cstdio>
+
+namespace ContextCache {
+
+static Query s_query = nullptr;
+static void *s_queryContext = nullptr;
+static Snapshot s_snapshot;
+static bool s_valid = false;
+static uint64_t s_generation = 0;
+static Stats s_stats;
+
+bool Snapshot::HasSelected(LayerKind kind) const {
+  if (!HasSelection())
+    return false;
+  for (const SelectedLayer &layer : layers) {
+    if (layer.kind == kind)
+      return true;
+  }
+  return false;
+}
+
+void SetQuery(Query query, void *context) {
+  s_query = query;
+  s_queryContext = context;
+  s_valid = false;
+}
+
+bool Parse(std::string_view wire, Snapshot &out) {
+  out = Snapshot();
+  WireFormat::Reader reader(wire);
+  if (!reader.Next() || reader.FieldCount() < WireFormat::CONTEXT_FIELD_COUNT)
+    return false;
+
+  out.compId = reader.Int(WireFormat::CONTEXT_COMP_ID, 0);
+  int viewer = reader.Int(WireFormat::CONTEXT_VIEWER, VIEWER_NONE);
+  out.viewer = (viewer >= VIEWER_NONE && viewer <= VIEWER_OTHER) ? (Viewer)viewer
+                                                                 : VIEWER_OTHER;
+  out.textTool = reader.Bool(WireFormat::CONTEXT_TEXT_TOOL, false);
+  out.selectedCount = reader.Int(WireFormat::CONTEXT_SELECTED_COUNT, 0);
+
+  while (reader.Next() && out.layers.size() < MAX_LAYERS) {
+    SelectedLayer layer;
+    layer.index = reader.Int(WireFormat::SELECTED_INDEX, 0);
+    layer.id = reader.Int(WireFormat::SELECTED_ID, 0);
+    int kind = reader.Int(WireFormat::SELECTED_KIND, LAYER_AV);
+    layer.kind = (kind >= LAYER_AV && kind <= LAYER_LIGHT) ? (LayerKind)kind
+                                                           : LAYER_AV;
+    out.layers.push_back(layer);
+  }
+  if (reader.Failed()) {
+    out = Snapshot();
+    return false;
+  }
+  return true;
+}
+
+const Snapshot &Get() {
+  s_stats.lookups++;
+  if (s_valid) {
+    s_stats.hits++;
+    return s_snapshot;
+  }
+
+  s_stats.refreshes++;
+  s_generation++;
+  std::string wire;
+  bool ok = s_query && s_query(wire, s_queryContext) && Parse(wire, s_snapshot);
+  if (!ok) {
+    s_stats.failures++;
+    s_snapshot = Snapshot();
+  }
+  s_valid = ok;
+  return s_snapshot;
+}
+
+void Invalidate() {
+  if (s_valid)
+    s_stats.invalidations++;
+  s_valid = false;
+  s_generation++;
+}
+
+bool IsValid() { return s_valid; }
+
+bool Store(std::string_view wire) {
+  s_generation++;
+  s_valid = Parse(wire, s_snapshot);
+  return s_valid;
+}
+
+uint64_t Generation() { return s_generation; }
+
+Stats GetStats() { return s_stats; }
+
+void ResetStats() { s_stats = Stats(); }
+
+std::string FormatStats() {
+  char line[192];
+  double rate = s_stats.lookups ? 100.0 * (double)s_stats.hits / (double)s_stats.lookups
+                                : 0.0;
+  snprintf(line, sizeof(line),
+           "context cache: %llu lookups, %llu hits (%.0f%%), %llu refreshes, "
+           "%llu script calls saved",
+           (unsigned long long)s_stats.lookups, (unsigned long long)s_stats.hits,
+           rate, (unsigned long long)s_stats.refreshes,
+           (unsigned long long)s_stats.hits);
+  return line;
+}
+
+} // namespace ContextCache
@@ -0,0 +1,129 @@
+/*****************************************************************************
+ * ContextCache.h
+ *
+ * Shared selection / context snapshot for key-trigger gating
+ *
+ * One selectionContext() call captures the active comp, active viewer,
+ * text tool state and the selected layers (index, id, kind). Every module
+ * gate (Y grid, Shift+E effects, D menu panels) reads the same snapshot,
+ * so a trigger costs a memory read instead of an AEGP_ExecuteScript.
+ *
+ * The snapshot is invalidated, never refreshed eagerly: UpdateMenuHook
+ * bursts, mouse clicks in AE and mutating script calls mark it stale, and
+ * the next lookup refreshes it once. Lookups in between are hits.
+ *
+ * Platform-neutral: the host query is injected (SetQuery), like
+ * ScriptBatch's runner, so the cache runs against a mock host.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ContextCache {
+
+// Active viewer (selectionContext() codes)
+enum Viewer {
+  VIEWER_NONE = 0,
+  VIEWER_COMPOSITION,
+  VIEWER_LAYER,
+  VIEWER_FOOTAGE,
+  VIEWER_EFFECT_CONTROLS,
+  VIEWER_OTHER
+};
+
+// Selected layer kind (selectionContext() codes)
+enum LayerKind {
+  LAYER_AV = 0, // Footage, solid, null, precomp, adjustment
+  LAYER_TEXT,
+  LAYER_SHAPE,
+  LAYER_CAMERA,
+  LAYER_LIGHT
+};
+
+// Selected layers stored per snapshot (selectedCount may be larger)
+const size_t MAX_LAYERS = 64;
+
+struct SelectedLayer {
+  int index = 0; // 1-based layer index
+  int id = 0;    // Layer.id (0 on hosts without it)
+  LayerKind kind = LAYER_AV;
+};
+
+struct Snapshot {
+  int compId = 0; // 0 = active item is not a comp
+  Viewer viewer = VIEWER_NONE;
+  bool textTool = false;
+  int selectedCount = 0;
+  std::vector<SelectedLayer> layers; // Selection order, first MAX_LAYERS
+
+  bool HasSelection() const { return compId != 0 && selectedCount > 0; }
+
+  // Selection in a comp/layer viewer (anchor grid, layer effects gate)
+  bool HasSelectedLayers() const {
+    return HasSelection() &&
+           (viewer == VIEWER_COMPOSITION || viewer == VIEWER_LAYER);
+  }
+
+  bool HasSelected(LayerKind kind) const;
+
+  // Kind of the first selected layer (shapeInfo/layerInfo read that one)
+  bool FirstSelectedIs(LayerKind kind) const {
+    return !layers.empty() && layers[0].kind == kind;
+  }
+};
+
+/**
+ * Host query: run selectionContext() and return its wire result.
+ * @return false if the host call failed
+ */
+typedef bool (*Query)(std::string &wire, void *context);
+
+void SetQuery(Query query, void *context);
+
+/**
+ * Current snapshot (refreshed first if stale)
+ * On a failed refresh the snapshot is empty (nothing selected) and the
+ * next lookup tries again.
+ */
+const Snapshot &Get();
+
+// Mark the snapshot stale (cheap; call as often as needed)
+void Invalidate();
+
+// True if the next Get() is served from memory
+bool IsValid();
+
+/**
+ * Adopt a selectionContext() result fetched by another call (PanelPrefetch)
+ * @return false if malformed (the cache is left stale)
+ */
+bool Store(std::string_view wire);
+
+// Bumped by every Invalidate() and refresh: snapshot-derived data taken at
+// one generation is current while Generation() still returns it
+uint64_t Generation();
+
+// selectionContext() wire result -> snapshot; false if malformed
+bool Parse(std::string_view wire, Snapshot &out);
+
+// Cache statistics (for logging / benchmarking)
+struct Stats {
+  uint64_t lookups = 0;       // Get() calls
+  uint64_t hits = 0;          // Served from memory = script calls saved
+  uint64_t refreshes = 0;     // selectionContext() calls
+  uint64_t failures = 0;      // Refreshes that failed or were malformed
+  uint64_t invalidations = 0; // Invalidate() calls that staled a snapshot
+};
+
+Stats GetStats();
+void ResetStats();
+
+// "context cache: N lookups, H hits (P%), R refreshes, S script calls saved"
+std::string FormatStats();
+
+} // namespace ContextCache
@@ -0,0 +1,72 @@
+/*****************************************************************************
+ * EffectEnumerator.cpp
+ *
+ * Installed effects -> effects catalog (see EffectEnumerator.h)
+ *****************************************************************************/
+
+#include "EffectEnumerator.h"
+#include "WireFormat.h"
+
+#include <utility>
+
+namespace EffectEnumerator {
+
+void MockSource::Add(std::string name, std::string matchName,
+                     std::string category) {
+  m_effects.push_back({std::move(name), std::move(matchName), std::move(category)});
+}
+
+bool MockSource::Next(Entry &entry) {
+  if (m_next >= m_effects.size())
+    return false;
+  const std::array<std::string, 3> &effect = m_effects[m_next++];
+  entry.name = effect[0];
+  entry.matchName = effect[1];
+  entry.category = effect[2];
+  return true;
+}
+
+size_t BuildCatalog(Source &source, CatalogCache::Builder &builder) {
+  std::string_view fields[WireFormat::EFFECT_FIELD_COUNT];
+  size_t added = 0;
+  Entry entry;
+  while (source.Next(entry)) {
+    if (entry.category.empty())
+      continue;
+    fields[WireFormat::EFFECT_NAME] = entry.name;
+    fields[WireFormat::EFFECT_MATCH_NAME] = entry.matchName;
+    fields[WireFormat::EFFECT_CATEGORY_OR_INDEX] = entry.category;
+    builder.AddRecord(fields);
+    added++;
+  }
+  return added;
+}
+
+bool IsUtf8(std::string_view text) {
+  const unsigned char *s = (const unsigned char *)text.data();
+  size_t n = text.size();
+  for (size_t i = 0; i < n;) {
+    unsigned char c = s[i];
+    size_t extra;
+    if (c < 0x80)
+      extra = 0;
+    else if ((c & 0xE0) == 0xC0 && c >= 0xC2)
+      extra = 1;
+    else if ((c & 0xF0) == 0xE0)
+      extra = 2;
+    else if ((c & 0xF8) == 0xF0 && c <= 0xF4)
+      extra = 3;
+    else
+      return false;
+    if (extra > n - i - 1)
+      return false;
+    for (size_t k = 1; k <= extra; k++) {
+      if ((s[i + k] & 0xC0) != 0x80)
+        return false;
+    }
+    i += extra + 1;
+  }
+  return true;
+}
+
+} // namespace EffectEnumerator
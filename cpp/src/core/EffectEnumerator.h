@@ -0,0 +1,77 @@
+/*****************************************************************************
+ * EffectEnumerator.h
+ *
+ * Installed effects -> effects catalog without ExtendScript
+ *
+ * A Source walks the installed effects and BuildCatalog() feeds each
+ * record straight into a CatalogCache::Builder: no script, no joined result
+ * string, no re-parse. Records use the effectsList() layout
+ * (WireFormat::EffectField), so the catalog is interchangeable with one
+ * built from the script.
+ *
+ * The plugin enumerates the AEGP Effect Suite itself (SnapPlugin
+ * EnumerateEffects) so each name is widened once into the ControlUI list;
+ * this module supplies IsUtf8 for that and the MockSource reference path
+ * ScriptBench checks it against.
+ *
+ * Platform-neutral (no AE / Win32 dependencies).
+ *****************************************************************************/
+
+#pragma once
+
+#include "CatalogCache.h"
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace EffectEnumerator {
+
+/**
+ * One installed effect (UTF-8; views stay valid until the next Next() call)
+ */
+struct Entry {
+  std::string_view name;      // Localized display name
+  std::string_view matchName;
+  std::string_view category;  // "" = hidden (not listed, like effectsList())
+};
+
+/**
+ * Effect source
+ */
+class Source {
+public:
+  virtual ~Source() = default;
+
+  // Next effect; false at the end or on error
+  virtual bool Next(Entry &entry) = 0;
+};
+
+/**
+ * In-memory source (tests, benchmarks)
+ */
+class MockSource : public Source {
+public:
+  void Add(std::string name, std::string matchName, std::string category);
+  void Rewind() { m_next = 0; }
+
+  bool Next(Entry &entry) override;
+
+private:
+  std::vector<std::array<std::string, 3>> m_effects;
+  size_t m_next = 0;
+};
+
+/**
+ * Append every listed effect (non-empty category) to the builder
+ * builder must have WireFormat::EFFECT_FIELD_COUNT fields.
+ * @return records added
+ */
+size_t BuildCatalog(Source &source, CatalogCache::Builder &builder);
+
+// True if text is well-formed UTF-8 (sources decide whether to convert)
+bool IsUtf8(std::string_view text);
+
+} // namespace EffectEnumerator
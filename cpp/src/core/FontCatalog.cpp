@@ -0,0 +1,140 @@
+/*****************************************************************************
+ * FontCatalog.cpp
+ *
+ * Font list cache (see FontCatalog.h)
+ *****************************************************************************/
+
+#include "FontCatalog.h"
+#include "WireFormat.h"
+
+#include <unordered_map>
+
+namespace FontCatalog {
+
+using CatalogCache::Catalog;
+
+struct Family {
+  std::u16string name;
+  std::string_view utf8; // View into the fontFamilies() result
+  uint32_t count;
+};
+
+// fontFamilies() records, duplicate names merged (first position kept)
+static std::vector<Family> ReadFamilies(std::string_view familiesWire) {
+  std::vector<Family> families;
+  std::unordered_map<std::u16string, size_t> index;
+  WireFormat::Reader reader(familiesWire);
+  while (reader.Next()) {
+    std::string_view name = reader.String(WireFormat::FAMILY_NAME);
+    int count = reader.Int(WireFormat::FAMILY_FONT_COUNT, 0);
+    if (count <= 0)
+      continue;
+    std::u16string wide = CatalogCache::ToUtf16(name);
+    auto it = index.find(wide);
+    if (it != index.end()) {
+      families[it->second].count += (uint32_t)count;
+      continue;
+    }
+    index.emplace(wide, families.size());
+    families.push_back({std::move(wide), name, (uint32_t)count});
+  }
+  return families;
+}
+
+// Cached record indices per family (views into the catalog)
+static std::unordered_map<std::u16string_view, std::vector<uint32_t>>
+GroupRecords(const Catalog &catalog) {
+  std::unordered_map<std::u16string_view, std::vector<uint32_t>> groups;
+  if (catalog.FieldCount() < WireFormat::FONT_FIELD_COUNT)
+    return groups;
+  uint32_t count = catalog.RecordCount();
+  for (uint32_t i = 0; i < count; i++)
+    groups[catalog.Field(i, WireFormat::FONT_FAMILY)].push_back(i);
+  return groups;
+}
+
+static uint64_t PairHash(std::u16string_view family, uint32_t count) {
+  uint64_t h = CatalogCache::Hash64(family.data(), family.size() * sizeof(char16_t));
+  return CatalogCache::Hash64(&count, sizeof(count), h);
+}
+
+uint64_t Fingerprint(const Catalog &catalog) {
+  uint64_t sum = 0;
+  for (const auto &group : GroupRecords(catalog))
+    sum += PairHash(group.first, (uint32_t)group.second.size());
+  return sum;
+}
+
+uint64_t FingerprintFamilies(std::string_view familiesWire) {
+  uint64_t sum = 0;
+  for (const Family &family : ReadFamilies(familiesWire))
+    sum += PairHash(family.name, family.count);
+  return sum;
+}
+
+Diff Compare(const Catalog &cached, std::string_view familiesWire) {
+  Diff diff;
+  auto groups = GroupRecords(cached);
+  std::vector<Family> families = ReadFamilies(familiesWire);
+  diff.families = families.size();
+
+  WireFormat::Writer writer(diff.changedWire);
+  size_t kept = 0;
+  for (const Family &family : families) {
+    auto it = groups.find(family.name);
+    if (it != groups.end()) {
+      kept++;
+      if (it->second.size() == family.count)
+        continue;
+    }
+    writer.BeginRecord(1);
+    writer.String(family.utf8);
+    diff.changed++;
+  }
+  diff.removed = groups.size() - kept;
+  return diff;
+}
+
+std::vector<uint8_t> Merge(const Catalog &cached, std::string_view familiesWire,
+                           std::string_view changedFontsWire,
+                           const CatalogCache::Key &key) {
+  auto groups = GroupRecords(cached);
+
+  // Fetched records per family (UTF-8 views into the fontsOf() result)
+  struct Fetched {
+    std::string_view fields[WireFormat::FONT_FIELD_COUNT];
+  };
+  std::unordered_map<std::u16string, std::vector<Fetched>> fetched;
+  WireFormat::Reader reader(changedFontsWire);
+  while (reader.Next()) {
+    if (reader.FieldCount() < WireFormat::FONT_FIELD_COUNT)
+      continue;
+    Fetched record;
+    for (size_t f = 0; f < WireFormat::FONT_FIELD_COUNT; f++)
+      record.fields[f] = reader.String(f);
+    fetched[CatalogCache::ToUtf16(record.fields[WireFormat::FONT_FAMILY])]
+        .push_back(record);
+  }
+
+  CatalogCache::Builder builder(WireFormat::FONT_FIELD_COUNT);
+  std::u16string_view fields[WireFormat::FONT_FIELD_COUNT];
+  for (const Family &family : ReadFamilies(familiesWire)) {
+    auto it = groups.find(family.name);
+    if (it != groups.end() && it->second.size() == family.count) {
+      for (uint32_t record : it->second) {
+        for (uint32_t f = 0; f < WireFormat::FONT_FIELD_COUNT; f++)
+          fields[f] = cached.Field(record, f);
+        builder.AddRecord(fields);
+      }
+      continue;
+    }
+    auto found = fetched.find(family.name);
+    if (found == fetched.end())
+      continue;
+    for (const Fetched &record : found->second)
+      builder.AddRecord(record.fields);
+  }
+  return builder.Finish(key);
+}
+
+} // namespace FontCatalog
@@ -0,0 +1,55 @@
+/*****************************************************************************
+ * FontCatalog.h
+ *
+ * Font list cache on top of CatalogCache (fonts-catalog.bin)
+ *
+ * Records use the fontsList() layout (WireFormat::FontField). The header
+ * fingerprint is an order-independent hash of (family name, font count)
+ * pairs, which fontFamilies() reports far faster than a full fontsList().
+ * When it changes, only new or changed families are fetched again with
+ * fontsOf() and merged with the cached records of the unchanged ones.
+ *
+ * Platform-neutral (no AE / Win32 dependencies).
+ *****************************************************************************/
+
+#pragma once
+
+#include "CatalogCache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace FontCatalog {
+
+// Fingerprint of a font catalog's records (family -> record count)
+uint64_t Fingerprint(const CatalogCache::Catalog &catalog);
+
+// Fingerprint of a fontFamilies() result
+uint64_t FingerprintFamilies(std::string_view familiesWire);
+
+/**
+ * Cached catalog vs. fontFamilies() result
+ */
+struct Diff {
+  std::string changedWire; // fontsOf() argument: one record per family name
+  size_t changed = 0;      // New families or families with a new font count
+  size_t removed = 0;      // Cached families no longer installed
+  size_t families = 0;     // Families installed now
+};
+
+Diff Compare(const CatalogCache::Catalog &cached,
+             std::string_view familiesWire);
+
+/**
+ * New catalog image in fontFamilies() order: cached records of unchanged
+ * families plus the fontsOf() records of the changed ones.
+ */
+std::vector<uint8_t> Merge(const CatalogCache::Catalog &cached,
+                           std::string_view familiesWire,
+                           std::string_view changedFontsWire,
+                           const CatalogCache::Key &key);
+
+} // namespace FontCatalog
@@ -0,0 +1,257 @@
+/*****************************************************************************
+ * IconAtlas.cpp
+ *
+ * Shelf-packed icon cache (see IconAtlas.h)
+ *****************************************************************************/
+
+#include "IconAtlas.h"
+
+#ifdef MSWindows
+#include "GdiPlusIncludes.h"
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace IconAtlas {
+
+static Stats s_stats;
+
+#ifdef MSWindows
+
+using namespace Gdiplus;
+
+static uint64_t NowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static const int PAD = 2; // Transparent border: AA fringes, pen overhang
+
+struct Cell {
+  int x, y, width, height;
+  uint64_t rasterNs;
+};
+
+struct Shelf {
+  int y, height, used;
+};
+
+// (owner, icon, state, scale, size, phase) -> cell
+struct Key {
+  int owner, icon;
+  uint32_t state;
+  int scaleX, scaleY; // Device scale * 1024
+  int width, height;  // Cell (device pixels, padding included)
+  int phase;          // Quarter pixels: phaseX * 4 + phaseY
+
+  bool operator==(const Key &o) const {
+    return owner == o.owner && icon == o.icon && state == o.state && scaleX == o.scaleX &&
+           scaleY == o.scaleY && width == o.width && height == o.height && phase == o.phase;
+  }
+};
+
+struct KeyHash {
+  size_t operator()(const Key &key) const {
+    uint64_t h = 1469598103934665603ull; // FNV-1a over the fields
+    const int fields[] = {key.owner,  key.icon,  (int)key.state, key.scaleX,
+                          key.scaleY, key.width, key.height,     key.phase};
+    for (int field : fields)
+      h = (h ^ (uint32_t)field) * 1099511628211ull;
+    return (size_t)h;
+  }
+};
+
+static std::unique_ptr<Bitmap> s_bitmap;
+static std::unordered_map<Key, Cell, KeyHash> s_cells;
+static std::vector<Shelf> s_shelves;
+static float s_scales[OWNER_COUNT] = {};
+
+static void UpdateSize() {
+  s_stats.icons = (uint32_t)s_cells.size();
+  s_stats.width = s_bitmap ? s_bitmap->GetWidth() : 0;
+  s_stats.height = s_bitmap ? s_bitmap->GetHeight() : 0;
+  s_stats.bytes = (uint64_t)s_stats.width * s_stats.height * 4;
+}
+
+void Clear() {
+  s_bitmap.reset();
+  s_cells.clear();
+  s_shelves.clear();
+  UpdateSize();
+}
+
+void SetScale(Owner owner, float scale) {
+  if (owner >= OWNER_COUNT || s_scales[owner] == scale)
+    return;
+  // Icons of other modules are rasterized again too: rare, and the
+  // shelves cannot free single cells
+  if (s_scales[owner] != 0.0f && !s_cells.empty()) {
+    Clear();
+    s_stats.clears++;
+  }
+  s_scales[owner] = scale;
+}
+
+// Bitmap of at least `height` rows, keeping the cells drawn so far
+static bool Grow(int height) {
+  int newHeight = s_bitmap ? (int)s_bitmap->GetHeight() : 0;
+  if (newHeight >= height)
+    return true;
+  if (newHeight == 0)
+    newHeight = 128;
+  while (newHeight < height)
+    newHeight *= 2;
+  if (newHeight > MAX_ATLAS_HEIGHT)
+    return false;
+  std::unique_ptr<Bitmap> bitmap(new Bitmap(ATLAS_WIDTH, newHeight, PixelFormat32bppPARGB));
+  if (bitmap->GetLastStatus() != Ok)
+    return false;
+  if (s_bitmap) {
+    Graphics graphics(bitmap.get());
+    graphics.SetCompositingMode(CompositingModeSourceCopy);
+    graphics.DrawImage(s_bitmap.get(), 0, 0, (INT)s_bitmap->GetWidth(), (INT)s_bitmap->GetHeight());
+  }
+  s_bitmap = std::move(bitmap);
+  UpdateSize();
+  return true;
+}
+
+// Shelf packing: first shelf tall enough (and not much taller) with room
+static bool Allocate(int width, int height, int *x, int *y) {
+  if (width > ATLAS_WIDTH || height > MAX_ATLAS_HEIGHT)
+    return false;
+  for (Shelf &shelf : s_shelves) {
+    if (height <= shelf.height && height * 4 >= shelf.height * 3 &&
+        shelf.used + width <= ATLAS_WIDTH) {
+      *x = shelf.used;
+      *y = shelf.y;
+      shelf.used += width;
+      return true;
+    }
+  }
+  int top = s_shelves.empty() ? 0 : s_shelves.back().y + s_shelves.back().height;
+  if (!Grow(top + height))
+    return false;
+  s_shelves.push_back({top, height, width});
+  *x = 0;
+  *y = top;
+  return true;
+}
+
+bool Draw(Graphics &graphics, Owner owner, int icon, uint32_t state, const RectF &rect,
+          RasterFunc raster) {
+  REAL m[6];
+  Matrix transform;
+  graphics.GetTransform(&transform);
+  transform.GetElements(m);
+  if (m[1] != 0 || m[2] != 0 || m[0] <= 0 || m[3] <= 0 || rect.Width <= 0 || rect.Height <= 0) {
+    raster(graphics, icon, state, rect);
+    return false;
+  }
+
+  // Device position: integer pixel + quarter-pixel phase
+  float deviceX = rect.X * m[0] + m[4];
+  float deviceY = rect.Y * m[3] + m[5];
+  int left = (int)std::floor(deviceX), top = (int)std::floor(deviceY);
+  int phaseX = (int)std::lround((deviceX - left) * 4.0f);
+  int phaseY = (int)std::lround((deviceY - top) * 4.0f);
+  if (phaseX == 4) {
+    left++;
+    phaseX = 0;
+  }
+  if (phaseY == 4) {
+    top++;
+    phaseY = 0;
+  }
+  int width = (int)std::ceil(rect.Width * m[0] + 0.25f) + PAD * 2;
+  int height = (int)std::ceil(rect.Height * m[3] + 0.25f) + PAD * 2;
+
+  Key key = {owner,
+             icon,
+             state,
+             (int)std::lround(m[0] * 1024.0f),
+             (int)std::lround(m[3] * 1024.0f),
+             width,
+             height,
+             phaseX * 4 + phaseY};
+
+  auto it = s_cells.find(key);
+  if (it == s_cells.end()) {
+    uint64_t start = NowNs();
+    Cell cell = {0, 0, width, height, 0};
+    if (!Allocate(width, height, &cell.x, &cell.y)) {
+      // Full: start over (every cached icon is redrawn on demand)
+      Clear();
+      s_stats.clears++;
+      if (!Allocate(width, height, &cell.x, &cell.y)) {
+        raster(graphics, icon, state, rect);
+        return false;
+      }
+    }
+    {
+      Graphics atlas(s_bitmap.get());
+      atlas.SetCompositingMode(CompositingModeSourceCopy);
+      SolidBrush clear(Color(0, 0, 0, 0));
+      atlas.FillRectangle(&clear, cell.x, cell.y, cell.width, cell.height);
+      atlas.SetCompositingMode(CompositingModeSourceOver);
+      atlas.SetSmoothingMode(graphics.GetSmoothingMode());
+      atlas.SetPixelOffsetMode(graphics.GetPixelOffsetMode());
+      atlas.SetTextRenderingHint(graphics.GetTextRenderingHint());
+      atlas.SetClip(Rect(cell.x, cell.y, cell.width, cell.height));
+      atlas.TranslateTransform((REAL)(cell.x + PAD) + phaseX * 0.25f,
+                               (REAL)(cell.y + PAD) + phaseY * 0.25f);
+      atlas.ScaleTransform(m[0], m[3]);
+      raster(atlas, icon, state, RectF(0, 0, rect.Width, rect.Height));
+    }
+    cell.rasterNs = NowNs() - start;
+    s_stats.rasterized++;
+    s_stats.rasterNs += cell.rasterNs;
+    it = s_cells.emplace(key, cell).first;
+    UpdateSize();
+  }
+
+  // 1:1 copy in device space
+  uint64_t start = NowNs();
+  const Cell &cell = it->second;
+  GraphicsState saved = graphics.Save();
+  graphics.ResetTransform();
+  graphics.SetInterpolationMode(InterpolationModeNearestNeighbor);
+  graphics.SetPixelOffsetMode(PixelOffsetModeHalf);
+  graphics.DrawImage(s_bitmap.get(), Rect(left - PAD, top - PAD, cell.width, cell.height), cell.x,
+                     cell.y, cell.width, cell.height, UnitPixel);
+  graphics.Restore(saved);
+  uint64_t blitNs = NowNs() - start;
+  s_stats.blits++;
+  s_stats.blitNs += blitNs;
+  if (cell.rasterNs > blitNs)
+    s_stats.savedNs += cell.rasterNs - blitNs;
+  return true;
+}
+
+#endif // MSWindows
+
+Stats GetStats() { return s_stats; }
+
+std::string FormatReport() {
+  char line[200];
+  snprintf(line, sizeof(line),
+           "icon atlas: %u icons, %ux%u (%.0f KB), %llu rasterized, %llu blits, %llu clears\n",
+           s_stats.icons, s_stats.width, s_stats.height, (double)s_stats.bytes / 1024.0,
+           (unsigned long long)s_stats.rasterized, (unsigned long long)s_stats.blits,
+           (unsigned long long)s_stats.clears);
+  std::string report = line;
+  snprintf(line, sizeof(line), "  raster %.1f us/icon, blit %.1f us/icon, saved %.2f ms\n",
+           s_stats.rasterized ? (double)s_stats.rasterNs / 1e3 / s_stats.rasterized : 0.0,
+           s_stats.blits ? (double)s_stats.blitNs / 1e3 / s_stats.blits : 0.0,
+           (double)s_stats.savedNs / 1e6);
+  report += line;
+  return report;
+}
+
+} // namespace IconAtlas
@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * IconAtlas.h
+ *
+ * Pre-rasterized UI icons
+ *
+ * GridUI's DrawIcon and ControlUI's DrawPresetIcon / DrawSaveIcon rebuilt
+ * their vector shapes (GraphicsPath stars and bolts, waves, gears) on
+ * every paint; KeyframeUI's preset thumbnails use it too. Each icon is
+ * now rasterized once per (module, icon, state, size, scale, subpixel
+ * phase) into one shared PARGB bitmap; later paints copy the cell 1:1:
+ *
+ *   static void RasterStar(Graphics &g, int icon, uint32_t state, const RectF &rect);
+ *   IconAtlas::Draw(graphics, IconAtlas::OWNER_CONTROL, ICON_STAR, filled, rect, RasterStar);
+ *
+ * The raster function draws `rect` at (0, 0) with the target's smoothing
+ * / pixel offset / text modes and its scale; the cell is placed at the
+ * target's device position (quarter-pixel phase kept). It must only
+ * depend on (icon, state, rect size) and the owner's scale: anything else
+ * that changes the look belongs in `state`.
+ *
+ * Built lazily (a miss rasterizes), cleared when a module's scale changes
+ * (SetScale from ShowPanel), when the atlas is full, and before GDI+ shuts
+ * down (last RenderContext::Release).
+ *
+ * Main thread only. Header is GDI+-free (SnapPlugin reads the report);
+ * Draw / SetScale / Clear exist on Windows only.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Gdiplus {
+class Graphics;
+class RectF;
+} // namespace Gdiplus
+
+namespace IconAtlas {
+
+enum Owner : uint8_t { OWNER_GRID = 0, OWNER_CONTROL, OWNER_KEYFRAME, OWNER_COUNT };
+
+const int ATLAS_WIDTH = 512;       // Shelves of cells, left to right
+const int MAX_ATLAS_HEIGHT = 2048; // Height doubles up to this, then the atlas is cleared
+
+struct Stats {
+  uint32_t icons = 0;       // Cells in the atlas
+  uint32_t width = 0;       // Atlas bitmap
+  uint32_t height = 0;
+  uint64_t bytes = 0;       // Atlas bitmap memory (PARGB)
+  uint64_t rasterized = 0;  // Misses: icon drawn into the atlas
+  uint64_t blits = 0;       // Hits: cell copied
+  uint64_t clears = 0;      // Scale changes / full atlas
+  uint64_t rasterNs = 0;    // Time drawing icons into the atlas
+  uint64_t blitNs = 0;      // Time copying cells
+  uint64_t savedNs = 0;     // Sum over hits of (that icon's raster time - blit time)
+};
+Stats GetStats();
+
+/**
+ * Text report:
+ *   "icon atlas: N icons, WxH (K KB), R rasterized, B blits, C clears"
+ *   "  raster X us/icon, blit Y us/icon, saved Z ms"
+ */
+std::string FormatReport();
+
+#ifdef MSWindows
+
+typedef void (*RasterFunc)(Gdiplus::Graphics &graphics, int icon, uint32_t state,
+                           const Gdiplus::RectF &rect);
+
+/**
+ * Draw an icon into `rect` (world coordinates of `graphics`)
+ * @return false if drawn directly (rotated / skewed transform, no atlas)
+ */
+bool Draw(Gdiplus::Graphics &graphics, Owner owner, int icon, uint32_t state,
+          const Gdiplus::RectF &rect, RasterFunc raster);
+
+// Module scale (GetModuleScaleFactor): a change clears the atlas
+void SetScale(Owner owner, float scale);
+
+// Free the atlas bitmap (icons are rasterized again on demand)
+void Clear();
+
+#endif // MSWindows
+
+} // namespace IconAtlas
@@ -0,0 +1,121 @@
+/*****************************************************************************
+ * IdleScheduler.cpp
+ *
+ * Adaptive IdleHook rate (see IdleScheduler.h)
+ *****************************************************************************/
+
+#include "IdleScheduler.h"
+
+#include <cstdio>
+
+namespace IdleScheduler {
+
+static Waker s_waker = nullptr;
+static void *s_wakerContext = nullptr;
+
+static Mode s_mode = MODE_ACTIVE; // Until the first tick has classified
+static bool s_inTick = false;
+static bool s_wakeSent = false; // One forwarded wake per sleep
+static uint64_t s_tickStartUs = 0;
+
+// Rolling 1 s window for the rate counters
+static const uint64_t WINDOW_US = 1000000;
+static uint64_t s_windowStartUs = 0;
+static uint64_t s_windowTicks = 0;
+static uint64_t s_windowBusyUs = 0;
+static bool s_windowStarted = false;
+
+static Stats s_stats;
+
+Mode Classify(const State &state) {
+  if (state.uiVisible || state.holdPending || state.workPending)
+    return MODE_ACTIVE;
+  return state.foreground ? MODE_IDLE : MODE_BACKGROUND;
+}
+
+int SleepFor(Mode mode) {
+  switch (mode) {
+  case MODE_ACTIVE:
+    return ACTIVE_SLEEP_MS;
+  case MODE_IDLE:
+    return IDLE_SLEEP_MS;
+  default:
+    return BACKGROUND_SLEEP_MS;
+  }
+}
+
+void SetWaker(Waker waker, void *context) {
+  s_waker = waker;
+  s_wakerContext = context;
+}
+
+void RequestWake() {
+  s_stats.wakeRequests++;
+  // Inside a tick or already polling fast: the next tick is soon anyway
+  if (s_inTick || s_wakeSent || s_mode == MODE_ACTIVE || !s_waker)
+    return;
+  s_wakeSent = true;
+  s_stats.wakes++;
+  s_waker(s_wakerContext);
+}
+
+void BeginTick(uint64_t nowUs) {
+  s_inTick = true;
+  s_wakeSent = false;
+  s_tickStartUs = nowUs;
+  if (!s_windowStarted) {
+    s_windowStarted = true;
+    s_windowStartUs = nowUs;
+  }
+}
+
+int EndTick(const State &state, uint64_t nowUs) {
+  uint64_t busy = nowUs > s_tickStartUs ? nowUs - s_tickStartUs : 0;
+  s_inTick = false;
+  s_mode = Classify(state);
+
+  s_stats.ticks++;
+  s_stats.ticksByMode[s_mode]++;
+  s_stats.busyUs += busy;
+  if (busy > s_stats.maxTickUs)
+    s_stats.maxTickUs = busy;
+
+  s_windowTicks++;
+  s_windowBusyUs += busy;
+  uint64_t elapsed = nowUs - s_windowStartUs;
+  if (elapsed >= WINDOW_US) {
+    s_stats.ticksPerSecond = (double)s_windowTicks * 1e6 / (double)elapsed;
+    s_stats.busyUsPerTick = (double)s_windowBusyUs / (double)s_windowTicks;
+    s_windowStartUs = nowUs;
+    s_windowTicks = 0;
+    s_windowBusyUs = 0;
+  }
+  return SleepFor(s_mode);
+}
+
+Mode CurrentMode() { return s_mode; }
+
+Stats GetStats() { return s_stats; }
+
+void ResetStats() {
+  s_stats = Stats();
+  s_windowStarted = false;
+  s_windowTicks = 0;
+  s_windowBusyUs = 0;
+}
+
+std::string FormatStats() {
+  char line[224];
+  snprintf(line, sizeof(line),
+           "idle: %llu ticks (%.1f/s, %.0f us/tick, max %llu us), "
+           "active/idle/background %llu/%llu/%llu, %llu wakes",
+           (unsigned long long)s_stats.ticks, s_stats.ticksPerSecond,
+           s_stats.busyUsPerTick, (unsigned long long)s_stats.maxTickUs,
+           (unsigned long long)s_stats.ticksByMode[MODE_ACTIVE],
+           (unsigned long long)s_stats.ticksByMode[MODE_IDLE],
+           (unsigned long long)s_stats.ticksByMode[MODE_BACKGROUND],
+           (unsigned long long)s_stats.wakes);
+  return line;
+}
+
+} // namespace IdleScheduler
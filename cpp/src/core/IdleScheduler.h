@@ -0,0 +1,88 @@
+/*****************************************************************************
+ * IdleScheduler.h
+ *
+ * Adaptive IdleHook rate
+ *
+ * IdleHook used to ask for a fixed 33 ms sleep and run every module's key /
+ * mouse polling on every tick, even with AE in the background. The
+ * scheduler picks the sleep from the plugin state instead:
+ *
+ *   MODE_ACTIVE      grid / panel visible, hold pending, trigger key down,
+ *                    catalog work left          -> ACTIVE_SLEEP_MS
+ *   MODE_IDLE        AE foreground, nothing shown -> IDLE_SLEEP_MS
+ *   MODE_BACKGROUND  AE not foreground           -> BACKGROUND_SLEEP_MS
+ *
+ * Long sleeps do not delay key triggers: key input in AE fires
+ * UpdateMenuHook, which calls RequestWake() and the injected waker
+ * (AEGP_CauseIdleRoutinesToBeCalled) runs the idle routines right away.
+ *
+ * Platform-neutral: times are passed in (microseconds, any monotonic
+ * origin) and the waker is injected, so traces can be replayed on Linux.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace IdleScheduler {
+
+enum Mode { MODE_BACKGROUND = 0, MODE_IDLE, MODE_ACTIVE, MODE_COUNT };
+
+// Sleep per mode (max_sleepPL)
+const int ACTIVE_SLEEP_MS = 16;      // Hover / hold timing (~60 Hz)
+const int IDLE_SLEEP_MS = 100;       // Safety poll; key input wakes earlier
+const int BACKGROUND_SLEEP_MS = 500; // Only focus changes / catalog polls
+
+// Plugin state sampled at the end of a tick
+struct State {
+  bool foreground = false;  // AE (or one of its windows) is foreground
+  bool uiVisible = false;   // Grid, D menu or any module panel is shown
+  bool holdPending = false; // Trigger key down, hold/toggle/prefetch pending
+  bool workPending = false; // Startup catalog steps left
+};
+
+Mode Classify(const State &state);
+int SleepFor(Mode mode);
+
+/**
+ * Waker: ask the host to run the idle routines now
+ * (SnapPlugin wraps AEGP_CauseIdleRoutinesToBeCalled)
+ */
+typedef void (*Waker)(void *context);
+
+void SetWaker(Waker waker, void *context);
+
+/**
+ * Relevant input arrived (UpdateMenuHook, key / mouse event)
+ * Forwarded to the waker once per tick, and only while sleeping long.
+ */
+void RequestWake();
+
+// Tick bracket (IdleHook entry / every exit)
+void BeginTick(uint64_t nowUs);
+
+// @return sleep for this tick in ms (also recorded in the stats)
+int EndTick(const State &state, uint64_t nowUs);
+
+Mode CurrentMode();
+
+// Scheduler statistics
+struct Stats {
+  uint64_t ticks = 0;
+  uint64_t ticksByMode[MODE_COUNT] = {};
+  uint64_t busyUs = 0;       // Time inside IdleHook (main thread, synchronous)
+  uint64_t maxTickUs = 0;
+  uint64_t wakeRequests = 0; // RequestWake() calls
+  uint64_t wakes = 0;        // Forwarded to the waker
+  double ticksPerSecond = 0; // Last full 1 s window
+  double busyUsPerTick = 0;  // Last full 1 s window
+};
+
+Stats GetStats();
+void ResetStats();
+
+// "idle: N ticks (T/s, B us/tick, max M us), active/idle/background a/i/b, W wakes"
+std::string FormatStats();
+
+} // namespace IdleScheduler
@@ -0,0 +1,151 @@
+/*****************************************************************************
+ * InputEngine.cpp
+ *
+ * Table-driven trigger detection (see InputEngine.h)
+ *****************************************************************************/
+
+#include "InputEngine.h"
+
+namespace InputEngine {
+
+Engine::Engine(const Binding *bindings, size_t count)
+    : m_bindings(bindings), m_count(count), m_states(count) {}
+
+void Engine::SetGate(Gate gate, void *context) {
+  m_gate = gate;
+  m_gateContext = context;
+}
+
+void Engine::SetGuard(Guard guard, void *context) {
+  m_guard = guard;
+  m_guardContext = context;
+}
+
+bool Engine::GateOpen() {
+  if (m_gateResult < 0)
+    m_gateResult = (!m_gate || m_gate(m_gateContext)) ? 1 : 0;
+  return m_gateResult == 1;
+}
+
+void Engine::Update(const Sample &sample, std::vector<Event> &events) {
+  m_gateResult = -1;
+  const uint64_t now = sample.timeMs;
+
+  for (size_t i = 0; i < m_count; i++) {
+    const Binding &binding = m_bindings[i];
+    State &state = m_states[i];
+    const uint32_t key = Bit(binding.key);
+    const bool keyDown = (sample.down & key) != 0;
+    const bool keyReleased = (sample.released & key) != 0;
+    const bool keyPressed = (sample.pressed & key) != 0;
+    const bool modifiersOk = (sample.down & binding.required) == binding.required &&
+                             (sample.down & binding.excluded) == 0;
+
+    if (!m_primed) {
+      // Held before the first sample: not a press
+      state.down = binding.gesture == GESTURE_CHORD ? keyDown && modifiersOk : keyDown;
+      continue;
+    }
+
+    if (binding.gesture != GESTURE_HOLD) {
+      // PRESS: the key's own edge; CHORD: the whole combination's edge
+      bool active = binding.gesture == GESTURE_CHORD ? keyDown && modifiersOk : keyDown;
+      // Tap between samples: down and up again, only seen through the masks
+      bool tap = !keyDown && keyPressed && keyReleased;
+      bool edge = (active && (!state.down || keyReleased)) || tap;
+      state.down = active;
+      if (edge && modifiersOk && (!binding.gated || GateOpen()))
+        events.push_back({binding.action, EVENT_TRIGGER, now});
+      continue;
+    }
+
+    // HOLD: release first, so a release + re-press between samples is
+    // reported as both
+    if (state.down && (!keyDown || keyReleased)) {
+      if (state.accepted)
+        events.push_back({binding.action, EVENT_RELEASE, now});
+      state.down = false;
+      state.accepted = false;
+      state.holdWaiting = false;
+      state.releaseMs = now;
+      state.released = true;
+    }
+
+    // Tap between samples: press (below) and release again in this sample
+    const bool tap = !keyDown && !state.down && keyPressed && keyReleased;
+
+    if ((keyDown || tap) && !state.down) {
+      state.down = true;
+      if (modifiersOk && (!binding.gated || GateOpen()) &&
+          (!m_guard || m_guard(binding.action, m_guardContext))) {
+        state.accepted = true;
+        if (binding.doubleTapMs > 0 && state.released &&
+            now - state.releaseMs < (uint64_t)binding.doubleTapMs) {
+          events.push_back({binding.action, EVENT_DOUBLE_TAP, now});
+          if (binding.latch)
+            state.latched = !state.latched;
+        } else {
+          state.holdWaiting = true;
+          state.pressMs = now;
+          events.push_back({binding.action, EVENT_PRESS, now});
+        }
+      }
+    }
+
+    if (keyDown && state.holdWaiting && now - state.pressMs >= (uint64_t)binding.holdMs) {
+      state.holdWaiting = false;
+      events.push_back({binding.action, EVENT_HOLD, now});
+    }
+
+    if (tap) {
+      if (state.accepted)
+        events.push_back({binding.action, EVENT_RELEASE, now});
+      state.down = false;
+      state.accepted = false;
+      state.holdWaiting = false;
+      state.releaseMs = now;
+      state.released = true;
+    }
+  }
+  m_primed = true;
+}
+
+bool Engine::HoldPending() const {
+  for (const State &state : m_states) {
+    if (state.holdWaiting)
+      return true;
+  }
+  return false;
+}
+
+bool Engine::IsActive(int action) const {
+  for (size_t i = 0; i < m_count; i++) {
+    if (m_bindings[i].action == action && m_states[i].accepted)
+      return true;
+  }
+  return false;
+}
+
+bool Engine::IsLatched(int action) const {
+  for (size_t i = 0; i < m_count; i++) {
+    if (m_bindings[i].action == action && m_states[i].latched)
+      return true;
+  }
+  return false;
+}
+
+void Engine::Unlatch(int action) {
+  for (size_t i = 0; i < m_count; i++) {
+    if (m_bindings[i].action == action)
+      m_states[i].latched = false;
+  }
+}
+
+void Engine::Reset() {
+  for (State &state : m_states)
+    state = State();
+  m_primed = false;
+  m_gateResult = -1;
+}
+
+} // namespace InputEngine
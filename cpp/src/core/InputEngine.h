@@ -0,0 +1,151 @@
+/*****************************************************************************
+ * InputEngine.h
+ *
+ * Table-driven trigger detection (hold / double-tap / chord / press)
+ *
+ * IdleHook samples the keyboard and mouse once per tick and feeds the
+ * Sample to an Engine built from a Binding table. The engine keeps the
+ * per-binding edge/hold state and emits high-level events (Hold(Y),
+ * DoubleTap(Y), Chord(RShift+K), Press(D)), so module code reacts to
+ * events instead of tracking its own "was held" booleans and timers.
+ *
+ * Every gesture that was accepted on press gets exactly one EVENT_RELEASE,
+ * also when the key went up and down again between two samples, or was
+ * tapped entirely between them (reported through Sample::pressed /
+ * released by edge-based sources).
+ *
+ * Timing (hold delay, double-tap window) and latching live in the table,
+ * so the host keeps no input timers or mode flags of its own.
+ *
+ * The input gate (IsKeyInputAllowed) is evaluated lazily, at most once per
+ * Update, and only when a gated binding sees its edge.
+ *
+ * Platform-neutral (no AE / Win32 dependencies): traces replay on Linux.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace InputEngine {
+
+// Logical inputs (one bit each in Sample masks)
+enum Input {
+  INPUT_Y = 0,
+  INPUT_E,
+  INPUT_D,
+  INPUT_K,
+  INPUT_SHIFT,  // Either Shift
+  INPUT_RSHIFT, // Right Shift only
+  INPUT_CTRL,
+  INPUT_ALT,
+  INPUT_MOUSE_LEFT,
+  INPUT_COUNT
+};
+
+inline uint32_t Bit(Input input) { return 1u << input; }
+
+// Input state at one point in time
+// pressed / released come from edge sources (key hook); polling leaves them
+// 0 and only sees transitions that last across a sample.
+struct Sample {
+  uint64_t timeMs = 0;   // Monotonic
+  uint32_t down = 0;     // Inputs held
+  uint32_t pressed = 0;  // Went down at least once since the previous sample
+  uint32_t released = 0; // Went up at least once since the previous sample
+};
+
+enum Gesture {
+  GESTURE_PRESS,     // Key goes down with the modifiers already held
+  GESTURE_CHORD,     // Key + modifiers complete, in any order
+  GESTURE_HOLD       // Press held for holdMs (optional double-tap)
+};
+
+struct Binding {
+  int action;        // Host action id (Event::action)
+  Gesture gesture;
+  Input key;
+  uint32_t required; // Inputs that must be held with the key
+  uint32_t excluded; // Inputs that must not be held
+  bool gated;        // Needs the input gate (IsKeyInputAllowed)
+  int holdMs;        // GESTURE_HOLD: hold delay
+  int doubleTapMs;   // GESTURE_HOLD: press within this after a release
+                     // -> EVENT_DOUBLE_TAP instead of a hold (0 = off)
+  bool latch;        // GESTURE_HOLD: EVENT_DOUBLE_TAP toggles the binding's
+                     // latch (IsLatched), e.g. a sticky "toggle mode"
+};
+
+enum EventType {
+  EVENT_TRIGGER,    // PRESS / CHORD edge
+  EVENT_PRESS,      // HOLD binding accepted a press (hold timer started)
+  EVENT_HOLD,       // Held for holdMs
+  EVENT_DOUBLE_TAP, // Second press within doubleTapMs
+  EVENT_RELEASE     // End of an accepted HOLD-binding gesture
+};
+
+struct Event {
+  int action;
+  EventType type;
+  uint64_t timeMs; // Sample time the event was decided at
+};
+
+// Input gate: true if key triggers may fire now
+typedef bool (*Gate)(void *context);
+
+// Press guard for HOLD bindings: false = ignore this press (no hold,
+// double-tap or release events)
+typedef bool (*Guard)(int action, void *context);
+
+class Engine {
+public:
+  Engine(const Binding *bindings, size_t count);
+
+  void SetGate(Gate gate, void *context);
+  void SetGuard(Guard guard, void *context);
+
+  // Process one sample; appends events in binding order
+  void Update(const Sample &sample, std::vector<Event> &events);
+
+  // True while a HOLD binding waits for its hold delay
+  bool HoldPending() const;
+
+  // True while the binding's accepted gesture is still held
+  bool IsActive(int action) const;
+
+  // Latch state of a Binding::latch binding (set / cleared by double-tap)
+  bool IsLatched(int action) const;
+
+  // Clear the latch (the host consumed the latched mode, e.g. by a click)
+  void Unlatch(int action);
+
+  // Forget all state (keys held at the next sample count as new presses
+  // only after they are released)
+  void Reset();
+
+private:
+  struct State {
+    bool down = false;      // Key (or chord) seen down
+    bool accepted = false;  // Press passed gate / guard
+    bool holdWaiting = false;
+    uint64_t pressMs = 0;
+    uint64_t releaseMs = 0;
+    bool released = false;  // releaseMs is valid
+    bool latched = false;   // Binding::latch toggled by double-tap
+  };
+
+  bool GateOpen();
+
+  const Binding *m_bindings;
+  size_t m_count;
+  std::vector<State> m_states;
+  Gate m_gate = nullptr;
+  void *m_gateContext = nullptr;
+  Guard m_guard = nullptr;
+  void *m_guardContext = nullptr;
+  int m_gateResult = -1; // Per Update: -1 not evaluated, 0 closed, 1 open
+  bool m_primed = false; // First sample seen (held keys are not presses)
+};
+
+} // namespace InputEngine
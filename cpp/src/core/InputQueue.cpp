@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * InputQueue.cpp
+ *
+ * SPSC key event ring (see InputQueue.h)
+ *****************************************************************************/
+
+#include "InputQueue.h"
+
+namespace InputQueue {
+
+static const size_t MASK = Ring::CAPACITY - 1;
+
+bool Ring::Push(const KeyEvent &event) {
+  size_t head = m_head.load(std::memory_order_relaxed);
+  if (head - m_tail.load(std::memory_order_acquire) >= CAPACITY) {
+    m_dropped.fetch_add(1, std::memory_order_release);
+    return false;
+  }
+  m_slots[head & MASK] = event;
+  m_head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+bool Ring::Pop(KeyEvent &event) {
+  size_t tail = m_tail.load(std::memory_order_relaxed);
+  if (tail == m_head.load(std::memory_order_acquire))
+    return false;
+  event = m_slots[tail & MASK];
+  m_tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+size_t Ring::Size() const {
+  return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+}
+
+bool Drain(Ring &ring, Cursor &cursor, uint32_t extraDown,
+           std::vector<InputEngine::Sample> &samples) {
+  KeyEvent event;
+  while (ring.Pop(event)) {
+    uint32_t bit = 1u << event.input;
+    InputEngine::Sample sample;
+    sample.timeMs = event.timeUs / 1000;
+    if (sample.timeMs < cursor.lastMs)
+      sample.timeMs = cursor.lastMs;
+    cursor.lastMs = sample.timeMs;
+    if (event.down) {
+      cursor.down |= bit;
+      sample.pressed = bit;
+    } else {
+      cursor.down &= ~bit;
+      sample.released = bit;
+    }
+    sample.down = cursor.down | extraDown;
+    samples.push_back(sample);
+  }
+
+  uint64_t dropped = ring.Dropped();
+  bool complete = dropped == cursor.dropped;
+  cursor.dropped = dropped;
+  return complete;
+}
+
+} // namespace InputQueue
@@ -0,0 +1,82 @@
+/*****************************************************************************
+ * InputQueue.h
+ *
+ * Key transitions from the keyboard hook thread to IdleHook
+ *
+ * IdleHook only samples key state when AE calls it, so taps shorter than
+ * one idle tick were lost and double-tap timing followed AE's idle jitter.
+ * The low-level keyboard hook (KeyboardMonitor::StartKeyHook) runs on its
+ * own thread, stamps every transition of the trigger keys and pushes it
+ * into a Ring; PollInput drains the ring and replays each transition into
+ * the InputEngine at its own timestamp.
+ *
+ * Ring: bounded single-producer / single-consumer, lock-free (one atomic
+ * index per side). When full the producer drops the new event and counts
+ * it; the consumer then resyncs its key state from a poll (Drain returns
+ * false), so an overflow costs precision, never a stuck key.
+ *
+ * Platform-neutral (no AE / Win32 dependencies): the bench runs a
+ * high-rate producer thread against it on Linux.
+ *****************************************************************************/
+
+#pragma once
+
+#include "InputEngine.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace InputQueue {
+
+// One key transition
+struct KeyEvent {
+  uint64_t timeUs = 0; // steady_clock, stamped on the hook thread
+  uint8_t input = 0;   // InputEngine::Input
+  bool down = false;
+};
+
+class Ring {
+public:
+  static const size_t CAPACITY = 256; // Power of two
+
+  // Producer side (hook thread). false = full, event dropped
+  bool Push(const KeyEvent &event);
+
+  // Consumer side (IdleHook). false = empty
+  bool Pop(KeyEvent &event);
+
+  // Approximate from either side
+  size_t Size() const;
+
+  // Events dropped because the ring was full (monotonic)
+  uint64_t Dropped() const { return m_dropped.load(std::memory_order_acquire); }
+
+private:
+  // Head / tail on separate cache lines: each side writes only its own
+  alignas(64) std::atomic<size_t> m_head{0}; // Next slot to write (producer)
+  alignas(64) std::atomic<size_t> m_tail{0}; // Next slot to read (consumer)
+  alignas(64) std::atomic<uint64_t> m_dropped{0};
+  KeyEvent m_slots[CAPACITY];
+};
+
+// Consumer state between drains
+struct Cursor {
+  uint32_t down = 0;    // Hooked inputs held after the last drained event
+  uint64_t dropped = 0; // Ring::Dropped() seen at the last drain
+  uint64_t lastMs = 0;  // Sample times never go backwards
+};
+
+/**
+ * Drain the ring into one InputEngine sample per transition
+ * (timeMs = event time, down = cursor.down | extraDown)
+ *
+ * @param extraDown  polled inputs the hook does not see (mouse button)
+ * @return false if events were dropped since the last drain: the caller
+ *         resyncs cursor.down from a poll before its closing sample
+ */
+bool Drain(Ring &ring, Cursor &cursor, uint32_t extraDown,
+           std::vector<InputEngine::Sample> &samples);
+
+} // namespace InputQueue
@@ -19,6 +19,10 @@
 
 #include "KeyboardMonitor.h"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #ifdef MSWindows
 #include <windows.h>
 #endif
@@ -115,6 +119,143 @@ void GetMousePosition(int *x, int *y) {
 
 #endif
 
+/*****************************************************************************
+ * Key hook
+ * Windows: WH_KEYBOARD_LL on a dedicated message-loop thread.
+ * The hook proc runs on that thread, so s_hookKeys needs no lock; it only
+ * maps the key, stamps it and pushes (LL hooks must return quickly).
+ *****************************************************************************/
+static std::atomic<bool> s_hookRunning{false};
+
+#ifdef MSWindows
+static InputQueue::Ring *s_hookRing = nullptr;
+static std::thread s_hookThread;
+static DWORD s_hookThreadId = 0;
+static HHOOK s_hook = NULL;
+static uint32_t s_hookKeys = 0; // Physical keys held (hook thread only)
+
+// Physical key bits (left / right modifiers separately)
+enum HookKey {
+  HOOK_Y, HOOK_E, HOOK_D, HOOK_K,
+  HOOK_LSHIFT, HOOK_RSHIFT, HOOK_LCTRL, HOOK_RCTRL, HOOK_LALT, HOOK_RALT
+};
+
+static int HookKeyFor(DWORD vk) {
+  switch (vk) {
+  case KEY_Y: return HOOK_Y;
+  case KEY_E: return HOOK_E;
+  case KEY_D: return HOOK_D;
+  case KEY_K: return HOOK_K;
+  case VK_LSHIFT: return HOOK_LSHIFT;
+  case VK_RSHIFT: return HOOK_RSHIFT;
+  case VK_LCONTROL: return HOOK_LCTRL;
+  case VK_RCONTROL: return HOOK_RCTRL;
+  case VK_LMENU: return HOOK_LALT;
+  case VK_RMENU: return HOOK_RALT;
+  default: return -1;
+  }
+}
+
+// Physical keys -> InputEngine inputs
+static uint32_t LogicalInputs(uint32_t keys) {
+  using namespace InputEngine;
+  auto has = [keys](int key) { return (keys & (1u << key)) != 0; };
+  uint32_t inputs = 0;
+  if (has(HOOK_Y)) inputs |= Bit(INPUT_Y);
+  if (has(HOOK_E)) inputs |= Bit(INPUT_E);
+  if (has(HOOK_D)) inputs |= Bit(INPUT_D);
+  if (has(HOOK_K)) inputs |= Bit(INPUT_K);
+  if (has(HOOK_LSHIFT) || has(HOOK_RSHIFT)) inputs |= Bit(INPUT_SHIFT);
+  if (has(HOOK_RSHIFT)) inputs |= Bit(INPUT_RSHIFT);
+  if (has(HOOK_LCTRL) || has(HOOK_RCTRL)) inputs |= Bit(INPUT_CTRL);
+  if (has(HOOK_LALT) || has(HOOK_RALT)) inputs |= Bit(INPUT_ALT);
+  return inputs;
+}
+
+static LRESULT CALLBACK LowLevelKeyboardProc(int nCode, WPARAM wParam, LPARAM lParam) {
+  if (nCode == HC_ACTION) {
+    const KBDLLHOOKSTRUCT *info = (const KBDLLHOOKSTRUCT *)lParam;
+    int key = HookKeyFor(info->vkCode);
+    if (key >= 0) {
+      bool down = wParam == WM_KEYDOWN || wParam == WM_SYSKEYDOWN;
+      uint32_t before = LogicalInputs(s_hookKeys);
+      if (down)
+        s_hookKeys |= 1u << key;
+      else
+        s_hookKeys &= ~(1u << key);
+      // Auto-repeat and the second Shift of a pair change nothing
+      uint32_t changed = before ^ LogicalInputs(s_hookKeys);
+      if (changed) {
+        InputQueue::KeyEvent event;
+        event.timeUs = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count();
+        event.down = down;
+        for (uint8_t input = 0; input < InputEngine::INPUT_COUNT; input++) {
+          if (changed & (1u << input)) {
+            event.input = input;
+            s_hookRing->Push(event);
+          }
+        }
+      }
+    }
+  }
+  return CallNextHookEx(NULL, nCode, wParam, lParam);
+}
+
+bool StartKeyHook(InputQueue::Ring *ring) {
+  if (s_hookRunning || !ring)
+    return s_hookRunning;
+  s_hookRing = ring;
+  s_hookKeys = 0;
+
+  // The hook must be installed on the thread that pumps its messages
+  std::atomic<int> started{0}; // 0 pending, 1 installed, -1 failed
+  s_hookThread = std::thread([&started]() {
+    s_hookThreadId = GetCurrentThreadId();
+    s_hook = SetWindowsHookExW(WH_KEYBOARD_LL, LowLevelKeyboardProc,
+                               GetModuleHandleW(NULL), 0);
+    started = s_hook ? 1 : -1;
+    if (!s_hook)
+      return;
+    MSG msg;
+    while (GetMessageW(&msg, NULL, 0, 0) > 0) {
+    }
+    UnhookWindowsHookEx(s_hook);
+    s_hook = NULL;
+  });
+  while (started == 0)
+    std::this_thread::yield();
+
+  if (started < 0) {
+    s_hookThread.join();
+    return false;
+  }
+  s_hookRunning = true;
+  return true;
+}
+
+void StopKeyHook() {
+  if (!s_hookRunning)
+    return;
+  PostThreadMessageW(s_hookThreadId, WM_QUIT, 0, 0);
+  s_hookThread.join();
+  s_hookRunning = false;
+}
+
+#else
+
+bool StartKeyHook(InputQueue::Ring *ring) {
+  (void)ring;
+  return false;
+}
+
+void StopKeyHook() {}
+
+#endif
+
+bool IsKeyHookRunning() { return s_hookRunning; }
+
 bool IsMouseButtonPressed() {
 #ifdef MSWindows
   return (GetAsyncKeyState(VK_LBUTTON) & 0x8000) != 0;
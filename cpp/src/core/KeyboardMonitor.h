@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include "InputQueue.h"
+
 #ifdef MAC_ENV
 #include <Carbon/Carbon.h>
 #include <CoreGraphics/CoreGraphics.h>
@@ -73,4 +75,16 @@ void GetMousePosition(int *x, int *y);
  */
 bool IsMouseButtonPressed();
 
+/**
+ * Low-level keyboard hook thread (Windows: WH_KEYBOARD_LL)
+ * Pushes timestamped transitions of the trigger keys (Y/E/D/K, Shift,
+ * Right Shift, Ctrl, Alt) into the ring; key repeats are filtered and no
+ * other keys are recorded. macOS returns false (an event tap needs the
+ * accessibility permission) and input stays polled.
+ * @return true if the hook is installed
+ */
+bool StartKeyHook(InputQueue::Ring *ring);
+void StopKeyHook();
+bool IsKeyHookRunning();
+
 } // namespace KeyboardMonitor
@@ -0,0 +1,496 @@
+/*****************************************************************************
+ * Logger.cpp
+ *
+ * Asynchronous binary logger (see Logger.h)
+ *
+ * Ring: bounded multi-producer / single-consumer queue of 64-byte slots
+ * (Vyukov). Each slot carries a sequence number: slot free for position p
+ * when seq == p, published when seq == p + 1. A record spans consecutive
+ * slots; the producer claims them all with one CAS on the head after
+ * checking the last one is free (slots are freed in order, so the earlier
+ * ones are free too), copies the bytes and publishes the slots.
+ *****************************************************************************/
+
+#include "Logger.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace Logger {
+
+std::atomic<uint8_t> g_levels[CAT_COUNT] = {LEVEL_INFO, LEVEL_INFO, LEVEL_INFO,
+                                            LEVEL_INFO, LEVEL_INFO, LEVEL_INFO};
+
+static const size_t SLOT_COUNT = 32768; // 2 MB
+static const size_t SLOT_MASK = SLOT_COUNT - 1;
+static const size_t SLOT_DATA = 56;
+static const int FLUSH_INTERVAL_MS = 50;
+// Producers wake the flusher each time the head crosses a quarter of the
+// ring, so a burst is drained while it lasts instead of every 50 ms
+static const uint64_t NUDGE_SLOTS = SLOT_COUNT / 4;
+
+struct Slot {
+  std::atomic<uint64_t> seq;
+  char data[SLOT_DATA];
+};
+static_assert(sizeof(Slot) == 64, "one slot per cache line");
+
+static Slot s_slots[SLOT_COUNT];
+alignas(64) static std::atomic<uint64_t> s_head{0}; // Next position to claim
+alignas(64) static uint64_t s_tail = 0;             // Next position to read (flusher)
+static std::atomic<uint32_t> s_sequence{0};
+
+// Per-category rate window (whole seconds of the record clock)
+static std::atomic<uint64_t> s_rateSecond[CAT_COUNT];
+static std::atomic<uint32_t> s_rateCount[CAT_COUNT];
+static std::atomic<uint32_t> s_rateLimit{1000};
+
+static std::atomic<uint64_t> s_logged{0};
+static std::atomic<uint64_t> s_droppedFull{0};
+static std::atomic<uint64_t> s_droppedRate{0};
+static std::atomic<uint64_t> s_filtered{0};
+static std::atomic<uint64_t> s_written{0}; // Written by the flusher thread
+static std::atomic<uint64_t> s_bytes{0};
+static uint64_t s_reportedFull = 0; // Drops already reported (flusher)
+static uint64_t s_reportedRate = 0;
+
+static std::atomic<bool> s_running{false};
+static FILE *s_file = nullptr;
+static uint64_t s_startUs = 0;
+static DebugSink s_sink = nullptr;
+static void *s_sinkContext = nullptr;
+
+// Flusher thread and Flush() handshake (never touched by Log)
+static std::thread s_thread;
+static std::mutex s_mutex;
+static std::condition_variable s_wake;
+static std::condition_variable s_drained;
+static bool s_stop = false;
+static bool s_flushRequested = false;
+static std::atomic<bool> s_nudged{false}; // Set by producers (no mutex)
+static uint64_t s_drainedTo = 0; // Ring position written so far
+
+static bool s_ringInitialized = false;
+
+static uint64_t NowUs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static void InitRing() {
+  if (s_ringInitialized)
+    return;
+  s_ringInitialized = true;
+  for (size_t i = 0; i < SLOT_COUNT; i++)
+    s_slots[i].seq.store(i, std::memory_order_relaxed);
+  s_head.store(0, std::memory_order_relaxed);
+  s_tail = 0;
+}
+
+const char *LevelName(Level level) {
+  static const char *kNames[] = {"DEBUG", "INFO", "WARN", "ERROR", "OFF"};
+  return level <= LEVEL_OFF ? kNames[level] : "?";
+}
+
+const char *CategoryName(Category category) {
+  static const char *kNames[] = {"general", "input", "script", "catalog", "idle", "profile"};
+  return category < CAT_COUNT ? kNames[category] : "?";
+}
+
+void SetLevel(Category category, Level level) {
+  if (category < CAT_COUNT)
+    g_levels[category].store(level, std::memory_order_relaxed);
+}
+
+Level GetLevel(Category category) {
+  return category < CAT_COUNT ? (Level)g_levels[category].load(std::memory_order_relaxed)
+                              : LEVEL_OFF;
+}
+
+static bool EqualsNoCase(std::string_view a, std::string_view b) {
+  return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return (x | 0x20) == (y | 0x20);
+         });
+}
+
+bool ParseLevels(const char *spec) {
+  if (!spec)
+    return true;
+  bool ok = true;
+  std::string_view rest(spec);
+  while (!rest.empty()) {
+    size_t comma = rest.find(',');
+    std::string_view item = rest.substr(0, comma);
+    rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+
+    size_t eq = item.find('=');
+    if (eq == std::string_view::npos) {
+      ok = false;
+      continue;
+    }
+    std::string_view name = item.substr(0, eq);
+    std::string_view value = item.substr(eq + 1);
+    int level = -1;
+    for (int l = LEVEL_DEBUG; l <= LEVEL_OFF; l++) {
+      if (EqualsNoCase(value, LevelName((Level)l)))
+        level = l;
+    }
+    bool matched = false;
+    for (int c = 0; c < CAT_COUNT && level >= 0; c++) {
+      if (name == "*" || EqualsNoCase(name, CategoryName((Category)c))) {
+        SetLevel((Category)c, (Level)level);
+        matched = true;
+      }
+    }
+    ok = ok && matched;
+  }
+  return ok;
+}
+
+void SetRateLimit(uint32_t perSecond) { s_rateLimit.store(perSecond); }
+
+void SetDebugSink(DebugSink sink, void *context) {
+  s_sink = sink;
+  s_sinkContext = context;
+}
+
+/*****************************************************************************
+ * Producer side (any thread, never blocks)
+ *****************************************************************************/
+static bool RateAllows(Category category, uint64_t timeUs) {
+  uint32_t limit = s_rateLimit.load(std::memory_order_relaxed);
+  if (limit == 0)
+    return true;
+  uint64_t second = timeUs / 1000000;
+  uint64_t window = s_rateSecond[category].load(std::memory_order_relaxed);
+  if (window != second &&
+      s_rateSecond[category].compare_exchange_strong(window, second,
+                                                     std::memory_order_relaxed)) {
+    s_rateCount[category].store(0, std::memory_order_relaxed);
+  }
+  return s_rateCount[category].fetch_add(1, std::memory_order_relaxed) < limit;
+}
+
+static bool Push(Category category, Level level, uint64_t timeUs, uint32_t sequence,
+                 const char *text, size_t length) {
+  if (length > MAX_MESSAGE)
+    length = MAX_MESSAGE;
+  const size_t total = sizeof(RecordHeader) + length;
+  const uint64_t need = (total + SLOT_DATA - 1) / SLOT_DATA;
+
+  // Claim `need` consecutive positions
+  uint64_t pos = s_head.load(std::memory_order_relaxed);
+  for (;;) {
+    uint64_t last = pos + need - 1;
+    uint64_t seq = s_slots[last & SLOT_MASK].seq.load(std::memory_order_acquire);
+    if (seq == last) {
+      if (s_head.compare_exchange_weak(pos, pos + need, std::memory_order_relaxed))
+        break;
+    } else if (seq < last) {
+      s_droppedFull.fetch_add(1, std::memory_order_relaxed);
+      return false; // Full: the flusher has not freed the slot yet
+    } else {
+      pos = s_head.load(std::memory_order_relaxed); // Another producer won
+    }
+  }
+
+  RecordHeader header;
+  header.timeUs = timeUs - s_startUs;
+  header.sequence = sequence;
+  header.level = level;
+  header.category = category;
+  header.length = (uint16_t)length;
+
+  // Copy header + text across the slots, then publish them in order
+  size_t copied = 0;
+  for (uint64_t k = 0; k < need; k++) {
+    Slot &slot = s_slots[(pos + k) & SLOT_MASK];
+    size_t chunk = total - copied < SLOT_DATA ? total - copied : SLOT_DATA;
+    for (size_t i = 0; i < chunk; i++, copied++) {
+      slot.data[i] = copied < sizeof(header) ? ((const char *)&header)[copied]
+                                             : text[copied - sizeof(header)];
+    }
+  }
+  for (uint64_t k = 0; k < need; k++)
+    s_slots[(pos + k) & SLOT_MASK].seq.store(pos + k + 1, std::memory_order_release);
+  s_logged.fetch_add(1, std::memory_order_relaxed);
+
+  // A wake-up lost to the race with wait_for costs one interval at most
+  if (pos / NUDGE_SLOTS != (pos + need) / NUDGE_SLOTS &&
+      !s_nudged.exchange(true, std::memory_order_relaxed)) {
+    s_wake.notify_one();
+  }
+  return true;
+}
+
+bool LogText(Category category, Level level, std::string_view text) {
+  if (!s_running.load(std::memory_order_acquire))
+    return false;
+  if (!ShouldLog(category, level)) {
+    s_filtered.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  uint64_t now = NowUs();
+  if (!RateAllows(category, now)) {
+    s_droppedRate.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  uint32_t sequence = s_sequence.fetch_add(1, std::memory_order_relaxed);
+  return Push(category, level, now, sequence, text.data(), text.size());
+}
+
+bool Log(Category category, Level level, const char *format, ...) {
+  if (!s_running.load(std::memory_order_acquire))
+    return false;
+  if (!ShouldLog(category, level)) {
+    s_filtered.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  uint64_t now = NowUs();
+  if (!RateAllows(category, now)) {
+    s_droppedRate.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  uint32_t sequence = s_sequence.fetch_add(1, std::memory_order_relaxed);
+  char buffer[MAX_MESSAGE + 1];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length < 0)
+    length = 0;
+  return Push(category, level, now, sequence, buffer,
+              (size_t)length < MAX_MESSAGE ? (size_t)length : MAX_MESSAGE);
+}
+
+/*****************************************************************************
+ * Flusher thread
+ *****************************************************************************/
+static void WriteRecord(const RecordHeader &header, const char *text) {
+  if (s_file) {
+    fwrite(&header, sizeof(header), 1, s_file);
+    fwrite(text, 1, header.length, s_file);
+  }
+  s_written++;
+  s_bytes += sizeof(header) + header.length;
+  if (s_sink) {
+    Record record;
+    record.header = header;
+    record.text = std::string_view(text, header.length);
+    std::string line = FormatRecord(record) + "\n";
+    s_sink(line.c_str(), s_sinkContext);
+  }
+}
+
+// Write every fully published record; returns the ring position reached
+static uint64_t Drain() {
+  char text[MAX_MESSAGE];
+  for (;;) {
+    Slot &first = s_slots[s_tail & SLOT_MASK];
+    if (first.seq.load(std::memory_order_acquire) != s_tail + 1)
+      break;
+    RecordHeader header;
+    memcpy(&header, first.data, sizeof(header));
+    const size_t total = sizeof(header) + header.length;
+    const uint64_t need = (total + SLOT_DATA - 1) / SLOT_DATA;
+    // The producer publishes its slots in order: wait for the last one
+    uint64_t last = s_tail + need - 1;
+    if (s_slots[last & SLOT_MASK].seq.load(std::memory_order_acquire) != last + 1)
+      break;
+
+    size_t copied = 0;
+    for (uint64_t k = 0; k < need; k++) {
+      Slot &slot = s_slots[(s_tail + k) & SLOT_MASK];
+      size_t chunk = total - copied < SLOT_DATA ? total - copied : SLOT_DATA;
+      for (size_t i = 0; i < chunk; i++, copied++) {
+        if (copied >= sizeof(header))
+          text[copied - sizeof(header)] = slot.data[i];
+      }
+    }
+    for (uint64_t k = 0; k < need; k++) {
+      s_slots[(s_tail + k) & SLOT_MASK].seq.store(s_tail + k + SLOT_COUNT,
+                                                  std::memory_order_release);
+    }
+    s_tail += need;
+    WriteRecord(header, text);
+  }
+  return s_tail;
+}
+
+// Dropped counts since the last report, as one WARN record
+static void ReportDrops(uint64_t &reportedFull, uint64_t &reportedRate) {
+  uint64_t full = s_droppedFull.load(std::memory_order_relaxed);
+  uint64_t rate = s_droppedRate.load(std::memory_order_relaxed);
+  if (full < reportedFull || rate < reportedRate) // ResetStats
+    reportedFull = reportedRate = 0;
+  if (full == reportedFull && rate == reportedRate)
+    return;
+  char text[128];
+  int length = snprintf(text, sizeof(text), "logger: dropped %llu (ring full), %llu (rate limit)",
+                        (unsigned long long)(full - reportedFull),
+                        (unsigned long long)(rate - reportedRate));
+  reportedFull = full;
+  reportedRate = rate;
+  RecordHeader header;
+  header.timeUs = NowUs() - s_startUs;
+  header.sequence = UINT32_MAX; // Not a caller record
+  header.level = LEVEL_WARN;
+  header.category = CAT_GENERAL;
+  header.length = (uint16_t)length;
+  WriteRecord(header, text);
+}
+
+static void FlusherMain() {
+  uint64_t reportedFull = s_reportedFull;
+  uint64_t reportedRate = s_reportedRate;
+  std::unique_lock<std::mutex> lock(s_mutex);
+  for (;;) {
+    s_wake.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL_MS),
+                    [] { return s_stop || s_flushRequested || s_nudged.load(); });
+    s_nudged.store(false, std::memory_order_relaxed);
+    bool stopping = s_stop;
+    s_flushRequested = false;
+    lock.unlock();
+
+    uint64_t reached = Drain();
+    ReportDrops(reportedFull, reportedRate);
+    if (s_file)
+      fflush(s_file);
+
+    lock.lock();
+    s_drainedTo = reached;
+    s_drained.notify_all();
+    if (stopping) {
+      s_reportedFull = reportedFull;
+      s_reportedRate = reportedRate;
+      break;
+    }
+  }
+}
+
+bool Start(const std::string &path) {
+  if (s_running)
+    return true;
+  InitRing();
+  s_file = fopen(path.c_str(), "ab");
+  if (!s_file)
+    return false;
+
+  s_startUs = NowUs();
+  FileHeader header;
+  memcpy(header.magic, "ASLG", 4);
+  header.version = FILE_VERSION;
+  header.size = sizeof(FileHeader);
+  header.startUs = s_startUs;
+  fwrite(&header, sizeof(header), 1, s_file);
+  s_bytes += sizeof(header);
+
+  // Sequences restart per session (file header)
+  s_sequence = 0;
+  s_reportedFull = s_droppedFull.load();
+  s_reportedRate = s_droppedRate.load();
+  s_stop = false;
+  s_running = true;
+  s_thread = std::thread(FlusherMain);
+  return true;
+}
+
+void Flush() {
+  if (!s_running)
+    return;
+  uint64_t target = s_head.load(std::memory_order_acquire);
+  std::unique_lock<std::mutex> lock(s_mutex);
+  s_flushRequested = true;
+  s_wake.notify_one();
+  // A claimed but unpublished record stops the drain; the next pass gets it
+  s_drained.wait(lock, [target] {
+    if (s_drainedTo < target && !s_flushRequested) {
+      s_flushRequested = true;
+      s_wake.notify_one();
+    }
+    return s_drainedTo >= target;
+  });
+}
+
+void Stop() {
+  if (!s_running)
+    return;
+  Flush();
+  s_running = false;
+  {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_stop = true;
+  }
+  s_wake.notify_one();
+  s_thread.join();
+  if (s_file) {
+    fclose(s_file);
+    s_file = nullptr;
+  }
+}
+
+bool IsRunning() { return s_running; }
+
+Stats GetStats() {
+  Stats stats;
+  stats.logged = s_logged.load();
+  stats.droppedFull = s_droppedFull.load();
+  stats.droppedRate = s_droppedRate.load();
+  stats.filtered = s_filtered.load();
+  stats.written = s_written.load();
+  stats.bytes = s_bytes.load();
+  return stats;
+}
+
+void ResetStats() {
+  s_logged = 0;
+  s_droppedFull = 0;
+  s_droppedRate = 0;
+  s_filtered = 0;
+  s_written = 0;
+  s_bytes = 0;
+}
+
+/*****************************************************************************
+ * Decoding
+ *****************************************************************************/
+bool ReadFileHeader(const char *data, size_t size, size_t &offset, FileHeader &header) {
+  if (offset > size || size - offset < sizeof(FileHeader))
+    return false;
+  memcpy(&header, data + offset, sizeof(header));
+  if (memcmp(header.magic, "ASLG", 4) != 0 || header.version != FILE_VERSION ||
+      header.size != sizeof(FileHeader))
+    return false;
+  offset += sizeof(header);
+  return true;
+}
+
+bool ReadRecord(const char *data, size_t size, size_t &offset, Record &record) {
+  if (offset > size || size - offset < sizeof(RecordHeader))
+    return false;
+  memcpy(&record.header, data + offset, sizeof(RecordHeader));
+  if (record.header.level > LEVEL_ERROR || record.header.category >= CAT_COUNT ||
+      record.header.length > MAX_MESSAGE ||
+      size - offset - sizeof(RecordHeader) < record.header.length)
+    return false;
+  record.text = std::string_view(data + offset + sizeof(RecordHeader), record.header.length);
+  offset += sizeof(RecordHeader) + record.header.length;
+  return true;
+}
+
+std::string FormatRecord(const Record &record) {
+  char prefix[64];
+  snprintf(prefix, sizeof(prefix), "[%6llu.%06llu] %-5s %-7s ",
+           (unsigned long long)(record.header.timeUs / 1000000),
+           (unsigned long long)(record.header.timeUs % 1000000),
+           LevelName((Level)record.header.level), CategoryName((Category)record.header.category));
+  return std::string(prefix) + std::string(record.text);
+}
+
+} // namespace Logger
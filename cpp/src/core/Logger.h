@@ -0,0 +1,152 @@
+/*****************************************************************************
+ * Logger.h
+ *
+ * Asynchronous binary logger
+ *
+ * LogToFile used to vfprintf + fflush + OutputDebugStringA on the calling
+ * (UI) thread, so turning logging on changed the timing being debugged.
+ * Log() now only checks the category level and rate limit, formats into a
+ * stack buffer and copies the record into a lock-free ring; a background
+ * thread writes the records to the log file and the debug sink.
+ *
+ * Callers never block: when the ring is full (or a category exceeds its
+ * rate) the record is dropped and counted, and the flusher writes a
+ * "dropped" record. Sequence numbers make ring drops visible as gaps.
+ *
+ * File format (little-endian):
+ *   FileHeader  "ASLG", version, header size
+ *   records     RecordHeader + length bytes of UTF-8 text (no terminator)
+ * tools/LogDecoder prints a file as text.
+ *
+ * Platform-neutral: the debug sink (OutputDebugStringA) is injected.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Logger {
+
+enum Level : uint8_t { LEVEL_DEBUG = 0, LEVEL_INFO, LEVEL_WARN, LEVEL_ERROR, LEVEL_OFF };
+
+enum Category : uint8_t {
+  CAT_GENERAL = 0,
+  CAT_INPUT,   // Key hook / input engine
+  CAT_SCRIPT,  // ExtendScript calls, library, context cache
+  CAT_CATALOG, // Effect / font catalogs
+  CAT_IDLE,    // Idle scheduler
+  CAT_PROFILE, // Profiler reports
+  CAT_COUNT
+};
+
+const char *LevelName(Level level);
+const char *CategoryName(Category category);
+
+// Longest message (profiler / bench reports fit); longer text is truncated
+const size_t MAX_MESSAGE = 8192;
+
+#pragma pack(push, 1)
+struct FileHeader {
+  char magic[4];     // "ASLG"
+  uint16_t version;  // FILE_VERSION
+  uint16_t size;     // sizeof(FileHeader)
+  uint64_t startUs;  // steady_clock at Start (record times are relative)
+};
+
+struct RecordHeader {
+  uint64_t timeUs;   // Since FileHeader::startUs
+  uint32_t sequence; // Per accepted message of the session; gaps = ring drops
+  uint8_t level;
+  uint8_t category;
+  uint16_t length;   // Text bytes following the header
+};
+#pragma pack(pop)
+
+const uint16_t FILE_VERSION = 1;
+
+/**
+ * Debug sink: called on the flusher thread with each formatted line
+ * (SnapPlugin: OutputDebugStringA for DebugView)
+ */
+typedef void (*DebugSink)(const char *line, void *context);
+
+/**
+ * Open (append to) the log file and start the flusher thread
+ * @return false if the file cannot be opened (Log() then does nothing)
+ */
+bool Start(const std::string &path);
+
+// Write everything queued, stop the thread, close the file
+void Stop();
+
+bool IsRunning();
+
+void SetDebugSink(DebugSink sink, void *context);
+
+// Minimum level per category (default LEVEL_INFO)
+void SetLevel(Category category, Level level);
+Level GetLevel(Category category);
+
+/**
+ * Levels from "input=debug,script=warn" ("*" = every category)
+ * @return false if part of the spec was not understood (the rest applies)
+ */
+bool ParseLevels(const char *spec);
+
+// Messages per second and category before dropping (0 = unlimited)
+void SetRateLimit(uint32_t perSecond);
+
+// Level check without a call (Log() checks again)
+extern std::atomic<uint8_t> g_levels[CAT_COUNT];
+
+inline bool ShouldLog(Category category, Level level) {
+  return category < CAT_COUNT && level < LEVEL_OFF &&
+         level >= g_levels[category].load(std::memory_order_relaxed);
+}
+
+/**
+ * Queue one message (printf format)
+ * @return false if filtered, rate limited or dropped
+ */
+bool Log(Category category, Level level, const char *format, ...);
+
+// Queue pre-formatted text (no formatting cost)
+bool LogText(Category category, Level level, std::string_view text);
+
+/**
+ * Write every record queued so far (blocks the caller; for shutdown and
+ * the bench, not for the UI thread)
+ */
+void Flush();
+
+struct Stats {
+  uint64_t logged = 0;      // Queued records
+  uint64_t written = 0;     // Records written by the flusher
+  uint64_t droppedFull = 0; // Ring full
+  uint64_t droppedRate = 0; // Rate limit
+  uint64_t filtered = 0;    // Below the category level
+  uint64_t bytes = 0;       // File bytes written
+};
+
+Stats GetStats();
+void ResetStats();
+
+/**
+ * Decode one record at data[offset]
+ * Advances offset; false at the end or on a damaged record.
+ */
+struct Record {
+  RecordHeader header;
+  std::string_view text;
+};
+bool ReadFileHeader(const char *data, size_t size, size_t &offset, FileHeader &header);
+bool ReadRecord(const char *data, size_t size, size_t &offset, Record &record);
+
+// "[   12.345678] WARN  input   text"
+std::string FormatRecord(const Record &record);
+
+} // namespace Logger
@@ -0,0 +1,130 @@
+/*****************************************************************************
+ * ModuleRegistry.cpp
+ *
+ * Module table and lifecycle (see ModuleRegistry.h)
+ *****************************************************************************/
+
+#include "ModuleRegistry.h"
+#include "Tracer.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace ModuleRegistry {
+
+struct Module {
+  const char *name;
+  InitFunc init;
+  ShutdownFunc shutdown;
+  State state;
+  uint32_t attempts;
+  uint64_t initNs;
+};
+
+static std::vector<Module> s_modules;
+static std::vector<int> s_initOrder; // READY modules, in initialization order
+
+const char *StateName(State state) {
+  switch (state) {
+  case STATE_REGISTERED:
+    return "registered";
+  case STATE_INITIALIZING:
+    return "initializing";
+  case STATE_READY:
+    return "ready";
+  case STATE_FAILED:
+    return "failed";
+  case STATE_SHUT_DOWN:
+    return "shut down";
+  }
+  return "?";
+}
+
+static uint64_t NowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int Register(const char *name, InitFunc init, ShutdownFunc shutdown) {
+  s_modules.push_back({name ? name : "", init, shutdown, STATE_REGISTERED, 0, 0});
+  return (int)s_modules.size() - 1;
+}
+
+bool Ensure(int id) {
+  if (id < 0 || id >= (int)s_modules.size())
+    return false;
+  Module &module = s_modules[id];
+  if (module.state == STATE_READY)
+    return true;
+  if (module.state == STATE_INITIALIZING || module.state == STATE_SHUT_DOWN)
+    return false;
+
+  TRACE_SCOPE("module", module.name);
+  module.state = STATE_INITIALIZING;
+  module.attempts++;
+  uint64_t start = NowNs();
+  bool ok = !module.init || module.init();
+  // `module` stays valid: registration does not happen during Initialize
+  module.initNs = NowNs() - start;
+  module.state = ok ? STATE_READY : STATE_FAILED;
+  if (ok)
+    s_initOrder.push_back(id);
+  return ok;
+}
+
+State GetState(int id) {
+  if (id < 0 || id >= (int)s_modules.size())
+    return STATE_FAILED;
+  return s_modules[id].state;
+}
+
+void ShutdownAll() {
+  for (auto it = s_initOrder.rbegin(); it != s_initOrder.rend(); ++it) {
+    Module &module = s_modules[*it];
+    if (module.state == STATE_READY && module.shutdown)
+      module.shutdown();
+  }
+  s_initOrder.clear();
+  for (Module &module : s_modules)
+    module.state = STATE_SHUT_DOWN;
+}
+
+std::vector<ModuleStats> GetStats() {
+  std::vector<ModuleStats> stats;
+  for (const Module &module : s_modules) {
+    ModuleStats entry;
+    entry.name = module.name;
+    entry.state = module.state;
+    entry.attempts = module.attempts;
+    entry.initNs = module.initNs;
+    stats.push_back(entry);
+  }
+  return stats;
+}
+
+std::string FormatReport() {
+  int ready = 0;
+  uint64_t totalNs = 0;
+  for (const Module &module : s_modules) {
+    ready += module.state == STATE_READY;
+    totalNs += module.initNs;
+  }
+  char line[160];
+  snprintf(line, sizeof(line), "modules: %zu registered, %d ready, %.2f ms initializing\n",
+           s_modules.size(), ready, (double)totalNs / 1e6);
+  std::string report = line;
+  for (const Module &module : s_modules) {
+    snprintf(line, sizeof(line), "  %-12s %-12s %3u attempts %9.2f ms\n", module.name,
+             StateName(module.state), module.attempts, (double)module.initNs / 1e6);
+    report += line;
+  }
+  return report;
+}
+
+void Reset() {
+  s_modules.clear();
+  s_initOrder.clear();
+}
+
+} // namespace ModuleRegistry
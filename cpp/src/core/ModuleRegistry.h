@@ -0,0 +1,75 @@
+/*****************************************************************************
+ * ModuleRegistry.h
+ *
+ * Lazy initialization of the UI modules
+ *
+ * EntryPointFunc used to initialize all eight UI modules during AE launch
+ * (GDI+ startup, window classes, hidden windows, preset files). Modules are
+ * now only registered at launch; Ensure() runs a module's Initialize on its
+ * first show and records how long it took.
+ *
+ *   REGISTERED --Ensure--> INITIALIZING --ok--> READY --ShutdownAll--> SHUT_DOWN
+ *                                       \--fail--> FAILED (retried by Ensure)
+ *
+ * Main thread only. Platform-neutral: modules are plain function pointers.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ModuleRegistry {
+
+enum State : uint8_t {
+  STATE_REGISTERED = 0, // Known, not initialized yet
+  STATE_INITIALIZING,   // Inside Initialize (re-entrant Ensure fails)
+  STATE_READY,
+  STATE_FAILED,         // Initialize returned false (next Ensure retries)
+  STATE_SHUT_DOWN       // Stays down (AE is quitting)
+};
+
+const char *StateName(State state);
+
+typedef bool (*InitFunc)();
+typedef void (*ShutdownFunc)();
+
+/**
+ * Register a module (cheap: no call into the module)
+ * @param name  literal, shown in reports
+ * @return module id (registration order, from 0)
+ */
+int Register(const char *name, InitFunc init, ShutdownFunc shutdown);
+
+/**
+ * Initialize the module if needed
+ * @return true if the module is READY
+ */
+bool Ensure(int id);
+
+State GetState(int id);
+
+// Shut down every READY module, in reverse initialization order
+void ShutdownAll();
+
+struct ModuleStats {
+  const char *name = "";
+  State state = STATE_REGISTERED;
+  uint32_t attempts = 0; // Initialize calls
+  uint64_t initNs = 0;   // Time of the successful (or last) Initialize
+};
+
+std::vector<ModuleStats> GetStats();
+
+/**
+ * Text report:
+ *   "modules: N registered, M ready, T ns initializing"
+ *   "  name  state  attempts  init time" (one line per module)
+ */
+std::string FormatReport();
+
+// Forget every module (bench)
+void Reset();
+
+} // namespace ModuleRegistry
@@ -0,0 +1,94 @@
+/*****************************************************************************
+ * PanelPrefetch.cpp
+ *
+ * Speculative panel info snapshot (see PanelPrefetch.h)
+ *****************************************************************************/
+
+#include "PanelPrefetch.h"
+#include "ContextCache.h"
+
+namespace PanelPrefetch {
+
+static Query s_query = nullptr;
+static void *s_queryContext = nullptr;
+
+static bool s_pending = false;
+static bool s_ready = false;
+static bool s_used = false;
+static uint64_t s_generation = 0;
+static std::string s_wire; // Owns the section views below
+static std::string_view s_sections[WireFormat::PANEL_FIELD_COUNT];
+static Stats s_stats;
+
+static void Clear() {
+  if (s_ready && !s_used)
+    s_stats.unused++;
+  s_pending = false;
+  s_ready = false;
+  s_used = false;
+  s_wire.clear();
+  for (std::string_view &section : s_sections)
+    section = std::string_view();
+}
+
+void SetQuery(Query query, void *context) {
+  s_query = query;
+  s_queryContext = context;
+  Clear();
+}
+
+void Arm() {
+  Clear();
+  s_pending = true;
+}
+
+bool IsPending() { return s_pending; }
+
+bool Run() {
+  if (!s_pending)
+    return s_ready;
+  s_pending = false;
+  if (!s_query)
+    return false;
+
+  s_stats.snapshots++;
+  bool ok = s_query(s_wire, s_queryContext);
+  WireFormat::Reader reader(s_wire);
+  ok = ok && reader.Next() && reader.FieldCount() >= WireFormat::PANEL_FIELD_COUNT;
+  if (!ok) {
+    s_stats.failures++;
+    s_wire.clear();
+    return false;
+  }
+  for (size_t f = 0; f < WireFormat::PANEL_FIELD_COUNT; f++)
+    s_sections[f] = reader.String(f);
+
+  // The selection section doubles as a ContextCache refresh; the generation
+  // is read after it, so the adopted snapshot counts as current
+  ContextCache::Store(s_sections[WireFormat::PANEL_CONTEXT]);
+  s_generation = ContextCache::Generation();
+  s_ready = true;
+  return true;
+}
+
+std::string_view Section(WireFormat::PanelField field, bool &found) {
+  found = false;
+  if (!s_ready || field >= WireFormat::PANEL_FIELD_COUNT)
+    return std::string_view();
+  if (ContextCache::Generation() != s_generation) {
+    s_stats.stale++;
+    return std::string_view();
+  }
+  s_stats.hits++;
+  s_used = true;
+  found = true;
+  return s_sections[field];
+}
+
+void Discard() { Clear(); }
+
+Stats GetStats() { return s_stats; }
+
+void ResetStats() { s_stats = Stats(); }
+
+} // namespace PanelPrefetch
@@ -0,0 +1,76 @@
+/*****************************************************************************
+ * PanelPrefetch.h
+ *
+ * Speculative panel info snapshot while the D menu is open
+ *
+ * The D menu waits for the user to pick a module, and each module panel
+ * used to open with its own info script (textInfo, shapeInfo, keyframeInfo,
+ * layerInfo). Instead, one panelSnapshot() call runs on the idle tick after
+ * the menu is shown and returns every section in one record (see
+ * WireFormat::PanelField). The chosen panel's Set*Info then reads its
+ * section from memory.
+ *
+ * A snapshot is only used for the ContextCache generation it was taken in:
+ * anything that invalidates the selection context also stales the snapshot,
+ * and the panel falls back to its own script.
+ *
+ * Platform-neutral: the host query is injected (SetQuery), like
+ * ContextCache, so the prefetch runs against a mock host.
+ *****************************************************************************/
+
+#pragma once
+
+#include "WireFormat.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace PanelPrefetch {
+
+/**
+ * Host query: run panelSnapshot() and return its wire result.
+ * @return false if the host call failed
+ */
+typedef bool (*Query)(std::string &wire, void *context);
+
+void SetQuery(Query query, void *context);
+
+// D menu shown: run the snapshot on the next Run()
+void Arm();
+
+// True if armed and not run yet
+bool IsPending();
+
+/**
+ * Run the armed snapshot (IdleHook, while the menu is visible)
+ * Also hands the selection section to ContextCache.
+ * @return true if a snapshot is now available
+ */
+bool Run();
+
+/**
+ * Prefetched section for the chosen panel
+ * @param found  Output: false if there is no current snapshot (run the
+ *               panel's own script); an empty section with found == true
+ *               means "nothing selected for this panel"
+ * @return view valid until the next Arm()/Run()/Discard()
+ */
+std::string_view Section(WireFormat::PanelField field, bool &found);
+
+// Menu closed: drop the snapshot (used or not)
+void Discard();
+
+// Prefetch statistics (for logging / benchmarking)
+struct Stats {
+  uint64_t snapshots = 0; // panelSnapshot() calls
+  uint64_t failures = 0;  // Calls that failed or were malformed
+  uint64_t hits = 0;      // Sections served from a snapshot
+  uint64_t stale = 0;     // Lookups refused: context changed since the snapshot
+  uint64_t unused = 0;    // Snapshots discarded without a lookup
+};
+
+Stats GetStats();
+void ResetStats();
+
+} // namespace PanelPrefetch
@@ -0,0 +1,193 @@
+/*****************************************************************************
+ * Profiler.cpp
+ *
+ * Scoped timers and latency histograms (see Profiler.h)
+ *****************************************************************************/
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+namespace Profiler {
+
+bool g_enabled = false;
+
+struct Site {
+  const char *label = nullptr;
+  int line = 0;
+  uint64_t count = 0;
+  uint64_t totalNs = 0;
+  uint64_t maxNs = 0;
+  uint32_t buckets[BUCKET_COUNT] = {};
+};
+
+static Site s_sites[MAX_SITES];
+static int s_siteCount = 0;
+static uint64_t s_droppedSites = 0;
+
+void SetEnabled(bool enabled) { g_enabled = enabled; }
+
+uint64_t NowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int BucketFor(uint64_t ns) {
+  const uint64_t sub = 1ull << SUB_BITS;
+  if (ns < sub)
+    return (int)ns;
+  int msb = 63;
+  while (!(ns >> msb))
+    msb--;
+  if (msb > MAX_EXPONENT)
+    return BUCKET_COUNT - 1;
+  uint64_t top = ns >> (msb - SUB_BITS); // [sub, 2 * sub)
+  return ((msb - SUB_BITS + 1) << SUB_BITS) + (int)(top - sub);
+}
+
+uint64_t BucketLow(int bucket) {
+  const int sub = 1 << SUB_BITS;
+  if (bucket < sub)
+    return (uint64_t)bucket;
+  int exponent = bucket >> SUB_BITS;
+  return (uint64_t)(sub + (bucket & (sub - 1))) << (exponent - 1);
+}
+
+uint64_t BucketHigh(int bucket) {
+  if (bucket >= BUCKET_COUNT - 1)
+    return UINT64_MAX;
+  return BucketLow(bucket + 1) - 1;
+}
+
+static Site *FindSite(const char *label, int line, bool create) {
+  for (int i = 0; i < s_siteCount; i++) {
+    if (s_sites[i].label == label && s_sites[i].line == line)
+      return &s_sites[i];
+  }
+  if (!create)
+    return nullptr;
+  if (s_siteCount >= MAX_SITES) {
+    s_droppedSites++;
+    return nullptr;
+  }
+  Site *site = &s_sites[s_siteCount++];
+  site->label = label;
+  site->line = line;
+  return site;
+}
+
+void Record(const char *label, int line, uint64_t ns) {
+  Site *site = FindSite(label, line, true);
+  if (!site)
+    return;
+  site->count++;
+  site->totalNs += ns;
+  if (ns > site->maxNs)
+    site->maxNs = ns;
+  site->buckets[BucketFor(ns)]++;
+}
+
+void Sections::Switch(const char *label) {
+  uint64_t now = NowNs();
+  if (m_label)
+    Record(m_label, 0, now - m_startNs);
+  m_label = label;
+  m_startNs = now;
+}
+
+static uint64_t SitePercentile(const Site &site, double q) {
+  if (site.count == 0)
+    return 0;
+  uint64_t rank = (uint64_t)(q * (double)site.count + 0.5);
+  if (rank < 1)
+    rank = 1;
+  uint64_t seen = 0;
+  for (int b = 0; b < BUCKET_COUNT; b++) {
+    seen += site.buckets[b];
+    if (seen >= rank)
+      return std::min(BucketHigh(b), site.maxNs);
+  }
+  return site.maxNs;
+}
+
+uint64_t Percentile(const char *label, int line, double q) {
+  Site *site = FindSite(label, line, false);
+  return site ? SitePercentile(*site, q) : 0;
+}
+
+std::vector<SiteStats> GetStats() {
+  std::vector<SiteStats> stats;
+  for (int i = 0; i < s_siteCount; i++) {
+    const Site &site = s_sites[i];
+    SiteStats entry;
+    entry.label = site.label;
+    if (site.line > 0)
+      entry.label += ":" + std::to_string(site.line);
+    entry.count = site.count;
+    entry.totalNs = site.totalNs;
+    entry.maxNs = site.maxNs;
+    entry.p50Ns = SitePercentile(site, 0.50);
+    entry.p99Ns = SitePercentile(site, 0.99);
+    stats.push_back(entry);
+  }
+  std::sort(stats.begin(), stats.end(), [](const SiteStats &a, const SiteStats &b) {
+    return a.totalNs > b.totalNs;
+  });
+  return stats;
+}
+
+uint64_t DroppedSites() { return s_droppedSites; }
+
+// "850ns", "12.3us", "4.56ms", "1.23s"
+static std::string FormatNs(uint64_t ns) {
+  char text[32];
+  if (ns < 1000)
+    snprintf(text, sizeof(text), "%lluns", (unsigned long long)ns);
+  else if (ns < 1000000)
+    snprintf(text, sizeof(text), "%.1fus", (double)ns / 1e3);
+  else if (ns < 1000000000)
+    snprintf(text, sizeof(text), "%.2fms", (double)ns / 1e6);
+  else
+    snprintf(text, sizeof(text), "%.2fs", (double)ns / 1e9);
+  return text;
+}
+
+std::string FormatReport() {
+  std::vector<SiteStats> stats = GetStats();
+  uint64_t totalNs = 0;
+  for (const SiteStats &entry : stats)
+    totalNs += entry.totalNs;
+
+  char line[256];
+  snprintf(line, sizeof(line), "profile: %zu sites, %s recorded", stats.size(),
+           FormatNs(totalNs).c_str());
+  std::string report = line;
+  if (s_droppedSites > 0) {
+    snprintf(line, sizeof(line), " (%llu dropped)", (unsigned long long)s_droppedSites);
+    report += line;
+  }
+  report += "\n";
+  snprintf(line, sizeof(line), "  %-32s %9s %9s %9s %9s %9s\n", "site", "count", "p50", "p99",
+           "max", "total");
+  report += line;
+  for (const SiteStats &entry : stats) {
+    snprintf(line, sizeof(line), "  %-32s %9llu %9s %9s %9s %9s\n", entry.label.c_str(),
+             (unsigned long long)entry.count, FormatNs(entry.p50Ns).c_str(),
+             FormatNs(entry.p99Ns).c_str(), FormatNs(entry.maxNs).c_str(),
+             FormatNs(entry.totalNs).c_str());
+    report += line;
+  }
+  return report;
+}
+
+void Reset() {
+  for (int i = 0; i < MAX_SITES; i++)
+    s_sites[i] = Site();
+  s_siteCount = 0;
+  s_droppedSites = 0;
+}
+
+} // namespace Profiler
@@ -0,0 +1,132 @@
+/*****************************************************************************
+ * Profiler.h
+ *
+ * Scoped timers for IdleHook sections and script calls
+ *
+ * Every probe site aggregates into a log-linear latency histogram (16 sub
+ * buckets per power of two, < 6.25% error) plus exact count / total / max,
+ * and FormatReport() prints p50 / p99 / max per site.
+ *
+ *   PROFILE_SCOPE("script.host");            // Until the end of the block
+ *
+ *   Profiler::Sections sections;             // Consecutive sections
+ *   sections.Enter("idle.input");            // (ends the previous one,
+ *   sections.Enter("idle.anchor");           //  the last ends on return)
+ *
+ * Disabled (the default) a probe is one bool test: no clock read, no
+ * lookup. SnapPlugin enables it with ANCHORSNAP_PROFILE and dumps the
+ * report to the log and the IPC directory.
+ *
+ * Main thread only (IdleHook, menu hooks). Platform-neutral.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Profiler {
+
+extern bool g_enabled;
+
+inline bool IsEnabled() { return g_enabled; }
+void SetEnabled(bool enabled);
+
+const int MAX_SITES = 64; // Further sites are counted as dropped
+
+// Histogram layout (exposed for the bench)
+const int SUB_BITS = 4;
+const int MAX_EXPONENT = 40; // Values >= 2^41 ns (~37 min) share the last bucket
+const int BUCKET_COUNT = (MAX_EXPONENT - SUB_BITS + 2) << SUB_BITS;
+int BucketFor(uint64_t ns);
+uint64_t BucketLow(int bucket);  // Smallest value in the bucket
+uint64_t BucketHigh(int bucket); // Largest value in the bucket
+
+uint64_t NowNs(); // steady_clock
+
+/**
+ * Add one duration to a site
+ * @param label  probe label (string literal; the pointer is the key)
+ * @param line   0, or the call-site line for labels shared by many sites
+ */
+void Record(const char *label, int line, uint64_t ns);
+
+class Scope {
+public:
+  Scope(const char *label, int line = 0) {
+    if (g_enabled) {
+      m_label = label;
+      m_line = line;
+      m_startNs = NowNs();
+    }
+  }
+  ~Scope() {
+    if (m_label)
+      Record(m_label, m_line, NowNs() - m_startNs);
+  }
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+private:
+  const char *m_label = nullptr;
+  int m_line = 0;
+  uint64_t m_startNs = 0;
+};
+
+class Sections {
+public:
+  Sections() = default;
+  ~Sections() { End(); }
+  Sections(const Sections &) = delete;
+  Sections &operator=(const Sections &) = delete;
+
+  // End the current section and start `label`
+  void Enter(const char *label) {
+    if (g_enabled)
+      Switch(label);
+  }
+  void End() {
+    if (m_label)
+      Switch(nullptr);
+  }
+
+private:
+  void Switch(const char *label);
+
+  const char *m_label = nullptr;
+  uint64_t m_startNs = 0;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(label) Profiler::Scope PROFILE_CONCAT(profileScope_, __LINE__)(label)
+
+struct SiteStats {
+  std::string label; // "label" or "label:line"
+  uint64_t count = 0;
+  uint64_t totalNs = 0;
+  uint64_t maxNs = 0;
+  uint64_t p50Ns = 0;
+  uint64_t p99Ns = 0;
+};
+
+// Sites sorted by total time (largest first)
+std::vector<SiteStats> GetStats();
+
+// Percentile of one site's histogram (bucket upper bound, capped at max)
+uint64_t Percentile(const char *label, int line, double q);
+
+// Sites dropped because MAX_SITES was reached
+uint64_t DroppedSites();
+
+/**
+ * Text report:
+ *   "profile: N sites, T s recorded"
+ *   "  label  count  p50  p99  max  total" (one line per site)
+ */
+std::string FormatReport();
+
+void Reset();
+
+} // namespace Profiler
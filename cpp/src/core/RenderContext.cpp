@@ -0,0 +1,246 @@
+/*****************************************************************************
+ * RenderContext.cpp
+ *
+ * GDI+ session, resource pools and backbuffers (see RenderContext.h)
+ *****************************************************************************/
+
+#include "RenderContext.h"
+#include "IconAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace RenderContext {
+
+static int s_users = 0;
+static Stats s_stats;
+
+#ifdef MSWindows
+
+static ULONG_PTR s_token = 0;
+
+template <typename T> struct Pooled {
+  std::unique_ptr<T> resource;
+  uint32_t used = 0; // s_beginSerial of the last lookup
+};
+
+template <typename T> using Pool = std::unordered_map<uint64_t, Pooled<T>>;
+
+static Pool<Gdiplus::SolidBrush> s_brushes;
+static Pool<Gdiplus::Pen> s_pens;
+static Pool<Gdiplus::Font> s_fonts;
+static Pool<Gdiplus::StringFormat> s_formats;
+static uint32_t s_beginSerial = 0; // Backbuffer::Begin calls
+
+// Width / size in 1/16 px
+static uint64_t Sixteenths(Gdiplus::REAL value, Gdiplus::REAL scale) {
+  long steps = lroundf(value * scale * 16.0f);
+  return (uint64_t)(steps > 0 ? steps : 0) & 0xFFFFFF;
+}
+
+static void UpdatePooled() {
+  s_stats.pooled = (uint32_t)(s_brushes.size() + s_pens.size() + s_fonts.size() + s_formats.size());
+}
+
+static void ClearPools() {
+  s_brushes.clear();
+  s_pens.clear();
+  s_fonts.clear();
+  s_formats.clear();
+  UpdatePooled();
+}
+
+// Called from Backbuffer::Begin: an oversized pool drops its least recently
+// used entries down to 3/4 of MAX_POOLED. Entries looked up since the
+// previous Begin are kept, an enclosing paint may still hold them.
+template <typename T> static void Trim(Pool<T> &pool) {
+  if ((int)pool.size() <= MAX_POOLED)
+    return;
+  std::vector<std::pair<uint32_t, uint64_t>> byAge; // (last use, key)
+  byAge.reserve(pool.size());
+  for (const auto &entry : pool) {
+    if (entry.second.used != s_beginSerial)
+      byAge.emplace_back(entry.second.used, entry.first);
+  }
+  size_t evict = pool.size() - (size_t)MAX_POOLED * 3 / 4;
+  if (evict > byAge.size())
+    evict = byAge.size();
+  std::nth_element(byAge.begin(), byAge.begin() + evict, byAge.end());
+  for (size_t i = 0; i < evict; i++)
+    pool.erase(byAge[i].second);
+  s_stats.trims++;
+  s_stats.evicted += (uint32_t)evict;
+}
+
+template <typename T, typename Create>
+static const T *Lookup(Pool<T> &pool, uint64_t key, Create create) {
+  auto it = pool.find(key);
+  if (it != pool.end()) {
+    s_stats.hits++;
+    it->second.used = s_beginSerial;
+    return it->second.resource.get();
+  }
+  s_stats.misses++;
+  Pooled<T> &entry = pool[key];
+  entry.resource.reset(create());
+  entry.used = s_beginSerial;
+  UpdatePooled();
+  return entry.resource.get();
+}
+
+bool Acquire() {
+  if (s_users == 0) {
+    Gdiplus::GdiplusStartupInput input;
+    if (Gdiplus::GdiplusStartup(&s_token, &input, NULL) != Gdiplus::Ok) {
+      s_token = 0;
+      return false;
+    }
+    s_stats.sessions++;
+  }
+  s_users++;
+  return true;
+}
+
+void Release() {
+  if (s_users == 0 || --s_users > 0)
+    return;
+  ClearPools(); // GDI+ objects must die before GdiplusShutdown
+  IconAtlas::Clear();
+  Gdiplus::GdiplusShutdown(s_token);
+  s_token = 0;
+}
+
+const Gdiplus::SolidBrush *Brush(const Gdiplus::Color &color) {
+  return Lookup(s_brushes, color.GetValue(), [&] { return new Gdiplus::SolidBrush(color); });
+}
+
+const Gdiplus::Pen *Pen(const Gdiplus::Color &color, Gdiplus::REAL width, Gdiplus::REAL scale) {
+  uint64_t key = ((uint64_t)color.GetValue() << 24) | Sixteenths(width, scale);
+  return Lookup(s_pens, key, [&] { return new Gdiplus::Pen(color, width * scale); });
+}
+
+const Gdiplus::Font *Font(Gdiplus::REAL size, INT style, Gdiplus::REAL scale) {
+  uint64_t key = ((uint64_t)(style & 0xFF) << 24) | Sixteenths(size, scale);
+  return Lookup(s_fonts, key, [&] {
+    return new Gdiplus::Font(L"Segoe UI", size * scale, style, Gdiplus::UnitPixel);
+  });
+}
+
+const Gdiplus::StringFormat *Format(Gdiplus::StringAlignment align,
+                                    Gdiplus::StringAlignment lineAlign, bool ellipsis) {
+  uint64_t key = (uint64_t)align | ((uint64_t)lineAlign << 4) | ((uint64_t)ellipsis << 8);
+  return Lookup(s_formats, key, [&] {
+    Gdiplus::StringFormat *format = new Gdiplus::StringFormat();
+    format->SetAlignment(align);
+    format->SetLineAlignment(lineAlign);
+    if (ellipsis)
+      format->SetTrimming(Gdiplus::StringTrimmingEllipsisCharacter);
+    return format;
+  });
+}
+
+/*****************************************************************************
+ * Backbuffer
+ *****************************************************************************/
+HDC Backbuffer::Begin(HDC target, int width, int height, const RECT *dirty) {
+  Trim(s_brushes);
+  Trim(s_pens);
+  Trim(s_fonts);
+  Trim(s_formats);
+  UpdatePooled();
+  s_beginSerial++;
+
+  m_painting = false;
+  if (width <= 0 || height <= 0)
+    return target;
+  if (!m_dc) {
+    m_dc = CreateCompatibleDC(target);
+    if (!m_dc)
+      return target;
+  }
+  if (!m_bitmap || width > m_width || height > m_height) {
+    int newWidth = width > m_width ? width : m_width;
+    int newHeight = height > m_height ? height : m_height;
+    HBITMAP bitmap = CreateCompatibleBitmap(target, newWidth, newHeight);
+    if (!bitmap)
+      return target;
+    HGDIOBJ previous = SelectObject(m_dc, bitmap);
+    if (m_bitmap) {
+      DeleteObject(m_bitmap);
+    } else {
+      m_oldBitmap = previous;
+    }
+    m_bitmap = bitmap;
+    m_width = newWidth;
+    m_height = newHeight;
+    s_stats.bitmaps++;
+  }
+  m_dirty.left = 0;
+  m_dirty.top = 0;
+  m_dirty.right = width;
+  m_dirty.bottom = height;
+  if (dirty) {
+    m_dirty.left = dirty->left > 0 ? dirty->left : 0;
+    m_dirty.top = dirty->top > 0 ? dirty->top : 0;
+    m_dirty.right = dirty->right < width ? dirty->right : width;
+    m_dirty.bottom = dirty->bottom < height ? dirty->bottom : height;
+  }
+  if (m_dirty.right > m_dirty.left && m_dirty.bottom > m_dirty.top)
+    PatBlt(m_dc, m_dirty.left, m_dirty.top, m_dirty.right - m_dirty.left,
+           m_dirty.bottom - m_dirty.top, BLACKNESS);
+  m_painting = true;
+  return m_dc;
+}
+
+void Backbuffer::Present(HDC target, int width, int height) {
+  if (!m_painting)
+    return;
+  int right = m_dirty.right < width ? m_dirty.right : width;
+  int bottom = m_dirty.bottom < height ? m_dirty.bottom : height;
+  if (right > m_dirty.left && bottom > m_dirty.top)
+    BitBlt(target, m_dirty.left, m_dirty.top, right - m_dirty.left, bottom - m_dirty.top, m_dc,
+           m_dirty.left, m_dirty.top, SRCCOPY);
+  m_painting = false;
+}
+
+void Backbuffer::Release() {
+  if (m_dc) {
+    if (m_oldBitmap)
+      SelectObject(m_dc, m_oldBitmap);
+    DeleteDC(m_dc);
+  }
+  if (m_bitmap)
+    DeleteObject(m_bitmap);
+  m_dc = NULL;
+  m_bitmap = NULL;
+  m_oldBitmap = NULL;
+  m_width = 0;
+  m_height = 0;
+  m_painting = false;
+}
+
+#else
+
+bool Acquire() {
+  s_users++;
+  return true;
+}
+
+void Release() {
+  if (s_users > 0)
+    s_users--;
+}
+
+#endif // MSWindows
+
+Stats GetStats() {
+  Stats stats = s_stats;
+  stats.users = (uint32_t)s_users;
+  return stats;
+}
+
+} // namespace RenderContext
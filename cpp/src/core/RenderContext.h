@@ -0,0 +1,124 @@
+/*****************************************************************************
+ * RenderContext.h
+ *
+ * Shared GDI+ session, pooled drawing resources and reusable backbuffers
+ *
+ * Every UI module used to call GdiplusStartup with its own token, and every
+ * WM_PAINT created a memory DC + bitmap and fresh SolidBrush / Pen / Font /
+ * StringFormat objects. Modules now share one reference-counted session and
+ * draw with pooled, immutable resources:
+ *
+ *   RenderContext::Acquire();                          // Module Initialize
+ *   g.FillRectangle(RenderContext::Brush(COLOR_BG), r);
+ *   g.DrawLine(RenderContext::Pen(COLOR_BORDER, 1), ...);
+ *   g.DrawString(text, -1, RenderContext::Font(12, FontStyleBold), rect,
+ *                RenderContext::Format(StringAlignmentCenter), brush);
+ *   RenderContext::Release();                          // Module Shutdown
+ *
+ * Pool keys are (color, width * scale) for pens and (size * scale, style)
+ * for fonts, in 1/16 px steps. Modules that draw under ScaleTransform pass
+ * scale 1; GridUI scales its sizes itself. Pooled objects must not be
+ * modified (dash patterns, trimming ...): build a local object for those.
+ * Pooled pointers are frame-scoped: use them in the paint that looked them
+ * up and look them up again next paint; never keep one in a static or a
+ * member. A pool holding more than MAX_POOLED entries (animated colors,
+ * pickers) evicts its least recently used entries at Backbuffer::Begin.
+ * Entries looked up since the previous Begin are never evicted, so a
+ * cached layer may be rebuilt (its own Begin) in the middle of a paint.
+ * Everything is freed by the last Release().
+ *
+ * Main thread only (window procedures).
+ *****************************************************************************/
+
+#pragma once
+
+#include "GdiPlusIncludes.h"
+
+#include <cstdint>
+
+namespace RenderContext {
+
+const int MAX_POOLED = 256; // Per resource kind
+
+/**
+ * Start the shared GDI+ session (first caller) and count the user
+ * @return false if GDI+ could not start (not counted: no Release)
+ */
+bool Acquire();
+
+// Last user: free pooled resources, then shut GDI+ down
+void Release();
+
+struct Stats {
+  uint32_t users = 0;       // Acquire() without Release()
+  uint32_t sessions = 0;    // GdiplusStartup calls
+  uint64_t hits = 0;        // Pool lookups served from the pool
+  uint64_t misses = 0;      // Pool lookups that created a resource
+  uint32_t pooled = 0;      // Live pooled resources
+  uint32_t trims = 0;       // Trims of a pool exceeding MAX_POOLED
+  uint32_t evicted = 0;     // Least recently used resources freed by trims
+  uint32_t bitmaps = 0;     // Backbuffer bitmaps created (first paint or growth)
+};
+Stats GetStats();
+
+#ifdef MSWindows
+
+const Gdiplus::SolidBrush *Brush(const Gdiplus::Color &color);
+
+const Gdiplus::Pen *Pen(const Gdiplus::Color &color, Gdiplus::REAL width = 1.0f,
+                        Gdiplus::REAL scale = 1.0f);
+
+// Segoe UI, UnitPixel (the only family the modules use)
+const Gdiplus::Font *Font(Gdiplus::REAL size, INT style = Gdiplus::FontStyleRegular,
+                          Gdiplus::REAL scale = 1.0f);
+
+const Gdiplus::StringFormat *Format(Gdiplus::StringAlignment align,
+                                    Gdiplus::StringAlignment lineAlign = Gdiplus::StringAlignmentCenter,
+                                    bool ellipsis = false);
+
+/**
+ * Per-window double buffer kept across paints
+ *
+ *   HDC memDC = g_backbuffer.Begin(hdc, rect.right, rect.bottom);
+ *   Draw(memDC);
+ *   g_backbuffer.Present(hdc, rect.right, rect.bottom);
+ *
+ * The bitmap only grows (windows resize with content), and the painted
+ * area is cleared to black like a freshly created bitmap. If the buffer
+ * cannot be created Begin returns the target DC and Present does nothing.
+ *
+ * With a dirty rect (ps.rcPaint) only that area is cleared and presented;
+ * the rest of the buffer keeps the previous paint.
+ *
+ * Cached layer: Begin, draw, and skip Present. The drawing stays in the
+ * buffer until the next Begin; Surface() is the DC to BitBlt it from.
+ */
+class Backbuffer {
+public:
+  Backbuffer() = default;
+  ~Backbuffer() { Release(); }
+  Backbuffer(const Backbuffer &) = delete;
+  Backbuffer &operator=(const Backbuffer &) = delete;
+
+  HDC Begin(HDC target, int width, int height, const RECT *dirty = NULL);
+  void Present(HDC target, int width, int height);
+
+  // Memory DC holding the last drawing (NULL before the first Begin)
+  HDC Surface() const { return m_bitmap ? m_dc : NULL; }
+
+  // Free the DC and bitmap (module Shutdown)
+  void Release();
+
+private:
+  HDC m_dc = NULL;
+  HBITMAP m_bitmap = NULL;
+  HGDIOBJ m_oldBitmap = NULL;
+  int m_width = 0;
+  int m_height = 0;
+  RECT m_dirty = {0, 0, 0, 0}; // Area cleared by Begin, copied by Present
+  bool m_painting = false;     // Begin returned m_dc
+};
+
+#endif // MSWindows
+
+} // namespace RenderContext
@@ -0,0 +1,344 @@
+/*****************************************************************************
+ * ScriptBatch.cpp
+ *
+ * Multiplexed ExtendScript transport
+ *
+ * Batch script layout (one AEGP_ExecuteScript call):
+ *   (function(){
+ *     var __b=$.global.__asBatch={id:<serial>,out:[]},__o=__b.out;
+ *     function __e(__s){return eval(__s);}
+ *     try{__o.push('\x06'+__q(__e('<call 1>')));}catch(e){__o.push('\x15'+__q(e));}
+ *     try{__o.push('\x06'+__q(__e('<call 2>')));}catch(e){__o.push('\x15'+__q(e));}
+ *     return __o.join('\x1e');
+ *   })();
+ *
+ * - Each call is passed to eval as a string literal, so any script works:
+ *   an expression, an IIFE or statements ("var a=...; a.b"). The call's
+ *   result is the completion value of its last statement, as with a single
+ *   AEGP_ExecuteScript. A call with a syntax error throws inside its own
+ *   try/catch instead of failing the whole batch. Top-level var / function
+ *   declarations stay local to the call.
+ * - Records are separated by RS (0x1e), each starting with ACK (0x06) on
+ *   success or NAK (0x15) on exception.
+ * - RS/ESC inside a result are escaped with ESC (0x1b).
+ * - Records are also kept in $.global.__asBatch. When the host reports an
+ *   error or the result cannot be split, a recovery probe reads them back:
+ *   the calls that left a record are resolved from it and only the others
+ *   are re-run one by one. If the probe shows the batch never started (a
+ *   parse error fails the whole script before anything runs), every call
+ *   is re-run to isolate the bad one. If the probe itself fails, nothing is
+ *   re-run: a mutating call must not run twice.
+ *****************************************************************************/
+
+#include "ScriptBatch.h"
+#include "Tracer.h"
+
+#include <utility>
+#include <vector>
+
+namespace ScriptBatch {
+
+static const char MARK_OK = '\x06';
+static const char MARK_ERROR = '\x15';
+static const char RECORD_SEP = '\x1e';
+static const char ESCAPE = '\x1b';
+static const char MARK_STARTED = '\x02'; // Recovery probe: batch started
+
+struct CallState {
+  const char *name = "";
+  std::string script;
+  std::string result;
+  std::string error;
+  bool ready = false;
+  bool succeeded = false;
+};
+
+static ScriptRunner s_runner = nullptr;
+static void *s_runnerContext = nullptr;
+static std::vector<std::shared_ptr<CallState>> s_pending;
+static Stats s_stats;
+static uint32_t s_batchSerial = 0; // Id stamped into $.global.__asBatch
+
+static const std::string &EmptyString() {
+  static const std::string empty;
+  return empty;
+}
+
+// ---------------------------------------------------------------------------
+// Future
+// ---------------------------------------------------------------------------
+
+bool Future::IsReady() const { return m_state && m_state->ready; }
+
+bool Future::Succeeded() const {
+  if (!m_state)
+    return false;
+  if (!m_state->ready)
+    Flush();
+  return m_state->ready && m_state->succeeded;
+}
+
+const std::string &Future::Get() const {
+  if (!m_state)
+    return EmptyString();
+  if (!m_state->ready)
+    Flush();
+  return m_state->ready ? m_state->result : EmptyString();
+}
+
+const std::string &Future::Error() const {
+  if (!m_state)
+    return EmptyString();
+  if (!m_state->ready)
+    Flush();
+  return m_state->error;
+}
+
+// ---------------------------------------------------------------------------
+// Compose / split
+// ---------------------------------------------------------------------------
+
+// Append the call as a single-quoted JS literal for __e (eval).
+// U+2028 / U+2029 end a line inside a literal, so they are escaped too.
+static void AppendQuoted(std::string &out, const std::string &script) {
+  static const char HEX[] = "0123456789abcdef";
+  out += '\'';
+  for (size_t i = 0; i < script.size(); i++) {
+    unsigned char c = (unsigned char)script[i];
+    if (c == '\'' || c == '\\') {
+      out += '\\';
+      out += (char)c;
+    } else if (c == '\n') {
+      out += "\\n";
+    } else if (c == '\r') {
+      out += "\\r";
+    } else if (c < 0x20) {
+      out += "\\x";
+      out += HEX[c >> 4];
+      out += HEX[c & 15];
+    } else if (c == 0xE2 && i + 2 < script.size() &&
+               (unsigned char)script[i + 1] == 0x80 &&
+               ((unsigned char)script[i + 2] == 0xA8 ||
+                (unsigned char)script[i + 2] == 0xA9)) {
+      out += ((unsigned char)script[i + 2] == 0xA8) ? "\\u2028" : "\\u2029";
+      i += 2;
+    } else {
+      out += (char)c;
+    }
+  }
+  out += '\'';
+}
+
+std::string ComposeScript(const std::string *scripts, size_t count,
+                          uint32_t batchId) {
+  size_t total = 256;
+  for (size_t i = 0; i < count; i++)
+    total += scripts[i].size() + scripts[i].size() / 8 + 96;
+
+  std::string out;
+  out.reserve(total);
+  out += "(function(){var __b=$.global.__asBatch={id:";
+  out += std::to_string(batchId);
+  out += ",out:[]},__o=__b.out;"
+         "function __q(v){"
+         "v=(v===undefined||v===null)?'':String(v);"
+         "return v.replace(/[\\x1b\\x1e]/g,function(c){return '\\x1b'+c;});"
+         "}"
+         "function __e(__s){return eval(__s);}";
+  for (size_t i = 0; i < count; i++) {
+    out += "try{__o.push('\\x06'+__q(__e(";
+    AppendQuoted(out, scripts[i]);
+    out += ")));}catch(e){__o.push('\\x15'+__q(e.toString()));}";
+  }
+  out += "return __o.join('\\x1e');})();";
+  return out;
+}
+
+std::string ComposeRecovery(uint32_t batchId) {
+  std::string out = "(function(){var b=$.global.__asBatch;"
+                    "return(b&&b.id===";
+  out += std::to_string(batchId);
+  out += ")?'\\x02'+b.out.join('\\x1e'):'';})();";
+  return out;
+}
+
+// Parses up to `capacity` records; `records` is the number found.
+// Returns false if the text is not a well-formed record list.
+static bool ParseRecords(const std::string &combined, std::string *results,
+                         bool *succeeded, size_t capacity, size_t &records) {
+  records = 0;
+  if (combined.empty())
+    return true;
+
+  size_t index = 0;
+  bool atRecordStart = true;
+  for (size_t i = 0; i < combined.size(); i++) {
+    char c = combined[i];
+    if (atRecordStart) {
+      if (index >= capacity || (c != MARK_OK && c != MARK_ERROR))
+        return false;
+      succeeded[index] = (c == MARK_OK);
+      results[index].clear();
+      atRecordStart = false;
+      continue;
+    }
+    if (c == ESCAPE && i + 1 < combined.size()) {
+      results[index] += combined[++i];
+    } else if (c == RECORD_SEP) {
+      index++;
+      atRecordStart = true;
+    } else {
+      results[index] += c;
+    }
+  }
+  // Every record carries a marker, so a well-formed list does not end on
+  // a separator
+  if (atRecordStart)
+    return false;
+  records = index + 1;
+  return true;
+}
+
+bool SplitResult(const std::string &combined, std::string *results,
+                 bool *succeeded, size_t count) {
+  size_t records = 0;
+  return ParseRecords(combined, results, succeeded, count, records) &&
+         records == count;
+}
+
+// ---------------------------------------------------------------------------
+// Batch execution
+// ---------------------------------------------------------------------------
+
+static void Resolve(CallState &call, bool ok, std::string &&text) {
+  call.ready = true;
+  call.succeeded = ok;
+  if (ok)
+    call.result = std::move(text);
+  else
+    call.error = std::move(text);
+  s_stats.calls++;
+}
+
+static void RunSingle(CallState &call) {
+  std::string result;
+  bool ok = s_runner(call.script.c_str(), result, s_runnerContext);
+  s_stats.batches++;
+  s_stats.bytesSent += call.script.size();
+  s_stats.bytesReceived += result.size();
+  Resolve(call, ok, std::move(result));
+}
+
+void SetRunner(ScriptRunner runner, void *context) {
+  s_runner = runner;
+  s_runnerContext = context;
+}
+
+Future Enqueue(const char *name, const char *script) {
+  auto state = std::make_shared<CallState>();
+  state->name = name ? name : "";
+  state->script = script ? script : "";
+  s_pending.push_back(state);
+  return Future(state);
+}
+
+int Flush() {
+  if (s_pending.empty())
+    return 0;
+
+  // Take ownership first: a script may pump messages (alert) and a window
+  // procedure may enqueue new calls while this batch is running
+  std::vector<std::shared_ptr<CallState>> batch;
+  batch.swap(s_pending);
+  Tracer::Scope trace("script", "ScriptBatch::Flush");
+  trace.Arg("calls", (int64_t)batch.size());
+
+  if (!s_runner) {
+    for (auto &call : batch)
+      Resolve(*call, false, "No script runner");
+    return (int)batch.size();
+  }
+
+  if (batch.size() == 1) {
+    RunSingle(*batch[0]);
+    return 1;
+  }
+
+  std::vector<std::string> scripts(batch.size());
+  for (size_t i = 0; i < batch.size(); i++)
+    scripts[i] = batch[i]->script;
+
+  uint32_t batchId = ++s_batchSerial;
+  std::string combinedScript =
+      ComposeScript(scripts.data(), scripts.size(), batchId);
+  std::string combined;
+  bool ok = s_runner(combinedScript.c_str(), combined, s_runnerContext);
+  s_stats.batches++;
+  s_stats.bytesSent += combinedScript.size();
+  s_stats.bytesReceived += combined.size();
+
+  std::vector<std::string> results(batch.size());
+  std::unique_ptr<bool[]> succeeded(new bool[batch.size()]);
+  // A complete record list means every call ran, even if the host reported
+  // an error afterwards
+  if (SplitResult(combined, results.data(), succeeded.get(), batch.size())) {
+    for (size_t i = 0; i < batch.size(); i++)
+      Resolve(*batch[i], succeeded[i], std::move(results[i]));
+    s_stats.roundTripsSaved += batch.size() - 1;
+    return (int)batch.size();
+  }
+
+  // Result lost or incomplete: ask the host how far the batch got
+  std::string hostError = ok ? "Malformed batch result" : combined;
+  std::string recovery = ComposeRecovery(batchId);
+  std::string progress;
+  bool probed = s_runner(recovery.c_str(), progress, s_runnerContext);
+  s_stats.batches++;
+  s_stats.recoveries++;
+  s_stats.bytesSent += recovery.size();
+  s_stats.bytesReceived += progress.size();
+
+  // "" = the batch never started (parse error): no call has a record
+  size_t records = 0;
+  bool known = probed;
+  if (probed && !progress.empty() &&
+      (progress[0] != MARK_STARTED ||
+       !ParseRecords(progress.substr(1), results.data(), succeeded.get(),
+                     batch.size(), records))) {
+    known = false; // Unreadable progress: same as a failed probe
+    records = 0;
+  }
+
+  for (size_t i = 0; i < records; i++)
+    Resolve(*batch[i], succeeded[i], std::move(results[i]));
+  if (records > 0)
+    s_stats.roundTripsSaved += records - 1;
+
+  if (!known) {
+    // Unknown progress: a call may have run, do not run it twice
+    for (size_t i = records; i < batch.size(); i++)
+      Resolve(*batch[i], false, std::string(hostError));
+  } else if (records < batch.size()) {
+    // Only the calls without a record: not started, or the one the host
+    // stopped in
+    s_stats.fallbacks++;
+    for (size_t i = records; i < batch.size(); i++)
+      RunSingle(*batch[i]);
+  }
+  return (int)batch.size();
+}
+
+size_t PendingCount() { return s_pending.size(); }
+
+void Discard() {
+  std::vector<std::shared_ptr<CallState>> batch;
+  batch.swap(s_pending);
+  for (auto &call : batch)
+    Resolve(*call, false, "Discarded");
+}
+
+Stats GetStats() { return s_stats; }
+
+void ResetStats() { s_stats = Stats(); }
+
+} // namespace ScriptBatch
@@ -0,0 +1,119 @@
+/*****************************************************************************
+ * ScriptBatch.h
+ *
+ * Coalesces ExtendScript calls made during one IdleHook tick into a single
+ * AEGP_ExecuteScript round-trip.
+ *
+ * Callers enqueue named calls and receive a Future. The pending batch runs
+ * as one multiplexed script when the first result is needed (Future::Get)
+ * or when the tick ends (Flush). Each call runs in its own try/catch, so one
+ * failing call does not affect the others.
+ *
+ * Platform-neutral: the host transport is injected as a ScriptRunner, so the
+ * batcher has no dependency on the AE SDK and can run against a mock host.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace ScriptBatch {
+
+/**
+ * Host transport: run one script and return its string result.
+ * @param script   ExtendScript source
+ * @param result   Output: script result (UTF-8)
+ * @param context  Opaque pointer passed to SetRunner
+ * @return false if the host reported an error
+ */
+typedef bool (*ScriptRunner)(const char *script, std::string &result,
+                             void *context);
+
+struct CallState;
+
+/**
+ * Result handle for one enqueued call.
+ * Get() flushes the pending batch if the call has not run yet.
+ */
+class Future {
+public:
+  Future() = default;
+
+  bool IsValid() const { return m_state != nullptr; }
+  bool IsReady() const;
+
+  // True if the call ran and did not throw
+  bool Succeeded() const;
+
+  // Call result ("" if the call failed or returned undefined/null)
+  const std::string &Get() const;
+
+  // Exception text if the call threw
+  const std::string &Error() const;
+
+private:
+  friend Future Enqueue(const char *name, const char *script);
+  explicit Future(std::shared_ptr<CallState> state)
+      : m_state(std::move(state)) {}
+
+  std::shared_ptr<CallState> m_state;
+};
+
+// Batch statistics (for logging / benchmarking)
+struct Stats {
+  uint64_t batches = 0;         // AEGP_ExecuteScript round-trips issued
+  uint64_t calls = 0;           // Calls completed
+  uint64_t roundTripsSaved = 0; // calls - batches
+  uint64_t fallbacks = 0;       // Batches whose unrecorded calls were re-run
+  uint64_t recoveries = 0;      // Progress probes after a failed batch
+  uint64_t bytesSent = 0;       // Script bytes handed to the host
+  uint64_t bytesReceived = 0;   // Result bytes returned by the host
+};
+
+/**
+ * Install the host transport (SnapPlugin wraps AEGP_ExecuteScript)
+ */
+void SetRunner(ScriptRunner runner, void *context);
+
+/**
+ * Queue a call for the next batch
+ * @param name    Call-site label (stats / diagnostics)
+ * @param script  ExtendScript source: an expression, e.g. "(function(){...})();",
+ *                or statements; the result is the last statement's value
+ */
+Future Enqueue(const char *name, const char *script);
+
+/**
+ * Run all pending calls as one script invocation
+ * @return number of calls completed
+ */
+int Flush();
+
+// Number of calls waiting for the next flush
+size_t PendingCount();
+
+// Drop pending calls without running them (futures resolve as failed)
+void Discard();
+
+Stats GetStats();
+void ResetStats();
+
+/**
+ * Compose / split helpers (exposed for host-side mocks)
+ * ComposeScript evals each call in its own try/catch and joins results
+ * with RS;
+ * the records are also kept in $.global.__asBatch under batchId.
+ * ComposeRecovery reads them back: STX + records if batch batchId started,
+ * "" if it never ran.
+ * SplitResult reverses that; returns false if the record count mismatches.
+ */
+std::string ComposeScript(const std::string *scripts, size_t count,
+                          uint32_t batchId);
+std::string ComposeRecovery(uint32_t batchId);
+bool SplitResult(const std::string &combined, std::string *results,
+                 bool *succeeded, size_t count);
+
+} // namespace ScriptBatch
@@ -0,0 +1,495 @@
+/*****************************************************************************
+ * ScriptBuilder.h
+ *
+ * Typed ExtendScript templates (replaces snprintf into fixed char buffers)
+ *
+ * Template text marks argument slots with ${k}:
+ *   ${i}  integer            ${f}  float (non-finite -> 0)
+ *   ${b}  bool               ${s}  JS string literal, escaped
+ *   ${j}  JSON (ScriptBuilder::Json), parsed on the host side
+ *
+ * Usage:
+ *   SCRIPT_TEMPLATE(DeleteEffectScript, "deleteEffect(${i},${s})");
+ *   const char *script = ScriptBuilder::Render<DeleteEffectScript>(
+ *       ScriptBuilder::DefaultArena(), index, name);
+ *
+ * Slot count and slot kinds are checked against the argument list at
+ * compile time. The exact output length is computed before writing, and
+ * the output goes into a reusable Arena (no per-call buffers).
+ *
+ * Strings are emitted as pure-ASCII single-quoted literals: quotes,
+ * backslashes and control characters are escaped, non-ASCII characters
+ * (UTF-8 or UTF-16 input) become \uXXXX, so the host code page never
+ * matters.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace ScriptBuilder {
+
+enum SlotKind : char {
+  SLOT_NONE = 0,
+  SLOT_INT = 'i',
+  SLOT_FLOAT = 'f',
+  SLOT_BOOL = 'b',
+  SLOT_STRING = 's',
+  SLOT_JSON = 'j',
+};
+
+// JSON text argument (kept distinct from plain strings on purpose)
+struct Json {
+  std::string_view text;
+  explicit Json(std::string_view t) : text(t) {}
+};
+
+/*****************************************************************************
+ * Compile-time template inspection
+ *****************************************************************************/
+
+constexpr bool IsSlotAt(const char *t, size_t i) {
+  return t[i] == '$' && t[i + 1] == '{' && t[i + 2] != '\0' && t[i + 3] == '}';
+}
+
+constexpr size_t CountSlots(const char *t) {
+  size_t n = 0;
+  for (size_t i = 0; t[i] != '\0';) {
+    if (IsSlotAt(t, i)) {
+      n++;
+      i += 4;
+    } else {
+      i++;
+    }
+  }
+  return n;
+}
+
+constexpr char SlotKindAt(const char *t, size_t index) {
+  size_t n = 0;
+  for (size_t i = 0; t[i] != '\0';) {
+    if (IsSlotAt(t, i)) {
+      if (n == index)
+        return t[i + 2];
+      n++;
+      i += 4;
+    } else {
+      i++;
+    }
+  }
+  return SLOT_NONE;
+}
+
+constexpr bool ValidSlots(const char *t) {
+  for (size_t i = 0; t[i] != '\0'; i++) {
+    if (IsSlotAt(t, i)) {
+      char k = t[i + 2];
+      if (k != SLOT_INT && k != SLOT_FLOAT && k != SLOT_BOOL &&
+          k != SLOT_STRING && k != SLOT_JSON)
+        return false;
+    }
+  }
+  return true;
+}
+
+// Literal segments between slots, computed once per template at compile time
+template <size_t N> struct Layout {
+  size_t start[N + 1] = {};
+  size_t length[N + 1] = {};
+  size_t literal = 0; // Template length without slot markers
+};
+
+template <size_t N> constexpr Layout<N> MakeLayout(const char *t) {
+  Layout<N> layout;
+  size_t seg = 0, begin = 0, i = 0;
+  while (t[i] != '\0') {
+    if (seg < N && IsSlotAt(t, i)) {
+      layout.start[seg] = begin;
+      layout.length[seg] = i - begin;
+      layout.literal += i - begin;
+      seg++;
+      i += 4;
+      begin = i;
+    } else {
+      i++;
+    }
+  }
+  layout.start[seg] = begin;
+  layout.length[seg] = i - begin;
+  layout.literal += i - begin;
+  return layout;
+}
+
+/*****************************************************************************
+ * Argument kinds
+ *****************************************************************************/
+
+template <typename T, typename Enable = void> struct ArgKind {
+  static constexpr char value = SLOT_NONE;
+};
+template <> struct ArgKind<bool> {
+  static constexpr char value = SLOT_BOOL;
+};
+template <typename T>
+struct ArgKind<T, typename std::enable_if<std::is_integral<T>::value &&
+                                          !std::is_same<T, bool>::value &&
+                                          !std::is_same<T, char>::value &&
+                                          !std::is_same<T, wchar_t>::value>::type> {
+  static constexpr char value = SLOT_INT;
+};
+template <typename T>
+struct ArgKind<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+  static constexpr char value = SLOT_FLOAT;
+};
+template <> struct ArgKind<const char *> {
+  static constexpr char value = SLOT_STRING;
+};
+template <> struct ArgKind<char *> {
+  static constexpr char value = SLOT_STRING;
+};
+template <> struct ArgKind<std::string> {
+  static constexpr char value = SLOT_STRING;
+};
+template <> struct ArgKind<std::string_view> {
+  static constexpr char value = SLOT_STRING;
+};
+template <> struct ArgKind<const wchar_t *> {
+  static constexpr char value = SLOT_STRING;
+};
+template <> struct ArgKind<wchar_t *> {
+  static constexpr char value = SLOT_STRING;
+};
+template <> struct ArgKind<std::wstring> {
+  static constexpr char value = SLOT_STRING;
+};
+template <> struct ArgKind<std::wstring_view> {
+  static constexpr char value = SLOT_STRING;
+};
+template <> struct ArgKind<Json> {
+  static constexpr char value = SLOT_JSON;
+};
+
+template <typename... Args> constexpr bool KindsMatch(const char *t) {
+  constexpr char kinds[] = {ArgKind<typename std::decay<Args>::type>::value...,
+                            SLOT_NONE};
+  for (size_t i = 0; i < sizeof...(Args); i++) {
+    if (kinds[i] == SLOT_NONE || SlotKindAt(t, i) != kinds[i])
+      return false;
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * Arena
+ * Reusable output buffer. A rendered script stays valid until the next
+ * Render into the same arena.
+ *****************************************************************************/
+class Arena {
+public:
+  char *Reserve(size_t len) {
+    if (m_buf.size() < len + 1)
+      m_buf.resize(len + 1); // Grows only; capacity is kept
+    m_len = len;
+    m_buf[len] = '\0';
+    return &m_buf[0];
+  }
+  const char *Data() const { return m_buf.c_str(); }
+  size_t Length() const { return m_len; }
+
+private:
+  std::string m_buf;
+  size_t m_len = 0;
+};
+
+// Main-thread arena shared by all script call sites
+inline Arena &DefaultArena() {
+  static Arena arena;
+  return arena;
+}
+
+/*****************************************************************************
+ * Escaping
+ *****************************************************************************/
+namespace detail {
+
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+// Decode one UTF-8 sequence; invalid input yields U+FFFD and consumes 1 byte
+inline unsigned DecodeUtf8(const unsigned char *s, size_t len, size_t &i) {
+  unsigned c = s[i];
+  size_t extra = 0;
+  unsigned cp = 0;
+  if (c < 0x80) {
+    i++;
+    return c;
+  } else if ((c & 0xE0) == 0xC0) {
+    extra = 1;
+    cp = c & 0x1F;
+  } else if ((c & 0xF0) == 0xE0) {
+    extra = 2;
+    cp = c & 0x0F;
+  } else if ((c & 0xF8) == 0xF0) {
+    extra = 3;
+    cp = c & 0x07;
+  } else {
+    i++;
+    return 0xFFFD;
+  }
+  if (i + extra >= len) {
+    i++;
+    return 0xFFFD;
+  }
+  for (size_t k = 1; k <= extra; k++) {
+    if ((s[i + k] & 0xC0) != 0x80) {
+      i++;
+      return 0xFFFD;
+    }
+    cp = (cp << 6) | (s[i + k] & 0x3F);
+  }
+  i += extra + 1;
+  return cp;
+}
+
+// Escaped length of one UTF-16 code unit / ASCII character
+inline size_t UnitLength(unsigned u) {
+  if (u == '\'' || u == '\\' || u == '\n' || u == '\r' || u == '\t')
+    return 2;
+  if (u < 0x20 || u >= 0x7F)
+    return 6; // \uXXXX
+  return 1;
+}
+
+inline char *WriteUnit(char *p, unsigned u) {
+  switch (u) {
+  case '\'': *p++ = '\\'; *p++ = '\''; return p;
+  case '\\': *p++ = '\\'; *p++ = '\\'; return p;
+  case '\n': *p++ = '\\'; *p++ = 'n'; return p;
+  case '\r': *p++ = '\\'; *p++ = 'r'; return p;
+  case '\t': *p++ = '\\'; *p++ = 't'; return p;
+  default: break;
+  }
+  if (u < 0x20 || u >= 0x7F) {
+    *p++ = '\\';
+    *p++ = 'u';
+    *p++ = HEX_DIGITS[(u >> 12) & 0xF];
+    *p++ = HEX_DIGITS[(u >> 8) & 0xF];
+    *p++ = HEX_DIGITS[(u >> 4) & 0xF];
+    *p++ = HEX_DIGITS[u & 0xF];
+    return p;
+  }
+  *p++ = (char)u;
+  return p;
+}
+
+// Code point -> escaped length / write (surrogate pairs above U+FFFF)
+inline size_t CodePointLength(unsigned cp) {
+  return cp > 0xFFFF ? 12 : UnitLength(cp);
+}
+
+inline char *WriteCodePoint(char *p, unsigned cp) {
+  if (cp > 0xFFFF) {
+    cp -= 0x10000;
+    p = WriteUnit(p, 0xD800 + (cp >> 10));
+    return WriteUnit(p, 0xDC00 + (cp & 0x3FF));
+  }
+  return WriteUnit(p, cp);
+}
+
+inline size_t EscapedLength(std::string_view s) {
+  const unsigned char *u = (const unsigned char *)s.data();
+  size_t len = 0;
+  for (size_t i = 0; i < s.size();)
+    len += CodePointLength(DecodeUtf8(u, s.size(), i));
+  return len;
+}
+
+inline char *WriteEscaped(char *p, std::string_view s) {
+  const unsigned char *u = (const unsigned char *)s.data();
+  for (size_t i = 0; i < s.size();)
+    p = WriteCodePoint(p, DecodeUtf8(u, s.size(), i));
+  return p;
+}
+
+inline size_t EscapedLength(std::wstring_view s) {
+  size_t len = 0;
+  for (wchar_t c : s)
+    len += CodePointLength((unsigned)c);
+  return len;
+}
+
+inline char *WriteEscaped(char *p, std::wstring_view s) {
+  for (wchar_t c : s)
+    p = WriteCodePoint(p, (unsigned)c);
+  return p;
+}
+
+/*****************************************************************************
+ * Pieces: each argument formatted/measured once before writing
+ *****************************************************************************/
+enum PieceKind { PIECE_NUMBER, PIECE_RAW, PIECE_STRING, PIECE_WIDE, PIECE_JSON };
+
+struct Piece {
+  PieceKind kind = PIECE_NUMBER;
+  char number[40];
+  size_t length = 0;     // Output length
+  std::string_view text; // PIECE_RAW / PIECE_STRING / PIECE_JSON (UTF-8)
+  std::wstring_view wide;
+};
+
+constexpr char JSON_PREFIX[] = "JSON.parse('";
+constexpr char JSON_SUFFIX[] = "')";
+
+inline Piece MakeNumber(long long v) {
+  Piece p;
+  char tmp[24];
+  size_t n = 0;
+  unsigned long long mag = v < 0 ? 0ULL - (unsigned long long)v
+                                 : (unsigned long long)v;
+  do {
+    tmp[n++] = (char)('0' + mag % 10);
+    mag /= 10;
+  } while (mag);
+  if (v < 0)
+    p.number[p.length++] = '-';
+  while (n)
+    p.number[p.length++] = tmp[--n];
+  return p;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value &&
+                                   !std::is_same<T, bool>::value,
+                               Piece>::type
+MakePiece(T v) {
+  return MakeNumber((long long)v);
+}
+
+inline Piece MakePiece(bool v) {
+  Piece p;
+  p.kind = PIECE_RAW;
+  p.text = v ? "true" : "false";
+  p.length = p.text.size();
+  return p;
+}
+
+inline Piece MakePiece(double v) {
+  Piece p;
+  if (!std::isfinite(v))
+    v = 0.0; // "nan"/"inf" would break the script
+  int n = snprintf(p.number, sizeof(p.number), "%.9g", v);
+  p.length = n > 0 ? (size_t)n : 0;
+  return p;
+}
+
+inline Piece MakePiece(float v) { return MakePiece((double)v); }
+
+inline Piece MakeString(std::string_view s) {
+  Piece p;
+  p.kind = PIECE_STRING;
+  p.text = s;
+  p.length = 2 + EscapedLength(s);
+  return p;
+}
+
+inline Piece MakeWide(std::wstring_view s) {
+  Piece p;
+  p.kind = PIECE_WIDE;
+  p.wide = s;
+  p.length = 2 + EscapedLength(s);
+  return p;
+}
+
+inline Piece MakePiece(const char *s) { return MakeString(s ? s : ""); }
+inline Piece MakePiece(const std::string &s) { return MakeString(s); }
+inline Piece MakePiece(std::string_view s) { return MakeString(s); }
+inline Piece MakePiece(const wchar_t *s) { return MakeWide(s ? s : L""); }
+inline Piece MakePiece(const std::wstring &s) { return MakeWide(s); }
+inline Piece MakePiece(std::wstring_view s) { return MakeWide(s); }
+
+inline Piece MakePiece(const Json &j) {
+  Piece p;
+  p.kind = PIECE_JSON;
+  p.text = j.text;
+  p.length = (sizeof(JSON_PREFIX) - 1) + EscapedLength(j.text) +
+             (sizeof(JSON_SUFFIX) - 1);
+  return p;
+}
+
+inline char *WriteRaw(char *out, const char *s, size_t len) {
+  memcpy(out, s, len);
+  return out + len;
+}
+
+inline char *WritePiece(char *out, const Piece &p) {
+  switch (p.kind) {
+  case PIECE_NUMBER:
+    return WriteRaw(out, p.number, p.length);
+  case PIECE_RAW:
+    return WriteRaw(out, p.text.data(), p.text.size());
+  case PIECE_STRING:
+    *out++ = '\'';
+    out = WriteEscaped(out, p.text);
+    *out++ = '\'';
+    return out;
+  case PIECE_WIDE:
+    *out++ = '\'';
+    out = WriteEscaped(out, p.wide);
+    *out++ = '\'';
+    return out;
+  case PIECE_JSON:
+    out = WriteRaw(out, JSON_PREFIX, sizeof(JSON_PREFIX) - 1);
+    out = WriteEscaped(out, p.text);
+    return WriteRaw(out, JSON_SUFFIX, sizeof(JSON_SUFFIX) - 1);
+  }
+  return out;
+}
+
+} // namespace detail
+
+/*****************************************************************************
+ * Render
+ * @return null-terminated script in the arena (Arena::Length() bytes)
+ *****************************************************************************/
+template <typename Tpl, typename... Args>
+const char *Render(Arena &arena, const Args &...args) {
+  static_assert(CountSlots(Tpl::text) == sizeof...(Args),
+                "Script template: argument count does not match slots");
+  static_assert(KindsMatch<Args...>(Tpl::text),
+                "Script template: argument type does not match slot kind");
+
+  static constexpr Layout<sizeof...(Args)> layout =
+      MakeLayout<sizeof...(Args)>(Tpl::text);
+
+  const detail::Piece pieces[] = {detail::MakePiece(args)..., detail::Piece()};
+  size_t len = layout.literal;
+  for (size_t i = 0; i < sizeof...(Args); i++)
+    len += pieces[i].length;
+
+  char *out = arena.Reserve(len);
+  for (size_t i = 0; i < sizeof...(Args); i++) {
+    out = detail::WriteRaw(out, Tpl::text + layout.start[i], layout.length[i]);
+    out = detail::WritePiece(out, pieces[i]);
+  }
+  detail::WriteRaw(out, Tpl::text + layout.start[sizeof...(Args)],
+                   layout.length[sizeof...(Args)]);
+  return arena.Data();
+}
+
+} // namespace ScriptBuilder
+
+/**
+ * Declare a script template type
+ * Unknown slot kinds (e.g. ${x}) fail to compile.
+ */
+#define SCRIPT_TEMPLATE(Name, Text)                                            \
+  struct Name {                                                                \
+    static constexpr const char *text = Text;                                  \
+    static_assert(::ScriptBuilder::ValidSlots(Text),                           \
+                  "Script template: unknown slot kind");                       \
+  }
@@ -0,0 +1,1105 @@
+/*****************************************************************************
+ * ScriptLibrary.cpp
+ *
+ * Preinstalled ExtendScript function library
+ *
+ * Bootstrap: $.global.AnchorSnap_v<N>={fn:function(params){body},...,
+ *            version:<N>};
+ * Call:      ($.global.AnchorSnap_v<N>?AnchorSnap_v<N>.fn(args):'\x18')
+ *            N = SCRIPT_LIBRARY_VERSION
+ *            '\x18' (CAN) = namespace missing -> install and retry
+ *****************************************************************************/
+
+#include "ScriptLibrary.h"
+#include "ContextCache.h"
+#include "ScriptBatch.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ScriptLibrary {
+
+// Bump when any function changes: the namespace name and the bootstrap's
+// version field both follow it
+#define SCRIPT_LIBRARY_VERSION 6
+#define SCRIPT_LIBRARY_STR(x) SCRIPT_LIBRARY_STR_(x)
+#define SCRIPT_LIBRARY_STR_(x) #x
+
+const int VERSION = SCRIPT_LIBRARY_VERSION;
+const char *const NAMESPACE =
+    "AnchorSnap_v" SCRIPT_LIBRARY_STR(SCRIPT_LIBRARY_VERSION);
+
+static const char MISSING_SENTINEL = '\x18';
+
+struct Function {
+  const char *name;
+  const char *params;
+  const char *body;
+  bool readOnly;          // Safe to run repeatedly (benchmark)
+  const char *sampleArgs; // Arguments used by the benchmark (nullptr = helper)
+};
+
+/*****************************************************************************
+ * Function table
+ *****************************************************************************/
+static const Function s_functions[] = {
+    // ---------------------------------------------------------------------
+    // Wire format encoder (see WireFormat.h)
+    // ---------------------------------------------------------------------
+    {"wStr", "v",
+     "v=(v===undefined||v===null)?'':String(v);"
+     "return 's'+v.length+':'+v;",
+     false, nullptr},
+    {"wNum", "v",
+     "v=Number(v);"
+     "if(!isFinite(v))v=0;"
+     "if(v>1e11)v=1e11;else if(v<-1e11)v=-1e11;"
+     "var t=String(Math.round(v*10000));"
+     "return 'f'+t.length+':'+t;",
+     false, nullptr},
+    // Exact double: 53-bit integer mantissa (trailing zero bits dropped) 'p'
+    // binary exponent
+    {"wDbl", "v",
+     "v=Number(v);"
+     "if(!isFinite(v)||v===0)return 'd3:0p0';"
+     "var e=Math.floor(Math.log(Math.abs(v))/Math.LN2)-52,m=v/Math.pow(2,e);"
+     "while(Math.abs(m)>=9007199254740992){e++;m=v/Math.pow(2,e);}"
+     "while(Math.abs(m)<4503599627370496){e--;m=v/Math.pow(2,e);}"
+     "while(m%2===0){m/=2;e++;}"
+     "var t=String(m)+'p'+e;"
+     "return 'd'+t.length+':'+t;",
+     false, nullptr},
+    {"wInt", "v",
+     "v=Math.round(Number(v));"
+     "if(!isFinite(v))v=0;"
+     "var t=String(v);"
+     "return 'i'+t.length+':'+t;",
+     false, nullptr},
+    {"wBool", "v",
+     "return v?'b1:1':'b1:0';",
+     false, nullptr},
+    // Record from an array of encoded fields
+    {"wRec", "f",
+     "return 'R'+f.length+':'+f.join('');",
+     false, nullptr},
+    // Decoder: every string field of a wire message (C++ -> script lists)
+    {"wStrings", "t",
+     "var r=[],i=0;"
+     "while(i<t.length){"
+     "var c=t.charAt(i),j=t.indexOf(':',i);"
+     "if(j<0)break;"
+     "var n=parseInt(t.substring(i+1,j),10);"
+     "if(isNaN(n))break;"
+     "if(c==='R'){i=j+1;continue;}"
+     "if(c==='s')r.push(t.substr(j+1,n));"
+     "i=j+1+n;"
+     "}"
+     "return r;",
+     false, nullptr},
+    // Decoder: every record of a wire message as an array of values
+    {"wRecords", "t",
+     "var r=[],f=null,i=0;"
+     "while(i<t.length){"
+     "var c=t.charAt(i),j=t.indexOf(':',i);"
+     "if(j<0)break;"
+     "var n=parseInt(t.substring(i+1,j),10);"
+     "if(isNaN(n))break;"
+     "if(c==='R'){f=[];r.push(f);i=j+1;continue;}"
+     "var v=t.substr(j+1,n);"
+     "if(c==='i')v=parseInt(v,10);"
+     "else if(c==='f')v=Number(v)/10000;"
+     "else if(c==='d'){var p=v.indexOf('p');v=Number(v.substring(0,p))*Math.pow(2,Number(v.substring(p+1)));}"
+     "else if(c==='b')v=(v==='1');"
+     "if(f)f.push(v);"
+     "i=j+1+n;"
+     "}"
+     "return r;",
+     false, nullptr},
+
+    // ---------------------------------------------------------------------
+    // Catalogs (wire records)
+    // ---------------------------------------------------------------------
+    // Catalog cache key: AE build, UI language, plug-in folders
+    {"hostInfo", "",
+     "var r=[this.wStr(app.version),this.wStr(app.isoLanguage)];"
+     "try{r.push(this.wStr(Folder.startup.fsName+'/Plug-ins'));}catch(e){}"
+     "try{r.push(this.wStr(Folder.appPackage.parent.fsName+'/Plug-ins'));}catch(e){}"
+     "try{r.push(this.wStr(Folder.commonFiles.fsName+'/Adobe/Common/Plug-ins/7.0/MediaCore'));}catch(e){}"
+     "return this.wRec(r);",
+     true, ""},
+
+    // All installed effects: name, matchName, category
+    {"effectsList", "",
+     "try{"
+     "var r=[];"
+     "for(var i=0;i<app.effects.length;i++){"
+     "var e=app.effects[i];"
+     "if(e.category==='')continue;"
+     "r.push(this.wRec([this.wStr(e.displayName),this.wStr(e.matchName),this.wStr(e.category)]));"
+     "}"
+     "return r.join('');"
+     "}catch(ex){return '';}",
+     true, ""},
+
+    // Selection / context snapshot (ContextCache): comp id, viewer
+    // (1 comp, 2 layer, 3 footage, 4 effect controls, 5 other), text tool,
+    // selected count; then index, id, kind (1 text, 2 shape, 3 camera,
+    // 4 light) for up to 64 selected layers
+    {"selectionContext", "",
+     "var c=null,v=null,vt=0,tt=false,id=0,sel=[],r=[];"
+     "try{c=app.project.activeItem;}catch(e){}"
+     "try{v=app.activeViewer;}catch(e){}"
+     "if(v){"
+     "var y=v.type;"
+     "vt=y==ViewerType.VIEWER_COMPOSITION?1:y==ViewerType.VIEWER_LAYER?2:"
+     "y==ViewerType.VIEWER_FOOTAGE?3:"
+     "(ViewerType.VIEWER_EFFECT_CONTROLS!==undefined&&y==ViewerType.VIEWER_EFFECT_CONTROLS)?4:5;"
+     "}"
+     "try{var t=app.project.toolType;tt=(t===ToolType.Tool_TextH||t===ToolType.Tool_TextV);}catch(e){}"
+     "if(c&&c instanceof CompItem){id=c.id;sel=c.selectedLayers;}"
+     "r.push(this.wRec([this.wInt(id),this.wInt(vt),this.wBool(tt),this.wInt(sel.length)]));"
+     "for(var i=0;i<sel.length&&i<64;i++){"
+     "var l=sel[i],k=0;"
+     "if(l instanceof TextLayer)k=1;"
+     "else if(l instanceof ShapeLayer)k=2;"
+     "else if(l instanceof CameraLayer)k=3;"
+     "else if(l instanceof LightLayer)k=4;"
+     "r.push(this.wRec([this.wInt(l.index),this.wInt(l.id!==undefined?l.id:0),this.wInt(k)]));"
+     "}"
+     "return r.join('');",
+     true, ""},
+
+    // Effects on the first selected layer: name, matchName, 0-based index
+    {"layerEffects", "",
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return '';"
+     "if(c.selectedLayers.length==0)return '';"
+     "var fx=c.selectedLayers[0].Effects;"
+     "if(!fx||fx.numProperties==0)return '';"
+     "var r=[];"
+     "for(var i=1;i<=fx.numProperties;i++){"
+     "var e=fx.property(i);"
+     "r.push(this.wRec([this.wStr(e.name),this.wStr(e.matchName),this.wInt(i-1)]));"
+     "}"
+     "return r.join('');",
+     true, ""},
+
+    // All fonts: family, style, PostScript name
+    {"fontsList", "",
+     "try{"
+     "var fonts=app.fonts.allFonts;"
+     "var r=[];"
+     "for(var i=0;i<fonts.length;i++){"
+     "var fam=fonts[i];"
+     "for(var j=0;j<fam.length;j++){"
+     "var f=fam[j];"
+     "if(f.isSubstitute)continue;"
+     "r.push(this.wRec([this.wStr(f.familyName),this.wStr(f.styleName),this.wStr(f.postScriptName)]));"
+     "}"
+     "}"
+     "return r.join('');"
+     "}catch(e){return '';}",
+     true, ""},
+
+    // Font catalog revalidation: family name, font count (no substitutes)
+    {"fontFamilies", "",
+     "try{"
+     "var fonts=app.fonts.allFonts;"
+     "var r=[];"
+     "for(var i=0;i<fonts.length;i++){"
+     "var fam=fonts[i],n=0;"
+     "for(var j=0;j<fam.length;j++)if(!fam[j].isSubstitute)n++;"
+     "if(n>0)r.push(this.wRec([this.wStr(fam[0].familyName),this.wInt(n)]));"
+     "}"
+     "return r.join('');"
+     "}catch(e){return '';}",
+     true, ""},
+
+    // fontsList() restricted to the given families (wire message of names)
+    {"fontsOf", "names",
+     "try{"
+     "var want={},l=this.wStrings(names);"
+     "for(var k=0;k<l.length;k++)want['_'+l[k]]=true;"
+     "var fonts=app.fonts.allFonts;"
+     "var r=[];"
+     "for(var i=0;i<fonts.length;i++){"
+     "var fam=fonts[i];"
+     "if(!fam.length||!want['_'+fam[0].familyName])continue;"
+     "for(var j=0;j<fam.length;j++){"
+     "var f=fam[j];"
+     "if(f.isSubstitute)continue;"
+     "r.push(this.wRec([this.wStr(f.familyName),this.wStr(f.styleName),this.wStr(f.postScriptName)]));"
+     "}"
+     "}"
+     "return r.join('');"
+     "}catch(e){return '';}",
+     true, "'R1:s5:Arial'"},
+
+    // ---------------------------------------------------------------------
+    // Anchor
+    // ---------------------------------------------------------------------
+    {"applyAnchor", "gx,gy,gridW,gridH,useCompMode,useMaskMode",
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return;"
+     "if(c.selectedLayers.length==0)return;"
+     "app.beginUndoGroup('Set Anchor');"
+     "for(var i=0;i<c.selectedLayers.length;i++){"
+     "var L=c.selectedLayers[i];"
+     "var b=null;"
+     // Composition mode: use comp bounds
+     "if(useCompMode){"
+     "b={left:0,top:0,width:c.width,height:c.height};"
+     "}else{"
+     // Selection mode: try mask first if enabled, then sourceRect
+     "if(useMaskMode){"
+     "var masks=L.property('ADBE Mask Parade');"
+     "if(masks&&masks.numProperties>0){"
+     "var minX=Infinity,minY=Infinity,maxX=-Infinity,maxY=-Infinity;"
+     "for(var m=1;m<=masks.numProperties;m++){"
+     "var mask=masks.property(m);"
+     "var path=mask.property('ADBE Mask Shape').valueAtTime(c.time,false);"
+     "if(!path||!path.vertices)continue;"
+     "var verts=path.vertices;"
+     "for(var v=0;v<verts.length;v++){"
+     "var pt=verts[v];"
+     "if(pt[0]<minX)minX=pt[0];"
+     "if(pt[0]>maxX)maxX=pt[0];"
+     "if(pt[1]<minY)minY=pt[1];"
+     "if(pt[1]>maxY)maxY=pt[1];"
+     "}}"
+     "if(minX!=Infinity){"
+     "b={left:minX,top:minY,width:maxX-minX,height:maxY-minY};"
+     "}}}"
+     // Fall back to sourceRectAtTime
+     "if(!b)b=L.sourceRectAtTime(c.time,false);"
+     "}"
+     "if(!b||b.width<=0||b.height<=0)continue;"
+     "var px=gx/(gridW-1),py=gy/(gridH-1);"
+     "var nx,ny;"
+     "if(useCompMode){"
+     // Composition mode: convert comp coord to layer local
+     "var pos=L.position.value;"
+     "var anc=L.anchorPoint.value;"
+     "var sc=L.scale.value;"
+     "var rot=L.rotation.value*Math.PI/180;"
+     "var compX=c.width*px,compY=c.height*py;"
+     "var dx=compX-pos[0],dy=compY-pos[1];"
+     "var cos_r=Math.cos(-rot),sin_r=Math.sin(-rot);"
+     "var rx=dx*cos_r-dy*sin_r,ry=dx*sin_r+dy*cos_r;"
+     "var sx=100/sc[0],sy=100/sc[1];"
+     "rx=rx*sx;ry=ry*sy;"
+     "nx=rx+anc[0];ny=ry+anc[1];"
+     "}else{"
+     // Selection mode: already in layer local coordinates
+     "nx=b.left+b.width*px;ny=b.top+b.height*py;"
+     "}"
+     "this.moveAnchor(c,L,nx,ny);"
+     "}"
+     "app.endUndoGroup();",
+     false, "1,1,3,3,false,false"},
+
+    {"applyCustomAnchor", "rx,ry",
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return;"
+     "if(c.selectedLayers.length==0)return;"
+     "app.beginUndoGroup('Set Custom Anchor');"
+     "for(var i=0;i<c.selectedLayers.length;i++){"
+     "var L=c.selectedLayers[i];"
+     "var b=L.sourceRectAtTime(c.time,false);"
+     "if(!b||b.width<=0||b.height<=0)continue;"
+     "this.moveAnchor(c,L,b.left+b.width*rx,b.top+b.height*ry);"
+     "}"
+     "app.endUndoGroup();",
+     false, "0.5000,0.5000"},
+
+    // Move anchor to (nx,ny) in layer space, compensating position
+    {"moveAnchor", "c,L,nx,ny",
+     "var ap=L.property('ADBE Transform Group').property('ADBE Anchor Point');"
+     "var pp=L.property('ADBE Transform Group').property('ADBE Position');"
+     "if(!ap||!pp)return;"
+     "var oa=ap.value,pos=pp.value;"
+     "var dx=nx-oa[0],dy=ny-oa[1];"
+     "var sc=L.property('ADBE Transform Group').property('ADBE Scale').value;"
+     "var sx=sc[0]/100,sy=sc[1]/100;"
+     "var rot=L.property('ADBE Transform Group').property('ADBE Rotate Z')"
+     ".value*Math.PI/180;"
+     "var rdx=(dx*Math.cos(rot)-dy*Math.sin(rot))*sx;"
+     "var rdy=(dx*Math.sin(rot)+dy*Math.cos(rot))*sy;"
+     "var newAp=[nx,ny];"
+     "var newPos=pos.length==3?[pos[0]+rdx,pos[1]+rdy,pos[2]]:[pos[0]+rdx,pos[1]+rdy];"
+     "if(ap.numKeys>0)ap.setValueAtTime(c.time,newAp);else ap.setValue(newAp);"
+     "if(pp.numKeys>0)pp.setValueAtTime(c.time,newPos);else pp.setValue(newPos);",
+     false, nullptr},
+
+    // ---------------------------------------------------------------------
+    // Effects (Control module)
+    // ---------------------------------------------------------------------
+    {"deleteEffect", "idx",
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return;"
+     "if(c.selectedLayers.length==0)return;"
+     "var fx=c.selectedLayers[0].Effects;"
+     "if(fx&&fx.numProperties>idx){"
+     "app.beginUndoGroup('Delete Effect');"
+     "fx.property(idx+1).remove();"
+     "app.endUndoGroup();"
+     "}",
+     false, "0"},
+
+    // Expand this effect in timeline (collapse others)
+    {"expandEffect", "idx",
+     "try{"
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return;"
+     "if(c.selectedLayers.length===0)return;"
+     "var fx=c.selectedLayers[0].property('ADBE Effect Parade');"
+     "if(!fx||fx.numProperties===0)return;"
+     "idx=idx+1;"
+     "if(idx<1||idx>fx.numProperties)return;"
+     "for(var i=1;i<=fx.numProperties;i++){"
+     "var e=fx.property(i);"
+     "e.selected=false;"
+     "for(var j=1;j<=e.numProperties;j++){"
+     "try{e.property(j).selected=false;}catch(ex){}"
+     "}"
+     "}"
+     "var target=fx.property(idx);"
+     "target.selected=true;"
+     "for(var k=1;k<=Math.min(target.numProperties,5);k++){"
+     "try{target.property(k).selected=true;}catch(ex){}"
+     "}"
+     "}catch(e){}",
+     false, "0"},
+
+    {"addEffect", "matchName",
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return;"
+     "if(c.selectedLayers.length==0)return;"
+     "app.beginUndoGroup('Add Effect');"
+     "for(var i=0;i<c.selectedLayers.length;i++){"
+     "try{c.selectedLayers[i].Effects.addProperty(matchName);}catch(e){}"
+     "}"
+     "app.endUndoGroup();",
+     false, "'ADBE Gaussian Blur 2'"},
+
+    {"savePreset", "",
+     "try{"
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return 'Error';"
+     "if(c.selectedLayers.length===0)return 'Error';"
+     "var fx=c.selectedLayers[0].property('ADBE Effect Parade');"
+     "if(!fx||fx.numProperties===0)return 'Error';"
+     "var allPresets={effects:[]};"
+     "for(var ei=0;ei<fx.numProperties;ei++){"
+     "var effect=fx.property(ei+1);"
+     "var preset={matchName:effect.matchName,name:effect.name,properties:[],expressions:[]};"
+     "for(var pi=1;pi<=effect.numProperties;pi++){"
+     "try{"
+     "var prop=effect.property(pi);"
+     "if(prop.propertyValueType===PropertyValueType.NO_VALUE)continue;"
+     "var pd={index:pi,name:prop.name,matchName:prop.matchName};"
+     "if(prop.numKeys===0){pd.value=prop.value;}else{pd.value=prop.valueAtTime(c.time,false);pd.hasKeyframes=true;}"
+     "if(prop.expression&&prop.expression.length>0){"
+     "preset.expressions.push({index:pi,expression:prop.expression,enabled:prop.expressionEnabled});"
+     "}"
+     "preset.properties.push(pd);"
+     "}catch(pe){}"
+     "}"
+     "allPresets.effects.push(preset);"
+     "}"
+     "return JSON.stringify(allPresets);"
+     "}catch(e){return 'Error';}",
+     true, ""},
+
+    {"applyPreset", "json",
+     "try{"
+     "var allPresets=json;"
+     "if(!allPresets||!allPresets.effects||allPresets.effects.length===0)return;"
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return;"
+     "if(c.selectedLayers.length===0)return;"
+     "app.beginUndoGroup('Apply Multi-Effect Preset');"
+     "for(var li=0;li<c.selectedLayers.length;li++){"
+     "var fx=c.selectedLayers[li].property('ADBE Effect Parade');"
+     "for(var ei=0;ei<allPresets.effects.length;ei++){"
+     "var preset=allPresets.effects[ei];"
+     "if(!fx.canAddProperty(preset.matchName))continue;"
+     "var newFx=fx.addProperty(preset.matchName);"
+     "for(var pi=0;pi<preset.properties.length;pi++){"
+     "try{"
+     "var pd=preset.properties[pi];"
+     "var prop=newFx.property(pd.index);"
+     "if(prop&&prop.propertyValueType!==PropertyValueType.NO_VALUE&&!pd.hasKeyframes){"
+     "prop.setValue(pd.value);"
+     "}"
+     "}catch(pe){}"
+     "}"
+     "for(var xi=0;xi<preset.expressions.length;xi++){"
+     "try{"
+     "var xd=preset.expressions[xi];"
+     "var xp=newFx.property(xd.index);"
+     "if(xp){xp.expression=xd.expression;xp.expressionEnabled=xd.enabled;}"
+     "}catch(xe){}"
+     "}"
+     "}"
+     "}"
+     "app.endUndoGroup();"
+     "}catch(e){}",
+     false, "JSON.parse('{}')"},
+
+    // ---------------------------------------------------------------------
+    // Keyframe
+    // ---------------------------------------------------------------------
+    // Interpolation type code of the keyframeInfo record (EaseModel)
+    {"easeType", "t",
+     "return t===KeyframeInterpolationType.HOLD?3:(t===KeyframeInterpolationType.LINEAR?1:2);",
+     false, nullptr},
+    // Value change of keys k1 -> k2 per temporal ease dimension: one per
+    // component, or the path length when one ease covers the whole value
+    // (spatial: Gauss-Legendre over the spatial bezier)
+    {"easeDeltas", "prop,k1,k2",
+     "var a=prop.keyValue(k1),b=prop.keyValue(k2),n=prop.keyOutTemporalEase(k1).length,r=[];"
+     "if(!(a instanceof Array))return [b-a];"
+     "if(n===a.length){for(var d=0;d<n;d++)r.push(b[d]-a[d]);return r;}"
+     "var p1=a,p2=b;"
+     "if(prop.isSpatial){"
+     "var to=prop.keyOutSpatialTangent(k1),ti=prop.keyInSpatialTangent(k2);p1=[];p2=[];"
+     "for(var d=0;d<a.length;d++){p1.push(a[d]+to[d]);p2.push(b[d]+ti[d]);}"
+     "}"
+     "var g=[[0.046910077030668,0.118463442528095],[0.230765344947158,0.239314335249683],"
+     "[0.5,0.284444444444444],[0.769234655052842,0.239314335249683],"
+     "[0.953089922969332,0.118463442528095]],len=0;"
+     "for(var h=0;h<2;h++)for(var q=0;q<5;q++){"
+     "var t=(h+g[q][0])/2,u=1-t,s=0;"
+     "for(var d=0;d<a.length;d++){"
+     "var v=3*u*u*(p1[d]-a[d])+6*u*t*(p2[d]-p1[d])+3*t*t*(b[d]-p2[d]);s+=v*v;"
+     "}"
+     "len+=g[q][1]*Math.sqrt(s)/2;"
+     "}"
+     "return [len];",
+     false, nullptr},
+    // Every selected key of every selected property (wire records: property
+    // header, then each key once with its ease per temporal ease dimension
+    // and the value change to the next selected key, exact doubles)
+    {"keyframeInfo", "",
+     "try{"
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return '';"
+     "var props=c.selectedProperties,r=[];"
+     "if(!props)return '';"
+     "for(var p=0;p<props.length;p++){"
+     "var prop=props[p],keys=prop.selectedKeys;"
+     "if(!keys||keys.length<2)continue;"
+     "var dims=Math.min(prop.keyOutTemporalEase(keys[0]).length,3);"
+     "r.push(this.wRec([this.wStr(prop.name),this.wStr(prop.matchName),this.wInt(p),"
+     "this.wInt(dims),this.wInt(keys.length)]));"
+     "for(var j=0;j<keys.length;j++){"
+     "var k=keys[j],n=prop.keyInTemporalEase(k),o=prop.keyOutTemporalEase(k);"
+     "var dl=j+1<keys.length?this.easeDeltas(prop,k,keys[j+1]):[];"
+     "var f=[this.wInt(k),this.wDbl(prop.keyTime(k)),"
+     "this.wInt(this.easeType(prop.keyInInterpolationType(k))),"
+     "this.wInt(this.easeType(prop.keyOutInterpolationType(k)))];"
+     "for(var d=0;d<dims;d++)"
+     "f.push(this.wDbl(d<dl.length?dl[d]:0),this.wDbl(n[d].speed),this.wDbl(n[d].influence),"
+     "this.wDbl(o[d].speed),this.wDbl(o[d].influence));"
+     "r.push(this.wRec(f));"
+     "}"
+     "}"
+     "return r.join('');"
+     "}catch(e){return '';}",
+     true, ""},
+
+    // Per-pair eases computed in C++ (KeyframeSelection::BuildApply wire
+    // records), written in one undo group. Properties are matched by
+    // position and matchName; the middle key of K1-K2-K3 gets its in ease
+    // from the first pair and its out ease from the second
+    {"applyEase", "w",
+     "try{"
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return 0;"
+     "var props=c.selectedProperties,recs=this.wRecords(w),prop=null,dims=0,n=0;"
+     "if(!props||recs.length===0)return 0;"
+     "app.beginUndoGroup('Apply Keyframe Easing');"
+     "for(var i=0;i<recs.length;i++){"
+     "var r=recs[i];"
+     "if(typeof r[0]==='string'){"
+     "prop=(r[1]<props.length&&props[r[1]].matchName===r[0])?props[r[1]]:null;dims=r[2];"
+     "continue;"
+     "}"
+     "if(!prop||r[1]>prop.numKeys)continue;"
+     "var oa=[],ia=[];"
+     "for(var d=0;d<dims;d++){"
+     "var b=2+d*4;"
+     "oa.push(new KeyframeEase(r[b],r[b+1]));ia.push(new KeyframeEase(r[b+2],r[b+3]));"
+     "}"
+     "try{prop.setTemporalEaseAtKey(r[0],prop.keyInTemporalEase(r[0]),oa);n++;}catch(e){}"
+     "try{prop.setTemporalEaseAtKey(r[1],ia,prop.keyOutTemporalEase(r[1]));}catch(e){}"
+     "}"
+     "app.endUndoGroup();"
+     "return n;"
+     "}catch(e){return 0;}",
+     false, "''"},
+
+    // ---------------------------------------------------------------------
+    // Text
+    // ---------------------------------------------------------------------
+    {"textInfo", "",
+     "try{"
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return '';"
+     "var sel=c.selectedLayers;"
+     "var textLayer=null;"
+     "for(var i=0;i<sel.length;i++){"
+     "if(sel[i] instanceof TextLayer){textLayer=sel[i];break;}"
+     "}"
+     "if(!textLayer)return '';"
+     "var txt=textLayer.text.sourceText.value;"
+     "if(!txt)return '';"
+     "var font=(txt.font!=null)?txt.font:'Arial';"
+     "var fontStyle=(txt.fontStyle!=null)?txt.fontStyle:'Regular';"
+     "var fontSize=(txt.fontSize!=null)?txt.fontSize:72;"
+     "var tracking=(txt.tracking!=null)?txt.tracking:0;"
+     "var leading=(txt.leading!=null)?txt.leading:0;"
+     "var strokeWidth=(txt.strokeWidth!=null)?txt.strokeWidth:0;"
+     "var applyFill=(txt.applyFill!==false);"
+     "var applyStroke=(txt.applyStroke===true);"
+     "var fill=(applyFill&&txt.fillColor&&txt.fillColor.length>=3)?txt.fillColor:[1,1,1];"
+     "var stroke=(applyStroke&&txt.strokeColor&&txt.strokeColor.length>=3)?txt.strokeColor:[0,0,0];"
+     "var just=txt.justification||ParagraphJustification.LEFT_JUSTIFY;"
+     "var justNum=0;"
+     "if(just==ParagraphJustification.LEFT_JUSTIFY)justNum=0;"
+     "else if(just==ParagraphJustification.CENTER_JUSTIFY)justNum=1;"
+     "else if(just==ParagraphJustification.RIGHT_JUSTIFY)justNum=2;"
+     "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_LEFT)justNum=3;"
+     "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_CENTER)justNum=4;"
+     "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_RIGHT)justNum=5;"
+     "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_FULL)justNum=6;"
+     "return this.wRec([this.wStr(font),this.wStr(fontStyle),"
+     "this.wNum(fontSize),this.wNum(tracking),this.wNum(leading),this.wNum(strokeWidth),"
+     "this.wNum(fill[0]),this.wNum(fill[1]),this.wNum(fill[2]),"
+     "this.wNum(stroke[0]),this.wNum(stroke[1]),this.wNum(stroke[2]),"
+     "this.wBool(applyFill),this.wBool(applyStroke),this.wInt(justNum),"
+     "this.wStr(textLayer.name)]);"
+     "}catch(e){return '';}",
+     true, ""},
+
+    // ---------------------------------------------------------------------
+    // Comp (Layer module)
+    // ---------------------------------------------------------------------
+    // LayerType: 0=NONE 1=TEXT 2=SHAPE 3=SOLID 4=NULL 5=FOOTAGE 6=CAMERA
+    //            7=LIGHT 8=ADJUSTMENT 9=PRECOMP
+    {"layerInfo", "",
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return '';"
+     "var layers=c.selectedLayers;"
+     "if(layers.length===0)return '';"
+     "var layer=layers[0];"
+     "var type=0;"
+     "if(layer instanceof TextLayer)type=1;"
+     "else if(layer instanceof ShapeLayer)type=2;"
+     "else if(layer instanceof CameraLayer)type=6;"
+     "else if(layer instanceof LightLayer)type=7;"
+     "else if(layer instanceof AVLayer){"
+     "if(layer.nullLayer)type=4;"
+     "else if(layer.adjustmentLayer)type=8;"
+     "else if(layer.source instanceof CompItem)type=9;"
+     "else if(layer.source&&layer.source.mainSource instanceof SolidSource)type=3;"
+     "else type=5;"
+     "}"
+     "var hasParent=layer.parent!==null;"
+     "var parentIdx=hasParent?layer.parent.index:0;"
+     "var isSeq=false,hasTimeRemap=false;"
+     "if(type===5&&layer.source&&layer.source.mainSource){"
+     "isSeq=!layer.source.mainSource.isStill;"
+     "hasTimeRemap=layer.timeRemapEnabled;"
+     "}"
+     "var solidColor=0;"
+     "if(type===3&&layer.source&&layer.source.mainSource instanceof SolidSource){"
+     "var col=layer.source.mainSource.color;"
+     "solidColor=Math.round(col[0]*255)*65536+Math.round(col[1]*255)*256+Math.round(col[2]*255);"
+     "}"
+     "return this.wRec([this.wStr(layer.name),this.wInt(type),this.wInt(layer.index),"
+     "this.wBool(hasParent),this.wInt(parentIdx),this.wBool(true),"
+     "this.wInt(solidColor),this.wBool(isSeq),this.wBool(hasTimeRemap)]);",
+     true, ""},
+
+    // ---------------------------------------------------------------------
+    // Shape
+    // ---------------------------------------------------------------------
+    // First shape group of the selected shape layer (wire record)
+    {"shapeInfo", "",
+     "try{"
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return '';"
+     "if(c.selectedLayers.length===0)return '';"
+     "var layer=c.selectedLayers[0];"
+     "if(!(layer instanceof ShapeLayer))return '';"
+     "var contents=layer.property('ADBE Root Vectors Group');"
+     "if(!contents||contents.numProperties===0)return '';"
+     "var g=contents.property(1);"
+     "if(!g)return '';"
+     "var type='Path',hasFill=false,hasStroke=false;"
+     "var fc=[1,1,1],sc=[0,0,0],sw=0,op=100;"
+     "var w=100,h=100,rnd=0,ax=0,ay=0,param=false;"
+     "var bl=0,bt=0,bw=100,bh=100;"
+     "var rect=g.property('ADBE Vector Shape - Rect');"
+     "var ell=g.property('ADBE Vector Shape - Ellipse');"
+     "if(rect){"
+     "type='Rectangle';param=true;"
+     "var sz=rect.property('ADBE Vector Rect Size').value;"
+     "var ps=rect.property('ADBE Vector Rect Position').value;"
+     "w=sz[0];h=sz[1];bl=ps[0]-sz[0]/2;bt=ps[1]-sz[1]/2;bw=sz[0];bh=sz[1];"
+     "var rr=rect.property('ADBE Vector Rect Roundness');"
+     "if(rr)rnd=rr.value;"
+     "}else if(ell){"
+     "type='Ellipse';param=true;"
+     "var es=ell.property('ADBE Vector Ellipse Size').value;"
+     "var ep=ell.property('ADBE Vector Ellipse Position').value;"
+     "w=es[0];h=es[1];bl=ep[0]-es[0]/2;bt=ep[1]-es[1]/2;bw=es[0];bh=es[1];"
+     "}"
+     "var fill=g.property('ADBE Vector Graphic - Fill');"
+     "if(fill){"
+     "hasFill=true;"
+     "var fcp=fill.property('ADBE Vector Fill Color');"
+     "if(fcp){var f=fcp.value;fc=[f[0],f[1],f[2]];}"
+     "var fo=fill.property('ADBE Vector Fill Opacity');"
+     "if(fo)op=fo.value;"
+     "}"
+     "var stroke=g.property('ADBE Vector Graphic - Stroke');"
+     "if(stroke){"
+     "hasStroke=true;"
+     "var scp=stroke.property('ADBE Vector Stroke Color');"
+     "if(scp){var s=scp.value;sc=[s[0],s[1],s[2]];}"
+     "var swp=stroke.property('ADBE Vector Stroke Width');"
+     "if(swp)sw=swp.value;"
+     "}"
+     "var gt=g.property('ADBE Vector Transform Group');"
+     "if(gt){var an=gt.property('ADBE Vector Anchor');if(an){ax=an.value[0];ay=an.value[1];}}"
+     "return this.wRec([this.wStr(layer.name),this.wStr(g.name),this.wStr(type),"
+     "this.wBool(hasFill),this.wBool(hasStroke),"
+     "this.wNum(fc[0]),this.wNum(fc[1]),this.wNum(fc[2]),"
+     "this.wNum(sc[0]),this.wNum(sc[1]),this.wNum(sc[2]),"
+     "this.wNum(sw),this.wNum(op),this.wNum(w),this.wNum(h),this.wNum(rnd),"
+     "this.wNum(ax),this.wNum(ay),this.wBool(param),this.wBool(false),"
+     "this.wNum(bl),this.wNum(bt),this.wNum(bw),this.wNum(bh)]);"
+     "}catch(e){return '';}",
+     true, ""},
+
+    // ---------------------------------------------------------------------
+    // D menu prefetch (PanelPrefetch)
+    // ---------------------------------------------------------------------
+    // Every panel info result in one record (WireFormat::PanelField):
+    // selectionContext, textInfo, shapeInfo, keyframeInfo, layerInfo
+    {"panelSnapshot", "",
+     "var fn=['selectionContext','textInfo','shapeInfo','keyframeInfo','layerInfo'],r=[];"
+     "for(var i=0;i<fn.length;i++){"
+     "var v='';"
+     "try{v=this[fn[i]]();}catch(e){}"
+     "r.push(this.wStr(v));"
+     "}"
+     "return this.wRec(r);",
+     true, ""},
+
+    // Range-selector text animator (typewriter, fade, scale, blur, tracking)
+    {"textAnimator", "undoName,animName,endFrac,propName,value",
+     "var c=app.project.activeItem;if(!c)return;"
+     "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof TextLayer))return;"
+     "app.beginUndoGroup(undoName);"
+     "var tp=layer.Text.property('ADBE Text Animators');"
+     "var anim=tp.addProperty('ADBE Text Animator');"
+     "anim.name=animName;"
+     "var sel=anim.property('ADBE Text Selectors').addProperty('ADBE Text Selector');"
+     "var range=sel.property('ADBE Text Percent Start');"
+     "range.setValueAtTime(0,100);range.setValueAtTime(c.duration*endFrac,0);"
+     "var props=anim.property('ADBE Text Animator Properties');"
+     "props.addProperty(propName);props.property(propName).setValue(value);"
+     "app.endUndoGroup();",
+     false, "'Add Fade In','Fade In',0.5,'ADBE Text Opacity',0"},
+
+    {"trimPath", "",
+     "var c=app.project.activeItem;if(!c)return;"
+     "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof ShapeLayer))return;"
+     "app.beginUndoGroup('Add Trim Paths');"
+     "var contents=layer.property('ADBE Root Vectors Group');"
+     "var trim=contents.addProperty('ADBE Vector Filter - Trim');"
+     "trim.property('ADBE Vector Trim End').setValueAtTime(0,0);"
+     "trim.property('ADBE Vector Trim End').setValueAtTime(c.duration*0.5,100);"
+     "app.endUndoGroup();",
+     false, ""},
+
+    {"repeater", "",
+     "var c=app.project.activeItem;if(!c)return;"
+     "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof ShapeLayer))return;"
+     "app.beginUndoGroup('Add Repeater');"
+     "var contents=layer.property('ADBE Root Vectors Group');"
+     "var rep=contents.addProperty('ADBE Vector Filter - Repeater');"
+     "rep.property('ADBE Vector Repeater Copies').setValue(5);"
+     "rep.property('ADBE Vector Repeater Transform').property('ADBE Vector Repeater Position').setValue([100,0]);"
+     "app.endUndoGroup();",
+     false, ""},
+
+    // Plain shape operator (wiggle paths / wiggle transform)
+    {"shapeFilter", "undoName,matchName",
+     "var c=app.project.activeItem;if(!c)return;"
+     "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof ShapeLayer))return;"
+     "app.beginUndoGroup(undoName);"
+     "layer.property('ADBE Root Vectors Group').addProperty(matchName);"
+     "app.endUndoGroup();",
+     false, "'Add Wiggle Paths','ADBE Vector Filter - Wiggler'"},
+
+    {"fitSolid", "",
+     "var c=app.project.activeItem;if(!c)return;"
+     "var layer=c.selectedLayers[0];if(!layer)return;"
+     "if(!(layer.source instanceof SolidSource))return;"
+     "app.beginUndoGroup('Fit Solid to Comp');"
+     "layer.source.mainSource.width=c.width;"
+     "layer.source.mainSource.height=c.height;"
+     "app.endUndoGroup();",
+     false, ""},
+
+    {"loopFootage", "undoName,loopType",
+     "var c=app.project.activeItem;if(!c)return;"
+     "var layer=c.selectedLayers[0];if(!layer)return;"
+     "app.beginUndoGroup(undoName);"
+     "layer.timeRemapEnabled=true;"
+     "layer.timeRemap.expression='loopOut(\"'+loopType+'\")';"
+     "layer.outPoint=c.duration;"
+     "app.endUndoGroup();",
+     false, "'Add Loop Cycle','cycle'"},
+
+    {"lastFrameHold", "",
+     "var c=app.project.activeItem;if(!c)return;"
+     "var layer=c.selectedLayers[0];if(!layer)return;"
+     "app.beginUndoGroup('Last Frame Hold');"
+     "layer.timeRemapEnabled=true;"
+     "var dur=layer.source.duration;"
+     "layer.timeRemap.setValueAtTime(dur,dur-c.frameDuration);"
+     "layer.outPoint=c.duration;"
+     "app.endUndoGroup();",
+     false, ""},
+
+    {"resetTransform", "",
+     "var c=app.project.activeItem;if(!c)return;"
+     "var layer=c.selectedLayers[0];if(!layer)return;"
+     "app.beginUndoGroup('Reset Transform');"
+     "var hasParent=layer.parent!==null;"
+     "var oldParent=layer.parent;"
+     "if(hasParent)layer.parent=null;"
+     "layer.position.setValue([c.width/2,c.height/2]);"
+     "layer.scale.setValue([100,100]);"
+     "layer.rotation.setValue(0);"
+     "if(hasParent)layer.parent=oldParent;"
+     "app.endUndoGroup();",
+     false, ""},
+
+    {"resetPosition", "",
+     "var c=app.project.activeItem;if(!c)return;"
+     "var layer=c.selectedLayers[0];if(!layer)return;"
+     "app.beginUndoGroup('Reset Position');"
+     "var hasParent=layer.parent!==null;"
+     "var oldParent=layer.parent;"
+     "if(hasParent)layer.parent=null;"
+     "layer.position.setValue([c.width/2,c.height/2,0]);"
+     "if(hasParent)layer.parent=oldParent;"
+     "app.endUndoGroup();",
+     false, ""},
+
+    // ---------------------------------------------------------------------
+    // Align
+    // ---------------------------------------------------------------------
+    // Comp-space bounds of a layer
+    {"layerBounds", "c,L",
+     "var r=L.sourceRectAtTime(c.time,false);"
+     "var pos=L.position.value,anc=L.anchorPoint.value,sc=L.scale.value;"
+     "var w=r.width*sc[0]/100,h=r.height*sc[1]/100;"
+     "var left=pos[0]-(anc[0]-r.left)*sc[0]/100;"
+     "var top=pos[1]-(anc[1]-r.top)*sc[1]/100;"
+     "return{left:left,top:top,right:left+w,bottom:top+h,cx:left+w/2,cy:top+h/2,w:w,h:h,layer:L};",
+     false, nullptr},
+
+    // dir: 0=left,1=centerH,2=right,3=top,4=middleV,5=bottom
+    {"align", "useComp,dir",
+     "try{"
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return;"
+     "var layers=c.selectedLayers;"
+     "if(layers.length===0)return;"
+     "app.beginUndoGroup('Align Layers');"
+     "var allBounds=[];"
+     "for(var i=0;i<layers.length;i++)allBounds.push(this.layerBounds(c,layers[i]));"
+     "var target;"
+     "if(useComp){"
+     "target={left:0,top:0,right:c.width,bottom:c.height,cx:c.width/2,cy:c.height/2};"
+     "}else{"
+     "var minL=Infinity,minT=Infinity,maxR=-Infinity,maxB=-Infinity;"
+     "for(var i=0;i<allBounds.length;i++){"
+     "var b=allBounds[i];"
+     "if(b.left<minL)minL=b.left;if(b.top<minT)minT=b.top;"
+     "if(b.right>maxR)maxR=b.right;if(b.bottom>maxB)maxB=b.bottom;"
+     "}"
+     "target={left:minL,top:minT,right:maxR,bottom:maxB,cx:(minL+maxR)/2,cy:(minT+maxB)/2};"
+     "}"
+     "for(var i=0;i<layers.length;i++){"
+     "var L=layers[i],b=allBounds[i];"
+     "var pos=L.position.value;"
+     "var dx=0,dy=0;"
+     "if(dir===0)dx=target.left-b.left;"
+     "else if(dir===1)dx=target.cx-b.cx;"
+     "else if(dir===2)dx=target.right-b.right;"
+     "else if(dir===3)dy=target.top-b.top;"
+     "else if(dir===4)dy=target.cy-b.cy;"
+     "else if(dir===5)dy=target.bottom-b.bottom;"
+     "var pp=L.property('ADBE Transform Group').property('ADBE Position');"
+     "var newPos=[pos[0]+dx,pos[1]+dy];"
+     "if(pp.numKeys>0)pp.setValueAtTime(c.time,newPos);else pp.setValue(newPos);"
+     "}"
+     "app.endUndoGroup();"
+     "}catch(e){alert('Align error: '+e.toString());}",
+     false, "false,0"},
+
+    {"distribute", "useComp,isH",
+     "try{"
+     "var c=app.project.activeItem;"
+     "if(!c||!(c instanceof CompItem))return;"
+     "var layers=c.selectedLayers;"
+     "if(layers.length<3)return;"
+     "app.beginUndoGroup('Distribute Layers');"
+     "var data=[];"
+     "for(var i=0;i<layers.length;i++)data.push(this.layerBounds(c,layers[i]));"
+     "data.sort(function(a,b){return isH?(a.cx-b.cx):(a.cy-b.cy);});"
+     "var first,last;"
+     "if(useComp){"
+     "first=0;last=isH?c.width:c.height;"
+     "}else{"
+     "first=isH?data[0].cx:data[0].cy;"
+     "last=isH?data[data.length-1].cx:data[data.length-1].cy;"
+     "}"
+     "var spacing=(last-first)/(data.length-1);"
+     "for(var i=1;i<data.length-1;i++){"
+     "var targetPos=first+spacing*i;"
+     "var delta=isH?(targetPos-data[i].cx):(targetPos-data[i].cy);"
+     "var pos=data[i].layer.position.value;"
+     "var pp=data[i].layer.property('ADBE Transform Group').property('ADBE Position');"
+     "var newPos=isH?[pos[0]+delta,pos[1]]:[pos[0],pos[1]+delta];"
+     "if(pp.numKeys>0)pp.setValueAtTime(c.time,newPos);else pp.setValue(newPos);"
+     "}"
+     "app.endUndoGroup();"
+     "}catch(e){alert('Distribute error: '+e.toString());}",
+     false, "false,true"},
+};
+
+static const size_t FUNCTION_COUNT = sizeof(s_functions) / sizeof(s_functions[0]);
+
+static Stats s_stats;
+
+static const Function *FindFunction(const char *name) {
+  for (size_t i = 0; i < FUNCTION_COUNT; i++) {
+    if (strcmp(s_functions[i].name, name) == 0)
+      return &s_functions[i];
+  }
+  return nullptr;
+}
+
+static std::string BuildCall(const char *fn, const std::string &args) {
+  std::string call;
+  call.reserve(64 + strlen(fn) + args.size());
+  call += "($.global.";
+  call += NAMESPACE;
+  call += "?";
+  call += NAMESPACE;
+  call += ".";
+  call += fn;
+  call += "(";
+  call += args;
+  call += "):'\\x18')";
+  return call;
+}
+
+/*****************************************************************************
+ * Public API
+ *****************************************************************************/
+
+std::string BuildBootstrap() {
+  size_t total = 128;
+  for (size_t i = 0; i < FUNCTION_COUNT; i++)
+    total += strlen(s_functions[i].body) + 64;
+
+  std::string out;
+  out.reserve(total);
+  out += "(function(){$.global.";
+  out += NAMESPACE;
+  out += "={";
+  for (size_t i = 0; i < FUNCTION_COUNT; i++) {
+    const Function &f = s_functions[i];
+    out += f.name;
+    out += ":function(";
+    out += f.params;
+    out += "){";
+    out += f.body;
+    out += "},";
+  }
+  out += "version:";
+  out += std::to_string(VERSION);
+  out += "};return 'ok';})();";
+  return out;
+}
+
+std::string BuildInline(const char *fn, const char *args) {
+  const Function *f = FindFunction(fn);
+  if (!f)
+    return std::string();
+  // Helpers reached through "this." (entries without sample args) are
+  // bound to a throwaway object so the inline form behaves like the
+  // pre-library scripts
+  std::string out = "(function(";
+  out += f->params;
+  out += "){";
+  out += f->body;
+  out += "}).call({";
+  bool first = true;
+  for (size_t i = 0; i < FUNCTION_COUNT; i++) {
+    const Function &helper = s_functions[i];
+    if (helper.sampleArgs)
+      continue;
+    if (!first)
+      out += ",";
+    first = false;
+    out += helper.name;
+    out += ":function(";
+    out += helper.params;
+    out += "){";
+    out += helper.body;
+    out += "}";
+  }
+  out += "}";
+  if (args[0] != '\0') {
+    out += ",";
+    out += args;
+  }
+  out += ")";
+  return out;
+}
+
+bool Install() {
+  std::string bootstrap = BuildBootstrap();
+  ScriptBatch::Future f = ScriptBatch::Enqueue("ScriptLibrary::Install",
+                                               bootstrap.c_str());
+  bool ok = f.Get() == "ok";
+  s_stats.installs++;
+  return ok;
+}
+
+// "fn(args)" -> function name and argument text
+static void SplitRendered(const char *rendered, std::string &fn,
+                          std::string &argText) {
+  const char *paren = strchr(rendered, '(');
+  fn.assign(rendered, paren ? (size_t)(paren - rendered) : strlen(rendered));
+  argText = paren ? std::string(paren + 1) : std::string();
+  if (!argText.empty())
+    argText.pop_back(); // ')'
+}
+
+std::string BuildCallScript(const char *rendered) {
+  std::string fn, argText;
+  SplitRendered(rendered, fn, argText);
+  return BuildCall(fn.c_str(), argText);
+}
+
+bool IsMissing(std::string_view result) {
+  return result.size() == 1 && result[0] == MISSING_SENTINEL;
+}
+
+std::string CallScript(const char *rendered) {
+  std::string fn, argText;
+  SplitRendered(rendered, fn, argText);
+
+  std::string call = BuildCall(fn.c_str(), argText);
+  const Function *f = FindFunction(fn.c_str());
+
+  // Mutating calls may change the selection (new layers, deleted effects)
+  if (!f || !f->readOnly)
+    ContextCache::Invalidate();
+
+  s_stats.calls++;
+  s_stats.bytesSent += call.size();
+  if (f)
+    s_stats.inlineBytes += strlen(f->body) + strlen(f->params) +
+                           argText.size() + 32;
+
+  std::string result = ScriptBatch::Enqueue(f ? f->name : "ScriptLibrary",
+                                            call.c_str()).Get();
+
+  // Namespace missing (engine reset / project reload): install and retry
+  if (IsMissing(result)) {
+    if (!Install())
+      return std::string();
+    s_stats.bytesSent += call.size();
+    result = ScriptBatch::Enqueue(f ? f->name : "ScriptLibrary",
+                                  call.c_str()).Get();
+    if (IsMissing(result))
+      result.clear();
+  }
+  return result;
+}
+
+Stats GetStats() { return s_stats; }
+
+std::string RunBenchmark(int iterations) {
+  typedef std::chrono::steady_clock Clock;
+  if (iterations < 1)
+    iterations = 1;
+
+  Install();
+
+  std::string report;
+  char line[256];
+  snprintf(line, sizeof(line),
+           "ScriptLibrary benchmark (%d runs, bootstrap %u bytes)\n"
+           "%-16s %8s %8s %10s %10s\n",
+           iterations, (unsigned)BuildBootstrap().size(), "function",
+           "inlineB", "callB", "inline ms", "call ms");
+  report += line;
+
+  for (size_t i = 0; i < FUNCTION_COUNT; i++) {
+    const Function &f = s_functions[i];
+    if (!f.sampleArgs)
+      continue; // Internal helper
+
+    std::string inlineScript = BuildInline(f.name, f.sampleArgs);
+    std::string callScript = BuildCall(f.name, f.sampleArgs);
+
+    double inlineMs = -1.0, callMs = -1.0;
+    if (f.readOnly) {
+      // Each Get() is its own round-trip, so this times transport + parse
+      Clock::time_point t0 = Clock::now();
+      for (int n = 0; n < iterations; n++)
+        ScriptBatch::Enqueue("bench", inlineScript.c_str()).Get();
+      Clock::time_point t1 = Clock::now();
+      for (int n = 0; n < iterations; n++)
+        ScriptBatch::Enqueue("bench", callScript.c_str()).Get();
+      Clock::time_point t2 = Clock::now();
+      inlineMs =
+          std::chrono::duration<double, std::milli>(t1 - t0).count() /
+          iterations;
+      callMs = std::chrono::duration<double, std::milli>(t2 - t1).count() /
+               iterations;
+    }
+
+    if (f.readOnly) {
+      snprintf(line, sizeof(line), "%-16s %8u %8u %10.3f %10.3f\n", f.name,
+               (unsigned)inlineScript.size(), (unsigned)callScript.size(),
+               inlineMs, callMs);
+    } else {
+      snprintf(line, sizeof(line), "%-16s %8u %8u %10s %10s\n", f.name,
+               (unsigned)inlineScript.size(), (unsigned)callScript.size(),
+               "-", "-");
+    }
+    report += line;
+  }
+  return report;
+}
+
+} // namespace ScriptLibrary
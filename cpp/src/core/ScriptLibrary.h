@@ -0,0 +1,131 @@
+/*****************************************************************************
+ * ScriptLibrary.h
+ *
+ * Preinstalled ExtendScript function library
+ *
+ * The large inline scripts (anchor, align/distribute, keyframe info/ease,
+ * effect presets, comp actions) are installed once into a versioned
+ * $.global namespace. Each use then sends a short "ns.fn(args)" call
+ * instead of re-sending and re-parsing the whole body.
+ *
+ * If the namespace is gone (e.g. the ExtendScript engine was reset), the
+ * call returns a sentinel and the library is re-installed lazily before
+ * the call is retried.
+ *
+ * Transport goes through ScriptBatch, so this module is platform-neutral.
+ *****************************************************************************/
+
+#pragma once
+
+#include "ScriptBuilder.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace ScriptLibrary {
+
+// Library version and the namespace derived from it ("AnchorSnap_v<N>"):
+// bumped when any function changes so a stale install from an older
+// plugin build is never used
+extern const int VERSION;
+extern const char *const NAMESPACE;
+
+// Library statistics
+struct Stats {
+  uint64_t installs = 0;         // Bootstrap runs (initial + lazy)
+  uint64_t calls = 0;            // Library calls issued
+  uint64_t bytesSent = 0;        // Call script bytes sent
+  uint64_t inlineBytes = 0;      // Bytes the inline equivalent would send
+};
+
+/**
+ * Install all functions into $.global[NAMESPACE]
+ * Called at EntryPointFunc; safe to call again (replaces the namespace).
+ * @return true if the host confirmed the install
+ */
+bool Install();
+
+/**
+ * Call a rendered "fn(args)" expression (synchronous)
+ * @return function result ("" for undefined)
+ */
+std::string CallScript(const char *call);
+
+/**
+ * Namespaced call script for a rendered "fn(args)" expression, for callers
+ * that run it on their own transport (large results read in place).
+ * Check the result with IsMissing(); on true, Install() and run it again.
+ */
+std::string BuildCallScript(const char *call);
+
+// True if a call result is the "namespace missing" sentinel
+bool IsMissing(std::string_view result);
+
+/**
+ * Call a library function with typed arguments (synchronous)
+ *   ScriptLibrary::Call<ScriptLibrary::ApplyCustomAnchorCall>(rx, ry);
+ * Argument count/types are checked against the call template at compile time.
+ */
+template <typename Tpl, typename... Args>
+std::string Call(const Args &...args) {
+  return CallScript(ScriptBuilder::Render<Tpl>(ScriptBuilder::DefaultArena(),
+                                               args...));
+}
+
+// Full bootstrap script (exposed for the benchmark / diagnostics)
+std::string BuildBootstrap();
+
+/**
+ * Inline form of a library call: the function body wrapped as
+ * "(function(params){body})(args)" - what the plugin used to send
+ */
+std::string BuildInline(const char *fn, const char *args);
+
+Stats GetStats();
+
+/**
+ * Benchmark: bytes sent and host time per call, inline vs library call.
+ * Only read-only functions are timed; mutating ones report bytes only.
+ * @param iterations  Runs per function and mode
+ * @return multi-line report text
+ */
+std::string RunBenchmark(int iterations);
+
+/*****************************************************************************
+ * Call templates (one per library function)
+ *****************************************************************************/
+SCRIPT_TEMPLATE(ApplyAnchorCall, "applyAnchor(${i},${i},${i},${i},${b},${b})");
+SCRIPT_TEMPLATE(ApplyCustomAnchorCall, "applyCustomAnchor(${f},${f})");
+SCRIPT_TEMPLATE(DeleteEffectCall, "deleteEffect(${i})");
+SCRIPT_TEMPLATE(ExpandEffectCall, "expandEffect(${i})");
+SCRIPT_TEMPLATE(AddEffectCall, "addEffect(${s})");
+SCRIPT_TEMPLATE(SavePresetCall, "savePreset()");
+SCRIPT_TEMPLATE(ApplyPresetCall, "applyPreset(${j})");
+SCRIPT_TEMPLATE(HostInfoCall, "hostInfo()");
+SCRIPT_TEMPLATE(EffectsListCall, "effectsList()");
+SCRIPT_TEMPLATE(SelectionContextCall, "selectionContext()");
+SCRIPT_TEMPLATE(LayerEffectsCall, "layerEffects()");
+SCRIPT_TEMPLATE(FontsListCall, "fontsList()");
+SCRIPT_TEMPLATE(FontFamiliesCall, "fontFamilies()");
+SCRIPT_TEMPLATE(FontsOfCall, "fontsOf(${s})");
+SCRIPT_TEMPLATE(KeyframeInfoCall, "keyframeInfo()");
+SCRIPT_TEMPLATE(ApplyEaseCall, "applyEase(${s})");
+SCRIPT_TEMPLATE(TextInfoCall, "textInfo()");
+SCRIPT_TEMPLATE(LayerInfoCall, "layerInfo()");
+SCRIPT_TEMPLATE(ShapeInfoCall, "shapeInfo()");
+SCRIPT_TEMPLATE(PanelSnapshotCall, "panelSnapshot()");
+SCRIPT_TEMPLATE(TextAnimatorCall, "textAnimator(${s},${s},${f},${s},${j})");
+SCRIPT_TEMPLATE(TrimPathCall, "trimPath()");
+SCRIPT_TEMPLATE(RepeaterCall, "repeater()");
+SCRIPT_TEMPLATE(ShapeFilterCall, "shapeFilter(${s},${s})");
+SCRIPT_TEMPLATE(FitSolidCall, "fitSolid()");
+SCRIPT_TEMPLATE(LoopFootageCall, "loopFootage(${s},${s})");
+SCRIPT_TEMPLATE(LastFrameHoldCall, "lastFrameHold()");
+SCRIPT_TEMPLATE(ResetTransformCall, "resetTransform()");
+SCRIPT_TEMPLATE(ResetPositionCall, "resetPosition()");
+SCRIPT_TEMPLATE(AlignCall, "align(${b},${i})");
+SCRIPT_TEMPLATE(DistributeCall, "distribute(${b},${b})");
+
+} // namespace ScriptLibrary
@@ -0,0 +1,90 @@
+/*****************************************************************************
+ * ScriptResult.cpp
+ *
+ * Zero-copy ExtendScript results (see ScriptResult.h)
+ *****************************************************************************/
+
+#include "ScriptResult.h"
+#include "ScriptBuilder.h"
+
+#include <utility>
+
+namespace ScriptResult {
+
+// ---------------------------------------------------------------------------
+// Result
+// ---------------------------------------------------------------------------
+
+Result Result::FromString(std::string text, bool succeeded) {
+  Result r;
+  r.m_owned = std::move(text);
+  r.m_text = r.m_owned;
+  r.m_succeeded = succeeded;
+  return r;
+}
+
+void Result::Release() {
+  if (m_handle && m_release)
+    m_release(m_handle, m_context);
+  m_handle = nullptr;
+  m_release = nullptr;
+  m_context = nullptr;
+  m_text = std::string_view();
+  m_owned.clear();
+}
+
+void Result::MoveFrom(Result &other) {
+  // Moving a std::string may move small-string storage, so re-point the view
+  bool owned = other.m_handle == nullptr && !other.m_owned.empty();
+  m_owned = std::move(other.m_owned);
+  m_text = owned ? std::string_view(m_owned) : other.m_text;
+  m_succeeded = other.m_succeeded;
+  m_handle = other.m_handle;
+  m_release = other.m_release;
+  m_context = other.m_context;
+
+  other.m_text = std::string_view();
+  other.m_handle = nullptr;
+  other.m_release = nullptr;
+  other.m_context = nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// UTF-8 -> wchar_t
+// ---------------------------------------------------------------------------
+
+static const bool WIDE_IS_UTF16 = sizeof(wchar_t) == 2;
+
+size_t WidenInto(std::string_view utf8, wchar_t *out, size_t outCount) {
+  if (!out || outCount == 0)
+    return 0;
+
+  const unsigned char *s = (const unsigned char *)utf8.data();
+  size_t n = 0;
+  for (size_t i = 0; i < utf8.size();) {
+    unsigned cp = ScriptBuilder::detail::DecodeUtf8(s, utf8.size(), i);
+    if (WIDE_IS_UTF16 && cp > 0xFFFF) {
+      if (n + 2 >= outCount)
+        break;
+      cp -= 0x10000;
+      out[n++] = (wchar_t)(0xD800 + (cp >> 10));
+      out[n++] = (wchar_t)(0xDC00 + (cp & 0x3FF));
+    } else {
+      if (n + 1 >= outCount)
+        break;
+      out[n++] = (wchar_t)cp;
+    }
+  }
+  out[n] = L'\0';
+  return n;
+}
+
+std::wstring Widen(std::string_view utf8) {
+  // UTF-8 never has fewer bytes than UTF-16/32 has units
+  std::wstring out(utf8.size() + 1, L'\0');
+  size_t n = WidenInto(utf8, &out[0], out.size());
+  out.resize(n);
+  return out;
+}
+
+} // namespace ScriptResult
@@ -0,0 +1,94 @@
+/*****************************************************************************
+ * ScriptResult.h
+ *
+ * Zero-copy ExtendScript results
+ *
+ * Result keeps the AEGP result handle locked for its own lifetime and
+ * exposes the text as a std::string_view, so large results (effects list,
+ * fonts list) are never copied into fixed buffers or truncated.
+ *
+ * Records are read in place with WireFormat::Reader, and the Widen helpers
+ * transcode one field at a time (UTF-8 -> wchar_t, one pass).
+ *
+ * Platform-neutral: the handle release is injected, so the host side
+ * (AEGP MemorySuite) and a mock allocator can both back a Result.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace ScriptResult {
+
+/**
+ * Release callback: unlock + free the handle that backs a Result
+ * @param handle   Opaque handle (AEGP_MemHandle on the host)
+ * @param context  Opaque pointer given with the handle
+ */
+typedef void (*ReleaseFn)(void *handle, void *context);
+
+/**
+ * Script result text. Move-only; the view is valid while the Result lives.
+ */
+class Result {
+public:
+  Result() = default;
+
+  // Adopt a locked handle; data/size point into it
+  Result(const char *data, size_t size, bool succeeded, void *handle,
+         ReleaseFn release, void *context)
+      : m_text(data, size), m_succeeded(succeeded), m_handle(handle),
+        m_release(release), m_context(context) {}
+
+  // Own a copied string (batched results, errors)
+  static Result FromString(std::string text, bool succeeded);
+
+  ~Result() { Release(); }
+
+  Result(Result &&other) noexcept { MoveFrom(other); }
+  Result &operator=(Result &&other) noexcept {
+    if (this != &other) {
+      Release();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+  Result(const Result &) = delete;
+  Result &operator=(const Result &) = delete;
+
+  // True if the script ran without an error
+  bool Succeeded() const { return m_succeeded; }
+
+  // Result text ("" for failed scripts)
+  std::string_view View() const {
+    return m_succeeded ? m_text : std::string_view();
+  }
+
+  // Error text for failed scripts
+  std::string_view Error() const {
+    return m_succeeded ? std::string_view() : m_text;
+  }
+
+private:
+  void Release();
+  void MoveFrom(Result &other);
+
+  std::string_view m_text;
+  std::string m_owned; // FromString storage (m_text points here)
+  bool m_succeeded = false;
+  void *m_handle = nullptr;
+  ReleaseFn m_release = nullptr;
+  void *m_context = nullptr;
+};
+
+/**
+ * UTF-8 -> wchar_t (UTF-16 on Windows, UTF-32 elsewhere)
+ * WidenInto writes at most outCount-1 units plus a terminator and never
+ * splits a surrogate pair; returns the number of units written.
+ */
+size_t WidenInto(std::string_view utf8, wchar_t *out, size_t outCount);
+std::wstring Widen(std::string_view utf8);
+
+} // namespace ScriptResult
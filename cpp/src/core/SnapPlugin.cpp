@@ -7,6 +7,7 @@
 
 #include "SnapPlugin.h"
 #include "KeyboardMonitor.h"
+#include "Logger.h"
 #include "GridUI.h"
 #include "ControlUI.h"
 #include "KeyframeUI.h"
@@ -16,11 +17,32 @@
 #include "CompUI.h"
 #include "DMenuUI.h"
 #include "CEPBridge.h"
+#include "ScriptBatch.h"
+#include "ScriptLibrary.h"
+#include "ScriptResult.h"
+#include "CatalogCache.h"
+#include "ContextCache.h"
+#include "EffectEnumerator.h"
+#include "IdleScheduler.h"
+#include "InputEngine.h"
+#include "InputQueue.h"
+#include "IconAtlas.h"
+#include "ModuleRegistry.h"
+#include "PanelPrefetch.h"
+#include "Profiler.h"
+#include "Tracer.h"
+#include "FontCatalog.h"
+#include "WireFormat.h"
+#include <atomic>
 #include <chrono>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
+#include <filesystem>
+#include <memory>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #ifdef MSWindows
 #include <windows.h>
@@ -33,27 +55,18 @@
 #include "AE_Macros.h"
 
 // Global state
-static SnapPluginGlobals g_globals = {0, NULL, false, false, false};
+static SnapPluginGlobals g_globals = {0, NULL, false};
 static int g_mouseStartX = 0;
 static int g_mouseStartY = 0;
-static std::chrono::steady_clock::time_point g_keyPressTime;
-static bool g_waitingForHold = false;
-static const int HOLD_DELAY_MS = 400; // 0.4 seconds
-static const int DOUBLE_TAP_MS = 250; // Max time between double-tap
-static std::chrono::steady_clock::time_point g_lastYRelease;
-static bool g_toggleClickMode = false; // Toggle mode vs hold mode
 
 // Control module state
 static bool g_controlVisible = false;
-static bool g_eKeyWasHeld = false;
 
 // Keyframe module state (toggle mode via D→K or Right Shift+K)
 static bool g_keyframeVisible = false;
-static bool g_rshiftKWasHeld = false;  // For Right Shift+K trigger
 
 // D Menu state (D key shows menu, then A/T/K opens panels)
 static bool g_dMenuVisible = false;
-static bool g_dKeyWasHeld = false;
 
 // Align module state
 static bool g_alignVisible = false;
@@ -68,9 +81,6 @@ static const int MENU_HOOK_THRESHOLD_MS = 50;  // 50ms 이내에 호출됐으면
 static auto g_panelActivationTime = std::chrono::steady_clock::now();
 static const int PANEL_ACTIVATION_WINDOW_MS = 300;  // UpdateMenuHook 후 300ms간 키 입력 허용 (1000→300 변경)
 
-// Mouse click detection for panel activation (UpdateMenuHook doesn't fire on mouse clicks)
-static bool g_wasMouseButtonDown = false;
-
 // Cached AE main window handle for foreground check
 static HWND g_aeMainHwnd = NULL;
 
@@ -83,74 +93,94 @@ static bool g_shapeVisible = false;
 // Layer module state (D → C)
 static bool g_layerVisible = false;
 
-// Text editing mode detection (cached, updated periodically)
-static bool g_isTextLayerSelected = false;
-static auto g_lastTextLayerCheck = std::chrono::steady_clock::now();
+// Script library benchmark runs once on first idle (env-gated)
+static bool g_benchmarkChecked = false;
+
+// Forward declarations for script execution (defined later)
+// ExecuteScript is profiled per call site (function:line)
+static A_Err ExecuteScriptAt(const char *site, int line, const char *script);
+#define ExecuteScript(script) ExecuteScriptAt(__func__, __LINE__, script)
+static std::string QueryScript(const char *script);
+ScriptResult::Result RunScript(const char *script);
 
-// Forward declaration for ExecuteScript (defined later)
-A_Err ExecuteScript(const char *script, char *resultBuf = nullptr, size_t bufSize = 0);
+/*****************************************************************************
+ * RunLibraryCall
+ * Library call with its result read in place (RunScript, no copy).
+ * Installs the library and retries once if the namespace is missing.
+ *****************************************************************************/
+template <typename Tpl, typename... Args>
+static ScriptResult::Result RunLibraryCall(const Args &...args) {
+  std::string call = ScriptLibrary::BuildCallScript(
+      ScriptBuilder::Render<Tpl>(ScriptBuilder::DefaultArena(), args...));
+  ScriptResult::Result result = RunScript(call.c_str());
+  if (ScriptLibrary::IsMissing(result.View()) && ScriptLibrary::Install()) {
+    result = RunScript(call.c_str());
+  }
+  if (ScriptLibrary::IsMissing(result.View())) {
+    return ScriptResult::Result::FromString(std::string(), false);
+  }
+  return result;
+}
 
 /*****************************************************************************
  * LogToFile
- * Write debug messages to a log file in TEMP folder
+ * Debug message (general category) through the async Logger
  * Usage: LogToFile("message %d", value);
+ * The file (TEMP/AnchorSnap.aslog, binary) is written by the logger thread;
+ * decode it with tools/LogDecoder. DebugView still gets every line.
  *****************************************************************************/
-#ifdef MSWindows
-static FILE* g_logFile = nullptr;
-static bool g_logInitialized = false;
-
 void LogToFile(const char* format, ...) {
-    if (!g_logInitialized) {
-        g_logInitialized = true;
-        char path[MAX_PATH];
-        if (GetTempPathA(MAX_PATH, path)) {
-            strcat_s(path, MAX_PATH, "AnchorSnap.log");
-            fopen_s(&g_logFile, path, "a");
-            if (g_logFile) {
-                fprintf(g_logFile, "\n=== AnchorSnap Log Started ===\n");
-                fflush(g_logFile);
-            }
-        }
-    }
-    if (g_logFile) {
-        va_list args;
-        va_start(args, format);
-        vfprintf(g_logFile, format, args);
-        va_end(args);
-        fprintf(g_logFile, "\n");
-        fflush(g_logFile);
-    }
-    // Also output to DebugView
-    char buffer[1024];
-    va_list args2;
-    va_start(args2, format);
-    vsnprintf(buffer, sizeof(buffer), format, args2);
-    va_end(args2);
-    OutputDebugStringA(buffer);
+  if (!Logger::ShouldLog(Logger::CAT_GENERAL, Logger::LEVEL_INFO)) {
+    return;
+  }
+  char buffer[Logger::MAX_MESSAGE + 1];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length > 0) {
+    size_t size = (size_t)length < Logger::MAX_MESSAGE ? (size_t)length : Logger::MAX_MESSAGE;
+    Logger::LogText(Logger::CAT_GENERAL, Logger::LEVEL_INFO, std::string_view(buffer, size));
+  }
+}
+
+#ifdef MSWindows
+static void LogToDebugView(const char* line, void* context) {
+  (void)context;
+  OutputDebugStringA(line);
 }
+#endif
+
+/*****************************************************************************
+ * StartLogger
+ * Async logger into TEMP (levels: ANCHORSNAP_LOG="input=debug,*=warn")
+ *****************************************************************************/
+static void StartLogger() {
+  std::string path;
+#ifdef MSWindows
+  char temp[MAX_PATH];
+  if (GetTempPathA(MAX_PATH, temp)) {
+    path = std::string(temp) + "AnchorSnap.aslog";
+  }
+  Logger::SetDebugSink(LogToDebugView, nullptr);
 #else
-void LogToFile(const char* format, ...) { (void)format; }
+  const char* temp = getenv("TMPDIR");
+  path = std::string(temp ? temp : "/tmp") + "/AnchorSnap.aslog";
 #endif
+  Logger::ParseLevels(getenv("ANCHORSNAP_LOG"));
+  if (!path.empty()) {
+    Logger::Start(path);
+  }
+}
 
 #ifdef MSWindows
 /*****************************************************************************
  * IsEffectControlsFocused
  * Check if Effect Controls panel is the active/focused panel in AE
- * Uses ExtendScript to detect active panel type
+ * Reads the shared context snapshot (no script when it is current)
  *****************************************************************************/
 bool IsEffectControlsFocused() {
-  // Use ExtendScript to check activeViewer type
-  // Effect Controls is VIEWER_EFFECT_CONTROLS
-  char result[64] = {0};
-  ExecuteScript("(function(){"
-                "try{"
-                "var v=app.activeViewer;"
-                "if(v&&v.type==ViewerType.VIEWER_EFFECT_CONTROLS)return '1';"
-                "}catch(e){}"
-                "return '0';"
-                "})();",
-                result, sizeof(result));
-  return result[0] == '1';
+  return ContextCache::Get().viewer == ContextCache::VIEWER_EFFECT_CONTROLS;
 }
 
 /*****************************************************************************
@@ -158,19 +188,7 @@ bool IsEffectControlsFocused() {
  * Check if text tool (horizontal or vertical) is currently active
  * When text tool is active, user is likely editing text and D menu should not appear
  *****************************************************************************/
-bool IsTextToolActive() {
-  char result[32] = {0};
-  ExecuteScript(
-      "(function(){"
-      "try{"
-      "var t=app.project.toolType;"
-      "if(t===ToolType.Tool_TextH||t===ToolType.Tool_TextV)return '1';"
-      "}catch(e){}"
-      "return '0';"
-      "})();",
-      result, sizeof(result));
-  return result[0] == '1';
-}
+bool IsTextToolActive() { return ContextCache::Get().textTool; }
 
 /*****************************************************************************
  * OpenEffectControls
@@ -189,8 +207,7 @@ void OpenEffectControls() {
       // Open Effect Controls panel
       "app.executeCommand(2163);"
       "}catch(e){}"
-      "})();",
-      NULL, 0);
+      "})();");
 }
 
 // NOTE: FindEffectControlsWindow() 삭제됨 (2025-12-26)
@@ -199,81 +216,34 @@ void OpenEffectControls() {
 
 /*****************************************************************************
  * GetAllEffectsList
- * Get all available effects from AE (localized names)
- * Returns: "displayName|matchName|category;..."
+ * Get all available effects from AE (localized names, zero-copy result)
+ * Fallback for RebuildEffectsCatalog when the Effect Suite yields nothing
+ * Returns: wire records (WireFormat::EffectField, category in the 3rd field)
  *****************************************************************************/
 static bool g_effectsLoaded = false;
-void GetAllEffectsList(wchar_t* outBuffer, size_t bufSize) {
-  outBuffer[0] = L'\0';
-
-  // Use heap allocation to avoid stack overflow
-  char* resultBuf = new char[65536];
-  if (!resultBuf) return;
-  memset(resultBuf, 0, 65536);
-
-  // Inline script to get all effects (doesn't depend on CEP panel)
-  ExecuteScript(
-      "(function(){"
-      "try{"
-      "var r=[];"
-      "for(var i=0;i<app.effects.length;i++){"
-      "var e=app.effects[i];"
-      "if(e.category==='')continue;"
-      "r.push(e.displayName+'|'+e.matchName+'|'+e.category);"
-      "}"
-      "return r.join(';');"
-      "}catch(ex){return '';}"
-      "})();",
-      resultBuf, 65536);
-
-  if (resultBuf[0] != '\0' && strncmp(resultBuf, "Error", 5) != 0) {
-    MultiByteToWideChar(CP_UTF8, 0, resultBuf, -1, outBuffer, (int)bufSize);
-  }
-  delete[] resultBuf;
+ScriptResult::Result GetAllEffectsList() {
+  return RunLibraryCall<ScriptLibrary::EffectsListCall>();
 }
 
 /*****************************************************************************
  * GetLayerEffectsList
  * Get list of effects on selected layer for Mode 2
- * Returns: "name1|matchName1|0;name2|matchName2|1;..."
+ * Returns: wire records (WireFormat::EffectField, 0-based index in the 3rd field)
  *****************************************************************************/
-void GetLayerEffectsList(wchar_t* outBuffer, size_t bufSize) {
-  outBuffer[0] = L'\0';
-
-  char resultBuf[4096] = {0};
-  ExecuteScript(
-      "(function(){"
-      "var c=app.project.activeItem;"
-      "if(!c||!(c instanceof CompItem))return '';"
-      "if(c.selectedLayers.length==0)return '';"
-      "var L=c.selectedLayers[0];"
-      "var fx=L.Effects;"
-      "if(!fx||fx.numProperties==0)return '';"
-      "var arr=[];"
-      "for(var i=1;i<=fx.numProperties;i++){"
-      "var e=fx.property(i);"
-      "arr.push(e.name+'|'+e.matchName+'|'+(i-1));"
-      "}"
-      "return arr.join(';');"
-      "})();",
-      resultBuf, sizeof(resultBuf));
-
-  // Convert to wide string
-  if (resultBuf[0] != '\0') {
-    MultiByteToWideChar(CP_UTF8, 0, resultBuf, -1, outBuffer, (int)bufSize);
-  }
+ScriptResult::Result GetLayerEffectsList() {
+  return RunLibraryCall<ScriptLibrary::LayerEffectsCall>();
 }
 #else
 // macOS stub - TODO: implement
 bool IsEffectControlsFocused() { return false; }
 bool IsTextToolActive() { return false; }
 static bool g_effectsLoaded = false;
-void GetAllEffectsList(wchar_t* outBuffer, size_t bufSize) { outBuffer[0] = L'\0'; }
-void GetLayerEffectsList(wchar_t* outBuffer, size_t bufSize) { outBuffer[0] = L'\0'; }
+ScriptResult::Result GetAllEffectsList() { return ScriptResult::Result(); }
+ScriptResult::Result GetLayerEffectsList() { return ScriptResult::Result(); }
 void ApplyTextPropertyValue(const char* propName, float value) {}
 void ApplyTextColorValue(bool stroke, float r, float g, float b) {}
 void ApplyTextJustificationValue(int just) {}
-void GetFontsList(wchar_t* outBuffer, size_t bufSize) { outBuffer[0] = L'\0'; }
+ScriptResult::Result GetFontsList() { return ScriptResult::Result(); }
 void ApplyTextFont(const char* postScriptName) {}
 // Shape module stubs
 void ApplyShapePropertyValue(const char* propName, float value) {}
@@ -283,30 +253,388 @@ void ApplyShapeAnchorValue(float x, float y) {}
 void AddShapePathOperation(int opType) {}
 #endif
 
+/*****************************************************************************
+ * GetCacheFilePath
+ * Cache files live next to CEP's settings.json (cross-platform)
+ *****************************************************************************/
+static std::filesystem::path GetCacheFilePath(const char *fileName) {
+#ifdef MSWindows
+  // Windows: %APPDATA%\Adobe\CEP\extensions\com.anchor.snap\<fileName>
+  const wchar_t *appdata = _wgetenv(L"APPDATA");
+  if (!appdata)
+    return std::filesystem::path();
+  std::filesystem::path dir(appdata);
+#else
+  // macOS: ~/Library/Application Support/Adobe/CEP/extensions/com.anchor.snap/<fileName>
+  const char *home = getenv("HOME");
+  if (!home)
+    return std::filesystem::path();
+  std::filesystem::path dir(home);
+  dir /= "Library";
+  dir /= "Application Support";
+#endif
+  return dir / "Adobe" / "CEP" / "extensions" / "com.anchor.snap" / fileName;
+}
+
+/*****************************************************************************
+ * Effects catalog cache
+ * The parsed effects list is kept in a mapped binary file (CatalogCache),
+ * keyed by AE build + UI language. A warm start maps the file instead of
+ * enumerating the installed effects; the plug-in folders are then hashed
+ * on a worker thread and the cache is rebuilt only if they changed.
+ *****************************************************************************/
+static const char *EFFECTS_CACHE_FILE = "effects-catalog.bin";
+
+struct FolderHashJob {
+  std::vector<std::string> folders;
+  uint64_t fingerprint = 0;
+  std::atomic<bool> done{false};
+};
+
+static CatalogCache::Catalog g_effectsCatalog;
+static CatalogCache::Key g_effectsKey;
+static bool g_effectsFromDisk = false;
+static std::shared_ptr<FolderHashJob> g_effectsRevalidation;
+
+// Cache key from hostInfo(); plug-in folders are returned for hashing
+static bool ReadHostKey(CatalogCache::Key &key,
+                        std::vector<std::string> &folders) {
+  std::string info = ScriptLibrary::Call<ScriptLibrary::HostInfoCall>();
+  WireFormat::Reader reader(info);
+  if (!reader.Next())
+    return false;
+  key.hostBuild = std::string(reader.String(WireFormat::HOST_BUILD));
+  key.language = std::string(reader.String(WireFormat::HOST_LANGUAGE));
+  for (size_t i = WireFormat::HOST_PLUGIN_FOLDER; i < reader.FieldCount(); i++) {
+    folders.emplace_back(reader.String(i));
+  }
+  return !key.hostBuild.empty();
+}
+
+/*****************************************************************************
+ * EnumerateEffects
+ * Installed effects straight from the AEGP Effect Suite (no ExtendScript).
+ * Each name is converted once (UTF-8, or the ANSI code page when it is not
+ * valid UTF-8) into the ControlUI item. The catalog is only the cache-file
+ * format for warm starts: it interns the same UTF-16 text (Windows) or the
+ * Effect Suite's UTF-8 (macOS), and the list is never decoded back out of it.
+ *****************************************************************************/
+static_assert(AEGP_MAX_EFFECT_NAME_SIZE <= sizeof(ControlUI::EffectItem::name) / sizeof(wchar_t) &&
+                  AEGP_MAX_EFFECT_MATCH_NAME_SIZE <=
+                      sizeof(ControlUI::EffectItem::matchName) / sizeof(wchar_t) &&
+                  AEGP_MAX_EFFECT_CATEGORY_NAME_SIZE <=
+                      sizeof(ControlUI::EffectItem::category) / sizeof(wchar_t),
+              "Effect Suite names must fit the ControlUI item fields");
+
+template <size_t N>
+static std::wstring_view WidenEffectText(const A_char *text, wchar_t (&out)[N]) {
+#ifdef MSWindows
+  UINT codePage = EffectEnumerator::IsUtf8(text) ? CP_UTF8 : CP_ACP;
+  int n = MultiByteToWideChar(codePage, 0, text, -1, out, (int)N);
+  if (n <= 0) {
+    out[0] = L'\0';
+    n = 1;
+  }
+  return std::wstring_view(out, (size_t)n - 1);
+#else
+  return std::wstring_view(out, ScriptResult::WidenInto(text, out, N));
+#endif
+}
+
+static size_t EnumerateEffects(AEGP_SuiteHandler &suites,
+                               std::vector<ControlUI::EffectItem> &items,
+                               CatalogCache::Builder &builder) {
+  AEGP_EffectSuite4 *effects = suites.EffectSuite4();
+  A_long count = 0;
+  if (effects->AEGP_GetNumInstalledEffects(&count) != A_Err_NONE) {
+    return 0;
+  }
+  items.reserve((size_t)count);
+
+  AEGP_InstalledEffectKey key = AEGP_InstalledEffectKey_NONE;
+  A_char name[AEGP_MAX_EFFECT_NAME_SIZE];
+  A_char matchName[AEGP_MAX_EFFECT_MATCH_NAME_SIZE];
+  A_char category[AEGP_MAX_EFFECT_CATEGORY_NAME_SIZE];
+  for (A_long i = 0; i < count; i++) {
+    if (effects->AEGP_GetNextInstalledEffect(key, &key) != A_Err_NONE ||
+        key == AEGP_InstalledEffectKey_NONE) {
+      break;
+    }
+    name[0] = matchName[0] = category[0] = '\0';
+    effects->AEGP_GetEffectCategory(key, category);
+    if (category[0] == '\0') {
+      continue; // Hidden (not listed, like effectsList())
+    }
+    effects->AEGP_GetEffectName(key, name);
+    effects->AEGP_GetEffectMatchName(key, matchName);
+
+    items.emplace_back();
+    ControlUI::EffectItem &item = items.back();
+    std::wstring_view wideName = WidenEffectText(name, item.name);
+    std::wstring_view wideMatchName = WidenEffectText(matchName, item.matchName);
+    std::wstring_view wideCategory = WidenEffectText(category, item.category);
+    item.index = (int)items.size() - 1;
+    item.isLayerEffect = false;
+
+#ifdef MSWindows
+    // wchar_t is UTF-16 here: the catalog copies the item text as is
+    std::u16string_view fields[WireFormat::EFFECT_FIELD_COUNT];
+    fields[WireFormat::EFFECT_NAME] = std::u16string_view(
+        reinterpret_cast<const char16_t *>(wideName.data()), wideName.size());
+    fields[WireFormat::EFFECT_MATCH_NAME] = std::u16string_view(
+        reinterpret_cast<const char16_t *>(wideMatchName.data()), wideMatchName.size());
+    fields[WireFormat::EFFECT_CATEGORY_OR_INDEX] = std::u16string_view(
+        reinterpret_cast<const char16_t *>(wideCategory.data()), wideCategory.size());
+#else
+    (void)wideName;
+    (void)wideMatchName;
+    (void)wideCategory;
+    std::string_view fields[WireFormat::EFFECT_FIELD_COUNT];
+    fields[WireFormat::EFFECT_NAME] = name;
+    fields[WireFormat::EFFECT_MATCH_NAME] = matchName;
+    fields[WireFormat::EFFECT_CATEGORY_OR_INDEX] = category;
+#endif
+    builder.AddRecord(fields);
+  }
+  return items.size();
+}
+
+// Build the effects list from the Effect Suite (effectsList() script as
+// fallback), hand it to ControlUI and keep the catalog for the cache file
+static bool RebuildEffectsCatalog() {
+  CatalogCache::Builder builder(WireFormat::EFFECT_FIELD_COUNT);
+  std::vector<ControlUI::EffectItem> items;
+  try {
+    AEGP_SuiteHandler suites(g_globals.pica_basicP);
+    EnumerateEffects(suites, items, builder);
+  } catch (...) {
+    items.clear();
+  }
+  if (items.empty()) {
+    builder = CatalogCache::Builder(WireFormat::EFFECT_FIELD_COUNT);
+    ScriptResult::Result list = GetAllEffectsList();
+    if (builder.AddFromWire(list.View()) == 0)
+      return false;
+  }
+  g_effectsFromDisk = false;
+  if (!g_effectsCatalog.Adopt(builder.Finish(g_effectsKey)))
+    return false;
+  if (items.empty()) {
+    ControlUI::SetAvailableEffects(g_effectsCatalog); // Script result
+  } else {
+    ControlUI::SetAvailableEffects(std::move(items));
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * LoadEffectsCatalog
+ * First idle: map the cache (warm) or enumerate effects (cold), hand the
+ * catalog to ControlUI and start the background revalidation
+ *****************************************************************************/
+static bool LoadEffectsCatalog() {
+  std::vector<std::string> folders;
+  bool keyed = ReadHostKey(g_effectsKey, folders);
+
+  g_effectsFromDisk = keyed &&
+                      g_effectsCatalog.Open(GetCacheFilePath(EFFECTS_CACHE_FILE)) &&
+                      g_effectsCatalog.Matches(g_effectsKey, false) &&
+                      g_effectsCatalog.RecordCount() > 0;
+  if (g_effectsFromDisk) {
+    ControlUI::SetAvailableEffects(g_effectsCatalog);
+  } else if (!RebuildEffectsCatalog()) {
+    return false;
+  }
+
+  if (keyed) {
+    // Hash the plug-in folders off the main thread (polled from IdleHook)
+    std::shared_ptr<FolderHashJob> job = std::make_shared<FolderHashJob>();
+    job->folders = std::move(folders);
+    g_effectsRevalidation = job;
+    std::thread([job]() {
+      Tracer::SetThreadName("folder hash");
+      TRACE_SCOPE("catalog", "HashFolderListing");
+      job->fingerprint = CatalogCache::HashFolderListing(job->folders);
+      job->done = true;
+    }).detach();
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * PollEffectsRevalidation
+ * Finish a completed folder hash: keep a valid cache, rebuild a stale one
+ * (script runs on the main thread) and write the cache file
+ *****************************************************************************/
+static void PollEffectsRevalidation() {
+  if (!g_effectsRevalidation || !g_effectsRevalidation->done) {
+    return;
+  }
+  g_effectsKey.fingerprint = g_effectsRevalidation->fingerprint;
+  g_effectsRevalidation.reset();
+
+  if (g_effectsFromDisk) {
+    if (g_effectsCatalog.Matches(g_effectsKey, true)) {
+      return; // Plug-ins unchanged: cache is current
+    }
+    // Plug-ins changed since the cache was written
+    if (!RebuildEffectsCatalog()) {
+      return;
+    }
+  }
+
+  g_effectsCatalog.SetKey(g_effectsKey);
+  CatalogCache::WriteFile(GetCacheFilePath(EFFECTS_CACHE_FILE),
+                          g_effectsCatalog.Data(), g_effectsCatalog.Size());
+}
+
+/*****************************************************************************
+ * Font catalog cache
+ * Same mapped-file scheme as the effects catalog (see FontCatalog.h).
+ * A warm start maps fonts-catalog.bin; a later idle tick compares the
+ * installed font families with the cache and refetches only the families
+ * that were added or changed.
+ *****************************************************************************/
+static const char *FONTS_CACHE_FILE = "fonts-catalog.bin";
+
+ScriptResult::Result GetFontsList();
+
+static CatalogCache::Catalog g_fontsCatalog;
+static CatalogCache::Key g_fontsKey;
+static bool g_fontsKeyed = false;        // hostInfo() succeeded (cache usable)
+static bool g_fontsCatalogLoaded = false; // Load attempted on idle
+static bool g_fontsRevalidated = false;
+
+// Run fontsList() and adopt the result (fingerprint from its records)
+static bool RebuildFontsCatalog() {
+  ScriptResult::Result list = GetFontsList();
+  CatalogCache::Builder builder(WireFormat::FONT_FIELD_COUNT);
+  if (builder.AddFromWire(list.View()) == 0 ||
+      !g_fontsCatalog.Adopt(builder.Finish(g_fontsKey))) {
+    return false;
+  }
+  g_fontsKey.fingerprint = FontCatalog::Fingerprint(g_fontsCatalog);
+  g_fontsCatalog.SetKey(g_fontsKey);
+  return true;
+}
+
+static void SaveFontsCatalog() {
+  if (g_fontsKeyed) {
+    CatalogCache::WriteFile(GetCacheFilePath(FONTS_CACHE_FILE),
+                            g_fontsCatalog.Data(), g_fontsCatalog.Size());
+  }
+}
+
+/*****************************************************************************
+ * LoadFontCatalog
+ * Map the cache (warm) or run fontsList() (cold) and hand the catalog to
+ * TextUI. Runs on an early idle tick; TextUI calls it if the font dropdown
+ * opens before that.
+ *****************************************************************************/
+bool LoadFontCatalog() {
+  g_fontsCatalogLoaded = true;
+  std::vector<std::string> folders; // Unused (fonts are fingerprinted by family)
+  g_fontsKeyed = ReadHostKey(g_fontsKey, folders);
+
+  bool warm = g_fontsKeyed &&
+              g_fontsCatalog.Open(GetCacheFilePath(FONTS_CACHE_FILE)) &&
+              g_fontsCatalog.Matches(g_fontsKey, false) &&
+              g_fontsCatalog.RecordCount() > 0;
+  if (!warm) {
+    if (!RebuildFontsCatalog()) {
+      return false;
+    }
+    SaveFontsCatalog();
+    g_fontsRevalidated = true; // Fresh list
+  }
+  TextUI::SetFonts(g_fontsCatalog);
+  return true;
+}
+
+/*****************************************************************************
+ * RevalidateFontCatalog
+ * Once per session after a warm start: compare fontFamilies() with the
+ * cached fingerprint; refetch changed families with fontsOf() and merge
+ *****************************************************************************/
+static void RevalidateFontCatalog() {
+  g_fontsRevalidated = true;
+  ScriptResult::Result families =
+      RunLibraryCall<ScriptLibrary::FontFamiliesCall>();
+  if (families.View().empty()) {
+    return;
+  }
+  g_fontsKey.fingerprint = FontCatalog::FingerprintFamilies(families.View());
+  if (g_fontsCatalog.Matches(g_fontsKey, true)) {
+    return; // Fonts unchanged: cache is current
+  }
+
+  FontCatalog::Diff diff = FontCatalog::Compare(g_fontsCatalog, families.View());
+  if (diff.changed * 2 > diff.families) {
+    // Mostly new fonts: one fontsList() beats fetching most families by name
+    if (!RebuildFontsCatalog()) {
+      return;
+    }
+  } else {
+    ScriptResult::Result changed;
+    if (diff.changed > 0) {
+      changed = RunLibraryCall<ScriptLibrary::FontsOfCall>(
+          std::string_view(diff.changedWire));
+    }
+    std::vector<uint8_t> image = FontCatalog::Merge(
+        g_fontsCatalog, families.View(), changed.View(), g_fontsKey);
+    if (!g_fontsCatalog.Adopt(std::move(image))) {
+      return;
+    }
+  }
+  Logger::Log(Logger::CAT_CATALOG, Logger::LEVEL_INFO,
+              "Font catalog: %zu changed, %zu removed of %zu families",
+              diff.changed, diff.removed, diff.families);
+  TextUI::SetFonts(g_fontsCatalog);
+  SaveFontsCatalog();
+}
+
+/*****************************************************************************
+ * Text / Shape script templates
+ * Slot values are typed and escaped by ScriptBuilder (no fixed buffers)
+ *****************************************************************************/
+#ifdef MSWindows
+// Run "assign" on the TextDocument of every selected text layer
+#define TEXT_DOC_SCRIPT(assign)                                              \
+  "(function(){"                                                             \
+  "try{"                                                                     \
+  "var c=app.project.activeItem;"                                            \
+  "if(!c||!(c instanceof CompItem))return;"                                  \
+  "var sel=c.selectedLayers;"                                                \
+  "for(var i=0;i<sel.length;i++){"                                           \
+  "if(!(sel[i] instanceof TextLayer))continue;"                              \
+  "var txt=sel[i].text.sourceText;"                                          \
+  "var doc=txt.value;" assign "txt.setValue(doc);"                           \
+  "}"                                                                        \
+  "}catch(e){}"                                                              \
+  "})();"
+
+SCRIPT_TEMPLATE(TextPropertyScript, TEXT_DOC_SCRIPT("doc[${s}]=${f};"));
+SCRIPT_TEMPLATE(TextColorScript, TEXT_DOC_SCRIPT("doc[${s}]=[${f},${f},${f}];"));
+SCRIPT_TEMPLATE(TextJustificationScript,
+                TEXT_DOC_SCRIPT("doc.justification=ParagraphJustification[${s}];"));
+SCRIPT_TEMPLATE(TextFontScript, TEXT_DOC_SCRIPT("doc.font=${s};"));
+
+#undef TEXT_DOC_SCRIPT
+
+SCRIPT_TEMPLATE(ShapePropertyScript, "setShapePropertyValue(${s},${f})");
+SCRIPT_TEMPLATE(ShapeStrokeColorScript, "setShapeStrokeColor(${f},${f},${f})");
+SCRIPT_TEMPLATE(ShapeFillColorScript, "setShapeFillColor(${f},${f},${f})");
+SCRIPT_TEMPLATE(ShapeSizeScript, "setShapeSize(${f},${f})");
+SCRIPT_TEMPLATE(ShapeAnchorScript, "setShapeAnchor(${f},${f})");
+SCRIPT_TEMPLATE(ShapePathOperationScript, "addShapePathOperation(${i})");
+
 /*****************************************************************************
  * ApplyTextPropertyValue
  * Apply a single text property to the selected text layer
  *****************************************************************************/
-#ifdef MSWindows
 void ApplyTextPropertyValue(const char* propName, float value) {
-  char script[512];
-  snprintf(script, sizeof(script),
-    "(function(){"
-    "try{"
-    "var c=app.project.activeItem;"
-    "if(!c||!(c instanceof CompItem))return;"
-    "var sel=c.selectedLayers;"
-    "for(var i=0;i<sel.length;i++){"
-    "if(!(sel[i] instanceof TextLayer))continue;"
-    "var txt=sel[i].text.sourceText;"
-    "var doc=txt.value;"
-    "doc.%s=%f;"
-    "txt.setValue(doc);"
-    "}"
-    "}catch(e){}"
-    "})();",
-    propName, value);
-  ExecuteScript(script);
+  ExecuteScript(ScriptBuilder::Render<TextPropertyScript>(
+      ScriptBuilder::DefaultArena(), propName, value));
 }
 
 /*****************************************************************************
@@ -314,24 +642,9 @@ void ApplyTextPropertyValue(const char* propName, float value) {
  * Apply fill or stroke color to the selected text layer
  *****************************************************************************/
 void ApplyTextColorValue(bool stroke, float r, float g, float b) {
-  char script[512];
-  snprintf(script, sizeof(script),
-    "(function(){"
-    "try{"
-    "var c=app.project.activeItem;"
-    "if(!c||!(c instanceof CompItem))return;"
-    "var sel=c.selectedLayers;"
-    "for(var i=0;i<sel.length;i++){"
-    "if(!(sel[i] instanceof TextLayer))continue;"
-    "var txt=sel[i].text.sourceText;"
-    "var doc=txt.value;"
-    "doc.%sColor=[%f,%f,%f];"
-    "txt.setValue(doc);"
-    "}"
-    "}catch(e){}"
-    "})();",
-    stroke ? "stroke" : "fill", r, g, b);
-  ExecuteScript(script);
+  ExecuteScript(ScriptBuilder::Render<TextColorScript>(
+      ScriptBuilder::DefaultArena(), stroke ? "strokeColor" : "fillColor", r,
+      g, b));
 }
 
 /*****************************************************************************
@@ -340,71 +653,27 @@ void ApplyTextColorValue(bool stroke, float r, float g, float b) {
  *****************************************************************************/
 void ApplyTextJustificationValue(int just) {
   const char* justNames[] = {
-    "ParagraphJustification.LEFT_JUSTIFY",
-    "ParagraphJustification.CENTER_JUSTIFY",
-    "ParagraphJustification.RIGHT_JUSTIFY",
-    "ParagraphJustification.FULL_JUSTIFY_LASTLINE_LEFT",
-    "ParagraphJustification.FULL_JUSTIFY_LASTLINE_CENTER",
-    "ParagraphJustification.FULL_JUSTIFY_LASTLINE_RIGHT",
-    "ParagraphJustification.FULL_JUSTIFY_LASTLINE_FULL"
+    "LEFT_JUSTIFY",
+    "CENTER_JUSTIFY",
+    "RIGHT_JUSTIFY",
+    "FULL_JUSTIFY_LASTLINE_LEFT",
+    "FULL_JUSTIFY_LASTLINE_CENTER",
+    "FULL_JUSTIFY_LASTLINE_RIGHT",
+    "FULL_JUSTIFY_LASTLINE_FULL"
   };
   if (just < 0 || just > 6) just = 0;
 
-  char script[512];
-  snprintf(script, sizeof(script),
-    "(function(){"
-    "try{"
-    "var c=app.project.activeItem;"
-    "if(!c||!(c instanceof CompItem))return;"
-    "var sel=c.selectedLayers;"
-    "for(var i=0;i<sel.length;i++){"
-    "if(!(sel[i] instanceof TextLayer))continue;"
-    "var txt=sel[i].text.sourceText;"
-    "var doc=txt.value;"
-    "doc.justification=%s;"
-    "txt.setValue(doc);"
-    "}"
-    "}catch(e){}"
-    "})();",
-    justNames[just]);
-  ExecuteScript(script);
+  ExecuteScript(ScriptBuilder::Render<TextJustificationScript>(
+      ScriptBuilder::DefaultArena(), justNames[just]));
 }
 
 /*****************************************************************************
  * GetFontsList
- * Get list of all available fonts from AE
- * Returns: "familyName|styleName|postScriptName;..."
+ * Get list of all available fonts from AE (zero-copy result)
+ * Returns: wire records (WireFormat::FontField)
  *****************************************************************************/
-void GetFontsList(wchar_t* outBuffer, size_t bufSize) {
-  outBuffer[0] = L'\0';
-
-  // Use heap allocation to avoid stack overflow
-  char* resultBuf = new char[131072];  // 128KB for fonts
-  if (!resultBuf) return;
-  memset(resultBuf, 0, 131072);
-
-  ExecuteScript(
-      "(function(){"
-      "try{"
-      "var fonts=app.fonts.allFonts;"
-      "var r=[];"
-      "for(var i=0;i<fonts.length;i++){"
-      "var fam=fonts[i];"
-      "for(var j=0;j<fam.length;j++){"
-      "var f=fam[j];"
-      "if(f.isSubstitute)continue;"
-      "r.push(f.familyName+'|'+f.styleName+'|'+f.postScriptName);"
-      "}"
-      "}"
-      "return r.join(';');"
-      "}catch(e){return '';}"
-      "})();",
-      resultBuf, 131072);
-
-  if (resultBuf[0] != '\0' && strncmp(resultBuf, "Error", 5) != 0) {
-    MultiByteToWideChar(CP_UTF8, 0, resultBuf, -1, outBuffer, (int)bufSize);
-  }
-  delete[] resultBuf;
+ScriptResult::Result GetFontsList() {
+  return RunLibraryCall<ScriptLibrary::FontsListCall>();
 }
 
 /*****************************************************************************
@@ -412,24 +681,8 @@ void GetFontsList(wchar_t* outBuffer, size_t bufSize) {
  * Apply a font to the selected text layer by PostScript name
  *****************************************************************************/
 void ApplyTextFont(const char* postScriptName) {
-  char script[1024];
-  snprintf(script, sizeof(script),
-    "(function(){"
-    "try{"
-    "var c=app.project.activeItem;"
-    "if(!c||!(c instanceof CompItem))return;"
-    "var sel=c.selectedLayers;"
-    "for(var i=0;i<sel.length;i++){"
-    "if(!(sel[i] instanceof TextLayer))continue;"
-    "var txt=sel[i].text.sourceText;"
-    "var doc=txt.value;"
-    "doc.font='%s';"
-    "txt.setValue(doc);"
-    "}"
-    "}catch(e){}"
-    "})();",
-    postScriptName);
-  ExecuteScript(script);
+  ExecuteScript(ScriptBuilder::Render<TextFontScript>(
+      ScriptBuilder::DefaultArena(), postScriptName));
 }
 
 /*****************************************************************************
@@ -437,37 +690,33 @@ void ApplyTextFont(const char* postScriptName) {
  *****************************************************************************/
 
 void ApplyShapePropertyValue(const char* propName, float value) {
-  char script[256];
-  snprintf(script, sizeof(script), "setShapePropertyValue('%s', %f)", propName, value);
-  ExecuteScript(script);
+  ExecuteScript(ScriptBuilder::Render<ShapePropertyScript>(
+      ScriptBuilder::DefaultArena(), propName, value));
 }
 
 void ApplyShapeColorValue(bool stroke, float r, float g, float b) {
-  char script[256];
   if (stroke) {
-    snprintf(script, sizeof(script), "setShapeStrokeColor(%f, %f, %f)", r, g, b);
+    ExecuteScript(ScriptBuilder::Render<ShapeStrokeColorScript>(
+        ScriptBuilder::DefaultArena(), r, g, b));
   } else {
-    snprintf(script, sizeof(script), "setShapeFillColor(%f, %f, %f)", r, g, b);
+    ExecuteScript(ScriptBuilder::Render<ShapeFillColorScript>(
+        ScriptBuilder::DefaultArena(), r, g, b));
   }
-  ExecuteScript(script);
 }
 
 void ApplyShapeSizeValue(float w, float h) {
-  char script[256];
-  snprintf(script, sizeof(script), "setShapeSize(%f, %f)", w, h);
-  ExecuteScript(script);
+  ExecuteScript(ScriptBuilder::Render<ShapeSizeScript>(
+      ScriptBuilder::DefaultArena(), w, h));
 }
 
 void ApplyShapeAnchorValue(float x, float y) {
-  char script[256];
-  snprintf(script, sizeof(script), "setShapeAnchor(%f, %f)", x, y);
-  ExecuteScript(script);
+  ExecuteScript(ScriptBuilder::Render<ShapeAnchorScript>(
+      ScriptBuilder::DefaultArena(), x, y));
 }
 
 void AddShapePathOperation(int opType) {
-  char script[256];
-  snprintf(script, sizeof(script), "addShapePathOperation(%d)", opType);
-  ExecuteScript(script);
+  ExecuteScript(ScriptBuilder::Render<ShapePathOperationScript>(
+      ScriptBuilder::DefaultArena(), opType));
 }
 #endif
 
@@ -512,12 +761,16 @@ void AEGP_SuiteHandler::MissingSuiteError() const {
 }
 
 /*****************************************************************************
- * ExecuteScript
- * Execute ExtendScript using AEGP_ExecuteScript, returns result string
+ * RunHostScript
+ * ScriptBatch runner: one AEGP_ExecuteScript round-trip
  *****************************************************************************/
-A_Err ExecuteScript(const char *script, char *resultBuf,
-                    size_t bufSize) {
-  A_Err err = A_Err_NONE;
+static bool RunHostScript(const char *script, std::string &result,
+                          void *context) {
+  (void)context;
+  PROFILE_SCOPE("script.host");
+  Tracer::Scope trace("script", "script.host");
+  trace.Arg("bytesIn", (int64_t)strlen(script));
+  bool ok = false;
 
   try {
     AEGP_SuiteHandler suites(g_globals.pica_basicP);
@@ -525,73 +778,208 @@ A_Err ExecuteScript(const char *script, char *resultBuf,
     AEGP_MemHandle resultH = NULL;
     AEGP_MemHandle errorH = NULL;
 
-    err = suites.UtilitySuite6()->AEGP_ExecuteScript(
+    A_Err err = suites.UtilitySuite6()->AEGP_ExecuteScript(
         g_globals.plugin_id, script, TRUE, &resultH, &errorH);
+    ok = (err == A_Err_NONE);
 
-    // Get result if requested
-    if (resultBuf && bufSize > 0 && resultH) {
+    if (resultH) {
       A_char *resultStr = NULL;
       suites.MemorySuite1()->AEGP_LockMemHandle(resultH, (void **)&resultStr);
       if (resultStr) {
-        strncpy(resultBuf, resultStr, bufSize - 1);
-        resultBuf[bufSize - 1] = '\0';
+        result.assign(resultStr);
       }
       suites.MemorySuite1()->AEGP_UnlockMemHandle(resultH);
+      suites.MemorySuite1()->AEGP_FreeMemHandle(resultH);
     }
 
-    if (resultH) {
-      suites.MemorySuite1()->AEGP_FreeMemHandle(resultH);
+    if (errorH) {
+      A_char *errorStr = NULL;
+      suites.MemorySuite1()->AEGP_LockMemHandle(errorH, (void **)&errorStr);
+      if (errorStr && errorStr[0] != '\0') {
+        ok = false;
+        if (result.empty()) {
+          result.assign(errorStr);
+        }
+      }
+      suites.MemorySuite1()->AEGP_UnlockMemHandle(errorH);
+      suites.MemorySuite1()->AEGP_FreeMemHandle(errorH);
+    }
+
+  } catch (...) {
+    ok = false;
+  }
+
+  trace.Arg("bytesOut", (int64_t)result.size());
+  return ok;
+}
+
+// IdleHook tick depth: while > 0, fire-and-forget scripts are deferred and
+// sent together with the other calls of the tick
+static int g_scriptTickDepth = 0;
+
+// Flushes the pending script batch when the IdleHook tick ends (any return)
+struct ScriptTickScope {
+  ScriptTickScope() { g_scriptTickDepth++; }
+  ~ScriptTickScope() {
+    if (--g_scriptTickDepth == 0) {
+      ScriptBatch::Flush();
     }
+  }
+};
+
+/*****************************************************************************
+ * ExecuteScript
+ * Fire-and-forget ExtendScript through the per-tick batch
+ * Queued and sent with the next flush (in call order); flushed right away
+ * when called outside an IdleHook tick.
+ *****************************************************************************/
+static A_Err ExecuteScriptAt(const char *site, int line, const char *script) {
+  Profiler::Scope scope(site, line);
+  Tracer::Scope trace("script", "ExecuteScript");
+  trace.Arg("site", site);
+  trace.Arg("line", line);
+  trace.Arg("bytesIn", (int64_t)strlen(script));
+  // Fire-and-forget scripts edit the project: the selection may change
+  ContextCache::Invalidate();
+  ScriptBatch::Enqueue(site, script);
+  if (g_scriptTickDepth == 0) {
+    ScriptBatch::Flush();
+  }
+  return A_Err_NONE;
+}
+
+/*****************************************************************************
+ * QueryScript
+ * Short result (flags, counts) through the per-tick batch
+ * Flushes everything queued so far plus this call.
+ *****************************************************************************/
+static std::string QueryScript(const char *script) {
+  Tracer::Scope trace("script", "QueryScript");
+  trace.Arg("bytesIn", (int64_t)strlen(script));
+  std::string result = ScriptBatch::Enqueue("QueryScript", script).Get();
+  trace.Arg("bytesOut", (int64_t)result.size());
+  return result;
+}
+
+/*****************************************************************************
+ * RunScript
+ * Large result as a view over the locked AEGP result handle (no copy,
+ * no size limit). Pending batched calls run first to keep the call order;
+ * the handle is unlocked and freed when the Result is destroyed.
+ *****************************************************************************/
+static void ReleaseResultHandle(void *handle, void *context) {
+  (void)context;
+  try {
+    AEGP_SuiteHandler suites(g_globals.pica_basicP);
+    AEGP_MemHandle memH = static_cast<AEGP_MemHandle>(handle);
+    suites.MemorySuite1()->AEGP_UnlockMemHandle(memH);
+    suites.MemorySuite1()->AEGP_FreeMemHandle(memH);
+  } catch (...) {
+  }
+}
+
+ScriptResult::Result RunScript(const char *script) {
+  ScriptBatch::Flush();
+  PROFILE_SCOPE("script.run");
+  Tracer::Scope trace("script", "RunScript");
+  trace.Arg("bytesIn", (int64_t)strlen(script));
+
+  try {
+    AEGP_SuiteHandler suites(g_globals.pica_basicP);
+
+    AEGP_MemHandle resultH = NULL;
+    AEGP_MemHandle errorH = NULL;
+    A_Err err = suites.UtilitySuite6()->AEGP_ExecuteScript(
+        g_globals.plugin_id, script, TRUE, &resultH, &errorH);
+
+    std::string errorText;
     if (errorH) {
+      A_char *errorStr = NULL;
+      suites.MemorySuite1()->AEGP_LockMemHandle(errorH, (void **)&errorStr);
+      if (errorStr) {
+        errorText.assign(errorStr);
+      }
+      suites.MemorySuite1()->AEGP_UnlockMemHandle(errorH);
       suites.MemorySuite1()->AEGP_FreeMemHandle(errorH);
     }
 
+    if (err != A_Err_NONE || !errorText.empty()) {
+      if (resultH) {
+        suites.MemorySuite1()->AEGP_FreeMemHandle(resultH);
+      }
+      return ScriptResult::Result::FromString(errorText, false);
+    }
+    if (!resultH) {
+      return ScriptResult::Result::FromString(std::string(), true);
+    }
+
+    A_char *resultStr = NULL;
+    AEGP_MemSize size = 0;
+    suites.MemorySuite1()->AEGP_GetMemHandleSize(resultH, &size);
+    suites.MemorySuite1()->AEGP_LockMemHandle(resultH, (void **)&resultStr);
+    if (!resultStr) {
+      suites.MemorySuite1()->AEGP_FreeMemHandle(resultH);
+      return ScriptResult::Result::FromString(std::string(), false);
+    }
+    // The handle holds a null-terminated string; never read past its size
+    size_t length = strnlen(resultStr, (size_t)size);
+    trace.Arg("bytesOut", (int64_t)length);
+    return ScriptResult::Result(resultStr, length, true, resultH,
+                                ReleaseResultHandle, nullptr);
   } catch (...) {
-    err = A_Err_GENERIC;
+    return ScriptResult::Result::FromString(std::string(), false);
   }
+}
 
-  return err;
+/*****************************************************************************
+ * QuerySelectionContext
+ * ContextCache host query: selectionContext() read in place
+ *****************************************************************************/
+static bool QuerySelectionContext(std::string &wire, void *context) {
+  (void)context;
+  ScriptResult::Result result =
+      RunLibraryCall<ScriptLibrary::SelectionContextCall>();
+  wire.assign(result.View());
+  return result.Succeeded() && !wire.empty();
+}
+
+/*****************************************************************************
+ * QueryPanelSnapshot
+ * PanelPrefetch host query: panelSnapshot() (copied, the menu outlives it)
+ *****************************************************************************/
+static bool QueryPanelSnapshot(std::string &wire, void *context) {
+  (void)context;
+  ScriptResult::Result result =
+      RunLibraryCall<ScriptLibrary::PanelSnapshotCall>();
+  wire.assign(result.View());
+  return result.Succeeded() && !wire.empty();
+}
+
+/*****************************************************************************
+ * CurrentContext
+ * Shared selection snapshot for trigger gating (logs cache stats)
+ *****************************************************************************/
+static const ContextCache::Snapshot &CurrentContext() {
+  const ContextCache::Snapshot &snapshot = ContextCache::Get();
+  if (ContextCache::GetStats().lookups % 100 == 0 &&
+      Logger::ShouldLog(Logger::CAT_SCRIPT, Logger::LEVEL_INFO)) {
+    Logger::LogText(Logger::CAT_SCRIPT, Logger::LEVEL_INFO, ContextCache::FormatStats());
+  }
+  return snapshot;
 }
 
 /*****************************************************************************
  * HasSelectedLayers
  * Check if there are selected layers and active panel is Viewer/Timeline
  *****************************************************************************/
-bool HasSelectedLayers() {
-  char result[64] = {0};
-  ExecuteScript("(function(){"
-                "var c=app.project.activeItem;"
-                "if(!c||!(c instanceof CompItem))return 0;"
-                "if(c.selectedLayers.length==0)return 0;"
-                "var v=app.activeViewer;"
-                "if(!v)return 0;"
-                "var t=v.type;"
-                "if(t!=ViewerType.VIEWER_COMPOSITION&&t!=ViewerType.VIEWER_"
-                "LAYER)return 0;"
-                "return 1;"
-                "})();",
-                result, sizeof(result));
-  return atoi(result) > 0;
-}
+bool HasSelectedLayers() { return CurrentContext().HasSelectedLayers(); }
 
 /*****************************************************************************
  * HasSelectedTextLayer
  * Check if any selected layer is a text layer
  *****************************************************************************/
 bool HasSelectedTextLayer() {
-  char result[64] = {0};
-  ExecuteScript("(function(){"
-                "var c=app.project.activeItem;"
-                "if(!c||!(c instanceof CompItem))return 0;"
-                "var sel=c.selectedLayers;"
-                "if(sel.length==0)return 0;"
-                "for(var i=0;i<sel.length;i++){"
-                "if(sel[i] instanceof TextLayer)return 1;"
-                "}"
-                "return 0;"
-                "})();",
-                result, sizeof(result));
-  return atoi(result) > 0;
+  return CurrentContext().HasSelected(ContextCache::LAYER_TEXT);
 }
 
 /*****************************************************************************
@@ -599,6 +987,7 @@ bool HasSelectedTextLayer() {
  * Read settings from CEP's settings file (cross-platform)
  *****************************************************************************/
 void LoadSettingsFromFile() {
+  TRACE_SCOPE("io", "LoadSettingsFromFile");
 #ifdef MSWindows
   // Windows: %APPDATA%\Adobe\CEP\extensions\com.anchor.snap\settings.json
   char path[512];
@@ -833,6 +1222,7 @@ void LoadSettingsFromFile() {
  * Save clipboard anchor to settings.json for CEP panel access
  *****************************************************************************/
 void SaveClipboardAnchorToFile(float rx, float ry) {
+  TRACE_SCOPE("io", "SaveClipboardAnchorToFile");
 #ifdef MSWindows
   char path[512];
   const char *appdata = getenv("APPDATA");
@@ -907,6 +1297,7 @@ void SaveClipboardAnchorToFile(float rx, float ry) {
  *useMaskRecognition)
  *****************************************************************************/
 void SaveSettingsToFile() {
+  TRACE_SCOPE("io", "SaveSettingsToFile");
 #ifdef MSWindows
   char path[512];
   const char *appdata = getenv("APPDATA");
@@ -1014,9 +1405,10 @@ void GetPresetFilePath(int slotIndex, char* outPath, size_t pathSize) {
  * SavePresetToSlot
  * Save effect preset data to a file
  *****************************************************************************/
-void SavePresetToSlot(int slotIndex, const char* presetJson) {
+void SavePresetToSlot(int slotIndex, const std::string& presetJson) {
+  TRACE_SCOPE("io", "SavePresetToSlot");
   if (slotIndex < 0 || slotIndex > 2) return;
-  if (!presetJson || presetJson[0] == '\0') return;
+  if (presetJson.empty()) return;
 
   char path[512];
   GetPresetFilePath(slotIndex, path, sizeof(path));
@@ -1024,20 +1416,19 @@ void SavePresetToSlot(int slotIndex, const char* presetJson) {
 
   FILE *f = fopen(path, "w");
   if (f) {
-    fputs(presetJson, f);
+    fwrite(presetJson.data(), 1, presetJson.size(), f);
     fclose(f);
   }
 }
 
 /*****************************************************************************
  * LoadPresetFromSlot
- * Load effect preset data from a file
+ * Load effect preset data from a file (whole file, no size limit)
  *****************************************************************************/
-bool LoadPresetFromSlot(int slotIndex, char* outBuffer, size_t bufSize) {
+bool LoadPresetFromSlot(int slotIndex, std::string& outJson) {
+  TRACE_SCOPE("io", "LoadPresetFromSlot");
+  outJson.clear();
   if (slotIndex < 0 || slotIndex > 2) return false;
-  if (!outBuffer || bufSize == 0) return false;
-
-  outBuffer[0] = '\0';
 
   char path[512];
   GetPresetFilePath(slotIndex, path, sizeof(path));
@@ -1046,11 +1437,14 @@ bool LoadPresetFromSlot(int slotIndex, char* outBuffer, size_t bufSize) {
   FILE *f = fopen(path, "r");
   if (!f) return false;
 
-  size_t len = fread(outBuffer, 1, bufSize - 1, f);
-  outBuffer[len] = '\0';
+  char chunk[8192];
+  size_t len;
+  while ((len = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+    outJson.append(chunk, len);
+  }
   fclose(f);
 
-  return len > 0;
+  return !outJson.empty();
 }
 
 /*****************************************************************************
@@ -1073,29 +1467,47 @@ bool PresetSlotExists(int slotIndex) {
 }
 
 /*****************************************************************************
- * EscapeJsonForScript
- * Escape JSON string for use in ExtendScript
+ * UI modules
+ * Registered at load, initialized on first show (ModuleRegistry): AE launch
+ * no longer pays for GDI+ startup, window classes and preset files
  *****************************************************************************/
-void EscapeJsonForScript(const char* input, char* output, size_t outputSize) {
-  size_t j = 0;
-  for (size_t i = 0; input[i] != '\0' && j < outputSize - 2; i++) {
-    if (input[i] == '\\') {
-      output[j++] = '\\';
-      output[j++] = '\\';
-    } else if (input[i] == '\'') {
-      output[j++] = '\\';
-      output[j++] = '\'';
-    } else if (input[i] == '\n') {
-      output[j++] = '\\';
-      output[j++] = 'n';
-    } else if (input[i] == '\r') {
-      output[j++] = '\\';
-      output[j++] = 'r';
-    } else {
-      output[j++] = input[i];
-    }
+enum UIModule {
+  UI_GRID = 0,
+  UI_CONTROL,
+  UI_KEYFRAME,
+  UI_ALIGN,
+  UI_TEXT,
+  UI_SHAPE,
+  UI_COMP,
+  UI_DMENU,
+  UI_MODULE_COUNT
+};
+
+static void RegisterModules() {
+  // Order matches UIModule
+  ModuleRegistry::Register("NativeUI", NativeUI::Initialize, NativeUI::Cleanup);
+  ModuleRegistry::Register("ControlUI", ControlUI::Initialize, ControlUI::Shutdown);
+  ModuleRegistry::Register("KeyframeUI", KeyframeUI::Initialize, KeyframeUI::Shutdown);
+  ModuleRegistry::Register("AlignUI", AlignUI::Initialize, AlignUI::Shutdown);
+  ModuleRegistry::Register("TextUI", TextUI::Initialize, TextUI::Shutdown);
+  ModuleRegistry::Register("ShapeUI", ShapeUI::Initialize, ShapeUI::Shutdown);
+  ModuleRegistry::Register("CompUI", CompUI::Initialize, CompUI::Shutdown);
+  ModuleRegistry::Register("DMenuUI", DMenuUI::Initialize, DMenuUI::Shutdown);
+}
+
+// Initialize a module before its first show (logs the init cost once)
+static bool EnsureModule(UIModule module) {
+  ModuleRegistry::State before = ModuleRegistry::GetState(module);
+  if (before == ModuleRegistry::STATE_READY) {
+    return true;
   }
-  output[j] = '\0';
+  bool ready = ModuleRegistry::Ensure(module);
+  ModuleRegistry::ModuleStats stats = ModuleRegistry::GetStats()[module];
+  Logger::Log(Logger::CAT_GENERAL, ready ? Logger::LEVEL_INFO : Logger::LEVEL_WARN,
+              "module %s: %s in %.2f ms (attempt %u)", stats.name,
+              ModuleRegistry::StateName(stats.state), (double)stats.initNs / 1e6,
+              stats.attempts);
+  return ready;
 }
 
 /*****************************************************************************
@@ -1120,6 +1532,7 @@ void ShowAnchorGrid(int mouseX, int mouseY) {
   settings.gridOpacity = g_loadedGridOpacity;
   settings.cellOpacity = g_loadedCellOpacity;
 
+  EnsureModule(UI_GRID);
   NativeUI::ShowGrid(mouseX, mouseY, config);
 }
 
@@ -1137,97 +1550,8 @@ void ApplyAnchorToLayers(int gridX, int gridY) {
   bool useCompMode = settings.useCompMode;
   bool useMaskMode = settings.useMaskRecognition;
 
-  char script[6000];
-  snprintf(
-      script, sizeof(script),
-      "(function(){"
-      "var gx=%d,gy=%d,gridW=%d,gridH=%d;"
-      "var useCompMode=%s,useMaskMode=%s;"
-      "var c=app.project.activeItem;"
-      "if(!c||!(c instanceof CompItem))return;"
-      "if(c.selectedLayers.length==0)return;"
-      "app.beginUndoGroup('Set Anchor');"
-      "for(var i=0;i<c.selectedLayers.length;i++){"
-      "var L=c.selectedLayers[i];"
-      "var b=null;"
-      // Composition mode: use comp bounds
-      "if(useCompMode){"
-      "b={left:0,top:0,width:c.width,height:c.height};"
-      "}else{"
-      // Selection mode: try mask first if enabled, then sourceRect
-      "if(useMaskMode){"
-      "var masks=L.property('ADBE Mask Parade');"
-      "if(masks&&masks.numProperties>0){"
-      "var minX=Infinity,minY=Infinity,maxX=-Infinity,maxY=-Infinity;"
-      "for(var m=1;m<=masks.numProperties;m++){"
-      "var mask=masks.property(m);"
-      "var path=mask.property('ADBE Mask Shape').valueAtTime(c.time,false);"
-      "if(!path||!path.vertices)continue;"
-      "var verts=path.vertices;"
-      "for(var v=0;v<verts.length;v++){"
-      "var pt=verts[v];"
-      "if(pt[0]<minX)minX=pt[0];"
-      "if(pt[0]>maxX)maxX=pt[0];"
-      "if(pt[1]<minY)minY=pt[1];"
-      "if(pt[1]>maxY)maxY=pt[1];"
-      "}}"
-      "if(minX!=Infinity){"
-      "b={left:minX,top:minY,width:maxX-minX,height:maxY-minY};"
-      "}}}"
-      // Fall back to sourceRectAtTime
-      "if(!b)b=L.sourceRectAtTime(c.time,false);"
-      "}"
-      "if(!b||b.width<=0||b.height<=0)continue;"
-      "var px=gx/(gridW-1),py=gy/(gridH-1);"
-      // Calculate anchor in appropriate coordinate space
-      "var nx,ny;"
-      "if(useCompMode){"
-      // Composition mode: convert comp coord to layer local
-      // Get layer transform properties
-      "var pos=L.position.value;"
-      "var anc=L.anchorPoint.value;"
-      "var sc=L.scale.value;"
-      "var rot=L.rotation.value*Math.PI/180;"
-      // Target position in comp space
-      "var compX=c.width*px,compY=c.height*py;"
-      // Translate: comp coord relative to layer position
-      "var dx=compX-pos[0],dy=compY-pos[1];"
-      // Reverse rotation
-      "var cos_r=Math.cos(-rot),sin_r=Math.sin(-rot);"
-      "var rx=dx*cos_r-dy*sin_r,ry=dx*sin_r+dy*cos_r;"
-      // Reverse scale
-      "var sx=100/sc[0],sy=100/sc[1];"
-      "rx=rx*sx;ry=ry*sy;"
-      // Add anchor offset to get local coord
-      "nx=rx+anc[0];ny=ry+anc[1];"
-      "}else{"
-      // Selection mode: already in layer local coordinates
-      "nx=b.left+b.width*px;ny=b.top+b.height*py;"
-      "}"
-      "var ap=L.property('ADBE Transform Group').property('ADBE Anchor "
-      "Point');"
-      "var pp=L.property('ADBE Transform Group').property('ADBE Position');"
-      "if(!ap||!pp)continue;"
-      "var oa=ap.value,pos=pp.value;"
-      "var dx=nx-oa[0],dy=ny-oa[1];"
-      "var sc=L.property('ADBE Transform Group').property('ADBE "
-      "Scale').value;"
-      "var sx=sc[0]/100,sy=sc[1]/100;"
-      "var rot=L.property('ADBE Transform Group').property('ADBE Rotate "
-      "Z').value*Math.PI/180;"
-      "var rdx=(dx*Math.cos(rot)-dy*Math.sin(rot))*sx;"
-      "var rdy=(dx*Math.sin(rot)+dy*Math.cos(rot))*sy;"
-      "var newAp=[nx,ny];"
-      "var newPos=pos.length==3?[pos[0]+rdx,pos[1]+rdy,pos[2]]:[pos[0]+rdx,pos[1]+rdy];"
-      "if(ap.numKeys>0)ap.setValueAtTime(c.time,newAp);else ap.setValue(newAp);"
-      "if(pp.numKeys>0)pp.setValueAtTime(c.time,newPos);else pp.setValue(newPos);"
-      "}"
-      "app.endUndoGroup();"
-      "})();",
-      gridX, gridY, gridW, gridH, useCompMode ? "true" : "false",
-      useMaskMode ? "true" : "false");
-
-  ExecuteScript(script);
+  ScriptLibrary::Call<ScriptLibrary::ApplyAnchorCall>(
+      gridX, gridY, gridW, gridH, useCompMode, useMaskMode);
 }
 
 /*****************************************************************************
@@ -1235,43 +1559,30 @@ void ApplyAnchorToLayers(int gridX, int gridY) {
  * Apply a custom anchor point at specified ratio (0-1)
  *****************************************************************************/
 void ApplyCustomAnchor(float ratioX, float ratioY) {
-  char script[3000];
-  snprintf(
-      script, sizeof(script),
-      "(function(){"
-      "var rx=%.4f,ry=%.4f;"
-      "var c=app.project.activeItem;"
-      "if(!c||!(c instanceof CompItem))return;"
-      "if(c.selectedLayers.length==0)return;"
-      "app.beginUndoGroup('Set Custom Anchor');"
-      "for(var i=0;i<c.selectedLayers.length;i++){"
-      "var L=c.selectedLayers[i];"
-      "var b=L.sourceRectAtTime(c.time,false);"
-      "if(!b||b.width<=0||b.height<=0)continue;"
-      "var nx=b.left+b.width*rx,ny=b.top+b.height*ry;"
-      "var ap=L.property('ADBE Transform Group').property('ADBE Anchor "
-      "Point');"
-      "var pp=L.property('ADBE Transform Group').property('ADBE Position');"
-      "if(!ap||!pp)continue;"
-      "var oa=ap.value,pos=pp.value;"
-      "var dx=nx-oa[0],dy=ny-oa[1];"
-      "var sc=L.property('ADBE Transform Group').property('ADBE "
-      "Scale').value;"
-      "var sx=sc[0]/100,sy=sc[1]/100;"
-      "var rot=L.property('ADBE Transform Group').property('ADBE Rotate "
-      "Z').value*Math.PI/180;"
-      "var rdx=(dx*Math.cos(rot)-dy*Math.sin(rot))*sx;"
-      "var rdy=(dx*Math.sin(rot)+dy*Math.cos(rot))*sy;"
-      "var newAp=[nx,ny];"
-      "var newPos=pos.length==3?[pos[0]+rdx,pos[1]+rdy,pos[2]]:[pos[0]+rdx,pos[1]+rdy];"
-      "if(ap.numKeys>0)ap.setValueAtTime(c.time,newAp);else ap.setValue(newAp);"
-      "if(pp.numKeys>0)pp.setValueAtTime(c.time,newPos);else pp.setValue(newPos);"
-      "}"
-      "app.endUndoGroup();"
-      "})();",
-      ratioX, ratioY);
-
-  ExecuteScript(script);
+  ScriptLibrary::Call<ScriptLibrary::ApplyCustomAnchorCall>(ratioX, ratioY);
+}
+
+/*****************************************************************************
+ * NotifyModeChanged
+ * Notify CEP of a mode toggle (fails gracefully if CEP is not open)
+ *****************************************************************************/
+SCRIPT_TEMPLATE(ModeChangedScript,
+                "(function(){"
+                "try{"
+                "var lib=new ExternalObject('lib:PlugPlugExternalObject');"
+                "if(lib){"
+                "var e=new CSXSEvent();"
+                "e.type='anchorGridModeChanged';"
+                "e.data=JSON.stringify({useCompMode:${b},useMaskRecognition:${b}});"
+                "e.dispatch();"
+                "}"
+                "}catch(ex){}"
+                "})();");
+
+static void NotifyModeChanged(const NativeUI::GridSettings &settings) {
+  ExecuteScript(ScriptBuilder::Render<ModeChangedScript>(
+      ScriptBuilder::DefaultArena(), settings.useCompMode,
+      settings.useMaskRecognition));
 }
 
 /*****************************************************************************
@@ -1295,44 +1606,14 @@ void HideAndApplyAnchor() {
   if (hoverOpt == NativeUI::OPT_COMP_MODE) {
     settings.useCompMode = !settings.useCompMode;
     SaveSettingsToFile(); // Persist to file
-    // Notify CEP of change via inline ExtendScript (fails gracefully if CEP not open)
-    char script[512];
-    snprintf(script, sizeof(script),
-             "(function(){"
-             "try{"
-             "var lib=new ExternalObject('lib:PlugPlugExternalObject');"
-             "if(lib){"
-             "var e=new CSXSEvent();"
-             "e.type='anchorGridModeChanged';"
-             "e.data=JSON.stringify({useCompMode:%s,useMaskRecognition:%s});"
-             "e.dispatch();"
-             "}"
-             "}catch(ex){}"
-             "})();",
-             settings.useCompMode ? "true" : "false",
-             settings.useMaskRecognition ? "true" : "false");
-    ExecuteScript(script);
+    // Notify CEP of change
+    NotifyModeChanged(settings);
     // Don't return - fall through to hide grid
   } else if (hoverOpt == NativeUI::OPT_MASK_MODE) {
     settings.useMaskRecognition = !settings.useMaskRecognition;
     SaveSettingsToFile(); // Persist to file
-    // Notify CEP of change via inline ExtendScript (fails gracefully if CEP not open)
-    char script[512];
-    snprintf(script, sizeof(script),
-             "(function(){"
-             "try{"
-             "var lib=new ExternalObject('lib:PlugPlugExternalObject');"
-             "if(lib){"
-             "var e=new CSXSEvent();"
-             "e.type='anchorGridModeChanged';"
-             "e.data=JSON.stringify({useCompMode:%s,useMaskRecognition:%s});"
-             "e.dispatch();"
-             "}"
-             "}catch(ex){}"
-             "})();",
-             settings.useCompMode ? "true" : "false",
-             settings.useMaskRecognition ? "true" : "false");
-    ExecuteScript(script);
+    // Notify CEP of change
+    NotifyModeChanged(settings);
     // Don't return - fall through to hide grid
   }
 
@@ -1366,25 +1647,23 @@ void HideAndApplyAnchor() {
     // Copy/Paste anchor
     case NativeUI::OPT_COPY_ANCHOR: {
       // Get current anchor ratio from selected layer
-      char resultBuf[256] = {0};
-      ExecuteScript("(function(){"
-                    "var c=app.project.activeItem;"
-                    "if(!c||!(c instanceof CompItem))return 'null';"
-                    "if(c.selectedLayers.length==0)return 'null';"
-                    "var L=c.selectedLayers[0];"
-                    "var b=L.sourceRectAtTime(c.time,false);"
-                    "if(!b||b.width<=0||b.height<=0)return 'null';"
-                    "var ap=L.property('ADBE Transform Group').property('ADBE "
-                    "Anchor Point').value;"
-                    "var rx=(ap[0]-b.left)/b.width;"
-                    "var ry=(ap[1]-b.top)/b.height;"
-                    "return rx.toFixed(4)+','+ry.toFixed(4);"
-                    "})();",
-                    resultBuf, sizeof(resultBuf));
+      std::string result = QueryScript("(function(){"
+                                       "var c=app.project.activeItem;"
+                                       "if(!c||!(c instanceof CompItem))return 'null';"
+                                       "if(c.selectedLayers.length==0)return 'null';"
+                                       "var L=c.selectedLayers[0];"
+                                       "var b=L.sourceRectAtTime(c.time,false);"
+                                       "if(!b||b.width<=0||b.height<=0)return 'null';"
+                                       "var ap=L.property('ADBE Transform Group').property('ADBE "
+                                       "Anchor Point').value;"
+                                       "var rx=(ap[0]-b.left)/b.width;"
+                                       "var ry=(ap[1]-b.top)/b.height;"
+                                       "return rx.toFixed(4)+','+ry.toFixed(4);"
+                                       "})();");
       // Parse result
-      if (resultBuf[0] != 'n' && resultBuf[0] != '\0') {
+      if (!result.empty() && result[0] != 'n') {
         float rx = 0.5f, ry = 0.5f;
-        if (sscanf(resultBuf, "%f,%f", &rx, &ry) == 2) {
+        if (sscanf(result.c_str(), "%f,%f", &rx, &ry) == 2) {
           // Store using NativeUI clipboard functions
           NativeUI::SetClipboardAnchor(rx, ry);
           // Also save to settings.json for CEP panel access
@@ -1452,6 +1731,17 @@ void HideAndApplyAnchor() {
  * - GetAncestor, GetWindow: AE 자식 윈도우 확인
  *****************************************************************************/
 
+/**
+ * IsTriggerKeyHeld
+ * True while a module trigger key (Y, E, D, K) is down
+ */
+static bool IsTriggerKeyHeld() {
+  return KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_Y) ||
+         KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_E) ||
+         KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_D) ||
+         KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_K);
+}
+
 /*****************************************************************************
  * UpdateMenuHook
  * Called when menus need updating - used to detect NOT in text editing mode
@@ -1468,6 +1758,15 @@ static A_Err UpdateMenuHook(
   auto now = std::chrono::steady_clock::now();
   g_lastMenuHookTime = now;
 
+  // Menu updates mean the selection/viewer may have changed. Skip the ones
+  // fired by our own trigger keys, which only read the selection.
+  if (!IsTriggerKeyHeld()) {
+    ContextCache::Invalidate();
+  }
+
+  // Key input in AE: run the idle routines now instead of after a long sleep
+  IdleScheduler::RequestWake();
+
   // Also update panel activation time for 1-second key input window
   // This covers: panel clicks, key inputs, returning from other apps
   g_panelActivationTime = now;
@@ -1639,159 +1938,465 @@ static bool IsKeyInputAllowed() {
   return IsMenuHookRecent() || IsInPanelActivationWindow();
 }
 
+/*****************************************************************************
+ * Preset slot alerts
+ *****************************************************************************/
+SCRIPT_TEMPLATE(PresetSavedAlert, "alert('Preset saved to slot ${i}')");
+SCRIPT_TEMPLATE(PresetEmptyAlert, "alert('Preset slot ${i} is empty')");
+
+/*****************************************************************************
+ * FetchKeyframeInfo
+ * Load every selected key pair of the selected properties into KeyframeUI
+ * (used by Right Shift+K, D→K and the Load button)
+ *****************************************************************************/
+static void FetchKeyframeInfo() {
+  // Keyframes belong to selected layers: nothing to read without one
+  if (!CurrentContext().HasSelection()) {
+    return;
+  }
+  std::string info = ScriptLibrary::Call<ScriptLibrary::KeyframeInfoCall>();
+
+  // Set keyframe info if we got valid data
+  if (!info.empty()) {
+    KeyframeUI::SetKeyframeInfo(info);
+  }
+}
+
+/*****************************************************************************
+ * FetchTextInfo
+ * Load the first selected text layer's properties into TextUI
+ *****************************************************************************/
+static void FetchTextInfo() {
+  std::string info = ScriptLibrary::Call<ScriptLibrary::TextInfoCall>();
+
+  if (!info.empty()) {
+    TextUI::SetTextInfo(info);
+  }
+}
+
+/*****************************************************************************
+ * Key triggers (InputEngine)
+ * One binding per module trigger; IdleHook reacts to the emitted events.
+ *****************************************************************************/
+enum InputAction {
+  INPUT_ANCHOR_GRID,    // Y hold = grid, Y~Y = toggle click mode
+  INPUT_LAYER_EFFECTS,  // Shift+E
+  INPUT_KEYFRAME_PANEL, // Right Shift+K
+  INPUT_D_MENU,         // D (no modifiers)
+  INPUT_CLICK           // Left click (panel activation, toggle-mode apply)
+};
+
+using InputEngine::Bit;
+
+// Y: hold 0.4 s shows the grid; a second press within 0.25 s of the
+// release latches toggle (click) mode until the next double-tap or click
+static const InputEngine::Binding kInputBindings[] = {
+    {INPUT_ANCHOR_GRID, InputEngine::GESTURE_HOLD, InputEngine::INPUT_Y, 0,
+     Bit(InputEngine::INPUT_ALT), true, 400, 250, true},
+    {INPUT_LAYER_EFFECTS, InputEngine::GESTURE_CHORD, InputEngine::INPUT_E,
+     Bit(InputEngine::INPUT_SHIFT), 0, true, 0, 0, false},
+    {INPUT_KEYFRAME_PANEL, InputEngine::GESTURE_CHORD, InputEngine::INPUT_K,
+     Bit(InputEngine::INPUT_RSHIFT), 0, true, 0, 0, false},
+    {INPUT_D_MENU, InputEngine::GESTURE_PRESS, InputEngine::INPUT_D, 0,
+     Bit(InputEngine::INPUT_ALT) | Bit(InputEngine::INPUT_SHIFT) |
+         Bit(InputEngine::INPUT_CTRL),
+     true, 0, 0, false},
+    {INPUT_CLICK, InputEngine::GESTURE_PRESS, InputEngine::INPUT_MOUSE_LEFT, 0, 0,
+     false, 0, 0, false},
+};
+
+static InputEngine::Engine g_input(kInputBindings,
+                                   sizeof(kInputBindings) / sizeof(kInputBindings[0]));
+static InputEngine::Sample g_inputSample;
+static std::vector<InputEngine::Event> g_inputEvents;
+
+static bool InputGate(void *context) {
+  (void)context;
+  return IsKeyInputAllowed();
+}
+
+// Y press only starts a hold / double-tap with layers selected
+static bool InputGuard(int action, void *context) {
+  (void)context;
+  return action != INPUT_ANCHOR_GRID || HasSelectedLayers();
+}
+
+// Key transitions from the hook thread (KeyboardMonitor::StartKeyHook)
+static InputQueue::Ring g_keyRing;
+static InputQueue::Cursor g_keyCursor;
+static std::vector<InputEngine::Sample> g_hookSamples;
+
+static uint64_t NowMs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * PollInput
+ * Run the trigger bindings once per tick
+ *
+ * With the key hook running, every transition since the last tick is
+ * replayed first at its own hook timestamp (taps between ticks, exact
+ * double-tap timing). The closing sample is always the polled level, so a
+ * dropped or missed hook event is corrected within one tick.
+ */
+static void PollInput() {
+  using namespace InputEngine;
+  uint32_t down = 0;
+  if (KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_Y)) down |= Bit(INPUT_Y);
+  if (KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_E)) down |= Bit(INPUT_E);
+  if (KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_D)) down |= Bit(INPUT_D);
+  if (KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_K)) down |= Bit(INPUT_K);
+  if (KeyboardMonitor::IsShiftHeld()) down |= Bit(INPUT_SHIFT);
+  if (GetAsyncKeyState(VK_RSHIFT) & 0x8000) down |= Bit(INPUT_RSHIFT);
+  if (KeyboardMonitor::IsCtrlHeld()) down |= Bit(INPUT_CTRL);
+  if (KeyboardMonitor::IsAltHeld()) down |= Bit(INPUT_ALT);
+  if (GetAsyncKeyState(VK_LBUTTON) & 0x8000) down |= Bit(INPUT_MOUSE_LEFT);
+
+  g_inputEvents.clear();
+  uint64_t now = NowMs();
+
+  if (KeyboardMonitor::IsKeyHookRunning()) {
+    // The hook only sees the keyboard; the mouse button stays polled
+    const uint32_t mouse = down & Bit(INPUT_MOUSE_LEFT);
+    g_hookSamples.clear();
+    if (!InputQueue::Drain(g_keyRing, g_keyCursor, mouse, g_hookSamples)) {
+      Logger::Log(Logger::CAT_INPUT, Logger::LEVEL_WARN,
+                  "Key hook queue overflow (%llu dropped), resynced from poll",
+                  (unsigned long long)g_keyRing.Dropped());
+    }
+    for (const Sample &sample : g_hookSamples) {
+      g_input.Update(sample, g_inputEvents);
+    }
+    g_keyCursor.down = down & ~mouse;
+    if (now < g_keyCursor.lastMs) {
+      now = g_keyCursor.lastMs;
+    }
+    g_keyCursor.lastMs = now;
+  }
+
+  g_inputSample = Sample();
+  g_inputSample.timeMs = now;
+  g_inputSample.down = down;
+  g_input.Update(g_inputSample, g_inputEvents);
+}
+
+static bool HasInputEvent(InputAction action, InputEngine::EventType type) {
+  for (const InputEngine::Event &event : g_inputEvents) {
+    if (event.action == action && event.type == type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool IsInputHeld(InputEngine::Input input) {
+  return (g_inputSample.down & InputEngine::Bit(input)) != 0;
+}
+
+/*****************************************************************************
+ * CurrentIdleState
+ * Plugin state that decides the next idle interval (IdleScheduler)
+ *****************************************************************************/
+static IdleScheduler::State CurrentIdleState() {
+  IdleScheduler::State state;
+  state.foreground = IsAEForeground();
+  state.uiVisible = g_globals.menu_visible || g_dMenuVisible || g_controlVisible ||
+                    g_keyframeVisible || g_alignVisible || g_textVisible ||
+                    g_shapeVisible || g_layerVisible;
+  state.holdPending = g_input.HoldPending() ||
+                      g_input.IsLatched(INPUT_ANCHOR_GRID) ||
+                      IsTriggerKeyHeld() || PanelPrefetch::IsPending();
+  state.workPending = !g_effectsLoaded || !g_fontsCatalogLoaded ||
+                      !g_fontsRevalidated;
+  return state;
+}
+
+static uint64_t NowUs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Brackets one IdleHook tick: sets max_sleepPL from the state on any return
+struct IdleTickScope {
+  explicit IdleTickScope(A_long *max_sleepPL) : m_sleep(max_sleepPL) {
+    IdleScheduler::BeginTick(NowUs());
+  }
+  ~IdleTickScope() {
+    IdleScheduler::Mode before = IdleScheduler::CurrentMode();
+    int sleepMs = IdleScheduler::EndTick(CurrentIdleState(), NowUs());
+    if (m_sleep) {
+      *m_sleep = sleepMs;
+    }
+    // Log the rate counters when AE goes to the background
+    if (IdleScheduler::CurrentMode() == IdleScheduler::MODE_BACKGROUND &&
+        before != IdleScheduler::MODE_BACKGROUND) {
+      Logger::LogText(Logger::CAT_IDLE, Logger::LEVEL_INFO, IdleScheduler::FormatStats());
+    }
+  }
+  A_long *m_sleep;
+};
+
+/*****************************************************************************
+ * WakeIdleRoutines
+ * IdleScheduler waker: run the idle routines without waiting out max_sleep
+ *
+ * AEGP API: AEGP_CauseIdleRoutinesToBeCalled (AEGP_UtilitySuite6)
+ *****************************************************************************/
+static void WakeIdleRoutines(void *context) {
+  (void)context;
+  if (g_globals.pica_basicP == NULL) {
+    return;
+  }
+  try {
+    AEGP_SuiteHandler suites(g_globals.pica_basicP);
+    suites.UtilitySuite6()->AEGP_CauseIdleRoutinesToBeCalled();
+  } catch (...) {
+    // Suite not available - the next regular tick picks the input up
+  }
+}
+
+/*****************************************************************************
+ * PollProfilerDump
+ * Profiler report to the log and <IPC>/profile.txt, every
+ * ANCHORSNAP_PROFILE seconds or when the panel creates profile_request.txt
+ * (checked once per second; only runs while the profiler is enabled)
+ *****************************************************************************/
+static int g_profileDumpSec = 0;
+static std::chrono::steady_clock::time_point g_profileLastDump;
+static std::chrono::steady_clock::time_point g_profileLastRequestCheck;
+
+static void PollProfilerDump() {
+  auto now = std::chrono::steady_clock::now();
+  bool due = now - g_profileLastDump >= std::chrono::seconds(g_profileDumpSec);
+  if (!due && now - g_profileLastRequestCheck >= std::chrono::seconds(1)) {
+    g_profileLastRequestCheck = now;
+    std::string request = CEPBridge::GetProfileRequestPath();
+    std::error_code ec;
+    if (std::filesystem::exists(request, ec)) {
+      std::filesystem::remove(request, ec);
+      due = true;
+    }
+  }
+  if (!due) {
+    return;
+  }
+  g_profileLastDump = now;
+
+  std::string report = Profiler::FormatReport() + ModuleRegistry::FormatReport() +
+                       IconAtlas::FormatReport();
+  Logger::LogText(Logger::CAT_PROFILE, Logger::LEVEL_INFO, report);
+  FILE *file = fopen(CEPBridge::GetProfileFilePath().c_str(), "w");
+  if (file) {
+    fputs(report.c_str(), file);
+    fclose(file);
+  }
+}
+
+/*****************************************************************************
+ * PollTracer
+ * Timeline trace to <IPC>/trace.json: started at load for
+ * ANCHORSNAP_TRACE seconds, or started / stopped each time the panel
+ * creates trace_request.txt (checked once per second)
+ *****************************************************************************/
+static int g_traceStopSec = 0; // 0 = until the next request
+static std::chrono::steady_clock::time_point g_traceStart;
+static std::chrono::steady_clock::time_point g_traceLastRequestCheck;
+
+static void StartTracer(int seconds) {
+  if (Tracer::Start(CEPBridge::GetTraceFilePath())) {
+    Tracer::SetThreadName("main");
+    g_traceStopSec = seconds;
+    g_traceStart = std::chrono::steady_clock::now();
+    Logger::Log(Logger::CAT_PROFILE, Logger::LEVEL_INFO, "trace started");
+  }
+}
+
+static void StopTracer() {
+  if (!Tracer::IsEnabled()) {
+    return;
+  }
+  bool written = Tracer::Stop();
+  Tracer::Stats stats = Tracer::GetStats();
+  Logger::Log(Logger::CAT_PROFILE, written ? Logger::LEVEL_INFO : Logger::LEVEL_WARN,
+              "trace %s: %llu events, %llu dropped, %u threads, %llu bytes",
+              written ? "written" : "write failed", (unsigned long long)stats.events,
+              (unsigned long long)stats.dropped, stats.threads,
+              (unsigned long long)stats.bytes);
+}
+
+static void PollTracer() {
+  auto now = std::chrono::steady_clock::now();
+  if (Tracer::IsEnabled() && g_traceStopSec > 0 &&
+      now - g_traceStart >= std::chrono::seconds(g_traceStopSec)) {
+    StopTracer();
+  }
+  if (now - g_traceLastRequestCheck < std::chrono::seconds(1)) {
+    return;
+  }
+  g_traceLastRequestCheck = now;
+  std::string request = CEPBridge::GetTraceRequestPath();
+  std::error_code ec;
+  if (std::filesystem::exists(request, ec)) {
+    std::filesystem::remove(request, ec);
+    if (Tracer::IsEnabled()) {
+      StopTracer();
+    } else {
+      StartTracer(0);
+    }
+  }
+}
+
 /*****************************************************************************
  * IdleHook
  * Called periodically by After Effects - we use this to check keyboard state
+ * The interval adapts to the plugin state (IdleScheduler).
  *****************************************************************************/
 A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
                A_long *max_sleepPL) {
   A_Err err = A_Err_NONE;
+  PollTracer(); // Before the tick's scope: a stop never cuts a tick in half
+  IdleTickScope idleTick(max_sleepPL); // Next interval from the final state
+  PROFILE_SCOPE("idle.tick");          // Includes the end-of-tick flush
+  TRACE_SCOPE("idle", "IdleHook");
+  ScriptTickScope scriptTick; // All scripts of this tick share one round-trip
+  Profiler::Sections sections; // Per-module time (ANCHORSNAP_PROFILE)
+
+  if (Profiler::IsEnabled()) {
+    PollProfilerDump();
+  }
+
+  // Key / mouse state -> trigger events for every module (one sample)
+  sections.Enter("idle.input");
+  PollInput();
 
   // Mouse click detection: UpdateMenuHook doesn't fire on mouse clicks
   // Detect click moment and update panel activation time
   // IMPORTANT: Only update when AE is foreground to prevent hooking keys from other apps
-  bool mouseButtonDown = (GetAsyncKeyState(VK_LBUTTON) & 0x8000) != 0;
-  if (mouseButtonDown && !g_wasMouseButtonDown) {
+  if (HasInputEvent(INPUT_CLICK, InputEngine::EVENT_TRIGGER)) {
     // Mouse just clicked - update panel activation time ONLY if AE is foreground
     if (IsAEForeground()) {
       g_panelActivationTime = std::chrono::steady_clock::now();
+      // Clicks select layers/viewers without a menu update
+      ContextCache::Invalidate();
     }
   }
-  g_wasMouseButtonDown = mouseButtonDown;
 
-  // Preload effects list on first idle (so Shift+E is fast)
-  if (!g_effectsLoaded) {
-    // Use heap allocation to avoid stack overflow (65536 * 2 = 128KB is too large for stack)
-    wchar_t* allEffects = new wchar_t[65536];
-    if (allEffects) {
-      GetAllEffectsList(allEffects, 65536);
-      if (allEffects[0] != L'\0') {
-        ControlUI::SetAvailableEffects(allEffects);
-        g_effectsLoaded = true;
-      }
-      delete[] allEffects;
+  // Script library benchmark (set ANCHORSNAP_SCRIPT_BENCH=<runs> to enable)
+  if (!g_benchmarkChecked) {
+    g_benchmarkChecked = true;
+    const char* benchRuns = getenv("ANCHORSNAP_SCRIPT_BENCH");
+    if (benchRuns && atoi(benchRuns) > 0) {
+      std::string report = ScriptLibrary::RunBenchmark(atoi(benchRuns));
+      Logger::LogText(Logger::CAT_SCRIPT, Logger::LEVEL_INFO, report);
     }
   }
 
-  bool y_key_held = KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_Y);
-  bool alt_held = KeyboardMonitor::IsAltHeld();
-  auto now = std::chrono::steady_clock::now();
+  // Preload effects and fonts on the first idle ticks (Shift+E and the
+  // font dropdown then open instantly), one catalog step per tick.
+  // Warm starts map the cached catalogs; revalidation runs on later ticks.
+  sections.Enter("idle.catalog");
+  if (!g_effectsLoaded) {
+    g_effectsLoaded = LoadEffectsCatalog();
+  } else if (!g_fontsCatalogLoaded) {
+    LoadFontCatalog();
+  } else if (!g_fontsRevalidated) {
+    RevalidateFontCatalog();
+  } else {
+    PollEffectsRevalidation();
+  }
 
-  // Y key just pressed
-  // Skip if: not in valid key input state (text editing mode, AE not foreground, or panel not active)
-  if (y_key_held && !g_globals.key_was_held && !alt_held && IsKeyInputAllowed()) {
-    if (HasSelectedLayers()) {
-      // Check for double-tap (Y~Y)
-      auto timeSinceLastRelease =
-          std::chrono::duration_cast<std::chrono::milliseconds>(now -
-                                                                g_lastYRelease)
-              .count();
-
-      if (timeSinceLastRelease < DOUBLE_TAP_MS) {
-        // Double-tap detected - toggle click mode
-        g_toggleClickMode = !g_toggleClickMode;
-        if (g_toggleClickMode) {
-          // Show grid in toggle mode (stays visible)
-          KeyboardMonitor::GetMousePosition(&g_mouseStartX, &g_mouseStartY);
-          LoadSettingsFromFile(); // Sync settings
-          ShowAnchorGrid(g_mouseStartX, g_mouseStartY);
-          g_globals.menu_visible = true;
-        } else {
-          // Hide grid
-          HideAndApplyAnchor();
-          g_globals.menu_visible = false;
-        }
-        g_waitingForHold = false;
-      } else {
-        // Normal press - start waiting for hold
-        g_keyPressTime = now;
-        g_waitingForHold = true;
-        KeyboardMonitor::GetMousePosition(&g_mouseStartX, &g_mouseStartY);
-      }
-    }
+  // AE in the background with nothing shown: no trigger can fire (every one
+  // needs IsKeyInputAllowed), so skip the module polling below
+  if (!g_globals.menu_visible && !g_dMenuVisible && !g_controlVisible &&
+      !g_keyframeVisible && !g_alignVisible && !g_textVisible &&
+      !g_shapeVisible && !g_layerVisible && !IsAEForeground()) {
+    return err;
   }
-  // Y key still held - check if hold duration reached
-  else if (y_key_held && g_waitingForHold && !g_globals.menu_visible) {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                       now - g_keyPressTime)
-                       .count();
-    if (elapsed >= HOLD_DELAY_MS) {
-      // Update mouse position to current
+
+  // =========================================================================
+  // ANCHOR MODULE: Y hold shows the grid, Y~Y toggles click mode
+  // (press is only accepted with layers selected, see InputGuard)
+  // =========================================================================
+  sections.Enter("idle.anchor");
+  if (HasInputEvent(INPUT_ANCHOR_GRID, InputEngine::EVENT_DOUBLE_TAP)) {
+    // Double-tap detected - the engine toggled the click-mode latch
+    if (g_input.IsLatched(INPUT_ANCHOR_GRID)) {
+      // Show grid in toggle mode (stays visible)
       KeyboardMonitor::GetMousePosition(&g_mouseStartX, &g_mouseStartY);
-      LoadSettingsFromFile(); // Sync settings from CEP
+      LoadSettingsFromFile(); // Sync settings
       ShowAnchorGrid(g_mouseStartX, g_mouseStartY);
       g_globals.menu_visible = true;
-      g_waitingForHold = false;
+    } else {
+      // Hide grid
+      HideAndApplyAnchor();
+      g_globals.menu_visible = false;
     }
   }
+
+  // Normal press - the engine starts waiting for the hold
+  if (HasInputEvent(INPUT_ANCHOR_GRID, InputEngine::EVENT_PRESS)) {
+    KeyboardMonitor::GetMousePosition(&g_mouseStartX, &g_mouseStartY);
+  }
+
+  // Hold duration reached
+  if (HasInputEvent(INPUT_ANCHOR_GRID, InputEngine::EVENT_HOLD) &&
+      !g_globals.menu_visible) {
+    // Update mouse position to current
+    KeyboardMonitor::GetMousePosition(&g_mouseStartX, &g_mouseStartY);
+    LoadSettingsFromFile(); // Sync settings from CEP
+    ShowAnchorGrid(g_mouseStartX, g_mouseStartY);
+    g_globals.menu_visible = true;
+  }
   // Y key still held and grid visible - update hover
-  else if (y_key_held && g_globals.menu_visible) {
+  else if (IsInputHeld(InputEngine::INPUT_Y) && g_globals.menu_visible) {
     int mouseX = 0, mouseY = 0;
     KeyboardMonitor::GetMousePosition(&mouseX, &mouseY);
     NativeUI::UpdateHover(mouseX, mouseY);
   }
-  // Y key just released
-  else if (!y_key_held && g_globals.key_was_held) {
-    g_lastYRelease = now;
 
-    // In toggle mode, don't hide on release
-    if (!g_toggleClickMode && g_globals.menu_visible) {
-      HideAndApplyAnchor();
-      g_globals.menu_visible = false;
-    }
-    g_waitingForHold = false;
+  // Y key released (the engine reports every accepted press's release)
+  // In toggle mode, don't hide on release
+  if (HasInputEvent(INPUT_ANCHOR_GRID, InputEngine::EVENT_RELEASE) &&
+      !g_input.IsLatched(INPUT_ANCHOR_GRID) && g_globals.menu_visible) {
+    HideAndApplyAnchor();
+    g_globals.menu_visible = false;
   }
 
   // In toggle mode, handle mouse click to apply
-  if (g_toggleClickMode && g_globals.menu_visible) {
-    if (KeyboardMonitor::IsMouseButtonPressed()) {
-      HideAndApplyAnchor();
-      g_globals.menu_visible = false;
-      g_toggleClickMode = false;
-    }
-  }
-
-  // Safety: If grid visible, Y not held, and not toggle mode - force close
-  // This catches edge cases where key release was missed
-  if (g_globals.menu_visible && !y_key_held && !g_toggleClickMode) {
+  if (g_input.IsLatched(INPUT_ANCHOR_GRID) && g_globals.menu_visible &&
+      HasInputEvent(INPUT_CLICK, InputEngine::EVENT_TRIGGER)) {
     HideAndApplyAnchor();
     g_globals.menu_visible = false;
+    g_input.Unlatch(INPUT_ANCHOR_GRID);
   }
 
-  g_globals.key_was_held = y_key_held;
-
   // =========================================================================
   // CONTROL MODULE: Shift+E for layer effects panel
   // Shows layer effects list when a layer is selected
   // =========================================================================
-  bool shift_held = KeyboardMonitor::IsShiftHeld();
-  bool e_key_held = KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_E);
-  bool shift_e_pressed = shift_held && e_key_held;
-
+  sections.Enter("idle.control");
   // Shift+E just pressed - toggle panel
-  // Skip if: not in valid key input state
-  if (shift_e_pressed && !g_eKeyWasHeld &&
-      IsKeyInputAllowed() && !g_globals.menu_visible) {
+  // (the binding is gated on a valid key input state)
+  if (HasInputEvent(INPUT_LAYER_EFFECTS, InputEngine::EVENT_TRIGGER) &&
+      !g_globals.menu_visible) {
 
     if (g_controlVisible) {
       // Already open - close it (toggle off)
       ControlUI::HidePanel();
       g_controlVisible = false;
-    } else {
-      // Not open - show panel
-      // Only show if a layer is selected
-      if (!HasSelectedLayers()) {
-        g_eKeyWasHeld = shift_e_pressed;
-        return err;
-      }
+    } else if (HasSelectedLayers()) {
+      // Not open - show panel, only if a layer is selected
+      // (shared context snapshot)
 
       // Show layer effects panel (Mode 2)
       // (effects list is preloaded in IdleHook)
       ControlUI::SetMode(ControlUI::MODE_EFFECTS);
-      wchar_t effectsList[4096];
-      GetLayerEffectsList(effectsList, sizeof(effectsList) / sizeof(wchar_t));
-      ControlUI::SetLayerEffects(effectsList);
+      ScriptResult::Result effects = GetLayerEffectsList();
+      ControlUI::SetLayerEffects(effects.View());
+      EnsureModule(UI_CONTROL);
       ControlUI::ShowPanel();
 
       g_controlVisible = true;
@@ -1821,58 +2426,12 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
         // Mode 2: Handle layer effect action
         if (result.action == ControlUI::ACTION_DELETE) {
           // Delete effect from layer
-          char script[512];
-          snprintf(script, sizeof(script),
-                   "(function(){"
-                   "var c=app.project.activeItem;"
-                   "if(!c||!(c instanceof CompItem))return;"
-                   "if(c.selectedLayers.length==0)return;"
-                   "var L=c.selectedLayers[0];"
-                   "var fx=L.Effects;"
-                   "if(fx&&fx.numProperties>%d){"
-                   "app.beginUndoGroup('Delete Effect');"
-                   "fx.property(%d).remove();"
-                   "app.endUndoGroup();"
-                   "}"
-                   "})();",
-                   result.effectIndex, result.effectIndex + 1);
-          ExecuteScript(script);
+          ScriptLibrary::Call<ScriptLibrary::DeleteEffectCall>(result.effectIndex);
         } else if (result.action == ControlUI::ACTION_EXPAND) {
-          // Expand this effect in timeline (collapse others) - inline script
+          // Expand this effect in timeline (collapse others)
           // Note: ExtendScript can't directly control Effect Controls twirl state
           // But we can show/hide properties in timeline which helps visibility
-          char script[2048];
-          snprintf(script, sizeof(script),
-                   "(function(){"
-                   "try{"
-                   "var c=app.project.activeItem;"
-                   "if(!c||!(c instanceof CompItem))return;"
-                   "if(c.selectedLayers.length===0)return;"
-                   "var layer=c.selectedLayers[0];"
-                   "var fx=layer.property('ADBE Effect Parade');"
-                   "if(!fx||fx.numProperties===0)return;"
-                   "var idx=%d+1;"  // Convert 0-based to 1-based
-                   "if(idx<1||idx>fx.numProperties)return;"
-                   // Deselect all effects and their properties
-                   "for(var i=1;i<=fx.numProperties;i++){"
-                   "var e=fx.property(i);"
-                   "e.selected=false;"
-                   // Collapse: set all properties to not selected
-                   "for(var j=1;j<=e.numProperties;j++){"
-                   "try{e.property(j).selected=false;}catch(ex){}"
-                   "}"
-                   "}"
-                   // Select target effect and its properties (expands in timeline)
-                   "var target=fx.property(idx);"
-                   "target.selected=true;"
-                   // Select first few properties to show them expanded
-                   "for(var k=1;k<=Math.min(target.numProperties,5);k++){"
-                   "try{target.property(k).selected=true;}catch(ex){}"
-                   "}"
-                   "}catch(e){}"
-                   "})();",
-                   result.effectIndex);
-          ExecuteScript(script);
+          ScriptLibrary::Call<ScriptLibrary::ExpandEffectCall>(result.effectIndex);
         }
       } else if (result.action == ControlUI::ACTION_NEW_EC_WINDOW) {
         // Open new locked Effect Controls window - inline script
@@ -1887,162 +2446,44 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
             "}catch(e){}"
             "})();");
       } else if (result.action == ControlUI::ACTION_SAVE_PRESET) {
-        // Save current effects to preset slot - inline script
-        // Use heap allocation to avoid stack overflow
-        char* presetData = new char[65536];
-        if (presetData) {
-          memset(presetData, 0, 65536);
-          ExecuteScript(
-              "(function(){"
-              "try{"
-              "var c=app.project.activeItem;"
-              "if(!c||!(c instanceof CompItem))return 'Error';"
-              "if(c.selectedLayers.length===0)return 'Error';"
-              "var layer=c.selectedLayers[0];"
-              "var fx=layer.property('ADBE Effect Parade');"
-              "if(!fx||fx.numProperties===0)return 'Error';"
-              "var allPresets={effects:[]};"
-              "for(var ei=0;ei<fx.numProperties;ei++){"
-              "var effect=fx.property(ei+1);"
-              "var preset={matchName:effect.matchName,name:effect.name,properties:[],expressions:[]};"
-              "for(var pi=1;pi<=effect.numProperties;pi++){"
-              "try{"
-              "var prop=effect.property(pi);"
-              "if(prop.propertyValueType===PropertyValueType.NO_VALUE)continue;"
-              "var pd={index:pi,name:prop.name,matchName:prop.matchName};"
-              "if(prop.numKeys===0){pd.value=prop.value;}else{pd.value=prop.valueAtTime(c.time,false);pd.hasKeyframes=true;}"
-              "if(prop.expression&&prop.expression.length>0){"
-              "preset.expressions.push({index:pi,expression:prop.expression,enabled:prop.expressionEnabled});"
-              "}"
-              "preset.properties.push(pd);"
-              "}catch(pe){}"
-              "}"
-              "allPresets.effects.push(preset);"
-              "}"
-              "return JSON.stringify(allPresets);"
-              "}catch(e){return 'Error';}"
-              "})();",
-              presetData, 65536);
-
-          if (presetData[0] != '\0' && strncmp(presetData, "null", 4) != 0 &&
-              strncmp(presetData, "Error", 5) != 0) {
-            SavePresetToSlot(result.presetSlotIndex, presetData);
-            // Mark slot as filled for UI
-            ControlUI::SetPresetSlotFilled(result.presetSlotIndex, true);
-            // Show confirmation
-            char confirmScript[256];
-            snprintf(confirmScript, sizeof(confirmScript),
-                     "alert('Preset saved to slot %d')",
-                     result.presetSlotIndex + 1);
-            ExecuteScript(confirmScript);
-          }
-          delete[] presetData;
+        // Save current effects to preset slot (whole result, no size limit)
+        std::string preset = ScriptLibrary::Call<ScriptLibrary::SavePresetCall>();
+        if (!preset.empty() && preset.compare(0, 4, "null") != 0 &&
+            preset.compare(0, 5, "Error") != 0) {
+          SavePresetToSlot(result.presetSlotIndex, preset);
+          // Mark slot as filled for UI
+          ControlUI::SetPresetSlotFilled(result.presetSlotIndex, true);
+          // Show confirmation
+          ExecuteScript(ScriptBuilder::Render<PresetSavedAlert>(
+              ScriptBuilder::DefaultArena(), result.presetSlotIndex + 1));
         }
       } else if (result.action == ControlUI::ACTION_APPLY_PRESET) {
-        // Apply preset from quick slot - inline script
-        // Use heap allocation to avoid stack overflow
-        char* presetJson = new char[65536];
-        if (presetJson) {
-          memset(presetJson, 0, 65536);
-          if (LoadPresetFromSlot(result.presetSlotIndex, presetJson, 65536)) {
-            // Escape the JSON for use in script
-            char* escapedJson = new char[131072];
-            if (escapedJson) {
-              memset(escapedJson, 0, 131072);
-              EscapeJsonForScript(presetJson, escapedJson, 131072);
-
-              // Apply the preset with inline script
-              char* script = new char[150000];
-              if (script) {
-                snprintf(script, 150000,
-                   "(function(){"
-                   "try{"
-                   "var allPresets=JSON.parse('%s');"
-                   "if(!allPresets||!allPresets.effects||allPresets.effects.length===0)return;"
-                   "var c=app.project.activeItem;"
-                   "if(!c||!(c instanceof CompItem))return;"
-                   "if(c.selectedLayers.length===0)return;"
-                   "app.beginUndoGroup('Apply Multi-Effect Preset');"
-                   "for(var li=0;li<c.selectedLayers.length;li++){"
-                   "var layer=c.selectedLayers[li];"
-                   "var fx=layer.property('ADBE Effect Parade');"
-                   "for(var ei=0;ei<allPresets.effects.length;ei++){"
-                   "var preset=allPresets.effects[ei];"
-                   "if(!fx.canAddProperty(preset.matchName))continue;"
-                   "var newFx=fx.addProperty(preset.matchName);"
-                   "for(var pi=0;pi<preset.properties.length;pi++){"
-                   "try{"
-                   "var pd=preset.properties[pi];"
-                   "var prop=newFx.property(pd.index);"
-                   "if(prop&&prop.propertyValueType!==PropertyValueType.NO_VALUE&&!pd.hasKeyframes){"
-                   "prop.setValue(pd.value);"
-                   "}"
-                   "}catch(pe){}"
-                   "}"
-                   "for(var xi=0;xi<preset.expressions.length;xi++){"
-                   "try{"
-                   "var xd=preset.expressions[xi];"
-                   "var xp=newFx.property(xd.index);"
-                   "if(xp){xp.expression=xd.expression;xp.expressionEnabled=xd.enabled;}"
-                   "}catch(xe){}"
-                   "}"
-                   "}"
-                   "}"
-                   "app.endUndoGroup();"
-                   "}catch(e){}"
-                   "})();",
-                   escapedJson);
-                ExecuteScript(script);
-                delete[] script;
-              }
-              delete[] escapedJson;
-            }
-          } else {
-            // Slot is empty
-            char emptyMsg[256];
-            snprintf(emptyMsg, sizeof(emptyMsg),
-                     "alert('Preset slot %d is empty')",
-                     result.presetSlotIndex + 1);
-            ExecuteScript(emptyMsg);
-          }
-          delete[] presetJson;
+        // Apply preset from quick slot
+        std::string presetJson;
+        if (LoadPresetFromSlot(result.presetSlotIndex, presetJson)) {
+          // Apply the preset via the script library (escaped by the template)
+          ScriptLibrary::Call<ScriptLibrary::ApplyPresetCall>(
+              ScriptBuilder::Json(presetJson));
+        } else {
+          // Slot is empty
+          ExecuteScript(ScriptBuilder::Render<PresetEmptyAlert>(
+              ScriptBuilder::DefaultArena(), result.presetSlotIndex + 1));
         }
       } else {
-        // Mode 1: Add new effect to layer
-        char matchNameA[256];
-        WideCharToMultiByte(CP_ACP, 0, result.selectedEffect.matchName, -1,
-                            matchNameA, sizeof(matchNameA), NULL, NULL);
-
-        char script[1024];
-        snprintf(script, sizeof(script),
-                 "(function(){"
-                 "var c=app.project.activeItem;"
-                 "if(!c||!(c instanceof CompItem))return;"
-                 "if(c.selectedLayers.length==0)return;"
-                 "app.beginUndoGroup('Add Effect');"
-                 "for(var i=0;i<c.selectedLayers.length;i++){"
-                 "try{c.selectedLayers[i].Effects.addProperty('%s');}catch(e){}"
-                 "}"
-                 "app.endUndoGroup();"
-                 "})();",
-                 matchNameA);
-        ExecuteScript(script);
+        // Mode 1: Add new effect to layer (wide match name is escaped as \uXXXX)
+        ScriptLibrary::Call<ScriptLibrary::AddEffectCall>(
+            result.selectedEffect.matchName);
       }
     }
   }
 
-  g_eKeyWasHeld = shift_e_pressed;
-
   // =========================================================================
   // KEYFRAME MODULE: Right Shift + K for direct keyframe panel access
   // =========================================================================
-  bool rshift_held = (GetAsyncKeyState(VK_RSHIFT) & 0x8000) != 0;
-  bool k_key_held = KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_K);
-  bool rshift_k_pressed = rshift_held && k_key_held;
-
+  sections.Enter("idle.keyframe");
   // Right Shift+K just pressed - toggle panel
-  if (rshift_k_pressed && !g_rshiftKWasHeld &&
-      IsKeyInputAllowed() && !g_globals.menu_visible && !g_dMenuVisible) {
+  if (HasInputEvent(INPUT_KEYFRAME_PANEL, InputEngine::EVENT_TRIGGER) &&
+      !g_globals.menu_visible && !g_dMenuVisible) {
 
     if (g_keyframeVisible) {
       // Already open - close it (toggle off)
@@ -2053,61 +2494,17 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
       int mouseX = 0, mouseY = 0;
       KeyboardMonitor::GetMousePosition(&mouseX, &mouseY);
 
-      // Get keyframe info before showing panel (same script as D→K)
-      const char* getInfoScript =
-        "(function(){"
-        "try{"
-        "var c=app.project.activeItem;"
-        "if(!c||!(c instanceof CompItem))return '';"
-        "var props=c.selectedProperties;"
-        "if(!props||props.length===0)return '';"
-        "var prop=props[0];"
-        "if(!prop.selectedKeys||prop.selectedKeys.length<2)return '';"
-        "var keys=prop.selectedKeys;"
-        "var k1=keys[0],k2=keys[1];"
-        "var t1=prop.keyTime(k1),t2=prop.keyTime(k2);"
-        "var v1=prop.keyValue(k1),v2=prop.keyValue(k2);"
-        "var val1=v1,val2=v2;"
-        "if(v1 instanceof Array){"
-        "var sum1=0,sum2=0;"
-        "for(var i=0;i<v1.length;i++){sum1+=v1[i]*v1[i];sum2+=v2[i]*v2[i];}"
-        "val1=Math.sqrt(sum1);val2=Math.sqrt(sum2);"
-        "}"
-        "var outEase=prop.keyOutTemporalEase(k1);"
-        "var inEase=prop.keyInTemporalEase(k2);"
-        "var outSpd=outEase[0].speed,outInf=outEase[0].influence;"
-        "var inSpd=inEase[0].speed,inInf=inEase[0].influence;"
-        "var dur=t2-t1;"
-        "var valChange=val2-val1;"
-        "var avgSpd=Math.abs(dur)>0.0001?Math.abs(valChange/dur):0;"
-        "return '{\"propName\":\"'+prop.name.replace(/\"/g,'\\\\\"')+'\",'+"
-        "'\"propMatchName\":\"'+prop.matchName.replace(/\"/g,'\\\\\"')+'\",'+"
-        "'\"keyIndex1\":'+k1+',\"keyIndex2\":'+k2+','+"
-        "'\"time1\":'+t1+',\"time2\":'+t2+','+"
-        "'\"value1\":'+val1+',\"value2\":'+val2+','+"
-        "'\"outSpeed\":'+outSpd+',\"outInfluence\":'+outInf+','+"
-        "'\"inSpeed\":'+inSpd+',\"inInfluence\":'+inInf+','+"
-        "'\"avgSpeed\":'+avgSpd+'}';"
-        "}catch(e){return '';}"
-        "})();";
-
-      char resultBuf[2048] = {0};
-      ExecuteScript(getInfoScript, resultBuf, sizeof(resultBuf));
-
-      // Set keyframe info if we got valid data
-      if (resultBuf[0] == '{') {
-        wchar_t wResult[2048];
-        MultiByteToWideChar(CP_UTF8, 0, resultBuf, -1, wResult, 2048);
-        KeyframeUI::SetKeyframeInfo(wResult);
-      }
+      // Create the window first: SetKeyframeInfo repaints it
+      EnsureModule(UI_KEYFRAME);
+
+      // Get keyframe info from current selection
+      FetchKeyframeInfo();
 
       KeyframeUI::ShowPanel(mouseX, mouseY);
       g_keyframeVisible = true;
     }
   }
 
-  g_rshiftKWasHeld = rshift_k_pressed;
-
   // =========================================================================
   // KEYFRAME MODULE: Toggle mode via D→K (DMenuUI)
   // Panel stays open until closed by outside click, ESC, or D→K toggle
@@ -2118,65 +2515,11 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
     KeyframeUI::KeyframeResult result = KeyframeUI::GetResult();
     g_keyframeVisible = false;
 
-    if (result.applied) {
-      // Validate and sanitize values before script generation
-      // NaN/inf would break ExtendScript parsing (produces "nan", "inf" strings)
-      float outSpd = result.outSpeed;
-      float outInf = result.outInfluence;
-      float inSpd = result.inSpeed;
-      float inInf = result.inInfluence;
-
-      // Check for NaN (x != x is true for NaN) and infinity
-      // Using inline check: finite numbers satisfy (x - x == 0)
-      if (outSpd != outSpd || (outSpd - outSpd) != 0.0f) outSpd = 1.0f;
-      if (outInf != outInf || (outInf - outInf) != 0.0f) outInf = 33.33f;
-      if (inSpd != inSpd || (inSpd - inSpd) != 0.0f) inSpd = 1.0f;
-      if (inInf != inInf || (inInf - inInf) != 0.0f) inInf = 33.33f;
-
-      // Clamp to valid ranges (also catches any remaining edge cases)
-      outSpd = (outSpd < 0.0f) ? 0.0f : ((outSpd > 10000.0f) ? 10000.0f : outSpd);
-      outInf = (outInf < 0.1f) ? 0.1f : ((outInf > 100.0f) ? 100.0f : outInf);
-      inSpd = (inSpd < 0.0f) ? 0.0f : ((inSpd > 10000.0f) ? 10000.0f : inSpd);
-      inInf = (inInf < 0.1f) ? 0.1f : ((inInf > 100.0f) ? 100.0f : inInf);
-
-      // Apply keyframe easing using inline ExtendScript
-      char script[4096];
-      snprintf(script, sizeof(script),
-               "(function(){"
-               "try{"
-               "var c=app.project.activeItem;"
-               "if(!c||!(c instanceof CompItem))return;"
-               "var props=c.selectedProperties;"
-               "if(!props||props.length===0)return;"
-               "var outSpd=%.2f,outInf=%.2f,inSpd=%.2f,inInf=%.2f;"
-               "app.beginUndoGroup('Apply Keyframe Easing');"
-               "for(var i=0;i<props.length;i++){"
-               "var prop=props[i];"
-               "if(!prop.selectedKeys||prop.selectedKeys.length<2)continue;"
-               "var keys=prop.selectedKeys;"
-               "var numDims=1;"
-               "if(prop.propertyValueType===PropertyValueType.TwoD)numDims=2;"
-               "else if(prop.propertyValueType===PropertyValueType.ThreeD)numDims=3;"
-               "var outArr=[],inArr=[];"
-               "for(var d=0;d<numDims;d++){"
-               "outArr.push(new KeyframeEase(outSpd,outInf));"
-               "inArr.push(new KeyframeEase(inSpd,inInf));"
-               "}"
-               "for(var j=0;j<keys.length;j++){"
-               "var k=keys[j];"
-               "if(j<keys.length-1){"
-               "try{prop.setTemporalEaseAtKey(k,prop.keyInTemporalEase(k),outArr);}catch(e){}"
-               "}"
-               "if(j>0){"
-               "try{prop.setTemporalEaseAtKey(k,inArr,prop.keyOutTemporalEase(k));}catch(e){}"
-               "}"
-               "}"
-               "}"
-               "app.endUndoGroup();"
-               "}catch(e){}"
-               "})();",
-               outSpd, outInf, inSpd, inInf);
-      ExecuteScript(script);
+    // Apply keyframe easing: exact per-pair eases of every selected key
+    // pair, one script call and one undo group (KeyframeSelection)
+    std::string payload;
+    if (result.applied && KeyframeUI::TakeEasePayload(payload)) {
+      ScriptLibrary::Call<ScriptLibrary::ApplyEaseCall>(payload);
     }
   }
 
@@ -2189,52 +2532,8 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
     // Check if Load button was pressed (reload keyframe info)
     KeyframeUI::KeyframeResult currentResult = KeyframeUI::GetResult();
     if (currentResult.loadRequested) {
-      // Re-fetch keyframe info from current selection
-      const char* getInfoScript =
-        "(function(){"
-        "try{"
-        "var c=app.project.activeItem;"
-        "if(!c||!(c instanceof CompItem))return '';"
-        "var props=c.selectedProperties;"
-        "if(!props||props.length===0)return '';"
-        "var prop=props[0];"
-        "if(!prop.selectedKeys||prop.selectedKeys.length<2)return '';"
-        "var keys=prop.selectedKeys;"
-        "var k1=keys[0],k2=keys[1];"
-        "var t1=prop.keyTime(k1),t2=prop.keyTime(k2);"
-        "var v1=prop.keyValue(k1),v2=prop.keyValue(k2);"
-        "var val1=v1,val2=v2;"
-        "if(v1 instanceof Array){"
-        "var sum1=0,sum2=0;"
-        "for(var i=0;i<v1.length;i++){sum1+=v1[i]*v1[i];sum2+=v2[i]*v2[i];}"
-        "val1=Math.sqrt(sum1);val2=Math.sqrt(sum2);"
-        "}"
-        "var outEase=prop.keyOutTemporalEase(k1);"
-        "var inEase=prop.keyInTemporalEase(k2);"
-        "var outSpd=outEase[0].speed,outInf=outEase[0].influence;"
-        "var inSpd=inEase[0].speed,inInf=inEase[0].influence;"
-        "var dur=t2-t1;"
-        "var valChange=val2-val1;"
-        "var avgSpd=Math.abs(dur)>0.0001?Math.abs(valChange/dur):0;"
-        "return '{\"propName\":\"'+prop.name.replace(/\"/g,'\\\\\"')+'\",'+"
-        "'\"propMatchName\":\"'+prop.matchName.replace(/\"/g,'\\\\\"')+'\",'+"
-        "'\"keyIndex1\":'+k1+',\"keyIndex2\":'+k2+','+"
-        "'\"time1\":'+t1+',\"time2\":'+t2+','+"
-        "'\"value1\":'+val1+',\"value2\":'+val2+','+"
-        "'\"outSpeed\":'+outSpd+',\"outInfluence\":'+outInf+','+"
-        "'\"inSpeed\":'+inSpd+',\"inInfluence\":'+inInf+','+"
-        "'\"avgSpeed\":'+avgSpd+'}';"
-        "}catch(e){return '';}"
-        "})();";
-
-      char resultBuf[2048] = {0};
-      ExecuteScript(getInfoScript, resultBuf, sizeof(resultBuf));
-
-      if (resultBuf[0] == '{') {
-        wchar_t wResult[2048];
-        MultiByteToWideChar(CP_UTF8, 0, resultBuf, -1, wResult, 2048);
-        KeyframeUI::SetKeyframeInfo(wResult);
-      }
+      // Get keyframe info from current selection
+      FetchKeyframeInfo();
     }
   }
 
@@ -2242,19 +2541,24 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
   // D MENU MODULE: D key shows menu, user selects A/T/K
   // Menu popup takes focus, so keys go to menu not AE
   // =========================================================================
-  bool d_key_held = KeyboardMonitor::IsKeyHeld(KeyboardMonitor::KEY_D);
+  sections.Enter("idle.dmenu");
+  // Menu painted last tick: prefetch every panel's info while the user picks
+  // (before the show below, so the script never delays the menu's first paint)
+  if (g_dMenuVisible && DMenuUI::IsVisible() && PanelPrefetch::IsPending()) {
+    PanelPrefetch::Run();
+  }
 
   // D key just pressed - show D menu
-  // Skip if: modifier keys held, or not in valid key input state
-  bool ctrl_held = KeyboardMonitor::IsCtrlHeld();
-  if (d_key_held && !g_dKeyWasHeld && !alt_held && !shift_held && !ctrl_held &&
-      IsKeyInputAllowed() &&
+  // (the binding excludes Alt/Shift/Ctrl and is gated on key input state)
+  if (HasInputEvent(INPUT_D_MENU, InputEngine::EVENT_TRIGGER) &&
       !g_globals.menu_visible && !g_controlVisible && !g_keyframeVisible &&
       !g_alignVisible && !g_textVisible && !g_dMenuVisible) {
     int mouseX = 0, mouseY = 0;
     KeyboardMonitor::GetMousePosition(&mouseX, &mouseY);
+    EnsureModule(UI_DMENU);
     DMenuUI::ShowMenu(mouseX, mouseY);
     g_dMenuVisible = true;
+    PanelPrefetch::Arm();
   }
 
   // Fallback: Force close DMenu if it lost focus (WM_ACTIVATE might not fire)
@@ -2270,70 +2574,29 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
     int mouseX = 0, mouseY = 0;
     KeyboardMonitor::GetMousePosition(&mouseX, &mouseY);
 
+    // Panel info from the menu's prefetch (found == false: fetch it now)
+    bool found = false;
+    std::string_view info;
+
     switch (action) {
     case DMenuUI::ACTION_ALIGN:
+      EnsureModule(UI_ALIGN);
       AlignUI::ShowPanel(mouseX, mouseY);
       g_alignVisible = true;
       break;
 
     case DMenuUI::ACTION_TEXT: {
+      // Create the window first: SetTextInfo repaints it
+      EnsureModule(UI_TEXT);
+
       // Get text layer info if a text layer is selected (panel opens regardless)
-      const char* getTextInfoScript =
-        "(function(){"
-        "try{"
-        "var c=app.project.activeItem;"
-        "if(!c||!(c instanceof CompItem))return '';"
-        "var sel=c.selectedLayers;"
-        "var textLayer=null;"
-        "for(var i=0;i<sel.length;i++){"
-        "if(sel[i] instanceof TextLayer){textLayer=sel[i];break;}"
-        "}"
-        "if(!textLayer)return '';"
-        "var txt=textLayer.text.sourceText.value;"
-        "if(!txt)return '';"
-        "var font=(txt.font!=null)?txt.font:'Arial';"
-        "var fontStyle=(txt.fontStyle!=null)?txt.fontStyle:'Regular';"
-        "var fontSize=(txt.fontSize!=null)?txt.fontSize:72;"
-        "var tracking=(txt.tracking!=null)?txt.tracking:0;"
-        "var leading=(txt.leading!=null)?txt.leading:0;"
-        "var strokeWidth=(txt.strokeWidth!=null)?txt.strokeWidth:0;"
-        "var applyFill=(txt.applyFill!==false);"
-        "var applyStroke=(txt.applyStroke===true);"
-        "var fill=(applyFill&&txt.fillColor&&txt.fillColor.length>=3)?txt.fillColor:[1,1,1];"
-        "var stroke=(applyStroke&&txt.strokeColor&&txt.strokeColor.length>=3)?txt.strokeColor:[0,0,0];"
-        "var just=txt.justification||ParagraphJustification.LEFT_JUSTIFY;"
-        "var justNum=0;"
-        "if(just==ParagraphJustification.LEFT_JUSTIFY)justNum=0;"
-        "else if(just==ParagraphJustification.CENTER_JUSTIFY)justNum=1;"
-        "else if(just==ParagraphJustification.RIGHT_JUSTIFY)justNum=2;"
-        "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_LEFT)justNum=3;"
-        "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_CENTER)justNum=4;"
-        "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_RIGHT)justNum=5;"
-        "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_FULL)justNum=6;"
-        "return '{'+"
-        "'\"font\":\"'+String(font).replace(/\"/g,'\\\\\"')+'\",'+"
-        "'\"fontStyle\":\"'+String(fontStyle).replace(/\"/g,'\\\\\"')+'\",'+"
-        "'\"fontSize\":'+fontSize+','+"
-        "'\"tracking\":'+tracking+','+"
-        "'\"leading\":'+leading+','+"
-        "'\"strokeWidth\":'+strokeWidth+','+"
-        "'\"fillColor\":['+fill[0]+','+fill[1]+','+fill[2]+'],'+"
-        "'\"strokeColor\":['+stroke[0]+','+stroke[1]+','+stroke[2]+'],'+"
-        "'\"applyFill\":'+applyFill+','+"
-        "'\"applyStroke\":'+applyStroke+','+"
-        "'\"justify\":'+justNum+','+"
-        "'\"layerName\":\"'+textLayer.name.replace(/\"/g,'\\\\\"')+'\"'+"
-        "'}';"
-        "}catch(e){return '';}"
-        "})();";
-
-      char resultBuf[2048] = {0};
-      ExecuteScript(getTextInfoScript, resultBuf, sizeof(resultBuf));
-
-      if (resultBuf[0] == '{') {
-        wchar_t wResult[2048];
-        MultiByteToWideChar(CP_UTF8, 0, resultBuf, -1, wResult, 2048);
-        TextUI::SetTextInfo(wResult);
+      info = PanelPrefetch::Section(WireFormat::PANEL_TEXT, found);
+      if (found) {
+        if (!info.empty()) {
+          TextUI::SetTextInfo(info);
+        }
+      } else if (HasSelectedTextLayer()) {
+        FetchTextInfo();
       }
 
       // Always open the panel (even without text layer selected)
@@ -2343,16 +2606,18 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
     }
 
     case DMenuUI::ACTION_SHAPE: {
-      // Get shape layer info if a shape layer is selected
-      const char* getShapeInfoScript = "getShapeInfo()";
+      EnsureModule(UI_SHAPE);
 
-      char resultBuf[4096] = {0};
-      ExecuteScript(getShapeInfoScript, resultBuf, sizeof(resultBuf));
+      // Get shape layer info if a shape layer is selected
+      ScriptResult::Result shapeInfo;
+      info = PanelPrefetch::Section(WireFormat::PANEL_SHAPE, found);
+      if (!found && CurrentContext().FirstSelectedIs(ContextCache::LAYER_SHAPE)) {
+        shapeInfo = RunLibraryCall<ScriptLibrary::ShapeInfoCall>();
+        info = shapeInfo.View();
+      }
 
-      if (resultBuf[0] == '{') {
-        wchar_t wResult[4096];
-        MultiByteToWideChar(CP_UTF8, 0, resultBuf, -1, wResult, 4096);
-        ShapeUI::SetShapeInfo(wResult);
+      if (!info.empty()) {
+        ShapeUI::SetShapeInfo(info);
       }
 
       // Always open the panel (even without shape layer selected)
@@ -2367,52 +2632,14 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
         KeyframeUI::HidePanel();
         g_keyframeVisible = false;
       } else {
-        // Get keyframe info before showing panel
-        const char* getInfoScript =
-          "(function(){"
-          "try{"
-          "var c=app.project.activeItem;"
-          "if(!c||!(c instanceof CompItem))return '';"
-          "var props=c.selectedProperties;"
-          "if(!props||props.length===0)return '';"
-          "var prop=props[0];"
-          "if(!prop.selectedKeys||prop.selectedKeys.length<2)return '';"
-          "var keys=prop.selectedKeys;"
-          "var k1=keys[0],k2=keys[1];"
-          "var t1=prop.keyTime(k1),t2=prop.keyTime(k2);"
-          "var v1=prop.keyValue(k1),v2=prop.keyValue(k2);"
-          "var val1=v1,val2=v2;"
-          "if(v1 instanceof Array){"
-          "var sum1=0,sum2=0;"
-          "for(var i=0;i<v1.length;i++){sum1+=v1[i]*v1[i];sum2+=v2[i]*v2[i];}"
-          "val1=Math.sqrt(sum1);val2=Math.sqrt(sum2);"
-          "}"
-          "var outEase=prop.keyOutTemporalEase(k1);"
-          "var inEase=prop.keyInTemporalEase(k2);"
-          "var outSpd=outEase[0].speed,outInf=outEase[0].influence;"
-          "var inSpd=inEase[0].speed,inInf=inEase[0].influence;"
-          "var dur=t2-t1;"
-          "var valChange=val2-val1;"
-          "var avgSpd=Math.abs(dur)>0.0001?Math.abs(valChange/dur):0;"
-          "return '{\"propName\":\"'+prop.name.replace(/\"/g,'\\\\\"')+'\",'+"
-          "'\"propMatchName\":\"'+prop.matchName.replace(/\"/g,'\\\\\"')+'\",'+"
-          "'\"keyIndex1\":'+k1+',\"keyIndex2\":'+k2+','+"
-          "'\"time1\":'+t1+',\"time2\":'+t2+','+"
-          "'\"value1\":'+val1+',\"value2\":'+val2+','+"
-          "'\"outSpeed\":'+outSpd+',\"outInfluence\":'+outInf+','+"
-          "'\"inSpeed\":'+inSpd+',\"inInfluence\":'+inInf+','+"
-          "'\"avgSpeed\":'+avgSpd+'}';"
-          "}catch(e){return '';}"
-          "})();";
-
-        char resultBuf[2048] = {0};
-        ExecuteScript(getInfoScript, resultBuf, sizeof(resultBuf));
-
-        // Set keyframe info if we got valid data
-        if (resultBuf[0] == '{') {
-          wchar_t wResult[2048];
-          MultiByteToWideChar(CP_UTF8, 0, resultBuf, -1, wResult, 2048);
-          KeyframeUI::SetKeyframeInfo(wResult);
+        EnsureModule(UI_KEYFRAME);
+
+        // Get keyframe info from current selection
+        info = PanelPrefetch::Section(WireFormat::PANEL_KEYFRAME, found);
+        if (!found) {
+          FetchKeyframeInfo();
+        } else if (!info.empty()) {
+          KeyframeUI::SetKeyframeInfo(info);
         }
 
         KeyframeUI::ShowPanel(mouseX, mouseY);
@@ -2426,63 +2653,20 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
         CompUI::HidePanel();
         g_layerVisible = false;
       } else {
-        // Get selected layer info via ExtendScript
+        EnsureModule(UI_COMP);
+
+        // Get selected layer info via ExtendScript (skipped without a selection)
         // LayerType enum values: 0=NONE, 1=TEXT, 2=SHAPE, 3=SOLID, 4=NULL, 5=FOOTAGE, 6=CAMERA, 7=LIGHT, 8=ADJUSTMENT, 9=PRECOMP
-        char layerResult[2048] = {0};
-        ExecuteScript(
-          "(function(){"
-          "var c=app.project.activeItem;"
-          "if(!c||!(c instanceof CompItem))return '';"
-          "var layers=c.selectedLayers;"
-          "if(layers.length===0)return '';"
-          "var layer=layers[0];"
-          "var type=0;"  // Default: NONE
-          "if(layer instanceof TextLayer)type=1;"
-          "else if(layer instanceof ShapeLayer)type=2;"
-          "else if(layer instanceof CameraLayer)type=6;"
-          "else if(layer instanceof LightLayer)type=7;"
-          "else if(layer instanceof AVLayer){"
-          "  if(layer.nullLayer)type=4;"
-          "  else if(layer.adjustmentLayer)type=8;"
-          "  else if(layer.source instanceof CompItem)type=9;"
-          "  else if(layer.source&&layer.source.mainSource instanceof SolidSource)type=3;"
-          "  else type=5;"  // Footage
-          "}"
-          "var hasParent=layer.parent!==null;"
-          "var parentIdx=hasParent?layer.parent.index:0;"
-          "var isSeq=false,hasTimeRemap=false;"
-          "if(type===5&&layer.source&&layer.source.mainSource){"
-          "  isSeq=!layer.source.mainSource.isStill;"
-          "  hasTimeRemap=layer.timeRemapEnabled;"
-          "}"
-          "var solidColor=0;"
-          "if(type===3&&layer.source&&layer.source.mainSource instanceof SolidSource){"
-          "  var col=layer.source.mainSource.color;"
-          "  solidColor=Math.round(col[0]*255)*65536+Math.round(col[1]*255)*256+Math.round(col[2]*255);"
-          "}"
-          "return JSON.stringify({"
-          "  name:layer.name,"
-          "  type:type,"
-          "  index:layer.index,"
-          "  hasParent:hasParent,"
-          "  parentIndex:parentIdx,"
-          "  isSelected:true,"
-          "  solidColor:solidColor,"
-          "  isSequence:isSeq,"
-          "  hasTimeRemap:hasTimeRemap"
-          "});"
-          "})()",
-          layerResult, sizeof(layerResult));
-
-        // Convert to wide string and set layer info
-        if (layerResult[0] != '\0') {
-          wchar_t wResult[2048];
-          MultiByteToWideChar(CP_UTF8, 0, layerResult, -1, wResult, 2048);
-          CompUI::SetLayerInfo(wResult);
-        } else {
-          CompUI::SetLayerInfo(L"");  // No layer selected
+        std::string layerInfo;
+        info = PanelPrefetch::Section(WireFormat::PANEL_LAYER, found);
+        if (!found && CurrentContext().HasSelection()) {
+          layerInfo = ScriptLibrary::Call<ScriptLibrary::LayerInfoCall>();
+          info = layerInfo;
         }
 
+        // Empty result = no layer selected
+        CompUI::SetLayerInfo(info);
+
         CompUI::ShowPanel(mouseX, mouseY);
         g_layerVisible = true;
       }
@@ -2527,137 +2711,29 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
       // ACTION_NONE or ACTION_CANCELLED - do nothing
       break;
     }
+
+    // The snapshot belongs to this menu: never reuse it for the next one
+    PanelPrefetch::Discard();
   }
 
   // Check if Align panel closed and process result
+  sections.Enter("idle.align");
   if (g_alignVisible && !AlignUI::IsVisible()) {
     g_alignVisible = false;
     AlignUI::AlignResult result = AlignUI::GetResult();
 
     if (result.applied) {
-      // Execute alignment/distribution via ExtendScript
-      // The actual script will be built based on the result
+      // Execute alignment/distribution via the script library
       if (result.funcMode == AlignUI::FUNC_ALIGN) {
-        // Build align script based on direction and reference mode
-        char script[4096];
-        const char* refMode = (result.refMode == AlignUI::REF_COMPOSITION) ? "true" : "false";
+        // Align by direction and reference mode
+        bool useComp = (result.refMode == AlignUI::REF_COMPOSITION);
         int dir = static_cast<int>(result.alignDir);
-
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "try{"
-          "var useComp=%s;"
-          "var dir=%d;" // 0=left,1=centerH,2=right,3=top,4=middleV,5=bottom
-          "var c=app.project.activeItem;"
-          "if(!c||!(c instanceof CompItem))return;"
-          "var layers=c.selectedLayers;"
-          "if(layers.length===0)return;"
-          "app.beginUndoGroup('Align Layers');"
-
-          // Get bounds for all layers
-          "function getBounds(L){"
-          "var r=L.sourceRectAtTime(c.time,false);"
-          "var pos=L.position.value,anc=L.anchorPoint.value,sc=L.scale.value;"
-          "var w=r.width*sc[0]/100,h=r.height*sc[1]/100;"
-          "var left=pos[0]-(anc[0]-r.left)*sc[0]/100;"
-          "var top=pos[1]-(anc[1]-r.top)*sc[1]/100;"
-          "return{left:left,top:top,right:left+w,bottom:top+h,cx:left+w/2,cy:top+h/2,w:w,h:h};"
-          "}"
-
-          "var allBounds=[];"
-          "for(var i=0;i<layers.length;i++)allBounds.push(getBounds(layers[i]));"
-
-          // Calculate target position based on mode
-          "var target;"
-          "if(useComp){"
-          "target={left:0,top:0,right:c.width,bottom:c.height,cx:c.width/2,cy:c.height/2};"
-          "}else{"
-          "var minL=Infinity,minT=Infinity,maxR=-Infinity,maxB=-Infinity;"
-          "for(var i=0;i<allBounds.length;i++){"
-          "var b=allBounds[i];"
-          "if(b.left<minL)minL=b.left;if(b.top<minT)minT=b.top;"
-          "if(b.right>maxR)maxR=b.right;if(b.bottom>maxB)maxB=b.bottom;"
-          "}"
-          "target={left:minL,top:minT,right:maxR,bottom:maxB,cx:(minL+maxR)/2,cy:(minT+maxB)/2};"
-          "}"
-
-          // Apply alignment
-          "for(var i=0;i<layers.length;i++){"
-          "var L=layers[i],b=allBounds[i];"
-          "var pos=L.position.value;"
-          "var dx=0,dy=0;"
-          "if(dir===0)dx=target.left-b.left;"       // Left
-          "else if(dir===1)dx=target.cx-b.cx;"      // Center H
-          "else if(dir===2)dx=target.right-b.right;" // Right
-          "else if(dir===3)dy=target.top-b.top;"    // Top
-          "else if(dir===4)dy=target.cy-b.cy;"      // Middle V
-          "else if(dir===5)dy=target.bottom-b.bottom;" // Bottom
-          "var pp=L.property('ADBE Transform Group').property('ADBE Position');"
-          "var newPos=[pos[0]+dx,pos[1]+dy];"
-          "if(pp.numKeys>0)pp.setValueAtTime(c.time,newPos);else pp.setValue(newPos);"
-          "}"
-          "app.endUndoGroup();"
-          "}catch(e){alert('Align error: '+e.toString());}"
-          "})();",
-          refMode, dir);
-        ExecuteScript(script);
+        ScriptLibrary::Call<ScriptLibrary::AlignCall>(useComp, dir);
       } else {
         // Distribute
-        char script[4096];
-        const char* refMode = (result.refMode == AlignUI::REF_COMPOSITION) ? "true" : "false";
+        bool useComp = (result.refMode == AlignUI::REF_COMPOSITION);
         bool isHorizontal = (result.distDir == AlignUI::DIST_HORIZONTAL);
-
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "try{"
-          "var useComp=%s;"
-          "var isH=%s;"
-          "var c=app.project.activeItem;"
-          "if(!c||!(c instanceof CompItem))return;"
-          "var layers=c.selectedLayers;"
-          "if(layers.length<3)return;" // Need at least 3 layers
-          "app.beginUndoGroup('Distribute Layers');"
-
-          "function getBounds(L){"
-          "var r=L.sourceRectAtTime(c.time,false);"
-          "var pos=L.position.value,anc=L.anchorPoint.value,sc=L.scale.value;"
-          "var w=r.width*sc[0]/100,h=r.height*sc[1]/100;"
-          "var left=pos[0]-(anc[0]-r.left)*sc[0]/100;"
-          "var top=pos[1]-(anc[1]-r.top)*sc[1]/100;"
-          "return{left:left,top:top,right:left+w,bottom:top+h,cx:left+w/2,cy:top+h/2,w:w,h:h,layer:L};"
-          "}"
-
-          // Collect and sort layers by position
-          "var data=[];"
-          "for(var i=0;i<layers.length;i++){"
-          "var b=getBounds(layers[i]);b.layer=layers[i];data.push(b);"
-          "}"
-          "data.sort(function(a,b){return isH?(a.cx-b.cx):(a.cy-b.cy);});"
-
-          // Calculate spacing
-          "var first,last,total;"
-          "if(useComp){"
-          "first=isH?0:0;last=isH?c.width:c.height;"
-          "}else{"
-          "first=isH?data[0].cx:data[0].cy;"
-          "last=isH?data[data.length-1].cx:data[data.length-1].cy;"
-          "}"
-          "var spacing=(last-first)/(data.length-1);"
-
-          // Apply distribution (skip first and last)
-          "for(var i=1;i<data.length-1;i++){"
-          "var targetPos=first+spacing*i;"
-          "var delta=isH?(targetPos-data[i].cx):(targetPos-data[i].cy);"
-          "var pos=data[i].layer.position.value;"
-          "var pp=data[i].layer.property('ADBE Transform Group').property('ADBE Position');"
-          "var newPos=isH?[pos[0]+delta,pos[1]]:[pos[0],pos[1]+delta];"
-          "if(pp.numKeys>0)pp.setValueAtTime(c.time,newPos);else pp.setValue(newPos);"
-          "}"
-          "app.endUndoGroup();"
-          "}catch(e){alert('Distribute error: '+e.toString());}"
-          "})();",
-          refMode, isHorizontal ? "true" : "false");
-        ExecuteScript(script);
+        ScriptLibrary::Call<ScriptLibrary::DistributeCall>(useComp, isHorizontal);
       }
     }
   }
@@ -2669,9 +2745,8 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
     AlignUI::UpdateHover(mouseX, mouseY);
   }
 
-  g_dKeyWasHeld = d_key_held;
-
   // Check if Text panel closed and process result
+  sections.Enter("idle.text");
   if (g_textVisible && !TextUI::IsVisible()) {
     g_textVisible = false;
     TextUI::TextResult result = TextUI::GetResult();
@@ -2690,227 +2765,66 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
 
     // Check if refresh is requested (e.g., user clicked refresh button)
     if (TextUI::NeedsRefresh()) {
-      const char* getTextInfoScript =
-        "(function(){"
-        "try{"
-        "var c=app.project.activeItem;"
-        "if(!c||!(c instanceof CompItem))return '';"
-        "var sel=c.selectedLayers;"
-        "var textLayer=null;"
-        "for(var i=0;i<sel.length;i++){"
-        "if(sel[i] instanceof TextLayer){textLayer=sel[i];break;}"
-        "}"
-        "if(!textLayer)return '';"
-        "var txt=textLayer.text.sourceText.value;"
-        "if(!txt)return '';"
-        "var font=(txt.font!=null)?txt.font:'Arial';"
-        "var fontStyle=(txt.fontStyle!=null)?txt.fontStyle:'Regular';"
-        "var fontSize=(txt.fontSize!=null)?txt.fontSize:72;"
-        "var tracking=(txt.tracking!=null)?txt.tracking:0;"
-        "var leading=(txt.leading!=null)?txt.leading:0;"
-        "var strokeWidth=(txt.strokeWidth!=null)?txt.strokeWidth:0;"
-        "var applyFill=(txt.applyFill!==false);"
-        "var applyStroke=(txt.applyStroke===true);"
-        "var fill=(applyFill&&txt.fillColor&&txt.fillColor.length>=3)?txt.fillColor:[1,1,1];"
-        "var stroke=(applyStroke&&txt.strokeColor&&txt.strokeColor.length>=3)?txt.strokeColor:[0,0,0];"
-        "var just=txt.justification||ParagraphJustification.LEFT_JUSTIFY;"
-        "var justNum=0;"
-        "if(just==ParagraphJustification.LEFT_JUSTIFY)justNum=0;"
-        "else if(just==ParagraphJustification.CENTER_JUSTIFY)justNum=1;"
-        "else if(just==ParagraphJustification.RIGHT_JUSTIFY)justNum=2;"
-        "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_LEFT)justNum=3;"
-        "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_CENTER)justNum=4;"
-        "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_RIGHT)justNum=5;"
-        "else if(just==ParagraphJustification.FULL_JUSTIFY_LASTLINE_FULL)justNum=6;"
-        "return '{'+"
-        "'\"font\":\"'+String(font).replace(/\"/g,'\\\\\"')+'\",'+"
-        "'\"fontStyle\":\"'+String(fontStyle).replace(/\"/g,'\\\\\"')+'\",'+"
-        "'\"fontSize\":'+fontSize+','+"
-        "'\"tracking\":'+tracking+','+"
-        "'\"leading\":'+leading+','+"
-        "'\"strokeWidth\":'+strokeWidth+','+"
-        "'\"fillColor\":['+fill[0]+','+fill[1]+','+fill[2]+'],'+"
-        "'\"strokeColor\":['+stroke[0]+','+stroke[1]+','+stroke[2]+'],'+"
-        "'\"applyFill\":'+applyFill+','+"
-        "'\"applyStroke\":'+applyStroke+','+"
-        "'\"justify\":'+justNum+','+"
-        "'\"layerName\":\"'+textLayer.name.replace(/\"/g,'\\\\\"')+'\"'+"
-        "'}';"
-        "}catch(e){return '';}"
-        "})();";
-
-      char resultBuf[2048] = {0};
-      ExecuteScript(getTextInfoScript, resultBuf, sizeof(resultBuf));
-
-      if (resultBuf[0] == '{') {
-        wchar_t wResult[2048];
-        MultiByteToWideChar(CP_UTF8, 0, resultBuf, -1, wResult, 2048);
-        TextUI::SetTextInfo(wResult);
-      }
+      FetchTextInfo();
     }
   }
 
   // Check if Layer panel closed and process result
+  sections.Enter("idle.layer");
   if (g_layerVisible && !CompUI::IsVisible()) {
     g_layerVisible = false;
     CompUI::CompResult result = CompUI::GetResult();
 
     if (result.applied) {
-      char script[4096];
-      char resultBuf[512];
-
       switch (result.action) {
       // Text layer actions
       case CompUI::ACTION_TEXT_ANIMATOR_TYPEWRITER:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof TextLayer))return;"
-          "app.beginUndoGroup('Add Typewriter');"
-          "var tp=layer.Text.property('ADBE Text Animators');"
-          "var anim=tp.addProperty('ADBE Text Animator');"
-          "anim.name='Typewriter';"
-          "var sel=anim.property('ADBE Text Selectors').addProperty('ADBE Text Selector');"
-          "var range=sel.property('ADBE Text Percent Start');"
-          "range.setValueAtTime(0,100);range.setValueAtTime(c.duration*0.8,0);"
-          "var props=anim.property('ADBE Text Animator Properties');"
-          "props.addProperty('ADBE Text Opacity');props.property('ADBE Text Opacity').setValue(0);"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::TextAnimatorCall>(
+            "Add Typewriter", "Typewriter", 0.8f, "ADBE Text Opacity",
+            ScriptBuilder::Json("0"));
         break;
 
       case CompUI::ACTION_TEXT_ANIMATOR_FADE:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof TextLayer))return;"
-          "app.beginUndoGroup('Add Fade In');"
-          "var tp=layer.Text.property('ADBE Text Animators');"
-          "var anim=tp.addProperty('ADBE Text Animator');"
-          "anim.name='Fade In';"
-          "var sel=anim.property('ADBE Text Selectors').addProperty('ADBE Text Selector');"
-          "var range=sel.property('ADBE Text Percent Start');"
-          "range.setValueAtTime(0,100);range.setValueAtTime(c.duration*0.5,0);"
-          "var props=anim.property('ADBE Text Animator Properties');"
-          "props.addProperty('ADBE Text Opacity');props.property('ADBE Text Opacity').setValue(0);"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::TextAnimatorCall>(
+            "Add Fade In", "Fade In", 0.5f, "ADBE Text Opacity",
+            ScriptBuilder::Json("0"));
         break;
 
       case CompUI::ACTION_TEXT_ANIMATOR_SCALE:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof TextLayer))return;"
-          "app.beginUndoGroup('Add Scale');"
-          "var tp=layer.Text.property('ADBE Text Animators');"
-          "var anim=tp.addProperty('ADBE Text Animator');"
-          "anim.name='Scale In';"
-          "var sel=anim.property('ADBE Text Selectors').addProperty('ADBE Text Selector');"
-          "var range=sel.property('ADBE Text Percent Start');"
-          "range.setValueAtTime(0,100);range.setValueAtTime(c.duration*0.5,0);"
-          "var props=anim.property('ADBE Text Animator Properties');"
-          "props.addProperty('ADBE Text Scale');props.property('ADBE Text Scale').setValue([0,0]);"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::TextAnimatorCall>(
+            "Add Scale", "Scale In", 0.5f, "ADBE Text Scale",
+            ScriptBuilder::Json("[0,0]"));
         break;
 
       case CompUI::ACTION_TEXT_ANIMATOR_BLUR:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof TextLayer))return;"
-          "app.beginUndoGroup('Add Blur');"
-          "var tp=layer.Text.property('ADBE Text Animators');"
-          "var anim=tp.addProperty('ADBE Text Animator');"
-          "anim.name='Blur In';"
-          "var sel=anim.property('ADBE Text Selectors').addProperty('ADBE Text Selector');"
-          "var range=sel.property('ADBE Text Percent Start');"
-          "range.setValueAtTime(0,100);range.setValueAtTime(c.duration*0.5,0);"
-          "var props=anim.property('ADBE Text Animator Properties');"
-          "props.addProperty('ADBE Text Blur');props.property('ADBE Text Blur').setValue(20);"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::TextAnimatorCall>(
+            "Add Blur", "Blur In", 0.5f, "ADBE Text Blur",
+            ScriptBuilder::Json("20"));
         break;
 
       case CompUI::ACTION_TEXT_ANIMATOR_TRACKING:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof TextLayer))return;"
-          "app.beginUndoGroup('Add Tracking');"
-          "var tp=layer.Text.property('ADBE Text Animators');"
-          "var anim=tp.addProperty('ADBE Text Animator');"
-          "anim.name='Tracking';"
-          "var sel=anim.property('ADBE Text Selectors').addProperty('ADBE Text Selector');"
-          "var range=sel.property('ADBE Text Percent Start');"
-          "range.setValueAtTime(0,100);range.setValueAtTime(c.duration*0.5,0);"
-          "var props=anim.property('ADBE Text Animator Properties');"
-          "props.addProperty('ADBE Text Tracking Amount');props.property('ADBE Text Tracking Amount').setValue(50);"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::TextAnimatorCall>(
+            "Add Tracking", "Tracking", 0.5f, "ADBE Text Tracking Amount",
+            ScriptBuilder::Json("50"));
         break;
 
       // Shape layer actions
       case CompUI::ACTION_SHAPE_TRIM_PATH:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof ShapeLayer))return;"
-          "app.beginUndoGroup('Add Trim Paths');"
-          "var contents=layer.property('ADBE Root Vectors Group');"
-          "var trim=contents.addProperty('ADBE Vector Filter - Trim');"
-          "trim.property('ADBE Vector Trim End').setValueAtTime(0,0);"
-          "trim.property('ADBE Vector Trim End').setValueAtTime(c.duration*0.5,100);"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::TrimPathCall>();
         break;
 
       case CompUI::ACTION_SHAPE_REPEATER:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof ShapeLayer))return;"
-          "app.beginUndoGroup('Add Repeater');"
-          "var contents=layer.property('ADBE Root Vectors Group');"
-          "var rep=contents.addProperty('ADBE Vector Filter - Repeater');"
-          "rep.property('ADBE Vector Repeater Copies').setValue(5);"
-          "rep.property('ADBE Vector Repeater Transform').property('ADBE Vector Repeater Position').setValue([100,0]);"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::RepeaterCall>();
         break;
 
       case CompUI::ACTION_SHAPE_WIGGLE_PATH:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof ShapeLayer))return;"
-          "app.beginUndoGroup('Add Wiggle Paths');"
-          "var contents=layer.property('ADBE Root Vectors Group');"
-          "var wig=contents.addProperty('ADBE Vector Filter - Wiggler');"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::ShapeFilterCall>(
+            "Add Wiggle Paths", "ADBE Vector Filter - Wiggler");
         break;
 
       case CompUI::ACTION_SHAPE_WIGGLE_TRANSFORM:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer||!(layer instanceof ShapeLayer))return;"
-          "app.beginUndoGroup('Add Wiggle Transform');"
-          "var contents=layer.property('ADBE Root Vectors Group');"
-          "var wig=contents.addProperty('ADBE Vector Filter - Wig-Zag');"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::ShapeFilterCall>(
+            "Add Wiggle Transform", "ADBE Vector Filter - Wig-Zag");
         break;
 
       // Solid layer actions
@@ -2919,96 +2833,31 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
         break;
 
       case CompUI::ACTION_SOLID_FIT_TO_COMP:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer)return;"
-          "if(!(layer.source instanceof SolidSource))return;"
-          "app.beginUndoGroup('Fit Solid to Comp');"
-          "layer.source.mainSource.width=c.width;"
-          "layer.source.mainSource.height=c.height;"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::FitSolidCall>();
         break;
 
       // Footage layer actions
       case CompUI::ACTION_FOOTAGE_LOOP_CYCLE:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer)return;"
-          "app.beginUndoGroup('Add Loop Cycle');"
-          "layer.timeRemapEnabled=true;"
-          "layer.timeRemap.expression='loopOut(\"cycle\")';"
-          "layer.outPoint=c.duration;"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::LoopFootageCall>("Add Loop Cycle",
+                                                         "cycle");
         break;
 
       case CompUI::ACTION_FOOTAGE_LOOP_PINGPONG:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer)return;"
-          "app.beginUndoGroup('Add Loop Ping Pong');"
-          "layer.timeRemapEnabled=true;"
-          "layer.timeRemap.expression='loopOut(\"pingpong\")';"
-          "layer.outPoint=c.duration;"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::LoopFootageCall>("Add Loop Ping Pong",
+                                                         "pingpong");
         break;
 
       case CompUI::ACTION_FOOTAGE_LAST_FRAME_HOLD:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer)return;"
-          "app.beginUndoGroup('Last Frame Hold');"
-          "layer.timeRemapEnabled=true;"
-          "var dur=layer.source.duration;"
-          "layer.timeRemap.setValueAtTime(dur,dur-c.frameDuration);"
-          "layer.outPoint=c.duration;"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::LastFrameHoldCall>();
         break;
 
       // Common actions
       case CompUI::ACTION_RESET_TRANSFORM:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer)return;"
-          "app.beginUndoGroup('Reset Transform');"
-          "var hasParent=layer.parent!==null;"
-          "var oldParent=layer.parent;"
-          "if(hasParent)layer.parent=null;"
-          "layer.position.setValue([c.width/2,c.height/2]);"
-          "layer.scale.setValue([100,100]);"
-          "layer.rotation.setValue(0);"
-          "if(hasParent)layer.parent=oldParent;"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::ResetTransformCall>();
         break;
 
       case CompUI::ACTION_RESET_POSITION:
-        snprintf(script, sizeof(script),
-          "(function(){"
-          "var c=app.project.activeItem;if(!c)return;"
-          "var layer=c.selectedLayers[0];if(!layer)return;"
-          "app.beginUndoGroup('Reset Position');"
-          "var hasParent=layer.parent!==null;"
-          "var oldParent=layer.parent;"
-          "if(hasParent)layer.parent=null;"
-          "layer.position.setValue([c.width/2,c.height/2,0]);"
-          "if(hasParent)layer.parent=oldParent;"
-          "app.endUndoGroup();"
-          "})()");
-        ExecuteScript(script, resultBuf, sizeof(resultBuf));
+        ScriptLibrary::Call<ScriptLibrary::ResetPositionCall>();
         break;
 
       default:
@@ -3024,11 +2873,23 @@ A_Err IdleHook(AEGP_GlobalRefcon plugin_refconP, AEGP_IdleRefcon refconP,
     CompUI::UpdateHover(mouseX, mouseY);
   }
 
-  *max_sleepPL = 33; // ~30fps for hover updates
-
   return err;
 }
 
+/*****************************************************************************
+ * DeathHook
+ * AE shutdown: stop the key hook thread before the DLL unloads
+ *****************************************************************************/
+static A_Err DeathHook(AEGP_GlobalRefcon plugin_refconP, AEGP_DeathRefcon refconP) {
+  (void)plugin_refconP;
+  (void)refconP;
+  KeyboardMonitor::StopKeyHook();
+  ModuleRegistry::ShutdownAll();
+  StopTracer();
+  Logger::Stop();
+  return A_Err_NONE;
+}
+
 /*****************************************************************************
  * EntryPointFunc
  * Main plugin entry point
@@ -3040,23 +2901,55 @@ extern "C" DllExport A_Err EntryPointFunc(struct SPBasicSuite *pica_basicP,
                                           AEGP_GlobalRefcon *global_refconP) {
   A_Err err = A_Err_NONE;
 
+  uint64_t startupNs = Profiler::NowNs(); // Startup probe (logged at the end)
+
   try {
     AEGP_SuiteHandler suites(pica_basicP);
 
     g_globals.plugin_id = aegp_plugin_id;
     g_globals.pica_basicP = pica_basicP;
     g_globals.menu_visible = false;
-    g_globals.key_was_held = false;
-
-    // Initialize native UI modules
-    NativeUI::Initialize();
-    ControlUI::Initialize();
-    KeyframeUI::Initialize();
-    AlignUI::Initialize();
-    TextUI::Initialize();
-    ShapeUI::Initialize();
-    CompUI::Initialize();
-    DMenuUI::Initialize();
+
+    // Log records are written off the UI thread
+    StartLogger();
+
+    // Route all ExtendScript calls through the batch transport
+    ScriptBatch::SetRunner(RunHostScript, nullptr);
+
+    // Section / script profiler (set ANCHORSNAP_PROFILE=<dump seconds>)
+    const char *profileSec = getenv("ANCHORSNAP_PROFILE");
+    if (profileSec && atoi(profileSec) > 0) {
+      g_profileDumpSec = atoi(profileSec);
+      g_profileLastDump = std::chrono::steady_clock::now();
+      Profiler::SetEnabled(true);
+    }
+
+    // Timeline trace (set ANCHORSNAP_TRACE=<seconds>, or trace_request.txt)
+    const char *traceSec = getenv("ANCHORSNAP_TRACE");
+    if (traceSec && atoi(traceSec) > 0) {
+      StartTracer(atoi(traceSec));
+    }
+
+    // Key triggers: gate on key input state, Y needs selected layers
+    g_input.SetGate(InputGate, nullptr);
+    g_input.SetGuard(InputGuard, nullptr);
+    // Timestamped key transitions between idle ticks (polling if unavailable)
+    if (KeyboardMonitor::StartKeyHook(&g_keyRing)) {
+      Logger::Log(Logger::CAT_INPUT, Logger::LEVEL_INFO, "Key hook installed");
+    }
+
+    // Selection snapshot shared by all key-trigger gates
+    ContextCache::SetQuery(QuerySelectionContext, nullptr);
+    PanelPrefetch::SetQuery(QueryPanelSnapshot, nullptr);
+
+    // Adaptive idle rate; key input wakes the idle routines early
+    IdleScheduler::SetWaker(WakeIdleRoutines, nullptr);
+
+    // Install the script library once (re-installed lazily if lost)
+    ScriptLibrary::Install();
+
+    // UI modules initialize on first show
+    RegisterModules();
 
     *global_refconP = (AEGP_GlobalRefcon)&g_globals;
 
@@ -3072,6 +2965,11 @@ extern "C" DllExport A_Err EntryPointFunc(struct SPBasicSuite *pica_basicP,
         UpdateMenuHook,
         nullptr));
 
+    ERR(suites.RegisterSuite5()->AEGP_RegisterDeathHook(aegp_plugin_id, DeathHook, nullptr));
+
+    Logger::Log(Logger::CAT_GENERAL, Logger::LEVEL_INFO,
+                "startup: %.2f ms (%d UI modules registered, none initialized)",
+                (double)(Profiler::NowNs() - startupNs) / 1e6, (int)UI_MODULE_COUNT);
   } catch (...) {
     err = A_Err_GENERIC;
   }
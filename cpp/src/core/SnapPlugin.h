@@ -25,8 +25,6 @@ struct SnapPluginGlobals {
   AEGP_PluginID plugin_id;
   SPBasicSuite *pica_basicP;
   bool menu_visible;
-  bool key_was_held;
-  bool click_mode_active; // Option+Y toggle mode
 };
 
 // Plugin entry point
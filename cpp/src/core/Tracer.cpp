@@ -0,0 +1,255 @@
+/*****************************************************************************
+ * Tracer.cpp
+ *
+ * Per-thread event buffers and the Chrome trace_event writer (see Tracer.h)
+ *
+ * Only the owning thread writes its buffer; it publishes the event count
+ * with release, so Stop() on another thread reads a consistent prefix.
+ * The buffer list lock is taken once per thread and session, never per
+ * event.
+ *****************************************************************************/
+
+#include "Tracer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Tracer {
+
+std::atomic<bool> g_enabled{false};
+
+struct Event {
+  uint64_t timeNs; // Since Start
+  const char *category;
+  const char *name;
+  char phase; // 'B', 'E', 'i'
+  uint8_t argCount;
+  EventArg args[MAX_ARGS];
+};
+
+struct ThreadBuffer {
+  uint32_t tid = 0; // 1, 2, ... in order of the first event
+  std::atomic<const char *> name{nullptr};
+  std::unique_ptr<Event[]> events;
+  size_t capacity = 0;
+  std::atomic<size_t> count{0};
+  std::atomic<uint32_t> session{0};
+  size_t open = 0; // Recorded begins without their end (room reserved)
+  std::atomic<uint64_t> dropped{0};
+};
+
+static std::mutex s_mutex; // s_buffers
+static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+static thread_local ThreadBuffer *t_buffer = nullptr;
+static thread_local const char *t_threadName = nullptr;
+
+static std::atomic<uint32_t> s_session{0};
+static size_t s_capacity = DEFAULT_CAPACITY;
+static uint64_t s_startNs = 0;
+static std::string s_path;
+static uint64_t s_bytes = 0;
+
+static uint64_t NowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Calling thread's buffer for the current session (created / reset here)
+static ThreadBuffer *CurrentBuffer() {
+  uint32_t session = s_session.load(std::memory_order_acquire);
+  ThreadBuffer *buffer = t_buffer;
+  if (buffer && buffer->session.load(std::memory_order_relaxed) == session)
+    return buffer;
+
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (!buffer) {
+    s_buffers.push_back(std::make_unique<ThreadBuffer>());
+    buffer = s_buffers.back().get();
+    buffer->tid = (uint32_t)s_buffers.size();
+    t_buffer = buffer;
+  }
+  if (buffer->capacity != s_capacity) {
+    buffer->events.reset(new Event[s_capacity]);
+    buffer->capacity = s_capacity;
+  }
+  buffer->name = t_threadName;
+  buffer->count.store(0, std::memory_order_relaxed);
+  buffer->open = 0;
+  buffer->dropped = 0;
+  buffer->session.store(session, std::memory_order_release);
+  return buffer;
+}
+
+static void Append(ThreadBuffer *buffer, char phase, const char *category, const char *name,
+                   const EventArg *args, int argCount) {
+  size_t index = buffer->count.load(std::memory_order_relaxed);
+  Event &event = buffer->events[index];
+  event.timeNs = NowNs() - s_startNs;
+  event.category = category;
+  event.name = name;
+  event.phase = phase;
+  event.argCount = (uint8_t)argCount;
+  for (int i = 0; i < argCount; i++)
+    event.args[i] = args[i];
+  buffer->count.store(index + 1, std::memory_order_release);
+}
+
+void Scope::Begin(const char *category, const char *name) {
+  ThreadBuffer *buffer = CurrentBuffer();
+  // Keep room for the end of every open scope plus this one
+  if (buffer->count.load(std::memory_order_relaxed) + buffer->open + 2 > buffer->capacity) {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Append(buffer, 'B', category, name, nullptr, 0);
+  buffer->open++;
+  m_category = category;
+  m_name = name;
+  m_session = buffer->session.load(std::memory_order_relaxed);
+}
+
+void Scope::End() {
+  // Ends after Stop() still land in the (already written) buffer; a scope
+  // that outlives its session is not recorded in the next one
+  ThreadBuffer *buffer = t_buffer;
+  if (!buffer || buffer->session.load(std::memory_order_relaxed) != m_session)
+    return;
+  Append(buffer, 'E', m_category, m_name, m_args, m_argCount);
+  buffer->open--;
+}
+
+void Instant(const char *category, const char *name, const char *key, int64_t value) {
+  if (!IsEnabled())
+    return;
+  ThreadBuffer *buffer = CurrentBuffer();
+  if (buffer->count.load(std::memory_order_relaxed) + buffer->open + 1 > buffer->capacity) {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  EventArg arg = {key, nullptr, value};
+  Append(buffer, 'i', category, name, &arg, key ? 1 : 0);
+}
+
+void SetThreadName(const char *name) {
+  t_threadName = name;
+  if (t_buffer)
+    t_buffer->name = name;
+}
+
+bool Start(const std::string &path, size_t capacity) {
+  if (IsEnabled() || capacity < 2)
+    return false;
+  s_path = path;
+  s_capacity = capacity;
+  s_startNs = NowNs();
+  s_bytes = 0;
+  s_session.fetch_add(1, std::memory_order_release);
+  CurrentBuffer(); // Preallocate the caller's buffer
+  g_enabled.store(true, std::memory_order_release);
+  return true;
+}
+
+/*****************************************************************************
+ * JSON writer
+ *****************************************************************************/
+static void WriteString(FILE *file, const char *text) {
+  fputc('"', file);
+  for (const unsigned char *p = (const unsigned char *)text; *p; p++) {
+    if (*p == '"' || *p == '\\') {
+      fputc('\\', file);
+      fputc(*p, file);
+    } else if (*p < 0x20) {
+      fprintf(file, "\\u%04x", *p);
+    } else {
+      fputc(*p, file);
+    }
+  }
+  fputc('"', file);
+}
+
+static void WriteEvent(FILE *file, const Event &event, uint32_t tid) {
+  fputs(",\n{\"name\":", file);
+  WriteString(file, event.name);
+  fputs(",\"cat\":", file);
+  WriteString(file, event.category);
+  fprintf(file, ",\"ph\":\"%c\",\"ts\":%llu.%03u,\"pid\":1,\"tid\":%u", event.phase,
+          (unsigned long long)(event.timeNs / 1000), (unsigned)(event.timeNs % 1000), tid);
+  if (event.phase == 'i')
+    fputs(",\"s\":\"t\"", file);
+  if (event.argCount > 0) {
+    fputs(",\"args\":{", file);
+    for (int i = 0; i < event.argCount; i++) {
+      const EventArg &arg = event.args[i];
+      if (i > 0)
+        fputc(',', file);
+      WriteString(file, arg.key ? arg.key : "");
+      fputc(':', file);
+      if (arg.text)
+        WriteString(file, arg.text);
+      else
+        fprintf(file, "%lld", (long long)arg.value);
+    }
+    fputc('}', file);
+  }
+  fputc('}', file);
+}
+
+bool Stop() {
+  if (!g_enabled.exchange(false))
+    return false;
+  uint32_t session = s_session.load();
+  FILE *file = fopen(s_path.c_str(), "wb");
+  if (!file)
+    return false;
+  std::vector<char> streamBuffer(1 << 16);
+  setvbuf(file, streamBuffer.data(), _IOFBF, streamBuffer.size());
+
+  uint64_t dropped = 0;
+  fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"AnchorSnap\"}}",
+        file);
+  std::lock_guard<std::mutex> lock(s_mutex);
+  for (const auto &buffer : s_buffers) {
+    if (buffer->session.load(std::memory_order_acquire) != session)
+      continue;
+    const char *name = buffer->name.load();
+    char fallback[32];
+    snprintf(fallback, sizeof(fallback), "thread %u", buffer->tid);
+    fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+            buffer->tid);
+    WriteString(file, name ? name : fallback);
+    fputs("}}", file);
+
+    size_t count = buffer->count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; i++)
+      WriteEvent(file, buffer->events[i], buffer->tid);
+    dropped += buffer->dropped.load(std::memory_order_relaxed);
+  }
+  fprintf(file, "\n],\"otherData\":{\"dropped\":%llu,\"capacity\":%llu}}\n",
+          (unsigned long long)dropped, (unsigned long long)s_capacity);
+  bool ok = !ferror(file);
+  s_bytes = (uint64_t)ftell(file);
+  ok = fclose(file) == 0 && ok;
+  return ok;
+}
+
+Stats GetStats() {
+  Stats stats;
+  uint32_t session = s_session.load();
+  std::lock_guard<std::mutex> lock(s_mutex);
+  for (const auto &buffer : s_buffers) {
+    if (session == 0 || buffer->session.load(std::memory_order_acquire) != session)
+      continue;
+    stats.threads++;
+    stats.events += buffer->count.load(std::memory_order_acquire);
+    stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+  }
+  stats.bytes = s_bytes;
+  return stats;
+}
+
+} // namespace Tracer
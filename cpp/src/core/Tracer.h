@@ -0,0 +1,118 @@
+/*****************************************************************************
+ * Tracer.h
+ *
+ * Opt-in timeline tracer (Chrome trace_event JSON, opens in Perfetto or
+ * chrome://tracing)
+ *
+ * The profiler aggregates; the tracer keeps every begin / end event with
+ * its thread and arguments, so one slow IdleHook tick can be followed
+ * through its script calls and window paints.
+ *
+ *   TRACE_SCOPE("paint", "GridUI::DrawGrid");     // Until the end of the block
+ *
+ *   Tracer::Scope scope("script", "script.host"); // With arguments (on End)
+ *   scope.Arg("bytesIn", size);
+ *
+ * Each thread records into its own preallocated buffer (no lock, no
+ * allocation per event); Stop() streams all buffers to the JSON file.
+ * When a buffer is full new scopes are dropped and counted, but every
+ * recorded begin keeps room for its end.
+ *
+ * Disabled (the default) a probe is one atomic load. Names, categories,
+ * argument keys and text arguments are stored as pointers: use literals or
+ * __func__. Platform-neutral.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Tracer {
+
+extern std::atomic<bool> g_enabled;
+
+inline bool IsEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+// Events per thread buffer (~100 bytes each, ~6.5 MB)
+const size_t DEFAULT_CAPACITY = 65536;
+
+const int MAX_ARGS = 3; // Per event
+
+struct EventArg {
+  const char *key;
+  const char *text; // nullptr: numeric value
+  int64_t value;
+};
+
+/**
+ * Start a session. The calling thread's buffer is allocated here, other
+ * threads allocate theirs on their first event.
+ * @param path      JSON output written by Stop()
+ * @param capacity  events per thread
+ */
+bool Start(const std::string &path, size_t capacity = DEFAULT_CAPACITY);
+
+/**
+ * End the session and write the JSON file
+ * @return false if nothing was running or the file cannot be written
+ */
+bool Stop();
+
+// Thread name shown in the viewer (calling thread, literal)
+void SetThreadName(const char *name);
+
+struct Stats {
+  uint64_t events = 0;  // Recorded in the last / current session
+  uint64_t dropped = 0; // Scopes / instants lost to full buffers
+  uint32_t threads = 0; // Threads that recorded
+  uint64_t bytes = 0;   // JSON bytes written by the last Stop()
+};
+Stats GetStats();
+
+class Scope {
+public:
+  Scope(const char *category, const char *name) {
+    if (IsEnabled())
+      Begin(category, name);
+  }
+  ~Scope() {
+    if (m_session)
+      End();
+  }
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+  // Arguments for the end event (ignored while not recording)
+  void Arg(const char *key, int64_t value) {
+    if (m_session && m_argCount < MAX_ARGS)
+      m_args[m_argCount++] = {key, nullptr, value};
+  }
+  void Arg(const char *key, const char *text) {
+    if (m_session && m_argCount < MAX_ARGS)
+      m_args[m_argCount++] = {key, text ? text : "", 0};
+  }
+
+private:
+  void Begin(const char *category, const char *name);
+  void End();
+
+  const char *m_category = nullptr;
+  const char *m_name = nullptr;
+  uint32_t m_session = 0; // 0 = not recorded
+  int m_argCount = 0;
+  EventArg m_args[MAX_ARGS];
+};
+
+// Instant event ("i") with one optional argument
+void Instant(const char *category, const char *name, const char *key = nullptr,
+             int64_t value = 0);
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(category, name)                                                                \
+  Tracer::Scope TRACE_CONCAT(traceScope_, __LINE__)(category, name)
+
+} // namespace Tracer
@@ -0,0 +1,268 @@
+/*****************************************************************************
+ * WireFormat.cpp
+ *
+ * Length-prefixed record format (see WireFormat.h)
+ *****************************************************************************/
+
+#include "WireFormat.h"
+#include "ScriptResult.h"
+
+#include <cmath>
+
+namespace WireFormat {
+
+// Bytes taken by one UTF-8 sequence and the UTF-16 units it stands for.
+// Stray continuation bytes count as one unit, like the host's replacement.
+static inline size_t SequenceLength(unsigned char lead, size_t &units) {
+  units = 1;
+  if (lead < 0x80)
+    return 1;
+  if ((lead & 0xE0) == 0xC0)
+    return 2;
+  if ((lead & 0xF0) == 0xE0)
+    return 3;
+  if ((lead & 0xF8) == 0xF0) {
+    units = 2;
+    return 4;
+  }
+  return 1;
+}
+
+size_t Utf16Length(std::string_view utf8) {
+  size_t units = 0;
+  for (size_t i = 0; i < utf8.size();) {
+    size_t n = 0;
+    i += SequenceLength((unsigned char)utf8[i], n);
+    units += n;
+  }
+  return units;
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+bool Reader::Fail() {
+  m_failed = true;
+  m_fieldCount = 0;
+  m_pos = m_data.size();
+  return false;
+}
+
+bool Reader::ReadLength(size_t &value) {
+  value = 0;
+  size_t digits = 0;
+  while (m_pos < m_data.size() && m_data[m_pos] >= '0' && m_data[m_pos] <= '9') {
+    value = value * 10 + (size_t)(m_data[m_pos] - '0');
+    if (++digits > 9)
+      return false; // Larger than any script result
+    m_pos++;
+  }
+  if (digits == 0 || m_pos >= m_data.size() || m_data[m_pos] != ':')
+    return false;
+  m_pos++;
+  return true;
+}
+
+bool Reader::Next() {
+  m_fieldCount = 0;
+  if (m_failed || m_pos >= m_data.size())
+    return false;
+
+  if (m_data[m_pos++] != 'R')
+    return Fail();
+  size_t count = 0;
+  if (!ReadLength(count) || count > MAX_FIELDS)
+    return Fail();
+
+  for (size_t f = 0; f < count; f++) {
+    if (m_pos >= m_data.size())
+      return Fail();
+    char tag = m_data[m_pos++];
+    size_t length = 0;
+    if (!ReadLength(length))
+      return Fail();
+
+    size_t start = m_pos;
+    if (tag == FIELD_STRING) {
+      // Length is in UTF-16 units: walk the UTF-8 payload to find its end
+      size_t units = 0;
+      while (units < length) {
+        if (m_pos >= m_data.size())
+          return Fail();
+        size_t n = 0;
+        m_pos += SequenceLength((unsigned char)m_data[m_pos], n);
+        units += n;
+      }
+      if (units != length || m_pos > m_data.size())
+        return Fail();
+    } else if (tag == FIELD_FIXED || tag == FIELD_DOUBLE || tag == FIELD_INT ||
+               tag == FIELD_BOOL) {
+      if (length > m_data.size() - m_pos)
+        return Fail();
+      m_pos += length;
+    } else {
+      return Fail();
+    }
+    m_types[f] = (FieldType)tag;
+    m_fields[f] = m_data.substr(start, m_pos - start);
+  }
+  m_fieldCount = count;
+  return true;
+}
+
+std::string_view Reader::String(size_t index) const {
+  return Type(index) == FIELD_STRING ? m_fields[index] : std::string_view();
+}
+
+size_t Reader::StringInto(size_t index, wchar_t *out, size_t outCount) const {
+  return ScriptResult::WidenInto(String(index), out, outCount);
+}
+
+std::wstring Reader::WideString(size_t index) const {
+  return ScriptResult::Widen(String(index));
+}
+
+// Signed decimal integer (at most 18 digits)
+static bool ParseInteger(std::string_view s, int64_t &value) {
+  size_t i = 0;
+  bool negative = false;
+  if (i < s.size() && s[i] == '-') {
+    negative = true;
+    i++;
+  }
+  if (i >= s.size() || s.size() - i > 18)
+    return false;
+  int64_t v = 0;
+  for (; i < s.size(); i++) {
+    if (s[i] < '0' || s[i] > '9')
+      return false;
+    v = v * 10 + (s[i] - '0');
+  }
+  value = negative ? -v : v;
+  return true;
+}
+
+bool Reader::RawInteger(size_t index, int64_t &value) const {
+  return ParseInteger(m_fields[index], value);
+}
+
+double Reader::Number(size_t index, double fallback) const {
+  FieldType type = Type(index);
+  int64_t v = 0;
+  if (type == FIELD_DOUBLE) {
+    std::string_view s = m_fields[index];
+    size_t p = s.find('p');
+    int64_t exponent = 0;
+    if (p == std::string_view::npos || !ParseInteger(s.substr(0, p), v) ||
+        !ParseInteger(s.substr(p + 1), exponent) || exponent < -1200 || exponent > 1100)
+      return fallback;
+    double value = std::ldexp((double)v, (int)exponent);
+    return std::isfinite(value) ? value : fallback;
+  }
+  if ((type != FIELD_FIXED && type != FIELD_INT) || !RawInteger(index, v))
+    return fallback;
+  return type == FIELD_FIXED ? (double)v / (double)FIXED_SCALE : (double)v;
+}
+
+int Reader::Int(size_t index, int fallback) const {
+  double v = Number(index, fallback);
+  if (v > 2147483647.0 || v < -2147483648.0)
+    return fallback;
+  return (int)(v < 0 ? std::ceil(v) : std::floor(v));
+}
+
+bool Reader::Bool(size_t index, bool fallback) const {
+  if (Type(index) != FIELD_BOOL || m_fields[index].size() != 1)
+    return fallback;
+  return m_fields[index][0] == '1';
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+static void AppendUnsigned(std::string &out, uint64_t v) {
+  char tmp[24];
+  size_t n = 0;
+  do {
+    tmp[n++] = (char)('0' + v % 10);
+    v /= 10;
+  } while (v);
+  while (n)
+    out += tmp[--n];
+}
+
+void Writer::BeginRecord(size_t fieldCount) {
+  m_out += 'R';
+  AppendUnsigned(m_out, fieldCount);
+  m_out += ':';
+}
+
+void Writer::Field(char tag, std::string_view payload) {
+  m_out += tag;
+  AppendUnsigned(m_out, payload.size());
+  m_out += ':';
+  m_out.append(payload.data(), payload.size());
+}
+
+void Writer::String(std::string_view utf8) {
+  m_out += (char)FIELD_STRING;
+  AppendUnsigned(m_out, Utf16Length(utf8));
+  m_out += ':';
+  m_out.append(utf8.data(), utf8.size());
+}
+
+void Writer::Int(int64_t value) {
+  std::string digits;
+  if (value < 0)
+    digits += '-';
+  AppendUnsigned(digits, value < 0 ? 0ULL - (uint64_t)value : (uint64_t)value);
+  Field(FIELD_INT, digits);
+}
+
+void Writer::Fixed(double value) {
+  // Same clamp/rounding as the ExtendScript encoder (wNum)
+  if (!std::isfinite(value))
+    value = 0.0;
+  if (value > 1e11)
+    value = 1e11;
+  if (value < -1e11)
+    value = -1e11;
+  int64_t scaled = (int64_t)std::floor(value * (double)FIXED_SCALE + 0.5);
+  std::string digits;
+  if (scaled < 0)
+    digits += '-';
+  AppendUnsigned(digits, scaled < 0 ? 0ULL - (uint64_t)scaled : (uint64_t)scaled);
+  Field(FIELD_FIXED, digits);
+}
+
+void Writer::Double(double value) {
+  // Same encoding as wDbl: 53-bit integer mantissa without trailing zero
+  // bits, binary exponent
+  if (!std::isfinite(value) || value == 0.0) {
+    Field(FIELD_DOUBLE, "0p0");
+    return;
+  }
+  int exponent = 0;
+  double mantissa = std::ldexp(std::frexp(value, &exponent), 53);
+  exponent -= 53;
+  int64_t m = (int64_t)mantissa;
+  while ((m & 1) == 0) {
+    m /= 2;
+    exponent++;
+  }
+  std::string digits;
+  if (m < 0)
+    digits += '-';
+  AppendUnsigned(digits, m < 0 ? 0ULL - (uint64_t)m : (uint64_t)m);
+  digits += 'p';
+  if (exponent < 0)
+    digits += '-';
+  AppendUnsigned(digits, (uint64_t)(exponent < 0 ? -exponent : exponent));
+  Field(FIELD_DOUBLE, digits);
+}
+
+void Writer::Bool(bool value) { Field(FIELD_BOOL, value ? "1" : "0"); }
+
+} // namespace WireFormat
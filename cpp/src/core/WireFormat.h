@@ -0,0 +1,299 @@
+/*****************************************************************************
+ * WireFormat.h
+ *
+ * Length-prefixed record format for ExtendScript -> C++ results
+ *
+ * Layout (ASCII framing, UTF-8 payloads):
+ *   message = record*
+ *   record  = 'R' <fieldCount> ':' field*
+ *   field   = <tag> <length> ':' <payload>
+ *     's'  string, length in UTF-16 code units (ExtendScript String.length)
+ *     'f'  fixed-point number, payload = round(value * FIXED_SCALE)
+ *     'd'  exact double, payload = <integer mantissa> 'p' <binary exponent>
+ *          (mantissa * 2^exponent: no rounding, no locale; the encoders
+ *          drop trailing zero bits, so 0.5 is "1p-1")
+ *     'i'  integer
+ *     'b'  bool, payload "0" / "1"
+ *
+ * Payloads are never scanned for delimiters, so '|', ';', '"' or any other
+ * character in an effect, font or layer name cannot break the parse.
+ * The ExtendScript encoder lives in ScriptLibrary (wStr/wNum/wDbl/wInt/
+ * wBool/wRec); Writer is the C++ equivalent (mocks, benchmarks, caches).
+ *
+ * Reader is single-pass and allocation-free: fields are views into the
+ * result text (ScriptResult::Result or the batched std::string).
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace WireFormat {
+
+// Fixed-point scale for 'f' fields (4 decimal places)
+const int64_t FIXED_SCALE = 10000;
+
+// Fields per record (largest record: shapeInfo)
+const size_t MAX_FIELDS = 32;
+
+enum FieldType : char {
+  FIELD_NONE = 0,
+  FIELD_STRING = 's',
+  FIELD_FIXED = 'f',
+  FIELD_DOUBLE = 'd',
+  FIELD_INT = 'i',
+  FIELD_BOOL = 'b',
+};
+
+/**
+ * Record reader
+ *   WireFormat::Reader reader(result.View());
+ *   while (reader.Next()) { reader.String(0); reader.Float(1, 0.0f); ... }
+ *   if (reader.Failed()) { ... malformed input ... }
+ * Typed getters return the fallback for missing or mistyped fields.
+ */
+class Reader {
+public:
+  explicit Reader(std::string_view data) : m_data(data) {}
+
+  // Advance to the next record; false at the end or on malformed input
+  bool Next();
+
+  // True if parsing stopped on malformed input
+  bool Failed() const { return m_failed; }
+
+  size_t FieldCount() const { return m_fieldCount; }
+  FieldType Type(size_t index) const {
+    return index < m_fieldCount ? m_types[index] : FIELD_NONE;
+  }
+
+  // UTF-8 payload of a string field ("" otherwise)
+  std::string_view String(size_t index) const;
+
+  // String field widened into a fixed wchar_t buffer (see ScriptResult)
+  size_t StringInto(size_t index, wchar_t *out, size_t outCount) const;
+  std::wstring WideString(size_t index) const;
+
+  // Numeric fields ('f', 'd' or 'i')
+  double Number(size_t index, double fallback) const;
+  float Float(size_t index, float fallback) const {
+    return (float)Number(index, fallback);
+  }
+  int Int(size_t index, int fallback) const;
+
+  bool Bool(size_t index, bool fallback) const;
+
+private:
+  bool Fail();
+  bool ReadLength(size_t &value);
+  bool RawInteger(size_t index, int64_t &value) const;
+
+  std::string_view m_data;
+  size_t m_pos = 0;
+  bool m_failed = false;
+  size_t m_fieldCount = 0;
+  FieldType m_types[MAX_FIELDS] = {};
+  std::string_view m_fields[MAX_FIELDS];
+};
+
+/**
+ * Record writer (C++ counterpart of the ExtendScript encoder)
+ * BeginRecord(n) must be followed by exactly n fields.
+ */
+class Writer {
+public:
+  explicit Writer(std::string &out) : m_out(out) {}
+
+  void BeginRecord(size_t fieldCount);
+  void String(std::string_view utf8);
+  void Fixed(double value);
+  void Double(double value);
+  void Int(int64_t value);
+  void Bool(bool value);
+
+private:
+  void Field(char tag, std::string_view payload);
+
+  std::string &m_out;
+};
+
+// UTF-16 code units of a UTF-8 string (the 's' field length)
+size_t Utf16Length(std::string_view utf8);
+
+/*****************************************************************************
+ * Record layouts (field order of the ScriptLibrary info functions)
+ *****************************************************************************/
+
+// hostInfo(): one record, plug-in folders from HOST_PLUGIN_FOLDER onward
+enum HostField {
+  HOST_BUILD = 0,
+  HOST_LANGUAGE,
+  HOST_PLUGIN_FOLDER
+};
+
+// selectionContext(): one header record, then one record per selected layer
+enum ContextField {
+  CONTEXT_COMP_ID = 0,
+  CONTEXT_VIEWER,
+  CONTEXT_TEXT_TOOL,
+  CONTEXT_SELECTED_COUNT,
+  CONTEXT_FIELD_COUNT
+};
+enum SelectedLayerField {
+  SELECTED_INDEX = 0,
+  SELECTED_ID,
+  SELECTED_KIND,
+  SELECTED_FIELD_COUNT
+};
+
+// panelSnapshot(): one record, each field the full result of one info call
+enum PanelField {
+  PANEL_CONTEXT = 0, // selectionContext()
+  PANEL_TEXT,        // textInfo()
+  PANEL_SHAPE,       // shapeInfo()
+  PANEL_KEYFRAME,    // keyframeInfo()
+  PANEL_LAYER,       // layerInfo()
+  PANEL_FIELD_COUNT
+};
+
+// effectsList(): one record per installed effect
+// layerEffects(): one record per effect on the first selected layer
+enum EffectField {
+  EFFECT_NAME = 0,
+  EFFECT_MATCH_NAME,
+  EFFECT_CATEGORY_OR_INDEX, // category (effectsList) / 0-based index (layerEffects)
+  EFFECT_FIELD_COUNT
+};
+
+// fontsList() / fontsOf(): one record per font
+enum FontField {
+  FONT_FAMILY = 0,
+  FONT_STYLE,
+  FONT_POSTSCRIPT_NAME,
+  FONT_FIELD_COUNT
+};
+
+// fontFamilies(): one record per font family (font catalog revalidation)
+enum FontFamilyField {
+  FAMILY_NAME = 0,
+  FAMILY_FONT_COUNT
+};
+
+// keyframeInfo(): every selected property with two or more selected keys,
+// a KeyframePropField record followed by one KeyframeField record per
+// selected key (one KeyframeDimField group per temporal ease dimension
+// from KEY_DIMENSION onward)
+enum KeyframePropField {
+  KEY_PROP_NAME = 0,
+  KEY_PROP_MATCH_NAME,
+  KEY_PROP_POSITION,   // Index in comp.selectedProperties
+  KEY_PROP_DIMENSIONS, // Temporal ease dimensions (1 for spatial / 1D)
+  KEY_PROP_KEY_COUNT,  // Key records that follow
+  KEY_PROP_FIELD_COUNT
+};
+enum KeyframeField {
+  KEY_INDEX = 0,
+  KEY_TIME,
+  KEY_IN_TYPE,     // 1 linear, 2 bezier, 3 hold (EaseModel::Interpolation)
+  KEY_OUT_TYPE,
+  KEY_DIMENSION
+};
+enum KeyframeDimField {
+  KEY_DIM_DELTA = 0, // Value change to the next selected key (spatial: path length)
+  KEY_DIM_IN_SPEED,
+  KEY_DIM_IN_INFLUENCE,
+  KEY_DIM_OUT_SPEED,
+  KEY_DIM_OUT_INFLUENCE,
+  KEY_DIM_FIELD_COUNT
+};
+
+// applyEase() argument (C++ -> script, KeyframeSelection::BuildApply):
+// an EasePropField record per property, then one EasePairField record per
+// key pair with one EaseDimField group per dimension from EASE_DIMENSION on
+enum EasePropField {
+  EASE_PROP_MATCH_NAME = 0,
+  EASE_PROP_POSITION,
+  EASE_PROP_DIMENSIONS,
+  EASE_PROP_FIELD_COUNT
+};
+enum EasePairField {
+  EASE_KEY1 = 0,
+  EASE_KEY2,
+  EASE_DIMENSION
+};
+enum EaseDimField {
+  EASE_DIM_OUT_SPEED = 0,
+  EASE_DIM_OUT_INFLUENCE,
+  EASE_DIM_IN_SPEED,
+  EASE_DIM_IN_INFLUENCE,
+  EASE_DIM_FIELD_COUNT
+};
+
+// textInfo(): one record for the first selected text layer
+enum TextField {
+  TEXT_FONT = 0,
+  TEXT_FONT_STYLE,
+  TEXT_FONT_SIZE,
+  TEXT_TRACKING,
+  TEXT_LEADING,
+  TEXT_STROKE_WIDTH,
+  TEXT_FILL_R,
+  TEXT_FILL_G,
+  TEXT_FILL_B,
+  TEXT_STROKE_R,
+  TEXT_STROKE_G,
+  TEXT_STROKE_B,
+  TEXT_APPLY_FILL,
+  TEXT_APPLY_STROKE,
+  TEXT_JUSTIFY,
+  TEXT_LAYER_NAME,
+  TEXT_FIELD_COUNT
+};
+
+// shapeInfo(): one record for the first group of the selected shape layer
+enum ShapeField {
+  SHAPE_LAYER_NAME = 0,
+  SHAPE_NAME,
+  SHAPE_TYPE,
+  SHAPE_HAS_FILL,
+  SHAPE_HAS_STROKE,
+  SHAPE_FILL_R,
+  SHAPE_FILL_G,
+  SHAPE_FILL_B,
+  SHAPE_STROKE_R,
+  SHAPE_STROKE_G,
+  SHAPE_STROKE_B,
+  SHAPE_STROKE_WIDTH,
+  SHAPE_OPACITY,
+  SHAPE_SIZE_W,
+  SHAPE_SIZE_H,
+  SHAPE_ROUNDNESS,
+  SHAPE_ANCHOR_X,
+  SHAPE_ANCHOR_Y,
+  SHAPE_IS_PARAMETRIC,
+  SHAPE_SIZE_LINK,
+  SHAPE_BOUNDS_LEFT,
+  SHAPE_BOUNDS_TOP,
+  SHAPE_BOUNDS_WIDTH,
+  SHAPE_BOUNDS_HEIGHT,
+  SHAPE_FIELD_COUNT
+};
+
+// layerInfo(): one record for the first selected layer
+enum LayerField {
+  LAYER_NAME = 0,
+  LAYER_TYPE,
+  LAYER_INDEX,
+  LAYER_HAS_PARENT,
+  LAYER_PARENT_INDEX,
+  LAYER_IS_SELECTED,
+  LAYER_SOLID_COLOR,
+  LAYER_IS_SEQUENCE,
+  LAYER_HAS_TIME_REMAP,
+  LAYER_FIELD_COUNT
+};
+
+} // namespace WireFormat
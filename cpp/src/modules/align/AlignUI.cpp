@@ -6,12 +6,15 @@
  *****************************************************************************/
 
 #include "AlignUI.h"
+#include "Profiler.h"
+#include "Tracer.h"
 
 #ifdef MSWindows
 #include <windows.h>
 #include <windowsx.h>  // GET_X_LPARAM, GET_Y_LPARAM
 #include <gdiplus.h>
 #pragma comment(lib, "gdiplus.lib")
+#include "RenderContext.h"
 
 using namespace Gdiplus;
 
@@ -61,7 +64,8 @@ static const Color COLOR_CLOSE_HOVER(255, 200, 60, 60);
 // Global state
 static HWND g_hwnd = NULL;
 static bool g_visible = false;
-static ULONG_PTR g_gdiplusToken = 0;
+static bool g_renderAcquired = false;
+static RenderContext::Backbuffer g_backbuffer;
 static FunctionMode g_funcMode = FUNC_ALIGN;
 static ReferenceMode g_refMode = REF_SELECTION;
 static AlignResult g_result;
@@ -100,16 +104,15 @@ static void HandleKeyboard(WPARAM key);
 /*****************************************************************************
  * Initialize
  *****************************************************************************/
-void Initialize() {
-    if (g_hwnd) return;
+bool Initialize() {
+    if (g_hwnd) return true;
 
-    // Initialize GDI+
-    GdiplusStartupInput gdiplusStartupInput;
-    Status gdipStatus = GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, NULL);
-    if (gdipStatus != Ok) {
+    // Join the shared GDI+ session
+    if (!RenderContext::Acquire()) {
         // GDI+ initialization failed - cannot proceed
-        return;
+        return false;
     }
+    g_renderAcquired = true;
 
     // Register window class (explicitly use Wide version for Unicode strings)
     WNDCLASSEXW wc = {0};
@@ -123,9 +126,9 @@ void Initialize() {
     ATOM classAtom = RegisterClassExW(&wc);
     if (classAtom == 0 && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
         // Registration failed and class doesn't exist
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
-        return;
+        RenderContext::Release();
+        g_renderAcquired = false;
+        return false;
     }
 
     // Create window (initially hidden)
@@ -140,13 +143,14 @@ void Initialize() {
 
     if (!g_hwnd) {
         // Window creation failed
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
-        return;
+        RenderContext::Release();
+        g_renderAcquired = false;
+        return false;
     }
 
     // Set layered window for transparency
     SetLayeredWindowAttributes(g_hwnd, 0, 255, LWA_ALPHA);
+    return true;
 }
 
 /*****************************************************************************
@@ -157,9 +161,10 @@ void Shutdown() {
         DestroyWindow(g_hwnd);
         g_hwnd = NULL;
     }
-    if (g_gdiplusToken) {
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
+    g_backbuffer.Release();
+    if (g_renderAcquired) {
+        RenderContext::Release();
+        g_renderAcquired = false;
     }
 }
 
@@ -292,25 +297,20 @@ void SetReferenceMode(ReferenceMode mode) { g_refMode = mode; }
 static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
     case WM_PAINT: {
+        TRACE_SCOPE("paint", "AlignUI::Draw");
+        PROFILE_SCOPE("paint.align");
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
 
-        // Double buffering
+        // Double buffering (buffer kept across paints)
         RECT rect;
         GetClientRect(hwnd, &rect);
-        HDC memDC = CreateCompatibleDC(hdc);
-        HBITMAP memBitmap = CreateCompatibleBitmap(hdc, rect.right, rect.bottom);
-        HGDIOBJ oldBitmap = SelectObject(memDC, memBitmap);
+        HDC memDC = g_backbuffer.Begin(hdc, rect.right, rect.bottom);
 
         Draw(memDC);
 
         // Copy to screen
-        BitBlt(hdc, 0, 0, rect.right, rect.bottom, memDC, 0, 0, SRCCOPY);
-
-        // Cleanup
-        SelectObject(memDC, oldBitmap);
-        DeleteObject(memBitmap);
-        DeleteDC(memDC);
+        g_backbuffer.Present(hdc, rect.right, rect.bottom);
 
         EndPaint(hwnd, &ps);
         return 0;
@@ -389,12 +389,12 @@ static void Draw(HDC hdc) {
     g.ScaleTransform(g_scaleFactor, g_scaleFactor);
 
     // Background
-    SolidBrush bgBrush(COLOR_BG);
-    g.FillRectangle(&bgBrush, 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+    const SolidBrush *bgBrush = RenderContext::Brush(COLOR_BG);
+    g.FillRectangle(bgBrush, 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
 
     // Border
-    Pen borderPen(Color(255, 60, 60, 70), 1);
-    g.DrawRectangle(&borderPen, 0, 0, WINDOW_WIDTH - 1, WINDOW_HEIGHT - 1);
+    const Pen *borderPen = RenderContext::Pen(Color(255, 60, 60, 70), 1);
+    g.DrawRectangle(borderPen, 0, 0, WINDOW_WIDTH - 1, WINDOW_HEIGHT - 1);
 
     // Header
     DrawHeader(g);
@@ -412,14 +412,11 @@ static void Draw(HDC hdc) {
  *****************************************************************************/
 static void DrawHeader(Graphics& g) {
     // Header background
-    SolidBrush headerBrush(COLOR_HEADER_BG);
-    g.FillRectangle(&headerBrush, 0, 0, WINDOW_WIDTH, HEADER_HEIGHT);
+    const SolidBrush *headerBrush = RenderContext::Brush(COLOR_HEADER_BG);
+    g.FillRectangle(headerBrush, 0, 0, WINDOW_WIDTH, HEADER_HEIGHT);
 
-    FontFamily fontFamily(L"Segoe UI");
-    Font font(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    StringFormat sf;
-    sf.SetAlignment(StringAlignmentCenter);
-    sf.SetLineAlignment(StringAlignmentCenter);
+    const Font *font = RenderContext::Font(10);
+    const StringFormat *sf = RenderContext::Format(StringAlignmentCenter);
 
     // Left side: Align / Dist mode buttons
     int leftX = 8;
@@ -431,21 +428,21 @@ static void DrawHeader(Graphics& g) {
     g_alignModeRect = {leftX, btnY, leftX + btnW, btnY + btnH};
     Color alignColor = (g_funcMode == FUNC_ALIGN) ? COLOR_MODE_ACTIVE_BLUE :
                        (g_alignModeHover ? COLOR_BUTTON_HOVER : COLOR_MODE_INACTIVE);
-    SolidBrush alignBrush(alignColor);
-    g.FillRectangle(&alignBrush, leftX, btnY, btnW, btnH);
-    SolidBrush textBrush(COLOR_TEXT);
+    const SolidBrush *alignBrush = RenderContext::Brush(alignColor);
+    g.FillRectangle(alignBrush, leftX, btnY, btnW, btnH);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
     RectF alignRect((REAL)leftX, (REAL)btnY, (REAL)btnW, (REAL)btnH);
-    g.DrawString(L"Align", -1, &font, alignRect, &sf, &textBrush);
+    g.DrawString(L"Align", -1, font, alignRect, sf, textBrush);
 
     // Dist button
     leftX += btnW + 4;
     g_distModeRect = {leftX, btnY, leftX + btnW, btnY + btnH};
     Color distColor = (g_funcMode == FUNC_DISTRIBUTE) ? COLOR_MODE_ACTIVE_BLUE :
                       (g_distModeHover ? COLOR_BUTTON_HOVER : COLOR_MODE_INACTIVE);
-    SolidBrush distBrush(distColor);
-    g.FillRectangle(&distBrush, leftX, btnY, btnW, btnH);
+    const SolidBrush *distBrush = RenderContext::Brush(distColor);
+    g.FillRectangle(distBrush, leftX, btnY, btnW, btnH);
     RectF distRect((REAL)leftX, (REAL)btnY, (REAL)btnW, (REAL)btnH);
-    g.DrawString(L"Dist", -1, &font, distRect, &sf, &textBrush);
+    g.DrawString(L"Dist", -1, font, distRect, sf, textBrush);
 
     // Right side: Sel / Comp mode buttons
     int rightX = WINDOW_WIDTH - 8 - 24 - 4 - 24 - 8 - btnW;
@@ -454,48 +451,48 @@ static void DrawHeader(Graphics& g) {
     g_selModeRect = {rightX, btnY, rightX + btnW/2 + 4, btnY + btnH};
     Color selColor = (g_refMode == REF_SELECTION) ? COLOR_MODE_ACTIVE_BLUE :
                      (g_selModeHover ? COLOR_BUTTON_HOVER : COLOR_MODE_INACTIVE);
-    SolidBrush selBrush(selColor);
-    g.FillRectangle(&selBrush, rightX, btnY, btnW/2 + 4, btnH);
+    const SolidBrush *selBrush = RenderContext::Brush(selColor);
+    g.FillRectangle(selBrush, rightX, btnY, btnW/2 + 4, btnH);
     RectF selRect((REAL)rightX, (REAL)btnY, (REAL)(btnW/2 + 4), (REAL)btnH);
-    g.DrawString(L"Sel", -1, &font, selRect, &sf, &textBrush);
+    g.DrawString(L"Sel", -1, font, selRect, sf, textBrush);
 
     // Comp button
     rightX += btnW/2 + 4 + 4;
     g_compModeRect = {rightX, btnY, rightX + btnW/2 + 8, btnY + btnH};
     Color compColor = (g_refMode == REF_COMPOSITION) ? COLOR_MODE_ACTIVE_ORANGE :
                       (g_compModeHover ? COLOR_BUTTON_HOVER : COLOR_MODE_INACTIVE);
-    SolidBrush compBrush(compColor);
-    g.FillRectangle(&compBrush, rightX, btnY, btnW/2 + 8, btnH);
+    const SolidBrush *compBrush = RenderContext::Brush(compColor);
+    g.FillRectangle(compBrush, rightX, btnY, btnW/2 + 8, btnH);
     RectF compRect((REAL)rightX, (REAL)btnY, (REAL)(btnW/2 + 8), (REAL)btnH);
-    g.DrawString(L"Comp", -1, &font, compRect, &sf, &textBrush);
+    g.DrawString(L"Comp", -1, font, compRect, sf, textBrush);
 
     // Pin button
     rightX = WINDOW_WIDTH - 8 - 24 - 4 - 24;
     g_pinRect = {rightX, btnY, rightX + 20, btnY + btnH};
     Color pinColor = g_keepPanelOpen ? COLOR_PIN_ACTIVE :
                      (g_pinHover ? COLOR_BUTTON_HOVER : COLOR_MODE_INACTIVE);
-    SolidBrush pinBrush(pinColor);
-    g.FillRectangle(&pinBrush, rightX, btnY, 20, btnH);
+    const SolidBrush *pinBrush = RenderContext::Brush(pinColor);
+    g.FillRectangle(pinBrush, rightX, btnY, 20, btnH);
 
     // Pin icon (simple pushpin shape)
-    Pen pinPen(g_keepPanelOpen ? Color(255, 40, 40, 40) : COLOR_TEXT, 1.5f);
+    const Pen *pinPen = RenderContext::Pen(g_keepPanelOpen ? Color(255, 40, 40, 40) : COLOR_TEXT, 1.5f);
     int px = rightX + 10, py = btnY + 11;
-    g.DrawLine(&pinPen, px - 4, py - 4, px + 4, py + 4);
-    g.DrawLine(&pinPen, px, py - 6, px, py + 6);
-    g.DrawEllipse(&pinPen, px - 3, py - 8, 6, 6);
+    g.DrawLine(pinPen, px - 4, py - 4, px + 4, py + 4);
+    g.DrawLine(pinPen, px, py - 6, px, py + 6);
+    g.DrawEllipse(pinPen, px - 3, py - 8, 6, 6);
 
     // Close button
     rightX = WINDOW_WIDTH - 8 - 24;
     g_closeRect = {rightX, btnY, rightX + 20, btnY + btnH};
     Color closeColor = g_closeHover ? COLOR_CLOSE_HOVER : COLOR_MODE_INACTIVE;
-    SolidBrush closeBrush(closeColor);
-    g.FillRectangle(&closeBrush, rightX, btnY, 20, btnH);
+    const SolidBrush *closeBrush = RenderContext::Brush(closeColor);
+    g.FillRectangle(closeBrush, rightX, btnY, 20, btnH);
 
     // X icon
-    Pen closePen(COLOR_TEXT, 1.5f);
+    const Pen *closePen = RenderContext::Pen(COLOR_TEXT, 1.5f);
     int cx = rightX + 10, cy = btnY + btnH/2;
-    g.DrawLine(&closePen, cx - 4, cy - 4, cx + 4, cy + 4);
-    g.DrawLine(&closePen, cx + 4, cy - 4, cx - 4, cy + 4);
+    g.DrawLine(closePen, cx - 4, cy - 4, cx + 4, cy + 4);
+    g.DrawLine(closePen, cx + 4, cy - 4, cx - 4, cy + 4);
 }
 
 /*****************************************************************************
@@ -545,14 +542,14 @@ static void DrawDistributeButtons(Graphics& g) {
 static void DrawAlignIcon(Graphics& g, int index, RECT& rect, bool hover) {
     // Button background
     Color bgColor = hover ? COLOR_BUTTON_HOVER : COLOR_BUTTON_BG;
-    SolidBrush brush(bgColor);
-    g.FillRectangle(&brush, rect.left, rect.top,
+    const SolidBrush *brush = RenderContext::Brush(bgColor);
+    g.FillRectangle(brush, rect.left, rect.top,
                     rect.right - rect.left, rect.bottom - rect.top);
 
     // Icon
     Color iconColor = hover ? COLOR_ICON_HOVER : COLOR_ICON;
-    Pen pen(iconColor, 2.0f);
-    SolidBrush iconBrush(iconColor);
+    const Pen *pen = RenderContext::Pen(iconColor, 2.0f);
+    const SolidBrush *iconBrush = RenderContext::Brush(iconColor);
 
     int cx = (rect.left + rect.right) / 2;
     int cy = (rect.top + rect.bottom) / 2;
@@ -560,39 +557,39 @@ static void DrawAlignIcon(Graphics& g, int index, RECT& rect, bool hover) {
 
     switch (index) {
     case 0: // Left align - vertical line on left with horizontal lines
-        g.DrawLine(&pen, cx - 8, cy - 8, cx - 8, cy + 8);
-        g.FillRectangle(&iconBrush, cx - 8, cy - 6, 14, 4);
-        g.FillRectangle(&iconBrush, cx - 8, cy + 2, 10, 4);
+        g.DrawLine(pen, cx - 8, cy - 8, cx - 8, cy + 8);
+        g.FillRectangle(iconBrush, cx - 8, cy - 6, 14, 4);
+        g.FillRectangle(iconBrush, cx - 8, cy + 2, 10, 4);
         break;
 
     case 1: // Center H - vertical center line with centered rectangles
-        g.DrawLine(&pen, cx, cy - 10, cx, cy + 10);
-        g.FillRectangle(&iconBrush, cx - 7, cy - 6, 14, 4);
-        g.FillRectangle(&iconBrush, cx - 5, cy + 2, 10, 4);
+        g.DrawLine(pen, cx, cy - 10, cx, cy + 10);
+        g.FillRectangle(iconBrush, cx - 7, cy - 6, 14, 4);
+        g.FillRectangle(iconBrush, cx - 5, cy + 2, 10, 4);
         break;
 
     case 2: // Right align - vertical line on right with right-aligned lines
-        g.DrawLine(&pen, cx + 8, cy - 8, cx + 8, cy + 8);
-        g.FillRectangle(&iconBrush, cx - 6, cy - 6, 14, 4);
-        g.FillRectangle(&iconBrush, cx - 2, cy + 2, 10, 4);
+        g.DrawLine(pen, cx + 8, cy - 8, cx + 8, cy + 8);
+        g.FillRectangle(iconBrush, cx - 6, cy - 6, 14, 4);
+        g.FillRectangle(iconBrush, cx - 2, cy + 2, 10, 4);
         break;
 
     case 3: // Top align - horizontal line on top with top-aligned rectangles
-        g.DrawLine(&pen, cx - 8, cy - 8, cx + 8, cy - 8);
-        g.FillRectangle(&iconBrush, cx - 6, cy - 8, 4, 14);
-        g.FillRectangle(&iconBrush, cx + 2, cy - 8, 4, 10);
+        g.DrawLine(pen, cx - 8, cy - 8, cx + 8, cy - 8);
+        g.FillRectangle(iconBrush, cx - 6, cy - 8, 4, 14);
+        g.FillRectangle(iconBrush, cx + 2, cy - 8, 4, 10);
         break;
 
     case 4: // Middle V - horizontal center line with centered rectangles
-        g.DrawLine(&pen, cx - 10, cy, cx + 10, cy);
-        g.FillRectangle(&iconBrush, cx - 6, cy - 7, 4, 14);
-        g.FillRectangle(&iconBrush, cx + 2, cy - 5, 4, 10);
+        g.DrawLine(pen, cx - 10, cy, cx + 10, cy);
+        g.FillRectangle(iconBrush, cx - 6, cy - 7, 4, 14);
+        g.FillRectangle(iconBrush, cx + 2, cy - 5, 4, 10);
         break;
 
     case 5: // Bottom align - horizontal line on bottom
-        g.DrawLine(&pen, cx - 8, cy + 8, cx + 8, cy + 8);
-        g.FillRectangle(&iconBrush, cx - 6, cy - 6, 4, 14);
-        g.FillRectangle(&iconBrush, cx + 2, cy - 2, 4, 10);
+        g.DrawLine(pen, cx - 8, cy + 8, cx + 8, cy + 8);
+        g.FillRectangle(iconBrush, cx - 6, cy - 6, 4, 14);
+        g.FillRectangle(iconBrush, cx + 2, cy - 2, 4, 10);
         break;
     }
 }
@@ -603,46 +600,41 @@ static void DrawAlignIcon(Graphics& g, int index, RECT& rect, bool hover) {
 static void DrawDistIcon(Graphics& g, int index, RECT& rect, bool hover) {
     // Button background
     Color bgColor = hover ? COLOR_BUTTON_HOVER : COLOR_BUTTON_BG;
-    SolidBrush brush(bgColor);
-    g.FillRectangle(&brush, rect.left, rect.top,
+    const SolidBrush *brush = RenderContext::Brush(bgColor);
+    g.FillRectangle(brush, rect.left, rect.top,
                     rect.right - rect.left, rect.bottom - rect.top);
 
     // Icon and text
     Color iconColor = hover ? COLOR_ICON_HOVER : COLOR_ICON;
-    Pen pen(iconColor, 2.0f);
-    SolidBrush iconBrush(iconColor);
+    const Pen *pen = RenderContext::Pen(iconColor, 2.0f);
+    const SolidBrush *iconBrush = RenderContext::Brush(iconColor);
 
     int iconX = rect.left + 15;
     int cy = (rect.top + rect.bottom) / 2;
 
-    FontFamily fontFamily(L"Segoe UI");
-    Font font(&fontFamily, 11, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(hover ? COLOR_TEXT : COLOR_TEXT_DIM);
+    const Font *font = RenderContext::Font(11);
+    const SolidBrush *textBrush = RenderContext::Brush(hover ? COLOR_TEXT : COLOR_TEXT_DIM);
 
     if (index == 0) { // Horizontal distribute
         // Three vertical bars with equal spacing
-        g.FillRectangle(&iconBrush, iconX, cy - 10, 3, 20);
-        g.FillRectangle(&iconBrush, iconX + 12, cy - 10, 3, 20);
-        g.FillRectangle(&iconBrush, iconX + 24, cy - 10, 3, 20);
+        g.FillRectangle(iconBrush, iconX, cy - 10, 3, 20);
+        g.FillRectangle(iconBrush, iconX + 12, cy - 10, 3, 20);
+        g.FillRectangle(iconBrush, iconX + 24, cy - 10, 3, 20);
 
         // Text
         RectF textRect((REAL)(iconX + 40), (REAL)(rect.top), 70.0f, (REAL)(rect.bottom - rect.top));
-        StringFormat sf;
-        sf.SetAlignment(StringAlignmentNear);
-        sf.SetLineAlignment(StringAlignmentCenter);
-        g.DrawString(L"Horizontal", -1, &font, textRect, &sf, &textBrush);
+        const StringFormat *sf = RenderContext::Format(StringAlignmentNear);
+        g.DrawString(L"Horizontal", -1, font, textRect, sf, textBrush);
     } else { // Vertical distribute
         // Three horizontal bars with equal spacing
-        g.FillRectangle(&iconBrush, iconX, cy - 10, 20, 3);
-        g.FillRectangle(&iconBrush, iconX, cy - 2, 20, 3);
-        g.FillRectangle(&iconBrush, iconX, cy + 6, 20, 3);
+        g.FillRectangle(iconBrush, iconX, cy - 10, 20, 3);
+        g.FillRectangle(iconBrush, iconX, cy - 2, 20, 3);
+        g.FillRectangle(iconBrush, iconX, cy + 6, 20, 3);
 
         // Text
         RectF textRect((REAL)(iconX + 40), (REAL)(rect.top), 70.0f, (REAL)(rect.bottom - rect.top));
-        StringFormat sf;
-        sf.SetAlignment(StringAlignmentNear);
-        sf.SetLineAlignment(StringAlignmentCenter);
-        g.DrawString(L"Vertical", -1, &font, textRect, &sf, &textBrush);
+        const StringFormat *sf = RenderContext::Format(StringAlignmentNear);
+        g.DrawString(L"Vertical", -1, font, textRect, sf, textBrush);
     }
 }
 
@@ -841,7 +833,7 @@ static void HandleKeyboard(WPARAM key) {
 
 namespace AlignUI {
 
-void Initialize() {}
+bool Initialize() { return true; }
 void Shutdown() {}
 void ShowPanel(int x, int y) { (void)x; (void)y; }
 AlignResult HidePanel() { return AlignResult(); }
@@ -54,7 +54,8 @@ struct AlignResult {
 };
 
 // Initialize the Align UI system
-void Initialize();
+// @return false if GDI+ or the window (class) could not be created
+bool Initialize();
 
 // Cleanup
 void Shutdown();
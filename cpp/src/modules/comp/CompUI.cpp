@@ -8,6 +8,10 @@
 
 #include "CompUI.h"
 #include "GdiPlusIncludes.h"
+#include "WireFormat.h"
+#include "Profiler.h"
+#include "RenderContext.h"
+#include "Tracer.h"
 
 #ifdef MSWindows
 #include <windowsx.h>
@@ -131,7 +135,8 @@ static std::vector<const ActionDef*> g_currentActions;
 // Global state
 static HWND g_hwnd = NULL;
 static bool g_visible = false;
-static ULONG_PTR g_gdiplusToken = 0;
+static bool g_renderAcquired = false;
+static RenderContext::Backbuffer g_backbuffer;
 static LayerInfo g_layerInfo = {};
 static CompResult g_result;
 static bool g_keepPanelOpen = false;
@@ -168,15 +173,14 @@ static const wchar_t* GetLayerTypeName();
 /*****************************************************************************
  * Initialize
  *****************************************************************************/
-void Initialize() {
-    if (g_hwnd) return;
+bool Initialize() {
+    if (g_hwnd) return true;
 
-    // Initialize GDI+
-    GdiplusStartupInput gdiplusStartupInput;
-    Status gdipStatus = GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, NULL);
-    if (gdipStatus != Ok) {
-        return;
+    // Join the shared GDI+ session
+    if (!RenderContext::Acquire()) {
+        return false;
     }
+    g_renderAcquired = true;
 
     // Register window class
     WNDCLASSEXW wc = {0};
@@ -189,9 +193,9 @@ void Initialize() {
     wc.lpszClassName = L"CompUIWindow";
     ATOM classAtom = RegisterClassExW(&wc);
     if (classAtom == 0 && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
-        return;
+        RenderContext::Release();
+        g_renderAcquired = false;
+        return false;
     }
 
     // Create window (initially hidden) - NO WS_EX_NOACTIVATE, we need focus
@@ -205,12 +209,13 @@ void Initialize() {
     );
 
     if (!g_hwnd) {
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
-        return;
+        RenderContext::Release();
+        g_renderAcquired = false;
+        return false;
     }
 
     SetLayeredWindowAttributes(g_hwnd, 0, 255, LWA_ALPHA);
+    return true;
 }
 
 /*****************************************************************************
@@ -221,9 +226,10 @@ void Shutdown() {
         DestroyWindow(g_hwnd);
         g_hwnd = NULL;
     }
-    if (g_gdiplusToken) {
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
+    g_backbuffer.Release();
+    if (g_renderAcquired) {
+        RenderContext::Release();
+        g_renderAcquired = false;
     }
 }
 
@@ -353,6 +359,7 @@ static void ParseActionList(const std::string& json, std::vector<ActiveAction>&
  * LoadActionsFromConfig - Parse settings.json to load action configuration
  *****************************************************************************/
 bool LoadActionsFromConfig() {
+    TRACE_SCOPE("io", "CompUI::LoadActionsFromConfig");
     // Initialize with defaults first
     InitDefaultActions();
 
@@ -602,60 +609,31 @@ LayerAction GetSelectedAction() { return g_result.action; }
 LayerType GetCurrentLayerType() { return g_layerInfo.type; }
 
 /*****************************************************************************
- * SetLayerInfo - Parse JSON from ExtendScript
+ * SetLayerInfo - Read the layerInfo() wire record
  *****************************************************************************/
-void SetLayerInfo(const wchar_t* jsonInfo) {
-    if (!jsonInfo || jsonInfo[0] == L'\0') {
+void SetLayerInfo(std::string_view info) {
+    WireFormat::Reader reader(info);
+    if (!reader.Next()) {
         // No layer selected
         g_layerInfo = LayerInfo();
         g_layerInfo.type = LAYER_NONE;
         return;
     }
 
-    std::wstring json(jsonInfo);
-
-    auto getInt = [&json](const wchar_t* key) -> int {
-        std::wstring search = std::wstring(L"\"") + key + L"\":";
-        size_t pos = json.find(search);
-        if (pos == std::wstring::npos) return 0;
-        pos += search.length();
-        return _wtoi(json.c_str() + pos);
-    };
+    reader.StringInto(WireFormat::LAYER_NAME, g_layerInfo.name, 256);
+    g_layerInfo.type = (LayerType)reader.Int(WireFormat::LAYER_TYPE, 0);
+    g_layerInfo.index = reader.Int(WireFormat::LAYER_INDEX, 0);
+    g_layerInfo.hasParent = reader.Bool(WireFormat::LAYER_HAS_PARENT, false);
+    g_layerInfo.parentIndex = reader.Int(WireFormat::LAYER_PARENT_INDEX, 0);
+    g_layerInfo.isSelected = reader.Bool(WireFormat::LAYER_IS_SELECTED, false);
+    g_layerInfo.solidColor = (unsigned int)reader.Int(WireFormat::LAYER_SOLID_COLOR, 0);
+    g_layerInfo.isSequence = reader.Bool(WireFormat::LAYER_IS_SEQUENCE, false);
+    g_layerInfo.hasTimeRemap = reader.Bool(WireFormat::LAYER_HAS_TIME_REMAP, false);
 
-    auto getBool = [&json](const wchar_t* key) -> bool {
-        std::wstring search = std::wstring(L"\"") + key + L"\":";
-        size_t pos = json.find(search);
-        if (pos == std::wstring::npos) return false;
-        pos += search.length();
-        // Skip whitespace
-        while (pos < json.length() && (json[pos] == L' ' || json[pos] == L'\t')) pos++;
-        return json.substr(pos, 4) == L"true";
-    };
-
-    auto getString = [&json](const wchar_t* key, wchar_t* out, int maxLen) {
-        std::wstring search = std::wstring(L"\"") + key + L"\":\"";
-        size_t pos = json.find(search);
-        if (pos == std::wstring::npos) { out[0] = L'\0'; return; }
-        pos += search.length();
-        size_t end = json.find(L'"', pos);
-        if (end == std::wstring::npos) { out[0] = L'\0'; return; }
-        int len = (int)(end - pos);
-        if (len >= maxLen) len = maxLen - 1;
-        wcsncpy(out, json.c_str() + pos, len);
-        out[len] = L'\0';
-    };
-
-    getString(L"name", g_layerInfo.name, 256);
-    g_layerInfo.type = (LayerType)getInt(L"type");
-    g_layerInfo.index = getInt(L"index");
-    g_layerInfo.hasParent = getBool(L"hasParent");
-    g_layerInfo.parentIndex = getInt(L"parentIndex");
-    g_layerInfo.isSelected = getBool(L"isSelected");
-    g_layerInfo.solidColor = (unsigned int)getInt(L"solidColor");
-    g_layerInfo.isSequence = getBool(L"isSequence");
-    g_layerInfo.hasTimeRemap = getBool(L"hasTimeRemap");
-
-    InvalidateRect(g_hwnd, NULL, FALSE);
+    // Redraw if the window exists (NULL would invalidate the desktop)
+    if (g_hwnd) {
+        InvalidateRect(g_hwnd, NULL, FALSE);
+    }
 }
 
 /*****************************************************************************
@@ -664,23 +642,19 @@ void SetLayerInfo(const wchar_t* jsonInfo) {
 static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
     case WM_PAINT: {
+        TRACE_SCOPE("paint", "CompUI::Draw");
+        PROFILE_SCOPE("paint.comp");
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
 
         // Double buffering
         RECT rect;
         GetClientRect(hwnd, &rect);
-        HDC memDC = CreateCompatibleDC(hdc);
-        HBITMAP memBitmap = CreateCompatibleBitmap(hdc, rect.right, rect.bottom);
-        HGDIOBJ oldBitmap = SelectObject(memDC, memBitmap);
+        HDC memDC = g_backbuffer.Begin(hdc, rect.right, rect.bottom);
 
         Draw(memDC);
 
-        BitBlt(hdc, 0, 0, rect.right, rect.bottom, memDC, 0, 0, SRCCOPY);
-
-        SelectObject(memDC, oldBitmap);
-        DeleteObject(memBitmap);
-        DeleteDC(memDC);
+        g_backbuffer.Present(hdc, rect.right, rect.bottom);
 
         EndPaint(hwnd, &ps);
         return 0;
@@ -778,12 +752,12 @@ static void Draw(HDC hdc) {
     int windowHeight = CalculateWindowHeight();
 
     // Background
-    SolidBrush bgBrush(COLOR_BG);
-    g.FillRectangle(&bgBrush, 0, 0, WINDOW_WIDTH, windowHeight);
+    const SolidBrush *bgBrush = RenderContext::Brush(COLOR_BG);
+    g.FillRectangle(bgBrush, 0, 0, WINDOW_WIDTH, windowHeight);
 
     // Border
-    Pen borderPen(COLOR_BORDER, 1);
-    g.DrawRectangle(&borderPen, 0, 0, WINDOW_WIDTH - 1, windowHeight - 1);
+    const Pen *borderPen = RenderContext::Pen(COLOR_BORDER, 1);
+    g.DrawRectangle(borderPen, 0, 0, WINDOW_WIDTH - 1, windowHeight - 1);
 
     DrawHeader(g);
     DrawButtons(g);
@@ -793,32 +767,29 @@ static void Draw(HDC hdc) {
  * DrawHeader
  *****************************************************************************/
 static void DrawHeader(Graphics& g) {
-    SolidBrush headerBrush(COLOR_HEADER_BG);
-    g.FillRectangle(&headerBrush, 0, 0, WINDOW_WIDTH, HEADER_HEIGHT);
+    const SolidBrush *headerBrush = RenderContext::Brush(COLOR_HEADER_BG);
+    g.FillRectangle(headerBrush, 0, 0, WINDOW_WIDTH, HEADER_HEIGHT);
 
-    FontFamily fontFamily(L"Segoe UI");
-    Font titleFont(&fontFamily, 11, FontStyleBold, UnitPixel);
-    Font layerFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush dimBrush(COLOR_TEXT_DIM);
+    const Font *titleFont = RenderContext::Font(11, FontStyleBold);
+    const Font *layerFont = RenderContext::Font(10);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
+    const SolidBrush *dimBrush = RenderContext::Brush(COLOR_TEXT_DIM);
 
     // Layer type with color indicator
     Color typeColor = GetLayerTypeColor();
-    SolidBrush typeBrush(typeColor);
+    const SolidBrush *typeBrush = RenderContext::Brush(typeColor);
 
     // Type indicator circle
-    g.FillEllipse(&typeBrush, 10.0f, 10.0f, 12.0f, 12.0f);
+    g.FillEllipse(typeBrush, 10.0f, 10.0f, 12.0f, 12.0f);
 
     // Layer type name
-    g.DrawString(GetLayerTypeName(), -1, &titleFont, PointF(28, 8), &textBrush);
+    g.DrawString(GetLayerTypeName(), -1, titleFont, PointF(28, 8), textBrush);
 
     // Layer name (if available)
     if (g_layerInfo.name[0] != L'\0') {
         RectF nameRect(100, 8, 130, 20);
-        StringFormat sf;
-        sf.SetAlignment(StringAlignmentFar);
-        sf.SetTrimming(StringTrimmingEllipsisCharacter);
-        g.DrawString(g_layerInfo.name, -1, &layerFont, nameRect, &sf, &dimBrush);
+        const StringFormat *sf = RenderContext::Format(StringAlignmentFar, StringAlignmentNear, true);
+        g.DrawString(g_layerInfo.name, -1, layerFont, nameRect, sf, dimBrush);
     }
 
     // Pin button
@@ -826,14 +797,14 @@ static void DrawHeader(Graphics& g) {
     g_pinRect = {WINDOW_WIDTH - 28, btnY, WINDOW_WIDTH - 8, btnY + 20};
     Color pinColor = g_keepPanelOpen ? COLOR_PIN_ACTIVE :
                      (g_pinHover ? COLOR_BUTTON_HOVER : COLOR_BUTTON_BG);
-    SolidBrush pinBrush(pinColor);
-    g.FillRectangle(&pinBrush, g_pinRect.left, g_pinRect.top, 20, 20);
+    const SolidBrush *pinBrush = RenderContext::Brush(pinColor);
+    g.FillRectangle(pinBrush, g_pinRect.left, g_pinRect.top, 20, 20);
 
     // Pin icon
-    Pen pinPen(g_keepPanelOpen ? Color(255, 40, 40, 40) : COLOR_TEXT, 1.5f);
+    const Pen *pinPen = RenderContext::Pen(g_keepPanelOpen ? Color(255, 40, 40, 40) : COLOR_TEXT, 1.5f);
     int px = g_pinRect.left + 10, py = g_pinRect.top + 10;
-    g.DrawLine(&pinPen, px - 4, py - 4, px + 4, py + 4);
-    g.DrawEllipse(&pinPen, (REAL)(px - 3), (REAL)(py - 6), 6.0f, 6.0f);
+    g.DrawLine(pinPen, px - 4, py - 4, px + 4, py + 4);
+    g.DrawEllipse(pinPen, (REAL)(px - 3), (REAL)(py - 6), 6.0f, 6.0f);
 }
 
 /*****************************************************************************
@@ -845,13 +816,11 @@ static void DrawButtons(Graphics& g) {
 
     if (numButtons == 0) {
         // No layer selected message
-        FontFamily fontFamily(L"Segoe UI");
-        Font msgFont(&fontFamily, 11, FontStyleRegular, UnitPixel);
-        SolidBrush dimBrush(COLOR_TEXT_DIM);
-        StringFormat sf;
-        sf.SetAlignment(StringAlignmentCenter);
+        const Font *msgFont = RenderContext::Font(11);
+        const SolidBrush *dimBrush = RenderContext::Brush(COLOR_TEXT_DIM);
+        const StringFormat *sf = RenderContext::Format(StringAlignmentCenter, StringAlignmentNear);
         RectF msgRect(0, (REAL)y, (REAL)WINDOW_WIDTH, 30);
-        g.DrawString(L"No layer selected", -1, &msgFont, msgRect, &sf, &dimBrush);
+        g.DrawString(L"No layer selected", -1, msgFont, msgRect, sf, dimBrush);
         return;
     }
 
@@ -878,38 +847,37 @@ static void DrawButton(Graphics& g, RECT& rect, int index, bool hover) {
 
     // Background
     Color bgColor = hover ? COLOR_BUTTON_HOVER : COLOR_BUTTON_BG;
-    SolidBrush bgBrush(bgColor);
-    g.FillRectangle(&bgBrush, rect.left, rect.top,
+    const SolidBrush *bgBrush = RenderContext::Brush(bgColor);
+    g.FillRectangle(bgBrush, rect.left, rect.top,
                     rect.right - rect.left, rect.bottom - rect.top);
 
     // Border on hover
     if (hover) {
-        Pen borderPen(COLOR_BUTTON_ACTIVE, 1);
-        g.DrawRectangle(&borderPen, rect.left, rect.top,
+        const Pen *borderPen = RenderContext::Pen(COLOR_BUTTON_ACTIVE, 1);
+        g.DrawRectangle(borderPen, rect.left, rect.top,
                         rect.right - rect.left - 1, rect.bottom - rect.top - 1);
     }
 
-    FontFamily fontFamily(L"Segoe UI");
-    Font labelFont(&fontFamily, 11, FontStyleBold, UnitPixel);
-    Font shortcutFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    Font descFont(&fontFamily, 9, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush dimBrush(COLOR_TEXT_DIM);
-    SolidBrush accentBrush(COLOR_BUTTON_ACTIVE);
+    const Font *labelFont = RenderContext::Font(11, FontStyleBold);
+    const Font *shortcutFont = RenderContext::Font(10);
+    const Font *descFont = RenderContext::Font(9);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
+    const SolidBrush *dimBrush = RenderContext::Brush(COLOR_TEXT_DIM);
+    const SolidBrush *accentBrush = RenderContext::Brush(COLOR_BUTTON_ACTIVE);
 
     // Shortcut number (position-based: 1, 2, 3, ...)
     wchar_t shortcutStr[4];
     swprintf(shortcutStr, 4, L"%d", index + 1);
-    g.DrawString(shortcutStr, -1, &shortcutFont,
-                 PointF((REAL)(rect.left + 10), (REAL)(rect.top + 10)), &accentBrush);
+    g.DrawString(shortcutStr, -1, shortcutFont,
+                 PointF((REAL)(rect.left + 10), (REAL)(rect.top + 10)), accentBrush);
 
     // Label
-    g.DrawString(action->label, -1, &labelFont,
-                 PointF((REAL)(rect.left + 30), (REAL)(rect.top + 6)), &textBrush);
+    g.DrawString(action->label, -1, labelFont,
+                 PointF((REAL)(rect.left + 30), (REAL)(rect.top + 6)), textBrush);
 
     // Description
-    g.DrawString(action->desc, -1, &descFont,
-                 PointF((REAL)(rect.left + 30), (REAL)(rect.top + 20)), &dimBrush);
+    g.DrawString(action->desc, -1, descFont,
+                 PointF((REAL)(rect.left + 30), (REAL)(rect.top + 20)), dimBrush);
 }
 
 /*****************************************************************************
@@ -1016,14 +984,14 @@ static void ExecuteAction(LayerAction action) {
 
 namespace CompUI {
 
-void Initialize() {}
+bool Initialize() { return true; }
 void Shutdown() {}
 void ShowPanel(int x, int y) { (void)x; (void)y; }
 CompResult HidePanel() { return CompResult(); }
 bool IsVisible() { return false; }
 void UpdateHover(int mouseX, int mouseY) { (void)mouseX; (void)mouseY; }
 CompResult GetResult() { return CompResult(); }
-void SetLayerInfo(const wchar_t* jsonInfo) { (void)jsonInfo; }
+void SetLayerInfo(std::string_view info) { (void)info; }
 LayerAction GetSelectedAction() { return ACTION_NONE; }
 LayerType GetCurrentLayerType() { return LAYER_UNKNOWN; }
 
@@ -18,6 +18,8 @@
 #ifndef COMPUI_H
 #define COMPUI_H
 
+#include <string_view>
+
 namespace CompUI {
 
 // Layer types
@@ -122,7 +124,8 @@ struct CompResult {
 };
 
 // Initialize the Layer UI system
-void Initialize();
+// @return false if GDI+ or the window (class) could not be created
+bool Initialize();
 
 // Cleanup
 void Shutdown();
@@ -142,8 +145,8 @@ void UpdateHover(int mouseX, int mouseY);
 // Get the result after panel closes
 CompResult GetResult();
 
-// Set current layer info from ExtendScript JSON
-void SetLayerInfo(const wchar_t* jsonInfo);
+// Set current layer info from the layerInfo() wire record (WireFormat::LayerField)
+void SetLayerInfo(std::string_view info);
 
 // Get current layer type
 LayerType GetCurrentLayerType();
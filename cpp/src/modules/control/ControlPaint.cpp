@@ -0,0 +1,369 @@
+/*****************************************************************************
+ * ControlPaint.cpp
+ *
+ * Control panel rendering on Canvas (see ControlPaint.h)
+ *****************************************************************************/
+
+#include "ControlPaint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cwchar>
+#include <string>
+
+namespace ControlPaint {
+
+using Canvas::Argb;
+using Canvas::Pixel;
+
+// Colors
+static const Pixel COLOR_BG = Argb(240, 28, 28, 32);
+static const Pixel COLOR_SEARCH_BG = Argb(255, 40, 40, 48);
+static const Pixel COLOR_ITEM_HOVER = Argb(255, 60, 80, 100);
+static const Pixel COLOR_ITEM_SELECTED = Argb(255, 74, 158, 255);
+static const Pixel COLOR_TEXT = Argb(255, 220, 220, 220);
+static const Pixel COLOR_TEXT_DIM = Argb(255, 140, 140, 140);
+static const Pixel COLOR_ACCENT = Argb(255, 74, 207, 255);
+static const Pixel COLOR_BORDER = Argb(255, 60, 60, 70);
+static const Pixel COLOR_PRESET_BG = Argb(255, 50, 50, 60);
+static const Pixel COLOR_PRESET_HOVER = Argb(255, 70, 100, 130);
+static const Pixel COLOR_PRESET_ACTIVE = Argb(255, 74, 158, 255);
+
+// Label colors (AE default palette)
+static const Pixel LABEL_COLORS[] = {
+    Argb(255, 128, 128, 128),  // 0: None (gray)
+    Argb(255, 255, 50, 50),    // 1: Red
+    Argb(255, 255, 200, 50),   // 2: Yellow
+    Argb(255, 180, 220, 140),  // 3: Aqua
+    Argb(255, 255, 180, 200),  // 4: Pink
+    Argb(255, 200, 180, 255),  // 5: Lavender
+    Argb(255, 255, 200, 150),  // 6: Peach
+    Argb(255, 200, 200, 220),  // 7: Sea Foam
+    Argb(255, 120, 180, 255),  // 8: Blue
+    Argb(255, 120, 255, 120),  // 9: Green
+    Argb(255, 200, 120, 255),  // 10: Purple
+    Argb(255, 255, 160, 80),   // 11: Orange
+    Argb(255, 165, 120, 80),   // 12: Brown
+    Argb(255, 255, 120, 200),  // 13: Fuchsia
+    Argb(255, 80, 200, 180),   // 14: Cyan
+    Argb(255, 180, 200, 120),  // 15: Sandstone
+    Argb(255, 100, 160, 100),  // 16: Dark Green
+};
+
+// Segoe UI line box / em: GDI+ centers this box in the layout rect
+static const float LINE_HEIGHT = 1.33f;
+
+// Base-unit drawing (the GDI+ paths drew through ScaleTransform(scale))
+struct Painter {
+    Canvas::Surface& surface;
+    float scale;
+
+    int Px(float value) const { return (int)std::lround(value * scale); }
+
+    void Fill(float x, float y, float w, float h, Pixel color) {
+        int x0 = Px(x), y0 = Px(y);
+        Canvas::BlendRect(surface, x0, y0, Px(x + w) - x0, Px(y + h) - y0, color);
+    }
+
+    // 1-unit outline on the rect edges (GDI+ DrawRectangle: w + 1 wide)
+    void Frame(float x, float y, float w, float h, Pixel color) {
+        int t = std::max(1, Px(1));
+        int x0 = Px(x), y0 = Px(y), x1 = Px(x + w), y1 = Px(y + h);
+        Canvas::BlendRect(surface, x0, y0, x1 - x0 + t, t, color);
+        Canvas::BlendRect(surface, x0, y1, x1 - x0 + t, t, color);
+        Canvas::BlendRect(surface, x0, y0 + t, t, y1 - y0 - t, color);
+        Canvas::BlendRect(surface, x1, y0 + t, t, y1 - y0 - t, color);
+    }
+
+    // Frame with 3-on / 3-off dashes
+    void DashedFrame(float x, float y, float w, float h, Pixel color) {
+        int t = std::max(1, Px(1)), dash = std::max(1, Px(3));
+        int x0 = Px(x), y0 = Px(y), x1 = Px(x + w), y1 = Px(y + h);
+        for (int d = x0; d <= x1; d += dash * 2) {
+            int length = std::min(dash, x1 + t - d);
+            Canvas::BlendRect(surface, d, y0, length, t, color);
+            Canvas::BlendRect(surface, d, y1, length, t, color);
+        }
+        for (int d = y0 + dash * 2; d < y1; d += dash * 2) {
+            int length = std::min(dash, y1 - d);
+            Canvas::BlendRect(surface, x0, d, t, length, color);
+            Canvas::BlendRect(surface, x1, d, t, length, color);
+        }
+    }
+
+    void Line(float x0, float y0, float x1, float y1, float width, Pixel color) {
+        Canvas::DrawLine(surface, x0 * scale, y0 * scale, x1 * scale, y1 * scale, width * scale,
+                         color);
+    }
+
+    void Ellipse(float x, float y, float w, float h, float width, Pixel color) {
+        Canvas::DrawEllipse(surface, x * scale, y * scale, w * scale, h * scale, width * scale,
+                            color);
+    }
+
+    float Measure(const wchar_t* text, float size) const {
+        return Canvas::MeasureString(text, size * scale) / scale;
+    }
+
+    // Left (or right) aligned, centered in the rect's height
+    void Text(const wchar_t* text, float size, float x, float y, float w, float h, Pixel color,
+              bool alignRight = false) {
+        float textX = alignRight ? x + w - Measure(text, size) : x;
+        float textY = y + (h - size * LINE_HEIGHT) / 2;
+        Canvas::DrawString(surface, textX * scale, textY * scale, text, size * scale, color);
+    }
+};
+
+// Keep open (pin) button
+static void DrawPinButton(Painter& p, const PanelState& state, float x, float y) {
+    float ps = (float)NEW_EC_BUTTON_SIZE;
+    if (state.keepOpenHover || state.keepPanelOpen) {
+        p.Fill(x, y, ps, ps, state.keepPanelOpen ? COLOR_PRESET_ACTIVE : COLOR_PRESET_HOVER);
+    }
+    Pixel pinColor = state.keepPanelOpen ? Argb(255, 255, 255, 255) : Argb(255, 140, 140, 140);
+    // Pin head (circle), needle (line down)
+    p.Ellipse(x + ps * 0.3f, y + ps * 0.2f, ps * 0.4f, ps * 0.35f, 1.5f, pinColor);
+    p.Line(x + ps * 0.5f, y + ps * 0.55f, x + ps * 0.5f, y + ps * 0.8f, 1.5f, pinColor);
+}
+
+// Selected / hovered row background
+static void DrawRowHighlight(Painter& p, const PanelState& state, int index, float y, float width) {
+    if (index == state.selectedIndex) {
+        p.Fill(PADDING, y, width, ITEM_HEIGHT, COLOR_ITEM_SELECTED);
+    } else if (index == state.hoverIndex) {
+        p.Fill(PADDING, y, width, ITEM_HEIGHT, COLOR_ITEM_HOVER);
+    }
+}
+
+static int VisibleCount(const std::vector<ControlUI::EffectItem>* items) {
+    return items ? std::min((int)items->size(), MAX_VISIBLE_ITEMS) : 0;
+}
+
+void DrawSearchPanel(Canvas::Surface& surface, const PanelState& state) {
+    Painter p{surface, state.scale};
+
+    // Base layout (the painter scales)
+    float baseWidth = (float)WINDOW_WIDTH;
+    float baseHeight = (float)(int)(surface.Height() / state.scale);
+    const wchar_t* query = state.query ? state.query : L"";
+    int queryLength = (int)wcslen(query);
+
+    // Background and border
+    p.Fill(0, 0, baseWidth, baseHeight, COLOR_BG);
+    p.Frame(0, 0, baseWidth - 1, baseHeight - 1, COLOR_BORDER);
+
+    // Search box background (full width - only pin button on right)
+    p.Fill(PADDING, PADDING, baseWidth - PADDING * 2 - NEW_EC_BUTTON_SIZE - 8, SEARCH_HEIGHT,
+           COLOR_SEARCH_BG);
+
+    // Keep open (pin) button - right side
+    DrawPinButton(p, state, baseWidth - PADDING - NEW_EC_BUTTON_SIZE,
+                  PADDING + (SEARCH_HEIGHT - NEW_EC_BUTTON_SIZE) / 2);
+
+    // Selection highlight
+    float textX = PADDING + 8, textY = PADDING + 8;
+    float textW = baseWidth - PADDING * 2 - 16, textH = SEARCH_HEIGHT - 16;
+    bool hasSelection = state.selectionStart >= 0 && state.selectionEnd >= 0 &&
+                        state.selectionStart != state.selectionEnd;
+    if (hasSelection && queryLength > 0) {
+        int selStart = std::min(std::min(state.selectionStart, state.selectionEnd), queryLength);
+        int selEnd = std::min(std::max(state.selectionStart, state.selectionEnd), queryLength);
+        float startWidth = selStart > 0 ? p.Measure(std::wstring(query, selStart).c_str(), 14) : 0;
+        float endWidth = p.Measure(std::wstring(query, selEnd).c_str(), 14);
+        p.Fill(textX + startWidth, textY, endWidth - startWidth, textH,
+               Argb(128, 74, 158, 255)); // Semi-transparent accent
+    }
+
+    // Search text
+    if (queryLength > 0) {
+        p.Text(query, 14, textX, textY, textW, textH, COLOR_TEXT);
+    } else {
+        p.Text(L"Search effects...", 14, textX, textY, textW, textH, COLOR_TEXT_DIM);
+    }
+
+    // Cursor blink
+    if (state.cursorVisible) {
+        int cursorPos = std::min(state.cursorPosition, queryLength);
+        float width = cursorPos > 0 ? p.Measure(std::wstring(query, cursorPos).c_str(), 14) : 0;
+        float cursorX = textX + width + 1.0f;
+        p.Line(cursorX, PADDING + 10, cursorX, PADDING + SEARCH_HEIGHT - 10, 2, COLOR_ACCENT);
+    }
+
+    // Results
+    float y = PADDING + SEARCH_HEIGHT + PADDING;
+    int visibleCount = VisibleCount(state.searchResults);
+    for (int i = 0; i < visibleCount; i++) {
+        const ControlUI::EffectItem& item = (*state.searchResults)[i];
+        DrawRowHighlight(p, state, i, y, baseWidth - PADDING * 2);
+
+        // Effect name, category (right aligned)
+        p.Text(item.name, 12, PADDING + 8, y + 4, baseWidth - PADDING * 2 - 100, ITEM_HEIGHT / 2,
+               COLOR_TEXT);
+        p.Text(item.category, 10, baseWidth - 110, y, 100, ITEM_HEIGHT, COLOR_TEXT_DIM, true);
+
+        y += ITEM_HEIGHT;
+    }
+
+    // No results message
+    if (visibleCount == 0 && queryLength > 0) {
+        p.Text(L"No effects found", 12, PADDING, y, baseWidth - PADDING * 2, ITEM_HEIGHT,
+               COLOR_TEXT_DIM);
+    }
+}
+
+int DrawEffectsPanel(Canvas::Surface& surface, const PanelState& state, IconSlot* icons) {
+    Painter p{surface, state.scale};
+    int iconCount = 0;
+
+    // Base layout (the painter scales)
+    float baseWidth = (float)WINDOW_WIDTH;
+    float baseHeight = (float)(int)(surface.Height() / state.scale);
+    const wchar_t* query = state.query ? state.query : L"";
+
+    // Background and border
+    p.Fill(0, 0, baseWidth, baseHeight, COLOR_BG);
+    p.Frame(0, 0, baseWidth - 1, baseHeight - 1, COLOR_BORDER);
+
+    float currentY = PADDING;
+
+    // ===== Header bar with layer name and label color =====
+    // Label color indicator (small square)
+    int labelSize = 8;
+    int labelIndex = (state.labelColor >= 0 && state.labelColor <= 16) ? state.labelColor : 0;
+    p.Fill(PADDING + 4, currentY + (HEADER_HEIGHT - labelSize) / 2, labelSize, labelSize,
+           LABEL_COLORS[labelIndex]);
+
+    // Layer name
+    float titleX = PADDING + labelSize + 10;
+    float titleW = baseWidth - PADDING * 2 - NEW_EC_BUTTON_SIZE - 10;
+    if (state.layerName && state.layerName[0]) {
+        p.Text(state.layerName, 12, titleX, currentY, titleW, HEADER_HEIGHT, COLOR_TEXT);
+    } else {
+        p.Text(L"Selected Layer", 12, titleX, currentY, titleW, HEADER_HEIGHT, COLOR_TEXT_DIM);
+    }
+
+    // Keep open (pin) button - right side
+    float pinBtnX = baseWidth - PADDING - NEW_EC_BUTTON_SIZE;
+    DrawPinButton(p, state, pinBtnX, currentY + (HEADER_HEIGHT - NEW_EC_BUTTON_SIZE) / 2);
+
+    // New EC window button [+] - left of pin button
+    float newECBtnX = pinBtnX - NEW_EC_BUTTON_SIZE - 4;
+    float newECBtnY = currentY + (HEADER_HEIGHT - NEW_EC_BUTTON_SIZE) / 2;
+    if (state.newECHover) {
+        p.Fill(newECBtnX, newECBtnY, NEW_EC_BUTTON_SIZE, NEW_EC_BUTTON_SIZE, COLOR_PRESET_HOVER);
+    }
+    float plusMargin = 5.0f, half = NEW_EC_BUTTON_SIZE / 2;
+    p.Line(newECBtnX + plusMargin, newECBtnY + half, newECBtnX + NEW_EC_BUTTON_SIZE - plusMargin,
+           newECBtnY + half, 2, COLOR_ACCENT);
+    p.Line(newECBtnX + half, newECBtnY + plusMargin, newECBtnX + half,
+           newECBtnY + NEW_EC_BUTTON_SIZE - plusMargin, 2, COLOR_ACCENT);
+
+    currentY += HEADER_HEIGHT + 4;
+
+    // ===== Preset buttons bar =====
+    int presetBtnSpacing = 4;
+    // 6 preset buttons + save button
+    int totalPresetWidth = PRESET_SLOT_COUNT * (PRESET_BUTTON_HEIGHT + presetBtnSpacing) +
+                           SAVE_BUTTON_SIZE + presetBtnSpacing;
+    int presetStartX = (WINDOW_WIDTH - totalPresetWidth) / 2;
+
+    for (int i = 0; i < PRESET_SLOT_COUNT; i++) {
+        float btnX = (float)(presetStartX + i * (PRESET_BUTTON_HEIGHT + presetBtnSpacing));
+        float btnY = currentY + (PRESET_BAR_HEIGHT - PRESET_BUTTON_HEIGHT) / 2;
+        PresetIcon icon = state.presetIcons ? state.presetIcons[i] : ICON_NONE;
+        bool hasFx = icon != ICON_NONE;
+
+        // Button background (save mode: orange glow)
+        Pixel btnColor;
+        if (state.saveMode) {
+            btnColor = (i == state.hoveredPreset) ? Argb(255, 255, 180, 0) : Argb(255, 200, 120, 0);
+        } else {
+            btnColor = (i == state.hoveredPreset) ? COLOR_PRESET_HOVER
+                       : hasFx                    ? COLOR_PRESET_ACTIVE
+                                                  : COLOR_PRESET_BG;
+        }
+        p.Fill(btnX, btnY, PRESET_BUTTON_HEIGHT, PRESET_BUTTON_HEIGHT, btnColor);
+
+        // Border: solid, or dashed for an empty slot; icon on top
+        if (hasFx) {
+            p.Frame(btnX, btnY, PRESET_BUTTON_HEIGHT, PRESET_BUTTON_HEIGHT, COLOR_BORDER);
+            icons[iconCount++] = {btnX, btnY, (float)PRESET_BUTTON_HEIGHT, icon, true};
+        } else {
+            p.DashedFrame(btnX, btnY, PRESET_BUTTON_HEIGHT, PRESET_BUTTON_HEIGHT,
+                          Argb(255, 80, 80, 90));
+        }
+    }
+
+    // Save button (floppy disk icon) - right of preset buttons
+    float saveBtnX = (float)(presetStartX + PRESET_SLOT_COUNT * (PRESET_BUTTON_HEIGHT + presetBtnSpacing));
+    float saveBtnY = currentY + (PRESET_BAR_HEIGHT - SAVE_BUTTON_SIZE) / 2;
+    Pixel saveBtnColor = state.saveMode    ? COLOR_PRESET_ACTIVE
+                         : state.saveHover ? COLOR_PRESET_HOVER
+                                           : COLOR_PRESET_BG;
+    p.Fill(saveBtnX, saveBtnY, SAVE_BUTTON_SIZE, SAVE_BUTTON_SIZE, saveBtnColor);
+    p.Frame(saveBtnX, saveBtnY, SAVE_BUTTON_SIZE, SAVE_BUTTON_SIZE, COLOR_BORDER);
+    icons[iconCount++] = {saveBtnX, saveBtnY, (float)SAVE_BUTTON_SIZE, ICON_COUNT,
+                          state.saveHover || state.saveMode};
+
+    currentY += PRESET_BAR_HEIGHT;
+
+    // ===== Search bar =====
+    p.Fill(PADDING, currentY, baseWidth - PADDING * 2, SEARCH_HEIGHT, COLOR_SEARCH_BG);
+    bool isSearching = query[0] != L'\0';
+    float searchTextW = baseWidth - PADDING * 2 - 16;
+    if (isSearching) {
+        p.Text(query, 12, PADDING + 8, currentY, searchTextW, SEARCH_HEIGHT, COLOR_TEXT);
+    } else {
+        p.Text(L"Search effects...", 12, PADDING + 8, currentY, searchTextW, SEARCH_HEIGHT,
+               COLOR_TEXT_DIM);
+    }
+
+    currentY += SEARCH_HEIGHT + PADDING;
+
+    // ===== Search results or layer effects =====
+    const std::vector<ControlUI::EffectItem>* items =
+        isSearching ? state.searchResults : state.layerEffects;
+    int visibleCount = VisibleCount(items);
+    if (visibleCount == 0) {
+        p.Text(isSearching ? L"No matching effects" : L"No effects on layer", 12, PADDING,
+               currentY, baseWidth - PADDING * 2, ITEM_HEIGHT, COLOR_TEXT_DIM);
+        return iconCount;
+    }
+
+    for (int i = 0; i < visibleCount; i++) {
+        const ControlUI::EffectItem& item = (*items)[i];
+        DrawRowHighlight(p, state, i, currentY, baseWidth - PADDING * 2);
+
+        if (isSearching) {
+            // Effect name, category
+            p.Text(item.name, 12, PADDING + 8, currentY, baseWidth - PADDING * 2 - 100,
+                   ITEM_HEIGHT, COLOR_TEXT);
+            p.Text(item.category, 10, baseWidth - PADDING - 90, currentY, 80, ITEM_HEIGHT,
+                   COLOR_TEXT_DIM, true);
+        } else {
+            // Expand icon, effect index number, effect name
+            p.Text(L"\u25B6", 10, PADDING + 4, currentY, 16, ITEM_HEIGHT, COLOR_TEXT_DIM);
+            wchar_t indexStr[8];
+            swprintf(indexStr, 8, L"%d.", item.index + 1);
+            p.Text(indexStr, 10, PADDING + 20, currentY, 24, ITEM_HEIGHT, COLOR_TEXT_DIM);
+            p.Text(item.name, 12, PADDING + 44, currentY, baseWidth - PADDING * 2 - 80,
+                   ITEM_HEIGHT, COLOR_TEXT);
+
+            // Delete button [x]
+            float btnX = baseWidth - PADDING - ACTION_BUTTON_SIZE - 4;
+            float btnY = currentY + (ITEM_HEIGHT - ACTION_BUTTON_SIZE) / 2;
+            float btnMargin = 5.0f;
+            Pixel deleteColor = Argb(255, 200, 80, 80);
+            p.Line(btnX + btnMargin, btnY + btnMargin, btnX + ACTION_BUTTON_SIZE - btnMargin,
+                   btnY + ACTION_BUTTON_SIZE - btnMargin, 1.5f, deleteColor);
+            p.Line(btnX + ACTION_BUTTON_SIZE - btnMargin, btnY + btnMargin, btnX + btnMargin,
+                   btnY + ACTION_BUTTON_SIZE - btnMargin, 1.5f, deleteColor);
+        }
+
+        currentY += ITEM_HEIGHT;
+    }
+    return iconCount;
+}
+
+} // namespace ControlPaint
@@ -0,0 +1,97 @@
+/*****************************************************************************
+ * ControlPaint.h
+ *
+ * Control panel rendering on Canvas (platform-neutral)
+ * Mode 1 (search) and Mode 2 (layer effects) render into a Canvas surface
+ * from a PanelState snapshot; ControlUI blits it in WM_PAINT and draws the
+ * preset / save icons on top through IconAtlas (GDI+). Without a window the
+ * same calls render the panel headless (tools/ScriptBench, cpp/tests).
+ *****************************************************************************/
+
+#ifndef CONTROLPAINT_H
+#define CONTROLPAINT_H
+
+#include "Canvas.h"
+#include "ControlUI.h"
+
+#include <vector>
+
+namespace ControlPaint {
+
+// Layout (base units; the surface is scale x larger)
+static const int WINDOW_WIDTH = 320;
+static const int SEARCH_HEIGHT = 36;
+static const int HEADER_HEIGHT = 32;  // Mode 2 header
+static const int PRESET_BAR_HEIGHT = 36;  // Mode 2 preset buttons
+static const int ITEM_HEIGHT = 32;
+static const int PADDING = 8;
+static const int MAX_VISIBLE_ITEMS = 8;
+static const int CLOSE_BUTTON_SIZE = 20;
+static const int ACTION_BUTTON_SIZE = 20;  // Delete, duplicate, move buttons
+static const int PRESET_BUTTON_WIDTH = 40;
+static const int PRESET_BUTTON_HEIGHT = 28;
+static const int NEW_EC_BUTTON_SIZE = 20;
+static const int PRESET_SLOT_COUNT = 6;
+static const int SAVE_BUTTON_SIZE = 28; // Square button to match preset height
+
+// Preset icons
+enum PresetIcon {
+    ICON_NONE = 0,      // Empty slot (no preset saved)
+    ICON_COLOR,         // Color wheel
+    ICON_BLUR,          // Blur circles
+    ICON_DISTORT,       // Wave
+    ICON_STAR,          // Star
+    ICON_LIGHTNING,     // Lightning bolt
+    ICON_MAGIC,         // Magic wand/sparkles
+    ICON_COUNT          // Number of icons (excluding NONE); also the save icon's id
+};
+
+// Everything one paint reads
+struct PanelState {
+    ControlUI::PanelMode mode = ControlUI::MODE_SEARCH;
+    float scale = 1.0f;
+
+    // Search box
+    const wchar_t* query = L"";
+    int cursorPosition = 0;
+    bool cursorVisible = false;
+    int selectionStart = -1;    // -1 = no selection
+    int selectionEnd = -1;
+
+    // Lists (NULL: empty)
+    const std::vector<ControlUI::EffectItem>* searchResults = nullptr;
+    const std::vector<ControlUI::EffectItem>* layerEffects = nullptr;
+    int selectedIndex = 0;
+    int hoverIndex = -1;
+
+    // Buttons
+    bool keepPanelOpen = false;
+    bool keepOpenHover = false;
+    bool newECHover = false;
+
+    // Mode 2 header and preset bar
+    const wchar_t* layerName = L"";
+    int labelColor = 0;                      // 0-16 AE label colors
+    const PresetIcon* presetIcons = nullptr; // PRESET_SLOT_COUNT, NULL: all empty
+    int hoveredPreset = -1;
+    bool saveMode = false;
+    bool saveHover = false;
+};
+
+// Icon the caller draws over a button (base units; ICON_COUNT: save icon)
+struct IconSlot {
+    float x, y, size;
+    int icon;
+    bool on;    // Preset: filled, save: hover
+};
+
+// Mode 1: search box and results. The surface is the client area
+void DrawSearchPanel(Canvas::Surface& surface, const PanelState& state);
+
+// Mode 2: header, preset bar, search box, layer effects or results
+// @return number of icon slots written to `icons` (up to PRESET_SLOT_COUNT + 1)
+int DrawEffectsPanel(Canvas::Surface& surface, const PanelState& state, IconSlot* icons);
+
+} // namespace ControlPaint
+
+#endif // CONTROLPAINT_H
@@ -10,12 +10,20 @@
 #ifdef MSWindows
 
 #include "GdiPlusIncludes.h"
+#include "ControlPaint.h"
+#include "IconAtlas.h"
+#include "CatalogCache.h"
+#include "WireFormat.h"
+#include "Profiler.h"
+#include "RenderContext.h"
+#include "Tracer.h"
 #include <cmath>
 #include <string>
 #include <vector>
 #include <algorithm>
 
 using namespace Gdiplus;
+using namespace ControlPaint;  // Layout constants, PresetIcon
 
 // External function from SnapPlugin.cpp to get module scale factor
 extern float GetModuleScaleFactor(const char* moduleName);
@@ -34,7 +42,11 @@ inline int InverseScaled(int screenValue) {
 }
 
 // GDI+ token
-static ULONG_PTR g_gdiplusToken = 0;
+static bool g_renderAcquired = false;
+static RenderContext::Backbuffer g_backbuffer;
+// Panel rendered on Canvas, glyphs through GDI+
+static Canvas::Surface g_surface;
+static Canvas::GdiplusText g_text;
 
 // Window class name
 static const wchar_t* CONTROL_CLASS_NAME = L"AnchorSnapControlClass";
@@ -62,52 +74,13 @@ static ControlUI::ControlSettings g_settings;
 // Result
 static ControlUI::ControlResult g_result;
 
-// UI Constants
-static const int WINDOW_WIDTH = 320;
-static const int SEARCH_HEIGHT = 36;
-static const int HEADER_HEIGHT = 32;  // Mode 2 header
-static const int PRESET_BAR_HEIGHT = 36;  // Mode 2 preset buttons
-static const int ITEM_HEIGHT = 32;
-static const int PADDING = 8;
-static const int MAX_VISIBLE_ITEMS = 8;
-static const int CLOSE_BUTTON_SIZE = 20;
-static const int ACTION_BUTTON_SIZE = 20;  // Delete, duplicate, move buttons
-static const int PRESET_BUTTON_WIDTH = 40;
-static const int PRESET_BUTTON_HEIGHT = 28;
-
-// Colors
-static const Color COLOR_BG(240, 28, 28, 32);
-static const Color COLOR_SEARCH_BG(255, 40, 40, 48);
-static const Color COLOR_ITEM_HOVER(255, 60, 80, 100);
-static const Color COLOR_ITEM_SELECTED(255, 74, 158, 255);
-static const Color COLOR_TEXT(255, 220, 220, 220);
-static const Color COLOR_TEXT_DIM(255, 140, 140, 140);
-static const Color COLOR_ACCENT(255, 74, 207, 255);
-static const Color COLOR_BORDER(255, 60, 60, 70);
-static const Color COLOR_CLOSE_HOVER(255, 200, 60, 60);
-static const Color COLOR_PRESET_BG(255, 50, 50, 60);
-static const Color COLOR_PRESET_HOVER(255, 70, 100, 130);
-static const Color COLOR_PRESET_ACTIVE(255, 74, 158, 255);
+// UI constants and colors: ControlPaint
 
 // New EC window button state (Mode 2)
 static bool g_newECButtonHover = false;
-static const int NEW_EC_BUTTON_SIZE = 20;
-
-// Preset icons
-enum PresetIcon {
-    ICON_NONE = 0,      // Empty slot (no preset saved)
-    ICON_COLOR,         // Color wheel
-    ICON_BLUR,          // Blur circles
-    ICON_DISTORT,       // Wave
-    ICON_STAR,          // Star
-    ICON_LIGHTNING,     // Lightning bolt
-    ICON_MAGIC,         // Magic wand/sparkles
-    ICON_COUNT          // Number of icons (excluding NONE)
-};
 
 // Preset button state (Mode 2)
 static int g_hoveredPresetButton = -1;  // -1 = none, 0-5 = slot buttons
-static const int PRESET_SLOT_COUNT = 6;
 static PresetIcon g_presetIcons[PRESET_SLOT_COUNT] = {ICON_NONE, ICON_NONE, ICON_NONE, ICON_NONE, ICON_NONE, ICON_NONE};
 
 // Icon selection state
@@ -123,7 +96,6 @@ static const UINT LONG_PRESS_MS = 500;  // 0.5 second hold to change icon
 // Save mode state (Mode 2)
 static bool g_saveMode = false;         // When true, clicking preset button saves
 static bool g_saveButtonHover = false;  // Hover state for save button
-static const int SAVE_BUTTON_SIZE = 28; // Square button to match preset height
 
 // Delayed close timer (prevent immediate close on focus loss)
 static UINT_PTR g_closeTimerId = 0;
@@ -152,26 +124,6 @@ static bool g_keepOpenButtonHover = false;
 static wchar_t g_currentLayerName[256] = L"";
 static int g_currentLayerLabelColor = 0;  // 0-16 AE label colors
 
-// Label colors (AE default palette)
-static const Color LABEL_COLORS[] = {
-    Color(255, 128, 128, 128),  // 0: None (gray)
-    Color(255, 255, 50, 50),    // 1: Red
-    Color(255, 255, 200, 50),   // 2: Yellow
-    Color(255, 180, 220, 140),  // 3: Aqua
-    Color(255, 255, 180, 200),  // 4: Pink
-    Color(255, 200, 180, 255),  // 5: Lavender
-    Color(255, 255, 200, 150),  // 6: Peach
-    Color(255, 200, 200, 220),  // 7: Sea Foam
-    Color(255, 120, 180, 255),  // 8: Blue
-    Color(255, 120, 255, 120),  // 9: Green
-    Color(255, 200, 120, 255),  // 10: Purple
-    Color(255, 255, 160, 80),   // 11: Orange
-    Color(255, 165, 120, 80),   // 12: Brown
-    Color(255, 255, 120, 200),  // 13: Fuchsia
-    Color(255, 80, 200, 180),   // 14: Cyan
-    Color(255, 180, 200, 120),  // 15: Sandstone
-    Color(255, 100, 160, 100),  // 16: Dark Green
-};
 
 // Dynamic effects list (loaded from AE - localized names)
 static std::vector<ControlUI::EffectItem> g_availableEffects;
@@ -230,18 +182,19 @@ static const wchar_t* BUILTIN_EFFECTS[][3] = {
 
 // Forward declarations
 LRESULT CALLBACK ControlWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
-void DrawControlPanel(HDC hdc, int width, int height);
-void DrawEffectsPanel(HDC hdc, int width, int height);
+void DrawPanel(HDC hdc, int width, int height);
 void PerformSearch(const wchar_t* query);
-void ParseLayerEffects(const wchar_t* effectList);
-void ParseAvailableEffects(const wchar_t* effectList);
+void ParseLayerEffects(std::string_view effectList);
+void ParseAvailableEffects(const CatalogCache::Catalog& catalog);
 
 namespace ControlUI {
 
-void Initialize() {
-    if (g_gdiplusToken == 0) {
-        GdiplusStartupInput gdiplusStartupInput;
-        GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, NULL);
+bool Initialize() {
+    if (!g_renderAcquired) {
+        g_renderAcquired = RenderContext::Acquire();
+    }
+    if (g_renderAcquired) {
+        Canvas::SetTextRenderer(&g_text);
     }
 
     // Register window class
@@ -253,6 +206,7 @@ void Initialize() {
     wc.hCursor = LoadCursor(NULL, IDC_ARROW);
     wc.style = CS_HREDRAW | CS_VREDRAW;
     RegisterClassExW(&wc);
+    return g_renderAcquired;
 }
 
 void Shutdown() {
@@ -262,9 +216,12 @@ void Shutdown() {
     }
     UnregisterClassW(CONTROL_CLASS_NAME, GetModuleHandle(NULL));
 
-    if (g_gdiplusToken) {
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
+    g_backbuffer.Release();
+    g_surface.Resize(0, 0);
+    if (g_renderAcquired) {
+        Canvas::SetTextRenderer(NULL);
+        RenderContext::Release();
+        g_renderAcquired = false;
     }
 }
 
@@ -281,6 +238,7 @@ void ShowPanelAt(int x, int y) {
 
     // Get module scale factor from settings
     g_scaleFactor = GetModuleScaleFactor("control");
+    IconAtlas::SetScale(IconAtlas::OWNER_CONTROL, g_scaleFactor);
 
     // Reset state based on mode
     g_selectedIndex = 0;
@@ -458,11 +416,15 @@ void UpdateSearch(const wchar_t* query) {
     InvalidateRect(g_hwnd, NULL, TRUE);
 }
 
-void SetAvailableEffects(const wchar_t* effectList) {
-    ParseAvailableEffects(effectList);
+void SetAvailableEffects(const CatalogCache::Catalog& catalog) {
+    ParseAvailableEffects(catalog);
 }
 
-void SetLayerEffects(const wchar_t* effectList) {
+void SetAvailableEffects(std::vector<EffectItem>&& effects) {
+    g_availableEffects = std::move(effects);
+}
+
+void SetLayerEffects(std::string_view effectList) {
     ParseLayerEffects(effectList);
 }
 
@@ -550,266 +512,71 @@ void PerformSearch(const wchar_t* query) {
     g_selectedIndex = 0;
 }
 
-// Parse available effects from string format: "displayName|matchName|category;..."
-void ParseAvailableEffects(const wchar_t* effectList) {
+// Copy available effects out of the catalog (mapped cache file or fresh effectsList())
+// Each field is copied once from the UTF-16 string pool into the item
+void ParseAvailableEffects(const CatalogCache::Catalog& catalog) {
+    uint32_t count = catalog.RecordCount();
     g_availableEffects.clear();
-
-    if (!effectList || wcslen(effectList) == 0) return;
-
-    std::wstring list(effectList);
-    size_t pos = 0;
-    int idx = 0;
-
-    while (pos < list.length()) {
-        size_t end = list.find(L';', pos);
-        if (end == std::wstring::npos) end = list.length();
-
-        std::wstring item = list.substr(pos, end - pos);
-        if (!item.empty()) {
-            size_t sep1 = item.find(L'|');
-            size_t sep2 = item.find(L'|', sep1 + 1);
-
-            if (sep1 != std::wstring::npos && sep2 != std::wstring::npos) {
-                ControlUI::EffectItem effect;
-                std::wstring displayName = item.substr(0, sep1);
-                std::wstring matchName = item.substr(sep1 + 1, sep2 - sep1 - 1);
-                std::wstring category = item.substr(sep2 + 1);
-
-                wcscpy_s(effect.name, displayName.c_str());
-                wcscpy_s(effect.matchName, matchName.c_str());
-                wcscpy_s(effect.category, category.c_str());
-                effect.index = idx;
-                effect.isLayerEffect = false;
-
-                g_availableEffects.push_back(effect);
-                idx++;
-            }
-        }
-        pos = end + 1;
+    g_availableEffects.resize(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        ControlUI::EffectItem& effect = g_availableEffects[i];
+        catalog.FieldInto(i, WireFormat::EFFECT_NAME, effect.name, _countof(effect.name));
+        catalog.FieldInto(i, WireFormat::EFFECT_MATCH_NAME, effect.matchName, _countof(effect.matchName));
+        catalog.FieldInto(i, WireFormat::EFFECT_CATEGORY_OR_INDEX, effect.category, _countof(effect.category));
+        effect.index = (int)i;
+        effect.isLayerEffect = false;
     }
 }
 
-// Parse layer effects from string format: "name1|matchName1|index1;name2|matchName2|index2;..."
-void ParseLayerEffects(const wchar_t* effectList) {
+// Parse layer effects from layerEffects() wire records (name, matchName, index)
+void ParseLayerEffects(std::string_view effectList) {
     g_layerEffects.clear();
 
-    if (!effectList || wcslen(effectList) == 0) return;
-
-    std::wstring list(effectList);
-    size_t pos = 0;
+    WireFormat::Reader reader(effectList);
     int idx = 0;
 
-    while (pos < list.length()) {
-        // Find next semicolon or end
-        size_t end = list.find(L';', pos);
-        if (end == std::wstring::npos) end = list.length();
-
-        std::wstring item = list.substr(pos, end - pos);
-        if (!item.empty()) {
-            // Parse "name|matchName|index"
-            size_t sep1 = item.find(L'|');
-            size_t sep2 = item.find(L'|', sep1 + 1);
-
-            if (sep1 != std::wstring::npos) {
-                ControlUI::EffectItem effect;
-                std::wstring name = item.substr(0, sep1);
-                wcscpy_s(effect.name, name.c_str());
-
-                if (sep2 != std::wstring::npos) {
-                    std::wstring matchName = item.substr(sep1 + 1, sep2 - sep1 - 1);
-                    std::wstring idxStr = item.substr(sep2 + 1);
-                    wcscpy_s(effect.matchName, matchName.c_str());
-                    effect.index = _wtoi(idxStr.c_str());
-                } else {
-                    std::wstring matchName = item.substr(sep1 + 1);
-                    wcscpy_s(effect.matchName, matchName.c_str());
-                    effect.index = idx;
-                }
-
-                effect.category[0] = L'\0';
-                effect.isLayerEffect = true;
-                g_layerEffects.push_back(effect);
-                idx++;
-            }
-        }
-        pos = end + 1;
-    }
-}
-
-// Draw the control panel
-void DrawControlPanel(HDC hdc, int width, int height) {
-    Graphics graphics(hdc);
-    graphics.SetSmoothingMode(SmoothingModeAntiAlias);
-    graphics.SetTextRenderingHint(TextRenderingHintClearTypeGridFit);
-
-    // Apply scale transform - all subsequent drawing will be scaled
-    graphics.ScaleTransform(g_scaleFactor, g_scaleFactor);
-
-    // Use base width for layout (transform handles scaling)
-    int baseWidth = WINDOW_WIDTH;
-
-    // Calculate base height from actual height
-    int baseHeight = (int)(height / g_scaleFactor);
-
-    // Background (fill entire base area)
-    SolidBrush bgBrush(COLOR_BG);
-    graphics.FillRectangle(&bgBrush, 0, 0, baseWidth, baseHeight);
-
-    // Border
-    Pen borderPen(COLOR_BORDER, 1);
-    graphics.DrawRectangle(&borderPen, 0, 0, baseWidth - 1, baseHeight - 1);
+    while (reader.Next()) {
+        // Index field optional
+        if (reader.FieldCount() < 2) continue;
 
-    // Search box background (full width - only pin button on right)
-    SolidBrush searchBgBrush(COLOR_SEARCH_BG);
-    RectF searchRect(PADDING, PADDING, baseWidth - PADDING * 2 - NEW_EC_BUTTON_SIZE - 8, SEARCH_HEIGHT);
-    graphics.FillRectangle(&searchBgBrush, searchRect);
+        ControlUI::EffectItem effect;
+        reader.StringInto(WireFormat::EFFECT_NAME, effect.name, _countof(effect.name));
+        reader.StringInto(WireFormat::EFFECT_MATCH_NAME, effect.matchName, _countof(effect.matchName));
+        effect.index = reader.Int(WireFormat::EFFECT_CATEGORY_OR_INDEX, idx);
 
-    // Keep open (pin) button - right side
-    int pinBtnX = baseWidth - PADDING - NEW_EC_BUTTON_SIZE;
-    int pinBtnY = PADDING + (SEARCH_HEIGHT - NEW_EC_BUTTON_SIZE) / 2;
-    RectF pinRect((REAL)pinBtnX, (REAL)pinBtnY, (REAL)NEW_EC_BUTTON_SIZE, (REAL)NEW_EC_BUTTON_SIZE);
-
-    if (g_keepOpenButtonHover || g_keepPanelOpen) {
-        SolidBrush pinBgBrush(g_keepPanelOpen ? COLOR_PRESET_ACTIVE : COLOR_PRESET_HOVER);
-        graphics.FillRectangle(&pinBgBrush, pinRect);
-    }
-
-    // Draw pin icon
-    Color pinColor = g_keepPanelOpen ? Color(255, 255, 255, 255) : Color(255, 140, 140, 140);
-    Pen pinPen(pinColor, 1.5f);
-    float px = (float)pinBtnX, py = (float)pinBtnY;
-    float ps = (float)NEW_EC_BUTTON_SIZE;
-    graphics.DrawEllipse(&pinPen, px + ps * 0.3f, py + ps * 0.2f, ps * 0.4f, ps * 0.35f);
-    graphics.DrawLine(&pinPen, px + ps * 0.5f, py + ps * 0.55f, px + ps * 0.5f, py + ps * 0.8f);
-
-    // Search text
-    FontFamily fontFamily(L"Segoe UI");
-    Font searchFont(&fontFamily, 14, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush dimBrush(COLOR_TEXT_DIM);
-
-    RectF textRect(PADDING + 8, PADDING + 8, baseWidth - PADDING * 2 - 16, SEARCH_HEIGHT - 16);
-    StringFormat sf;
-    sf.SetAlignment(StringAlignmentNear);
-    sf.SetLineAlignment(StringAlignmentCenter);
-
-    // Draw selection highlight if any
-    bool hasSelection = (g_selectionStart >= 0 && g_selectionEnd >= 0 && g_selectionStart != g_selectionEnd);
-    if (hasSelection && wcslen(g_searchQuery) > 0) {
-        int selStart = min(g_selectionStart, g_selectionEnd);
-        int selEnd = max(g_selectionStart, g_selectionEnd);
-
-        // Measure text up to selection start and end
-        RectF startBounds, endBounds;
-        if (selStart > 0) {
-            wchar_t textBefore[256] = {0};
-            wcsncpy(textBefore, g_searchQuery, selStart);
-            graphics.MeasureString(textBefore, -1, &searchFont, textRect, &sf, &startBounds);
-        } else {
-            startBounds.Width = 0;
-        }
-        wchar_t textToEnd[256] = {0};
-        wcsncpy(textToEnd, g_searchQuery, selEnd);
-        graphics.MeasureString(textToEnd, -1, &searchFont, textRect, &sf, &endBounds);
-
-        // Draw selection rectangle
-        SolidBrush selBrush(Color(128, 74, 158, 255));  // Semi-transparent accent
-        RectF selRect(PADDING + 8 + startBounds.Width, PADDING + 8,
-                      endBounds.Width - startBounds.Width, SEARCH_HEIGHT - 16);
-        graphics.FillRectangle(&selBrush, selRect);
-    }
-
-    if (wcslen(g_searchQuery) > 0) {
-        graphics.DrawString(g_searchQuery, -1, &searchFont, textRect, &sf, &textBrush);
-    } else {
-        graphics.DrawString(L"Search effects...", -1, &searchFont, textRect, &sf, &dimBrush);
-    }
-
-    // Cursor blink
-    if (g_cursorVisible) {
-        // Measure text width up to cursor position
-        RectF bounds;
-        int cursorPos = min(g_cursorPosition, (int)wcslen(g_searchQuery));
-        if (cursorPos > 0) {
-            wchar_t textBeforeCursor[256] = {0};
-            wcsncpy(textBeforeCursor, g_searchQuery, cursorPos);
-            graphics.MeasureString(textBeforeCursor, -1, &searchFont, textRect, &sf, &bounds);
-        } else {
-            bounds.Width = 0;
-        }
-
-        Pen cursorPen(COLOR_ACCENT, 2);
-        REAL cursorX = (REAL)(PADDING + 8) + bounds.Width + 1.0f;
-        REAL cursorY1 = (REAL)(PADDING + 10);
-        REAL cursorY2 = (REAL)(PADDING + SEARCH_HEIGHT - 10);
-        graphics.DrawLine(&cursorPen, cursorX, cursorY1, cursorX, cursorY2);
-    }
-
-    // Results
-    Font itemFont(&fontFamily, 12, FontStyleRegular, UnitPixel);
-    Font categoryFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-
-    int y = PADDING + SEARCH_HEIGHT + PADDING;
-    int visibleCount = min((int)g_searchResults.size(), MAX_VISIBLE_ITEMS);
-
-    for (int i = 0; i < visibleCount; i++) {
-        const auto& item = g_searchResults[i];
-        RectF itemRect(PADDING, y, baseWidth - PADDING * 2, ITEM_HEIGHT);
-
-        // Highlight selected/hover
-        if (i == g_selectedIndex) {
-            SolidBrush selectedBrush(COLOR_ITEM_SELECTED);
-            graphics.FillRectangle(&selectedBrush, itemRect);
-        } else if (i == g_hoverIndex) {
-            SolidBrush hoverBrush(COLOR_ITEM_HOVER);
-            graphics.FillRectangle(&hoverBrush, itemRect);
-        }
-
-        // Effect name
-        RectF nameRect(PADDING + 8, y + 4, baseWidth - PADDING * 2 - 100, ITEM_HEIGHT / 2);
-        graphics.DrawString(item.name, -1, &itemFont, nameRect, &sf, &textBrush);
-
-        // Category (right aligned)
-        StringFormat sfRight;
-        sfRight.SetAlignment(StringAlignmentFar);
-        sfRight.SetLineAlignment(StringAlignmentCenter);
-        RectF catRect(baseWidth - 110, y, 100, ITEM_HEIGHT);
-        graphics.DrawString(item.category, -1, &categoryFont, catRect, &sfRight, &dimBrush);
-
-        y += ITEM_HEIGHT;
-    }
-
-    // No results message
-    if (g_searchResults.empty() && wcslen(g_searchQuery) > 0) {
-        RectF msgRect(PADDING, y, baseWidth - PADDING * 2, ITEM_HEIGHT);
-        graphics.DrawString(L"No effects found", -1, &itemFont, msgRect, &sf, &dimBrush);
+        effect.category[0] = L'\0';
+        effect.isLayerEffect = true;
+        g_layerEffects.push_back(effect);
+        idx++;
     }
 }
 
-// Draw preset icon inside a rectangle
-void DrawPresetIcon(Graphics& graphics, PresetIcon icon, RectF rect, bool filled) {
+// Preset icon inside a rectangle (IconAtlas::RasterFunc, state: filled)
+static void RasterPresetIcon(Graphics& graphics, int icon, uint32_t state, const RectF& rect) {
+    bool filled = state != 0;
     float cx = rect.X + rect.Width / 2;
     float cy = rect.Y + rect.Height / 2;
     float r = min(rect.Width, rect.Height) / 2 - 4;
 
     Color iconColor = filled ? Color(255, 255, 255, 255) : Color(255, 100, 100, 110);
-    Pen iconPen(iconColor, 2);
-    SolidBrush iconBrush(iconColor);
+    const Pen *iconPen = RenderContext::Pen(iconColor, 2);
+    const SolidBrush *iconBrush = RenderContext::Brush(iconColor);
 
     switch (icon) {
         case ICON_COLOR: {
             // Color wheel - three overlapping circles (RGB)
             float sr = r * 0.5f;
-            graphics.DrawEllipse(&iconPen, cx - sr, cy - r * 0.4f, sr * 1.4f, sr * 1.4f);
-            graphics.DrawEllipse(&iconPen, cx - sr * 0.7f - sr * 0.4f, cy + r * 0.1f, sr * 1.4f, sr * 1.4f);
-            graphics.DrawEllipse(&iconPen, cx + sr * 0.7f - sr * 0.7f, cy + r * 0.1f, sr * 1.4f, sr * 1.4f);
+            graphics.DrawEllipse(iconPen, cx - sr, cy - r * 0.4f, sr * 1.4f, sr * 1.4f);
+            graphics.DrawEllipse(iconPen, cx - sr * 0.7f - sr * 0.4f, cy + r * 0.1f, sr * 1.4f, sr * 1.4f);
+            graphics.DrawEllipse(iconPen, cx + sr * 0.7f - sr * 0.7f, cy + r * 0.1f, sr * 1.4f, sr * 1.4f);
             break;
         }
         case ICON_BLUR: {
             // Concentric circles (blur effect)
-            graphics.DrawEllipse(&iconPen, cx - r, cy - r, r * 2, r * 2);
-            graphics.DrawEllipse(&iconPen, cx - r * 0.6f, cy - r * 0.6f, r * 1.2f, r * 1.2f);
-            graphics.DrawEllipse(&iconPen, cx - r * 0.25f, cy - r * 0.25f, r * 0.5f, r * 0.5f);
+            graphics.DrawEllipse(iconPen, cx - r, cy - r, r * 2, r * 2);
+            graphics.DrawEllipse(iconPen, cx - r * 0.6f, cy - r * 0.6f, r * 1.2f, r * 1.2f);
+            graphics.DrawEllipse(iconPen, cx - r * 0.25f, cy - r * 0.25f, r * 0.5f, r * 0.5f);
             break;
         }
         case ICON_DISTORT: {
@@ -822,7 +589,7 @@ void DrawPresetIcon(Graphics& graphics, PresetIcon icon, RectF rect, bool filled
                 float wy = cy + sinf(i * 3.14159f / 2) * r * 0.5f;
                 points[i] = PointF(wx, wy);
             }
-            graphics.DrawCurve(&iconPen, points, 7, 0.5f);
+            graphics.DrawCurve(iconPen, points, 7, 0.5f);
             break;
         }
         case ICON_STAR: {
@@ -835,7 +602,7 @@ void DrawPresetIcon(Graphics& graphics, PresetIcon icon, RectF rect, bool filled
                 starPoints[i] = PointF(cx + cosf(angle) * sr, cy + sinf(angle) * sr);
             }
             path.AddPolygon(starPoints, 10);
-            graphics.FillPath(&iconBrush, &path);
+            graphics.FillPath(iconBrush, &path);
             break;
         }
         case ICON_LIGHTNING: {
@@ -851,21 +618,21 @@ void DrawPresetIcon(Graphics& graphics, PresetIcon icon, RectF rect, bool filled
             };
             GraphicsPath path;
             path.AddPolygon(bolt, 7);
-            graphics.FillPath(&iconBrush, &path);
+            graphics.FillPath(iconBrush, &path);
             break;
         }
         case ICON_MAGIC: {
             // Magic wand with sparkle
             // Wand diagonal line
-            Pen wandPen(iconColor, 2.5f);
-            graphics.DrawLine(&wandPen, cx - r * 0.7f, cy + r * 0.7f, cx + r * 0.5f, cy - r * 0.5f);
+            const Pen *wandPen = RenderContext::Pen(iconColor, 2.5f);
+            graphics.DrawLine(wandPen, cx - r * 0.7f, cy + r * 0.7f, cx + r * 0.5f, cy - r * 0.5f);
             // Sparkle at tip
             float sx = cx + r * 0.5f, sy = cy - r * 0.5f;
-            Pen sparklePen(iconColor, 1.5f);
-            graphics.DrawLine(&sparklePen, sx - r * 0.3f, sy, sx + r * 0.3f, sy);
-            graphics.DrawLine(&sparklePen, sx, sy - r * 0.3f, sx, sy + r * 0.3f);
-            graphics.DrawLine(&sparklePen, sx - r * 0.2f, sy - r * 0.2f, sx + r * 0.2f, sy + r * 0.2f);
-            graphics.DrawLine(&sparklePen, sx + r * 0.2f, sy - r * 0.2f, sx - r * 0.2f, sy + r * 0.2f);
+            const Pen *sparklePen = RenderContext::Pen(iconColor, 1.5f);
+            graphics.DrawLine(sparklePen, sx - r * 0.3f, sy, sx + r * 0.3f, sy);
+            graphics.DrawLine(sparklePen, sx, sy - r * 0.3f, sx, sy + r * 0.3f);
+            graphics.DrawLine(sparklePen, sx - r * 0.2f, sy - r * 0.2f, sx + r * 0.2f, sy + r * 0.2f);
+            graphics.DrawLine(sparklePen, sx + r * 0.2f, sy - r * 0.2f, sx - r * 0.2f, sy + r * 0.2f);
             break;
         }
         default:
@@ -873,295 +640,85 @@ void DrawPresetIcon(Graphics& graphics, PresetIcon icon, RectF rect, bool filled
     }
 }
 
-// Draw save icon (floppy disk)
-void DrawSaveIcon(Graphics& graphics, RectF rect, bool hover) {
+// Save icon, floppy disk (IconAtlas::RasterFunc, state: hover)
+static void RasterSaveIcon(Graphics& graphics, int, uint32_t state, const RectF& rect) {
+    bool hover = state != 0;
     float cx = rect.X + rect.Width / 2;
     float cy = rect.Y + rect.Height / 2;
     float s = min(rect.Width, rect.Height) / 2 - 3;
 
     Color iconColor = hover ? Color(255, 74, 207, 255) : Color(255, 200, 200, 200);
-    Pen iconPen(iconColor, 1.5f);
-    SolidBrush iconBrush(iconColor);
+    const Pen *iconPen = RenderContext::Pen(iconColor, 1.5f);
+    const SolidBrush *iconBrush = RenderContext::Brush(iconColor);
 
     // Floppy disk outline
     RectF diskRect(cx - s, cy - s, s * 2, s * 2);
-    graphics.DrawRectangle(&iconPen, diskRect);
+    graphics.DrawRectangle(iconPen, diskRect);
 
     // Metal slider area at top
     RectF sliderRect(cx - s * 0.6f, cy - s, s * 1.2f, s * 0.5f);
-    graphics.FillRectangle(&iconBrush, sliderRect);
+    graphics.FillRectangle(iconBrush, sliderRect);
 
     // Label area at bottom
     RectF labelRect(cx - s * 0.7f, cy + s * 0.1f, s * 1.4f, s * 0.7f);
-    graphics.DrawRectangle(&iconPen, labelRect);
+    graphics.DrawRectangle(iconPen, labelRect);
 }
 
-// Draw the effects panel (Mode 2)
-void DrawEffectsPanel(HDC hdc, int width, int height) {
-    Graphics graphics(hdc);
-    graphics.SetSmoothingMode(SmoothingModeAntiAlias);
-    graphics.SetTextRenderingHint(TextRenderingHintClearTypeGridFit);
+// Draw preset icon inside a rectangle (rasterized once per scale)
+void DrawPresetIcon(Graphics& graphics, PresetIcon icon, RectF rect, bool filled) {
+    IconAtlas::Draw(graphics, IconAtlas::OWNER_CONTROL, icon, filled ? 1 : 0, rect, RasterPresetIcon);
+}
 
-    // Apply scale transform
-    graphics.ScaleTransform(g_scaleFactor, g_scaleFactor);
+// Draw save icon (floppy disk)
+void DrawSaveIcon(Graphics& graphics, RectF rect, bool hover) {
+    // Atlas id past the preset icons
+    IconAtlas::Draw(graphics, IconAtlas::OWNER_CONTROL, ICON_COUNT, hover ? 1 : 0, rect, RasterSaveIcon);
+}
 
-    // Use base dimensions for layout
-    int baseWidth = WINDOW_WIDTH;
-    int baseHeight = (int)(height / g_scaleFactor);
-
-    // Background
-    SolidBrush bgBrush(COLOR_BG);
-    graphics.FillRectangle(&bgBrush, 0, 0, baseWidth, baseHeight);
-
-    // Border
-    Pen borderPen(COLOR_BORDER, 1);
-    graphics.DrawRectangle(&borderPen, 0, 0, baseWidth - 1, baseHeight - 1);
-
-    // Fonts
-    FontFamily fontFamily(L"Segoe UI");
-    Font headerFont(&fontFamily, 12, FontStyleBold, UnitPixel);
-    Font itemFont(&fontFamily, 12, FontStyleRegular, UnitPixel);
-    Font indexFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush dimBrush(COLOR_TEXT_DIM);
-    SolidBrush accentBrush(COLOR_ACCENT);
-
-    StringFormat sf;
-    sf.SetAlignment(StringAlignmentNear);
-    sf.SetLineAlignment(StringAlignmentCenter);
-
-    StringFormat sfCenter;
-    sfCenter.SetAlignment(StringAlignmentCenter);
-    sfCenter.SetLineAlignment(StringAlignmentCenter);
-
-    int currentY = PADDING;
-
-    // ===== Header bar with layer name and label color =====
-    // Label color indicator (small square)
-    int labelSize = 8;
-    int labelX = PADDING + 4;
-    int labelY = currentY + (HEADER_HEIGHT - labelSize) / 2;
-    int labelIndex = (g_currentLayerLabelColor >= 0 && g_currentLayerLabelColor <= 16) ? g_currentLayerLabelColor : 0;
-    SolidBrush labelBrush(LABEL_COLORS[labelIndex]);
-    graphics.FillRectangle(&labelBrush, labelX, labelY, labelSize, labelSize);
-
-    // Layer name
-    RectF titleRect(PADDING + labelSize + 10, currentY, baseWidth - PADDING * 2 - NEW_EC_BUTTON_SIZE - 10, HEADER_HEIGHT);
-    if (wcslen(g_currentLayerName) > 0) {
-        graphics.DrawString(g_currentLayerName, -1, &headerFont, titleRect, &sf, &textBrush);
+// Draw the panel: Canvas (ControlPaint), then the preset / save icons
+void DrawPanel(HDC hdc, int width, int height) {
+    PanelState state;
+    state.mode = g_panelMode;
+    state.scale = g_scaleFactor;
+    state.query = g_searchQuery;
+    state.cursorPosition = g_cursorPosition;
+    state.cursorVisible = g_cursorVisible;
+    state.selectionStart = g_selectionStart;
+    state.selectionEnd = g_selectionEnd;
+    state.searchResults = &g_searchResults;
+    state.layerEffects = &g_layerEffects;
+    state.selectedIndex = g_selectedIndex;
+    state.hoverIndex = g_hoverIndex;
+    state.keepPanelOpen = g_keepPanelOpen;
+    state.keepOpenHover = g_keepOpenButtonHover;
+    state.newECHover = g_newECButtonHover;
+    state.layerName = g_currentLayerName;
+    state.labelColor = g_currentLayerLabelColor;
+    state.presetIcons = g_presetIcons;
+    state.hoveredPreset = g_hoveredPresetButton;
+    state.saveMode = g_saveMode;
+    state.saveHover = g_saveButtonHover;
+
+    g_surface.Resize(width, height);
+    IconSlot icons[PRESET_SLOT_COUNT + 1];
+    int iconCount = 0;
+    if (g_panelMode == ControlUI::MODE_SEARCH) {
+        DrawSearchPanel(g_surface, state);
     } else {
-        graphics.DrawString(L"Selected Layer", -1, &headerFont, titleRect, &sf, &dimBrush);
-    }
-
-    // Keep open (pin) button - right side
-    int pinBtnX = baseWidth - PADDING - NEW_EC_BUTTON_SIZE;
-    int pinBtnY = currentY + (HEADER_HEIGHT - NEW_EC_BUTTON_SIZE) / 2;
-    RectF pinRect((REAL)pinBtnX, (REAL)pinBtnY, (REAL)NEW_EC_BUTTON_SIZE, (REAL)NEW_EC_BUTTON_SIZE);
-
-    if (g_keepOpenButtonHover || g_keepPanelOpen) {
-        SolidBrush pinBgBrush(g_keepPanelOpen ? COLOR_PRESET_ACTIVE : COLOR_PRESET_HOVER);
-        graphics.FillRectangle(&pinBgBrush, pinRect);
+        iconCount = DrawEffectsPanel(g_surface, state, icons);
     }
+    Canvas::Blit(g_surface, hdc, 0, 0);
 
-    // Draw pin icon (pushpin)
-    Color pinColor = g_keepPanelOpen ? Color(255, 255, 255, 255) : Color(255, 140, 140, 140);
-    Pen pinPen(pinColor, 1.5f);
-    float px = (float)pinBtnX, py = (float)pinBtnY;
-    float ps = (float)NEW_EC_BUTTON_SIZE;
-    // Pin head (circle)
-    graphics.DrawEllipse(&pinPen, px + ps * 0.3f, py + ps * 0.2f, ps * 0.4f, ps * 0.35f);
-    // Pin needle (line down)
-    graphics.DrawLine(&pinPen, px + ps * 0.5f, py + ps * 0.55f, px + ps * 0.5f, py + ps * 0.8f);
-
-    // New EC window button [+] - left of pin button
-    int newECBtnX = pinBtnX - NEW_EC_BUTTON_SIZE - 4;
-    int newECBtnY = currentY + (HEADER_HEIGHT - NEW_EC_BUTTON_SIZE) / 2;
-    RectF newECRect((REAL)newECBtnX, (REAL)newECBtnY, (REAL)NEW_EC_BUTTON_SIZE, (REAL)NEW_EC_BUTTON_SIZE);
-
-    if (g_newECButtonHover) {
-        SolidBrush newECBgBrush(COLOR_PRESET_HOVER);
-        graphics.FillRectangle(&newECBgBrush, newECRect);
-    }
-
-    // Draw + sign
-    Pen plusPen(COLOR_ACCENT, 2);
-    float plusMargin = 5.0f;
-    graphics.DrawLine(&plusPen,
-        (REAL)(newECBtnX + plusMargin), (REAL)(newECBtnY + NEW_EC_BUTTON_SIZE / 2),
-        (REAL)(newECBtnX + NEW_EC_BUTTON_SIZE - plusMargin), (REAL)(newECBtnY + NEW_EC_BUTTON_SIZE / 2));
-    graphics.DrawLine(&plusPen,
-        (REAL)(newECBtnX + NEW_EC_BUTTON_SIZE / 2), (REAL)(newECBtnY + plusMargin),
-        (REAL)(newECBtnX + NEW_EC_BUTTON_SIZE / 2), (REAL)(newECBtnY + NEW_EC_BUTTON_SIZE - plusMargin));
-
-    currentY += HEADER_HEIGHT + 4;
-
-    // ===== Preset buttons bar with icons =====
-    int presetBarY = currentY;
-    int presetBtnSpacing = 4;
-    // 6 preset buttons + save button
-    int totalPresetWidth = PRESET_SLOT_COUNT * (PRESET_BUTTON_HEIGHT + presetBtnSpacing) + SAVE_BUTTON_SIZE + presetBtnSpacing;
-    int presetStartX = (baseWidth - totalPresetWidth) / 2;
-
-    for (int i = 0; i < PRESET_SLOT_COUNT; i++) {
-        int btnX = presetStartX + i * (PRESET_BUTTON_HEIGHT + presetBtnSpacing);
-        int btnY = presetBarY + (PRESET_BAR_HEIGHT - PRESET_BUTTON_HEIGHT) / 2;
-
-        RectF btnRect((REAL)btnX, (REAL)btnY, (REAL)PRESET_BUTTON_HEIGHT, (REAL)PRESET_BUTTON_HEIGHT);
-        bool hasFx = (g_presetIcons[i] != ICON_NONE);
-
-        // Button background
-        Color btnColor;
-        if (g_saveMode) {
-            // Save mode: orange glow
-            btnColor = (i == g_hoveredPresetButton) ? Color(255, 255, 180, 0) : Color(255, 200, 120, 0);
-        } else {
-            btnColor = (i == g_hoveredPresetButton) ? COLOR_PRESET_HOVER :
-                       hasFx ? COLOR_PRESET_ACTIVE : COLOR_PRESET_BG;
-        }
-        SolidBrush btnBrush(btnColor);
-        graphics.FillRectangle(&btnBrush, btnRect);
-
-        // Button border
-        if (hasFx) {
-            Pen btnBorder(COLOR_BORDER, 1);
-            graphics.DrawRectangle(&btnBorder, btnRect);
+    if (iconCount == 0) return;
+    Graphics graphics(hdc);
+    graphics.SetSmoothingMode(SmoothingModeAntiAlias);
+    graphics.ScaleTransform(g_scaleFactor, g_scaleFactor);
+    for (int i = 0; i < iconCount; i++) {
+        RectF rect(icons[i].x, icons[i].y, icons[i].size, icons[i].size);
+        if (icons[i].icon == ICON_COUNT) {
+            DrawSaveIcon(graphics, rect, icons[i].on);
         } else {
-            // Empty slot: dashed border
-            Pen dashPen(Color(255, 80, 80, 90), 1);
-            float dashes[] = {3.0f, 3.0f};
-            dashPen.SetDashPattern(dashes, 2);
-            graphics.DrawRectangle(&dashPen, btnRect);
-        }
-
-        // Draw icon or empty state
-        if (hasFx) {
-            DrawPresetIcon(graphics, g_presetIcons[i], btnRect, true);
-        }
-    }
-
-    // Save button (floppy disk icon) - right of preset buttons
-    int saveBtnX = presetStartX + PRESET_SLOT_COUNT * (PRESET_BUTTON_HEIGHT + presetBtnSpacing);
-    int saveBtnY = presetBarY + (PRESET_BAR_HEIGHT - SAVE_BUTTON_SIZE) / 2;
-    RectF saveRect((REAL)saveBtnX, (REAL)saveBtnY, (REAL)SAVE_BUTTON_SIZE, (REAL)SAVE_BUTTON_SIZE);
-
-    Color saveBtnColor = g_saveMode ? COLOR_PRESET_ACTIVE :
-                         g_saveButtonHover ? COLOR_PRESET_HOVER : COLOR_PRESET_BG;
-    SolidBrush saveBtnBrush(saveBtnColor);
-    graphics.FillRectangle(&saveBtnBrush, saveRect);
-
-    Pen saveBorder(COLOR_BORDER, 1);
-    graphics.DrawRectangle(&saveBorder, saveRect);
-
-    // Draw save icon
-    DrawSaveIcon(graphics, saveRect, g_saveButtonHover || g_saveMode);
-
-    currentY += PRESET_BAR_HEIGHT;
-
-    // ===== Search bar =====
-    SolidBrush searchBgBrush(COLOR_SEARCH_BG);
-    RectF searchRect(PADDING, currentY, baseWidth - PADDING * 2, SEARCH_HEIGHT);
-    graphics.FillRectangle(&searchBgBrush, searchRect);
-
-    // Search text or placeholder
-    RectF searchTextRect(PADDING + 8, currentY, baseWidth - PADDING * 2 - 16, SEARCH_HEIGHT);
-    if (wcslen(g_searchQuery) > 0) {
-        graphics.DrawString(g_searchQuery, -1, &itemFont, searchTextRect, &sf, &textBrush);
-    } else {
-        graphics.DrawString(L"Search effects...", -1, &itemFont, searchTextRect, &sf, &dimBrush);
-    }
-
-    currentY += SEARCH_HEIGHT + PADDING;
-
-    // ===== Show search results or layer effects =====
-    bool isSearching = wcslen(g_searchQuery) > 0;
-
-    if (isSearching) {
-        // Show search results
-        int visibleCount = min((int)g_searchResults.size(), MAX_VISIBLE_ITEMS);
-
-        if (visibleCount == 0) {
-            RectF msgRect(PADDING, currentY, baseWidth - PADDING * 2, ITEM_HEIGHT);
-            graphics.DrawString(L"No matching effects", -1, &itemFont, msgRect, &sf, &dimBrush);
-            return;
-        }
-
-        for (int i = 0; i < visibleCount; i++) {
-            const auto& item = g_searchResults[i];
-            RectF itemRect(PADDING, currentY, baseWidth - PADDING * 2, ITEM_HEIGHT);
-
-            // Highlight selected/hover
-            if (i == g_selectedIndex) {
-                SolidBrush selectedBrush(COLOR_ITEM_SELECTED);
-                graphics.FillRectangle(&selectedBrush, itemRect);
-            } else if (i == g_hoverIndex) {
-                SolidBrush hoverBrush(COLOR_ITEM_HOVER);
-                graphics.FillRectangle(&hoverBrush, itemRect);
-            }
-
-            // Effect name
-            RectF nameRect(PADDING + 8, currentY, baseWidth - PADDING * 2 - 100, ITEM_HEIGHT);
-            graphics.DrawString(item.name, -1, &itemFont, nameRect, &sf, &textBrush);
-
-            // Category
-            RectF catRect(baseWidth - PADDING - 90, currentY, 80, ITEM_HEIGHT);
-            StringFormat sfRight;
-            sfRight.SetAlignment(StringAlignmentFar);
-            sfRight.SetLineAlignment(StringAlignmentCenter);
-            graphics.DrawString(item.category, -1, &indexFont, catRect, &sfRight, &dimBrush);
-
-            currentY += ITEM_HEIGHT;
-        }
-    } else {
-        // Show layer effects list
-        int visibleCount = min((int)g_layerEffects.size(), MAX_VISIBLE_ITEMS);
-
-        if (visibleCount == 0) {
-            RectF msgRect(PADDING, currentY, baseWidth - PADDING * 2, ITEM_HEIGHT);
-            graphics.DrawString(L"No effects on layer", -1, &itemFont, msgRect, &sf, &dimBrush);
-            return;
-        }
-
-        for (int i = 0; i < visibleCount; i++) {
-            const auto& item = g_layerEffects[i];
-            RectF itemRect(PADDING, currentY, baseWidth - PADDING * 2, ITEM_HEIGHT);
-
-            // Highlight selected/hover
-            if (i == g_selectedIndex) {
-                SolidBrush selectedBrush(COLOR_ITEM_SELECTED);
-                graphics.FillRectangle(&selectedBrush, itemRect);
-            } else if (i == g_hoverIndex) {
-                SolidBrush hoverBrush(COLOR_ITEM_HOVER);
-                graphics.FillRectangle(&hoverBrush, itemRect);
-            }
-
-            // Expand icon (▶)
-            RectF expandRect(PADDING + 4, currentY, 16, ITEM_HEIGHT);
-            graphics.DrawString(L"\u25B6", -1, &indexFont, expandRect, &sf, &dimBrush);
-
-            // Effect index number
-            wchar_t indexStr[8];
-            swprintf_s(indexStr, L"%d.", item.index + 1);
-            RectF indexRect(PADDING + 20, currentY, 24, ITEM_HEIGHT);
-            graphics.DrawString(indexStr, -1, &indexFont, indexRect, &sf, &dimBrush);
-
-            // Effect name
-            RectF nameRect(PADDING + 44, currentY, baseWidth - PADDING * 2 - 80, ITEM_HEIGHT);
-            graphics.DrawString(item.name, -1, &itemFont, nameRect, &sf, &textBrush);
-
-            // Delete button [x]
-            int btnX = baseWidth - PADDING - ACTION_BUTTON_SIZE - 4;
-            int btnY = currentY + (ITEM_HEIGHT - ACTION_BUTTON_SIZE) / 2;
-
-            Pen deletePen(Color(255, 200, 80, 80), 1.5f);
-            float btnMargin = 5.0f;
-            graphics.DrawLine(&deletePen,
-                (REAL)(btnX + btnMargin), (REAL)(btnY + btnMargin),
-                (REAL)(btnX + ACTION_BUTTON_SIZE - btnMargin), (REAL)(btnY + ACTION_BUTTON_SIZE - btnMargin));
-            graphics.DrawLine(&deletePen,
-                (REAL)(btnX + ACTION_BUTTON_SIZE - btnMargin), (REAL)(btnY + btnMargin),
-                (REAL)(btnX + btnMargin), (REAL)(btnY + ACTION_BUTTON_SIZE - btnMargin));
-
-            currentY += ITEM_HEIGHT;
+            DrawPresetIcon(graphics, (PresetIcon)icons[i].icon, rect, icons[i].on);
         }
     }
 }
@@ -1170,6 +727,11 @@ void DrawEffectsPanel(HDC hdc, int width, int height) {
 LRESULT CALLBACK ControlWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
         case WM_PAINT: {
+            TRACE_SCOPE("paint", g_panelMode == ControlUI::MODE_SEARCH
+                                           ? "ControlPaint::DrawSearchPanel"
+                                           : "ControlPaint::DrawEffectsPanel");
+            PROFILE_SCOPE(g_panelMode == ControlUI::MODE_SEARCH ? "paint.control.search"
+                                                                : "paint.control.effects");
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hwnd, &ps);
 
@@ -1177,22 +739,11 @@ LRESULT CALLBACK ControlWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPara
             GetClientRect(hwnd, &rc);
 
             // Double buffer
-            HDC memDC = CreateCompatibleDC(hdc);
-            HBITMAP memBitmap = CreateCompatibleBitmap(hdc, rc.right, rc.bottom);
-            HBITMAP oldBitmap = (HBITMAP)SelectObject(memDC, memBitmap);
-
-            // Draw based on mode
-            if (g_panelMode == ControlUI::MODE_SEARCH) {
-                DrawControlPanel(memDC, rc.right, rc.bottom);
-            } else {
-                DrawEffectsPanel(memDC, rc.right, rc.bottom);
-            }
+            HDC memDC = g_backbuffer.Begin(hdc, rc.right, rc.bottom);
 
-            BitBlt(hdc, 0, 0, rc.right, rc.bottom, memDC, 0, 0, SRCCOPY);
+            DrawPanel(memDC, rc.right, rc.bottom);
 
-            SelectObject(memDC, oldBitmap);
-            DeleteObject(memBitmap);
-            DeleteDC(memDC);
+            g_backbuffer.Present(hdc, rc.right, rc.bottom);
 
             EndPaint(hwnd, &ps);
             return 0;
@@ -1845,7 +1396,7 @@ void ControlUI::SetLayerInfo(const wchar_t* layerName, int labelColor) {
 
 namespace ControlUI {
 
-void Initialize() {}
+bool Initialize() { return true; }
 void Shutdown() {}
 void SetMode(PanelMode) {}
 PanelMode GetMode() { return MODE_SEARCH; }
@@ -1856,8 +1407,9 @@ bool IsVisible() { return false; }
 ControlResult GetResult() { return ControlResult(); }
 ControlSettings& GetSettings() { static ControlSettings s; return s; }
 void UpdateSearch(const wchar_t*) {}
-void SetAvailableEffects(const wchar_t*) {}
-void SetLayerEffects(const wchar_t*) {}
+void SetAvailableEffects(const CatalogCache::Catalog&) {}
+void SetAvailableEffects(std::vector<EffectItem>&&) {}
+void SetLayerEffects(std::string_view) {}
 void ClearLayerEffects() {}
 void SetPresetSlotFilled(int, bool) {}
 bool IsPresetSlotFilled(int) { return false; }
@@ -10,6 +10,13 @@
 #ifndef CONTROLUI_H
 #define CONTROLUI_H
 
+#include <string_view>
+#include <vector>
+
+namespace CatalogCache {
+class Catalog;
+}
+
 namespace ControlUI {
 
 // Panel modes
@@ -61,7 +68,8 @@ struct ControlSettings {
 };
 
 // Initialize the Control UI system
-void Initialize();
+// @return false if GDI+ or the window (class) could not be created
+bool Initialize();
 
 // Cleanup
 void Shutdown();
@@ -94,12 +102,16 @@ ControlSettings& GetSettings();
 void UpdateSearch(const wchar_t* query);
 
 // Set available effects list (from AE - localized names)
-// effectList format: "displayName|matchName|category;displayName|matchName|category;..."
-void SetAvailableEffects(const wchar_t* effectList);
+// catalog records: name, matchName, category (WireFormat::EffectField order)
+void SetAvailableEffects(const CatalogCache::Catalog& catalog);
+
+// Set available effects list from items already converted by the caller
+// (AEGP Effect Suite enumeration): adopted as is, no catalog round trip
+void SetAvailableEffects(std::vector<EffectItem>&& effects);
 
-// Set layer effects list (Mode 2)
-// effectList format: "name1|matchName1;name2|matchName2;..."
-void SetLayerEffects(const wchar_t* effectList);
+// Set layer effects list (Mode 2, UTF-8 script result)
+// effectList format: layerEffects() wire records (name, matchName, index)
+void SetLayerEffects(std::string_view effectList);
 
 // Clear layer effects
 void ClearLayerEffects();
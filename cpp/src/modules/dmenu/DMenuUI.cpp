@@ -7,6 +7,9 @@
 
 #include "DMenuUI.h"
 #include "GdiPlusIncludes.h"
+#include "Profiler.h"
+#include "RenderContext.h"
+#include "Tracer.h"
 
 #ifdef MSWindows
 #include <windowsx.h>
@@ -71,7 +74,8 @@ static const int MENU_ITEM_COUNT = 6;
 // Global state
 static HWND g_hwnd = NULL;
 static bool g_visible = false;
-static ULONG_PTR g_gdiplusToken = 0;
+static bool g_renderAcquired = false;
+static RenderContext::Backbuffer g_backbuffer;
 static MenuAction g_action = ACTION_NONE;
 static int g_hoverIndex = -1;
 static std::chrono::steady_clock::time_point g_showTime;  // When menu was shown
@@ -84,15 +88,14 @@ static int HitTest(int x, int y);
 /*****************************************************************************
  * Initialize
  *****************************************************************************/
-void Initialize() {
-    if (g_hwnd) return;
-
-    // Initialize GDI+
-    GdiplusStartupInput gdiplusStartupInput;
-    Status gdipStatus = GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, NULL);
-    if (gdipStatus != Ok) {
-        return;
+bool Initialize() {
+    if (g_hwnd) return true;
+
+    // Join the shared GDI+ session
+    if (!RenderContext::Acquire()) {
+        return false;
     }
+    g_renderAcquired = true;
 
     // Register window class
     WNDCLASSEXW wc = {0};
@@ -105,9 +108,9 @@ void Initialize() {
     wc.lpszClassName = L"DMenuUIWindow";
     ATOM classAtom = RegisterClassExW(&wc);
     if (classAtom == 0 && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
-        return;
+        RenderContext::Release();
+        g_renderAcquired = false;
+        return false;
     }
 
     // Create window (initially hidden) - NOTE: NO WS_EX_NOACTIVATE, we WANT focus
@@ -121,10 +124,11 @@ void Initialize() {
     );
 
     if (!g_hwnd) {
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
-        return;
+        RenderContext::Release();
+        g_renderAcquired = false;
+        return false;
     }
+    return true;
 }
 
 /*****************************************************************************
@@ -135,9 +139,10 @@ void Shutdown() {
         DestroyWindow(g_hwnd);
         g_hwnd = NULL;
     }
-    if (g_gdiplusToken) {
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
+    g_backbuffer.Release();
+    if (g_renderAcquired) {
+        RenderContext::Release();
+        g_renderAcquired = false;
     }
 }
 
@@ -273,20 +278,19 @@ static void Draw(HDC hdc) {
     g.ScaleTransform(g_scaleFactor, g_scaleFactor);
 
     // Background with rounded corners
-    SolidBrush bgBrush(COLOR_BG);
-    Pen borderPen(COLOR_BORDER, 1);
+    const SolidBrush *bgBrush = RenderContext::Brush(COLOR_BG);
+    const Pen *borderPen = RenderContext::Pen(COLOR_BORDER, 1);
 
     // Simple rectangle for now
-    g.FillRectangle(&bgBrush, 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
-    g.DrawRectangle(&borderPen, 0, 0, WINDOW_WIDTH - 1, WINDOW_HEIGHT - 1);
+    g.FillRectangle(bgBrush, 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+    g.DrawRectangle(borderPen, 0, 0, WINDOW_WIDTH - 1, WINDOW_HEIGHT - 1);
 
     // Menu items
-    FontFamily fontFamily(L"Segoe UI");
-    Font keyFont(&fontFamily, 11, FontStyleBold, UnitPixel);
-    Font labelFont(&fontFamily, 11, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush keyBrush(COLOR_KEY);
-    SolidBrush hoverBrush(COLOR_ITEM_HOVER);
+    const Font *keyFont = RenderContext::Font(11, FontStyleBold);
+    const Font *labelFont = RenderContext::Font(11);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
+    const SolidBrush *keyBrush = RenderContext::Brush(COLOR_KEY);
+    const SolidBrush *hoverBrush = RenderContext::Brush(COLOR_ITEM_HOVER);
 
     int itemY = PADDING;
     for (int i = 0; i < MENU_ITEM_COUNT; i++) {
@@ -294,18 +298,18 @@ static void Draw(HDC hdc) {
 
         // Hover background
         if (i == g_hoverIndex) {
-            g.FillRectangle(&hoverBrush, itemRect.left, itemRect.top,
+            g.FillRectangle(hoverBrush, itemRect.left, itemRect.top,
                            itemRect.right - itemRect.left, itemRect.bottom - itemRect.top);
         }
 
         // Key indicator [A]
         wchar_t keyText[4];
         swprintf(keyText, 4, L"[%c]", MENU_ITEMS[i].key);
-        g.DrawString(keyText, -1, &keyFont, PointF((REAL)(PADDING + 4), (REAL)(itemY + 5)), &keyBrush);
+        g.DrawString(keyText, -1, keyFont, PointF((REAL)(PADDING + 4), (REAL)(itemY + 5)), keyBrush);
 
         // Label
-        g.DrawString(MENU_ITEMS[i].label, -1, &labelFont,
-                    PointF((REAL)(PADDING + 40), (REAL)(itemY + 6)), &textBrush);
+        g.DrawString(MENU_ITEMS[i].label, -1, labelFont,
+                    PointF((REAL)(PADDING + 40), (REAL)(itemY + 6)), textBrush);
 
         itemY += ITEM_HEIGHT;
     }
@@ -317,9 +321,15 @@ static void Draw(HDC hdc) {
 static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
     case WM_PAINT: {
+        TRACE_SCOPE("paint", "DMenuUI::Draw");
+        PROFILE_SCOPE("paint.dmenu");
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
-        Draw(hdc);
+        RECT rect;
+        GetClientRect(hwnd, &rect);
+        HDC memDC = g_backbuffer.Begin(hdc, rect.right, rect.bottom);
+        Draw(memDC);
+        g_backbuffer.Present(hdc, rect.right, rect.bottom);
         EndPaint(hwnd, &ps);
         return 0;
     }
@@ -431,7 +441,7 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPara
 
 namespace DMenuUI {
 
-void Initialize() {}
+bool Initialize() { return true; }
 void Shutdown() {}
 void ShowMenu(int x, int y) { (void)x; (void)y; }
 void HideMenu() {}
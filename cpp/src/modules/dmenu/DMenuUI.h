@@ -28,7 +28,8 @@ enum MenuAction {
 };
 
 // Initialize the D Menu UI system
-void Initialize();
+// @return false if GDI+ or the window (class) could not be created
+bool Initialize();
 
 // Cleanup
 void Shutdown();
@@ -0,0 +1,221 @@
+/*****************************************************************************
+ * GridPaint.cpp
+ *
+ * Grid window geometry and cell rendering on Canvas (see GridPaint.h)
+ *****************************************************************************/
+
+#include "GridPaint.h"
+
+namespace GridPaint {
+
+// Base sizes at scale 1.0
+static const int BASE_SIDE_PANEL_WIDTH = 52;
+static const int BASE_ICON_SIZE = 34;
+static const int BASE_ICON_SPACING = 16;
+static const int BASE_GRID_PIXELS = 120;
+
+Layout ComputeLayout(const NativeUI::GridConfig &config) {
+  Layout layout;
+
+  // FIXED grid area size with scale applied
+  // 10 steps: -20% to +70% (scale factors 0.8 to 1.7)
+  // Use config.cellSize to infer scale (40 base * factor)
+  static const float SCALE_FACTORS[] = {0.8f, 0.9f, 1.0f, 1.1f, 1.2f,
+                                        1.3f, 1.4f, 1.5f, 1.6f, 1.7f};
+  int scaleIndex = 9; // 40 * 1.7 = 68
+  for (int i = 0; i < 9; i++) {
+    if (config.cellSize <= 32 + i * 4) {
+      scaleIndex = i;
+      break;
+    }
+  }
+  layout.scale = SCALE_FACTORS[scaleIndex];
+  layout.fixedGridPixels = (int)(BASE_GRID_PIXELS * layout.scale);
+
+  // Scaled icon dimensions
+  layout.sidePanelWidth = (int)(BASE_SIDE_PANEL_WIDTH * layout.scale);
+  layout.iconSize = (int)(BASE_ICON_SIZE * layout.scale);
+  layout.iconSpacing = (int)(BASE_ICON_SPACING * layout.scale);
+
+  // Scale margin (base margin = 2)
+  layout.margin = (int)(config.margin * layout.scale);
+  if (layout.margin < 1)
+    layout.margin = 1;
+
+  // Calculate cellSize based on max dimension (like FX Console null parents)
+  layout.gridWidth = config.gridWidth;
+  layout.gridHeight = config.gridHeight;
+  int maxDim = (config.gridWidth > config.gridHeight) ? config.gridWidth : config.gridHeight;
+  int spacing = config.spacing;
+  layout.cellSize = (layout.fixedGridPixels - (maxDim - 1) * spacing) / maxDim;
+  if (layout.cellSize < 10)
+    layout.cellSize = 10; // Minimum cell size
+  int cellTotal = layout.cellSize + spacing;
+
+  // Actual grid pixels (always fits within fixedGridPixels)
+  int gridPixelsW = config.gridWidth * cellTotal;
+  int gridPixelsH = config.gridHeight * cellTotal;
+
+  // Window: FIXED size (use scaled margin)
+  layout.windowWidth =
+      layout.sidePanelWidth + layout.fixedGridPixels + layout.margin * 2 + layout.sidePanelWidth;
+
+  int minHeight = layout.iconSize * 3 + layout.iconSpacing * 2 + (int)(20 * layout.scale);
+  int bottomButtonsHeight = layout.iconSize + (int)(10 * layout.scale);
+  int gridAreaHeight = layout.fixedGridPixels + layout.margin * 2;
+  int baseHeight = (gridAreaHeight > minHeight) ? gridAreaHeight : minHeight;
+  layout.windowHeight = baseHeight + bottomButtonsHeight;
+
+  // Calculate vertical padding to center grid area when window is taller due to icons
+  layout.verticalPadding = (baseHeight - gridAreaHeight) / 2;
+
+  // Grid offset: center the actual grid within the fixed area
+  layout.offsetX = (layout.fixedGridPixels - gridPixelsW) / 2;
+  layout.offsetY = (layout.fixedGridPixels - gridPixelsH) / 2;
+  return layout;
+}
+
+Style MakeStyle(const Layout &layout, const NativeUI::GridSettings &settings) {
+  using Canvas::Argb;
+
+  Style style;
+  style.radius = layout.cellSize / 10;     // Slightly larger dots
+  style.hoverRadius = layout.cellSize / 7; // Enhanced hover glow (was /8)
+
+  // cellOpacity: 0 = fully transparent (no background), 100 = fully opaque
+  uint32_t cellAlpha = settings.cellOpacity > 0 ? (uint32_t)(settings.cellOpacity * 255 / 100) : 0;
+  style.cellBackground = Argb(cellAlpha, 35, 35, 40);
+  style.separator = Argb(200, 100, 100, 100); // Brighter semi-transparent gray
+
+  // Apply gridOpacity (mark opacity) to line/mark colors; glow stays full
+  uint32_t markAlpha = (uint32_t)(settings.gridOpacity * 255 / 100) & 0xFF;
+  if (settings.useCompMode) { // Orange / warm
+    style.line = Argb(markAlpha, 90, 70, 42);
+    style.glowInner = Argb(255, 255, 180, 74);
+    style.glowMid = Argb(255, 154, 100, 42);
+    style.glowOuter = Argb(255, 110, 80, 42);
+  } else { // Selection: cyan / teal
+    style.line = Argb(markAlpha, 90, 140, 170);
+    style.glowInner = Argb(255, 74, 207, 255);
+    style.glowMid = Argb(255, 42, 122, 154);
+    style.glowOuter = Argb(255, 42, 90, 110);
+  }
+  return style;
+}
+
+// Horizontal / vertical 2px mark stroke on pixel edges (the GDI+ pen drew
+// them without anti-aliasing)
+static void Stroke(Canvas::Surface &surface, int x0, int y0, int x1, int y1, Canvas::Pixel color) {
+  if (y0 == y1)
+    Canvas::BlendRect(surface, x0 < x1 ? x0 : x1, y0 - 1, x0 < x1 ? x1 - x0 : x0 - x1, 2, color);
+  else
+    Canvas::BlendRect(surface, x0 - 1, y0 < y1 ? y0 : y1, 2, y0 < y1 ? y1 - y0 : y0 - y1, color);
+}
+
+void DrawCellMark(Canvas::Surface &surface, const Layout &layout, const Style &style, int x,
+                  int y, bool hover, int originX, int originY) {
+  int cellTotal = layout.cellSize;
+  int radius = style.radius;
+  int hoverRadius = style.hoverRadius;
+  int cx = layout.GridStartX() - originX + x * cellTotal + cellTotal / 2;
+  int cy = layout.GridStartY() - originY + y * cellTotal + cellTotal / 2;
+
+  bool isLeft = (x == 0);
+  bool isRight = (x == layout.gridWidth - 1);
+  bool isTop = (y == 0);
+  bool isBottom = (y == layout.gridHeight - 1);
+  bool isCorner = (isLeft || isRight) && (isTop || isBottom);
+  bool isEdge = (isLeft || isRight || isTop || isBottom) && !isCorner;
+
+  // Reduced offset to move marks closer to center (was cellTotal/4)
+  int edgeOffset = cellTotal / 6;
+  int markX = cx, markY = cy;
+  if (isCorner || isEdge) {
+    if (isLeft)
+      markX -= edgeOffset;
+    if (isRight)
+      markX += edgeOffset;
+    if (isTop)
+      markY -= edgeOffset;
+    if (isBottom)
+      markY += edgeOffset;
+  }
+
+  // Different lengths for corner, edge, and center marks
+  int cornerLen = (int)(cellTotal * 0.35); // Longer for corners
+  int edgeLen = (int)(cellTotal * 0.25);   // Shorter for edges
+  int centerLen = (int)(cellTotal * 0.25); // Same as edges for center
+
+  Canvas::Pixel markColor = hover ? style.glowInner : style.line;
+
+  if (isCorner) {
+    int L = cornerLen;
+    int dx = isLeft ? L : -L;
+    int dy = isTop ? L : -L;
+    Stroke(surface, markX, markY, markX + dx, markY, markColor);
+    Stroke(surface, markX, markY, markX, markY + dy, markColor);
+  } else if (isEdge) {
+    int L = edgeLen;
+    if (isTop || isBottom) {
+      Stroke(surface, markX - L, markY, markX + L, markY, markColor);
+      Stroke(surface, markX, markY, markX, markY + (isTop ? L : -L), markColor);
+    } else {
+      Stroke(surface, markX, markY - L, markX, markY + L, markColor);
+      Stroke(surface, markX, markY, markX + (isLeft ? L : -L), markY, markColor);
+    }
+  } else {
+    int L = centerLen;
+    Stroke(surface, cx - L, cy, cx + L, cy, markColor);
+    Stroke(surface, cx, cy - L, cx, cy + L, markColor);
+  }
+
+  int anchorX = (isCorner || isEdge) ? markX : cx;
+  int anchorY = (isCorner || isEdge) ? markY : cy;
+
+  // Center dot
+  Canvas::FillEllipse(surface, (float)(anchorX - radius), (float)(anchorY - radius),
+                      (float)(radius * 2), (float)(radius * 2), style.line);
+
+  // Hover glow
+  if (hover) {
+    Canvas::FillEllipse(surface, (float)(anchorX - hoverRadius * 2),
+                        (float)(anchorY - hoverRadius * 2), (float)(hoverRadius * 4),
+                        (float)(hoverRadius * 4), style.glowOuter);
+    Canvas::FillEllipse(surface, (float)(anchorX - hoverRadius - 3),
+                        (float)(anchorY - hoverRadius - 3), (float)((hoverRadius + 3) * 2),
+                        (float)((hoverRadius + 3) * 2), style.glowMid);
+    Canvas::FillEllipse(surface, (float)(anchorX - hoverRadius), (float)(anchorY - hoverRadius),
+                        (float)(hoverRadius * 2), (float)(hoverRadius * 2), style.glowInner);
+  }
+}
+
+void DrawGrid(Canvas::Surface &surface, const Layout &layout, const Style &style) {
+  // Exact color key for clean transparency
+  surface.Clear(COLOR_KEY);
+
+  int cellTotal = layout.cellSize;
+  int gridStartX = layout.GridStartX();
+  int gridStartY = layout.GridStartY();
+  int gridWidth = layout.gridWidth * cellTotal;
+  int gridHeight = layout.gridHeight * cellTotal;
+
+  // Cell background over the whole grid area (alpha 0: key shows through)
+  Canvas::BlendRect(surface, gridStartX, gridStartY, gridWidth, gridHeight,
+                    style.cellBackground);
+
+  // Separators between cells
+  for (int x = 1; x < layout.gridWidth; x++)
+    Canvas::BlendRect(surface, gridStartX + x * cellTotal, gridStartY, 1, gridHeight,
+                      style.separator);
+  for (int y = 1; y < layout.gridHeight; y++)
+    Canvas::BlendRect(surface, gridStartX, gridStartY + y * cellTotal, gridWidth, 1,
+                      style.separator);
+
+  // Marks and dots
+  for (int y = 0; y < layout.gridHeight; y++) {
+    for (int x = 0; x < layout.gridWidth; x++)
+      DrawCellMark(surface, layout, style, x, y, false);
+  }
+}
+
+} // namespace GridPaint
@@ -0,0 +1,72 @@
+/*****************************************************************************
+ * GridPaint.h
+ *
+ * Grid window geometry and cell rendering on Canvas (platform-neutral)
+ *
+ * GridUI computes its window layout here and renders the grid part of the
+ * static layer (color key, cell background, separators, marks) and the
+ * hovered cell into Canvas surfaces, which WM_PAINT blits. The side panel
+ * icons stay on IconAtlas (GDI+). Without a window the same calls render
+ * the grid headless (tools/ScriptBench, cpp/tests).
+ *****************************************************************************/
+
+#ifndef GRIDPAINT_H
+#define GRIDPAINT_H
+
+#include "Canvas.h"
+#include "GridUI.h"
+
+namespace GridPaint {
+
+// Transparent key of the layered window (COLOR_BG in GridUI)
+const Canvas::Pixel COLOR_KEY = 0xFF010101;
+
+// Window geometry for one ShowGrid (scaled pixels)
+struct Layout {
+  float scale = 1.0f; // 0.8 - 1.7, inferred from GridConfig::cellSize
+  int sidePanelWidth = 52;
+  int iconSize = 34;
+  int iconSpacing = 16;
+  int margin = 2;
+  int fixedGridPixels = 120; // Grid area (the cells are centered in it)
+  int cellSize = 40;         // Replaces GridConfig::cellSize
+  int gridWidth = 3;         // Cells
+  int gridHeight = 3;
+  int windowWidth = 0;
+  int windowHeight = 0;
+  int verticalPadding = 0; // Grid area centered when the icons are taller
+  int offsetX = 0;         // Cells centered in the grid area
+  int offsetY = 0;
+
+  int GridStartX() const { return sidePanelWidth + margin + offsetX; }
+  int GridStartY() const { return verticalPadding + margin + offsetY; }
+};
+
+Layout ComputeLayout(const NativeUI::GridConfig &config);
+
+// Mark colors and dot sizes (gridOpacity: mark alpha, cellOpacity: cell
+// background alpha, both 0-100)
+struct Style {
+  Canvas::Pixel cellBackground;
+  Canvas::Pixel separator;
+  Canvas::Pixel line;
+  Canvas::Pixel glowInner;
+  Canvas::Pixel glowMid;
+  Canvas::Pixel glowOuter;
+  int radius;
+  int hoverRadius;
+};
+
+Style MakeStyle(const Layout &layout, const NativeUI::GridSettings &settings);
+
+// Color key, cell background, separators and every mark (no hover)
+void DrawGrid(Canvas::Surface &surface, const Layout &layout, const Style &style);
+
+// Mark and dot of one cell; hover adds the glow. (originX, originY): the
+// surface's position in the window (a cell-sized surface for the hover)
+void DrawCellMark(Canvas::Surface &surface, const Layout &layout, const Style &style, int x,
+                  int y, bool hover, int originX = 0, int originY = 0);
+
+} // namespace GridPaint
+
+#endif // GRIDPAINT_H
@@ -2,7 +2,7 @@
  * GridUI.cpp
  *
  * Native Windows UI for Anchor Snap - Grid Module
- * Uses GDI+ for anti-aliasing, alpha blending, and smooth rendering
+ * Grid and marks render on Canvas (GridPaint), icons through IconAtlas (GDI+)
  *
  * Layout:
  *   [Left Icons]  [Grid]  [Right Icons]
@@ -16,23 +16,28 @@
 
 // GDI+ includes - DO NOT MODIFY ORDER (see GdiPlusIncludes.h)
 #include "GdiPlusIncludes.h"
+#include "GridPaint.h"
+#include "IconAtlas.h"
+#include "Profiler.h"
+#include "RenderContext.h"
+#include "Tracer.h"
 
 #include <cmath>
 #include <string>
 
-// GDI+ token for startup/shutdown
-static ULONG_PTR g_gdiplusToken = 0;
+// Window backbuffer, kept across paints (hover changes only repaint dirty rects)
+static RenderContext::Backbuffer g_backbuffer;
+// Cached static layer: color key, cells, marks and icons without hover
+static RenderContext::Backbuffer g_staticLayer;
+// Grid part of the static layer, and the hovered cell rendered over a copy
+static Canvas::Surface g_gridSurface;
+static Canvas::Surface g_hoverSurface;
 
 // Window class name
 static const wchar_t *GRID_CLASS_NAME = L"AnchorGridClass";
 
 // Color palette - Selection Mode (Cyan/Teal)
-#define COLOR_BG RGB(1, 1, 1)         // Transparent key (unique dark color)
-#define COLOR_CELL_BG RGB(35, 35, 40) // Cell background
-#define COLOR_GRID_LINE RGB(90, 140, 170)
-#define COLOR_GLOW_INNER RGB(74, 207, 255)
-#define COLOR_GLOW_MID RGB(42, 122, 154)
-#define COLOR_GLOW_OUTER RGB(42, 90, 110)
+#define COLOR_BG RGB(1, 1, 1) // Transparent key (GridPaint::COLOR_KEY)
 #define COLOR_ICON_NORMAL RGB(90, 140, 170)
 #define COLOR_ICON_HOVER RGB(74, 207, 255)
 #define COLOR_ICON_ACTIVE RGB(100, 220, 255)
@@ -40,19 +45,10 @@ static const wchar_t *GRID_CLASS_NAME = L"AnchorGridClass";
 #define COLOR_ORANGE RGB(255, 180, 74)  // Composition mode
 #define COLOR_DARK_GRAY RGB(70, 70, 70) // Inactive/OFF state
 
-// Color palette - Comp Mode (Orange/Warm)
-#define COLOR_CELL_BG_COMP RGB(35, 25, 15)
-#define COLOR_GRID_LINE_COMP RGB(90, 70, 42)
-#define COLOR_GLOW_INNER_COMP RGB(255, 180, 74)
-#define COLOR_GLOW_MID_COMP RGB(154, 100, 42)
-#define COLOR_GLOW_OUTER_COMP RGB(110, 80, 42)
+// Grid, mark and glow colors: GridPaint::MakeStyle
 
-// Side panel base dimensions (will be scaled)
-#define BASE_SIDE_PANEL_WIDTH 52
-#define BASE_ICON_SIZE 34
-#define BASE_ICON_SPACING 16
-
-// Scaled dimensions (set in ShowGrid based on scale factor)
+// Scaled dimensions (set in ShowGrid from GridPaint::ComputeLayout)
+static GridPaint::Layout g_layout;
 static int g_sidePanelWidth = 52;
 static int g_iconSize = 34;
 static int g_iconSpacing = 16;
@@ -86,14 +82,42 @@ static bool g_hasClipboardAnchor = false;
 static float g_clipboardAnchorX = 0.5f;
 static float g_clipboardAnchorY = 0.5f;
 
+// Everything the static layer depends on (rebuilt when any of it changes)
+struct StaticLayerKey {
+  int width = 0; // Window
+  int height = 0;
+  int gridWidth = 0;
+  int gridHeight = 0;
+  int cellSize = 0;
+  int margin = 0;
+  float scale = 0.0f;
+  bool compMode = false;
+  bool maskMode = false;
+  bool settingsOpen = false;
+  bool hasClipboard = false;
+  float gridOpacity = 0.0f;
+  float cellOpacity = 0.0f;
+
+  bool operator==(const StaticLayerKey &o) const {
+    return width == o.width && height == o.height && gridWidth == o.gridWidth &&
+           gridHeight == o.gridHeight && cellSize == o.cellSize && margin == o.margin &&
+           scale == o.scale && compMode == o.compMode && maskMode == o.maskMode &&
+           settingsOpen == o.settingsOpen && hasClipboard == o.hasClipboard &&
+           gridOpacity == o.gridOpacity && cellOpacity == o.cellOpacity;
+  }
+};
+static StaticLayerKey g_staticKey;
+static bool g_staticValid = false;
+
 // Forward declarations
 static LRESULT CALLBACK GridWndProc(HWND hwnd, UINT msg, WPARAM wParam,
                                     LPARAM lParam);
-static void DrawGrid(HDC hdc);
 static void DrawSidePanels(HDC hdc);
 static void DrawIcon(HDC hdc, int cx, int cy, NativeUI::ExtendedOption type,
                      bool hover, bool active);
 static void UpdateHoverFromMouse(int screenX, int screenY);
+static void InvalidateHover(int cellX, int cellY, NativeUI::ExtendedOption opt);
+static bool GetHoverRect(int cellX, int cellY, NativeUI::ExtendedOption opt, RECT *rect);
 
 namespace NativeUI {
 
@@ -101,10 +125,8 @@ bool Initialize() {
   if (g_initialized)
     return true;
 
-  // Initialize GDI+
-  Gdiplus::GdiplusStartupInput gdiplusStartupInput;
-  if (Gdiplus::GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, NULL) !=
-      Gdiplus::Ok) {
+  // Join the shared GDI+ session
+  if (!RenderContext::Acquire()) {
     return false;
   }
 
@@ -121,7 +143,7 @@ bool Initialize() {
   wc.lpszClassName = GRID_CLASS_NAME;
 
   if (!RegisterClassExW(&wc)) {
-    Gdiplus::GdiplusShutdown(g_gdiplusToken);
+    RenderContext::Release();
     return false;
   }
 
@@ -134,13 +156,15 @@ void Cleanup() {
     DestroyWindow(g_gridWnd);
     g_gridWnd = NULL;
   }
+  g_backbuffer.Release();
+  g_staticLayer.Release();
+  g_staticValid = false;
+  g_gridSurface.Resize(0, 0);
+  g_hoverSurface.Resize(0, 0);
   if (g_initialized) {
     UnregisterClassW(GRID_CLASS_NAME, g_hInstance);
     g_initialized = false;
-  }
-  if (g_gdiplusToken != 0) {
-    Gdiplus::GdiplusShutdown(g_gdiplusToken);
-    g_gdiplusToken = 0;
+    RenderContext::Release();
   }
 }
 
@@ -153,79 +177,20 @@ void ShowGrid(int mouseX, int mouseY, const GridConfig &config) {
   g_hoverCellY = -1;
   g_hoverExtOption = OPT_NONE;
 
-  // FIXED grid area size with scale applied
-  // 10 steps: -20% to +70% (scale factors 0.8 to 1.7)
-  float scaleFactors[] = {0.8f, 0.9f, 1.0f, 1.1f, 1.2f, 1.3f, 1.4f, 1.5f, 1.6f, 1.7f};
-  int scaleIndex = 2; // Default to 0%
-  // Use config.cellSize to infer scale (40 base * factor)
-  if (g_config.cellSize <= 32)
-    scaleIndex = 0; // 40 * 0.8 = 32
-  else if (g_config.cellSize <= 36)
-    scaleIndex = 1; // 40 * 0.9 = 36
-  else if (g_config.cellSize <= 40)
-    scaleIndex = 2; // 40 * 1.0 = 40
-  else if (g_config.cellSize <= 44)
-    scaleIndex = 3; // 40 * 1.1 = 44
-  else if (g_config.cellSize <= 48)
-    scaleIndex = 4; // 40 * 1.2 = 48
-  else if (g_config.cellSize <= 52)
-    scaleIndex = 5; // 40 * 1.3 = 52
-  else if (g_config.cellSize <= 56)
-    scaleIndex = 6; // 40 * 1.4 = 56
-  else if (g_config.cellSize <= 60)
-    scaleIndex = 7; // 40 * 1.5 = 60
-  else if (g_config.cellSize <= 64)
-    scaleIndex = 8; // 40 * 1.6 = 64
-  else
-    scaleIndex = 9; // 40 * 1.7 = 68
-
-  int baseGridSize = 120; // Fixed base size for grid area
-  g_fixedGridPixels = (int)(baseGridSize * scaleFactors[scaleIndex]);
-
-  // Update scaled icon dimensions based on scale factor
-  g_currentScale = scaleFactors[scaleIndex];
-  g_sidePanelWidth = (int)(BASE_SIDE_PANEL_WIDTH * g_currentScale);
-  g_iconSize = (int)(BASE_ICON_SIZE * g_currentScale);
-  g_iconSpacing = (int)(BASE_ICON_SPACING * g_currentScale);
-
-  // Scale margin (base margin = 2)
-  g_scaledMargin = (int)(g_config.margin * g_currentScale);
-  if (g_scaledMargin < 1) g_scaledMargin = 1;
-
-  // Calculate cellSize based on max dimension (like FX Console null parents)
-  int maxDim = (g_config.gridWidth > g_config.gridHeight) ? g_config.gridWidth
-                                                          : g_config.gridHeight;
-  int spacing = g_config.spacing;
-  int calculatedCellSize =
-      (g_fixedGridPixels - (maxDim - 1) * spacing) / maxDim;
-  if (calculatedCellSize < 10)
-    calculatedCellSize = 10; // Minimum cell size
-
-  // Override cellSize with calculated value
-  g_config.cellSize = calculatedCellSize;
-  int cellTotal = g_config.cellSize + spacing;
-
-  // Actual grid pixels (always fits within g_fixedGridPixels)
-  int gridPixelsW = g_config.gridWidth * cellTotal;
-  int gridPixelsH = g_config.gridHeight * cellTotal;
-
-  // Window: FIXED size (use scaled margin)
-  g_windowWidth = g_sidePanelWidth + g_fixedGridPixels + g_scaledMargin * 2 +
-                  g_sidePanelWidth;
-
-  int minHeight =
-      g_iconSize * 3 + g_iconSpacing * 2 + (int)(20 * g_currentScale);
-  int bottomButtonsHeight = g_iconSize + (int)(10 * g_currentScale);
-  int gridAreaHeight = g_fixedGridPixels + g_scaledMargin * 2;
-  int baseHeight = (gridAreaHeight > minHeight) ? gridAreaHeight : minHeight;
-  g_windowHeight = baseHeight + bottomButtonsHeight;
-
-  // Calculate vertical padding to center grid area when window is taller due to icons
-  g_gridVerticalPadding = (baseHeight - gridAreaHeight) / 2;
-
-  // Grid offset: center the actual grid within the fixed area
-  g_gridOffsetX = (g_fixedGridPixels - gridPixelsW) / 2;
-  g_gridOffsetY = (g_fixedGridPixels - gridPixelsH) / 2;
+  g_layout = GridPaint::ComputeLayout(config);
+  g_currentScale = g_layout.scale;
+  g_fixedGridPixels = g_layout.fixedGridPixels;
+  g_sidePanelWidth = g_layout.sidePanelWidth;
+  g_iconSize = g_layout.iconSize;
+  g_iconSpacing = g_layout.iconSpacing;
+  g_scaledMargin = g_layout.margin;
+  g_config.cellSize = g_layout.cellSize;
+  g_windowWidth = g_layout.windowWidth;
+  g_windowHeight = g_layout.windowHeight;
+  g_gridVerticalPadding = g_layout.verticalPadding;
+  g_gridOffsetX = g_layout.offsetX;
+  g_gridOffsetY = g_layout.offsetY;
+  IconAtlas::SetScale(IconAtlas::OWNER_GRID, g_currentScale);
 
   // Mouse at WINDOW CENTER (grid area center, accounting for vertical padding)
   int gridCenterX = g_sidePanelWidth + g_scaledMargin + g_fixedGridPixels / 2;
@@ -301,7 +266,9 @@ void UpdateHover(int mouseX, int mouseY) {
 
     if (oldX != g_hoverCellX || oldY != g_hoverCellY ||
         oldExt != g_hoverExtOption) {
-      InvalidateRect(g_gridWnd, NULL, FALSE); // FALSE to prevent flickering
+      // Only the old and new hover areas: the rest comes from the static layer
+      InvalidateHover(oldX, oldY, oldExt);
+      InvalidateHover(g_hoverCellX, g_hoverCellY, g_hoverExtOption);
     }
   }
 }
@@ -331,6 +298,7 @@ void SetClipboardAnchor(float x, float y) {
 }
 
 void InvalidateGrid() {
+  g_staticValid = false; // Rebuild the static layer too
   if (g_gridWnd && IsWindow(g_gridWnd)) {
     InvalidateRect(g_gridWnd, NULL, FALSE);
   }
@@ -440,31 +408,30 @@ static void UpdateHoverFromMouse(int screenX, int screenY) {
   }
 }
 
-// Draw hover background (unified square area)
-static void DrawIconBackground(HDC hdc, int cx, int cy, bool hover) {
-  if (hover) {
-    int halfSize = g_iconSize / 2;
-    HBRUSH hoverBrush = CreateSolidBrush(RGB(55, 70, 85)); // Enhanced contrast
-    RECT hoverRect = {cx - halfSize, cy - halfSize, cx + halfSize,
-                      cy + halfSize};
-    FillRect(hdc, &hoverRect, hoverBrush);
-    DeleteObject(hoverBrush);
-  }
-}
-
-// Draw an icon based on type using pure GDI+
-static void DrawIcon(HDC hdc, int cx, int cy, NativeUI::ExtendedOption type,
-                     bool hover, bool active) {
+// Icon state bits (IconAtlas key: everything that changes the look)
+static const uint32_t ICON_HOVER = 1;
+static const uint32_t ICON_ACTIVE = 2;
+static const uint32_t ICON_COMP_MODE = 4;
+static const uint32_t ICON_MASK_ON = 8;
+static const uint32_t ICON_CLIPBOARD = 16;
+
+// Draw an icon based on type using pure GDI+ (IconAtlas::RasterFunc):
+// `rect` is the icon square, the hover background fills it
+static void RasterIcon(Gdiplus::Graphics &graphics, int icon, uint32_t state,
+                       const Gdiplus::RectF &rect) {
   using namespace Gdiplus;
 
-  // Draw hover background first
-  DrawIconBackground(hdc, cx, cy, hover);
+  NativeUI::ExtendedOption type = (NativeUI::ExtendedOption)icon;
+  bool hover = (state & ICON_HOVER) != 0;
+  bool active = (state & ICON_ACTIVE) != 0;
+  int cx = (int)rect.X + (int)rect.Width / 2;
+  int cy = (int)rect.Y + (int)rect.Height / 2;
 
-  // Create GDI+ Graphics with anti-aliasing
-  Graphics graphics(hdc);
-  graphics.SetSmoothingMode(SmoothingModeNone);
-  graphics.SetPixelOffsetMode(PixelOffsetModeHalf);
-  graphics.SetTextRenderingHint(TextRenderingHintClearTypeGridFit);
+  // Hover background first (unified square area, enhanced contrast)
+  if (hover)
+    graphics.FillRectangle(RenderContext::Brush(Color(255, 55, 70, 85)),
+                           (int)rect.X, (int)rect.Y, (int)rect.Width,
+                           (int)rect.Height);
 
   int r = g_iconSize / 2 - (int)(6 * g_currentScale);
   int s = (int)(3 * g_currentScale);
@@ -485,95 +452,92 @@ static void DrawIcon(HDC hdc, int cx, int cy, NativeUI::ExtendedOption type,
     // Use hover background color when hovering, otherwise transparent key
     COLORREF bgColorRef = hover ? RGB(50, 60, 70) : COLOR_BG;
     Color bgColor = toColor(bgColorRef);
-    Pen pen(color, 2.0f);
-    SolidBrush bgBrush(bgColor);
+    const Pen *pen = RenderContext::Pen(color, 2.0f);
+    const SolidBrush *bgBrush = RenderContext::Brush(bgColor);
 
     // +10% larger overall
     int iconR = (int)(r * 1.1f); // 10% larger radius
 
     // Crosshair lines (with gap for center circle)
     int gap = (int)(9 * g_currentScale);
-    graphics.DrawLine(&pen, cx - iconR, cy, cx - gap, cy);
-    graphics.DrawLine(&pen, cx + gap, cy, cx + iconR, cy);
-    graphics.DrawLine(&pen, cx, cy - iconR, cx, cy - gap);
-    graphics.DrawLine(&pen, cx, cy + gap, cx, cy + iconR);
+    graphics.DrawLine(pen, cx - iconR, cy, cx - gap, cy);
+    graphics.DrawLine(pen, cx + gap, cy, cx + iconR, cy);
+    graphics.DrawLine(pen, cx, cy - iconR, cx, cy - gap);
+    graphics.DrawLine(pen, cx, cy + gap, cx, cy + iconR);
 
     // Center circle with fill (AE anchor style)
     int circleR = (int)(9 * g_currentScale);
-    graphics.FillEllipse(&bgBrush, cx - circleR, cy - circleR, circleR * 2,
+    graphics.FillEllipse(bgBrush, cx - circleR, cy - circleR, circleR * 2,
                          circleR * 2);
-    graphics.DrawEllipse(&pen, cx - circleR, cy - circleR, circleR * 2,
+    graphics.DrawEllipse(pen, cx - circleR, cy - circleR, circleR * 2,
                          circleR * 2);
 
     // Draw preset number inside circle - scaled font
-    FontFamily fontFamily(L"Segoe UI");
-    Font font(&fontFamily, (int)(12 * g_currentScale), FontStyleBold,
-              UnitPixel);
-    SolidBrush textBrush(color);
-    StringFormat format;
-    format.SetAlignment(StringAlignmentCenter);
-    format.SetLineAlignment(StringAlignmentCenter);
+    const Font *font =
+        RenderContext::Font((REAL)(int)(12 * g_currentScale), FontStyleBold);
+    const SolidBrush *textBrush = RenderContext::Brush(color);
+    const StringFormat *format = RenderContext::Format(StringAlignmentCenter);
     wchar_t num[2] = {
         static_cast<wchar_t>(L'1' + (type - NativeUI::OPT_CUSTOM_1)), 0};
     RectF textRect((REAL)(cx - circleR), (REAL)(cy - circleR),
                    (REAL)(circleR * 2), (REAL)(circleR * 2));
-    graphics.DrawString(num, 1, &font, textRect, &format, &textBrush);
+    graphics.DrawString(num, 1, font, textRect, format, textBrush);
     break;
   }
 
   case NativeUI::OPT_COMP_MODE: {
-    bool isCompMode = g_settings.useCompMode;
+    bool isCompMode = (state & ICON_COMP_MODE) != 0;
     COLORREF colorRef =
         hover ? COLOR_ICON_HOVER : (isCompMode ? COLOR_ORANGE : COLOR_BLUE);
     Color color = toColor(colorRef);
-    Pen pen(color, 2.0f);
-    SolidBrush brush(color);
+    const Pen *pen = RenderContext::Pen(color, 2.0f);
+    const SolidBrush *brush = RenderContext::Brush(color);
 
     if (isCompMode) {
       // Composition: wide rectangle with + in center
       int w = r + 2;
       int h = r - 2;
-      graphics.DrawRectangle(&pen, cx - w, cy - h, w * 2, h * 2);
+      graphics.DrawRectangle(pen, cx - w, cy - h, w * 2, h * 2);
       // Plus sign
       int ps = 3;
-      graphics.DrawLine(&pen, cx - ps, cy, cx + ps, cy);
-      graphics.DrawLine(&pen, cx, cy - ps, cx, cy + ps);
+      graphics.DrawLine(pen, cx - ps, cy, cx + ps, cy);
+      graphics.DrawLine(pen, cx, cy - ps, cx, cy + ps);
     } else {
       // Selection: square with corner squares (centered on corners)
-      graphics.DrawRectangle(&pen, cx - r, cy - r, r * 2, r * 2);
+      graphics.DrawRectangle(pen, cx - r, cy - r, r * 2, r * 2);
       // Corner squares - centered on each corner
       int cs = s + 1; // corner square size
       int half = cs / 2;
-      graphics.FillRectangle(&brush, cx - r - half, cy - r - half, cs,
+      graphics.FillRectangle(brush, cx - r - half, cy - r - half, cs,
                              cs); // top-left
-      graphics.FillRectangle(&brush, cx + r - half, cy - r - half, cs,
+      graphics.FillRectangle(brush, cx + r - half, cy - r - half, cs,
                              cs); // top-right
-      graphics.FillRectangle(&brush, cx - r - half, cy + r - half, cs,
+      graphics.FillRectangle(brush, cx - r - half, cy + r - half, cs,
                              cs); // bottom-left
-      graphics.FillRectangle(&brush, cx + r - half, cy + r - half, cs,
+      graphics.FillRectangle(brush, cx + r - half, cy + r - half, cs,
                              cs); // bottom-right
     }
     break;
   }
 
   case NativeUI::OPT_MASK_MODE: {
-    bool maskOn = g_settings.useMaskRecognition;
+    bool maskOn = (state & ICON_MASK_ON) != 0;
     COLORREF colorRef =
         hover ? COLOR_ICON_HOVER : (maskOn ? COLOR_BLUE : COLOR_DARK_GRAY);
     Color color = toColor(colorRef);
-    SolidBrush brush(color);
+    const SolidBrush *brush = RenderContext::Brush(color);
     // Use hover background color when hovering for circle cutout
     COLORREF bgColorRef = hover ? RGB(50, 60, 70) : COLOR_BG;
     Color bgColor = toColor(bgColorRef);
-    SolidBrush bgBrush(bgColor);
+    const SolidBrush *bgBrush = RenderContext::Brush(bgColor);
 
     // Horizontal rectangle (20% taller - 10% more than before)
     int w = r + 3;
     int h = (int)((r - 3) * 1.2f); // 20% taller total
-    graphics.FillRectangle(&brush, cx - w, cy - h, w * 2, h * 2);
+    graphics.FillRectangle(brush, cx - w, cy - h, w * 2, h * 2);
     // Circle cutout (30% larger than original)
     int circleR = (int)(h / 2 * 1.3f); // 30% larger
-    graphics.FillEllipse(&bgBrush, cx - circleR, cy - circleR, circleR * 2,
+    graphics.FillEllipse(bgBrush, cx - circleR, cy - circleR, circleR * 2,
                          circleR * 2);
     break;
   }
@@ -583,7 +547,7 @@ static void DrawIcon(HDC hdc, int cx, int cy, NativeUI::ExtendedOption type,
     COLORREF colorRef =
         hover ? COLOR_ICON_HOVER : (active ? COLOR_BLUE : COLOR_DARK_GRAY);
     Color color = toColor(colorRef);
-    SolidBrush brush(color);
+    const SolidBrush *brush = RenderContext::Brush(color);
 
     // User-style gear: 6 wide teeth, large center hole - 40% larger
     int baseR = (int)(r * 1.4f);        // 40% larger
@@ -614,16 +578,16 @@ static void DrawIcon(HDC hdc, int cx, int cy, NativeUI::ExtendedOption type,
       gearPoints[i * 4 + 3].X = cx + (int)(midR * cos(baseAngle + toothWidth));
       gearPoints[i * 4 + 3].Y = cy + (int)(midR * sin(baseAngle + toothWidth));
     }
-    graphics.FillPolygon(&brush, gearPoints, 24);
+    graphics.FillPolygon(brush, gearPoints, 24);
 
     // Fill inner body circle
-    graphics.FillEllipse(&brush, cx - midR, cy - midR, midR * 2, midR * 2);
+    graphics.FillEllipse(brush, cx - midR, cy - midR, midR * 2, midR * 2);
 
     // Cut out center circle (use bg color)
     COLORREF bgColorRef = hover ? RGB(50, 60, 70) : COLOR_BG;
     Color bgColor = toColor(bgColorRef);
-    SolidBrush bgBrush(bgColor);
-    graphics.FillEllipse(&bgBrush, cx - centerR, cy - centerR, centerR * 2,
+    const SolidBrush *bgBrush = RenderContext::Brush(bgColor);
+    graphics.FillEllipse(bgBrush, cx - centerR, cy - centerR, centerR * 2,
                          centerR * 2);
     break;
   }
@@ -632,19 +596,19 @@ static void DrawIcon(HDC hdc, int cx, int cy, NativeUI::ExtendedOption type,
     // Orange if has clipboard data, blue if hover, else dark gray
     COLORREF colorRef =
         hover ? COLOR_ICON_HOVER
-              : (g_hasClipboardAnchor ? COLOR_ORANGE : COLOR_DARK_GRAY);
+              : ((state & ICON_CLIPBOARD) ? COLOR_ORANGE : COLOR_DARK_GRAY);
     Color color = toColor(colorRef);
-    Pen pen(color, 2.0f);
-    SolidBrush brush(color);
+    const Pen *pen = RenderContext::Pen(color, 2.0f);
+    const SolidBrush *brush = RenderContext::Brush(color);
 
     // Two overlapping rectangles - 25% larger
     int size = (int)(r * 1.25f) - 2;
     int offset = 4;
     // Back rectangle (outline only)
-    graphics.DrawRectangle(&pen, cx - size + offset, cy - size + offset,
+    graphics.DrawRectangle(pen, cx - size + offset, cy - size + offset,
                            size * 2 - offset * 2, size * 2 - offset * 2);
     // Front rectangle (filled)
-    graphics.FillRectangle(&brush, cx - size, cy - size, size * 2 - offset * 2,
+    graphics.FillRectangle(brush, cx - size, cy - size, size * 2 - offset * 2,
                            size * 2 - offset * 2);
     break;
   }
@@ -653,19 +617,19 @@ static void DrawIcon(HDC hdc, int cx, int cy, NativeUI::ExtendedOption type,
     // Dim if no clipboard data
     COLORREF colorRef =
         hover ? COLOR_ICON_HOVER
-              : (g_hasClipboardAnchor ? COLOR_BLUE : COLOR_DARK_GRAY);
+              : ((state & ICON_CLIPBOARD) ? COLOR_BLUE : COLOR_DARK_GRAY);
     Color color = toColor(colorRef);
-    Pen pen(color, 2.0f);
-    SolidBrush brush(color);
+    const Pen *pen = RenderContext::Pen(color, 2.0f);
+    const SolidBrush *brush = RenderContext::Brush(color);
 
     // Clipboard icon - smaller (was 1.2, now ~1.0)
     int w = (int)(r * 1.0f) - 2;
     int h = (int)(r * 1.0f) + 2;
     // Main board
-    graphics.DrawRectangle(&pen, cx - w, cy - h + 4, w * 2, h * 2 - 4);
+    graphics.DrawRectangle(pen, cx - w, cy - h + 4, w * 2, h * 2 - 4);
     // Clip at top
     int clipW = w / 2;
-    graphics.FillRectangle(&brush, cx - clipW, cy - h, clipW * 2, 6);
+    graphics.FillRectangle(brush, cx - clipW, cy - h, clipW * 2, 6);
     break;
   }
 
@@ -674,236 +638,180 @@ static void DrawIcon(HDC hdc, int cx, int cy, NativeUI::ExtendedOption type,
   }
 }
 
-// Draw side panels with icons
-static void DrawSidePanels(HDC hdc) {
+// Draw an icon: rasterized once per state into the icon atlas
+static void DrawIcon(HDC hdc, int cx, int cy, NativeUI::ExtendedOption type,
+                     bool hover, bool active) {
+  using namespace Gdiplus;
+
+  uint32_t state = (hover ? ICON_HOVER : 0) | (active ? ICON_ACTIVE : 0) |
+                   (g_settings.useCompMode ? ICON_COMP_MODE : 0) |
+                   (g_settings.useMaskRecognition ? ICON_MASK_ON : 0) |
+                   (g_hasClipboardAnchor ? ICON_CLIPBOARD : 0);
+
+  Graphics graphics(hdc);
+  graphics.SetSmoothingMode(SmoothingModeNone);
+  graphics.SetPixelOffsetMode(PixelOffsetModeHalf);
+  graphics.SetTextRenderingHint(TextRenderingHintClearTypeGridFit);
+
+  int halfSize = g_iconSize / 2;
+  RectF rect((REAL)(cx - halfSize), (REAL)(cy - halfSize), (REAL)(halfSize * 2),
+             (REAL)(halfSize * 2));
+  IconAtlas::Draw(graphics, IconAtlas::OWNER_GRID, type, state, rect,
+                  RasterIcon);
+}
+
+// Center and active state of a side panel / bottom icon
+static bool GetIconCenter(NativeUI::ExtendedOption opt, int *cx, int *cy,
+                          bool *active) {
   // Calculate icon Y based on grid area only (exclude bottom buttons)
   int bottomButtonsHeight = g_iconSize + (int)(10 * g_currentScale);
   int gridAreaHeight = g_windowHeight - bottomButtonsHeight;
   int iconY = (gridAreaHeight - (g_iconSize * 3 + g_iconSpacing * 2)) / 2;
-  int leftCx = g_sidePanelWidth / 2;
-  int rightCx = g_windowWidth - g_sidePanelWidth / 2;
-
-  // Left panel: Custom anchors 1, 2, 3
-  for (int i = 0; i < 3; i++) {
-    int cy = iconY + i * (g_iconSize + g_iconSpacing) + g_iconSize / 2;
-    NativeUI::ExtendedOption opt =
-        (NativeUI::ExtendedOption)(NativeUI::OPT_CUSTOM_1 + i);
-    bool hover = (g_hoverExtOption == opt);
-    DrawIcon(hdc, leftCx, cy, opt, hover, false);
-  }
-
-  // Right panel: Comp mode, Mask mode, Settings
-  NativeUI::ExtendedOption rightOpts[] = {
-      NativeUI::OPT_COMP_MODE, NativeUI::OPT_MASK_MODE, NativeUI::OPT_SETTINGS};
-  bool activeStates[] = {g_settings.useCompMode, g_settings.useMaskRecognition,
-                         g_settings.settingsPanelOpen};
-
-  for (int i = 0; i < 3; i++) {
-    int cy = iconY + i * (g_iconSize + g_iconSpacing) + g_iconSize / 2;
-    bool hover = (g_hoverExtOption == rightOpts[i]);
-    DrawIcon(hdc, rightCx, cy, rightOpts[i], hover, activeStates[i]);
-  }
-
   // Copy/Paste buttons below grid (centered based on FIXED grid size)
-  int cellTotal = g_config.cellSize + g_config.spacing;
-  // Use global g_fixedGridPixels for button positioning (with scaled margin and vertical padding)
   int windowCenterX =
       g_sidePanelWidth + g_scaledMargin + g_fixedGridPixels / 2;
   int gridBottomY = g_gridVerticalPadding + g_scaledMargin + g_fixedGridPixels + g_iconSize / 2 +
                     (int)(5 * g_currentScale);
 
-  // Copy icon
-  bool copyHover = (g_hoverExtOption == NativeUI::OPT_COPY_ANCHOR);
-  DrawIcon(hdc, windowCenterX - g_iconSize / 2 - (int)(5 * g_currentScale),
-           gridBottomY, NativeUI::OPT_COPY_ANCHOR, copyHover, false);
-
-  // Paste icon
-  bool pasteHover = (g_hoverExtOption == NativeUI::OPT_PASTE_ANCHOR);
-  DrawIcon(hdc, windowCenterX + g_iconSize / 2 + (int)(5 * g_currentScale),
-           gridBottomY, NativeUI::OPT_PASTE_ANCHOR, pasteHover,
-           g_hasClipboardAnchor);
-}
-
-// Draw the grid with marks and glow using GDI+
-static void DrawGrid(HDC hdc) {
-  using namespace Gdiplus;
+  *active = false;
+  switch (opt) {
+  // Left panel: Custom anchors 1, 2, 3
+  case NativeUI::OPT_CUSTOM_1:
+  case NativeUI::OPT_CUSTOM_2:
+  case NativeUI::OPT_CUSTOM_3:
+    *cx = g_sidePanelWidth / 2;
+    *cy = iconY + (opt - NativeUI::OPT_CUSTOM_1) * (g_iconSize + g_iconSpacing) +
+          g_iconSize / 2;
+    return true;
 
-  Graphics graphics(hdc);
-  graphics.SetSmoothingMode(SmoothingModeNone);
-  graphics.SetPixelOffsetMode(PixelOffsetModeHalf);
+  // Right panel: Comp mode, Mask mode, Settings
+  case NativeUI::OPT_COMP_MODE:
+  case NativeUI::OPT_MASK_MODE:
+  case NativeUI::OPT_SETTINGS:
+    *cx = g_windowWidth - g_sidePanelWidth / 2;
+    *cy = iconY + (opt - NativeUI::OPT_COMP_MODE) * (g_iconSize + g_iconSpacing) +
+          g_iconSize / 2;
+    *active = opt == NativeUI::OPT_COMP_MODE   ? g_settings.useCompMode
+              : opt == NativeUI::OPT_MASK_MODE ? g_settings.useMaskRecognition
+                                               : g_settings.settingsPanelOpen;
+    return true;
 
-  // Use cellSize directly (no spacing - grid lines will separate)
-  int cellTotal = g_config.cellSize; // No spacing now
-  // Apply grid offset for centered rectangular grids (with vertical padding)
-  int gridStartX = g_sidePanelWidth + g_scaledMargin + g_gridOffsetX;
-  int gridStartY = g_gridVerticalPadding + g_scaledMargin + g_gridOffsetY;
-  int radius = g_config.cellSize / 10;     // Slightly larger dots
-  int hoverRadius = g_config.cellSize / 7; // Enhanced hover glow (was /8)
-  int len = (int)(cellTotal * 0.3);        // Shorter marks (was 0.4)
+  case NativeUI::OPT_COPY_ANCHOR:
+    *cx = windowCenterX - g_iconSize / 2 - (int)(5 * g_currentScale);
+    *cy = gridBottomY;
+    return true;
 
-  bool compMode = g_settings.useCompMode;
+  case NativeUI::OPT_PASTE_ANCHOR:
+    *cx = windowCenterX + g_iconSize / 2 + (int)(5 * g_currentScale);
+    *cy = gridBottomY;
+    *active = g_hasClipboardAnchor;
+    return true;
 
-  // Helper to convert COLORREF to GDI+ Color
-  auto toColor = [](COLORREF c) {
-    return Color(255, GetRValue(c), GetGValue(c), GetBValue(c));
-  };
+  default:
+    return false;
+  }
+}
 
-  Color cellBgColor = toColor(COLOR_CELL_BG);
-
-  // Apply gridOpacity (mark opacity) to line/mark colors
-  BYTE markAlpha = (BYTE)(g_settings.gridOpacity * 255 / 100);
-  COLORREF lineColorRef = compMode ? COLOR_GRID_LINE_COMP : COLOR_GRID_LINE;
-  Color lineColor(markAlpha, GetRValue(lineColorRef), GetGValue(lineColorRef),
-                  GetBValue(lineColorRef));
-
-  COLORREF glowInnerRef = compMode ? COLOR_GLOW_INNER_COMP : COLOR_GLOW_INNER;
-  Color glowInnerColor(255, GetRValue(glowInnerRef), GetGValue(glowInnerRef),
-                       GetBValue(glowInnerRef)); // Glow stays full
-  COLORREF glowMidRef = compMode ? COLOR_GLOW_MID_COMP : COLOR_GLOW_MID;
-  Color glowMidColor(255, GetRValue(glowMidRef), GetGValue(glowMidRef),
-                     GetBValue(glowMidRef));
-  COLORREF glowOuterRef = compMode ? COLOR_GLOW_OUTER_COMP : COLOR_GLOW_OUTER;
-  Color glowOuterColor(255, GetRValue(glowOuterRef), GetGValue(glowOuterRef),
-                       GetBValue(glowOuterRef));
-
-  // Draw cell backgrounds with opacity
-  // cellOpacity: 0 = fully transparent (skip drawing), 100 = fully opaque
-  int gridWidth = g_config.gridWidth * cellTotal;
-  int gridHeight = g_config.gridHeight * cellTotal;
-
-  if (g_settings.cellOpacity > 0) {
-    // Linear alpha: 0->0, 100->255
-    BYTE cellAlpha = (BYTE)(g_settings.cellOpacity * 255 / 100);
-    Color cellBgWithAlpha(cellAlpha, GetRValue(COLOR_CELL_BG),
-                          GetGValue(COLOR_CELL_BG), GetBValue(COLOR_CELL_BG));
-    SolidBrush cellBrush(cellBgWithAlpha);
-
-    // Fill entire grid area
-    graphics.FillRectangle(&cellBrush, gridStartX, gridStartY, gridWidth,
-                           gridHeight);
+// Draw side panels with icons (no hover: see DrawHoverLayer)
+static void DrawSidePanels(HDC hdc) {
+  for (int i = NativeUI::OPT_CUSTOM_1; i <= NativeUI::OPT_PASTE_ANCHOR; i++) {
+    NativeUI::ExtendedOption opt = (NativeUI::ExtendedOption)i;
+    int cx, cy;
+    bool active;
+    if (GetIconCenter(opt, &cx, &cy, &active))
+      DrawIcon(hdc, cx, cy, opt, false, active);
   }
-  // When cellOpacity is 0, skip drawing background entirely (transparent)
+}
 
-  // Draw gray grid lines (separators between cells) - Enhanced visibility
-  Color gridLineColor(200, 100, 100, 100); // Brighter semi-transparent gray
-  Pen gridPen(gridLineColor, 1.0f);
+// Static layer: color key, grid and icons without hover
+static void DrawStaticLayer(HDC hdc, const RECT &rect) {
+  GridPaint::Style style = GridPaint::MakeStyle(g_layout, g_settings);
+  g_gridSurface.Resize(rect.right, rect.bottom);
+  GridPaint::DrawGrid(g_gridSurface, g_layout, style);
+  Canvas::Blit(g_gridSurface, hdc, 0, 0);
+  DrawSidePanels(hdc);
+}
 
-  // Vertical lines
-  for (int x = 1; x < g_config.gridWidth; x++) {
-    int lineX = gridStartX + x * cellTotal;
-    graphics.DrawLine(&gridPen, lineX, gridStartY, lineX,
-                      gridStartY + gridHeight);
-  }
-  // Horizontal lines
-  for (int y = 1; y < g_config.gridHeight; y++) {
-    int lineY = gridStartY + y * cellTotal;
-    graphics.DrawLine(&gridPen, gridStartX, lineY, gridStartX + gridWidth,
-                      lineY);
-  }
+// Hovered cell / icon on top of the static layer. The hover cell renders
+// into a copy of its rect of the grid surface (the opaque mark and glow
+// cover the plain ones); the hover background covers the plain icon.
+static void DrawHoverLayer(HDC hdc) {
+  RECT rect;
+  if (g_hoverCellX >= 0 && g_hoverCellY >= 0 &&
+      GetHoverRect(g_hoverCellX, g_hoverCellY, NativeUI::OPT_NONE, &rect)) {
+    g_hoverSurface.Resize(rect.right - rect.left, rect.bottom - rect.top);
+    g_hoverSurface.CopyFrom(g_gridSurface, rect.left, rect.top);
+    GridPaint::DrawCellMark(g_hoverSurface, g_layout, GridPaint::MakeStyle(g_layout, g_settings),
+                            g_hoverCellX, g_hoverCellY, true, rect.left, rect.top);
+    Canvas::Blit(g_hoverSurface, hdc, rect.left, rect.top);
+  }
+
+  int cx, cy;
+  bool active;
+  if (GetIconCenter(g_hoverExtOption, &cx, &cy, &active))
+    DrawIcon(hdc, cx, cy, g_hoverExtOption, true, active);
+}
 
-  // Draw marks and dots using GDI+
-  Pen markPen(lineColor, 2.0f);
-  SolidBrush dotBrush(lineColor);
-
-  for (int y = 0; y < g_config.gridHeight; y++) {
-    for (int x = 0; x < g_config.gridWidth; x++) {
-      int cx = gridStartX + x * cellTotal + cellTotal / 2;
-      int cy = gridStartY + y * cellTotal + cellTotal / 2;
-
-      bool isHover = (x == g_hoverCellX && y == g_hoverCellY);
-
-      bool isLeft = (x == 0);
-      bool isRight = (x == g_config.gridWidth - 1);
-      bool isTop = (y == 0);
-      bool isBottom = (y == g_config.gridHeight - 1);
-      bool isCorner = (isLeft || isRight) && (isTop || isBottom);
-      bool isEdge = (isLeft || isRight || isTop || isBottom) && !isCorner;
-
-      // Reduced offset to move marks closer to center (was cellTotal/4)
-      int edgeOffset = cellTotal / 6;
-      int markX = cx, markY = cy;
-      if (isCorner || isEdge) {
-        if (isLeft)
-          markX -= edgeOffset;
-        if (isRight)
-          markX += edgeOffset;
-        if (isTop)
-          markY -= edgeOffset;
-        if (isBottom)
-          markY += edgeOffset;
-      }
+// Window area a hover state draws into (cell or icon, plus the 2px pens)
+static bool GetHoverRect(int cellX, int cellY, NativeUI::ExtendedOption opt,
+                         RECT *rect) {
+  int left, top, size;
+  if (cellX >= 0 && cellY >= 0) {
+    size = g_config.cellSize;
+    left = g_sidePanelWidth + g_scaledMargin + g_gridOffsetX + cellX * size;
+    top = g_gridVerticalPadding + g_scaledMargin + g_gridOffsetY + cellY * size;
+  } else {
+    int cx, cy;
+    bool active;
+    if (!GetIconCenter(opt, &cx, &cy, &active))
+      return false;
+    size = g_iconSize;
+    left = cx - size / 2;
+    top = cy - size / 2;
+  }
+  rect->left = left - 2;
+  rect->top = top - 2;
+  rect->right = left + size + 2;
+  rect->bottom = top + size + 2;
+  return true;
+}
 
-      // Different lengths for corner, edge, and center marks
-      int cornerLen = (int)(cellTotal * 0.35); // Longer for corners
-      int edgeLen = (int)(cellTotal * 0.25);   // Shorter for edges
-      int centerLen = (int)(cellTotal * 0.25); // Same as edges for center
-
-      Color markColor = isHover ? glowInnerColor : lineColor;
-      Pen linePen(markColor, 2.0f);
-
-      if (isCorner) {
-        int L = cornerLen;
-        if (isTop && isLeft) {
-          graphics.DrawLine(&linePen, markX, markY + L, markX, markY);
-          graphics.DrawLine(&linePen, markX, markY, markX + L, markY);
-        } else if (isTop && isRight) {
-          graphics.DrawLine(&linePen, markX - L, markY, markX, markY);
-          graphics.DrawLine(&linePen, markX, markY, markX, markY + L);
-        } else if (isBottom && isLeft) {
-          graphics.DrawLine(&linePen, markX, markY - L, markX, markY);
-          graphics.DrawLine(&linePen, markX, markY, markX + L, markY);
-        } else {
-          graphics.DrawLine(&linePen, markX - L, markY, markX, markY);
-          graphics.DrawLine(&linePen, markX, markY, markX, markY - L);
-        }
-      } else if (isEdge) {
-        int L = edgeLen;
-        if (isTop) {
-          graphics.DrawLine(&linePen, markX - L, markY, markX + L, markY);
-          graphics.DrawLine(&linePen, markX, markY, markX, markY + L);
-        } else if (isBottom) {
-          graphics.DrawLine(&linePen, markX - L, markY, markX + L, markY);
-          graphics.DrawLine(&linePen, markX, markY - L, markX, markY);
-        } else if (isLeft) {
-          graphics.DrawLine(&linePen, markX, markY - L, markX, markY + L);
-          graphics.DrawLine(&linePen, markX, markY, markX + L, markY);
-        } else {
-          graphics.DrawLine(&linePen, markX, markY - L, markX, markY + L);
-          graphics.DrawLine(&linePen, markX - L, markY, markX, markY);
-        }
-      } else {
-        int L = centerLen;
-        graphics.DrawLine(&linePen, cx - L, cy, cx + L, cy);
-        graphics.DrawLine(&linePen, cx, cy - L, cx, cy + L);
-      }
+static void InvalidateHover(int cellX, int cellY, NativeUI::ExtendedOption opt) {
+  RECT rect;
+  if (GetHoverRect(cellX, cellY, opt, &rect))
+    InvalidateRect(g_gridWnd, &rect, FALSE); // FALSE to prevent flickering
+}
 
-      int anchorX = (isCorner || isEdge) ? markX : cx;
-      int anchorY = (isCorner || isEdge) ? markY : cy;
-
-      // Draw center dot
-      SolidBrush dotBrush(lineColor);
-      graphics.FillEllipse(&dotBrush, anchorX - radius, anchorY - radius,
-                           radius * 2, radius * 2);
-
-      // Draw hover glow
-      if (isHover) {
-        SolidBrush glowBrush3(glowOuterColor);
-        graphics.FillEllipse(&glowBrush3, anchorX - hoverRadius * 2,
-                             anchorY - hoverRadius * 2, hoverRadius * 4,
-                             hoverRadius * 4);
-
-        SolidBrush glowBrush2(glowMidColor);
-        graphics.FillEllipse(&glowBrush2, anchorX - hoverRadius - 3,
-                             anchorY - hoverRadius - 3, (hoverRadius + 3) * 2,
-                             (hoverRadius + 3) * 2);
-
-        SolidBrush glowBrush1(glowInnerColor);
-        graphics.FillEllipse(&glowBrush1, anchorX - hoverRadius,
-                             anchorY - hoverRadius, hoverRadius * 2,
-                             hoverRadius * 2);
-      }
-    }
-  }
+// Rebuild the static layer if its key changed
+// @return DC to copy it from, or NULL (draw it into the backbuffer instead)
+static HDC UpdateStaticLayer(HDC hdc, const RECT &rect) {
+  StaticLayerKey key;
+  key.width = rect.right;
+  key.height = rect.bottom;
+  key.gridWidth = g_config.gridWidth;
+  key.gridHeight = g_config.gridHeight;
+  key.cellSize = g_config.cellSize;
+  key.margin = g_scaledMargin;
+  key.scale = g_currentScale;
+  key.compMode = g_settings.useCompMode;
+  key.maskMode = g_settings.useMaskRecognition;
+  key.settingsOpen = g_settings.settingsPanelOpen;
+  key.hasClipboard = g_hasClipboardAnchor;
+  key.gridOpacity = g_settings.gridOpacity;
+  key.cellOpacity = g_settings.cellOpacity;
+
+  if (g_staticValid && key == g_staticKey)
+    return g_staticLayer.Surface();
+
+  PROFILE_SCOPE("paint.grid.static");
+  g_staticValid = false;
+  HDC layerDC = g_staticLayer.Begin(hdc, rect.right, rect.bottom);
+  if (layerDC == hdc)
+    return NULL;
+  DrawStaticLayer(layerDC, rect);
+  g_staticKey = key;
+  g_staticValid = true;
+  return layerDC;
 }
 
 // Window procedure
@@ -911,27 +819,28 @@ static LRESULT CALLBACK GridWndProc(HWND hwnd, UINT msg, WPARAM wParam,
                                     LPARAM lParam) {
   switch (msg) {
   case WM_PAINT: {
+    TRACE_SCOPE("paint", "GridUI::DrawGrid");
+    PROFILE_SCOPE("paint.grid");
     PAINTSTRUCT ps;
     HDC hdc = BeginPaint(hwnd, &ps);
 
     RECT rect;
     GetClientRect(hwnd, &rect);
-    HDC memDC = CreateCompatibleDC(hdc);
-    HBITMAP memBitmap = CreateCompatibleBitmap(hdc, rect.right, rect.bottom);
-    SelectObject(memDC, memBitmap);
-
-    // Fill with exact color key for clean transparency
-    HBRUSH bgBrush = CreateSolidBrush(RGB(1, 1, 1)); // Must match COLOR_BG
-    FillRect(memDC, &rect, bgBrush);
-    DeleteObject(bgBrush);
-
-    DrawGrid(memDC);
-    DrawSidePanels(memDC);
-
-    BitBlt(hdc, 0, 0, rect.right, rect.bottom, memDC, 0, 0, SRCCOPY);
+    // Before Begin: a rebuild may trim the pooled resources
+    HDC layerDC = UpdateStaticLayer(hdc, rect);
+    HDC memDC = g_backbuffer.Begin(hdc, rect.right, rect.bottom, &ps.rcPaint);
+
+    // Only the dirty rect: static layer, then the hovered cell / icon
+    const RECT &dirty = ps.rcPaint;
+    if (layerDC) {
+      BitBlt(memDC, dirty.left, dirty.top, dirty.right - dirty.left,
+             dirty.bottom - dirty.top, layerDC, dirty.left, dirty.top, SRCCOPY);
+    } else {
+      DrawStaticLayer(memDC, rect);
+    }
+    DrawHoverLayer(memDC);
 
-    DeleteObject(memBitmap);
-    DeleteDC(memDC);
+    g_backbuffer.Present(hdc, rect.right, rect.bottom);
 
     EndPaint(hwnd, &ps);
     return 0;
@@ -966,7 +875,7 @@ static LRESULT CALLBACK GridWndProc(HWND hwnd, UINT msg, WPARAM wParam,
 #else // macOS stub
 
 namespace NativeUI {
-bool Initialize() { return false; }
+bool Initialize() { return true; }
 void Cleanup() {}
 void ShowGrid(int, int, const GridConfig &) {}
 GridResult HideGrid(int, int) { return GridResult{-1, -1, true, OPT_NONE}; }
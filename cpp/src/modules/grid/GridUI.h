@@ -86,7 +86,8 @@ bool HasClipboardAnchor();
 void GetClipboardAnchor(float *outX, float *outY);
 void SetClipboardAnchor(float x, float y);
 
-// Redraw the grid window (for mode toggle without closing)
+// Redraw the grid window (for mode toggle without closing; rebuilds the
+// cached static layer)
 void InvalidateGrid();
 
 // Get current hover extended option
@@ -0,0 +1,318 @@
+/*****************************************************************************
+ * CurveMath.cpp
+ *
+ * Cubic bezier math (see CurveMath.h)
+ *****************************************************************************/
+
+#include "CurveMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CURVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace CurveMath {
+
+#ifdef CURVE_SSE2
+static bool s_simd = true;
+#else
+static bool s_simd = false;
+#endif
+
+bool HasSimd() {
+#ifdef CURVE_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+void SetSimdEnabled(bool enabled) { s_simd = enabled && HasSimd(); }
+
+const char* SimdName() { return s_simd ? "SSE2" : "scalar"; }
+
+// Power basis: B(t) = ((a t + b) t + c) t + d
+struct Poly {
+    float ax, bx, cx, dx;
+    float ay, by, cy, dy;
+};
+
+static Poly ToPoly(const Cubic& c) {
+    Poly p;
+    p.ax = -c.x0 + 3.0f * c.x1 - 3.0f * c.x2 + c.x3;
+    p.bx = 3.0f * c.x0 - 6.0f * c.x1 + 3.0f * c.x2;
+    p.cx = -3.0f * c.x0 + 3.0f * c.x1;
+    p.dx = c.x0;
+    p.ay = -c.y0 + 3.0f * c.y1 - 3.0f * c.y2 + c.y3;
+    p.by = 3.0f * c.y0 - 6.0f * c.y1 + 3.0f * c.y2;
+    p.cy = -3.0f * c.y0 + 3.0f * c.y1;
+    p.dy = c.y0;
+    return p;
+}
+
+/*****************************************************************************
+ * Lanes: the kernels below are written once against these (a wider
+ * set only needs another Lanes struct)
+ *****************************************************************************/
+
+struct ScalarLanes {
+    typedef float V;
+    typedef bool M;
+    static const int N = 1;
+    static V Load(const float* p) { return *p; }
+    static void Store(float* p, V v) { *p = v; }
+    static V Set(float v) { return v; }
+    static V Add(V a, V b) { return a + b; }
+    static V Sub(V a, V b) { return a - b; }
+    static V Mul(V a, V b) { return a * b; }
+    static V Div(V a, V b) { return a / b; }
+    static V Abs(V a) { return std::fabs(a); }
+    static V Min(V a, V b) { return b < a ? b : a; }
+    static V Max(V a, V b) { return a < b ? b : a; }
+    static M Less(V a, V b) { return a < b; }
+    static M LessEq(V a, V b) { return a <= b; }
+    static M And(M a, M b) { return a && b; }
+    static M Or(M a, M b) { return a || b; }
+    static V Select(M m, V a, V b) { return m ? a : b; }
+    static bool All(M m) { return m; }
+};
+
+#ifdef CURVE_SSE2
+struct SseLanes {
+    typedef __m128 V;
+    typedef __m128 M;
+    static const int N = 4;
+    static V Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, V v) { _mm_storeu_ps(p, v); }
+    static V Set(float v) { return _mm_set1_ps(v); }
+    static V Add(V a, V b) { return _mm_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm_div_ps(a, b); }
+    static V Abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    // Operand order as ScalarLanes (NaN picks the same side)
+    static V Min(V a, V b) { return Select(Less(b, a), b, a); }
+    static V Max(V a, V b) { return Select(Less(a, b), b, a); }
+    static M Less(V a, V b) { return _mm_cmplt_ps(a, b); }
+    static M LessEq(V a, V b) { return _mm_cmple_ps(a, b); }
+    static M And(M a, M b) { return _mm_and_ps(a, b); }
+    static M Or(M a, M b) { return _mm_or_ps(a, b); }
+    static V Select(M m, V a, V b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    static bool All(M m) { return _mm_movemask_ps(m) == 0xF; }
+};
+#endif
+
+// Horner: ((a t + b) t + c) t + d
+template <class L>
+static typename L::V Horner(typename L::V t, float a, float b, float c, float d) {
+    typename L::V v = L::Add(L::Mul(L::Set(a), t), L::Set(b));
+    v = L::Add(L::Mul(v, t), L::Set(c));
+    return L::Add(L::Mul(v, t), L::Set(d));
+}
+
+template <class L>
+static void EvalKernel(const Poly& p, const float* t, float* x, float* y) {
+    typename L::V tv = L::Load(t);
+    L::Store(x, Horner<L>(tv, p.ax, p.bx, p.cx, p.dx));
+    L::Store(y, Horner<L>(tv, p.ay, p.by, p.cy, p.dy));
+}
+
+static const float SOLVE_EPSILON = 2e-7f;
+static const int SOLVE_MAX_STEPS = 40;
+
+// Newton on x(t) - x inside a shrinking bracket; a step that leaves the
+// bracket (or x'(t) = 0: inf / NaN) is replaced by the midpoint. Finished
+// lanes are frozen, so a lane's result does not depend on its neighbours
+template <class L>
+static typename L::V SolveKernel(const Poly& p, typename L::V x, float x0, float x3) {
+    typedef typename L::V V;
+    typedef typename L::M M;
+    V eps = L::Set(SOLVE_EPSILON);
+    x = L::Min(L::Max(x, L::Set(x0)), L::Set(x3));
+    V lo = L::Set(0.0f), hi = L::Set(1.0f);
+    V t = L::Sub(x, L::Set(x0));  // Guess: linear timing
+    float span = x3 - x0;
+    if (span > 0.0f) t = L::Div(t, L::Set(span));
+    for (int step = 0; step < SOLVE_MAX_STEPS; step++) {
+        V f = L::Sub(Horner<L>(t, p.ax, p.bx, p.cx, p.dx), x);
+        M done = L::Or(L::LessEq(L::Abs(f), eps), L::LessEq(L::Sub(hi, lo), eps));
+        if (L::All(done)) break;
+        M above = L::Less(L::Set(0.0f), f);
+        V newLo = L::Select(above, lo, t);
+        V newHi = L::Select(above, t, hi);
+        V d = L::Add(L::Mul(L::Add(L::Mul(L::Set(3.0f * p.ax), t), L::Set(2.0f * p.bx)), t),
+                     L::Set(p.cx));
+        V next = L::Sub(t, L::Div(f, d));
+        M inside = L::And(L::Less(newLo, next), L::Less(next, newHi));
+        next = L::Select(inside, next, L::Mul(L::Add(newLo, newHi), L::Set(0.5f)));
+        t = L::Select(done, t, next);
+        lo = L::Select(done, lo, newLo);
+        hi = L::Select(done, hi, newHi);
+    }
+    return t;
+}
+
+template <class L>
+static void ValueKernel(const Poly& p, const float* x, float* y, float x0, float x3) {
+    typename L::V t = SolveKernel<L>(p, L::Load(x), x0, x3);
+    L::Store(y, Horner<L>(t, p.ay, p.by, p.cy, p.dy));
+}
+
+// Runs the kernels over [0, count): SSE2 groups of 4, scalar tail
+template <class ScalarFn, class SseFn>
+static void ForEachLane(int count, ScalarFn scalar, SseFn sse) {
+    int i = 0;
+#ifdef CURVE_SSE2
+    if (s_simd) {
+        for (; i + 4 <= count; i += 4) sse(i);
+    }
+#else
+    (void)sse;
+#endif
+    for (; i < count; i++) scalar(i);
+}
+
+/*****************************************************************************
+ * Parametric evaluation / tessellation
+ *****************************************************************************/
+
+Point Eval(const Cubic& cubic, float t) {
+    Point pt;
+    EvalKernel<ScalarLanes>(ToPoly(cubic), &t, &pt.x, &pt.y);
+    return pt;
+}
+
+void EvalBatch(const Cubic& cubic, const float* t, int count, float* x, float* y) {
+    Poly p = ToPoly(cubic);
+    ForEachLane(count,
+        [&](int i) { EvalKernel<ScalarLanes>(p, t + i, x + i, y + i); },
+#ifdef CURVE_SSE2
+        [&](int i) { EvalKernel<SseLanes>(p, t + i, x + i, y + i); });
+#else
+        [](int) {});
+#endif
+}
+
+int FlattenSegments(const Cubic& c, float tolerance) {
+    // |B''| <= 6 * max(|P0 - 2 P1 + P2|, |P1 - 2 P2 + P3|)
+    float d0x = c.x0 - 2.0f * c.x1 + c.x2, d0y = c.y0 - 2.0f * c.y1 + c.y2;
+    float d1x = c.x1 - 2.0f * c.x2 + c.x3, d1y = c.y1 - 2.0f * c.y2 + c.y3;
+    float dd = std::max(d0x * d0x + d0y * d0y, d1x * d1x + d1y * d1y);
+    if (!(tolerance > 0.0f) || !(dd >= 0.0f))
+        return MAX_SEGMENTS;
+    // 6 sqrt(dd) / (8 n^2) <= tolerance
+    float n = std::ceil(std::sqrt(0.75f * std::sqrt(dd) / tolerance));
+    if (n < 1.0f) return 1;
+    if (n > (float)MAX_SEGMENTS) return MAX_SEGMENTS;
+    return (int)n;
+}
+
+void Flatten(const Cubic& cubic, float tolerance, std::vector<Point>& points) {
+    int segments = FlattenSegments(cubic, tolerance);
+    float t[MAX_SEGMENTS + 1], x[MAX_SEGMENTS + 1], y[MAX_SEGMENTS + 1];
+    float step = 1.0f / segments;
+    for (int i = 0; i <= segments; i++)
+        t[i] = i * step;
+    EvalBatch(cubic, t, segments + 1, x, y);
+
+    points.resize(segments + 1);
+    for (int i = 0; i <= segments; i++) {
+        points[i].x = x[i];
+        points[i].y = y[i];
+    }
+    points[0].x = cubic.x0;
+    points[0].y = cubic.y0;
+    points[segments].x = cubic.x3;
+    points[segments].y = cubic.y3;
+}
+
+/*****************************************************************************
+ * Timing curves
+ *****************************************************************************/
+
+float SolveT(const Cubic& cubic, float x) {
+    return SolveKernel<ScalarLanes>(ToPoly(cubic), x, cubic.x0, cubic.x3);
+}
+
+float ValueAt(const Cubic& cubic, float x) {
+    float y;
+    ValueKernel<ScalarLanes>(ToPoly(cubic), &x, &y, cubic.x0, cubic.x3);
+    return y;
+}
+
+void ValueAtBatch(const Cubic& cubic, const float* x, int count, float* y) {
+    Poly p = ToPoly(cubic);
+    float x0 = cubic.x0, x3 = cubic.x3;
+    ForEachLane(count,
+        [&](int i) { ValueKernel<ScalarLanes>(p, x + i, y + i, x0, x3); },
+#ifdef CURVE_SSE2
+        [&](int i) { ValueKernel<SseLanes>(p, x + i, y + i, x0, x3); });
+#else
+        [](int) {});
+#endif
+}
+
+// dy/dx at parameter t
+static float SlopeAtT(const Poly& p, float t) {
+    float dx = (3.0f * p.ax * t + 2.0f * p.bx) * t + p.cx;
+    float dy = (3.0f * p.ay * t + 2.0f * p.by) * t + p.cy;
+    if (std::fabs(dx) > 1e-7f) return dy / dx;
+    // x'(t) = 0 (zero influence at an end): L'Hopital when y' = 0 too
+    float ddx = 6.0f * p.ax * t + 2.0f * p.bx;
+    float ddy = 6.0f * p.ay * t + 2.0f * p.by;
+    if (std::fabs(dy) <= 1e-7f && std::fabs(ddx) > 1e-7f) return ddy / ddx;
+    if (dy == 0.0f) return 0.0f;
+    return dy > 0.0f ? std::numeric_limits<float>::infinity()
+                     : -std::numeric_limits<float>::infinity();
+}
+
+float SlopeAt(const Cubic& cubic, float x) {
+    return SlopeAtT(ToPoly(cubic), SolveT(cubic, x));
+}
+
+double Integral(const Cubic& cubic, float x) {
+    double T = SolveT(cubic, x);
+    // Power basis in double
+    double ax = -cubic.x0 + 3.0 * cubic.x1 - 3.0 * cubic.x2 + cubic.x3;
+    double bx = 3.0 * cubic.x0 - 6.0 * cubic.x1 + 3.0 * cubic.x2;
+    double cx = -3.0 * cubic.x0 + 3.0 * cubic.x1;
+    double ay = -cubic.y0 + 3.0 * cubic.y1 - 3.0 * cubic.y2 + cubic.y3;
+    double by = 3.0 * cubic.y0 - 6.0 * cubic.y1 + 3.0 * cubic.y2;
+    double cy = -3.0 * cubic.y0 + 3.0 * cubic.y1;
+    double dy = cubic.y0;
+    // y(t) x'(t) = (ay t^3 + by t^2 + cy t + dy)(3 ax t^2 + 2 bx t + cx)
+    double k[6];
+    k[5] = ay * 3.0 * ax;
+    k[4] = ay * 2.0 * bx + by * 3.0 * ax;
+    k[3] = ay * cx + by * 2.0 * bx + cy * 3.0 * ax;
+    k[2] = by * cx + cy * 2.0 * bx + dy * 3.0 * ax;
+    k[1] = cy * cx + dy * 2.0 * bx;
+    k[0] = dy * cx;
+    // Sum k[n] T^(n+1) / (n+1), Horner
+    double sum = 0.0;
+    for (int n = 5; n >= 0; n--)
+        sum = sum * T + k[n] / (n + 1);
+    return sum * T;
+}
+
+float PeakSlope(const Cubic& cubic, float* atX) {
+    Poly p = ToPoly(cubic);
+    const int SAMPLES = 256;
+    float best = 0.0f, bestT = 0.0f;
+    for (int i = 0; i <= SAMPLES; i++) {
+        float t = (float)i / SAMPLES;
+        float slope = std::fabs(SlopeAtT(p, t));
+        if (slope > best) {
+            best = slope;
+            bestT = t;
+        }
+    }
+    if (atX) *atX = ((p.ax * bestT + p.bx) * bestT + p.cx) * bestT + p.dx;
+    return best;
+}
+
+} // namespace CurveMath
@@ -0,0 +1,107 @@
+/*****************************************************************************
+ * CurveMath.h
+ *
+ * Cubic bezier math for the keyframe velocity graph
+ *
+ * Tessellation: DrawBezierCurve evaluated 51 fixed samples (and
+ * DrawMiniBezier 21 per preset) on every paint. Flatten picks the segment
+ * count from a flatness tolerance instead - the chord error of n uniform
+ * segments is bounded by max|B''| / (8 n^2) - and evaluates all samples
+ * with EvalBatch:
+ *
+ *   CurveMath::Cubic cubic = {x0, y0, x1, y1, x2, y2, x3, y3}; // Screen space
+ *   std::vector<CurveMath::Point> points;
+ *   CurveMath::Flatten(cubic, 0.25f, points);                  // <= 0.25 px off
+ *
+ * Timing curve: a KeyframeUI::VelocityCurve is the cubic (0,0) P1 P2 (1,1)
+ * with x = normalized time, y = normalized value (control point x in
+ * [0, 1], so x(t) is monotone). The curve is parametric: the value at a
+ * time needs t = x^-1(time) first (SolveT: Newton, bisection when a step
+ * leaves the bracket or x'(t) = 0). Integral is exact: the area under
+ * y over x is the degree-5 polynomial integral of y(t) x'(t) dt.
+ *
+ * Batch functions run 4 values per step with SSE2 (x64 baseline); the
+ * scalar fallback runs the same arithmetic per value, so both paths give
+ * identical results. (8-wide AVX measured slower for the inversion: lanes
+ * wait for the slowest Newton lane, and the plugin does not build with
+ * /arch:AVX.)
+ *
+ * Platform-independent (no GDI+): ScriptBench tests it on any OS.
+ *****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+namespace CurveMath {
+
+struct Point {
+    float x, y;
+};
+
+// Control points P0..P3
+struct Cubic {
+    float x0, y0, x1, y1, x2, y2, x3, y3;
+
+    bool operator==(const Cubic& o) const {
+        return x0 == o.x0 && y0 == o.y0 && x1 == o.x1 && y1 == o.y1 &&
+               x2 == o.x2 && y2 == o.y2 && x3 == o.x3 && y3 == o.y3;
+    }
+    bool operator!=(const Cubic& o) const { return !(*this == o); }
+};
+
+// Timing curve (0,0) (x1,y1) (x2,y2) (1,1)
+inline Cubic TimingCubic(float x1, float y1, float x2, float y2) {
+    Cubic cubic = {0.0f, 0.0f, x1, y1, x2, y2, 1.0f, 1.0f};
+    return cubic;
+}
+
+const int MAX_SEGMENTS = 256;  // Flatten cap (degenerate / huge curves)
+
+// SSE2 batch path (compiled in when the target has SSE2); disable to time
+// the scalar path
+bool HasSimd();
+void SetSimdEnabled(bool enabled);
+const char* SimdName();  // "SSE2" or "scalar" (current path)
+
+/*****************************************************************************
+ * Parametric evaluation / tessellation
+ *****************************************************************************/
+
+// Point at parameter t (power basis, same arithmetic as EvalBatch)
+Point Eval(const Cubic& cubic, float t);
+
+// x[i], y[i] = B(t[i]) for count values
+void EvalBatch(const Cubic& cubic, const float* t, int count, float* x, float* y);
+
+// Uniform segments needed for a chord error <= tolerance (1..MAX_SEGMENTS)
+int FlattenSegments(const Cubic& cubic, float tolerance);
+
+// Polyline from P0 to P3 (exact endpoints), FlattenSegments + 1 points
+void Flatten(const Cubic& cubic, float tolerance, std::vector<Point>& points);
+
+/*****************************************************************************
+ * Timing curves (x monotone on [0, 1])
+ *****************************************************************************/
+
+// t with x(t) = x (x clamped to [x0, x3]): stops when the float residual
+// is <= 2e-7 or the bracket is that narrow (true residual < 1e-6)
+float SolveT(const Cubic& cubic, float x);
+
+// y at x (value at a normalized time)
+float ValueAt(const Cubic& cubic, float x);
+
+// dy/dx at x: velocity relative to the average (1 = linear). x'(t) = 0
+// (zero influence) gives the one-sided limit y'' / x'' or +-inf
+float SlopeAt(const Cubic& cubic, float x);
+
+// Integral of y dx from x0 to x, exact (double)
+double Integral(const Cubic& cubic, float x);
+
+// y[i] = ValueAt(x[i]) for count values
+void ValueAtBatch(const Cubic& cubic, const float* x, int count, float* y);
+
+// Largest |dy/dx| over the curve (256 samples in t) and where
+float PeakSlope(const Cubic& cubic, float* atX);
+
+} // namespace CurveMath
@@ -0,0 +1,90 @@
+/*****************************************************************************
+ * EaseModel.cpp
+ *
+ * AE temporal ease <-> timing curve (see EaseModel.h)
+ *****************************************************************************/
+
+#include "EaseModel.h"
+
+#include <cmath>
+
+namespace EaseModel {
+
+static double ClampInfluence(double influence) {
+    if (!(influence >= MIN_INFLUENCE)) return MIN_INFLUENCE;  // NaN too
+    return influence > MAX_INFLUENCE ? MAX_INFLUENCE : influence;
+}
+
+double AverageSpeed(const Segment& segment) {
+    if (!(segment.duration > 0.0) || !std::isfinite(segment.duration)) return 0.0;
+    double average = segment.delta / segment.duration;
+    return std::isfinite(average) ? average : 0.0;
+}
+
+Shape Classify(const Segment& segment) {
+    if (segment.outType == INTERP_HOLD || segment.inType == INTERP_HOLD) return SHAPE_HOLD;
+    if (!(std::fabs(segment.delta) > FLAT_DELTA) || AverageSpeed(segment) == 0.0) return SHAPE_FLAT;
+    return SHAPE_CURVE;
+}
+
+Shape ToHandles(const Segment& segment, Handles& handles) {
+    Shape shape = Classify(segment);
+    if (shape == SHAPE_HOLD) {
+        // Value stays at the start until the end key
+        handles = {1.0f, 0.0f, 1.0f, 0.0f};
+        return shape;
+    }
+
+    double average = AverageSpeed(segment);
+    double outX = ClampInfluence(segment.out.influence) / 100.0;
+    double inX = ClampInfluence(segment.in.influence) / 100.0;
+    double outSlope = shape == SHAPE_CURVE ? segment.out.speed / average : 1.0;
+    double inSlope = shape == SHAPE_CURVE ? segment.in.speed / average : 1.0;
+    if (segment.outType == INTERP_LINEAR) {
+        outX = 1.0 / 3.0;
+        outSlope = 1.0;
+    }
+    if (segment.inType == INTERP_LINEAR) {
+        inX = 1.0 / 3.0;
+        inSlope = 1.0;
+    }
+    if (!std::isfinite(outSlope)) outSlope = 1.0;
+    if (!std::isfinite(inSlope)) inSlope = 1.0;
+
+    handles.x1 = (float)outX;
+    handles.y1 = (float)(outX * outSlope);
+    handles.x2 = (float)(1.0 - inX);
+    handles.y2 = (float)(1.0 - inX * inSlope);
+    return shape;
+}
+
+double OutSlope(const Handles& handles) {
+    double x = ClampInfluence((double)handles.x1 * 100.0) / 100.0;
+    return handles.y1 / x;
+}
+
+double InSlope(const Handles& handles) {
+    double x = ClampInfluence((1.0 - (double)handles.x2) * 100.0) / 100.0;
+    return (1.0 - (double)handles.y2) / x;
+}
+
+Segment FromHandles(const Segment& loaded, const Handles& handles) {
+    Segment segment = loaded;
+    Shape shape = Classify(loaded);
+    if (shape == SHAPE_HOLD) return segment;
+    if (!std::isfinite(handles.x1) || !std::isfinite(handles.y1) ||
+        !std::isfinite(handles.x2) || !std::isfinite(handles.y2)) {
+        return segment;
+    }
+
+    segment.out.influence = ClampInfluence((double)handles.x1 * 100.0);
+    segment.in.influence = ClampInfluence((1.0 - (double)handles.x2) * 100.0);
+    if (shape == SHAPE_CURVE) {
+        double average = AverageSpeed(loaded);
+        segment.out.speed = OutSlope(handles) * average;
+        segment.in.speed = InSlope(handles) * average;
+    }
+    return segment;
+}
+
+} // namespace EaseModel
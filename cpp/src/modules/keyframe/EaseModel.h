@@ -0,0 +1,99 @@
+/*****************************************************************************
+ * EaseModel.h
+ *
+ * After Effects temporal ease <-> normalized timing curve
+ *
+ * AE stores the ease of one key pair per dimension: the value graph from
+ * (time1, value1) to (time2, value2) is a cubic bezier whose handles are
+ *
+ *   P1 = (time1 + out.influence% * duration, value1 + out.speed * out.influence% * duration)
+ *   P2 = (time2 - in.influence% * duration,  value2 - in.speed * in.influence% * duration)
+ *
+ * Dividing time by the duration and value by the delta gives the timing
+ * curve of the panel ((0,0) P1 P2 (1,1), KeyframeUI::VelocityCurve):
+ *
+ *   x1 = out.influence / 100      y1 = x1 * out.speed / average
+ *   x2 = 1 - in.influence / 100   y2 = 1 - (1 - x2) * in.speed / average
+ *
+ * with average = delta / duration (signed: a falling 1D property has
+ * negative speeds and the same curve as a rising one). The inverse is exact,
+ * so load -> apply without an edit writes the keys back within float
+ * rounding of the handles (ScriptBench section 23: property checks over
+ * millions of random pairs).
+ *
+ * Not representable by a (0,0) -> (1,1) curve, so kept as loaded:
+ *   - flat dimensions (|delta| <= FLAT_DELTA): the curve edits influence only
+ *   - hold segments: nothing to ease
+ * Linear sides show the straight handle (slope 1 at 1/3).
+ *
+ * Platform-independent (no GDI+): ScriptBench tests it on any OS.
+ *****************************************************************************/
+
+#pragma once
+
+namespace EaseModel {
+
+// Interpolation at a key side (KeyframeUI::KeyframeType / keyframeInfo values)
+enum Interpolation {
+    INTERP_LINEAR = 1,
+    INTERP_BEZIER = 2,
+    INTERP_HOLD = 3
+};
+
+// AE KeyframeEase
+struct Ease {
+    double speed;       // Value units per second (signed for 1D properties)
+    double influence;   // Percent of the duration
+};
+
+const double MIN_INFLUENCE = 0.1;    // AE range
+const double MAX_INFLUENCE = 100.0;
+const double FLAT_DELTA = 1e-4;      // Keyframe record resolution (4 decimals)
+const int MAX_DIMENSIONS = 3;        // Temporal ease dimensions per property
+
+// One dimension of a key pair
+struct Segment {
+    double duration;            // time2 - time1 (s)
+    double delta;               // value2 - value1 (spatial: path length)
+    Interpolation outType;      // Key1 out
+    Interpolation inType;       // Key2 in
+    Ease out;                   // Key1 out ease
+    Ease in;                    // Key2 in ease
+};
+
+// Timing curve handles P1, P2 (same layout as KeyframeUI::VelocityCurve)
+struct Handles {
+    float x1, y1;
+    float x2, y2;
+
+    bool operator==(const Handles& o) const {
+        return x1 == o.x1 && y1 == o.y1 && x2 == o.x2 && y2 == o.y2;
+    }
+};
+
+enum Shape {
+    SHAPE_CURVE = 0,    // Handles model the segment exactly
+    SHAPE_FLAT,         // No value change: speeds kept, influence editable
+    SHAPE_HOLD          // Hold segment: shown as a step, never changed
+};
+
+// delta / duration (0 for a zero or invalid duration)
+double AverageSpeed(const Segment& segment);
+
+Shape Classify(const Segment& segment);
+
+// AE ease -> handles
+Shape ToHandles(const Segment& segment, Handles& handles);
+
+// Handles -> AE ease: `loaded` with the eases replaced (types, duration and
+// delta unchanged; flat speeds and hold segments kept). Influence is
+// clamped to [MIN_INFLUENCE, MAX_INFLUENCE] and the slope is taken at the
+// clamped influence, so ToHandles(FromHandles(h)) == h for x in range
+Segment FromHandles(const Segment& loaded, const Handles& handles);
+
+// Speed relative to the average (1 = linear) at each end: the factor
+// FromHandles multiplies every dimension's average speed by
+double OutSlope(const Handles& handles);
+double InSlope(const Handles& handles);
+
+} // namespace EaseModel
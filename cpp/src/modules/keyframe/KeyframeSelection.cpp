@@ -0,0 +1,198 @@
+/*****************************************************************************
+ * KeyframeSelection.cpp
+ *
+ * Selected keys as ease pairs (see KeyframeSelection.h)
+ *****************************************************************************/
+
+#include "KeyframeSelection.h"
+#include "WireFormat.h"
+
+#include <cmath>
+
+namespace KeyframeSelection {
+
+static const int DIMS = EaseModel::MAX_DIMENSIONS;
+
+void Clear(Selection& selection) {
+    selection.props.clear();
+    selection.keyIndex.clear();
+    selection.keyTime.clear();
+    selection.keyInType.clear();
+    selection.keyOutType.clear();
+    selection.delta.clear();
+    selection.inSpeed.clear();
+    selection.inInfluence.clear();
+    selection.outSpeed.clear();
+    selection.outInfluence.clear();
+    selection.pairProp.clear();
+    selection.pairKey.clear();
+    selection.pairPrimary.clear();
+    selection.curve.clear();
+    selection.edited.clear();
+    selection.lastEdited = -1;
+}
+
+static uint8_t ReadType(const WireFormat::Reader& reader, size_t field) {
+    int type = reader.Int(field, EaseModel::INTERP_BEZIER);
+    if (type < EaseModel::INTERP_LINEAR || type > EaseModel::INTERP_HOLD) type = EaseModel::INTERP_BEZIER;
+    return (uint8_t)type;
+}
+
+// Pairs of the last property read (a property without a pair is dropped)
+static void ClosePairs(Selection& selection) {
+    if (selection.props.empty()) return;
+    const Property& prop = selection.props.back();
+    if (prop.keyCount < 2) {
+        size_t first = (size_t)prop.firstKey;
+        selection.keyIndex.resize(first);
+        selection.keyTime.resize(first);
+        selection.keyInType.resize(first);
+        selection.keyOutType.resize(first);
+        selection.delta.resize(first * DIMS);
+        selection.inSpeed.resize(first * DIMS);
+        selection.inInfluence.resize(first * DIMS);
+        selection.outSpeed.resize(first * DIMS);
+        selection.outInfluence.resize(first * DIMS);
+        selection.props.pop_back();
+        return;
+    }
+
+    int propIndex = (int)selection.props.size() - 1;
+    for (int k = prop.firstKey; k + 1 < prop.firstKey + prop.keyCount; k++) {
+        size_t pair = selection.pairKey.size();
+        const double* delta = &selection.delta[(size_t)k * DIMS];
+        int primary = 0;
+        for (int d = 1; d < prop.dimensions; d++) {
+            if (std::fabs(delta[d]) > std::fabs(delta[primary])) primary = d;
+        }
+        selection.pairProp.push_back(propIndex);
+        selection.pairKey.push_back(k);
+        selection.pairPrimary.push_back((uint8_t)primary);
+
+        EaseModel::Handles handles;
+        EaseModel::ToHandles(PairSegment(selection, pair, primary), handles);
+        selection.curve.push_back(handles);
+        selection.edited.push_back(0);
+    }
+}
+
+bool Parse(std::string_view wire, Selection& selection) {
+    Clear(selection);
+
+    WireFormat::Reader reader(wire);
+    while (reader.Next()) {
+        // Property header
+        if (reader.Type(0) == WireFormat::FIELD_STRING) {
+            ClosePairs(selection);
+            Property prop;
+            prop.name = std::string(reader.String(WireFormat::KEY_PROP_NAME));
+            prop.matchName = std::string(reader.String(WireFormat::KEY_PROP_MATCH_NAME));
+            prop.position = reader.Int(WireFormat::KEY_PROP_POSITION, 0);
+            prop.dimensions = reader.Int(WireFormat::KEY_PROP_DIMENSIONS, 1);
+            if (prop.dimensions < 1) prop.dimensions = 1;
+            if (prop.dimensions > DIMS) prop.dimensions = DIMS;
+            prop.firstKey = (int)selection.keyIndex.size();
+            prop.keyCount = 0;
+            selection.props.push_back(std::move(prop));
+            continue;
+        }
+        if (selection.props.empty()) continue;  // Key without a property
+
+        // Key: unused dimensions stay zero
+        Property& prop = selection.props.back();
+        selection.keyIndex.push_back(reader.Int(WireFormat::KEY_INDEX, 0));
+        selection.keyTime.push_back(reader.Number(WireFormat::KEY_TIME, 0.0));
+        selection.keyInType.push_back(ReadType(reader, WireFormat::KEY_IN_TYPE));
+        selection.keyOutType.push_back(ReadType(reader, WireFormat::KEY_OUT_TYPE));
+        for (int d = 0; d < DIMS; d++) {
+            size_t base = WireFormat::KEY_DIMENSION + d * WireFormat::KEY_DIM_FIELD_COUNT;
+            bool used = d < prop.dimensions;
+            selection.delta.push_back(used ? reader.Number(base + WireFormat::KEY_DIM_DELTA, 0.0) : 0.0);
+            selection.inSpeed.push_back(used ? reader.Number(base + WireFormat::KEY_DIM_IN_SPEED, 0.0) : 0.0);
+            selection.inInfluence.push_back(used ? reader.Number(base + WireFormat::KEY_DIM_IN_INFLUENCE, 33.33) : 33.33);
+            selection.outSpeed.push_back(used ? reader.Number(base + WireFormat::KEY_DIM_OUT_SPEED, 0.0) : 0.0);
+            selection.outInfluence.push_back(used ? reader.Number(base + WireFormat::KEY_DIM_OUT_INFLUENCE, 33.33) : 33.33);
+        }
+        prop.keyCount++;
+    }
+
+    if (reader.Failed()) {
+        Clear(selection);
+        return false;
+    }
+    ClosePairs(selection);
+    if (selection.PairCount() == 0) {
+        Clear(selection);
+        return false;
+    }
+    return true;
+}
+
+EaseModel::Segment PairSegment(const Selection& selection, size_t pair, int dimension) {
+    size_t k = (size_t)selection.pairKey[pair];
+    size_t out = k * DIMS + dimension;
+    size_t in = (k + 1) * DIMS + dimension;
+
+    EaseModel::Segment segment;
+    segment.duration = selection.keyTime[k + 1] - selection.keyTime[k];
+    segment.delta = selection.delta[out];
+    segment.outType = (EaseModel::Interpolation)selection.keyOutType[k];
+    segment.inType = (EaseModel::Interpolation)selection.keyInType[k + 1];
+    segment.out = {selection.outSpeed[out], selection.outInfluence[out]};
+    segment.in = {selection.inSpeed[in], selection.inInfluence[in]};
+    return segment;
+}
+
+EaseModel::Segment PrimarySegment(const Selection& selection, size_t pair) {
+    return PairSegment(selection, pair, selection.pairPrimary[pair]);
+}
+
+EaseModel::Handles Curve(const Selection& selection, size_t pair) {
+    if (selection.edited[pair] || selection.lastEdited < 0) return selection.curve[pair];
+    return selection.curve[(size_t)selection.lastEdited];
+}
+
+void SetCurve(Selection& selection, size_t pair, const EaseModel::Handles& curve) {
+    if (pair >= selection.PairCount() || Curve(selection, pair) == curve) return;
+    selection.curve[pair] = curve;
+    selection.edited[pair] = 1;
+    selection.lastEdited = (int)pair;
+}
+
+bool BuildApply(const Selection& selection, std::string& payload) {
+    payload.clear();
+    if (selection.lastEdited < 0) return false;
+
+    WireFormat::Writer writer(payload);
+    int headerProp = -1;
+    for (size_t pair = 0; pair < selection.PairCount(); pair++) {
+        // Hold segments have nothing to ease (FromHandles keeps them)
+        if (EaseModel::Classify(PairSegment(selection, pair, 0)) == EaseModel::SHAPE_HOLD) continue;
+
+        int propIndex = selection.pairProp[pair];
+        const Property& prop = selection.props[(size_t)propIndex];
+        if (propIndex != headerProp) {
+            writer.BeginRecord(WireFormat::EASE_PROP_FIELD_COUNT);
+            writer.String(prop.matchName);
+            writer.Int(prop.position);
+            writer.Int(prop.dimensions);
+            headerProp = propIndex;
+        }
+
+        size_t k = (size_t)selection.pairKey[pair];
+        EaseModel::Handles handles = Curve(selection, pair);
+        writer.BeginRecord(WireFormat::EASE_DIMENSION + prop.dimensions * WireFormat::EASE_DIM_FIELD_COUNT);
+        writer.Int(selection.keyIndex[k]);
+        writer.Int(selection.keyIndex[k + 1]);
+        for (int d = 0; d < prop.dimensions; d++) {
+            EaseModel::Segment segment = EaseModel::FromHandles(PairSegment(selection, pair, d), handles);
+            writer.Double(segment.out.speed);
+            writer.Double(segment.out.influence);
+            writer.Double(segment.in.speed);
+            writer.Double(segment.in.influence);
+        }
+    }
+    return !payload.empty();
+}
+
+} // namespace KeyframeSelection
@@ -0,0 +1,99 @@
+/*****************************************************************************
+ * KeyframeSelection.h
+ *
+ * Selected keys of every selected property as ease pairs
+ *
+ * keyframeInfo() returns the whole selection in one message: a
+ * WireFormat::KeyframePropField record per property, then one KeyframeField
+ * record per selected key. A key is sent once even when it ends one pair
+ * and starts the next (K1-K2-K3 = 3 records, 2 pairs).
+ *
+ * The model is flat (struct of arrays, no cap):
+ *   - per key:              index, time, in / out type
+ *   - per key x dimension:  delta to the next key, in / out ease
+ *                           (key * EaseModel::MAX_DIMENSIONS + dimension)
+ *   - per pair:             consecutive selected keys of one property,
+ *                           primary dimension, curve, edited flag
+ *
+ * Curves:
+ *   - a pair starts with its loaded ease (primary dimension = largest |delta|)
+ *   - SetCurve edits one pair; pairs never edited follow the latest edit,
+ *     so one curve still eases the whole selection
+ *   - once anything is edited, BuildApply writes every pair: each dimension
+ *     gets EaseModel::FromHandles of its own segment (exact per pair), all
+ *     in one applyEase() call and one undo group
+ *
+ * Platform-independent (no GDI+): ScriptBench section 24 drives it with a
+ * mock host.
+ *****************************************************************************/
+
+#pragma once
+
+#include "EaseModel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace KeyframeSelection {
+
+// Property with two or more selected keys
+struct Property {
+    std::string name;       // UTF-8
+    std::string matchName;
+    int position;           // Index in comp.selectedProperties
+    int dimensions;         // Temporal ease dimensions (1..MAX_DIMENSIONS)
+    int firstKey;           // Range in the key arrays
+    int keyCount;
+};
+
+struct Selection {
+    std::vector<Property> props;
+
+    // Per selected key
+    std::vector<int> keyIndex;          // AE key index (1-based)
+    std::vector<double> keyTime;
+    std::vector<uint8_t> keyInType;     // EaseModel::Interpolation
+    std::vector<uint8_t> keyOutType;
+
+    // Per key and dimension
+    std::vector<double> delta;          // Value change to the next selected key
+    std::vector<double> inSpeed;
+    std::vector<double> inInfluence;
+    std::vector<double> outSpeed;
+    std::vector<double> outInfluence;
+
+    // Per pair
+    std::vector<int> pairProp;          // props index
+    std::vector<int> pairKey;           // First key (key arrays); second = +1
+    std::vector<uint8_t> pairPrimary;   // Dimension the curve shows
+    std::vector<EaseModel::Handles> curve;
+    std::vector<uint8_t> edited;
+    int lastEdited = -1;                // Pair of the latest edit (-1 = none)
+
+    size_t PairCount() const { return pairKey.size(); }
+};
+
+void Clear(Selection& selection);
+
+// keyframeInfo() result -> selection
+// @return false (selection cleared) on malformed input or without a pair
+bool Parse(std::string_view wire, Selection& selection);
+
+// One dimension of a pair / the primary dimension
+EaseModel::Segment PairSegment(const Selection& selection, size_t pair, int dimension);
+EaseModel::Segment PrimarySegment(const Selection& selection, size_t pair);
+
+// Curve shown for (and applied to) a pair
+EaseModel::Handles Curve(const Selection& selection, size_t pair);
+
+// Set the viewed pair's curve; an edit only if it differs from Curve()
+void SetCurve(Selection& selection, size_t pair, const EaseModel::Handles& curve);
+
+// applyEase() argument (WireFormat::EasePropField / EasePairField records)
+// @return false if nothing was edited (nothing to write)
+bool BuildApply(const Selection& selection, std::string& payload);
+
+} // namespace KeyframeSelection
@@ -10,6 +10,14 @@
 #ifdef MSWindows
 
 #include "GdiPlusIncludes.h"
+#include "IconAtlas.h"
+#include "CurveMath.h"
+#include "EaseModel.h"
+#include "KeyframeSelection.h"
+#include "ScriptResult.h"
+#include "Profiler.h"
+#include "RenderContext.h"
+#include "Tracer.h"
 #include <cmath>
 #include <string>
 #include <vector>
@@ -35,204 +43,20 @@ inline int InverseScaled(int screenValue) {
     return (int)(screenValue / g_scaleFactor);
 }
 
-// =========================================================
-// JSON Helper Functions (Simple Manual Parser)
-// =========================================================
-
-// Extract a float value from JSON string like "key": 123.45
-static float JsonGetFloat(const wchar_t* json, const wchar_t* key, float defaultVal = 0.0f) {
-    wchar_t searchKey[64];
-    swprintf_s(searchKey, L"\"%s\"", key);
-
-    const wchar_t* pos = wcsstr(json, searchKey);
-    if (!pos) return defaultVal;
-
-    // Find the colon after the key
-    pos = wcschr(pos, L':');
-    if (!pos) return defaultVal;
-    pos++;
-
-    // Skip whitespace
-    while (*pos == L' ' || *pos == L'\t' || *pos == L'\n' || *pos == L'\r') pos++;
-
-    // Parse the number
-    return (float)_wtof(pos);
-}
-
-// Extract a string value from JSON like "key": "value"
-static void JsonGetString(const wchar_t* json, const wchar_t* key, wchar_t* out, size_t outSize) {
-    out[0] = L'\0';
-    wchar_t searchKey[64];
-    swprintf_s(searchKey, L"\"%s\"", key);
-
-    const wchar_t* pos = wcsstr(json, searchKey);
-    if (!pos) return;
-
-    // Find the colon
-    pos = wcschr(pos, L':');
-    if (!pos) return;
-    pos++;
-
-    // Skip whitespace
-    while (*pos == L' ' || *pos == L'\t' || *pos == L'\n' || *pos == L'\r') pos++;
-
-    // Expect opening quote
-    if (*pos != L'"') return;
-    pos++;
-
-    // Copy until closing quote
-    size_t i = 0;
-    while (*pos && *pos != L'"' && i < outSize - 1) {
-        out[i++] = *pos++;
-    }
-    out[i] = L'\0';
-}
-
-// =========================================================
-// AE <-> Bezier Conversion Functions
-// =========================================================
-
-// Convert After Effects speed/influence to bezier control points
-// Formula based on AE's KeyframeEase system:
-//   avgSpeed = valueChange / duration
-//   normalizedSpeed = speed / avgSpeed
-//   P1.x = outInfluence / 100
-//   P1.y = P1.x * normalizedOutSpeed
-//   P2.x = 1 - (inInfluence / 100)
-//   P2.y = 1 - (1 - P2.x) * normalizedInSpeed
-static void ConvertAEToBezier(
-    float outSpeed, float outInfluence,
-    float inSpeed, float inInfluence,
-    float avgSpeed,
-    KeyframeUI::KeyframeType outType,
-    KeyframeUI::KeyframeType inType,
-    KeyframeUI::VelocityCurve& curve)
-{
-    // Handle edge case: no value change (avgSpeed = 0)
-    // In this case, show a flat line
-    if (fabs(avgSpeed) < 0.0001f) {
-        curve.p0_x = 0.25f;
-        curve.p0_y = 0.25f;
-        curve.p1_x = 0.75f;
-        curve.p1_y = 0.75f;
-        return;
-    }
-
-    // Handle special keyframe types
-    // Hold keyframe: horizontal line (instant value jump at start/end)
-    if (outType == KeyframeUI::KEYFRAME_HOLD) {
-        // Out from hold: horizontal line at start
-        curve.p0_x = 0.33f;
-        curve.p0_y = 0.0f;  // Flat at bottom
-        curve.p1_x = 0.67f;
-        curve.p1_y = 1.0f;  // Jump to top at end
-        return;
-    }
-    if (inType == KeyframeUI::KEYFRAME_HOLD) {
-        // In to hold: horizontal line at end
-        curve.p0_x = 0.33f;
-        curve.p0_y = 0.0f;  // Start at bottom
-        curve.p1_x = 0.67f;
-        curve.p1_y = 1.0f;  // Jump at end
-        return;
-    }
-
-    // Linear keyframe: diagonal line (constant velocity)
-    if (outType == KeyframeUI::KEYFRAME_LINEAR && inType == KeyframeUI::KEYFRAME_LINEAR) {
-        curve.p0_x = 0.33f;
-        curve.p0_y = 0.33f;
-        curve.p1_x = 0.67f;
-        curve.p1_y = 0.67f;
-        return;
-    }
-
-    // Bezier keyframe: use speed/influence to calculate control points
-    // Clamp influence to valid range
-    outInfluence = max(0.01f, min(100.0f, outInfluence));
-    inInfluence = max(0.01f, min(100.0f, inInfluence));
-
-    // Normalized speeds (relative to average)
-    float normalizedOutSpeed = outSpeed / avgSpeed;
-    float normalizedInSpeed = inSpeed / avgSpeed;
-
-    // Handle linear out with bezier in (or vice versa)
-    if (outType == KeyframeUI::KEYFRAME_LINEAR) {
-        normalizedOutSpeed = 1.0f;  // Linear = same as average speed
-        outInfluence = 33.33f;
-    }
-    if (inType == KeyframeUI::KEYFRAME_LINEAR) {
-        normalizedInSpeed = 1.0f;
-        inInfluence = 33.33f;
-    }
-
-    // First control point (affects "out" from first keyframe)
-    curve.p0_x = outInfluence / 100.0f;
-    curve.p0_y = curve.p0_x * normalizedOutSpeed;
-
-    // Second control point (affects "in" to second keyframe)
-    curve.p1_x = 1.0f - (inInfluence / 100.0f);
-    curve.p1_y = 1.0f - ((1.0f - curve.p1_x) * normalizedInSpeed);
-
-    // Clamp Y values to reasonable range (-0.5 to 1.5 for overshoot effects)
-    curve.p0_y = max(-0.5f, min(1.5f, curve.p0_y));
-    curve.p1_y = max(-0.5f, min(1.5f, curve.p1_y));
+// AE ease <-> curve handles (VelocityCurve has the EaseModel::Handles layout)
+static EaseModel::Handles ToHandles(const KeyframeUI::VelocityCurve& curve) {
+    EaseModel::Handles handles = {curve.p0_x, curve.p0_y, curve.p1_x, curve.p1_y};
+    return handles;
 }
 
-// Convert bezier control points back to AE speed/influence
-// Reverse of ConvertAEToBezier
-static void ConvertBezierToAE(
-    const KeyframeUI::VelocityCurve& curve,
-    float avgSpeed,
-    float& outSpeed, float& outInfluence,
-    float& inSpeed, float& inInfluence)
-{
-    // Influence from X coordinates
-    outInfluence = curve.p0_x * 100.0f;
-    inInfluence = (1.0f - curve.p1_x) * 100.0f;
-
-    // Clamp influence to valid range (0.01-100%)
-    outInfluence = max(0.01f, min(100.0f, outInfluence));
-    inInfluence = max(0.01f, min(100.0f, inInfluence));
-
-    // Calculate normalized speeds from control points
-    // normalizedOutSpeed = P1.y / P1.x (when P1.x != 0)
-    float normalizedOutSpeed = 1.0f;  // Default: linear
-    if (fabs(curve.p0_x) > 0.001f) {
-        normalizedOutSpeed = curve.p0_y / curve.p0_x;
-    }
-
-    // normalizedInSpeed = (1 - P2.y) / (1 - P2.x) (when P2.x != 1)
-    float normalizedInSpeed = 1.0f;  // Default: linear
-    if (fabs(1.0f - curve.p1_x) > 0.001f) {
-        normalizedInSpeed = (1.0f - curve.p1_y) / (1.0f - curve.p1_x);
-    }
-
-    // If avgSpeed is 0 or very small, use default speed of 1.0
-    // This happens when value change is 0 (no animation)
-    float safeAvgSpeed = (fabs(avgSpeed) < 0.0001f) ? 1.0f : avgSpeed;
-
-    // Clamp normalized speeds first (prevent huge values)
-    normalizedOutSpeed = max(-100.0f, min(100.0f, normalizedOutSpeed));
-    normalizedInSpeed = max(-100.0f, min(100.0f, normalizedInSpeed));
-
-    // Convert back to actual speeds
-    outSpeed = normalizedOutSpeed * safeAvgSpeed;
-    inSpeed = normalizedInSpeed * safeAvgSpeed;
-
-    // Clamp speeds to prevent NaN/inf in script (AE range: 0 ~ 10,000,000)
-    outSpeed = max(0.0f, min(10000000.0f, outSpeed));
-    inSpeed = max(0.0f, min(10000000.0f, inSpeed));
-
-    // Final NaN and infinity check
-    // Finite numbers satisfy: (x - x == 0) and (x == x)
-    if (outSpeed != outSpeed || (outSpeed - outSpeed) != 0.0f) outSpeed = safeAvgSpeed;
-    if (inSpeed != inSpeed || (inSpeed - inSpeed) != 0.0f) inSpeed = safeAvgSpeed;
-    if (outInfluence != outInfluence || (outInfluence - outInfluence) != 0.0f) outInfluence = 33.33f;
-    if (inInfluence != inInfluence || (inInfluence - inInfluence) != 0.0f) inInfluence = 33.33f;
+static KeyframeUI::VelocityCurve ToCurve(const EaseModel::Handles& handles) {
+    KeyframeUI::VelocityCurve curve = {handles.x1, handles.y1, handles.x2, handles.y2};
+    return curve;
 }
 
 // GDI+ token
-static ULONG_PTR g_gdiplusToken = 0;
+static bool g_renderAcquired = false;
+static RenderContext::Backbuffer g_backbuffer;
 
 // Window class name
 static const wchar_t* KEYFRAME_CLASS_NAME = L"AnchorSnapKeyframeClass";
@@ -282,24 +106,43 @@ static KeyframeUI::VelocityCurve g_currentCurve = {0.25f, 0.25f, 0.75f, 0.75f};
 static KeyframeUI::KeyframeResult g_result;
 static KeyframeUI::KeyframeSettings g_settings;
 
-// Keyframe info from AE
-static KeyframeUI::KeyframeInfo g_keyframeInfo = {};
+// Keyframe info from AE: every selected key pair (no cap)
+static KeyframeSelection::Selection g_selection;
 static bool g_hasKeyframeInfo = false;
-static float g_avgSpeed = 0.0f;  // Cached average speed for conversions
-
-// Multi-View mode: support multiple keyframe pairs
-static const int MAX_KEYFRAME_PAIRS = 10;  // Max supported pairs
-struct KeyframePairInfo {
-    KeyframeUI::KeyframeInfo info;
-    KeyframeUI::VelocityCurve curve;
-    float avgSpeed;
-    bool isMiddleKeyframe;  // K2 in K1-K2-K3 has both in and out handles
-};
-static KeyframePairInfo g_keyframePairs[MAX_KEYFRAME_PAIRS];
+static std::wstring g_pairTitle;        // Property of the viewed pair
+static std::string g_easePayload;       // applyEase() argument of the last Apply
+
+// Multi-View mode: one pair viewed at a time
 static int g_numKeyframePairs = 0;
 static int g_currentPairIndex = 0;  // Currently selected/viewed pair
 static bool g_multiViewMode = false;  // True if more than 2 keyframes selected
 
+// Primary dimension of the viewed pair; a unit segment (speed = slope)
+// without keyframe info
+static EaseModel::Segment CurrentSegment() {
+    if (g_hasKeyframeInfo && g_currentPairIndex < g_numKeyframePairs) {
+        return KeyframeSelection::PrimarySegment(g_selection, g_currentPairIndex);
+    }
+    EaseModel::Segment unit = {1.0, 1.0, EaseModel::INTERP_BEZIER, EaseModel::INTERP_BEZIER,
+                               {1.0, 33.33}, {1.0, 33.33}};
+    return unit;
+}
+
+// Keep the edited curve with the viewed pair
+static void StoreCurve() {
+    if (g_hasKeyframeInfo && g_currentPairIndex < g_numKeyframePairs) {
+        KeyframeSelection::SetCurve(g_selection, g_currentPairIndex, ToHandles(g_currentCurve));
+    }
+}
+
+// View a pair: its curve (or the latest edit) and its property name
+static void ShowPair(int index) {
+    g_currentPairIndex = index;
+    g_currentCurve = ToCurve(KeyframeSelection::Curve(g_selection, index));
+    const KeyframeSelection::Property& prop = g_selection.props[g_selection.pairProp[index]];
+    g_pairTitle = ScriptResult::Widen(prop.name);
+}
+
 // Navigation button states
 static bool g_navPrevHover = false;
 static bool g_navNextHover = false;
@@ -327,6 +170,14 @@ static KeyframeUI::VelocityCurve g_presetCurves[NUM_PRESETS] = {
 };
 // Which presets have been saved (custom slots 6-11)
 static bool g_presetFilled[NUM_PRESETS] = {true, true, true, true, true, true, false, false, false, false, false, false};
+// Bumped when a preset curve changes (thumbnail key in the icon atlas)
+static uint32_t g_presetGeneration[NUM_PRESETS] = {};
+
+static void SetPresetCurve(int presetIdx, const KeyframeUI::VelocityCurve& curve) {
+    g_presetCurves[presetIdx] = curve;
+    g_presetFilled[presetIdx] = true;
+    g_presetGeneration[presetIdx]++;
+}
 
 // UI interaction state
 static bool g_closeButtonHover = false;
@@ -372,119 +223,66 @@ LRESULT CALLBACK KeyframeWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 void DrawKeyframePanel(HDC hdc, int width, int height);
 void DrawVelocityGraph(Graphics& graphics, int x, int y, int width, int height);
 void DrawBezierCurve(Graphics& graphics, const KeyframeUI::VelocityCurve& curve, int x, int y, int w, int h);
-void DrawMiniBezier(Graphics& graphics, const KeyframeUI::VelocityCurve& curve, int x, int y, int size, bool active);
-PointF EvalCubicBezier(float t, float p0, float p1, float p2, float p3);
+void DrawMiniBezier(Graphics& graphics, int presetIdx, int x, int y, int size, bool active);
 float IntegrateVelocityCurve(const KeyframeUI::VelocityCurve& curve, float t);
 
-// Draw slot icon
-// iconType: 0=Empty/Number, 1=Star, 2=Circle, 3=Wave, 4=Diamond
-void DrawSlotIcon(Graphics& graphics, int iconType, float cx, float cy, float size, const Color& color) {
-    SolidBrush brush(color);
-    Pen pen(color, 1.5f);
-    float r = size / 2.0f;
-
-    switch (iconType) {
-        case 1: {  // Star (5-pointed)
-            PointF starPoints[10];
-            for (int i = 0; i < 10; i++) {
-                float angle = -90.0f + i * 36.0f;
-                float rad = angle * 3.14159f / 180.0f;
-                float dist = (i % 2 == 0) ? r : r * 0.4f;
-                starPoints[i].X = cx + cosf(rad) * dist;
-                starPoints[i].Y = cy + sinf(rad) * dist;
-            }
-            graphics.FillPolygon(&brush, starPoints, 10);
-            break;
-        }
-        case 2: {  // Circle
-            graphics.FillEllipse(&brush, cx - r * 0.7f, cy - r * 0.7f, r * 1.4f, r * 1.4f);
-            break;
-        }
-        case 3: {  // Wave (sine wave symbol)
-            GraphicsPath path;
-            float waveR = r * 0.8f;
-            for (int i = 0; i <= 20; i++) {
-                float t = (float)i / 20.0f;
-                float x = cx - waveR + t * waveR * 2.0f;
-                float y = cy + sinf(t * 3.14159f * 2.0f) * (r * 0.5f);
-                if (i == 0) path.StartFigure();
-                else {
-                    float prevT = (float)(i - 1) / 20.0f;
-                    float prevX = cx - waveR + prevT * waveR * 2.0f;
-                    float prevY = cy + sinf(prevT * 3.14159f * 2.0f) * (r * 0.5f);
-                    path.AddLine(prevX, prevY, x, y);
-                }
-            }
-            Pen wavePen(color, 2.0f);
-            graphics.DrawPath(&wavePen, &path);
-            break;
-        }
-        case 4: {  // Diamond
-            PointF diamondPoints[4] = {
-                PointF(cx, cy - r),
-                PointF(cx + r * 0.7f, cy),
-                PointF(cx, cy + r),
-                PointF(cx - r * 0.7f, cy)
-            };
-            graphics.FillPolygon(&brush, diamondPoints, 4);
-            break;
-        }
-        default:
-            break;  // No icon for 0
-    }
+// Flatness tolerance in panel units: 1/4 device pixel at the module scale
+static float CurveTolerance() {
+    return 0.25f / (g_scaleFactor > 0.0f ? g_scaleFactor : 1.0f);
 }
 
-// Draw mini bezier curve in a slot button
-void DrawMiniBezier(Graphics& graphics, const KeyframeUI::VelocityCurve& curve, int x, int y, int size, bool active) {
-    int padding = 4;
-    int drawX = x + padding;
-    int drawY = y + padding;
-    int drawSize = size - padding * 2;
+// Atlas ids of the preset thumbnails (after the slot icons 1-4)
+static const int THUMBNAIL_ICON_BASE = 16;
 
-    // Background
-    SolidBrush bgBrush(active ? Color(255, 40, 60, 40) : Color(255, 30, 30, 35));
-    graphics.FillRectangle(&bgBrush, x, y, size, size);
-
-    // Draw curve
-    Pen curvePen(active ? COLOR_CURVE : Color(180, 74, 207, 255), 1.5f);
-
-    // Bezier curve points (normalized 0-1 to screen space)
-    std::vector<PointF> points;
-    for (int i = 0; i <= 20; i++) {
-        float t = (float)i / 20.0f;
-
-        // Cubic bezier: P = (1-t)^3*P0 + 3*(1-t)^2*t*P1 + 3*(1-t)*t^2*P2 + t^3*P3
-        float px = (1-t)*(1-t)*(1-t)*0.0f +
-                   3*(1-t)*(1-t)*t*curve.p0_x +
-                   3*(1-t)*t*t*curve.p1_x +
-                   t*t*t*1.0f;
-        float py = (1-t)*(1-t)*(1-t)*0.0f +
-                   3*(1-t)*(1-t)*t*curve.p0_y +
-                   3*(1-t)*t*t*curve.p1_y +
-                   t*t*t*1.0f;
-
-        // Map to screen (Y inverted)
-        float screenX = drawX + px * drawSize;
-        float screenY = drawY + (1.0f - py) * drawSize;
-        points.push_back(PointF(screenX, screenY));
-    }
+// Mini bezier curve of a preset button (IconAtlas::RasterFunc,
+// state: generation << 1 | active)
+static void RasterMiniBezier(Graphics& graphics, int icon, uint32_t state, const RectF& rect) {
+    const KeyframeUI::VelocityCurve& curve = g_presetCurves[icon - THUMBNAIL_ICON_BASE];
+    bool active = (state & 1) != 0;
+    float size = rect.Width;
+    float padding = 4;
+    float drawX = rect.X + padding;
+    float drawY = rect.Y + padding;
+    float drawSize = size - padding * 2;
 
-    // Draw curve segments
-    for (size_t i = 1; i < points.size(); i++) {
-        graphics.DrawLine(&curvePen, points[i-1], points[i]);
+    // Background
+    const SolidBrush *bgBrush = RenderContext::Brush(active ? Color(255, 40, 60, 40) : Color(255, 30, 30, 35));
+    graphics.FillRectangle(bgBrush, rect.X, rect.Y, size, size);
+
+    // Curve from (0,0) to (1,1), normalized 0-1 to screen space (Y inverted)
+    CurveMath::Cubic cubic = {
+        drawX, drawY + drawSize,
+        drawX + curve.p0_x * drawSize, drawY + (1.0f - curve.p0_y) * drawSize,
+        drawX + curve.p1_x * drawSize, drawY + (1.0f - curve.p1_y) * drawSize,
+        drawX + drawSize, drawY
+    };
+    static std::vector<CurveMath::Point> flat;
+    static std::vector<PointF> points;
+    CurveMath::Flatten(cubic, CurveTolerance(), flat);
+    points.resize(flat.size());
+    for (size_t i = 0; i < flat.size(); i++) {
+        points[i] = PointF(flat[i].x, flat[i].y);
     }
+    const Pen *curvePen = RenderContext::Pen(active ? COLOR_CURVE : Color(180, 74, 207, 255), 1.5f);
+    graphics.DrawLines(curvePen, points.data(), (INT)points.size());
 
     // Border
-    Pen borderPen(active ? COLOR_PRESET_ACTIVE : COLOR_BORDER, 1);
-    graphics.DrawRectangle(&borderPen, x, y, size, size);
+    const Pen *borderPen = RenderContext::Pen(active ? COLOR_PRESET_ACTIVE : COLOR_BORDER, 1);
+    graphics.DrawRectangle(borderPen, rect.X, rect.Y, size, size);
+}
+
+// Draw mini bezier curve in a slot button (cached until the preset changes)
+void DrawMiniBezier(Graphics& graphics, int presetIdx, int x, int y, int size, bool active) {
+    uint32_t state = (g_presetGeneration[presetIdx] << 1) | (active ? 1 : 0);
+    IconAtlas::Draw(graphics, IconAtlas::OWNER_KEYFRAME, THUMBNAIL_ICON_BASE + presetIdx, state,
+                    RectF((REAL)x, (REAL)y, (REAL)size, (REAL)size), RasterMiniBezier);
 }
 
 namespace KeyframeUI {
 
-void Initialize() {
-    if (g_gdiplusToken == 0) {
-        GdiplusStartupInput gdiplusStartupInput;
-        GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, NULL);
+bool Initialize() {
+    if (!g_renderAcquired) {
+        g_renderAcquired = RenderContext::Acquire();
     }
 
     // Register window class
@@ -496,6 +294,7 @@ void Initialize() {
     wc.hCursor = LoadCursor(NULL, IDC_ARROW);
     wc.style = CS_HREDRAW | CS_VREDRAW;
     RegisterClassExW(&wc);
+    return g_renderAcquired;
 }
 
 void Shutdown() {
@@ -505,9 +304,10 @@ void Shutdown() {
     }
     UnregisterClassW(KEYFRAME_CLASS_NAME, GetModuleHandle(NULL));
 
-    if (g_gdiplusToken) {
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
+    g_backbuffer.Release();
+    if (g_renderAcquired) {
+        RenderContext::Release();
+        g_renderAcquired = false;
     }
 }
 
@@ -516,6 +316,7 @@ void ShowPanel(int screenX, int screenY) {
 
     // Get module scale factor from settings
     g_scaleFactor = GetModuleScaleFactor("keyframe");
+    IconAtlas::SetScale(IconAtlas::OWNER_KEYFRAME, g_scaleFactor);
 
     // Calculate scaled window dimensions
     int scaledWidth = Scaled(WINDOW_WIDTH);
@@ -646,174 +447,34 @@ KeyframeResult GetResult() {
     return g_result;
 }
 
-bool IsVisible() {
-    return g_isVisible;
+bool TakeEasePayload(std::string& payload) {
+    payload.swap(g_easePayload);
+    g_easePayload.clear();
+    return !payload.empty();
 }
 
-// Helper: Parse a single keyframe pair object from JSON
-static void ParseSingleKeyframePair(const wchar_t* json, KeyframePairInfo& pair) {
-    // Extract property name
-    JsonGetString(json, L"propName", pair.info.propName, 128);
-    JsonGetString(json, L"propMatchName", pair.info.propMatchName, 128);
-
-    // Extract keyframe indices
-    pair.info.keyIndex1 = (int)JsonGetFloat(json, L"keyIndex1", 1);
-    pair.info.keyIndex2 = (int)JsonGetFloat(json, L"keyIndex2", 2);
-
-    // Extract times and values
-    pair.info.time1 = JsonGetFloat(json, L"time1", 0.0f);
-    pair.info.time2 = JsonGetFloat(json, L"time2", 1.0f);
-    pair.info.value1 = JsonGetFloat(json, L"value1", 0.0f);
-    pair.info.value2 = JsonGetFloat(json, L"value2", 0.0f);
-
-    // Extract easing values
-    pair.info.outSpeed = JsonGetFloat(json, L"outSpeed", 0.0f);
-    pair.info.outInfluence = JsonGetFloat(json, L"outInfluence", 33.33f);
-    pair.info.inSpeed = JsonGetFloat(json, L"inSpeed", 0.0f);
-    pair.info.inInfluence = JsonGetFloat(json, L"inInfluence", 33.33f);
-
-    // Sanitize parsed values (prevent NaN/inf)
-    auto sanitizeFloat = [](float& val, float defaultVal, float minVal, float maxVal) {
-        if (val != val || (val - val) != 0.0f) val = defaultVal;  // NaN/inf check
-        val = max(minVal, min(maxVal, val));
-    };
-    sanitizeFloat(pair.info.outSpeed, 0.0f, 0.0f, 10000000.0f);
-    sanitizeFloat(pair.info.outInfluence, 33.33f, 0.01f, 100.0f);
-    sanitizeFloat(pair.info.inSpeed, 0.0f, 0.0f, 10000000.0f);
-    sanitizeFloat(pair.info.inInfluence, 33.33f, 0.01f, 100.0f);
-
-    // Extract keyframe types (1=linear, 2=bezier, 3=hold)
-    int outTypeInt = (int)JsonGetFloat(json, L"outType", 2);
-    int inTypeInt = (int)JsonGetFloat(json, L"inType", 2);
-    pair.info.outType = (KeyframeUI::KeyframeType)outTypeInt;
-    pair.info.inType = (KeyframeUI::KeyframeType)inTypeInt;
-
-    // Get average speed
-    pair.avgSpeed = JsonGetFloat(json, L"avgSpeed", 0.0f);
-
-    // If avgSpeed not provided, calculate it
-    if (pair.avgSpeed == 0.0f) {
-        float duration = pair.info.time2 - pair.info.time1;
-        float valueChange = pair.info.value2 - pair.info.value1;
-        if (fabs(duration) > 0.0001f) {
-            pair.avgSpeed = fabs(valueChange / duration);
-        }
-    }
-
-    // Sanitize avgSpeed (prevent NaN/inf from breaking script)
-    if (pair.avgSpeed != pair.avgSpeed || (pair.avgSpeed - pair.avgSpeed) != 0.0f) {
-        pair.avgSpeed = 1.0f;  // Default to 1.0 for invalid values
-    }
-    pair.avgSpeed = max(0.0f, min(10000000.0f, pair.avgSpeed));
-
-    // Convert AE easing to bezier control points
-    ConvertAEToBezier(
-        pair.info.outSpeed,
-        pair.info.outInfluence,
-        pair.info.inSpeed,
-        pair.info.inInfluence,
-        pair.avgSpeed,
-        pair.info.outType,
-        pair.info.inType,
-        pair.curve
-    );
-
-    pair.isMiddleKeyframe = false;  // Will be set later based on context
+bool IsVisible() {
+    return g_isVisible;
 }
 
-void SetKeyframeInfo(const wchar_t* infoJson) {
-    if (!infoJson || wcslen(infoJson) == 0) {
-        g_hasKeyframeInfo = false;
-        g_numKeyframePairs = 0;
-        g_multiViewMode = false;
-        return;
-    }
-
+void SetKeyframeInfo(std::string_view info) {
     // Reset state
     g_numKeyframePairs = 0;
     g_currentPairIndex = 0;
     g_multiViewMode = false;
 
-    // Check if this is a JSON array (starts with '[')
-    const wchar_t* ptr = infoJson;
-    while (*ptr == L' ' || *ptr == L'\t' || *ptr == L'\n' || *ptr == L'\r') ptr++;
-
-    if (*ptr == L'[') {
-        // Parse JSON array - multiple keyframe pairs
-        ptr++;  // Skip '['
-
-        while (*ptr && g_numKeyframePairs < MAX_KEYFRAME_PAIRS) {
-            // Skip whitespace
-            while (*ptr == L' ' || *ptr == L'\t' || *ptr == L'\n' || *ptr == L'\r' || *ptr == L',') ptr++;
-
-            if (*ptr == L']') break;  // End of array
-
-            if (*ptr == L'{') {
-                // Find the matching closing brace
-                const wchar_t* objStart = ptr;
-                int braceCount = 1;
-                ptr++;
-
-                while (*ptr && braceCount > 0) {
-                    if (*ptr == L'{') braceCount++;
-                    else if (*ptr == L'}') braceCount--;
-                    ptr++;
-                }
-
-                if (braceCount == 0) {
-                    // Extract this object as a substring
-                    size_t objLen = ptr - objStart;
-                    wchar_t* objStr = new wchar_t[objLen + 1];
-                    wcsncpy_s(objStr, objLen + 1, objStart, objLen);
-                    objStr[objLen] = L'\0';
-
-                    // Parse this object
-                    ParseSingleKeyframePair(objStr, g_keyframePairs[g_numKeyframePairs]);
-
-                    // Mark middle keyframes (not first, not last will be determined later)
-                    g_numKeyframePairs++;
-
-                    delete[] objStr;
-                }
-            } else {
-                ptr++;  // Skip unknown character
-            }
-        }
-
-        // Mark middle keyframes (keyframes that appear in both pairs)
-        // For pairs: [K1-K2, K2-K3, K3-K4], K2 and K3 are middle keyframes
-        for (int i = 0; i < g_numKeyframePairs; i++) {
-            if (i > 0) {
-                // Check if this pair's first keyframe matches previous pair's second
-                if (g_keyframePairs[i].info.keyIndex1 == g_keyframePairs[i-1].info.keyIndex2) {
-                    g_keyframePairs[i].isMiddleKeyframe = true;
-                }
-            }
-        }
-
-        g_multiViewMode = (g_numKeyframePairs > 1);
-
-    } else if (*ptr == L'{') {
-        // Single object - parse directly
-        ParseSingleKeyframePair(infoJson, g_keyframePairs[0]);
-        g_numKeyframePairs = 1;
-        g_multiViewMode = false;
-    } else {
-        // Invalid JSON
-        g_hasKeyframeInfo = false;
+    // Property header records, then one record per selected key
+    g_hasKeyframeInfo = KeyframeSelection::Parse(info, g_selection);
+    if (!g_hasKeyframeInfo) {
         return;
     }
 
+    g_numKeyframePairs = (int)g_selection.PairCount();
+    g_multiViewMode = (g_numKeyframePairs > 1);
+
     // Initialize with first pair
-    if (g_numKeyframePairs > 0) {
-        g_keyframeInfo = g_keyframePairs[0].info;
-        g_currentCurve = g_keyframePairs[0].curve;
-        g_avgSpeed = g_keyframePairs[0].avgSpeed;
-        g_hasKeyframeInfo = true;
-        g_currentPreset = PRESET_CUSTOM;
-    } else {
-        g_hasKeyframeInfo = false;
-    }
+    ShowPair(0);
+    g_currentPreset = PRESET_CUSTOM;
 
     // Reset loadRequested flag (load operation complete)
     g_result.loadRequested = false;
@@ -831,17 +492,18 @@ VelocityCurve GetCurrentCurve() {
 void CalculateAEEase(const VelocityCurve& curve,
                      float& outSpeed, float& outInfluence,
                      float& inSpeed, float& inInfluence) {
-    // Use the proper reverse conversion function
-    // This converts bezier control points back to AE speed/influence values
-    ConvertBezierToAE(curve, g_avgSpeed, outSpeed, outInfluence, inSpeed, inInfluence);
+    EaseModel::Segment segment = EaseModel::FromHandles(CurrentSegment(), ToHandles(curve));
+    outSpeed = (float)segment.out.speed;
+    outInfluence = (float)segment.out.influence;
+    inSpeed = (float)segment.in.speed;
+    inInfluence = (float)segment.in.influence;
 }
 
 void SavePresetToSlot(int slot, const VelocityCurve& curve) {
     // Editable presets are at indices 6-11 (second row)
     int presetIdx = slot + 6;
     if (presetIdx < 6 || presetIdx >= NUM_PRESETS) return;
-    g_presetCurves[presetIdx] = curve;
-    g_presetFilled[presetIdx] = true;
+    SetPresetCurve(presetIdx, curve);
 }
 
 bool LoadPresetFromSlot(int slot, VelocityCurve& curve) {
@@ -872,40 +534,11 @@ KeyframeSettings& GetSettings() {
 
 } // namespace KeyframeUI
 
-// Evaluate cubic bezier at parameter t
-PointF EvalCubicBezier(float t, float p0x, float p0y, float p1x, float p1y,
-                       float p2x, float p2y, float p3x, float p3y) {
-    float u = 1.0f - t;
-    float tt = t * t;
-    float uu = u * u;
-    float uuu = uu * u;
-    float ttt = tt * t;
-
-    PointF result;
-    result.X = uuu * p0x + 3 * uu * t * p1x + 3 * u * tt * p2x + ttt * p3x;
-    result.Y = uuu * p0y + 3 * uu * t * p1y + 3 * u * tt * p2y + ttt * p3y;
-    return result;
-}
-
-// Integrate velocity curve using Simpson's rule
+// Area under the curve from time 0 to t (normalized time / value):
+// exact, along the x(t) reparametrization
 float IntegrateVelocityCurve(const KeyframeUI::VelocityCurve& curve, float t) {
-    const int N = 100;
-    float h = t / N;
-    float sum = 0;
-
-    for (int i = 0; i <= N; i++) {
-        float ti = (float)i * h;
-        // Evaluate bezier Y at this t (velocity)
-        PointF pt = EvalCubicBezier(ti, 0, 0, curve.p0_x, curve.p0_y,
-                                    curve.p1_x, curve.p1_y, 1, 1);
-        float vi = pt.Y;
-
-        if (i == 0 || i == N) sum += vi;
-        else if (i % 2 == 0) sum += 2 * vi;
-        else sum += 4 * vi;
-    }
-
-    return (h / 3.0f) * sum;
+    CurveMath::Cubic cubic = CurveMath::TimingCubic(curve.p0_x, curve.p0_y, curve.p1_x, curve.p1_y);
+    return (float)CurveMath::Integral(cubic, t);
 }
 
 // Draw the bezier curve in the graph area
@@ -920,29 +553,39 @@ inline float CurveYToScreen(float curveY, int graphY, int graphH) {
     return graphY + normalizedY * graphH;
 }
 
+// Tessellated graph curve, keyed by its screen-space control points
+// (curve + graph rect) and tolerance: hover / button repaints reuse it
+static CurveMath::Cubic g_graphCubic;
+static float g_graphTolerance = 0.0f;
+static std::vector<CurveMath::Point> g_graphFlat;
+static std::vector<PointF> g_graphPoints;
+
 void DrawBezierCurve(Graphics& graphics, const KeyframeUI::VelocityCurve& curve,
                      int x, int y, int w, int h) {
     // Draw the velocity curve as a bezier with overshoot support
-    std::vector<PointF> points;
-    const int segments = 50;
-
-    for (int i = 0; i <= segments; i++) {
-        float t = (float)i / segments;
-        PointF pt = EvalCubicBezier(t, 0, 1, curve.p0_x, 1 - curve.p0_y,
-                                    curve.p1_x, 1 - curve.p1_y, 1, 0);
-        // Map to graph coordinates with padding for overshoot
-        float px = x + pt.X * w;
-        // pt.Y is inverted (0=bottom, 1=top in curve space)
-        float curveY = 1.0f - pt.Y;  // Convert back to curve Y
-        float py = CurveYToScreen(curveY, y, h);
-        points.push_back(PointF(px, py));
+    // (affine map of the curve-space control points, so the screen-space
+    // bezier is the same curve)
+    CurveMath::Cubic cubic = {
+        (float)x, CurveYToScreen(0.0f, y, h),
+        x + curve.p0_x * w, CurveYToScreen(curve.p0_y, y, h),
+        x + curve.p1_x * w, CurveYToScreen(curve.p1_y, y, h),
+        (float)(x + w), CurveYToScreen(1.0f, y, h)
+    };
+    float tolerance = CurveTolerance();
+    if (g_graphPoints.empty() || cubic != g_graphCubic || tolerance != g_graphTolerance) {
+        PROFILE_SCOPE("paint.keyframe.tessellate");
+        CurveMath::Flatten(cubic, tolerance, g_graphFlat);
+        g_graphPoints.resize(g_graphFlat.size());
+        for (size_t i = 0; i < g_graphFlat.size(); i++) {
+            g_graphPoints[i] = PointF(g_graphFlat[i].x, g_graphFlat[i].y);
+        }
+        g_graphCubic = cubic;
+        g_graphTolerance = tolerance;
     }
 
     // Draw curve
-    Pen curvePen(COLOR_CURVE, 2.5f);
-    if (points.size() > 1) {
-        graphics.DrawLines(&curvePen, points.data(), (INT)points.size());
-    }
+    const Pen *curvePen = RenderContext::Pen(COLOR_CURVE, 2.5f);
+    graphics.DrawLines(curvePen, g_graphPoints.data(), (INT)g_graphPoints.size());
 
     // Draw control point handles (with overshoot support)
     float p0_screenX = x + curve.p0_x * w;
@@ -955,32 +598,32 @@ void DrawBezierCurve(Graphics& graphics, const KeyframeUI::VelocityCurve& curve,
     float endY = CurveYToScreen(1.0f, y, h);    // Top endpoint
 
     // Lines from endpoints to handles
-    Pen handleLinePen(COLOR_CURVE_DIM, 1);
-    graphics.DrawLine(&handleLinePen, (REAL)x, startY, p0_screenX, p0_screenY);
-    graphics.DrawLine(&handleLinePen, (REAL)(x + w), endY, p1_screenX, p1_screenY);
+    const Pen *handleLinePen = RenderContext::Pen(COLOR_CURVE_DIM, 1);
+    graphics.DrawLine(handleLinePen, (REAL)x, startY, p0_screenX, p0_screenY);
+    graphics.DrawLine(handleLinePen, (REAL)(x + w), endY, p1_screenX, p1_screenY);
 
     // Handle circles
     const float handleRadius = 6.0f;
     Color h0Color = g_handleHover[0] ? COLOR_HANDLE_HOVER : COLOR_HANDLE;
     Color h1Color = g_handleHover[1] ? COLOR_HANDLE_HOVER : COLOR_HANDLE;
 
-    SolidBrush h0Brush(h0Color);
-    SolidBrush h1Brush(h1Color);
+    const SolidBrush *h0Brush = RenderContext::Brush(h0Color);
+    const SolidBrush *h1Brush = RenderContext::Brush(h1Color);
 
-    graphics.FillEllipse(&h0Brush,
+    graphics.FillEllipse(h0Brush,
         p0_screenX - handleRadius, p0_screenY - handleRadius,
         handleRadius * 2, handleRadius * 2);
-    graphics.FillEllipse(&h1Brush,
+    graphics.FillEllipse(h1Brush,
         p1_screenX - handleRadius, p1_screenY - handleRadius,
         handleRadius * 2, handleRadius * 2);
 
     // Start/end points
-    SolidBrush endpointBrush(COLOR_TEXT);
+    const SolidBrush *endpointBrush = RenderContext::Brush(COLOR_TEXT);
     const float endpointRadius = 4.0f;
-    graphics.FillEllipse(&endpointBrush,
+    graphics.FillEllipse(endpointBrush,
         (REAL)x - endpointRadius, startY - endpointRadius,
         endpointRadius * 2, endpointRadius * 2);
-    graphics.FillEllipse(&endpointBrush,
+    graphics.FillEllipse(endpointBrush,
         (REAL)(x + w) - endpointRadius, endY - endpointRadius,
         endpointRadius * 2, endpointRadius * 2);
 }
@@ -988,39 +631,39 @@ void DrawBezierCurve(Graphics& graphics, const KeyframeUI::VelocityCurve& curve,
 // Draw the velocity graph with grid
 void DrawVelocityGraph(Graphics& graphics, int x, int y, int width, int height) {
     // Background
-    SolidBrush bgBrush(COLOR_GRAPH_BG);
-    graphics.FillRectangle(&bgBrush, x, y, width, height);
+    const SolidBrush *bgBrush = RenderContext::Brush(COLOR_GRAPH_BG);
+    graphics.FillRectangle(bgBrush, x, y, width, height);
 
     // Overshoot areas (dimmer background)
     float line0Y = CurveYToScreen(0.0f, y, height);  // Y=0 line
     float line1Y = CurveYToScreen(1.0f, y, height);  // Y=1 line
-    SolidBrush overshootBrush(Color(40, 255, 100, 100));  // Subtle red tint
+    const SolidBrush *overshootBrush = RenderContext::Brush(Color(40, 255, 100, 100)); // Subtle red tint
     // Top overshoot area (above Y=1)
-    graphics.FillRectangle(&overshootBrush, x, y, width, (int)(line1Y - y));
+    graphics.FillRectangle(overshootBrush, x, y, width, (int)(line1Y - y));
     // Bottom overshoot area (below Y=0)
-    graphics.FillRectangle(&overshootBrush, x, (int)line0Y, width, (int)(y + height - line0Y));
+    graphics.FillRectangle(overshootBrush, x, (int)line0Y, width, (int)(y + height - line0Y));
 
     // Border
-    Pen borderPen(COLOR_BORDER, 1);
-    graphics.DrawRectangle(&borderPen, x, y, width - 1, height - 1);
+    const Pen *borderPen = RenderContext::Pen(COLOR_BORDER, 1);
+    graphics.DrawRectangle(borderPen, x, y, width - 1, height - 1);
 
     // Grid lines (within 0-1 range)
-    Pen gridPen(COLOR_GRAPH_GRID, 1);
+    const Pen *gridPen = RenderContext::Pen(COLOR_GRAPH_GRID, 1);
     const int gridLines = 4;
     for (int i = 1; i < gridLines; i++) {
         float ratio = (float)i / gridLines;
         int gx = x + (int)(ratio * width);
         // Vertical grid lines span full height
-        graphics.DrawLine(&gridPen, gx, y, gx, y + height);
+        graphics.DrawLine(gridPen, gx, y, gx, y + height);
         // Horizontal grid lines at 0.25, 0.5, 0.75 in curve space
         float lineY = CurveYToScreen(ratio, y, height);
-        graphics.DrawLine(&gridPen, x, (int)lineY, x + width, (int)lineY);
+        graphics.DrawLine(gridPen, x, (int)lineY, x + width, (int)lineY);
     }
 
     // Boundary lines at Y=0 and Y=1 (more visible)
-    Pen boundaryPen(Color(180, 100, 180, 255), 1);  // Purple-ish
-    graphics.DrawLine(&boundaryPen, x, (int)line0Y, x + width, (int)line0Y);
-    graphics.DrawLine(&boundaryPen, x, (int)line1Y, x + width, (int)line1Y);
+    const Pen *boundaryPen = RenderContext::Pen(Color(180, 100, 180, 255), 1); // Purple-ish
+    graphics.DrawLine(boundaryPen, x, (int)line0Y, x + width, (int)line0Y);
+    graphics.DrawLine(boundaryPen, x, (int)line1Y, x + width, (int)line1Y);
 
     // Diagonal reference line (linear) - from (0,0) to (1,1) in curve space
     Pen refPen(COLOR_GRAPH_GRID, 1);
@@ -1036,14 +679,26 @@ void DrawVelocityGraph(Graphics& graphics, int x, int y, int width, int height)
     // Draw current curve
     DrawBezierCurve(graphics, g_currentCurve, x, y, width, height);
 
-    // Axis labels
-    FontFamily fontFamily(L"Segoe UI");
-    Font labelFont(&fontFamily, 9, FontStyleRegular, UnitPixel);
-    SolidBrush labelBrush(COLOR_TEXT_DIM);
-    StringFormat sf;
-    sf.SetAlignment(StringAlignmentCenter);
-
-    // Labels removed for cleaner look
+    // Peak velocity (relative to average; AE units when the pair's
+    // average speed is known), bottom-right corner
+    const Font *labelFont = RenderContext::Font(9);
+    const SolidBrush *labelBrush = RenderContext::Brush(COLOR_TEXT_DIM);
+    const StringFormat *sf = RenderContext::Format(StringAlignmentFar, StringAlignmentFar);
+    CurveMath::Cubic cubic = CurveMath::TimingCubic(g_currentCurve.p0_x, g_currentCurve.p0_y,
+                                                    g_currentCurve.p1_x, g_currentCurve.p1_y);
+    float peakX = 0.0f;
+    float peak = CurveMath::PeakSlope(cubic, &peakX);
+    wchar_t peakText[64];
+    if (peak > 99.0f) {
+        swprintf_s(peakText, L"Peak >99x @ %.0f%%", peakX * 100.0f);
+    } else if (g_hasKeyframeInfo && EaseModel::Classify(CurrentSegment()) == EaseModel::SHAPE_CURVE) {
+        double average = fabs(EaseModel::AverageSpeed(CurrentSegment()));
+        swprintf_s(peakText, L"Peak %.1f/s (%.2fx) @ %.0f%%", peak * average, peak, peakX * 100.0f);
+    } else {
+        swprintf_s(peakText, L"Peak %.2fx @ %.0f%%", peak, peakX * 100.0f);
+    }
+    RectF labelRect((REAL)x + 4, (REAL)y + 2, (REAL)width - 8, (REAL)height - 4);
+    graphics.DrawString(peakText, -1, labelFont, labelRect, sf, labelBrush);
 }
 
 // Draw the full keyframe panel
@@ -1060,46 +715,41 @@ void DrawKeyframePanel(HDC hdc, int width, int height) {
     int baseHeight = WINDOW_HEIGHT;
 
     // Background
-    SolidBrush bgBrush(COLOR_BG);
-    graphics.FillRectangle(&bgBrush, 0, 0, baseWidth, baseHeight);
+    const SolidBrush *bgBrush = RenderContext::Brush(COLOR_BG);
+    graphics.FillRectangle(bgBrush, 0, 0, baseWidth, baseHeight);
 
     // Border
-    Pen borderPen(COLOR_BORDER, 1);
-    graphics.DrawRectangle(&borderPen, 0, 0, baseWidth - 1, baseHeight - 1);
+    const Pen *borderPen = RenderContext::Pen(COLOR_BORDER, 1);
+    graphics.DrawRectangle(borderPen, 0, 0, baseWidth - 1, baseHeight - 1);
 
     // Fonts
-    FontFamily fontFamily(L"Segoe UI");
-    Font headerFont(&fontFamily, 12, FontStyleBold, UnitPixel);
-    Font labelFont(&fontFamily, 11, FontStyleRegular, UnitPixel);
-    Font presetFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    Font valueFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush dimBrush(COLOR_TEXT_DIM);
-    SolidBrush accentBrush(COLOR_ACCENT);
-
-    StringFormat sf;
-    sf.SetAlignment(StringAlignmentNear);
-    sf.SetLineAlignment(StringAlignmentCenter);
-
-    StringFormat sfCenter;
-    sfCenter.SetAlignment(StringAlignmentCenter);
-    sfCenter.SetLineAlignment(StringAlignmentCenter);
+    const Font *headerFont = RenderContext::Font(12, FontStyleBold);
+    const Font *labelFont = RenderContext::Font(11);
+    const Font *presetFont = RenderContext::Font(10);
+    const Font *valueFont = RenderContext::Font(10);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
+    const SolidBrush *dimBrush = RenderContext::Brush(COLOR_TEXT_DIM);
+    const SolidBrush *accentBrush = RenderContext::Brush(COLOR_ACCENT);
+
+    const StringFormat *sf = RenderContext::Format(StringAlignmentNear);
+
+    const StringFormat *sfCenter = RenderContext::Format(StringAlignmentCenter);
 
     int currentY = PADDING;
 
     // ===== Header bar =====
-    SolidBrush headerBgBrush(COLOR_HEADER_BG);
+    const SolidBrush *headerBgBrush = RenderContext::Brush(COLOR_HEADER_BG);
     RectF headerRect((REAL)PADDING, (REAL)currentY,
                      (REAL)(baseWidth - PADDING * 2 - CLOSE_BUTTON_SIZE - 4), (REAL)HEADER_HEIGHT);
-    graphics.FillRectangle(&headerBgBrush, headerRect);
+    graphics.FillRectangle(headerBgBrush, headerRect);
 
     // Title - show property name if available
     RectF titleRect((REAL)(PADDING + 8), (REAL)currentY, (REAL)(baseWidth - PADDING * 2 - CLOSE_BUTTON_SIZE - 20), (REAL)HEADER_HEIGHT);
-    if (g_hasKeyframeInfo && wcslen(g_keyframeInfo.propName) > 0) {
+    if (g_hasKeyframeInfo && !g_pairTitle.empty()) {
         // Show property name with accent color
-        graphics.DrawString(g_keyframeInfo.propName, -1, &headerFont, titleRect, &sf, &accentBrush);
+        graphics.DrawString(g_pairTitle.c_str(), -1, headerFont, titleRect, sf, accentBrush);
     } else {
-        graphics.DrawString(L"Keyframe Easing", -1, &headerFont, titleRect, &sf, &textBrush);
+        graphics.DrawString(L"Keyframe Easing", -1, headerFont, titleRect, sf, textBrush);
     }
 
     // Pin button 📌 (before close button)
@@ -1110,27 +760,27 @@ void DrawKeyframePanel(HDC hdc, int width, int height) {
 
     Color pinColor = g_pressedPinButton ? Color(255, 40, 80, 40) :  // Pressed: darker
                      g_keepPanelOpen ? COLOR_ACCENT : (g_pinButtonHover ? COLOR_PRESET_HOVER : COLOR_PRESET_BG);
-    SolidBrush pinBgBrush(pinColor);
-    graphics.FillRectangle(&pinBgBrush, pinRect);
+    const SolidBrush *pinBgBrush = RenderContext::Brush(pinColor);
+    graphics.FillRectangle(pinBgBrush, pinRect);
 
     // Draw pin icon (pushpin shape)
     float pinCx = (float)pinBtnX + CLOSE_BUTTON_SIZE / 2.0f;
     float pinCy = (float)pinBtnY + CLOSE_BUTTON_SIZE / 2.0f;
     Color pinIconColor = g_keepPanelOpen ? Color(255, 255, 255, 255) : COLOR_TEXT;
-    Pen pinPen(pinIconColor, 1.5f);
-    SolidBrush pinBrush(pinIconColor);
+    const Pen *pinPen = RenderContext::Pen(pinIconColor, 1.5f);
+    const SolidBrush *pinBrush = RenderContext::Brush(pinIconColor);
 
     // Pin head (circle)
-    graphics.FillEllipse(&pinBrush, pinCx - 3.0f, pinCy - 5.0f, 6.0f, 6.0f);
+    graphics.FillEllipse(pinBrush, pinCx - 3.0f, pinCy - 5.0f, 6.0f, 6.0f);
     // Pin needle (line down)
-    graphics.DrawLine(&pinPen, pinCx, pinCy + 1.0f, pinCx, pinCy + 6.0f);
+    graphics.DrawLine(pinPen, pinCx, pinCy + 1.0f, pinCx, pinCy + 6.0f);
     // Pin base (small triangle)
     PointF pinBase[3] = {
         PointF(pinCx - 2.0f, pinCy + 1.0f),
         PointF(pinCx + 2.0f, pinCy + 1.0f),
         PointF(pinCx, pinCy + 4.0f)
     };
-    graphics.FillPolygon(&pinBrush, pinBase, 3);
+    graphics.FillPolygon(pinBrush, pinBase, 3);
 
     // Close button [x]
     int closeBtnX = width - PADDING - CLOSE_BUTTON_SIZE;
@@ -1139,19 +789,19 @@ void DrawKeyframePanel(HDC hdc, int width, int height) {
                     (REAL)CLOSE_BUTTON_SIZE, (REAL)CLOSE_BUTTON_SIZE);
 
     if (g_pressedCloseButton) {
-        SolidBrush closeBgBrush(Color(255, 150, 40, 40));  // Darker red when pressed
-        graphics.FillRectangle(&closeBgBrush, closeRect);
+        const SolidBrush *closeBgBrush = RenderContext::Brush(Color(255, 150, 40, 40)); // Darker red when pressed
+        graphics.FillRectangle(closeBgBrush, closeRect);
     } else if (g_closeButtonHover) {
-        SolidBrush closeBgBrush(COLOR_CLOSE_HOVER);
-        graphics.FillRectangle(&closeBgBrush, closeRect);
+        const SolidBrush *closeBgBrush = RenderContext::Brush(COLOR_CLOSE_HOVER);
+        graphics.FillRectangle(closeBgBrush, closeRect);
     }
 
-    Pen xPen(COLOR_TEXT, 2);
+    const Pen *xPen = RenderContext::Pen(COLOR_TEXT, 2);
     float margin = 5.0f;
-    graphics.DrawLine(&xPen,
+    graphics.DrawLine(xPen,
         (REAL)(closeBtnX + margin), (REAL)(closeBtnY + margin),
         (REAL)(closeBtnX + CLOSE_BUTTON_SIZE - margin), (REAL)(closeBtnY + CLOSE_BUTTON_SIZE - margin));
-    graphics.DrawLine(&xPen,
+    graphics.DrawLine(xPen,
         (REAL)(closeBtnX + CLOSE_BUTTON_SIZE - margin), (REAL)(closeBtnY + margin),
         (REAL)(closeBtnX + margin), (REAL)(closeBtnY + CLOSE_BUTTON_SIZE - margin));
 
@@ -1170,35 +820,35 @@ void DrawKeyframePanel(HDC hdc, int width, int height) {
         Color prevBtnColor = g_pressedNavPrev ? Color(255, 30, 80, 30) :
                              g_navPrevHover ? COLOR_PRESET_HOVER :
                              (g_currentPairIndex > 0) ? COLOR_PRESET_BG : Color(100, 40, 40, 50);
-        SolidBrush prevBtnBrush(prevBtnColor);
-        graphics.FillRectangle(&prevBtnBrush, prevBtnRect);
-        Pen prevBorder(COLOR_BORDER, 1);
-        graphics.DrawRectangle(&prevBorder, prevBtnRect);
+        const SolidBrush *prevBtnBrush = RenderContext::Brush(prevBtnColor);
+        graphics.FillRectangle(prevBtnBrush, prevBtnRect);
+        const Pen *prevBorder = RenderContext::Pen(COLOR_BORDER, 1);
+        graphics.DrawRectangle(prevBorder, prevBtnRect);
 
         // Draw ◀ arrow
         if (g_currentPairIndex > 0) {
-            SolidBrush arrowBrush(COLOR_TEXT);
+            const SolidBrush *arrowBrush = RenderContext::Brush(COLOR_TEXT);
             PointF leftArrow[3] = {
                 PointF((float)prevBtnX + 18, (float)navY + 8),
                 PointF((float)prevBtnX + 18, (float)navY + NAV_BUTTON_SIZE - 8),
                 PointF((float)prevBtnX + 8, (float)navY + NAV_BUTTON_SIZE / 2)
             };
-            graphics.FillPolygon(&arrowBrush, leftArrow, 3);
+            graphics.FillPolygon(arrowBrush, leftArrow, 3);
         } else {
-            SolidBrush dimArrowBrush(COLOR_TEXT_DIM);
+            const SolidBrush *dimArrowBrush = RenderContext::Brush(COLOR_TEXT_DIM);
             PointF leftArrow[3] = {
                 PointF((float)prevBtnX + 18, (float)navY + 8),
                 PointF((float)prevBtnX + 18, (float)navY + NAV_BUTTON_SIZE - 8),
                 PointF((float)prevBtnX + 8, (float)navY + NAV_BUTTON_SIZE / 2)
             };
-            graphics.FillPolygon(&dimArrowBrush, leftArrow, 3);
+            graphics.FillPolygon(dimArrowBrush, leftArrow, 3);
         }
 
         // Indicator text "1/3" in the middle
         wchar_t navText[16];
         swprintf_s(navText, L"%d / %d", g_currentPairIndex + 1, g_numKeyframePairs);
         RectF navTextRect((REAL)(navCenterX - 30), (REAL)navY, 60, (REAL)NAV_BUTTON_SIZE);
-        graphics.DrawString(navText, -1, &labelFont, navTextRect, &sfCenter, &textBrush);
+        graphics.DrawString(navText, -1, labelFont, navTextRect, sfCenter, textBrush);
 
         // Next button [▶]
         int nextBtnX = navCenterX + 80 - NAV_BUTTON_SIZE;
@@ -1208,28 +858,28 @@ void DrawKeyframePanel(HDC hdc, int width, int height) {
         Color nextBtnColor = g_pressedNavNext ? Color(255, 30, 80, 30) :
                              g_navNextHover ? COLOR_PRESET_HOVER :
                              (g_currentPairIndex < g_numKeyframePairs - 1) ? COLOR_PRESET_BG : Color(100, 40, 40, 50);
-        SolidBrush nextBtnBrush(nextBtnColor);
-        graphics.FillRectangle(&nextBtnBrush, nextBtnRect);
-        Pen nextBorder(COLOR_BORDER, 1);
-        graphics.DrawRectangle(&nextBorder, nextBtnRect);
+        const SolidBrush *nextBtnBrush = RenderContext::Brush(nextBtnColor);
+        graphics.FillRectangle(nextBtnBrush, nextBtnRect);
+        const Pen *nextBorder = RenderContext::Pen(COLOR_BORDER, 1);
+        graphics.DrawRectangle(nextBorder, nextBtnRect);
 
         // Draw ▶ arrow
         if (g_currentPairIndex < g_numKeyframePairs - 1) {
-            SolidBrush arrowBrush(COLOR_TEXT);
+            const SolidBrush *arrowBrush = RenderContext::Brush(COLOR_TEXT);
             PointF rightArrow[3] = {
                 PointF((float)nextBtnX + 10, (float)navY + 8),
                 PointF((float)nextBtnX + 10, (float)navY + NAV_BUTTON_SIZE - 8),
                 PointF((float)nextBtnX + 20, (float)navY + NAV_BUTTON_SIZE / 2)
             };
-            graphics.FillPolygon(&arrowBrush, rightArrow, 3);
+            graphics.FillPolygon(arrowBrush, rightArrow, 3);
         } else {
-            SolidBrush dimArrowBrush(COLOR_TEXT_DIM);
+            const SolidBrush *dimArrowBrush = RenderContext::Brush(COLOR_TEXT_DIM);
             PointF rightArrow[3] = {
                 PointF((float)nextBtnX + 10, (float)navY + 8),
                 PointF((float)nextBtnX + 10, (float)navY + NAV_BUTTON_SIZE - 8),
                 PointF((float)nextBtnX + 20, (float)navY + NAV_BUTTON_SIZE / 2)
             };
-            graphics.FillPolygon(&dimArrowBrush, rightArrow, 3);
+            graphics.FillPolygon(dimArrowBrush, rightArrow, 3);
         }
 
         currentY += NAV_BUTTON_SIZE + 4;
@@ -1256,23 +906,23 @@ void DrawKeyframePanel(HDC hdc, int width, int height) {
         Color lockColor = g_pressedLockHandles ? Color(255, 30, 80, 30) :
                           g_lockHandles ? COLOR_PRESET_ACTIVE :
                           g_lockHandlesHover ? COLOR_PRESET_HOVER : COLOR_PRESET_BG;
-        SolidBrush lockBrush(lockColor);
-        graphics.FillRectangle(&lockBrush, lockRect);
-        Pen lockBorder(COLOR_BORDER, 1);
-        graphics.DrawRectangle(&lockBorder, lockRect);
+        const SolidBrush *lockBrush = RenderContext::Brush(lockColor);
+        graphics.FillRectangle(lockBrush, lockRect);
+        const Pen *lockBorder = RenderContext::Pen(COLOR_BORDER, 1);
+        graphics.DrawRectangle(lockBorder, lockRect);
 
         // Chain icon
         float iconX = (float)lockX + 6;
         float iconY = (float)lockY + LOCK_BUTTON_SIZE / 2.0f;
         Color iconColor = g_lockHandles ? Color(255, 255, 255, 255) : COLOR_TEXT_DIM;
-        Pen iconPen(iconColor, 1.5f);
-        graphics.DrawEllipse(&iconPen, iconX, iconY - 5.0f, 8.0f, 10.0f);
-        graphics.DrawEllipse(&iconPen, iconX + 6.0f, iconY - 5.0f, 8.0f, 10.0f);
+        const Pen *iconPen = RenderContext::Pen(iconColor, 1.5f);
+        graphics.DrawEllipse(iconPen, iconX, iconY - 5.0f, 8.0f, 10.0f);
+        graphics.DrawEllipse(iconPen, iconX + 6.0f, iconY - 5.0f, 8.0f, 10.0f);
 
         // "Sync" text
         RectF lockTextRect((REAL)(lockX + 22), (REAL)lockY, 40, (REAL)LOCK_BUTTON_SIZE);
-        SolidBrush lockTextBrush(g_lockHandles ? Color(255, 255, 255, 255) : COLOR_TEXT_DIM);
-        graphics.DrawString(L"Sync", -1, &presetFont, lockTextRect, &sf, &lockTextBrush);
+        const SolidBrush *lockTextBrush = RenderContext::Brush(g_lockHandles ? Color(255, 255, 255, 255) : COLOR_TEXT_DIM);
+        graphics.DrawString(L"Sync", -1, presetFont, lockTextRect, sf, lockTextBrush);
 
         currentY += LOCK_BUTTON_SIZE + PADDING;
     } else {
@@ -1298,35 +948,35 @@ void DrawKeyframePanel(HDC hdc, int width, int height) {
 
             // Draw mini bezier graph (or empty slot for unfilled editable presets)
             if (isFilled) {
-                DrawMiniBezier(graphics, g_presetCurves[presetIdx], btnX, btnY, PRESET_BUTTON_WIDTH, isActive);
+                DrawMiniBezier(graphics, presetIdx, btnX, btnY, PRESET_BUTTON_WIDTH, isActive);
             } else {
                 // Empty slot - dark background with slot number
-                SolidBrush emptyBrush(Color(255, 25, 25, 30));
-                graphics.FillRectangle(&emptyBrush, btnX, btnY, PRESET_BUTTON_WIDTH, PRESET_BUTTON_HEIGHT);
+                const SolidBrush *emptyBrush = RenderContext::Brush(Color(255, 25, 25, 30));
+                graphics.FillRectangle(emptyBrush, btnX, btnY, PRESET_BUTTON_WIDTH, PRESET_BUTTON_HEIGHT);
 
                 wchar_t slotText[4];
                 swprintf_s(slotText, L"%d", presetIdx - 5);  // 1-6 for custom slots
                 RectF textRect((REAL)btnX, (REAL)btnY, (REAL)PRESET_BUTTON_WIDTH, (REAL)PRESET_BUTTON_HEIGHT);
-                graphics.DrawString(slotText, -1, &presetFont, textRect, &sfCenter, &dimBrush);
+                graphics.DrawString(slotText, -1, presetFont, textRect, sfCenter, dimBrush);
             }
 
             // Overlay for hover/pressed/save mode
             if (isPressed) {
-                SolidBrush pressedOverlay(Color(100, 0, 0, 0));
-                graphics.FillRectangle(&pressedOverlay, btnX, btnY, PRESET_BUTTON_WIDTH, PRESET_BUTTON_HEIGHT);
+                const SolidBrush *pressedOverlay = RenderContext::Brush(Color(100, 0, 0, 0));
+                graphics.FillRectangle(pressedOverlay, btnX, btnY, PRESET_BUTTON_WIDTH, PRESET_BUTTON_HEIGHT);
             } else if (g_saveMode && isEditable) {
                 // Save mode - orange border glow for editable slots
-                Pen savePen(Color(255, 255, 180, 0), 2);
-                graphics.DrawRectangle(&savePen, btnX, btnY, PRESET_BUTTON_WIDTH, PRESET_BUTTON_HEIGHT);
+                const Pen *savePen = RenderContext::Pen(Color(255, 255, 180, 0), 2);
+                graphics.DrawRectangle(savePen, btnX, btnY, PRESET_BUTTON_WIDTH, PRESET_BUTTON_HEIGHT);
             } else if (isHovered && !isActive) {
-                SolidBrush hoverOverlay(Color(60, 255, 255, 255));
-                graphics.FillRectangle(&hoverOverlay, btnX, btnY, PRESET_BUTTON_WIDTH, PRESET_BUTTON_HEIGHT);
+                const SolidBrush *hoverOverlay = RenderContext::Brush(Color(60, 255, 255, 255));
+                graphics.FillRectangle(hoverOverlay, btnX, btnY, PRESET_BUTTON_WIDTH, PRESET_BUTTON_HEIGHT);
             }
 
             // Border
             if (!(g_saveMode && isEditable)) {
-                Pen btnBorder(isActive ? COLOR_PRESET_ACTIVE : COLOR_BORDER, isActive ? 2.0f : 1.0f);
-                graphics.DrawRectangle(&btnBorder, btnX, btnY, PRESET_BUTTON_WIDTH, PRESET_BUTTON_HEIGHT);
+                const Pen *btnBorder = RenderContext::Pen(isActive ? COLOR_PRESET_ACTIVE : COLOR_BORDER, isActive ? 2.0f : 1.0f);
+                graphics.DrawRectangle(btnBorder, btnX, btnY, PRESET_BUTTON_WIDTH, PRESET_BUTTON_HEIGHT);
             }
         }
         currentY += PRESET_BUTTON_HEIGHT + btnSpacing;
@@ -1341,15 +991,14 @@ void DrawKeyframePanel(HDC hdc, int width, int height) {
     wchar_t outText[64];
     swprintf_s(outText, L"Out: Spd %.1f / Infl %.0f%%", outSpeed, outInfluence);
     RectF outValueRect((REAL)PADDING, (REAL)currentY, (REAL)(baseWidth/2 - PADDING), 18);
-    graphics.DrawString(outText, -1, &valueFont, outValueRect, &sf, &textBrush);
+    graphics.DrawString(outText, -1, valueFont, outValueRect, sf, textBrush);
 
     // Right column: In ease
     wchar_t inText[64];
     swprintf_s(inText, L"In: Spd %.1f / Infl %.0f%%", inSpeed, inInfluence);
     RectF inValueRect((REAL)(baseWidth/2), (REAL)currentY, (REAL)(baseWidth/2 - PADDING), 18);
-    StringFormat sfRight;
-    sfRight.SetAlignment(StringAlignmentFar);
-    graphics.DrawString(inText, -1, &valueFont, inValueRect, &sfRight, &textBrush);
+    const StringFormat *sfRight = RenderContext::Format(StringAlignmentFar, StringAlignmentNear);
+    graphics.DrawString(inText, -1, valueFont, inValueRect, sfRight, textBrush);
 
     currentY += 22;
 
@@ -1369,21 +1018,21 @@ void DrawKeyframePanel(HDC hdc, int width, int height) {
     Color saveBtnColor = g_pressedSaveButton ? Color(255, 30, 80, 30) :
                          g_saveMode ? COLOR_PRESET_ACTIVE :
                          g_saveButtonHover ? COLOR_PRESET_HOVER : COLOR_PRESET_BG;
-    SolidBrush saveBtnBrush(saveBtnColor);
-    graphics.FillRectangle(&saveBtnBrush, saveBtnRect);
-    Pen saveBorder(COLOR_BORDER, 1);
-    graphics.DrawRectangle(&saveBorder, saveBtnRect);
+    const SolidBrush *saveBtnBrush = RenderContext::Brush(saveBtnColor);
+    graphics.FillRectangle(saveBtnBrush, saveBtnRect);
+    const Pen *saveBorder = RenderContext::Pen(COLOR_BORDER, 1);
+    graphics.DrawRectangle(saveBorder, saveBtnRect);
 
     // Floppy disk icon
     float diskCx = (float)saveBtnX + saveBtnWidth / 2.0f;
     float diskCy = (float)currentY + actionBtnHeight / 2.0f;
     float diskSize = 14.0f;
     Color diskColor = g_saveMode ? Color(255, 255, 255, 255) : COLOR_TEXT;
-    Pen diskPen(diskColor, 1.5f);
-    graphics.DrawRectangle(&diskPen, diskCx - diskSize/2, diskCy - diskSize/2, diskSize, diskSize);
-    graphics.DrawRectangle(&diskPen, diskCx - diskSize/3, diskCy - diskSize/2, diskSize*2/3, diskSize/3);
-    SolidBrush diskBrush(diskColor);
-    graphics.FillRectangle(&diskBrush, diskCx - diskSize/6, diskCy + diskSize/6, diskSize/3, diskSize/3);
+    const Pen *diskPen = RenderContext::Pen(diskColor, 1.5f);
+    graphics.DrawRectangle(diskPen, diskCx - diskSize/2, diskCy - diskSize/2, diskSize, diskSize);
+    graphics.DrawRectangle(diskPen, diskCx - diskSize/3, diskCy - diskSize/2, diskSize*2/3, diskSize/3);
+    const SolidBrush *diskBrush = RenderContext::Brush(diskColor);
+    graphics.FillRectangle(diskBrush, diskCx - diskSize/6, diskCy + diskSize/6, diskSize/3, diskSize/3);
 
     // Apply button (green)
     int applyBtnX = saveBtnX + saveBtnWidth + actionBtnSpacing;
@@ -1391,12 +1040,12 @@ void DrawKeyframePanel(HDC hdc, int width, int height) {
 
     Color applyBtnColor = g_pressedApplyButton ? Color(255, 30, 100, 30) :
                           g_applyButtonHover ? Color(255, 80, 180, 80) : Color(255, 50, 140, 50);
-    SolidBrush applyBtnBrush(applyBtnColor);
-    graphics.FillRectangle(&applyBtnBrush, applyBtnRect);
-    Pen applyBorder(Color(255, 100, 200, 100), 1);
-    graphics.DrawRectangle(&applyBorder, applyBtnRect);
-    SolidBrush applyTextBrush(Color(255, 255, 255, 255));
-    graphics.DrawString(L"Apply", -1, &presetFont, applyBtnRect, &sfCenter, &applyTextBrush);
+    const SolidBrush *applyBtnBrush = RenderContext::Brush(applyBtnColor);
+    graphics.FillRectangle(applyBtnBrush, applyBtnRect);
+    const Pen *applyBorder = RenderContext::Pen(Color(255, 100, 200, 100), 1);
+    graphics.DrawRectangle(applyBorder, applyBtnRect);
+    const SolidBrush *applyTextBrush = RenderContext::Brush(Color(255, 255, 255, 255));
+    graphics.DrawString(L"Apply", -1, presetFont, applyBtnRect, sfCenter, applyTextBrush);
 
     // Load button (blue)
     int loadBtnX = applyBtnX + applyBtnWidth + actionBtnSpacing;
@@ -1404,18 +1053,39 @@ void DrawKeyframePanel(HDC hdc, int width, int height) {
 
     Color loadBtnColor = g_pressedLoadButton ? Color(255, 30, 60, 120) :
                          g_loadButtonHover ? Color(255, 80, 140, 220) : Color(255, 50, 100, 180);
-    SolidBrush loadBtnBrush(loadBtnColor);
-    graphics.FillRectangle(&loadBtnBrush, loadBtnRect);
-    Pen loadBorder(Color(255, 100, 150, 255), 1);
-    graphics.DrawRectangle(&loadBorder, loadBtnRect);
-    SolidBrush loadTextBrush(Color(255, 255, 255, 255));
-    graphics.DrawString(L"Load", -1, &presetFont, loadBtnRect, &sfCenter, &loadTextBrush);
+    const SolidBrush *loadBtnBrush = RenderContext::Brush(loadBtnColor);
+    graphics.FillRectangle(loadBtnBrush, loadBtnRect);
+    const Pen *loadBorder = RenderContext::Pen(Color(255, 100, 150, 255), 1);
+    graphics.DrawRectangle(loadBorder, loadBtnRect);
+    const SolidBrush *loadTextBrush = RenderContext::Brush(Color(255, 255, 255, 255));
+    graphics.DrawString(L"Load", -1, presetFont, loadBtnRect, sfCenter, loadTextBrush);
+}
+
+// Apply current curve: AE ease of the viewed pair (display) and the
+// per-pair eases of the whole selection (KeyframeSelection::BuildApply)
+static void SetApplyResult() {
+    g_result.applied = true;
+    g_result.preset = g_currentPreset;
+    g_result.customCurve = g_currentCurve;
+    KeyframeUI::CalculateAEEase(g_currentCurve,
+        g_result.outSpeed, g_result.outInfluence,
+        g_result.inSpeed, g_result.inInfluence);
+    EaseModel::Handles handles = ToHandles(g_currentCurve);
+    g_result.velocityAtStart = (float)EaseModel::OutSlope(handles);
+    g_result.velocityAtEnd = (float)EaseModel::InSlope(handles);
+
+    StoreCurve();
+    if (!g_hasKeyframeInfo || !KeyframeSelection::BuildApply(g_selection, g_easePayload)) {
+        g_easePayload.clear();
+    }
 }
 
 // Window procedure
 LRESULT CALLBACK KeyframeWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
         case WM_PAINT: {
+            TRACE_SCOPE("paint", "KeyframeUI::DrawKeyframePanel");
+            PROFILE_SCOPE("paint.keyframe");
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hwnd, &ps);
 
@@ -1423,17 +1093,11 @@ LRESULT CALLBACK KeyframeWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
             GetClientRect(hwnd, &rc);
 
             // Double buffer
-            HDC memDC = CreateCompatibleDC(hdc);
-            HBITMAP memBitmap = CreateCompatibleBitmap(hdc, rc.right, rc.bottom);
-            HBITMAP oldBitmap = (HBITMAP)SelectObject(memDC, memBitmap);
+            HDC memDC = g_backbuffer.Begin(hdc, rc.right, rc.bottom);
 
             DrawKeyframePanel(memDC, rc.right, rc.bottom);
 
-            BitBlt(hdc, 0, 0, rc.right, rc.bottom, memDC, 0, 0, SRCCOPY);
-
-            SelectObject(memDC, oldBitmap);
-            DeleteObject(memBitmap);
-            DeleteDC(memDC);
+            g_backbuffer.Present(hdc, rc.right, rc.bottom);
 
             EndPaint(hwnd, &ps);
             return 0;
@@ -1472,12 +1136,7 @@ LRESULT CALLBACK KeyframeWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
                 KeyframeUI::HidePanel();
             } else if (wParam == VK_RETURN) {
                 // Apply current curve
-                g_result.applied = true;
-                g_result.preset = g_currentPreset;
-                g_result.customCurve = g_currentCurve;
-                KeyframeUI::CalculateAEEase(g_currentCurve,
-                    g_result.outSpeed, g_result.outInfluence,
-                    g_result.inSpeed, g_result.inInfluence);
+                SetApplyResult();
                 KeyframeUI::HidePanel();
             }
             return 0;
@@ -1749,10 +1408,9 @@ LRESULT CALLBACK KeyframeWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
                     y >= navY && y < navY + NAV_BUTTON_SIZE) {
                     if (g_currentPairIndex > 0) {
                         g_pressedNavPrev = true;
-                        g_currentPairIndex--;
-                        // Update current curve from pair
-                        g_currentCurve = g_keyframePairs[g_currentPairIndex].curve;
-                        g_avgSpeed = g_keyframePairs[g_currentPairIndex].avgSpeed;
+                        // Keep this pair's edit, show the other pair
+                        StoreCurve();
+                        ShowPair(g_currentPairIndex - 1);
                         InvalidateRect(hwnd, NULL, TRUE);
                         SetTimer(hwnd, CLICK_FEEDBACK_TIMER_ID, CLICK_FEEDBACK_DURATION_MS, NULL);
                     }
@@ -1764,10 +1422,9 @@ LRESULT CALLBACK KeyframeWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
                     y >= navY && y < navY + NAV_BUTTON_SIZE) {
                     if (g_currentPairIndex < g_numKeyframePairs - 1) {
                         g_pressedNavNext = true;
-                        g_currentPairIndex++;
-                        // Update current curve from pair
-                        g_currentCurve = g_keyframePairs[g_currentPairIndex].curve;
-                        g_avgSpeed = g_keyframePairs[g_currentPairIndex].avgSpeed;
+                        // Keep this pair's edit, show the other pair
+                        StoreCurve();
+                        ShowPair(g_currentPairIndex + 1);
                         InvalidateRect(hwnd, NULL, TRUE);
                         SetTimer(hwnd, CLICK_FEEDBACK_TIMER_ID, CLICK_FEEDBACK_DURATION_MS, NULL);
                     }
@@ -1810,8 +1467,7 @@ LRESULT CALLBACK KeyframeWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
                         bool isEditable = (presetIdx >= 6);
                         if (g_saveMode && isEditable) {
                             // Save current curve to this editable slot
-                            g_presetCurves[presetIdx] = g_currentCurve;
-                            g_presetFilled[presetIdx] = true;
+                            SetPresetCurve(presetIdx, g_currentCurve);
                             g_saveMode = false;
                         } else if (g_presetFilled[presetIdx]) {
                             // Load curve from preset
@@ -1856,12 +1512,7 @@ LRESULT CALLBACK KeyframeWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
                 y >= actionY && y < actionY + actionBtnHeight) {
                 g_pressedApplyButton = true;
                 InvalidateRect(hwnd, NULL, TRUE);
-                g_result.applied = true;
-                g_result.preset = g_currentPreset;
-                g_result.customCurve = g_currentCurve;
-                KeyframeUI::CalculateAEEase(g_currentCurve,
-                    g_result.outSpeed, g_result.outInfluence,
-                    g_result.inSpeed, g_result.inInfluence);
+                SetApplyResult();
                 KeyframeUI::HidePanel();
                 return 0;
             }
@@ -1964,14 +1615,15 @@ LRESULT CALLBACK KeyframeWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
 
 namespace KeyframeUI {
 
-void Initialize() {}
+bool Initialize() { return true; }
 void Shutdown() {}
 void ShowPanel(int, int) {}
 void UpdateHover(int, int) {}
 KeyframeResult HidePanel() { return KeyframeResult(); }
 KeyframeResult GetResult() { return KeyframeResult(); }
+bool TakeEasePayload(std::string& payload) { payload.clear(); return false; }
 bool IsVisible() { return false; }
-void SetKeyframeInfo(const wchar_t*) {}
+void SetKeyframeInfo(std::string_view) {}
 VelocityCurve GetCurrentCurve() { return VelocityCurve(); }
 void CalculateAEEase(const VelocityCurve&, float&, float&, float&, float&) {}
 void SavePresetToSlot(int, const VelocityCurve&) {}
@@ -9,6 +9,9 @@
 #ifndef KEYFRAMEUI_H
 #define KEYFRAMEUI_H
 
+#include <string>
+#include <string_view>
+
 namespace KeyframeUI {
 
 // Velocity curve presets
@@ -35,22 +38,6 @@ enum KeyframeType {
     KEYFRAME_HOLD = 3       // Hold (step/instant)
 };
 
-// Keyframe info from After Effects
-struct KeyframeInfo {
-    wchar_t propName[128];          // Property display name
-    wchar_t propMatchName[128];     // Property match name
-    int keyIndex1;                  // First selected keyframe index
-    int keyIndex2;                  // Second selected keyframe index
-    float time1, time2;             // Keyframe times
-    float value1, value2;           // Keyframe values
-    // Current easing
-    float outSpeed, outInfluence;   // Out ease at key1
-    float inSpeed, inInfluence;     // In ease at key2
-    // Keyframe types
-    KeyframeType outType;           // Interpolation type at key1 (out)
-    KeyframeType inType;            // Interpolation type at key2 (in)
-};
-
 // Result after panel closes
 struct KeyframeResult {
     bool cancelled = false;         // True if ESC or clicked outside
@@ -59,15 +46,16 @@ struct KeyframeResult {
     VelocityPreset preset = PRESET_LINEAR;
     VelocityCurve customCurve;
 
-    // Calculated AE KeyframeEase values
+    // Calculated AE KeyframeEase values (viewed pair, primary dimension)
     float outSpeed = 0.0f;          // Speed at first keyframe
     float outInfluence = 33.33f;    // Influence at first keyframe (%)
     float inSpeed = 0.0f;           // Speed at second keyframe
     float inInfluence = 33.33f;     // Influence at second keyframe (%)
 
-    // Display values (from integration)
-    float velocityAtStart = 0.0f;   // Velocity at curve start
-    float velocityAtEnd = 0.0f;     // Velocity at curve end
+    // Speed / average speed at the curve ends (EaseModel::OutSlope / InSlope)
+    // of the viewed pair's curve
+    float velocityAtStart = 1.0f;   // Velocity at curve start
+    float velocityAtEnd = 1.0f;     // Velocity at curve end
     float accelerationMax = 0.0f;   // Maximum acceleration
 
     // Preset slot for save/load
@@ -82,7 +70,8 @@ struct KeyframeSettings {
 };
 
 // Initialize the Keyframe UI system
-void Initialize();
+// @return false if GDI+ or the window (class) could not be created
+bool Initialize();
 
 // Cleanup
 void Shutdown();
@@ -100,18 +89,24 @@ KeyframeResult HidePanel();
 // Get result (for toggle mode - call after IsVisible() becomes false)
 KeyframeResult GetResult();
 
+// applyEase() argument of the last Apply: per-pair eases of every selected
+// key pair (KeyframeSelection::BuildApply). Moves it out of the panel
+// @return false if there is nothing to write
+bool TakeEasePayload(std::string& payload);
+
 // Check if panel is visible
 bool IsVisible();
 
 // Set keyframe info from After Effects
-// infoJson format: JSON array from getSelectedKeyframeInfo()
-void SetKeyframeInfo(const wchar_t* infoJson);
+// info format: keyframeInfo() wire records, a property header then one
+// record per selected key (WireFormat::KeyframePropField / KeyframeField)
+void SetKeyframeInfo(std::string_view info);
 
 // Get current curve values (for preview)
 VelocityCurve GetCurrentCurve();
 
 // Calculate AE ease values from velocity curve
-// Uses Simpson's rule integration
+// Exact inverse of the loaded ease for the viewed pair (EaseModel)
 void CalculateAEEase(const VelocityCurve& curve,
                      float& outSpeed, float& outInfluence,
                      float& inSpeed, float& inInfluence);
@@ -7,6 +7,10 @@
 
 #include "ShapeUI.h"
 #include "GdiPlusIncludes.h"
+#include "WireFormat.h"
+#include "Profiler.h"
+#include "RenderContext.h"
+#include "Tracer.h"
 
 #ifdef MSWindows
 #include <windowsx.h>  // GET_X_LPARAM, GET_Y_LPARAM
@@ -150,7 +154,9 @@ static HWND g_colorPickerHwnd = NULL;
 static HWND g_anchorGridHwnd = NULL;
 static bool g_visible = false;
 static bool g_needsRefresh = false;
-static ULONG_PTR g_gdiplusToken = 0;
+static bool g_renderAcquired = false;
+static RenderContext::Backbuffer g_backbuffer;
+static RenderContext::Backbuffer g_anchorGridBackbuffer;
 static ShapeInfo g_shapeInfo = {};
 static ShapeResult g_result;
 static bool g_keepPanelOpen = false;
@@ -252,10 +258,9 @@ static std::wstring g_presetSaveName;
 // Public API
 // ============================================================================
 
-void Initialize() {
-    if (g_gdiplusToken == 0) {
-        GdiplusStartupInput gdiplusStartupInput;
-        GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, NULL);
+bool Initialize() {
+    if (!g_renderAcquired) {
+        g_renderAcquired = RenderContext::Acquire();
     }
 
     // Register window class for main panel
@@ -280,6 +285,7 @@ void Initialize() {
 
     // Load presets from file
     LoadShapePresets();
+    return g_renderAcquired;
 }
 
 void Shutdown() {
@@ -295,9 +301,11 @@ void Shutdown() {
         DestroyWindow(g_anchorGridHwnd);
         g_anchorGridHwnd = NULL;
     }
-    if (g_gdiplusToken != 0) {
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
+    g_backbuffer.Release();
+    g_anchorGridBackbuffer.Release();
+    if (g_renderAcquired) {
+        RenderContext::Release();
+        g_renderAcquired = false;
     }
 }
 
@@ -361,83 +369,42 @@ void UpdateHover(int mouseX, int mouseY) {
 
 ShapeResult GetResult() { return g_result; }
 
-void SetShapeInfo(const wchar_t* jsonInfo) {
-    if (!jsonInfo || jsonInfo[0] == L'\0') return;
-
-    std::wstring json(jsonInfo);
-
-    // Simple JSON parsing
-    auto getFloat = [&json](const wchar_t* key) -> float {
-        std::wstring search = std::wstring(L"\"") + key + L"\":";
-        size_t pos = json.find(search);
-        if (pos == std::wstring::npos) return 0;
-        pos += search.length();
-        return (float)_wtof(json.c_str() + pos);
-    };
-
-    auto getBool = [&json](const wchar_t* key) -> bool {
-        std::wstring search = std::wstring(L"\"") + key + L"\":";
-        size_t pos = json.find(search);
-        if (pos == std::wstring::npos) return false;
-        pos += search.length();
-        while (json[pos] == L' ') pos++;
-        return json[pos] == L't';
-    };
-
-    auto getString = [&json](const wchar_t* key, wchar_t* out, int maxLen) {
-        std::wstring search = std::wstring(L"\"") + key + L"\":\"";
-        size_t pos = json.find(search);
-        if (pos == std::wstring::npos) { out[0] = L'\0'; return; }
-        pos += search.length();
-        size_t end = json.find(L'"', pos);
-        if (end == std::wstring::npos) { out[0] = L'\0'; return; }
-        int len = (int)(end - pos);
-        if (len >= maxLen) len = maxLen - 1;
-        wcsncpy(out, json.c_str() + pos, len);
-        out[len] = L'\0';
-    };
-
-    auto getColorArray = [&json](const wchar_t* key, float* outRGB) {
-        std::wstring search = std::wstring(L"\"") + key + L"\":[";
-        size_t pos = json.find(search);
-        if (pos == std::wstring::npos) return;
-        pos += search.length();
-        outRGB[0] = (float)_wtof(json.c_str() + pos);
-        size_t comma1 = json.find(L',', pos);
-        if (comma1 == std::wstring::npos) return;
-        pos = comma1 + 1;
-        outRGB[1] = (float)_wtof(json.c_str() + pos);
-        size_t comma2 = json.find(L',', pos);
-        if (comma2 == std::wstring::npos) return;
-        pos = comma2 + 1;
-        outRGB[2] = (float)_wtof(json.c_str() + pos);
-    };
-
-    getString(L"layerName", g_shapeInfo.layerName, 256);
-    getString(L"shapeName", g_shapeInfo.shapeName, 128);
-    getString(L"shapeType", g_shapeInfo.shapeType, 64);
-
-    g_shapeInfo.hasFill = getBool(L"hasFill");
-    g_shapeInfo.hasStroke = getBool(L"hasStroke");
-    g_shapeInfo.strokeWidth = getFloat(L"strokeWidth");
-    g_shapeInfo.opacity = getFloat(L"opacity");
-    g_shapeInfo.sizeW = getFloat(L"sizeW");
-    g_shapeInfo.sizeH = getFloat(L"sizeH");
-    g_shapeInfo.roundness = getFloat(L"roundness");
-    g_shapeInfo.anchorX = getFloat(L"anchorX");
-    g_shapeInfo.anchorY = getFloat(L"anchorY");
-    g_shapeInfo.isParametric = getBool(L"isParametric");
-    g_shapeInfo.sizeLinkEnabled = getBool(L"sizeLink");
-
-    getColorArray(L"fillColor", g_shapeInfo.fillColor);
-    getColorArray(L"strokeColor", g_shapeInfo.strokeColor);
-
-    g_shapeInfo.boundsLeft = getFloat(L"boundsLeft");
-    g_shapeInfo.boundsTop = getFloat(L"boundsTop");
-    g_shapeInfo.boundsWidth = getFloat(L"boundsWidth");
-    g_shapeInfo.boundsHeight = getFloat(L"boundsHeight");
-
-    InvalidateRect(g_hwnd, NULL, FALSE);
+void SetShapeInfo(std::string_view info) {
+    WireFormat::Reader reader(info);
+    if (!reader.Next()) return;
+
+    reader.StringInto(WireFormat::SHAPE_LAYER_NAME, g_shapeInfo.layerName, 256);
+    reader.StringInto(WireFormat::SHAPE_NAME, g_shapeInfo.shapeName, 128);
+    reader.StringInto(WireFormat::SHAPE_TYPE, g_shapeInfo.shapeType, 64);
+
+    g_shapeInfo.hasFill = reader.Bool(WireFormat::SHAPE_HAS_FILL, false);
+    g_shapeInfo.hasStroke = reader.Bool(WireFormat::SHAPE_HAS_STROKE, false);
+    g_shapeInfo.strokeWidth = reader.Float(WireFormat::SHAPE_STROKE_WIDTH, 0);
+    g_shapeInfo.opacity = reader.Float(WireFormat::SHAPE_OPACITY, 0);
+    g_shapeInfo.sizeW = reader.Float(WireFormat::SHAPE_SIZE_W, 0);
+    g_shapeInfo.sizeH = reader.Float(WireFormat::SHAPE_SIZE_H, 0);
+    g_shapeInfo.roundness = reader.Float(WireFormat::SHAPE_ROUNDNESS, 0);
+    g_shapeInfo.anchorX = reader.Float(WireFormat::SHAPE_ANCHOR_X, 0);
+    g_shapeInfo.anchorY = reader.Float(WireFormat::SHAPE_ANCHOR_Y, 0);
+    g_shapeInfo.isParametric = reader.Bool(WireFormat::SHAPE_IS_PARAMETRIC, false);
+    g_shapeInfo.sizeLinkEnabled = reader.Bool(WireFormat::SHAPE_SIZE_LINK, false);
+
+    for (int i = 0; i < 3; i++) {
+        g_shapeInfo.fillColor[i] =
+            reader.Float(WireFormat::SHAPE_FILL_R + i, g_shapeInfo.fillColor[i]);
+        g_shapeInfo.strokeColor[i] =
+            reader.Float(WireFormat::SHAPE_STROKE_R + i, g_shapeInfo.strokeColor[i]);
+    }
+
+    g_shapeInfo.boundsLeft = reader.Float(WireFormat::SHAPE_BOUNDS_LEFT, 0);
+    g_shapeInfo.boundsTop = reader.Float(WireFormat::SHAPE_BOUNDS_TOP, 0);
+    g_shapeInfo.boundsWidth = reader.Float(WireFormat::SHAPE_BOUNDS_WIDTH, 0);
+    g_shapeInfo.boundsHeight = reader.Float(WireFormat::SHAPE_BOUNDS_HEIGHT, 0);
+
+    // Redraw if the window exists (NULL would invalidate the desktop)
+    if (g_hwnd) {
+        InvalidateRect(g_hwnd, NULL, FALSE);
+    }
 }
 
 bool NeedsRefresh() {
@@ -592,6 +559,7 @@ static std::wstring GetShapePresetFilePath() {
 }
 
 static void LoadShapePresets() {
+    TRACE_SCOPE("io", "ShapeUI::LoadShapePresets");
     g_shapePresets.clear();
 
     std::wstring filePath = GetShapePresetFilePath();
@@ -638,6 +606,7 @@ static void LoadShapePresets() {
 }
 
 static void SaveShapePresetsToFile() {
+    TRACE_SCOPE("io", "ShapeUI::SaveShapePresetsToFile");
     std::wstring filePath = GetShapePresetFilePath();
     if (filePath.empty()) return;
 
@@ -734,11 +703,10 @@ static void DeleteShapePreset(int index) {
 static void DrawPresetDropdown(Graphics& g) {
     if (!g_presetDropdownOpen) return;
 
-    FontFamily fontFamily(L"Segoe UI");
-    Font itemFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    Font smallFont(&fontFamily, 9, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush dimBrush(COLOR_TEXT_DIM);
+    const Font *itemFont = RenderContext::Font(10);
+    const Font *smallFont = RenderContext::Font(9);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
+    const SolidBrush *dimBrush = RenderContext::Brush(COLOR_TEXT_DIM);
 
     int dropdownWidth = 160;
     int dropdownX = g_presetRect.left - dropdownWidth + PIN_BUTTON_SIZE;
@@ -753,33 +721,33 @@ static void DrawPresetDropdown(Graphics& g) {
     g_presetDropdownRect = {dropdownX, dropdownY, dropdownX + dropdownWidth, dropdownY + dropdownHeight};
 
     // Background
-    SolidBrush bgBrush(COLOR_HEADER_BG);
-    g.FillRectangle(&bgBrush, dropdownX, dropdownY, dropdownWidth, dropdownHeight);
+    const SolidBrush *bgBrush = RenderContext::Brush(COLOR_HEADER_BG);
+    g.FillRectangle(bgBrush, dropdownX, dropdownY, dropdownWidth, dropdownHeight);
 
     // Border
-    Pen borderPen(COLOR_BORDER, 1);
-    g.DrawRectangle(&borderPen, dropdownX, dropdownY, dropdownWidth - 1, dropdownHeight - 1);
+    const Pen *borderPen = RenderContext::Pen(COLOR_BORDER, 1);
+    g.DrawRectangle(borderPen, dropdownX, dropdownY, dropdownWidth - 1, dropdownHeight - 1);
 
     int itemY = dropdownY + 2;
 
     // "Save Current" item
     bool saveHovered = (g_presetHoverIndex == -2);
     if (saveHovered) {
-        SolidBrush hoverBrush(COLOR_HOVER);
-        g.FillRectangle(&hoverBrush, dropdownX + 2, itemY, dropdownWidth - 4, PRESET_ITEM_HEIGHT);
+        const SolidBrush *hoverBrush = RenderContext::Brush(COLOR_HOVER);
+        g.FillRectangle(hoverBrush, dropdownX + 2, itemY, dropdownWidth - 4, PRESET_ITEM_HEIGHT);
     }
 
     if (g_presetSaveMode) {
         // Draw text input for preset name
-        SolidBrush inputBrush(COLOR_VALUE_EDIT);
-        g.FillRectangle(&inputBrush, dropdownX + 4, itemY + 2, dropdownWidth - 8, PRESET_ITEM_HEIGHT - 4);
+        const SolidBrush *inputBrush = RenderContext::Brush(COLOR_VALUE_EDIT);
+        g.FillRectangle(inputBrush, dropdownX + 4, itemY + 2, dropdownWidth - 8, PRESET_ITEM_HEIGHT - 4);
         std::wstring displayText = g_presetSaveName + L"_";
-        g.DrawString(displayText.c_str(), -1, &itemFont,
-                     PointF((float)dropdownX + 8, (float)itemY + 4), &textBrush);
+        g.DrawString(displayText.c_str(), -1, itemFont,
+                     PointF((float)dropdownX + 8, (float)itemY + 4), textBrush);
     } else {
-        g.DrawString(L"+ Save Current Style", -1, &itemFont,
+        g.DrawString(L"+ Save Current Style", -1, itemFont,
                      PointF((float)dropdownX + 8, (float)itemY + 4),
-                     saveHovered ? &textBrush : &dimBrush);
+                     saveHovered ? textBrush : dimBrush);
     }
     itemY += PRESET_ITEM_HEIGHT;
 
@@ -790,45 +758,45 @@ static void DrawPresetDropdown(Graphics& g) {
         bool hovered = (g_presetHoverIndex == i);
 
         if (hovered) {
-            SolidBrush hoverBrush(COLOR_HOVER);
-            g.FillRectangle(&hoverBrush, dropdownX + 2, itemY, dropdownWidth - 4, PRESET_ITEM_HEIGHT);
+            const SolidBrush *hoverBrush = RenderContext::Brush(COLOR_HOVER);
+            g.FillRectangle(hoverBrush, dropdownX + 2, itemY, dropdownWidth - 4, PRESET_ITEM_HEIGHT);
         }
 
         // Color preview (small squares for fill and stroke)
         int colorX = dropdownX + 8;
-        SolidBrush fillPreview(Color(255,
+        const SolidBrush *fillPreview = RenderContext::Brush(Color(255,
             (BYTE)(preset.fillColor[0] * 255),
             (BYTE)(preset.fillColor[1] * 255),
             (BYTE)(preset.fillColor[2] * 255)));
         if (preset.hasFill) {
-            g.FillRectangle(&fillPreview, colorX, itemY + 5, 12, 12);
+            g.FillRectangle(fillPreview, colorX, itemY + 5, 12, 12);
         }
 
-        SolidBrush strokePreview(Color(255,
+        const SolidBrush *strokePreview = RenderContext::Brush(Color(255,
             (BYTE)(preset.strokeColor[0] * 255),
             (BYTE)(preset.strokeColor[1] * 255),
             (BYTE)(preset.strokeColor[2] * 255)));
         if (preset.hasStroke) {
-            Pen strokePen(Color(255,
+            const Pen *strokePen = RenderContext::Pen(Color(255,
                 (BYTE)(preset.strokeColor[0] * 255),
                 (BYTE)(preset.strokeColor[1] * 255),
                 (BYTE)(preset.strokeColor[2] * 255)), 2.0f);
-            g.DrawRectangle(&strokePen, colorX + (preset.hasFill ? 14 : 0), itemY + 5, 12, 12);
+            g.DrawRectangle(strokePen, colorX + (preset.hasFill ? 14 : 0), itemY + 5, 12, 12);
         }
 
         // Preset name
         int textX = colorX + 32;
-        g.DrawString(preset.name.c_str(), -1, &itemFont,
-                     PointF((float)textX, (float)itemY + 4), &textBrush);
+        g.DrawString(preset.name.c_str(), -1, itemFont,
+                     PointF((float)textX, (float)itemY + 4), textBrush);
 
         // Delete button (X) on hover
         if (hovered) {
             int delX = dropdownX + dropdownWidth - 22;
-            SolidBrush delBrush(Color(180, 200, 80, 80));
-            g.FillRectangle(&delBrush, delX, itemY + 4, 16, 16);
-            Pen xPen(COLOR_TEXT, 1.5f);
-            g.DrawLine(&xPen, delX + 4, itemY + 8, delX + 12, itemY + 16);
-            g.DrawLine(&xPen, delX + 12, itemY + 8, delX + 4, itemY + 16);
+            const SolidBrush *delBrush = RenderContext::Brush(Color(180, 200, 80, 80));
+            g.FillRectangle(delBrush, delX, itemY + 4, 16, 16);
+            const Pen *xPen = RenderContext::Pen(COLOR_TEXT, 1.5f);
+            g.DrawLine(xPen, delX + 4, itemY + 8, delX + 12, itemY + 16);
+            g.DrawLine(xPen, delX + 12, itemY + 8, delX + 4, itemY + 16);
         }
 
         itemY += PRESET_ITEM_HEIGHT;
@@ -855,26 +823,25 @@ static void Draw(HDC hdc) {
     int logicalHeight = InverseScaled(height);
 
     // Background
-    SolidBrush bgBrush(COLOR_BG);
-    graphics.FillRectangle(&bgBrush, 0, 0, logicalWidth, logicalHeight);
+    const SolidBrush *bgBrush = RenderContext::Brush(COLOR_BG);
+    graphics.FillRectangle(bgBrush, 0, 0, logicalWidth, logicalHeight);
 
     // Header
-    SolidBrush headerBrush(COLOR_HEADER_BG);
-    graphics.FillRectangle(&headerBrush, 0, 0, logicalWidth, HEADER_HEIGHT);
+    const SolidBrush *headerBrush = RenderContext::Brush(COLOR_HEADER_BG);
+    graphics.FillRectangle(headerBrush, 0, 0, logicalWidth, HEADER_HEIGHT);
 
     // Title
-    FontFamily fontFamily(L"Segoe UI");
-    Font titleFont(&fontFamily, 10, FontStyleBold, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
+    const Font *titleFont = RenderContext::Font(10, FontStyleBold);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
 
     // Layer/Shape name
     std::wstring title = L"Shape";
     if (g_shapeInfo.shapeName[0] != L'\0') {
         title = g_shapeInfo.shapeName;
     }
-    graphics.DrawString(title.c_str(), -1, &titleFont,
+    graphics.DrawString(title.c_str(), -1, titleFont,
                         PointF((float)PADDING, (float)(HEADER_HEIGHT - 18) / 2 + 2),
-                        &textBrush);
+                        textBrush);
 
     // Preset button (opens dropdown)
     int presetX = logicalWidth - PADDING - PIN_BUTTON_SIZE * 2 - 6;
@@ -884,31 +851,31 @@ static void Draw(HDC hdc) {
     // Show different color based on state
     Color presetColor = g_presetDropdownOpen ? COLOR_ACCENT :
                         (g_presetHover ? COLOR_HOVER : COLOR_SECTION_BG);
-    SolidBrush presetBrush(presetColor);
-    graphics.FillRectangle(&presetBrush, presetX, presetY, PIN_BUTTON_SIZE, PIN_BUTTON_SIZE);
+    const SolidBrush *presetBrush = RenderContext::Brush(presetColor);
+    graphics.FillRectangle(presetBrush, presetX, presetY, PIN_BUTTON_SIZE, PIN_BUTTON_SIZE);
 
     // Preset icon (grid/layers icon)
-    Pen presetPen(g_presetDropdownOpen ? Color(255, 40, 40, 40) : COLOR_TEXT_DIM, 1.0f);
+    const Pen *presetPen = RenderContext::Pen(g_presetDropdownOpen ? Color(255, 40, 40, 40) : COLOR_TEXT_DIM, 1.0f);
     int ppx = presetX + PIN_BUTTON_SIZE / 2;
     int ppy = presetY + PIN_BUTTON_SIZE / 2;
-    graphics.DrawRectangle(&presetPen, ppx - 5, ppy - 4, 10, 3);
-    graphics.DrawRectangle(&presetPen, ppx - 5, ppy, 10, 3);
+    graphics.DrawRectangle(presetPen, ppx - 5, ppy - 4, 10, 3);
+    graphics.DrawRectangle(presetPen, ppx - 5, ppy, 10, 3);
 
     // Pin button
     int pinX = logicalWidth - PADDING - PIN_BUTTON_SIZE;
     int pinY = (HEADER_HEIGHT - PIN_BUTTON_SIZE) / 2;
     g_pinRect = {pinX, pinY, pinX + PIN_BUTTON_SIZE, pinY + PIN_BUTTON_SIZE};
 
-    SolidBrush pinBrush(g_keepPanelOpen ? COLOR_PIN_ACTIVE :
+    const SolidBrush *pinBrush = RenderContext::Brush(g_keepPanelOpen ? COLOR_PIN_ACTIVE :
                         (g_pinHover ? COLOR_HOVER : COLOR_SECTION_BG));
-    graphics.FillEllipse(&pinBrush, (REAL)pinX, (REAL)pinY, (REAL)PIN_BUTTON_SIZE, (REAL)PIN_BUTTON_SIZE);
+    graphics.FillEllipse(pinBrush, (REAL)pinX, (REAL)pinY, (REAL)PIN_BUTTON_SIZE, (REAL)PIN_BUTTON_SIZE);
 
     // Pin icon
-    Pen pinPen(g_keepPanelOpen ? Color(255, 40, 40, 40) : COLOR_TEXT_DIM, 1.5f);
+    const Pen *pinPen = RenderContext::Pen(g_keepPanelOpen ? Color(255, 40, 40, 40) : COLOR_TEXT_DIM, 1.5f);
     float pcx = pinX + PIN_BUTTON_SIZE / 2.0f;
     float pcy = pinY + PIN_BUTTON_SIZE / 2.0f;
-    graphics.DrawEllipse(&pinPen, pcx - 3.0f, pcy - 4.0f, 6.0f, 6.0f);
-    graphics.DrawLine(&pinPen, pcx, pcy + 2, pcx, pcy + 6);
+    graphics.DrawEllipse(pinPen, pcx - 3.0f, pcy - 4.0f, 6.0f, 6.0f);
+    graphics.DrawLine(pinPen, pcx, pcy + 2, pcx, pcy + 6);
 
     // Draw sections
     int y = HEADER_HEIGHT + PADDING;
@@ -917,8 +884,8 @@ static void Draw(HDC hdc) {
     }
 
     // Border
-    Pen borderPen(COLOR_BORDER, 1);
-    graphics.DrawRectangle(&borderPen, 0, 0, logicalWidth - 1, logicalHeight - 1);
+    const Pen *borderPen = RenderContext::Pen(COLOR_BORDER, 1);
+    graphics.DrawRectangle(borderPen, 0, 0, logicalWidth - 1, logicalHeight - 1);
 
     // Draw preset dropdown on top
     DrawPresetDropdown(graphics);
@@ -932,20 +899,19 @@ static void DrawSection(Graphics& g, Section section, int& y) {
     // Section header
     const wchar_t* sectionNames[] = {L"Appearance", L"Transform", L"Path Operations"};
 
-    SolidBrush headerBrush(hovered ? COLOR_HOVER : COLOR_SECTION_HEADER);
-    g.FillRectangle(&headerBrush, PADDING, y, contentWidth, SECTION_HEADER_HEIGHT);
+    const SolidBrush *headerBrush = RenderContext::Brush(hovered ? COLOR_HOVER : COLOR_SECTION_HEADER);
+    g.FillRectangle(headerBrush, PADDING, y, contentWidth, SECTION_HEADER_HEIGHT);
 
     // Arrow
-    FontFamily fontFamily(L"Segoe UI");
-    Font arrowFont(&fontFamily, 10, FontStyleBold, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    g.DrawString(expanded ? L"\x25BC" : L"\x25B6", -1, &arrowFont,
-                 PointF((float)PADDING + 6, (float)y + 5), &textBrush);
+    const Font *arrowFont = RenderContext::Font(10, FontStyleBold);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
+    g.DrawString(expanded ? L"\x25BC" : L"\x25B6", -1, arrowFont,
+                 PointF((float)PADDING + 6, (float)y + 5), textBrush);
 
     // Section name
-    Font sectionFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    g.DrawString(sectionNames[section], -1, &sectionFont,
-                 PointF((float)PADDING + 22, (float)y + 5), &textBrush);
+    const Font *sectionFont = RenderContext::Font(10);
+    g.DrawString(sectionNames[section], -1, sectionFont,
+                 PointF((float)PADDING + 22, (float)y + 5), textBrush);
 
     g_sectionHeaderRects[section] = {
         PADDING, y, PADDING + contentWidth, y + SECTION_HEADER_HEIGHT
@@ -972,154 +938,150 @@ static void DrawSection(Graphics& g, Section section, int& y) {
 }
 
 static void DrawAppearanceSection(Graphics& g, int y) {
-    FontFamily fontFamily(L"Segoe UI");
-    Font labelFont(&fontFamily, 9, FontStyleRegular, UnitPixel);
-    Font valueFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush dimBrush(COLOR_TEXT_DIM);
+    const Font *labelFont = RenderContext::Font(9);
+    const Font *valueFont = RenderContext::Font(10);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
+    const SolidBrush *dimBrush = RenderContext::Brush(COLOR_TEXT_DIM);
 
     int rowY = y;
     int labelX = PADDING + 4;
     int valueX = PADDING + LABEL_WIDTH;
 
     // Row 1: Fill
-    g.DrawString(L"Fill", -1, &labelFont, PointF((float)labelX, (float)rowY + 4), &dimBrush);
+    g.DrawString(L"Fill", -1, labelFont, PointF((float)labelX, (float)rowY + 4), dimBrush);
 
     // Fill color box
     int colorX = valueX;
-    SolidBrush fillBrush(Color(255,
+    const SolidBrush *fillBrush = RenderContext::Brush(Color(255,
         (BYTE)(g_shapeInfo.fillColor[0] * 255),
         (BYTE)(g_shapeInfo.fillColor[1] * 255),
         (BYTE)(g_shapeInfo.fillColor[2] * 255)));
-    g.FillRectangle(&fillBrush, colorX, rowY, COLOR_BOX_SIZE, COLOR_BOX_SIZE);
+    g.FillRectangle(fillBrush, colorX, rowY, COLOR_BOX_SIZE, COLOR_BOX_SIZE);
     if (g_fillColorHover) {
-        Pen hoverPen(COLOR_ACCENT, 2);
-        g.DrawRectangle(&hoverPen, colorX, rowY, COLOR_BOX_SIZE, COLOR_BOX_SIZE);
+        const Pen *hoverPen = RenderContext::Pen(COLOR_ACCENT, 2);
+        g.DrawRectangle(hoverPen, colorX, rowY, COLOR_BOX_SIZE, COLOR_BOX_SIZE);
     }
     g_fillColorRect = {colorX, rowY, colorX + COLOR_BOX_SIZE, rowY + COLOR_BOX_SIZE};
 
     // Fill toggle
     int toggleX = colorX + COLOR_BOX_SIZE + 8;
-    SolidBrush toggleBrush(g_shapeInfo.hasFill ? COLOR_TOGGLE_ON : COLOR_TOGGLE_OFF);
-    g.FillEllipse(&toggleBrush, toggleX, rowY + 2, TOGGLE_SIZE, TOGGLE_SIZE);
+    const SolidBrush *toggleBrush = RenderContext::Brush(g_shapeInfo.hasFill ? COLOR_TOGGLE_ON : COLOR_TOGGLE_OFF);
+    g.FillEllipse(toggleBrush, toggleX, rowY + 2, TOGGLE_SIZE, TOGGLE_SIZE);
     g_fillToggleRect = {toggleX, rowY + 2, toggleX + TOGGLE_SIZE, rowY + 2 + TOGGLE_SIZE};
 
     rowY += ROW_HEIGHT + ROW_SPACING;
 
     // Row 2: Stroke
-    g.DrawString(L"Stroke", -1, &labelFont, PointF((float)labelX, (float)rowY + 4), &dimBrush);
+    g.DrawString(L"Stroke", -1, labelFont, PointF((float)labelX, (float)rowY + 4), dimBrush);
 
     // Stroke color box
-    SolidBrush strokeBrush(Color(255,
+    const SolidBrush *strokeBrush = RenderContext::Brush(Color(255,
         (BYTE)(g_shapeInfo.strokeColor[0] * 255),
         (BYTE)(g_shapeInfo.strokeColor[1] * 255),
         (BYTE)(g_shapeInfo.strokeColor[2] * 255)));
-    g.FillRectangle(&strokeBrush, colorX, rowY, COLOR_BOX_SIZE, COLOR_BOX_SIZE);
+    g.FillRectangle(strokeBrush, colorX, rowY, COLOR_BOX_SIZE, COLOR_BOX_SIZE);
     if (g_strokeColorHover) {
-        Pen hoverPen(COLOR_ACCENT, 2);
-        g.DrawRectangle(&hoverPen, colorX, rowY, COLOR_BOX_SIZE, COLOR_BOX_SIZE);
+        const Pen *hoverPen = RenderContext::Pen(COLOR_ACCENT, 2);
+        g.DrawRectangle(hoverPen, colorX, rowY, COLOR_BOX_SIZE, COLOR_BOX_SIZE);
     }
     g_strokeColorRect = {colorX, rowY, colorX + COLOR_BOX_SIZE, rowY + COLOR_BOX_SIZE};
 
     // Stroke toggle
-    SolidBrush strokeToggleBrush(g_shapeInfo.hasStroke ? COLOR_TOGGLE_ON : COLOR_TOGGLE_OFF);
-    g.FillEllipse(&strokeToggleBrush, toggleX, rowY + 2, TOGGLE_SIZE, TOGGLE_SIZE);
+    const SolidBrush *strokeToggleBrush = RenderContext::Brush(g_shapeInfo.hasStroke ? COLOR_TOGGLE_ON : COLOR_TOGGLE_OFF);
+    g.FillEllipse(strokeToggleBrush, toggleX, rowY + 2, TOGGLE_SIZE, TOGGLE_SIZE);
     g_strokeToggleRect = {toggleX, rowY + 2, toggleX + TOGGLE_SIZE, rowY + 2 + TOGGLE_SIZE};
 
     // Stroke width
     int widthX = toggleX + TOGGLE_SIZE + 16;
     wchar_t widthStr[32];
     swprintf(widthStr, 32, L"%.1f px", g_shapeInfo.strokeWidth);
-    SolidBrush valueBgBrush(g_hoverTarget == TARGET_STROKE_WIDTH ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
-    g.FillRectangle(&valueBgBrush, widthX, rowY, VALUE_BOX_WIDTH, VALUE_BOX_HEIGHT);
-    g.DrawString(widthStr, -1, &valueFont, PointF((float)widthX + 6, (float)rowY + 4), &textBrush);
+    const SolidBrush *valueBgBrush = RenderContext::Brush(g_hoverTarget == TARGET_STROKE_WIDTH ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
+    g.FillRectangle(valueBgBrush, widthX, rowY, VALUE_BOX_WIDTH, VALUE_BOX_HEIGHT);
+    g.DrawString(widthStr, -1, valueFont, PointF((float)widthX + 6, (float)rowY + 4), textBrush);
     g_strokeWidthRect = {widthX, rowY, widthX + VALUE_BOX_WIDTH, rowY + VALUE_BOX_HEIGHT};
 
     rowY += ROW_HEIGHT + ROW_SPACING;
 
     // Row 3: Opacity
-    g.DrawString(L"Opacity", -1, &labelFont, PointF((float)labelX, (float)rowY + 4), &dimBrush);
+    g.DrawString(L"Opacity", -1, labelFont, PointF((float)labelX, (float)rowY + 4), dimBrush);
 
     wchar_t opacityStr[32];
     swprintf(opacityStr, 32, L"%.0f%%", g_shapeInfo.opacity);
-    SolidBrush opacityBgBrush(g_hoverTarget == TARGET_OPACITY ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
-    g.FillRectangle(&opacityBgBrush, valueX, rowY, VALUE_BOX_WIDTH, VALUE_BOX_HEIGHT);
-    g.DrawString(opacityStr, -1, &valueFont, PointF((float)valueX + 6, (float)rowY + 4), &textBrush);
+    const SolidBrush *opacityBgBrush = RenderContext::Brush(g_hoverTarget == TARGET_OPACITY ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
+    g.FillRectangle(opacityBgBrush, valueX, rowY, VALUE_BOX_WIDTH, VALUE_BOX_HEIGHT);
+    g.DrawString(opacityStr, -1, valueFont, PointF((float)valueX + 6, (float)rowY + 4), textBrush);
     g_opacityRect = {valueX, rowY, valueX + VALUE_BOX_WIDTH, rowY + VALUE_BOX_HEIGHT};
 }
 
 static void DrawTransformSection(Graphics& g, int y) {
     if (!g_shapeInfo.isParametric) {
         // Non-parametric shape (Path) - show message
-        FontFamily fontFamily(L"Segoe UI");
-        Font msgFont(&fontFamily, 9, FontStyleItalic, UnitPixel);
-        SolidBrush dimBrush(COLOR_TEXT_DIM);
-        g.DrawString(L"Path shape - Size N/A", -1, &msgFont,
-                     PointF((float)PADDING + 4, (float)y + 4), &dimBrush);
+        const Font *msgFont = RenderContext::Font(9, FontStyleItalic);
+        const SolidBrush *dimBrush = RenderContext::Brush(COLOR_TEXT_DIM);
+        g.DrawString(L"Path shape - Size N/A", -1, msgFont,
+                     PointF((float)PADDING + 4, (float)y + 4), dimBrush);
         return;
     }
 
-    FontFamily fontFamily(L"Segoe UI");
-    Font labelFont(&fontFamily, 9, FontStyleRegular, UnitPixel);
-    Font valueFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush dimBrush(COLOR_TEXT_DIM);
+    const Font *labelFont = RenderContext::Font(9);
+    const Font *valueFont = RenderContext::Font(10);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
+    const SolidBrush *dimBrush = RenderContext::Brush(COLOR_TEXT_DIM);
 
     int rowY = y;
     int labelX = PADDING + 4;
     int valueX = PADDING + LABEL_WIDTH;
 
     // Row 1: Size W / H
-    g.DrawString(L"Size", -1, &labelFont, PointF((float)labelX, (float)rowY + 4), &dimBrush);
+    g.DrawString(L"Size", -1, labelFont, PointF((float)labelX, (float)rowY + 4), dimBrush);
 
     // Width
     wchar_t wStr[32];
     swprintf(wStr, 32, L"W: %.0f", g_shapeInfo.sizeW);
-    SolidBrush wBgBrush(g_hoverTarget == TARGET_SIZE_W ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
-    g.FillRectangle(&wBgBrush, valueX, rowY, 60, VALUE_BOX_HEIGHT);
-    g.DrawString(wStr, -1, &valueFont, PointF((float)valueX + 4, (float)rowY + 4), &textBrush);
+    const SolidBrush *wBgBrush = RenderContext::Brush(g_hoverTarget == TARGET_SIZE_W ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
+    g.FillRectangle(wBgBrush, valueX, rowY, 60, VALUE_BOX_HEIGHT);
+    g.DrawString(wStr, -1, valueFont, PointF((float)valueX + 4, (float)rowY + 4), textBrush);
     g_sizeWRect = {valueX, rowY, valueX + 60, rowY + VALUE_BOX_HEIGHT};
 
     // Link button
     int linkX = valueX + 64;
-    SolidBrush linkBrush(g_shapeInfo.sizeLinkEnabled ? COLOR_ACCENT : COLOR_VALUE_BG);
-    g.FillRectangle(&linkBrush, linkX, rowY + 2, 18, 18);
-    g.DrawString(L"=", -1, &labelFont, PointF((float)linkX + 4, (float)rowY + 3), &textBrush);
+    const SolidBrush *linkBrush = RenderContext::Brush(g_shapeInfo.sizeLinkEnabled ? COLOR_ACCENT : COLOR_VALUE_BG);
+    g.FillRectangle(linkBrush, linkX, rowY + 2, 18, 18);
+    g.DrawString(L"=", -1, labelFont, PointF((float)linkX + 4, (float)rowY + 3), textBrush);
     g_sizeLinkRect = {linkX, rowY + 2, linkX + 18, rowY + 20};
 
     // Height
     int hX = linkX + 24;
     wchar_t hStr[32];
     swprintf(hStr, 32, L"H: %.0f", g_shapeInfo.sizeH);
-    SolidBrush hBgBrush(g_hoverTarget == TARGET_SIZE_H ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
-    g.FillRectangle(&hBgBrush, hX, rowY, 60, VALUE_BOX_HEIGHT);
-    g.DrawString(hStr, -1, &valueFont, PointF((float)hX + 4, (float)rowY + 4), &textBrush);
+    const SolidBrush *hBgBrush = RenderContext::Brush(g_hoverTarget == TARGET_SIZE_H ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
+    g.FillRectangle(hBgBrush, hX, rowY, 60, VALUE_BOX_HEIGHT);
+    g.DrawString(hStr, -1, valueFont, PointF((float)hX + 4, (float)rowY + 4), textBrush);
     g_sizeHRect = {hX, rowY, hX + 60, rowY + VALUE_BOX_HEIGHT};
 
     rowY += ROW_HEIGHT + ROW_SPACING;
 
     // Row 2: Roundness
-    g.DrawString(L"Round", -1, &labelFont, PointF((float)labelX, (float)rowY + 4), &dimBrush);
+    g.DrawString(L"Round", -1, labelFont, PointF((float)labelX, (float)rowY + 4), dimBrush);
 
     wchar_t roundStr[32];
     swprintf(roundStr, 32, L"%.1f", g_shapeInfo.roundness);
-    SolidBrush roundBgBrush(g_hoverTarget == TARGET_ROUNDNESS ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
-    g.FillRectangle(&roundBgBrush, valueX, rowY, VALUE_BOX_WIDTH, VALUE_BOX_HEIGHT);
-    g.DrawString(roundStr, -1, &valueFont, PointF((float)valueX + 6, (float)rowY + 4), &textBrush);
+    const SolidBrush *roundBgBrush = RenderContext::Brush(g_hoverTarget == TARGET_ROUNDNESS ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
+    g.FillRectangle(roundBgBrush, valueX, rowY, VALUE_BOX_WIDTH, VALUE_BOX_HEIGHT);
+    g.DrawString(roundStr, -1, valueFont, PointF((float)valueX + 6, (float)rowY + 4), textBrush);
     g_roundnessRect = {valueX, rowY, valueX + VALUE_BOX_WIDTH, rowY + VALUE_BOX_HEIGHT};
 
     rowY += ROW_HEIGHT + ROW_SPACING;
 
     // Row 3: Anchor hint
-    g.DrawString(L"Anchor", -1, &labelFont, PointF((float)labelX, (float)rowY + 4), &dimBrush);
-    g.DrawString(L"Press Y for grid", -1, &labelFont,
-                 PointF((float)valueX, (float)rowY + 4), &dimBrush);
+    g.DrawString(L"Anchor", -1, labelFont, PointF((float)labelX, (float)rowY + 4), dimBrush);
+    g.DrawString(L"Press Y for grid", -1, labelFont,
+                 PointF((float)valueX, (float)rowY + 4), dimBrush);
 }
 
 static void DrawPathOpsSection(Graphics& g, int y) {
-    FontFamily fontFamily(L"Segoe UI");
-    Font btnFont(&fontFamily, 9, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
+    const Font *btnFont = RenderContext::Font(9);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
 
     int btnWidth = 80;
     int btnHeight = 22;
@@ -1133,16 +1095,16 @@ static void DrawPathOpsSection(Graphics& g, int y) {
         int by = y + row * (btnHeight + btnGap);
 
         bool hovered = (g_hoverPathOp == i);
-        SolidBrush btnBrush(hovered ? COLOR_HOVER : COLOR_VALUE_BG);
-        g.FillRectangle(&btnBrush, bx, by, btnWidth, btnHeight);
+        const SolidBrush *btnBrush = RenderContext::Brush(hovered ? COLOR_HOVER : COLOR_VALUE_BG);
+        g.FillRectangle(btnBrush, bx, by, btnWidth, btnHeight);
 
         // Truncate long names
         std::wstring name = PATH_OP_NAMES[i];
         if (name.length() > 10) {
             name = name.substr(0, 9) + L"...";
         }
-        g.DrawString(name.c_str(), -1, &btnFont,
-                     PointF((float)bx + 4, (float)by + 4), &textBrush);
+        g.DrawString(name.c_str(), -1, btnFont,
+                     PointF((float)bx + 4, (float)by + 4), textBrush);
 
         g_pathOpRects[i] = {bx, by, bx + btnWidth, by + btnHeight};
     }
@@ -1155,23 +1117,19 @@ static void DrawPathOpsSection(Graphics& g, int y) {
 static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
     case WM_PAINT: {
+        TRACE_SCOPE("paint", "ShapeUI::Draw");
+        PROFILE_SCOPE("paint.shape");
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
 
         // Double buffering
         RECT rect;
         GetClientRect(hwnd, &rect);
-        HDC memDC = CreateCompatibleDC(hdc);
-        HBITMAP memBitmap = CreateCompatibleBitmap(hdc, rect.right, rect.bottom);
-        HGDIOBJ oldBitmap = SelectObject(memDC, memBitmap);
+        HDC memDC = g_backbuffer.Begin(hdc, rect.right, rect.bottom);
 
         Draw(memDC);
 
-        BitBlt(hdc, 0, 0, rect.right, rect.bottom, memDC, 0, 0, SRCCOPY);
-
-        SelectObject(memDC, oldBitmap);
-        DeleteObject(memBitmap);
-        DeleteDC(memDC);
+        g_backbuffer.Present(hdc, rect.right, rect.bottom);
 
         EndPaint(hwnd, &ps);
         return 0;
@@ -1646,6 +1604,8 @@ static LRESULT CALLBACK ColorPickerWndProc(HWND hwnd, UINT msg, WPARAM wParam, L
 static LRESULT CALLBACK AnchorGridWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
     case WM_PAINT: {
+        TRACE_SCOPE("paint", "ShapeUI::AnchorGrid");
+        PROFILE_SCOPE("paint.shape.anchorGrid");
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
 
@@ -1653,16 +1613,14 @@ static LRESULT CALLBACK AnchorGridWndProc(HWND hwnd, UINT msg, WPARAM wParam, LP
         GetClientRect(hwnd, &rect);
 
         // Double buffering
-        HDC memDC = CreateCompatibleDC(hdc);
-        HBITMAP memBitmap = CreateCompatibleBitmap(hdc, rect.right, rect.bottom);
-        HGDIOBJ oldBitmap = SelectObject(memDC, memBitmap);
+        HDC memDC = g_anchorGridBackbuffer.Begin(hdc, rect.right, rect.bottom);
 
         Graphics graphics(memDC);
         graphics.SetSmoothingMode(SmoothingModeAntiAlias);
 
         // Background
-        SolidBrush bgBrush(COLOR_BG);
-        graphics.FillRectangle(&bgBrush, 0, 0, rect.right, rect.bottom);
+        const SolidBrush *bgBrush = RenderContext::Brush(COLOR_BG);
+        graphics.FillRectangle(bgBrush, 0, 0, rect.right, rect.bottom);
 
         // Draw 3x3 grid
         int cellSize = rect.right / 3;
@@ -1673,26 +1631,22 @@ static LRESULT CALLBACK AnchorGridWndProc(HWND hwnd, UINT msg, WPARAM wParam, LP
                 int cy = row * cellSize;
 
                 bool hovered = (g_anchorHoverIndex == idx);
-                SolidBrush cellBrush(hovered ? COLOR_HOVER : COLOR_SECTION_BG);
-                graphics.FillRectangle(&cellBrush, cx + 2, cy + 2, cellSize - 4, cellSize - 4);
+                const SolidBrush *cellBrush = RenderContext::Brush(hovered ? COLOR_HOVER : COLOR_SECTION_BG);
+                graphics.FillRectangle(cellBrush, cx + 2, cy + 2, cellSize - 4, cellSize - 4);
 
                 // Dot
                 float dotX = cx + cellSize / 2.0f;
                 float dotY = cy + cellSize / 2.0f;
-                SolidBrush dotBrush(hovered ? COLOR_ACCENT : COLOR_TEXT_DIM);
-                graphics.FillEllipse(&dotBrush, dotX - 4.0f, dotY - 4.0f, 8.0f, 8.0f);
+                const SolidBrush *dotBrush = RenderContext::Brush(hovered ? COLOR_ACCENT : COLOR_TEXT_DIM);
+                graphics.FillEllipse(dotBrush, dotX - 4.0f, dotY - 4.0f, 8.0f, 8.0f);
             }
         }
 
         // Border
-        Pen borderPen(COLOR_BORDER, 1);
-        graphics.DrawRectangle(&borderPen, 0, 0, rect.right - 1, rect.bottom - 1);
-
-        BitBlt(hdc, 0, 0, rect.right, rect.bottom, memDC, 0, 0, SRCCOPY);
+        const Pen *borderPen = RenderContext::Pen(COLOR_BORDER, 1);
+        graphics.DrawRectangle(borderPen, 0, 0, rect.right - 1, rect.bottom - 1);
 
-        SelectObject(memDC, oldBitmap);
-        DeleteObject(memBitmap);
-        DeleteDC(memDC);
+        g_anchorGridBackbuffer.Present(hdc, rect.right, rect.bottom);
 
         EndPaint(hwnd, &ps);
         return 0;
@@ -1756,14 +1710,14 @@ static LRESULT CALLBACK AnchorGridWndProc(HWND hwnd, UINT msg, WPARAM wParam, LP
 #else
 // Stub implementations for non-Windows platforms
 namespace ShapeUI {
-void Initialize() {}
+bool Initialize() { return true; }
 void Shutdown() {}
 void ShowPanel(int x, int y) { (void)x; (void)y; }
 ShapeResult HidePanel() { return {}; }
 bool IsVisible() { return false; }
 void UpdateHover(int mouseX, int mouseY) { (void)mouseX; (void)mouseY; }
 ShapeResult GetResult() { return {}; }
-void SetShapeInfo(const wchar_t* jsonInfo) { (void)jsonInfo; }
+void SetShapeInfo(std::string_view info) { (void)info; }
 bool NeedsRefresh() { return false; }
 void ShowColorPicker(bool forStroke, int x, int y) { (void)forStroke; (void)x; (void)y; }
 void HideColorPicker() {}
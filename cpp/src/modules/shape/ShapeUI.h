@@ -18,6 +18,8 @@
 #ifndef SHAPEUI_H
 #define SHAPEUI_H
 
+#include <string_view>
+
 namespace ShapeUI {
 
 // UI Sections (accordion)
@@ -102,7 +104,8 @@ struct ColorPreset {
 };
 
 // Initialize the Shape UI system
-void Initialize();
+// @return false if GDI+ or the window (class) could not be created
+bool Initialize();
 
 // Cleanup
 void Shutdown();
@@ -122,8 +125,8 @@ void UpdateHover(int mouseX, int mouseY);
 // Get the result after panel closes
 ShapeResult GetResult();
 
-// Set current shape info from ExtendScript JSON
-void SetShapeInfo(const wchar_t* jsonInfo);
+// Set current shape info from the shapeInfo() wire record (WireFormat::ShapeField)
+void SetShapeInfo(std::string_view info);
 
 // Refresh request - returns true if refresh is needed, then clears the flag
 bool NeedsRefresh();
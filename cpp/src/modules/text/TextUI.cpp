@@ -7,6 +7,11 @@
 
 #include "TextUI.h"
 #include "GdiPlusIncludes.h"
+#include "CatalogCache.h"
+#include "WireFormat.h"
+#include "Profiler.h"
+#include "RenderContext.h"
+#include "Tracer.h"
 
 #ifdef MSWindows
 #include <windowsx.h>  // GET_X_LPARAM, GET_Y_LPARAM
@@ -23,7 +28,7 @@ extern float GetModuleScaleFactor(const char* moduleName);
 extern void ApplyTextPropertyValue(const char* propName, float value);
 extern void ApplyTextColorValue(bool stroke, float r, float g, float b);
 extern void ApplyTextJustificationValue(int just);
-extern void GetFontsList(wchar_t* outBuffer, size_t bufSize);
+extern bool LoadFontCatalog();
 extern void ApplyTextFont(const char* postScriptName);
 
 #include <vector>
@@ -111,7 +116,9 @@ static HWND g_hwnd = NULL;
 static HWND g_colorPickerHwnd = NULL;
 static bool g_visible = false;
 static bool g_needsRefresh = false;  // Request to refresh text info from selection
-static ULONG_PTR g_gdiplusToken = 0;
+static bool g_renderAcquired = false;
+static RenderContext::Backbuffer g_backbuffer;
+static RenderContext::Backbuffer g_colorPickerBackbuffer;
 static TextInfo g_textInfo = {};
 static TextInfo g_copiedStyle = {};    // Copied style for Ctrl+C/V
 static bool g_hasStyleCopied = false;  // True if a style has been copied
@@ -173,6 +180,7 @@ struct FontInfo {
     std::wstring styleName;
     std::wstring postScriptName;
     std::wstring displayName;  // "familyName styleName"
+    std::wstring displayLower; // Search key (lowercased once at load)
 };
 static std::vector<FontInfo> g_allFonts;
 static std::vector<FontInfo*> g_filteredFonts;
@@ -253,16 +261,15 @@ static void SavePresetsToFile();
 /*****************************************************************************
  * Initialize
  *****************************************************************************/
-void Initialize() {
-    if (g_hwnd) return;
+bool Initialize() {
+    if (g_hwnd) return true;
 
-    // Initialize GDI+
-    GdiplusStartupInput gdiplusStartupInput;
-    Status gdipStatus = GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, NULL);
-    if (gdipStatus != Ok) {
+    // Join the shared GDI+ session
+    if (!RenderContext::Acquire()) {
         // GDI+ initialization failed - cannot proceed
-        return;
+        return false;
     }
+    g_renderAcquired = true;
 
     // Register main window class (explicitly use Wide version for Unicode strings)
     WNDCLASSEXW wc = {0};
@@ -276,9 +283,9 @@ void Initialize() {
     ATOM classAtom = RegisterClassExW(&wc);
     if (classAtom == 0 && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
         // Registration failed and class doesn't exist
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
-        return;
+        RenderContext::Release();
+        g_renderAcquired = false;
+        return false;
     }
 
     // Create main window (initially hidden) - NO WS_EX_NOACTIVATE, we need focus
@@ -293,9 +300,9 @@ void Initialize() {
 
     if (!g_hwnd) {
         // Window creation failed
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
-        return;
+        RenderContext::Release();
+        g_renderAcquired = false;
+        return false;
     }
 
     SetLayeredWindowAttributes(g_hwnd, 0, 255, LWA_ALPHA);
@@ -313,6 +320,7 @@ void Initialize() {
 
     // Load saved presets
     LoadPresets();
+    return true;
 }
 
 /*****************************************************************************
@@ -327,9 +335,11 @@ void Shutdown() {
         DestroyWindow(g_hwnd);
         g_hwnd = NULL;
     }
-    if (g_gdiplusToken) {
-        GdiplusShutdown(g_gdiplusToken);
-        g_gdiplusToken = 0;
+    g_backbuffer.Release();
+    g_colorPickerBackbuffer.Release();
+    if (g_renderAcquired) {
+        RenderContext::Release();
+        g_renderAcquired = false;
     }
 }
 
@@ -515,85 +525,59 @@ void UpdateHover(int mouseX, int mouseY) {
 TextResult GetResult() { return g_result; }
 
 /*****************************************************************************
- * SetTextInfo - Parse JSON from ExtendScript
+ * SetTextInfo - Read the textInfo() wire record
  *****************************************************************************/
-void SetTextInfo(const wchar_t* jsonInfo) {
-    if (!jsonInfo || jsonInfo[0] == L'\0') return;
-
-    // Simple JSON parsing (assuming well-formed)
-    std::wstring json(jsonInfo);
-
-    auto getFloat = [&json](const wchar_t* key) -> float {
-        std::wstring search = std::wstring(L"\"") + key + L"\":";
-        size_t pos = json.find(search);
-        if (pos == std::wstring::npos) return 0;
-        pos += search.length();
-        return (float)_wtof(json.c_str() + pos);
-    };
-
-    auto getBool = [&json](const wchar_t* key) -> bool {
-        std::wstring search = std::wstring(L"\"") + key + L"\":";
-        size_t pos = json.find(search);
-        if (pos == std::wstring::npos) return false;
-        pos += search.length();
-        while (json[pos] == L' ') pos++;
-        return json[pos] == L't';
-    };
-
-    auto getString = [&json](const wchar_t* key, wchar_t* out, int maxLen) {
-        std::wstring search = std::wstring(L"\"") + key + L"\":\"";
-        size_t pos = json.find(search);
-        if (pos == std::wstring::npos) { out[0] = L'\0'; return; }
-        pos += search.length();
-        size_t end = json.find(L'"', pos);
-        if (end == std::wstring::npos) { out[0] = L'\0'; return; }
-        int len = (int)(end - pos);
-        if (len >= maxLen) len = maxLen - 1;
-        wcsncpy(out, json.c_str() + pos, len);
-        out[len] = L'\0';
-    };
-
-    getString(L"font", g_textInfo.font, 128);
-    getString(L"layerName", g_textInfo.layerName, 256);
-    g_textInfo.fontSize = getFloat(L"fontSize");
-    g_textInfo.tracking = getFloat(L"tracking");
-    g_textInfo.leading = getFloat(L"leading");
-    g_textInfo.strokeWidth = getFloat(L"strokeWidth");
-    g_textInfo.applyFill = getBool(L"applyFill");
-    g_textInfo.applyStroke = getBool(L"applyStroke");
-    g_textInfo.justify = (Justification)(int)getFloat(L"justify");
-
-    // Parse color arrays [r,g,b]
-    auto getColorArray = [&json](const wchar_t* key, float* outRGB) {
-        std::wstring search = std::wstring(L"\"") + key + L"\":[";
-        size_t pos = json.find(search);
-        if (pos == std::wstring::npos) return;
-        pos += search.length();
-
-        // Parse r
-        outRGB[0] = (float)_wtof(json.c_str() + pos);
-
-        // Skip to next comma
-        size_t comma1 = json.find(L',', pos);
-        if (comma1 == std::wstring::npos) return;
-        pos = comma1 + 1;
-
-        // Parse g
-        outRGB[1] = (float)_wtof(json.c_str() + pos);
-
-        // Skip to next comma
-        size_t comma2 = json.find(L',', pos);
-        if (comma2 == std::wstring::npos) return;
-        pos = comma2 + 1;
-
-        // Parse b
-        outRGB[2] = (float)_wtof(json.c_str() + pos);
-    };
-
-    getColorArray(L"fillColor", g_textInfo.fillColor);
-    getColorArray(L"strokeColor", g_textInfo.strokeColor);
+void SetTextInfo(std::string_view info) {
+    WireFormat::Reader reader(info);
+    if (!reader.Next()) return;
+
+    reader.StringInto(WireFormat::TEXT_FONT, g_textInfo.font, 128);
+    reader.StringInto(WireFormat::TEXT_FONT_STYLE, g_textInfo.fontStyle, 64);
+    reader.StringInto(WireFormat::TEXT_LAYER_NAME, g_textInfo.layerName, 256);
+    g_textInfo.fontSize = reader.Float(WireFormat::TEXT_FONT_SIZE, 0);
+    g_textInfo.tracking = reader.Float(WireFormat::TEXT_TRACKING, 0);
+    g_textInfo.leading = reader.Float(WireFormat::TEXT_LEADING, 0);
+    g_textInfo.strokeWidth = reader.Float(WireFormat::TEXT_STROKE_WIDTH, 0);
+    g_textInfo.applyFill = reader.Bool(WireFormat::TEXT_APPLY_FILL, false);
+    g_textInfo.applyStroke = reader.Bool(WireFormat::TEXT_APPLY_STROKE, false);
+    g_textInfo.justify = (Justification)reader.Int(WireFormat::TEXT_JUSTIFY, 0);
 
-    InvalidateRect(g_hwnd, NULL, FALSE);
+    for (int i = 0; i < 3; i++) {
+        g_textInfo.fillColor[i] =
+            reader.Float(WireFormat::TEXT_FILL_R + i, g_textInfo.fillColor[i]);
+        g_textInfo.strokeColor[i] =
+            reader.Float(WireFormat::TEXT_STROKE_R + i, g_textInfo.strokeColor[i]);
+    }
+
+    // Redraw if the window exists (NULL would invalidate the desktop)
+    if (g_hwnd) {
+        InvalidateRect(g_hwnd, NULL, FALSE);
+    }
+}
+
+/*****************************************************************************
+ * SetFonts - Copy the font catalog into the dropdown list
+ * Called at startup and again if revalidation refreshed the catalog
+ *****************************************************************************/
+void SetFonts(const CatalogCache::Catalog& catalog) {
+    uint32_t count = catalog.RecordCount();
+    g_allFonts.clear();
+    g_allFonts.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        FontInfo& fi = g_allFonts[i];
+        fi.familyName = catalog.WideField(i, WireFormat::FONT_FAMILY);
+        fi.styleName = catalog.WideField(i, WireFormat::FONT_STYLE);
+        fi.postScriptName = catalog.WideField(i, WireFormat::FONT_POSTSCRIPT_NAME);
+        fi.displayName = fi.familyName + L" " + fi.styleName;
+        fi.displayLower = fi.displayName;
+        for (auto& c : fi.displayLower) c = towlower(c);
+    }
+    g_fontsLoaded = count > 0;
+
+    // g_filteredFonts points into g_allFonts: rebuild it
+    g_fontHoverIndex = -1;
+    FilterFonts(g_fontSearchText);
+    if (g_hwnd && g_fontDropdownOpen) InvalidateRect(g_hwnd, NULL, FALSE);
 }
 
 /*****************************************************************************
@@ -613,25 +597,20 @@ bool NeedsRefresh() {
 static LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
     case WM_PAINT: {
+        TRACE_SCOPE("paint", "TextUI::Draw");
+        PROFILE_SCOPE("paint.text");
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
 
         // Double buffering
         RECT rect;
         GetClientRect(hwnd, &rect);
-        HDC memDC = CreateCompatibleDC(hdc);
-        HBITMAP memBitmap = CreateCompatibleBitmap(hdc, rect.right, rect.bottom);
-        HGDIOBJ oldBitmap = SelectObject(memDC, memBitmap);
+        HDC memDC = g_backbuffer.Begin(hdc, rect.right, rect.bottom);
 
         Draw(memDC);
 
         // Copy to screen
-        BitBlt(hdc, 0, 0, rect.right, rect.bottom, memDC, 0, 0, SRCCOPY);
-
-        // Cleanup
-        SelectObject(memDC, oldBitmap);
-        DeleteObject(memBitmap);
-        DeleteDC(memDC);
+        g_backbuffer.Present(hdc, rect.right, rect.bottom);
 
         EndPaint(hwnd, &ps);
         return 0;
@@ -741,12 +720,12 @@ static void Draw(HDC hdc) {
     g.ScaleTransform(g_scaleFactor, g_scaleFactor);
 
     // Background
-    SolidBrush bgBrush(COLOR_BG);
-    g.FillRectangle(&bgBrush, 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+    const SolidBrush *bgBrush = RenderContext::Brush(COLOR_BG);
+    g.FillRectangle(bgBrush, 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
 
     // Border
-    Pen borderPen(Color(255, 60, 60, 70), 1);
-    g.DrawRectangle(&borderPen, 0, 0, WINDOW_WIDTH - 1, WINDOW_HEIGHT - 1);
+    const Pen *borderPen = RenderContext::Pen(Color(255, 60, 60, 70), 1);
+    g.DrawRectangle(borderPen, 0, 0, WINDOW_WIDTH - 1, WINDOW_HEIGHT - 1);
 
     // Draw sections
     DrawHeader(g);
@@ -766,27 +745,25 @@ static void Draw(HDC hdc) {
  * DrawHeader - Compact header with title + layer name + pin + preset
  *****************************************************************************/
 static void DrawHeader(Graphics& g) {
-    SolidBrush headerBrush(COLOR_HEADER_BG);
-    g.FillRectangle(&headerBrush, 0, 0, WINDOW_WIDTH, HEADER_HEIGHT);
+    const SolidBrush *headerBrush = RenderContext::Brush(COLOR_HEADER_BG);
+    g.FillRectangle(headerBrush, 0, 0, WINDOW_WIDTH, HEADER_HEIGHT);
 
-    FontFamily fontFamily(L"Segoe UI");
-    Font titleFont(&fontFamily, 10, FontStyleBold, UnitPixel);
-    Font layerFont(&fontFamily, 9, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush dimBrush(COLOR_TEXT_DIM);
+    const Font *titleFont = RenderContext::Font(10, FontStyleBold);
+    const Font *layerFont = RenderContext::Font(9);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
+    const SolidBrush *dimBrush = RenderContext::Brush(COLOR_TEXT_DIM);
 
     // Title "TEXT"
-    g.DrawString(L"TEXT", -1, &titleFont, PointF(PADDING, 7), &textBrush);
+    g.DrawString(L"TEXT", -1, titleFont, PointF(PADDING, 7), textBrush);
 
     // Separator dash
-    g.DrawString(L"\u2014", -1, &layerFont, PointF(40, 8), &dimBrush);
+    g.DrawString(L"\u2014", -1, layerFont, PointF(40, 8), dimBrush);
 
     // Layer name (truncated)
     if (g_textInfo.layerName[0] != L'\0') {
         RectF layerRect(52, 8, 130, 16);
-        StringFormat sf;
-        sf.SetTrimming(StringTrimmingEllipsisCharacter);
-        g.DrawString(g_textInfo.layerName, -1, &layerFont, layerRect, &sf, &dimBrush);
+        const StringFormat *sf = RenderContext::Format(StringAlignmentNear, StringAlignmentNear, true);
+        g.DrawString(g_textInfo.layerName, -1, layerFont, layerRect, sf, dimBrush);
     }
 
     int btnSize = 18;
@@ -795,104 +772,102 @@ static void DrawHeader(Graphics& g) {
     // Copy Style button
     g_copyStyleRect = {WINDOW_WIDTH - 120, btnY, WINDOW_WIDTH - 120 + btnSize, btnY + btnSize};
     Color copyColor = g_copyStyleHover ? COLOR_ALIGN_HOVER : Color(0, 0, 0, 0);
-    SolidBrush copyBrush(copyColor);
-    g.FillRectangle(&copyBrush, g_copyStyleRect.left, g_copyStyleRect.top, btnSize, btnSize);
+    const SolidBrush *copyBrush = RenderContext::Brush(copyColor);
+    g.FillRectangle(copyBrush, g_copyStyleRect.left, g_copyStyleRect.top, btnSize, btnSize);
 
     // Copy icon (two overlapping squares)
-    Pen copyPen(g_copyStyleHover ? COLOR_TEXT : COLOR_TEXT_DIM, 1.0f);
+    const Pen *copyPen = RenderContext::Pen(g_copyStyleHover ? COLOR_TEXT : COLOR_TEXT_DIM, 1.0f);
     int cpx = g_copyStyleRect.left + btnSize / 2;
     int cpy = g_copyStyleRect.top + btnSize / 2;
-    g.DrawRectangle(&copyPen, cpx - 4, cpy - 2, 5, 6);
-    g.DrawRectangle(&copyPen, cpx - 1, cpy - 5, 5, 6);
+    g.DrawRectangle(copyPen, cpx - 4, cpy - 2, 5, 6);
+    g.DrawRectangle(copyPen, cpx - 1, cpy - 5, 5, 6);
 
     // Paste Style button
     g_pasteStyleRect = {WINDOW_WIDTH - 96, btnY, WINDOW_WIDTH - 96 + btnSize, btnY + btnSize};
     Color pasteColor = g_pasteStyleHover ? COLOR_ALIGN_HOVER :
                        (g_hasStyleCopied ? Color(60, 74, 158, 255) : Color(0, 0, 0, 0));
-    SolidBrush pasteBrush(pasteColor);
-    g.FillRectangle(&pasteBrush, g_pasteStyleRect.left, g_pasteStyleRect.top, btnSize, btnSize);
+    const SolidBrush *pasteBrush = RenderContext::Brush(pasteColor);
+    g.FillRectangle(pasteBrush, g_pasteStyleRect.left, g_pasteStyleRect.top, btnSize, btnSize);
 
     // Paste icon (clipboard)
-    Pen pastePen(g_pasteStyleHover ? COLOR_TEXT : (g_hasStyleCopied ? COLOR_ALIGN_ACTIVE : COLOR_TEXT_DIM), 1.0f);
+    const Pen *pastePen = RenderContext::Pen(g_pasteStyleHover ? COLOR_TEXT : (g_hasStyleCopied ? COLOR_ALIGN_ACTIVE : COLOR_TEXT_DIM), 1.0f);
     int ppx = g_pasteStyleRect.left + btnSize / 2;
     int ppy = g_pasteStyleRect.top + btnSize / 2;
-    g.DrawRectangle(&pastePen, ppx - 4, ppy - 3, 8, 8);
-    g.DrawLine(&pastePen, ppx - 2, ppy - 5, ppx + 2, ppy - 5);
+    g.DrawRectangle(pastePen, ppx - 4, ppy - 3, 8, 8);
+    g.DrawLine(pastePen, ppx - 2, ppy - 5, ppx + 2, ppy - 5);
 
     // Preset button (star) - moved to header
     g_presetButtonRect = {WINDOW_WIDTH - 72, btnY, WINDOW_WIDTH - 72 + btnSize, btnY + btnSize};
     bool presetHover = (g_presetHoverIndex == -2);
-    SolidBrush presetBrush(presetHover ? COLOR_ALIGN_HOVER : Color(0, 0, 0, 0));  // Transparent unless hover
-    g.FillRectangle(&presetBrush, g_presetButtonRect.left, g_presetButtonRect.top, btnSize, btnSize);
+    const SolidBrush *presetBrush = RenderContext::Brush(presetHover ? COLOR_ALIGN_HOVER : Color(0, 0, 0, 0)); // Transparent unless hover
+    g.FillRectangle(presetBrush, g_presetButtonRect.left, g_presetButtonRect.top, btnSize, btnSize);
 
     // Star icon
-    Pen starPen(presetHover ? Color(255, 255, 200, 0) : COLOR_TEXT_DIM, 1.0f);
+    const Pen *starPen = RenderContext::Pen(presetHover ? Color(255, 255, 200, 0) : COLOR_TEXT_DIM, 1.0f);
     int starX = g_presetButtonRect.left + btnSize / 2;
     int starY = g_presetButtonRect.top + btnSize / 2;
-    g.DrawLine(&starPen, starX, starY - 5, starX, starY + 5);
-    g.DrawLine(&starPen, starX - 5, starY, starX + 5, starY);
-    g.DrawLine(&starPen, starX - 3, starY - 3, starX + 3, starY + 3);
-    g.DrawLine(&starPen, starX + 3, starY - 3, starX - 3, starY + 3);
+    g.DrawLine(starPen, starX, starY - 5, starX, starY + 5);
+    g.DrawLine(starPen, starX - 5, starY, starX + 5, starY);
+    g.DrawLine(starPen, starX - 3, starY - 3, starX + 3, starY + 3);
+    g.DrawLine(starPen, starX + 3, starY - 3, starX - 3, starY + 3);
 
     // Pin button
     g_pinRect = {WINDOW_WIDTH - 48, btnY, WINDOW_WIDTH - 48 + btnSize, btnY + btnSize};
     Color pinColor = g_keepPanelOpen ? COLOR_PIN_ACTIVE :
                      (g_pinHover ? COLOR_ALIGN_HOVER : Color(0, 0, 0, 0));
-    SolidBrush pinBrush(pinColor);
-    g.FillRectangle(&pinBrush, g_pinRect.left, g_pinRect.top, btnSize, btnSize);
+    const SolidBrush *pinBrush = RenderContext::Brush(pinColor);
+    g.FillRectangle(pinBrush, g_pinRect.left, g_pinRect.top, btnSize, btnSize);
 
-    Pen pinPen(g_keepPanelOpen ? Color(255, 40, 40, 40) : (g_pinHover ? COLOR_TEXT : COLOR_TEXT_DIM), 1.2f);
+    const Pen *pinPen = RenderContext::Pen(g_keepPanelOpen ? Color(255, 40, 40, 40) : (g_pinHover ? COLOR_TEXT : COLOR_TEXT_DIM), 1.2f);
     int px = g_pinRect.left + btnSize / 2, py = g_pinRect.top + btnSize / 2;
-    g.DrawLine(&pinPen, px - 3, py - 3, px + 3, py + 3);
-    g.DrawEllipse(&pinPen, (REAL)(px - 2), (REAL)(py - 5), 5.0f, 5.0f);
+    g.DrawLine(pinPen, px - 3, py - 3, px + 3, py + 3);
+    g.DrawEllipse(pinPen, (REAL)(px - 2), (REAL)(py - 5), 5.0f, 5.0f);
 
     // Close button (X)
     g_closeRect = {WINDOW_WIDTH - 24, btnY, WINDOW_WIDTH - 24 + btnSize, btnY + btnSize};
     Color closeColor = g_closeHover ? COLOR_CLOSE_HOVER : Color(0, 0, 0, 0);
-    SolidBrush closeBrush(closeColor);
-    g.FillRectangle(&closeBrush, g_closeRect.left, g_closeRect.top, btnSize, btnSize);
+    const SolidBrush *closeBrush = RenderContext::Brush(closeColor);
+    g.FillRectangle(closeBrush, g_closeRect.left, g_closeRect.top, btnSize, btnSize);
 
-    Pen closePen(g_closeHover ? COLOR_TEXT : COLOR_TEXT_DIM, 1.2f);
+    const Pen *closePen = RenderContext::Pen(g_closeHover ? COLOR_TEXT : COLOR_TEXT_DIM, 1.2f);
     int cx = g_closeRect.left + btnSize / 2, cy = g_closeRect.top + btnSize / 2;
-    g.DrawLine(&closePen, cx - 4, cy - 4, cx + 4, cy + 4);
-    g.DrawLine(&closePen, cx + 4, cy - 4, cx - 4, cy + 4);
+    g.DrawLine(closePen, cx - 4, cy - 4, cx + 4, cy + 4);
+    g.DrawLine(closePen, cx + 4, cy - 4, cx - 4, cy + 4);
 }
 
 /*****************************************************************************
  * DrawFontSection - Compact: "Font" label inline with dropdown
  *****************************************************************************/
 static void DrawFontSection(Graphics& g, int& y) {
-    FontFamily fontFamily(L"Segoe UI");
-    Font labelFont(&fontFamily, 9, FontStyleRegular, UnitPixel);
-    Font valueFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    SolidBrush labelBrush(COLOR_SECTION_LABEL);
-    SolidBrush textBrush(COLOR_TEXT);
+    const Font *labelFont = RenderContext::Font(9);
+    const Font *valueFont = RenderContext::Font(10);
+    const SolidBrush *labelBrush = RenderContext::Brush(COLOR_SECTION_LABEL);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
 
     // "Font" label inline
-    g.DrawString(L"Font", -1, &labelFont, PointF((REAL)PADDING, (REAL)(y + 4)), &labelBrush);
+    g.DrawString(L"Font", -1, labelFont, PointF((REAL)PADDING, (REAL)(y + 4)), labelBrush);
 
     // Font dropdown button (after label)
     int dropdownX = PADDING + 32;
     bool fontHover = (g_fontHoverIndex == -2);
-    SolidBrush valueBgBrush(fontHover ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
+    const SolidBrush *valueBgBrush = RenderContext::Brush(fontHover ? COLOR_VALUE_HOVER : COLOR_VALUE_BG);
     g_fontButtonRect = {dropdownX, y, WINDOW_WIDTH - PADDING, y + ROW_HEIGHT};
-    g.FillRectangle(&valueBgBrush, g_fontButtonRect.left, g_fontButtonRect.top,
+    g.FillRectangle(valueBgBrush, g_fontButtonRect.left, g_fontButtonRect.top,
                     g_fontButtonRect.right - g_fontButtonRect.left, ROW_HEIGHT);
 
     // Display current font
     std::wstring displayFont = g_textInfo.font[0] ? g_textInfo.font : L"(Select text layer)";
     RectF fontTextRect((REAL)g_fontButtonRect.left + 6, (REAL)y + 4,
                        (REAL)(g_fontButtonRect.right - g_fontButtonRect.left - 24), (REAL)ROW_HEIGHT - 8);
-    StringFormat sf;
-    sf.SetTrimming(StringTrimmingEllipsisCharacter);
-    g.DrawString(displayFont.c_str(), -1, &valueFont, fontTextRect, &sf, &textBrush);
+    const StringFormat *sf = RenderContext::Format(StringAlignmentNear, StringAlignmentNear, true);
+    g.DrawString(displayFont.c_str(), -1, valueFont, fontTextRect, sf, textBrush);
 
     // Dropdown arrow
-    Pen arrowPen(COLOR_TEXT, 1.5f);
+    const Pen *arrowPen = RenderContext::Pen(COLOR_TEXT, 1.5f);
     int arrowX = g_fontButtonRect.right - 12;
     int arrowY = y + ROW_HEIGHT / 2;
-    g.DrawLine(&arrowPen, arrowX - 3, arrowY - 2, arrowX, arrowY + 1);
-    g.DrawLine(&arrowPen, arrowX, arrowY + 1, arrowX + 3, arrowY - 2);
+    g.DrawLine(arrowPen, arrowX - 3, arrowY - 2, arrowX, arrowY + 1);
+    g.DrawLine(arrowPen, arrowX, arrowY + 1, arrowX + 3, arrowY - 2);
 
     y += ROW_HEIGHT + ROW_SPACING;
 }
@@ -901,23 +876,22 @@ static void DrawFontSection(Graphics& g, int& y) {
  * DrawColorSection - Compact: Fill [■] Stroke [■] [Width]
  *****************************************************************************/
 static void DrawColorSection(Graphics& g, int& y) {
-    FontFamily fontFamily(L"Segoe UI");
-    Font labelFont(&fontFamily, 9, FontStyleRegular, UnitPixel);
-    SolidBrush labelBrush(COLOR_SECTION_LABEL);
-    SolidBrush textBrush(COLOR_TEXT);
+    const Font *labelFont = RenderContext::Font(9);
+    const SolidBrush *labelBrush = RenderContext::Brush(COLOR_SECTION_LABEL);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
 
     int boxY = y;
     int x = PADDING;
 
     // Fill label + color box
-    g.DrawString(L"Fill", -1, &labelFont, PointF((REAL)x, (REAL)(boxY + 3)), &labelBrush);
+    g.DrawString(L"Fill", -1, labelFont, PointF((REAL)x, (REAL)(boxY + 3)), labelBrush);
     x += 22;
     g_fillColorRect = {x, boxY, x + COLOR_BOX_SIZE, boxY + COLOR_BOX_SIZE};
     DrawColorBox(g, g_fillColorRect, g_textInfo.fillColor, g_textInfo.applyFill, g_fillColorHover);
     x += COLOR_BOX_SIZE + 12;
 
     // Stroke label + color box
-    g.DrawString(L"Stroke", -1, &labelFont, PointF((REAL)x, (REAL)(boxY + 3)), &labelBrush);
+    g.DrawString(L"Stroke", -1, labelFont, PointF((REAL)x, (REAL)(boxY + 3)), labelBrush);
     x += 38;
     g_strokeColorRect = {x, boxY, x + COLOR_BOX_SIZE, boxY + COLOR_BOX_SIZE};
     DrawColorBox(g, g_strokeColorRect, g_textInfo.strokeColor, g_textInfo.applyStroke, g_strokeColorHover);
@@ -935,11 +909,10 @@ static void DrawColorSection(Graphics& g, int& y) {
  * DrawValueSection - Compact: 3 columns (Size, Tracking, Leading)
  *****************************************************************************/
 static void DrawValueSection(Graphics& g, int& y) {
-    FontFamily fontFamily(L"Segoe UI");
-    Font labelFont(&fontFamily, 8, FontStyleRegular, UnitPixel);
-    Font valueFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    SolidBrush labelBrush(COLOR_SECTION_LABEL);
-    SolidBrush textBrush(COLOR_TEXT);
+    const Font *labelFont = RenderContext::Font(8);
+    const Font *valueFont = RenderContext::Font(10);
+    const SolidBrush *labelBrush = RenderContext::Brush(COLOR_SECTION_LABEL);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
 
     // 3 columns layout
     int colWidth = (WINDOW_WIDTH - PADDING * 2 - 8) / 3;  // 8px gap total
@@ -947,19 +920,19 @@ static void DrawValueSection(Graphics& g, int& y) {
 
     // Column 1: Size
     int col1X = PADDING;
-    g.DrawString(L"Size", -1, &labelFont, PointF((REAL)col1X, (REAL)y), &labelBrush);
+    g.DrawString(L"Size", -1, labelFont, PointF((REAL)col1X, (REAL)y), labelBrush);
     g_sizeRect = {col1X, y + 12, col1X + colWidth, y + 12 + boxHeight};
     DrawValueBox(g, g_sizeRect, TARGET_SIZE, g_textInfo.fontSize, L"pt");
 
     // Column 2: Tracking
     int col2X = col1X + colWidth + 4;
-    g.DrawString(L"Tracking", -1, &labelFont, PointF((REAL)col2X, (REAL)y), &labelBrush);
+    g.DrawString(L"Tracking", -1, labelFont, PointF((REAL)col2X, (REAL)y), labelBrush);
     g_trackingRect = {col2X, y + 12, col2X + colWidth, y + 12 + boxHeight};
     DrawValueBox(g, g_trackingRect, TARGET_TRACKING, g_textInfo.tracking, L"");
 
     // Column 3: Leading
     int col3X = col2X + colWidth + 4;
-    g.DrawString(L"Leading", -1, &labelFont, PointF((REAL)col3X, (REAL)y), &labelBrush);
+    g.DrawString(L"Leading", -1, labelFont, PointF((REAL)col3X, (REAL)y), labelBrush);
     g_leadingRect = {col3X, y + 12, col3X + colWidth, y + 12 + boxHeight};
     DrawValueBox(g, g_leadingRect, TARGET_LEADING, g_textInfo.leading, L"");
 
@@ -1015,20 +988,19 @@ static void DrawValueBox(Graphics& g, RECT& rect, ValueTarget target, float valu
     Color bgColor = isEdit ? COLOR_VALUE_EDIT :
                     isDrag ? COLOR_VALUE_DRAG :
                     isHover ? COLOR_VALUE_HOVER : COLOR_VALUE_BG;
-    SolidBrush bgBrush(bgColor);
-    g.FillRectangle(&bgBrush, rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top);
+    const SolidBrush *bgBrush = RenderContext::Brush(bgColor);
+    g.FillRectangle(bgBrush, rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top);
 
     // Border for edit mode
     if (isEdit) {
-        Pen borderPen(COLOR_VALUE_BORDER, 2);
-        g.DrawRectangle(&borderPen, rect.left, rect.top,
+        const Pen *borderPen = RenderContext::Pen(COLOR_VALUE_BORDER, 2);
+        g.DrawRectangle(borderPen, rect.left, rect.top,
                         rect.right - rect.left - 1, rect.bottom - rect.top - 1);
     }
 
     // Text
-    FontFamily fontFamily(L"Segoe UI");
-    Font font(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
+    const Font *font = RenderContext::Font(10);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
 
     std::wstring displayText;
     if (isEdit) {
@@ -1037,16 +1009,14 @@ static void DrawValueBox(Graphics& g, RECT& rect, ValueTarget target, float valu
         displayText = FormatValue(target, value);
     }
 
-    StringFormat sf;
-    sf.SetAlignment(StringAlignmentCenter);
-    sf.SetLineAlignment(StringAlignmentCenter);
+    const StringFormat *sf = RenderContext::Format(StringAlignmentCenter);
     RectF textRect((REAL)rect.left, (REAL)rect.top,
                    (REAL)(rect.right - rect.left), (REAL)(rect.bottom - rect.top));
 
     // Selection highlight when selectAll is active
     if (isEdit && g_editSelectAll && !displayText.empty()) {
         RectF bounds;
-        g.MeasureString(displayText.c_str(), -1, &font, PointF(0, 0), &bounds);
+        g.MeasureString(displayText.c_str(), -1, font, PointF(0, 0), &bounds);
         REAL textWidth = bounds.Width;
         REAL textHeight = bounds.Height;
 
@@ -1055,25 +1025,25 @@ static void DrawValueBox(Graphics& g, RECT& rect, ValueTarget target, float valu
         int selW = (int)textWidth + 4;
         int selH = (int)textHeight;
 
-        SolidBrush selBrush(Color(180, 74, 158, 255));  // Blue selection highlight
-        g.FillRectangle(&selBrush, selX, selY, selW, selH);
+        const SolidBrush *selBrush = RenderContext::Brush(Color(180, 74, 158, 255)); // Blue selection highlight
+        g.FillRectangle(selBrush, selX, selY, selW, selH);
     }
 
-    g.DrawString(displayText.c_str(), -1, &font, textRect, &sf, &textBrush);
+    g.DrawString(displayText.c_str(), -1, font, textRect, sf, textBrush);
 
     // Cursor for edit mode (only show when not selectAll)
     if (isEdit && !g_editSelectAll) {
         // Simple cursor at end (TODO: proper cursor positioning)
         REAL textWidth = 0;
         RectF bounds;
-        g.MeasureString(displayText.c_str(), -1, &font, PointF(0, 0), &bounds);
+        g.MeasureString(displayText.c_str(), -1, font, PointF(0, 0), &bounds);
         textWidth = bounds.Width;
 
         int cx = (rect.left + rect.right) / 2 + (int)(textWidth / 2) + 2;
         int cy1 = rect.top + 4;
         int cy2 = rect.bottom - 4;
-        Pen cursorPen(COLOR_TEXT, 1);
-        g.DrawLine(&cursorPen, cx, cy1, cx, cy2);
+        const Pen *cursorPen = RenderContext::Pen(COLOR_TEXT, 1);
+        g.DrawLine(cursorPen, cx, cy1, cx, cy2);
     }
 }
 
@@ -1082,8 +1052,8 @@ static void DrawValueBox(Graphics& g, RECT& rect, ValueTarget target, float valu
  *****************************************************************************/
 static void DrawColorBox(Graphics& g, RECT& rect, float* color, bool hasColor, bool hover) {
     // Border
-    Pen borderPen(hover ? COLOR_VALUE_BORDER : Color(255, 80, 80, 90), hover ? 2.0f : 1.0f);
-    g.DrawRectangle(&borderPen, rect.left, rect.top,
+    const Pen *borderPen = RenderContext::Pen(hover ? COLOR_VALUE_BORDER : Color(255, 80, 80, 90), hover ? 2.0f : 1.0f);
+    g.DrawRectangle(borderPen, rect.left, rect.top,
                     rect.right - rect.left - 1, rect.bottom - rect.top - 1);
 
     // Fill
@@ -1091,14 +1061,14 @@ static void DrawColorBox(Graphics& g, RECT& rect, float* color, bool hasColor, b
         int r = (int)(color[0] * 255);
         int g_val = (int)(color[1] * 255);
         int b = (int)(color[2] * 255);
-        SolidBrush colorBrush(Color(255, r, g_val, b));
-        g.FillRectangle(&colorBrush, rect.left + 2, rect.top + 2,
+        const SolidBrush *colorBrush = RenderContext::Brush(Color(255, r, g_val, b));
+        g.FillRectangle(colorBrush, rect.left + 2, rect.top + 2,
                         rect.right - rect.left - 4, rect.bottom - rect.top - 4);
     } else {
         // X pattern for no color
-        Pen xPen(Color(255, 100, 100, 100), 1);
-        g.DrawLine(&xPen, rect.left + 4, rect.top + 4, rect.right - 4, rect.bottom - 4);
-        g.DrawLine(&xPen, rect.right - 4, rect.top + 4, rect.left + 4, rect.bottom - 4);
+        const Pen *xPen = RenderContext::Pen(Color(255, 100, 100, 100), 1);
+        g.DrawLine(xPen, rect.left + 4, rect.top + 4, rect.right - 4, rect.bottom - 4);
+        g.DrawLine(xPen, rect.right - 4, rect.top + 4, rect.left + 4, rect.bottom - 4);
     }
 }
 
@@ -1108,14 +1078,14 @@ static void DrawColorBox(Graphics& g, RECT& rect, float* color, bool hasColor, b
 static void DrawAlignButton(Graphics& g, RECT& rect, int index, bool active, bool hover) {
     Color bgColor = active ? COLOR_ALIGN_ACTIVE :
                     hover ? COLOR_ALIGN_HOVER : COLOR_ALIGN_BG;
-    SolidBrush bgBrush(bgColor);
-    g.FillRectangle(&bgBrush, rect.left, rect.top,
+    const SolidBrush *bgBrush = RenderContext::Brush(bgColor);
+    g.FillRectangle(bgBrush, rect.left, rect.top,
                     rect.right - rect.left, rect.bottom - rect.top);
 
     // Draw alignment icon
     Color iconColor = active ? Color(255, 255, 255, 255) : COLOR_TEXT;
-    Pen iconPen(iconColor, 1.5f);
-    SolidBrush iconBrush(iconColor);
+    const Pen *iconPen = RenderContext::Pen(iconColor, 1.5f);
+    const SolidBrush *iconBrush = RenderContext::Brush(iconColor);
 
     int cx = (rect.left + rect.right) / 2;
     int cy = (rect.top + rect.bottom) / 2;
@@ -1123,32 +1093,32 @@ static void DrawAlignButton(Graphics& g, RECT& rect, int index, bool active, boo
     // Icon patterns based on index
     switch (index) {
     case 0: // Left
-        g.DrawLine(&iconPen, cx - 6, cy - 6, cx - 6, cy + 6);
-        g.FillRectangle(&iconBrush, cx - 6, cy - 4, 10, 3);
-        g.FillRectangle(&iconBrush, cx - 6, cy + 1, 7, 3);
+        g.DrawLine(iconPen, cx - 6, cy - 6, cx - 6, cy + 6);
+        g.FillRectangle(iconBrush, cx - 6, cy - 4, 10, 3);
+        g.FillRectangle(iconBrush, cx - 6, cy + 1, 7, 3);
         break;
     case 1: // Center
-        g.DrawLine(&iconPen, cx, cy - 7, cx, cy + 7);
-        g.FillRectangle(&iconBrush, cx - 5, cy - 4, 10, 3);
-        g.FillRectangle(&iconBrush, cx - 3, cy + 1, 7, 3);
+        g.DrawLine(iconPen, cx, cy - 7, cx, cy + 7);
+        g.FillRectangle(iconBrush, cx - 5, cy - 4, 10, 3);
+        g.FillRectangle(iconBrush, cx - 3, cy + 1, 7, 3);
         break;
     case 2: // Right
-        g.DrawLine(&iconPen, cx + 6, cy - 6, cx + 6, cy + 6);
-        g.FillRectangle(&iconBrush, cx - 4, cy - 4, 10, 3);
-        g.FillRectangle(&iconBrush, cx - 1, cy + 1, 7, 3);
+        g.DrawLine(iconPen, cx + 6, cy - 6, cx + 6, cy + 6);
+        g.FillRectangle(iconBrush, cx - 4, cy - 4, 10, 3);
+        g.FillRectangle(iconBrush, cx - 1, cy + 1, 7, 3);
         break;
     case 3: // Justify Left
     case 4: // Justify Center
     case 5: // Justify Right
     case 6: // Justify Full
         // Full width lines
-        g.FillRectangle(&iconBrush, cx - 6, cy - 5, 12, 2);
-        g.FillRectangle(&iconBrush, cx - 6, cy - 1, 12, 2);
+        g.FillRectangle(iconBrush, cx - 6, cy - 5, 12, 2);
+        g.FillRectangle(iconBrush, cx - 6, cy - 1, 12, 2);
         // Last line based on justify type
-        if (index == 3) g.FillRectangle(&iconBrush, cx - 6, cy + 3, 8, 2);
-        else if (index == 4) g.FillRectangle(&iconBrush, cx - 4, cy + 3, 8, 2);
-        else if (index == 5) g.FillRectangle(&iconBrush, cx - 2, cy + 3, 8, 2);
-        else g.FillRectangle(&iconBrush, cx - 6, cy + 3, 12, 2);
+        if (index == 3) g.FillRectangle(iconBrush, cx - 6, cy + 3, 8, 2);
+        else if (index == 4) g.FillRectangle(iconBrush, cx - 4, cy + 3, 8, 2);
+        else if (index == 5) g.FillRectangle(iconBrush, cx - 2, cy + 3, 8, 2);
+        else g.FillRectangle(iconBrush, cx - 6, cy + 3, 12, 2);
         break;
     }
 }
@@ -1853,45 +1823,9 @@ static void ApplyJustification(Justification just) {
 static void LoadFonts() {
     if (g_fontsLoaded) return;
 
-    wchar_t* buffer = new wchar_t[65536];
-    if (!buffer) return;
-    memset(buffer, 0, 65536 * sizeof(wchar_t));
-
-    GetFontsList(buffer, 65536);
-
-    if (buffer[0] == L'\0') {
-        delete[] buffer;
-        return;
-    }
-
-    // Parse "familyName|styleName|postScriptName;..."
-    g_allFonts.clear();
-    std::wstring data(buffer);
-    delete[] buffer;
-
-    size_t pos = 0;
-    while (pos < data.length()) {
-        size_t end = data.find(L';', pos);
-        if (end == std::wstring::npos) end = data.length();
-
-        std::wstring entry = data.substr(pos, end - pos);
-        if (!entry.empty()) {
-            size_t p1 = entry.find(L'|');
-            size_t p2 = entry.find(L'|', p1 + 1);
-            if (p1 != std::wstring::npos && p2 != std::wstring::npos) {
-                FontInfo fi;
-                fi.familyName = entry.substr(0, p1);
-                fi.styleName = entry.substr(p1 + 1, p2 - p1 - 1);
-                fi.postScriptName = entry.substr(p2 + 1);
-                fi.displayName = fi.familyName + L" " + fi.styleName;
-                g_allFonts.push_back(fi);
-            }
-        }
-        pos = end + 1;
-    }
-
-    g_fontsLoaded = true;
-    FilterFonts(L"");
+    // Normally done on an early idle tick; this only runs if the dropdown
+    // opens first (LoadFontCatalog calls SetFonts)
+    LoadFontCatalog();
 }
 
 static void FilterFonts(const std::wstring& search) {
@@ -1902,14 +1836,8 @@ static void FilterFonts(const std::wstring& search) {
     for (auto& c : searchLower) c = towlower(c);
 
     for (auto& font : g_allFonts) {
-        if (search.empty()) {
+        if (search.empty() || font.displayLower.find(searchLower) != std::wstring::npos) {
             g_filteredFonts.push_back(&font);
-        } else {
-            std::wstring displayLower = font.displayName;
-            for (auto& c : displayLower) c = towlower(c);
-            if (displayLower.find(searchLower) != std::wstring::npos) {
-                g_filteredFonts.push_back(&font);
-            }
         }
     }
 }
@@ -1917,13 +1845,12 @@ static void FilterFonts(const std::wstring& search) {
 static void DrawFontDropdown(Graphics& g) {
     if (!g_fontDropdownOpen) return;
 
-    FontFamily fontFamily(L"Segoe UI");
-    Font searchFont(&fontFamily, 11, FontStyleRegular, UnitPixel);
-    Font itemFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
-    SolidBrush bgBrush(Color(255, 35, 35, 42));
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush dimBrush(COLOR_TEXT_DIM);
-    Pen borderPen(COLOR_BORDER, 1.0f);
+    const Font *searchFont = RenderContext::Font(11);
+    const Font *itemFont = RenderContext::Font(10);
+    const SolidBrush *bgBrush = RenderContext::Brush(Color(255, 35, 35, 42));
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
+    const SolidBrush *dimBrush = RenderContext::Brush(COLOR_TEXT_DIM);
+    const Pen *borderPen = RenderContext::Pen(COLOR_BORDER, 1.0f);
 
     // Dropdown position (below font button)
     int dropX = g_fontButtonRect.left;
@@ -1937,16 +1864,16 @@ static void DrawFontDropdown(Graphics& g) {
     g_fontDropdownRect = {dropX, dropY, dropX + dropW, dropY + dropH};
 
     // Background
-    g.FillRectangle(&bgBrush, dropX, dropY, dropW, dropH);
-    g.DrawRectangle(&borderPen, dropX, dropY, dropW - 1, dropH - 1);
+    g.FillRectangle(bgBrush, dropX, dropY, dropW, dropH);
+    g.DrawRectangle(borderPen, dropX, dropY, dropW - 1, dropH - 1);
 
     // Search box
-    SolidBrush searchBgBrush(COLOR_VALUE_BG);
-    g.FillRectangle(&searchBgBrush, dropX + 4, dropY + 4, dropW - 8, searchH - 8);
+    const SolidBrush *searchBgBrush = RenderContext::Brush(COLOR_VALUE_BG);
+    g.FillRectangle(searchBgBrush, dropX + 4, dropY + 4, dropW - 8, searchH - 8);
 
     std::wstring searchDisplay = g_fontSearchText.empty() ? L"Search fonts..." : g_fontSearchText;
-    SolidBrush& searchTextBrush = g_fontSearchText.empty() ? dimBrush : textBrush;
-    g.DrawString(searchDisplay.c_str(), -1, &searchFont, PointF((REAL)(dropX + 8), (REAL)(dropY + 6)), &searchTextBrush);
+    const SolidBrush *searchTextBrush = g_fontSearchText.empty() ? dimBrush : textBrush;
+    g.DrawString(searchDisplay.c_str(), -1, searchFont, PointF((REAL)(dropX + 8), (REAL)(dropY + 6)), searchTextBrush);
 
     // Font list
     int listY = dropY + searchH;
@@ -1961,13 +1888,13 @@ static void DrawFontDropdown(Graphics& g) {
 
         // Hover highlight
         if (idx == g_fontHoverIndex) {
-            SolidBrush hoverBrush(COLOR_HOVER);
-            g.FillRectangle(&hoverBrush, dropX + 2, itemY, dropW - 4, FONT_ITEM_HEIGHT);
+            const SolidBrush *hoverBrush = RenderContext::Brush(COLOR_HOVER);
+            g.FillRectangle(hoverBrush, dropX + 2, itemY, dropW - 4, FONT_ITEM_HEIGHT);
         }
 
         // Font name (use the font itself for preview if possible)
-        g.DrawString(fi->displayName.c_str(), -1, &itemFont,
-                     PointF((REAL)(dropX + 8), (REAL)(itemY + 4)), &textBrush);
+        g.DrawString(fi->displayName.c_str(), -1, itemFont,
+                     PointF((REAL)(dropX + 8), (REAL)(itemY + 4)), textBrush);
     }
 
     // Scroll indicator if needed
@@ -1977,8 +1904,8 @@ static void DrawFontDropdown(Graphics& g) {
         int scrollBarH = listH * FONT_DROPDOWN_MAX_ITEMS / (int)g_filteredFonts.size();
         int scrollBarY = listY + (int)((listH - scrollBarH) * scrollRatio);
 
-        SolidBrush scrollBrush(Color(128, 100, 100, 120));
-        g.FillRectangle(&scrollBrush, dropX + dropW - 6, scrollBarY, 4, scrollBarH);
+        const SolidBrush *scrollBrush = RenderContext::Brush(Color(128, 100, 100, 120));
+        g.FillRectangle(scrollBrush, dropX + dropW - 6, scrollBarY, 4, scrollBarH);
     }
 }
 
@@ -1988,11 +1915,10 @@ static void DrawFontDropdown(Graphics& g) {
 static void DrawPresetDropdown(Graphics& g) {
     if (!g_presetDropdownOpen) return;
 
-    FontFamily fontFamily(L"Segoe UI");
-    Font itemFont(&fontFamily, 11, FontStyleRegular, UnitPixel);
-    Font labelFont(&fontFamily, 9, FontStyleRegular, UnitPixel);
-    SolidBrush textBrush(COLOR_TEXT);
-    SolidBrush dimBrush(Color(255, 140, 140, 140));
+    const Font *itemFont = RenderContext::Font(11);
+    const Font *labelFont = RenderContext::Font(9);
+    const SolidBrush *textBrush = RenderContext::Brush(COLOR_TEXT);
+    const SolidBrush *dimBrush = RenderContext::Brush(Color(255, 140, 140, 140));
 
     // Dropdown position (below preset button)
     int dropX = g_presetButtonRect.left - 150;  // Wider dropdown, positioned left
@@ -2008,15 +1934,15 @@ static void DrawPresetDropdown(Graphics& g) {
     g_presetDropdownRect = {dropX, dropY, dropX + dropW, dropY + dropH};
 
     // Background with shadow
-    SolidBrush shadowBrush(Color(80, 0, 0, 0));
-    g.FillRectangle(&shadowBrush, dropX + 3, dropY + 3, dropW, dropH);
+    const SolidBrush *shadowBrush = RenderContext::Brush(Color(80, 0, 0, 0));
+    g.FillRectangle(shadowBrush, dropX + 3, dropY + 3, dropW, dropH);
 
-    SolidBrush bgBrush(Color(255, 40, 42, 48));
-    g.FillRectangle(&bgBrush, dropX, dropY, dropW, dropH);
+    const SolidBrush *bgBrush = RenderContext::Brush(Color(255, 40, 42, 48));
+    g.FillRectangle(bgBrush, dropX, dropY, dropW, dropH);
 
     // Border
-    Pen borderPen(Color(255, 60, 60, 70), 1.0f);
-    g.DrawRectangle(&borderPen, dropX, dropY, dropW - 1, dropH - 1);
+    const Pen *borderPen = RenderContext::Pen(Color(255, 60, 60, 70), 1.0f);
+    g.DrawRectangle(borderPen, dropX, dropY, dropW - 1, dropH - 1);
 
     // Draw items
     int listY = dropY + 4;
@@ -2028,24 +1954,24 @@ static void DrawPresetDropdown(Graphics& g) {
 
         // Hover highlight
         if (g_presetHoverIndex == -1) {
-            SolidBrush hoverBrush(COLOR_HOVER);
-            g.FillRectangle(&hoverBrush, itemRect.left, itemRect.top,
+            const SolidBrush *hoverBrush = RenderContext::Brush(COLOR_HOVER);
+            g.FillRectangle(hoverBrush, itemRect.left, itemRect.top,
                            itemRect.right - itemRect.left, PRESET_ITEM_HEIGHT);
         }
 
         // Star icon (small)
-        Pen starPen(Color(255, 255, 200, 0), 1.0f);
+        const Pen *starPen = RenderContext::Pen(Color(255, 255, 200, 0), 1.0f);
         int starCx = dropX + 18;
         int starCy = listY + PRESET_ITEM_HEIGHT / 2;
-        g.DrawLine(&starPen, starCx, starCy - 4, starCx, starCy + 4);
-        g.DrawLine(&starPen, starCx - 4, starCy, starCx + 4, starCy);
-        g.DrawLine(&starPen, starCx - 3, starCy - 3, starCx + 3, starCy + 3);
-        g.DrawLine(&starPen, starCx + 3, starCy - 3, starCx - 3, starCy + 3);
+        g.DrawLine(starPen, starCx, starCy - 4, starCx, starCy + 4);
+        g.DrawLine(starPen, starCx - 4, starCy, starCx + 4, starCy);
+        g.DrawLine(starPen, starCx - 3, starCy - 3, starCx + 3, starCy + 3);
+        g.DrawLine(starPen, starCx + 3, starCy - 3, starCx - 3, starCy + 3);
 
         // Text
-        SolidBrush saveBrush(Color(255, 255, 200, 0));
-        g.DrawString(L"Save Current Style", -1, &itemFont,
-                    PointF((REAL)dropX + 32, (REAL)listY + 5), &saveBrush);
+        const SolidBrush *saveBrush = RenderContext::Brush(Color(255, 255, 200, 0));
+        g.DrawString(L"Save Current Style", -1, itemFont,
+                    PointF((REAL)dropX + 32, (REAL)listY + 5), saveBrush);
 
         listY += PRESET_ITEM_HEIGHT;
         itemIndex++;
@@ -2063,30 +1989,29 @@ static void DrawPresetDropdown(Graphics& g) {
 
         // Hover highlight
         if (g_presetHoverIndex == i) {
-            SolidBrush hoverBrush(COLOR_HOVER);
-            g.FillRectangle(&hoverBrush, itemRect.left, itemRect.top,
+            const SolidBrush *hoverBrush = RenderContext::Brush(COLOR_HOVER);
+            g.FillRectangle(hoverBrush, itemRect.left, itemRect.top,
                            itemRect.right - itemRect.left, PRESET_ITEM_HEIGHT);
         }
 
         // Preset name
-        StringFormat sf;
-        sf.SetTrimming(StringTrimmingEllipsisCharacter);
+        const StringFormat *sf = RenderContext::Format(StringAlignmentNear, StringAlignmentNear, true);
         RectF textRect((REAL)dropX + 12, (REAL)listY + 2, (REAL)dropW - 50, (REAL)PRESET_ITEM_HEIGHT - 4);
-        g.DrawString(p.name.c_str(), -1, &itemFont, textRect, &sf, &textBrush);
+        g.DrawString(p.name.c_str(), -1, itemFont, textRect, sf, textBrush);
 
         // Font info (smaller, dim)
         std::wstring fontInfo = p.font.substr(0, 15);
         if (p.font.length() > 15) fontInfo += L"...";
-        g.DrawString(fontInfo.c_str(), -1, &labelFont,
-                    PointF((REAL)dropX + 12, (REAL)listY + 14), &dimBrush);
+        g.DrawString(fontInfo.c_str(), -1, labelFont,
+                    PointF((REAL)dropX + 12, (REAL)listY + 14), dimBrush);
 
         // Delete button (X) on hover
         if (g_presetHoverIndex == i) {
             int delX = dropX + dropW - 24;
             int delY = listY + PRESET_ITEM_HEIGHT / 2;
-            Pen delPen(Color(255, 200, 80, 80), 1.5f);
-            g.DrawLine(&delPen, delX - 4, delY - 4, delX + 4, delY + 4);
-            g.DrawLine(&delPen, delX + 4, delY - 4, delX - 4, delY + 4);
+            const Pen *delPen = RenderContext::Pen(Color(255, 200, 80, 80), 1.5f);
+            g.DrawLine(delPen, delX - 4, delY - 4, delX + 4, delY + 4);
+            g.DrawLine(delPen, delX + 4, delY - 4, delX - 4, delY + 4);
         }
 
         listY += PRESET_ITEM_HEIGHT;
@@ -2100,8 +2025,8 @@ static void DrawPresetDropdown(Graphics& g) {
         int scrollBarH = listH * PRESET_DROPDOWN_MAX_ITEMS / totalItems;
         int scrollBarY = dropY + 4 + (int)((listH - scrollBarH) * scrollRatio);
 
-        SolidBrush scrollBrush(Color(128, 100, 100, 120));
-        g.FillRectangle(&scrollBrush, dropX + dropW - 6, scrollBarY, 4, scrollBarH);
+        const SolidBrush *scrollBrush = RenderContext::Brush(Color(128, 100, 100, 120));
+        g.FillRectangle(scrollBrush, dropX + dropW - 6, scrollBarY, 4, scrollBarH);
     }
 }
 
@@ -2129,6 +2054,7 @@ static std::wstring GetPresetFilePath() {
 }
 
 static void LoadPresets() {
+    TRACE_SCOPE("io", "TextUI::LoadPresets");
     g_textPresets.clear();
 
     std::wstring filePath = GetPresetFilePath();
@@ -2176,6 +2102,7 @@ static void LoadPresets() {
 }
 
 static void SavePresetsToFile() {
+    TRACE_SCOPE("io", "TextUI::SavePresetsToFile");
     std::wstring filePath = GetPresetFilePath();
     if (filePath.empty()) return;
 
@@ -2462,11 +2389,11 @@ static void DrawColorPicker(HDC hdc) {
     g.SetSmoothingMode(SmoothingModeAntiAlias);
     g.ScaleTransform(g_scaleFactor, g_scaleFactor);
 
-    SolidBrush bgBrush(Color(255, 35, 35, 42));
-    g.FillRectangle(&bgBrush, 0, 0, PICKER_WIDTH, PICKER_HEIGHT);
+    const SolidBrush *bgBrush = RenderContext::Brush(Color(255, 35, 35, 42));
+    g.FillRectangle(bgBrush, 0, 0, PICKER_WIDTH, PICKER_HEIGHT);
 
-    Pen borderPen(Color(255, 80, 80, 90), 1);
-    g.DrawRectangle(&borderPen, 0, 0, PICKER_WIDTH - 1, PICKER_HEIGHT - 1);
+    const Pen *borderPen = RenderContext::Pen(Color(255, 80, 80, 90), 1);
+    g.DrawRectangle(borderPen, 0, 0, PICKER_WIDTH - 1, PICKER_HEIGHT - 1);
 
     // Reset transform to draw bitmaps at actual pixel positions
     g.ResetTransform();
@@ -2495,25 +2422,25 @@ static void DrawColorPicker(HDC hdc) {
     // SV cursor
     int svCursorX = svX + (int)(g_pickerS * SV_SIZE);
     int svCursorY = svY + (int)((1.0f - g_pickerV) * SV_SIZE);
-    Pen cursorPen(Color(255, 255, 255, 255), 2);
-    g.DrawEllipse(&cursorPen, svCursorX - 5, svCursorY - 5, 10, 10);
-    Pen cursorPenInner(Color(255, 0, 0, 0), 1);
-    g.DrawEllipse(&cursorPenInner, svCursorX - 4, svCursorY - 4, 8, 8);
+    const Pen *cursorPen = RenderContext::Pen(Color(255, 255, 255, 255), 2);
+    g.DrawEllipse(cursorPen, svCursorX - 5, svCursorY - 5, 10, 10);
+    const Pen *cursorPenInner = RenderContext::Pen(Color(255, 0, 0, 0), 1);
+    g.DrawEllipse(cursorPenInner, svCursorX - 4, svCursorY - 4, 8, 8);
 
     // Hue cursor
     int hueBarWidth = SV_SIZE;
     int hueCursorX = svX + (int)(g_pickerH * hueBarWidth);
-    Pen hueCursorPen(Color(255, 255, 255, 255), 2);
-    g.DrawRectangle(&hueCursorPen, hueCursorX - 2, hueY - 1, 4, HUE_BAR_HEIGHT + 2);
+    const Pen *hueCursorPen = RenderContext::Pen(Color(255, 255, 255, 255), 2);
+    g.DrawRectangle(hueCursorPen, hueCursorX - 2, hueY - 1, 4, HUE_BAR_HEIGHT + 2);
 
     // Current color preview
     int previewX = svX + SV_SIZE + 8;
     int previewSize = 30;
     float r, gVal, b;
     HSVtoRGB(g_pickerH, g_pickerS, g_pickerV, &r, &gVal, &b);
-    SolidBrush previewBrush(Color(255, (BYTE)(r * 255), (BYTE)(gVal * 255), (BYTE)(b * 255)));
-    g.FillRectangle(&previewBrush, previewX, svY, previewSize, previewSize);
-    g.DrawRectangle(&borderPen, previewX, svY, previewSize - 1, previewSize - 1);
+    const SolidBrush *previewBrush = RenderContext::Brush(Color(255, (BYTE)(r * 255), (BYTE)(gVal * 255), (BYTE)(b * 255)));
+    g.FillRectangle(previewBrush, previewX, svY, previewSize, previewSize);
+    g.DrawRectangle(borderPen, previewX, svY, previewSize - 1, previewSize - 1);
 }
 
 static void ApplyPickerColor() {
@@ -2529,18 +2456,15 @@ static LRESULT CALLBACK ColorPickerWndProc(HWND hwnd, UINT msg, WPARAM wParam, L
 
     switch (msg) {
     case WM_PAINT: {
+        TRACE_SCOPE("paint", "TextUI::DrawColorPicker");
+        PROFILE_SCOPE("paint.text.colorPicker");
         PAINTSTRUCT ps;
         HDC hdc = BeginPaint(hwnd, &ps);
         RECT rect;
         GetClientRect(hwnd, &rect);
-        HDC memDC = CreateCompatibleDC(hdc);
-        HBITMAP memBitmap = CreateCompatibleBitmap(hdc, rect.right, rect.bottom);
-        HGDIOBJ oldBitmap = SelectObject(memDC, memBitmap);
+        HDC memDC = g_colorPickerBackbuffer.Begin(hdc, rect.right, rect.bottom);
         DrawColorPicker(memDC);
-        BitBlt(hdc, 0, 0, rect.right, rect.bottom, memDC, 0, 0, SRCCOPY);
-        SelectObject(memDC, oldBitmap);
-        DeleteObject(memBitmap);
-        DeleteDC(memDC);
+        g_colorPickerBackbuffer.Present(hdc, rect.right, rect.bottom);
         EndPaint(hwnd, &ps);
         return 0;
     }
@@ -2621,14 +2545,15 @@ static LRESULT CALLBACK ColorPickerWndProc(HWND hwnd, UINT msg, WPARAM wParam, L
 
 namespace TextUI {
 
-void Initialize() {}
+bool Initialize() { return true; }
 void Shutdown() {}
 void ShowPanel(int x, int y) { (void)x; (void)y; }
 TextResult HidePanel() { return TextResult(); }
 bool IsVisible() { return false; }
 void UpdateHover(int mouseX, int mouseY) { (void)mouseX; (void)mouseY; }
 TextResult GetResult() { return TextResult(); }
-void SetTextInfo(const wchar_t* jsonInfo) { (void)jsonInfo; }
+void SetTextInfo(std::string_view info) { (void)info; }
+void SetFonts(const CatalogCache::Catalog& catalog) { (void)catalog; }
 bool NeedsRefresh() { return false; }
 void ShowColorPicker(bool forStroke, int x, int y) { (void)forStroke; (void)x; (void)y; }
 void HideColorPicker() {}
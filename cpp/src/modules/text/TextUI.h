@@ -18,6 +18,12 @@
 #ifndef TEXTUI_H
 #define TEXTUI_H
 
+#include <string_view>
+
+namespace CatalogCache {
+class Catalog;
+}
+
 namespace TextUI {
 
 // Drag/Edit target values
@@ -63,7 +69,8 @@ struct TextResult {
 };
 
 // Initialize the Text UI system
-void Initialize();
+// @return false if GDI+ or the window (class) could not be created
+bool Initialize();
 
 // Cleanup
 void Shutdown();
@@ -83,8 +90,12 @@ void UpdateHover(int mouseX, int mouseY);
 // Get the result after panel closes
 TextResult GetResult();
 
-// Set current text info from ExtendScript JSON
-void SetTextInfo(const wchar_t* jsonInfo);
+// Set current text info from the textInfo() wire record (WireFormat::TextField)
+void SetTextInfo(std::string_view info);
+
+// Set the font list (loaded at startup, before the dropdown opens)
+// catalog records: family, style, PostScript name (WireFormat::FontField order)
+void SetFonts(const CatalogCache::Catalog& catalog);
 
 // Refresh request - returns true if refresh is needed, then clears the flag
 bool NeedsRefresh();
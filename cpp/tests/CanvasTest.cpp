@@ -0,0 +1,217 @@
+/*****************************************************************************
+ * CanvasTest.cpp
+ *
+ * Canvas software rasterizer: premultiplied ARGB, clipping, SIMD spans equal
+ * to the scalar blend, anti-aliased lines / rounded rects / ellipses /
+ * outlines / beziers, block copies, the built-in text face, and PNG output
+ * checked by a minimal stored-deflate reader (chunk CRCs, block lengths,
+ * Adler-32).
+ *****************************************************************************/
+
+#include "Canvas.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static uint32_t ReadBigEndian(const uint8_t *p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t PngCrc32(const uint8_t *data, size_t size) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= data[i];
+    for (int k = 0; k < 8; k++)
+      crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+  }
+  return ~crc;
+}
+
+// Minimal PNG reader for Canvas::EncodePng output (stored deflate blocks):
+// RGBA rows, empty if any chunk CRC, block length or Adler-32 is wrong
+static std::vector<uint8_t> DecodeStoredPng(const std::vector<uint8_t> &png, int *width,
+                                            int *height) {
+  static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  std::vector<uint8_t> zlib, rows;
+  if (png.size() < 8 || memcmp(png.data(), SIGNATURE, 8) != 0)
+    return rows;
+  size_t pos = 8;
+  bool ended = false;
+  while (pos + 12 <= png.size() && !ended) {
+    uint32_t length = ReadBigEndian(&png[pos]);
+    if (pos + 12 + length > png.size())
+      return rows;
+    std::string type((const char *)&png[pos + 4], 4);
+    const uint8_t *data = &png[pos + 8];
+    if (PngCrc32(&png[pos + 4], length + 4) != ReadBigEndian(data + length))
+      return rows;
+    if (type == "IHDR") {
+      *width = (int)ReadBigEndian(data);
+      *height = (int)ReadBigEndian(data + 4);
+    } else if (type == "IDAT") {
+      zlib.insert(zlib.end(), data, data + length);
+    } else if (type == "IEND") {
+      ended = true;
+    }
+    pos += 12 + length;
+  }
+  if (!ended || zlib.size() < 6)
+    return rows;
+  size_t z = 2;
+  bool last = false;
+  while (!last && z + 5 <= zlib.size()) {
+    last = (zlib[z] & 1) != 0;
+    if ((zlib[z] & 6) != 0) // Not a stored block
+      return std::vector<uint8_t>();
+    uint32_t size = zlib[z + 1] | (zlib[z + 2] << 8);
+    uint32_t check = zlib[z + 3] | (zlib[z + 4] << 8);
+    if ((size ^ 0xFFFF) != check || z + 5 + size > zlib.size())
+      return std::vector<uint8_t>();
+    rows.insert(rows.end(), zlib.begin() + z + 5, zlib.begin() + z + 5 + size);
+    z += 5 + size;
+  }
+  uint32_t s1 = 1, s2 = 0;
+  for (uint8_t byte : rows) {
+    s1 = (s1 + byte) % 65521;
+    s2 = (s2 + s1) % 65521;
+  }
+  if (!last || z + 4 != zlib.size() || ReadBigEndian(&zlib[z]) != ((s2 << 16) | s1))
+    return std::vector<uint8_t>();
+  return rows;
+}
+
+int main() {
+  printf("Canvas checks\n");
+  using namespace Canvas;
+
+  Check("premultiplied ARGB", Argb(128, 255, 0, 0) == 0x80800000u &&
+                                  Argb(0, 255, 255, 255) == 0 &&
+                                  Argb(255, 1, 2, 3) == 0xFF010203u);
+
+  Surface small(4, 4);
+  FillRect(small, -2, -2, 5, 5, 0xFF0000FFu);
+  Check("rects clipped to the surface",
+        small.At(2, 2) == 0xFF0000FFu && small.At(3, 3) == 0 && small.At(0, 3) == 0);
+
+  // SIMD spans give the scalar pixels (odd widths: vector body + tail)
+  bool sameBlend = true;
+  uint32_t seed = 12345;
+  for (int alpha = 0; alpha <= 255 && sameBlend; alpha += 17) {
+    Surface simd(37, 3), scalar(37, 3);
+    for (int i = 0; i < 37 * 3; i++) {
+      seed = seed * 1103515245u + 12345u;
+      uint32_t a = (seed >> 24) & 0xFF;
+      Pixel p = Argb(a, (seed >> 16) & 0xFF, (seed >> 8) & 0xFF, seed & 0xFF);
+      simd.Data()[i] = p;
+      scalar.Data()[i] = BlendPixel(p, Argb((uint32_t)alpha, 200, 120, 40));
+    }
+    BlendRect(simd, 0, 0, 37, 3, Argb((uint32_t)alpha, 200, 120, 40));
+    sameBlend = memcmp(simd.Data(), scalar.Data(), simd.Bytes()) == 0;
+  }
+  Check(HasSimd() ? "SSE2 blend matches the scalar blend" : "scalar blend (no SSE2)", sameBlend);
+
+  Surface opaque(9, 9), filled(9, 9);
+  BlendRect(opaque, 1, 1, 7, 7, Argb(255, 9, 8, 7));
+  FillRect(filled, 1, 1, 7, 7, Argb(255, 9, 8, 7));
+  Check("opaque blend is a fill", memcmp(opaque.Data(), filled.Data(), opaque.Bytes()) == 0);
+
+  Surface lines(40, 40);
+  DrawLine(lines, 2, 10.5f, 30, 10.5f, 1, 0xFFFFFFFFu);
+  DrawLine(lines, 2, 20, 30, 35, 1.5f, 0xFFFFFFFFu);
+  int partial = 0;
+  for (int y = 0; y < 40; y++) {
+    for (int x = 0; x < 40; x++)
+      partial += (lines.At(x, y) >> 24) > 0 && (lines.At(x, y) >> 24) < 255;
+  }
+  Check("anti-aliased lines: solid core, soft diagonal edges",
+        lines.At(15, 10) == 0xFFFFFFFFu && lines.At(15, 9) == 0 && lines.At(15, 11) == 0 &&
+            partial > 20);
+
+  Surface round(40, 40);
+  FillRoundRect(round, 4, 4, 32, 32, 10, 0xFFFFFFFFu);
+  Check("rounded rect: corners cut, edges and center solid",
+        round.At(4, 4) == 0 && round.At(20, 20) == 0xFFFFFFFFu && round.At(4, 20) == 0xFFFFFFFFu &&
+            (round.At(7, 7) >> 24) > 0);
+
+  Surface disc(40, 40);
+  FillEllipse(disc, 10, 10, 20, 20, 0xFFFFFFFFu);
+  double area = 0;
+  for (int i = 0; i < 40 * 40; i++)
+    area += (disc.Data()[i] >> 24) / 255.0;
+  Check("ellipse area within 1% of pi r^2", fabs(area - 3.14159265 * 100) < 3.14159265);
+
+  Surface ring(40, 40);
+  DrawEllipse(ring, 10, 10, 20, 20, 2, 0xFFFFFFFFu);
+  Check("ellipse outline: on the edge, hollow inside",
+        (ring.At(10, 20) >> 24) > 128 && (ring.At(29, 20) >> 24) > 128 &&
+            (ring.At(20, 10) >> 24) > 128 && ring.At(20, 20) == 0 && ring.At(2, 2) == 0);
+
+  // Copy a block (partly outside the source: transparent there)
+  Surface source(10, 10), block(4, 4);
+  for (int i = 0; i < 100; i++)
+    source.Data()[i] = 0xFF000000u | (uint32_t)i;
+  block.Clear(0xFFFFFFFFu);
+  block.CopyFrom(source, 3, 5);
+  Surface edge(4, 4);
+  edge.Clear(0xFFFFFFFFu);
+  edge.CopyFrom(source, 8, -2);
+  Check("copy: block at (x, y), clipped outside the source",
+        block.At(0, 0) == 0xFF000035u && block.At(3, 3) == 0xFF000056u &&
+            edge.At(0, 0) == 0 && edge.At(0, 2) == 0xFF000008u && edge.At(1, 3) == 0xFF000013u &&
+            edge.At(2, 3) == 0);
+
+  // Half-transparent polyline: overlapping segments must not darken joins
+  Surface curve(60, 60);
+  DrawBezier(curve, 5, 50, 5, 5, 55, 55, 55, 10, 3, Argb(128, 255, 255, 255));
+  uint32_t maxAlpha = 0;
+  for (int i = 0; i < 60 * 60; i++)
+    maxAlpha = std::max(maxAlpha, curve.Data()[i] >> 24);
+  Check("bezier: end points drawn, joins blended once",
+        (curve.At(5, 49) >> 24) > 0 && (curve.At(54, 10) >> 24) > 0 && maxAlpha == 128);
+
+  Surface text(100, 20);
+  float width = MeasureString(L"Abc def", 12);
+  DrawString(text, 2, 2, L"Abc def", 12, 0xFFFFFFFFu);
+  int textRight = -1;
+  for (int y = 0; y < 20; y++) {
+    for (int x = 0; x < 100; x++) {
+      if (text.At(x, y))
+        textRight = std::max(textRight, x);
+    }
+  }
+  Check("software text: advance per character, drawn inside its measure",
+        fabs(width - 7 * 12 * 0.55f) < 0.01f && MeasureString(L"", 12) == 0 && textRight > 2 &&
+            textRight < 2 + width);
+
+  // PNG round trip (straight alpha)
+  Surface image(19, 7);
+  for (int y = 0; y < 7; y++) {
+    for (int x = 0; x < 19; x++)
+      image.Row(y)[x] = Argb((uint32_t)(x * 13 + 10), (uint32_t)(y * 30), 200, (uint32_t)(x * 7));
+  }
+  std::vector<uint8_t> png = EncodePng(image);
+  int pngWidth = 0, pngHeight = 0;
+  std::vector<uint8_t> rows = DecodeStoredPng(png, &pngWidth, &pngHeight);
+  bool roundTrip = pngWidth == 19 && pngHeight == 7 && rows.size() == (size_t)7 * (19 * 4 + 1);
+  for (int y = 0; y < 7 && roundTrip; y++) {
+    roundTrip = rows[(size_t)y * (19 * 4 + 1)] == 0;
+    for (int x = 0; x < 19 && roundTrip; x++) {
+      const uint8_t *p = &rows[(size_t)y * (19 * 4 + 1) + 1 + x * 4];
+      // Straight -> premultiplied gives the original pixel back
+      roundTrip = Argb(p[3], p[0], p[1], p[2]) == image.At(x, y);
+    }
+  }
+  Check("PNG: valid chunks / zlib, pixels round-trip", roundTrip);
+
+  Surface large(300, 300); // > 65535 bytes: several stored blocks
+  large.Clear(Argb(255, 1, 2, 3));
+  std::vector<uint8_t> largeRows = DecodeStoredPng(EncodePng(large), &pngWidth, &pngHeight);
+  Check("PNG: multi-block stream", largeRows.size() == (size_t)300 * (300 * 4 + 1) &&
+                                        largeRows[1] == 1 && largeRows[4] == 255);
+  return TestResult();
+}
@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * CatalogCacheTest.cpp
+ *
+ * CatalogCache: round-trip, string interning, field bounds, key match,
+ * mapped cache files, damaged files rejected, and a 5,000-effect catalog
+ * read back from the mapped cache.
+ *****************************************************************************/
+
+#include "CatalogCache.h"
+#include "EffectFixtures.h"
+#include "TestCheck.h"
+#include "WireFormat.h"
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static void CheckRoundTrip(const fs::path &dir) {
+  fs::path file = dir / "effects-catalog.bin";
+  CatalogCache::Key key;
+  key.hostBuild = "25.0x52";
+  key.language = "ko_KR";
+  key.fingerprint = 0x1234;
+
+  std::string wire;
+  WireFormat::Writer writer(wire);
+  static const char *const kRows[][3] = {
+      {"Gaussian Blur", "ADBE Gaussian Blur 2", "Blur & Sharpen"},
+      {"\xEB\xB8\x94\xEB\x9F\xAC|;", "ADBE Box Blur2", "Blur & Sharpen"},
+      {"\xF0\x9F\x8E\xA8 Glow", "ADBE Glo2", ""},
+  };
+  for (const auto &row : kRows) {
+    writer.BeginRecord(3);
+    writer.String(row[0]);
+    writer.String(row[1]);
+    writer.String(row[2]);
+  }
+  CatalogCache::Builder builder(WireFormat::EFFECT_FIELD_COUNT);
+  bool ok = builder.AddFromWire(wire) == 3;
+  std::vector<uint8_t> image = builder.Finish(key);
+
+  CatalogCache::Catalog catalog;
+  ok = ok && catalog.Adopt(image) && catalog.RecordCount() == 3 &&
+       catalog.FieldCount() == 3;
+  ok = ok && catalog.Field(0, 0) == u"Gaussian Blur" &&
+       catalog.Field(1, 0) == u"\uBE14\uB7EC|;" &&
+       catalog.Field(2, 0) == u"\U0001F3A8 Glow" &&
+       catalog.Field(2, 2).empty() && catalog.Field(3, 0).empty() &&
+       catalog.Field(0, 3).empty();
+  // "Blur & Sharpen" is stored once
+  ok = ok && catalog.Field(0, 2).data() == catalog.Field(1, 2).data();
+  wchar_t small[3];
+  size_t n = catalog.FieldInto(2, 0, small, 3);
+  ok = ok && (sizeof(wchar_t) == 2 ? n == 0 : n == 2);
+  Check("round-trip / interning / bounds", ok);
+
+  CatalogCache::Key other = key;
+  bool keyOk = catalog.Matches(key, true);
+  other.fingerprint = 1;
+  keyOk = keyOk && catalog.Matches(other, false) && !catalog.Matches(other, true);
+  other.language = "en_US";
+  keyOk = keyOk && !catalog.Matches(other, false);
+  Check("key match (build, language, fingerprint)", keyOk);
+
+  bool fileOk = CatalogCache::WriteFile(file, image.data(), image.size());
+  CatalogCache::Catalog mapped;
+  fileOk = fileOk && mapped.Open(file) && mapped.IsMapped() &&
+           mapped.Field(1, 1) == u"ADBE Box Blur2" && mapped.Matches(key, true);
+  mapped.Close();
+
+  // Damaged files are rejected, never read out of range
+  std::vector<uint8_t> truncated(image.begin(), image.end() - 2);
+  CatalogCache::WriteFile(file, truncated.data(), truncated.size());
+  fileOk = fileOk && !mapped.Open(file);
+  std::vector<uint8_t> badRef = image;
+  uint32_t huge = 0x7FFFFFFF;
+  memcpy(badRef.data() + 64, &huge, sizeof(huge));
+  fileOk = fileOk && mapped.Adopt(badRef) && mapped.Field(0, 0).empty();
+  fileOk = fileOk && !mapped.Open(dir / "missing.bin");
+  Check("mapped file / damaged file rejected", fileOk);
+}
+
+static void CheckLargeCatalog(const fs::path &dir) {
+  fs::path file = dir / "effects-catalog.bin";
+  CatalogCache::Key key;
+  key.hostBuild = "25.0x52";
+  key.language = "ko_KR";
+
+  // effectsList() result -> catalog -> cache file -> mapped -> ControlUI items
+  CatalogCache::Builder builder(WireFormat::EFFECT_FIELD_COUNT);
+  bool ok = builder.AddFromWire(EffectsWire(5000)) == 5000;
+  CatalogCache::Catalog built;
+  ok = ok && built.Adopt(builder.Finish(key)) &&
+       CatalogCache::WriteFile(file, built.Data(), built.Size());
+  CatalogCache::Catalog mapped;
+  std::vector<FixtureEffectItem> items;
+  ok = ok && mapped.Open(file) && mapped.Matches(key, false);
+  CopyEffects(mapped, items);
+  Check("5,000 effects from the mapped cache",
+        ok && items.size() == 5000 && items[4999].index == 4999 &&
+            wcscmp(items[4999].matchName, L"ADBE Effect 4999") == 0);
+}
+
+int main() {
+  printf("CatalogCache checks\n");
+  std::error_code ec;
+  fs::path dir = fs::temp_directory_path(ec) / "AnchorSnapTests.CatalogCache";
+  CheckRoundTrip(dir);
+  CheckLargeCatalog(dir);
+  fs::remove_all(dir, ec);
+  return TestResult();
+}
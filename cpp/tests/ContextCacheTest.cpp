@@ -0,0 +1,94 @@
+/*****************************************************************************
+ * ContextCacheTest.cpp
+ *
+ * ContextCache: selectionContext() parsing (viewer gating, layer kinds,
+ * malformed input, caps), hit / refresh / invalidate accounting against a
+ * mock query, failed refresh, and script calls over a trigger session.
+ *****************************************************************************/
+
+#include "ContextCache.h"
+#include "ContextFixtures.h"
+#include "TestCheck.h"
+
+#include <string>
+#include <vector>
+
+int main() {
+  printf("ContextCache checks\n");
+  using namespace ContextCache;
+
+  Snapshot snapshot;
+  bool ok = Parse(ContextWire(7, VIEWER_COMPOSITION, false, {LAYER_SHAPE, LAYER_TEXT}),
+                  snapshot) &&
+            snapshot.compId == 7 && snapshot.selectedCount == 2 &&
+            snapshot.layers.size() == 2 && snapshot.layers[1].id == 101 &&
+            snapshot.HasSelectedLayers() && snapshot.HasSelected(LAYER_TEXT) &&
+            snapshot.FirstSelectedIs(LAYER_SHAPE) && !snapshot.HasSelected(LAYER_CAMERA);
+  Check("parse selection context", ok);
+
+  ok = Parse(ContextWire(7, VIEWER_EFFECT_CONTROLS, true, {LAYER_AV}), snapshot) &&
+       snapshot.HasSelection() && !snapshot.HasSelectedLayers() && snapshot.textTool;
+  ok = ok && Parse(ContextWire(0, VIEWER_OTHER, false, {}), snapshot) &&
+       !snapshot.HasSelection();
+  ok = ok && !Parse("", snapshot) && !Parse("R1:i7", snapshot) &&
+       !Parse(ContextWire(7, 1, false, {1}).substr(0, 20), snapshot) &&
+       !snapshot.HasSelection();
+  Check("viewer gating, empty comp and malformed input", ok);
+
+  std::vector<int> many(MAX_LAYERS + 10, LAYER_AV);
+  ok = Parse(ContextWire(3, VIEWER_COMPOSITION, false, many), snapshot) &&
+       snapshot.layers.size() == MAX_LAYERS &&
+       snapshot.selectedCount == (int)many.size();
+  ok = ok && Parse(ContextWire(3, 42, false, {42}), snapshot) &&
+       snapshot.viewer == VIEWER_OTHER && snapshot.layers[0].kind == LAYER_AV;
+  Check("layer list capped, unknown codes clamped", ok);
+
+  MockContextHost host;
+  host.wire = ContextWire(7, VIEWER_COMPOSITION, false, {LAYER_TEXT});
+  SetQuery(MockContextQuery, &host);
+  ResetStats();
+  ok = Get().HasSelected(LAYER_TEXT) && Get().HasSelectedLayers() && host.calls == 1;
+  Invalidate();
+  Invalidate(); // Already stale: not counted twice
+  host.wire = ContextWire(7, VIEWER_COMPOSITION, false, {});
+  ok = ok && !Get().HasSelection() && host.calls == 2;
+  Stats stats = GetStats();
+  ok = ok && stats.lookups == 3 && stats.hits == 1 && stats.refreshes == 2 &&
+       stats.invalidations == 1 && stats.failures == 0;
+  Check("hits, refreshes and invalidations", ok);
+
+  host.fail = true;
+  Invalidate();
+  ok = !Get().HasSelection() && !IsValid();
+  host.fail = false;
+  host.wire = ContextWire(7, VIEWER_LAYER, false, {LAYER_SHAPE});
+  ok = ok && Get().FirstSelectedIs(LAYER_SHAPE) && IsValid() &&
+       GetStats().failures == 1;
+  Check("failed refresh is empty and retried", ok);
+
+  // Simulated session: trigger gates (Y, Shift+E, D menu with up to two
+  // reads) between menu-update bursts. The old code probed once per gate.
+  ResetStats();
+  host.calls = 0;
+  Invalidate();
+  const int triggers = 10000;
+  int probes = 0;
+  for (int i = 0; i < triggers; i++) {
+    if (i % 4 == 0)
+      Invalidate(); // User changed the selection between triggers
+    int reads = (i % 3 == 2) ? 2 : 1; // D menu: panel gate + info gate
+    for (int r = 0; r < reads; r++) {
+      Get();
+      probes++;
+    }
+  }
+  SetQuery(nullptr, nullptr);
+  stats = GetStats();
+  Check("one script call per invalidation burst",
+        host.calls == triggers / 4 && stats.refreshes == (uint64_t)host.calls &&
+            stats.hits == (uint64_t)(probes - host.calls));
+  printf("  %d gate reads: %d script calls before, %d now\n", probes, probes,
+         host.calls);
+  printf("  %s\n", FormatStats().c_str());
+  return TestResult();
+}
@@ -0,0 +1,116 @@
+/*****************************************************************************
+ * ContextFixtures.h
+ *
+ * Library results shared by the ContextCache / PanelPrefetch tests and
+ * tools/ScriptBench: selectionContext(), the per-panel info records and
+ * panelSnapshot(), plus a mock query that counts host round-trips.
+ *****************************************************************************/
+
+#pragma once
+
+#include "ContextCache.h"
+#include "EaseModel.h"
+#include "WireFormat.h"
+
+#include <string>
+#include <vector>
+
+struct MockContextHost {
+  std::string wire;
+  bool fail = false;
+  int calls = 0;
+};
+
+// ContextCache / PanelPrefetch query against the mock
+inline bool MockContextQuery(std::string &wire, void *context) {
+  MockContextHost *host = (MockContextHost *)context;
+  host->calls++;
+  if (host->fail)
+    return false;
+  wire = host->wire;
+  return true;
+}
+
+// selectionContext() result: header + one record per selected layer
+inline std::string ContextWire(int compId, int viewer, bool textTool,
+                               const std::vector<int> &kinds) {
+  std::string wire;
+  WireFormat::Writer writer(wire);
+  writer.BeginRecord(WireFormat::CONTEXT_FIELD_COUNT);
+  writer.Int(compId);
+  writer.Int(viewer);
+  writer.Bool(textTool);
+  writer.Int((int)kinds.size());
+  for (size_t i = 0; i < kinds.size(); i++) {
+    writer.BeginRecord(WireFormat::SELECTED_FIELD_COUNT);
+    writer.Int((int)i + 1);
+    writer.Int(100 + (int)i);
+    writer.Int(kinds[i]);
+  }
+  return wire;
+}
+
+// Info records as the library returns them (text, shape, keyframe, layer)
+inline std::string PanelRecord(WireFormat::PanelField field) {
+  std::string wire;
+  WireFormat::Writer writer(wire);
+  switch (field) {
+  case WireFormat::PANEL_TEXT:
+    writer.BeginRecord(16);
+    writer.String("Arial");
+    writer.String("Regular");
+    for (int i = 0; i < 10; i++)
+      writer.Fixed(i * 1.5);
+    writer.Bool(true);
+    writer.Bool(false);
+    writer.Int(0);
+    writer.String("\xEC\xA0\x9C\xEB\xAA\xA9 |;");
+    break;
+  case WireFormat::PANEL_SHAPE:
+    writer.BeginRecord(24);
+    writer.String("Shape Layer 1");
+    writer.String("Rectangle 1");
+    writer.String("Rectangle");
+    for (int i = 0; i < 21; i++)
+      writer.Fixed(i * 0.25);
+    break;
+  case WireFormat::PANEL_KEYFRAME:
+    writer.BeginRecord(WireFormat::KEY_PROP_FIELD_COUNT);
+    writer.String("Position");
+    writer.String("ADBE Position");
+    writer.Int(0);
+    writer.Int(1);
+    writer.Int(2);
+    for (int k = 0; k < 2; k++) {
+      writer.BeginRecord(WireFormat::KEY_DIMENSION + WireFormat::KEY_DIM_FIELD_COUNT);
+      writer.Int(k + 1);
+      writer.Double(k);
+      writer.Int(EaseModel::INTERP_BEZIER);
+      writer.Int(EaseModel::INTERP_BEZIER);
+      for (double v : {k ? 0.0 : 100.0, 0.0, 33.33, 0.0, 33.33})
+        writer.Double(v);
+    }
+    break;
+  case WireFormat::PANEL_LAYER:
+    writer.BeginRecord(9);
+    writer.String("Text \"A\"");
+    for (int i = 0; i < 8; i++)
+      writer.Int(i);
+    break;
+  default:
+    break;
+  }
+  return wire;
+}
+
+// panelSnapshot() result: the selection context, then every panel record
+inline std::string PanelSnapshotWire() {
+  std::string wire;
+  WireFormat::Writer writer(wire);
+  writer.BeginRecord(WireFormat::PANEL_FIELD_COUNT);
+  writer.String(ContextWire(7, ContextCache::VIEWER_COMPOSITION, false,
+                            {ContextCache::LAYER_TEXT}));
+  for (int f = WireFormat::PANEL_TEXT; f < WireFormat::PANEL_FIELD_COUNT; f++)
+    writer.String(PanelRecord((WireFormat::PanelField)f));
+  return wire;
+}
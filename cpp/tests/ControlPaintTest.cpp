@@ -0,0 +1,90 @@
+/*****************************************************************************
+ * ControlPaintTest.cpp
+ *
+ * ControlPaint: translucent panel background and border, selected / hovered
+ * rows, the border following the scale, an empty list drawing no rows, and
+ * the preset / save icon slots handed back to ControlUI.
+ *****************************************************************************/
+
+#include "ControlPaint.h"
+#include "TestCheck.h"
+
+#include <cwchar>
+#include <vector>
+
+static ControlUI::EffectItem MakeItem(const wchar_t *name, const wchar_t *category, int index) {
+  ControlUI::EffectItem item = {};
+  wcsncpy(item.name, name, 127);
+  wcsncpy(item.category, category, 63);
+  item.index = index;
+  return item;
+}
+
+int main() {
+  using namespace ControlPaint;
+  using Canvas::Argb;
+  printf("ControlPaint\n");
+
+  std::vector<ControlUI::EffectItem> results = {
+      MakeItem(L"Gaussian Blur", L"Blur & Sharpen", 0),
+      MakeItem(L"Glow", L"Stylize", 1),
+      MakeItem(L"Curves", L"Color Correction", 2),
+  };
+  int listY = PADDING + SEARCH_HEIGHT + PADDING;  // First row (base units)
+  int height = listY + (int)results.size() * ITEM_HEIGHT + PADDING;
+
+  // Mode 1 at scale 1.0
+  PanelState state;
+  state.query = L"bl";
+  state.searchResults = &results;
+  state.selectedIndex = 0;
+  state.hoverIndex = 1;
+  Canvas::Surface surface;
+  surface.Resize(WINDOW_WIDTH, height);
+  DrawSearchPanel(surface, state);
+  Check("translucent background, opaque border",
+        (surface.At(4, 4) >> 24) == 240 && surface.At(0, 0) == Argb(255, 60, 60, 70) &&
+            surface.At(WINDOW_WIDTH - 1, height - 1) == Argb(255, 60, 60, 70));
+  Check("selected row", surface.At(PADDING + 1, listY + 1) == Argb(255, 74, 158, 255));
+  Check("hovered row",
+        surface.At(PADDING + 1, listY + ITEM_HEIGHT + 1) == Argb(255, 60, 80, 100));
+  Check("other rows on the background",
+        surface.At(PADDING + 1, listY + ITEM_HEIGHT * 2 + 1) == surface.At(4, 4));
+
+  // Empty list: no row highlight
+  PanelState empty = state;
+  empty.query = L"";
+  empty.searchResults = nullptr;
+  surface.Resize(WINDOW_WIDTH, height);  // ControlUI resizes (clears) every paint
+  DrawSearchPanel(surface, empty);
+  Check("empty list: no rows", surface.At(PADDING + 1, listY + 1) == surface.At(4, 4));
+
+  // Scale 1.5: the 1-unit border is 2 px
+  PanelState scaled = state;
+  scaled.scale = 1.5f;
+  Canvas::Surface large;
+  large.Resize((int)(WINDOW_WIDTH * 1.5f), (int)(height * 1.5f));
+  DrawSearchPanel(large, scaled);
+  Check("scale 1.5: border and rows scaled",
+        large.At(1, 1) == Argb(255, 60, 60, 70) && (large.At(2, 2) >> 24) == 240 &&
+            large.At(PADDING * 3 / 2 + 1, listY * 3 / 2 + 1) == Argb(255, 74, 158, 255));
+
+  // Mode 2: icon slots for the filled presets, then the save button
+  PresetIcon presets[PRESET_SLOT_COUNT] = {ICON_BLUR, ICON_NONE, ICON_STAR,
+                                           ICON_NONE, ICON_NONE, ICON_NONE};
+  PanelState effects;
+  effects.mode = ControlUI::MODE_EFFECTS;
+  effects.layerName = L"Shape Layer 1";
+  effects.labelColor = 8;
+  effects.layerEffects = &results;
+  effects.presetIcons = presets;
+  effects.saveHover = true;
+  IconSlot icons[PRESET_SLOT_COUNT + 1];
+  surface.Resize(WINDOW_WIDTH, 400);
+  int count = DrawEffectsPanel(surface, effects, icons);
+  Check("filled presets + save slot",
+        count == 3 && icons[0].icon == ICON_BLUR && icons[1].icon == ICON_STAR &&
+            icons[0].x < icons[1].x && icons[2].icon == ICON_COUNT && icons[2].on);
+  Check("save slot right of the presets", icons[2].x > icons[1].x + icons[1].size);
+  return TestResult();
+}
@@ -0,0 +1,53 @@
+/*****************************************************************************
+ * CurveFixtures.h
+ *
+ * Deterministic random curves and AE ease pairs shared by the keyframe
+ * tests (CurveMath / EaseModel / KeyframeSelection) and tools/ScriptBench.
+ *****************************************************************************/
+
+#pragma once
+
+#include "CurveMath.h"
+#include "EaseModel.h"
+
+#include <cmath>
+#include <cstdint>
+
+// Deterministic [0, 1) values (xorshift)
+inline float NextUnit(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+// Timing curve with handles inside x in [0, 1], y in [-0.5, 1.5)
+inline CurveMath::Cubic RandomTiming(uint32_t &rng) {
+  return CurveMath::TimingCubic(NextUnit(rng), NextUnit(rng) * 2 - 0.5f, NextUnit(rng),
+                                NextUnit(rng) * 2 - 0.5f);
+}
+
+// Slope (speed / average): easy ease, linear, typical and extreme values
+inline double RandomSlope(uint32_t &rng) {
+  float u = NextUnit(rng);
+  if (u < 0.1f)
+    return 0.0;
+  if (u < 0.2f)
+    return 1.0;
+  if (u < 0.3f)
+    return std::pow(10.0, NextUnit(rng) * 6.0 - 3.0) * (NextUnit(rng) < 0.5f ? -1.0 : 1.0);
+  return NextUnit(rng) * 9.0 - 3.0 + NextUnit(rng) * 1e-6;
+}
+
+// Bezier pair: duration 1/120 s .. 600 s, |delta| 1e-3 .. 1e5, either sign
+inline EaseModel::Segment RandomSegment(uint32_t &rng) {
+  EaseModel::Segment seg;
+  seg.duration = std::pow(10.0, NextUnit(rng) * 4.86 - 2.08);
+  double magnitude = std::pow(10.0, NextUnit(rng) * 8.0 - 3.0);
+  seg.delta = NextUnit(rng) < 0.5f ? -magnitude : magnitude;
+  seg.outType = seg.inType = EaseModel::INTERP_BEZIER;
+  double average = seg.delta / seg.duration;
+  seg.out = {RandomSlope(rng) * average, 0.1 + NextUnit(rng) * 99.9};
+  seg.in = {RandomSlope(rng) * average, 0.1 + NextUnit(rng) * 99.9};
+  return seg;
+}
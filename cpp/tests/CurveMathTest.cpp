@@ -0,0 +1,212 @@
+/*****************************************************************************
+ * CurveMathTest.cpp
+ *
+ * CurveMath against double / long double references: Eval and the SIMD
+ * batch, adaptive flattening within tolerance, x -> t -> y solving, the
+ * exact area over time, end / peak slopes.
+ *****************************************************************************/
+
+#include "CurveFixtures.h"
+#include "CurveMath.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Distance from (px, py) to segment a-b
+static double SegmentDistance(double px, double py, double ax, double ay, double bx, double by) {
+  double dx = bx - ax, dy = by - ay;
+  double len2 = dx * dx + dy * dy;
+  double u = len2 > 0 ? ((px - ax) * dx + (py - ay) * dy) / len2 : 0.0;
+  u = std::max(0.0, std::min(1.0, u));
+  double ex = ax + u * dx - px, ey = ay + u * dy - py;
+  return std::sqrt(ex * ex + ey * ey);
+}
+
+// High-precision references: bisection / power basis in long double
+struct RefCurve {
+  long double ax, bx, cx, ay, by, cy;
+  explicit RefCurve(const CurveMath::Cubic &c) {
+    ax = -(long double)c.x0 + 3.0L * c.x1 - 3.0L * c.x2 + c.x3;
+    bx = 3.0L * c.x0 - 6.0L * c.x1 + 3.0L * c.x2;
+    cx = -3.0L * c.x0 + 3.0L * c.x1;
+    ay = -(long double)c.y0 + 3.0L * c.y1 - 3.0L * c.y2 + c.y3;
+    by = 3.0L * c.y0 - 6.0L * c.y1 + 3.0L * c.y2;
+    cy = -3.0L * c.y0 + 3.0L * c.y1;
+  }
+  long double X(long double t) const { return ((ax * t + bx) * t + cx) * t; }
+  long double Y(long double t) const { return ((ay * t + by) * t + cy) * t; }
+  long double DX(long double t) const { return (3.0L * ax * t + 2.0L * bx) * t + cx; }
+  long double Solve(long double x) const {
+    long double lo = 0, hi = 1;
+    for (int i = 0; i < 80; i++) {
+      long double mid = (lo + hi) / 2;
+      (X(mid) < x ? lo : hi) = mid;
+    }
+    return (lo + hi) / 2;
+  }
+  // Integral of y x'(t) dt over [0, T], composite Simpson
+  long double AreaT(long double T, int intervals) const {
+    long double h = T / intervals, sum = 0;
+    for (int i = 0; i <= intervals; i++) {
+      long double t = i * h, f = Y(t) * DX(t);
+      sum += (i == 0 || i == intervals) ? f : (i % 2 ? 4 * f : 2 * f);
+    }
+    return sum * h / 3;
+  }
+};
+
+static void CheckTessellation() {
+  using namespace CurveMath;
+
+  // Eval against the Bernstein form in double
+  uint32_t rng = 0x9E3779B9u;
+  double worstEval = 0;
+  for (int n = 0; n < 1000; n++) {
+    Cubic c = {NextUnit(rng) * 300, NextUnit(rng) * 200, NextUnit(rng) * 300, NextUnit(rng) * 200,
+               NextUnit(rng) * 300, NextUnit(rng) * 200, NextUnit(rng) * 300, NextUnit(rng) * 200};
+    double t = NextUnit(rng), u = 1 - t;
+    double rx = u * u * u * c.x0 + 3 * u * u * t * c.x1 + 3 * u * t * t * c.x2 + t * t * t * c.x3;
+    double ry = u * u * u * c.y0 + 3 * u * u * t * c.y1 + 3 * u * t * t * c.y2 + t * t * t * c.y3;
+    Point p = Eval(c, (float)t);
+    worstEval = std::max(worstEval, std::max(std::fabs(p.x - rx), std::fabs(p.y - ry)));
+  }
+  Check("Eval matches the Bernstein form (< 0.001 px on 300 px)", worstEval < 1e-3);
+
+  // Batch: SIMD lanes + scalar tail give the scalar results
+  Cubic ease = {0, 160, 105, 160, 151, 0, 260, 0};
+  float t[37], x[2][37], y[2][37];
+  for (int i = 0; i < 37; i++)
+    t[i] = i / 36.0f;
+  for (int pass = 0; pass < 2; pass++) {
+    SetSimdEnabled(pass == 0);
+    EvalBatch(ease, t, 37, x[pass], y[pass]);
+  }
+  SetSimdEnabled(true);
+  bool same = memcmp(x[0], x[1], sizeof(x[0])) == 0 && memcmp(y[0], y[1], sizeof(y[0])) == 0;
+  Point mid = Eval(ease, t[13]);
+  Check("EvalBatch SIMD == scalar == Eval", same && x[0][13] == mid.x && y[0][13] == mid.y);
+
+  // Flatness: every point of the curve within tolerance of its chord
+  const float tolerance = 0.25f;
+  double worstChord = 0;
+  for (int n = 0; n < 300; n++) {
+    Cubic c = {NextUnit(rng) * 300, NextUnit(rng) * 200, NextUnit(rng) * 300, NextUnit(rng) * 200,
+               NextUnit(rng) * 300, NextUnit(rng) * 200, NextUnit(rng) * 300, NextUnit(rng) * 200};
+    std::vector<Point> points;
+    Flatten(c, tolerance, points);
+    int segments = (int)points.size() - 1;
+    for (int i = 0; i < segments; i++) {
+      for (int k = 1; k < 8; k++) {
+        double tt = (i + k / 8.0) / segments, u = 1 - tt;
+        double px = u * u * u * c.x0 + 3 * u * u * tt * c.x1 + 3 * u * tt * tt * c.x2 + tt * tt * tt * c.x3;
+        double py = u * u * u * c.y0 + 3 * u * u * tt * c.y1 + 3 * u * tt * tt * c.y2 + tt * tt * tt * c.y3;
+        worstChord = std::max(worstChord, SegmentDistance(px, py, points[i].x, points[i].y,
+                                                          points[i + 1].x, points[i + 1].y));
+      }
+    }
+    if (points.front().x != c.x0 || points.back().y != c.y3)
+      worstChord = 1e9;
+  }
+  printf("  worst chord error %.3f px (tolerance %.2f)\n", worstChord, tolerance);
+  Check("flattened curves stay within tolerance, exact endpoints", worstChord <= tolerance + 1e-3);
+
+  Cubic line = {0, 0, 10, 10, 20, 20, 30, 30};
+  Cubic thumb = {4, 40, 4 + 0.42f * 36, 40, 4 + 0.58f * 36, 4, 40, 4};
+  int graphSegments = FlattenSegments(ease, tolerance);
+  int thumbSegments = FlattenSegments(thumb, tolerance);
+  printf("  segments: 260x160 ease graph %d (was 50), 36 px thumbnail %d (was 20)\n",
+         graphSegments, thumbSegments);
+  Check("segment count follows curvature", FlattenSegments(line, tolerance) == 1 &&
+                                               thumbSegments < graphSegments &&
+                                               FlattenSegments(ease, tolerance / 4) > graphSegments);
+}
+
+static void CheckTiming() {
+  using namespace CurveMath;
+
+  // x -> t -> y against long double bisection
+  uint32_t rng = 0x2545F491u;
+  double worstResidual = 0, worstValue = 0;
+  for (int n = 0; n < 20000; n++) {
+    Cubic c = RandomTiming(rng);
+    if (n % 10 == 0)
+      c.x1 = 0; // Zero out influence: x'(0) = 0
+    float x = NextUnit(rng);
+    RefCurve ref(c);
+    float t = SolveT(c, x);
+    worstResidual = std::max(worstResidual, (double)std::fabs(ref.X(t) - (long double)x));
+    long double tr = ref.Solve(x);
+    double slope = std::fabs((double)SlopeAt(c, x));
+    double err = (double)std::fabs((long double)ValueAt(c, x) - ref.Y(tr));
+    worstValue = std::max(worstValue, err / std::max(1.0, std::min(slope, 1e6)));
+  }
+  printf("  x->t: worst |x(t) - x| %.2e, worst value error %.2e (per unit slope)\n",
+         worstResidual, worstValue);
+  Check("SolveT residual <= 1e-6 (float evaluation)", worstResidual <= 1e-6);
+  Check("ValueAt within 1e-5 of the long double reference", worstValue <= 1e-5);
+
+  // Batch lanes == scalar bit for bit (SSE2 bodies + scalar tails)
+  bool same = true;
+  for (int count = 1; count <= 37 && same; count++) {
+    Cubic c = RandomTiming(rng);
+    float x[37], y[2][37];
+    for (int i = 0; i < count; i++)
+      x[i] = NextUnit(rng);
+    for (int pass = 0; pass < 2; pass++) {
+      SetSimdEnabled(pass == 0);
+      ValueAtBatch(c, x, count, y[pass]);
+    }
+    same = memcmp(y[0], y[1], count * sizeof(float)) == 0 && y[1][count - 1] == ValueAt(c, x[count - 1]);
+  }
+  SetSimdEnabled(true);
+  Check("ValueAtBatch SIMD == scalar == ValueAt", same);
+
+  // Exact integral vs Simpson on y(t) x'(t) in long double
+  double worstArea = 0;
+  for (int n = 0; n < 2000; n++) {
+    Cubic c = RandomTiming(rng);
+    float x = NextUnit(rng);
+    RefCurve ref(c);
+    long double area = ref.AreaT(ref.Solve(x), 2000);
+    worstArea = std::max(worstArea, (double)std::fabs((long double)Integral(c, x) - area));
+  }
+  Cubic linear = TimingCubic(1 / 3.0f, 1 / 3.0f, 2 / 3.0f, 2 / 3.0f);
+  Cubic inOut = TimingCubic(0.42f, 0.0f, 0.58f, 1.0f);
+  Cubic easeIn = TimingCubic(0.42f, 0.0f, 1.0f, 1.0f);
+  printf("  integral: worst error %.2e vs long double Simpson\n", worstArea);
+  Check("Integral within 1e-6 of the reference", worstArea <= 1e-6);
+  Check("Integral: linear 0.5, symmetric in-out 0.5, 0 at 0",
+        std::fabs(Integral(linear, 1.0f) - 0.5) < 1e-6 &&
+            std::fabs(Integral(inOut, 1.0f) - 0.5) < 1e-6 && Integral(inOut, 0.0f) == 0.0);
+
+  // Area over time, not over t: Simpson in x through the reference inverse
+  RefCurve ref(easeIn);
+  long double overX = 0, hx = 1.0L / 2000;
+  for (int i = 0; i <= 2000; i++) {
+    long double f = ref.Y(ref.Solve(i * hx));
+    overX += (i == 0 || i == 2000) ? f : (i % 2 ? 4 * f : 2 * f);
+  }
+  overX *= hx / 3;
+  printf("  ease-in area over time: exact %.6f, reference %.6f\n", Integral(easeIn, 1.0f),
+         (double)overX);
+  Check("Integral is the area over time", std::fabs(Integral(easeIn, 1.0f) - (double)overX) < 1e-6);
+
+  Check("end slopes: P1.y / P1.x and (1 - P2.y) / (1 - P2.x)",
+        std::fabs(SlopeAt(easeIn, 0.0f)) < 1e-6 && std::fabs(SlopeAt(inOut, 1.0f)) < 1e-6 &&
+            std::fabs(SlopeAt(linear, 0.5f) - 1.0f) < 1e-5);
+  float peakX = 0;
+  float peak = PeakSlope(inOut, &peakX);
+  Check("peak velocity of a symmetric in-out at half time",
+        peak > 1.5f && std::fabs(peakX - 0.5f) < 0.01f);
+}
+
+int main() {
+  printf("CurveMath checks (%s)\n", CurveMath::SimdName());
+  CheckTessellation();
+  CheckTiming();
+  return TestResult();
+}
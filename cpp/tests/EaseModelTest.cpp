@@ -0,0 +1,137 @@
+/*****************************************************************************
+ * EaseModelTest.cpp
+ *
+ * EaseModel over 1M random AE ease pairs: AE -> handles -> AE round trip,
+ * handles stable under repeated load -> apply, falling == rising, edited
+ * handles survive bit for bit, value / time scale independence, and flat,
+ * hold and linear segments.
+ *****************************************************************************/
+
+#include "CurveFixtures.h"
+#include "EaseModel.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+int main() {
+  printf("EaseModel checks\n");
+  using namespace EaseModel;
+
+  // Round trip AE -> handles -> AE over random pairs. Errors are measured
+  // where AE draws them: handle height in the value graph (speed *
+  // influence * duration) relative to the value change, or to the handle
+  // height itself for handles beyond it (float handles). A small in
+  // influence has few bits in x2 = 1 - influence: influence and speed
+  // then trade a little precision while the handle stays in place
+  const int tuples = 1000000;
+  uint32_t rng = 0x9E3779B9u;
+  double worstHandle = 0, worstInfluence = 0, worstOutSpeed = 0;
+  int unstable = 0, asymmetric = 0;
+  for (int n = 0; n < tuples; n++) {
+    Segment seg = RandomSegment(rng);
+    Handles handles;
+    ToHandles(seg, handles);
+
+    // Eases must come from the handles: start from other speeds
+    Segment other = seg;
+    other.out = {seg.out.speed * 3 + 1, 50};
+    other.in = {-seg.in.speed, 50};
+    Segment back = FromHandles(other, handles);
+    double average = std::fabs(seg.delta / seg.duration);
+    double outX = seg.out.influence / 100, inX = seg.in.influence / 100;
+    double outX2 = back.out.influence / 100, inX2 = back.in.influence / 100;
+    double outY = std::fabs(back.out.speed * outX2 - seg.out.speed * outX) / average;
+    double inY = std::fabs(back.in.speed * inX2 - seg.in.speed * inX) / average;
+    worstHandle = std::max(worstHandle, outY / std::max(1.0f, std::fabs(handles.y1)));
+    worstHandle = std::max(worstHandle, inY / std::max(1.0f, std::fabs(handles.y2)));
+    worstInfluence = std::max(worstInfluence, std::max(std::fabs(back.out.influence - seg.out.influence),
+                                                       std::fabs(back.in.influence - seg.in.influence)));
+    if (seg.out.speed != 0)
+      worstOutSpeed = std::max(worstOutSpeed, std::fabs(back.out.speed / seg.out.speed - 1));
+
+    // Load -> apply -> load: the handles never drift
+    Handles again;
+    ToHandles(back, again);
+    if (!(again == handles))
+      unstable++;
+
+    // A falling property has the same curve as a rising one
+    Segment negated = seg;
+    negated.delta = -seg.delta;
+    negated.out.speed = -seg.out.speed;
+    negated.in.speed = -seg.in.speed;
+    ToHandles(negated, again);
+    if (!(again == handles))
+      asymmetric++;
+  }
+  printf("  %d random pairs: worst handle error %.2e, influence %.2e %%, out speed "
+         "%.2e relative\n",
+         tuples, worstHandle, worstInfluence, worstOutSpeed);
+  Check("round trip: handle error <= 1e-6, influence <= 1e-5 %",
+        worstHandle <= 1e-6 && worstInfluence <= 1e-5);
+  Check("round trip: out speed within 1e-6 relative", worstOutSpeed <= 1e-6);
+  Check("handles stable under repeated load -> apply", unstable == 0);
+  Check("falling and rising pairs give the same curve", asymmetric == 0);
+
+  // Curve edits: FromHandles -> ToHandles returns the edited handles
+  int changed = 0;
+  for (int n = 0; n < tuples / 4; n++) {
+    Segment seg = RandomSegment(rng);
+    Handles edit = {0.002f + NextUnit(rng) * 0.998f, NextUnit(rng) * 5 - 2,
+                    NextUnit(rng) * 0.998f, NextUnit(rng) * 5 - 2};
+    Handles shown;
+    ToHandles(FromHandles(seg, edit), shown);
+    if (!(shown == edit))
+      changed++;
+  }
+  Check("edited handles survive apply -> load bit for bit", changed == 0);
+
+  // Scale: 2^k times the delta and speeds, or the duration, same curve
+  bool scaled = true;
+  for (int n = 0; n < 10000 && scaled; n++) {
+    Segment seg = RandomSegment(rng), big = seg, longer = seg;
+    big.delta *= 1024;
+    big.out.speed *= 1024;
+    big.in.speed *= 1024;
+    longer.duration *= 4;
+    longer.out.speed /= 4;
+    longer.in.speed /= 4;
+    Handles a, b, c;
+    ToHandles(seg, a);
+    ToHandles(big, b);
+    ToHandles(longer, c);
+    scaled = a == b && a == c;
+  }
+  Check("curve independent of value / time scale", scaled);
+
+  // Flat, hold and linear segments
+  bool flatKept = true, holdKept = true;
+  for (int n = 0; n < 10000; n++) {
+    Segment seg = RandomSegment(rng);
+    Handles edit = {0.002f + NextUnit(rng) * 0.998f, NextUnit(rng), NextUnit(rng), NextUnit(rng)};
+    Segment flat = seg;
+    flat.delta = 0;
+    Segment back = FromHandles(flat, edit);
+    flatKept = flatKept && Classify(flat) == SHAPE_FLAT && back.out.speed == flat.out.speed &&
+               back.in.speed == flat.in.speed &&
+               std::fabs(back.out.influence - edit.x1 * 100.0) < 1e-4;
+    Segment hold = seg;
+    hold.inType = INTERP_HOLD;
+    back = FromHandles(hold, edit);
+    holdKept = holdKept && Classify(hold) == SHAPE_HOLD && back.out.speed == hold.out.speed &&
+               back.out.influence == hold.out.influence && back.in.speed == hold.in.speed &&
+               back.in.influence == hold.in.influence;
+  }
+  Check("flat pairs keep their speeds, influence from the curve", flatKept);
+  Check("hold pairs never change", holdKept);
+  Segment linear = {2.0, -50.0, INTERP_LINEAR, INTERP_LINEAR, {0, 16.67}, {0, 16.67}};
+  Handles handles;
+  ToHandles(linear, handles);
+  Segment back = FromHandles(linear, handles);
+  Check("linear pair: straight handles, speed = average",
+        handles == (Handles{1 / 3.0f, 1 / 3.0f, 2 / 3.0f, 2 / 3.0f}) &&
+            std::fabs(back.out.speed + 25.0) < 1e-5 && std::fabs(back.in.speed + 25.0) < 1e-5);
+  return TestResult();
+}
@@ -0,0 +1,75 @@
+/*****************************************************************************
+ * EffectEnumeratorTest.cpp
+ *
+ * EffectEnumerator against MockSource: hidden effects skipped, the native
+ * catalog equals the one built from effectsList(), UTF-8 validation, and
+ * the ControlUI items widened directly equal the items copied out of the
+ * catalog.
+ *****************************************************************************/
+
+#include "CatalogCache.h"
+#include "EffectEnumerator.h"
+#include "EffectFixtures.h"
+#include "TestCheck.h"
+#include "WireFormat.h"
+
+#include <cwchar>
+#include <string>
+#include <vector>
+
+static bool SameCatalog(const CatalogCache::Catalog &a, const CatalogCache::Catalog &b) {
+  if (a.RecordCount() != b.RecordCount() || a.FieldCount() != b.FieldCount())
+    return false;
+  for (uint32_t i = 0; i < a.RecordCount(); i++) {
+    for (uint32_t f = 0; f < a.FieldCount(); f++) {
+      if (a.Field(i, f) != b.Field(i, f))
+        return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  printf("EffectEnumerator checks\n");
+  CatalogCache::Key key;
+  key.hostBuild = "25.0x52";
+  key.language = "ko_KR";
+
+  // 5,000 installed effects, every 50th hidden
+  EffectEnumerator::MockSource source;
+  std::string wire;
+  size_t listed = MakeEffectSource(5000, source, wire);
+
+  CatalogCache::Builder native(WireFormat::EFFECT_FIELD_COUNT);
+  bool ok = EffectEnumerator::BuildCatalog(source, native) == listed;
+  CatalogCache::Builder scripted(WireFormat::EFFECT_FIELD_COUNT);
+  ok = ok && scripted.AddFromWire(wire) == listed;
+  CatalogCache::Catalog a, b;
+  ok = ok && a.Adopt(native.Finish(key)) && b.Adopt(scripted.Finish(key)) &&
+       SameCatalog(a, b) && a.Field(0, 0) == u"\uBE14\uB7EC 0";
+  Check("mock source == effectsList() catalog, hidden skipped", ok);
+
+  Check("UTF-8 validation (ANSI names are converted by the source)",
+        EffectEnumerator::IsUtf8("Gaussian Blur") &&
+            EffectEnumerator::IsUtf8("\xEB\xB8\x94\xEB\x9F\xAC \xF0\x9F\x8E\xA8") &&
+            !EffectEnumerator::IsUtf8("\xBA\xED\xB7\xAF") && // CP949
+            !EffectEnumerator::IsUtf8("\xEB\xB8") && !EffectEnumerator::IsUtf8("\xC0\x80"));
+
+  // SnapPlugin EnumerateEffects fills the list directly; the cache image it
+  // builds on the side is the same catalog
+  std::vector<FixtureEffectItem> viaCatalog, direct;
+  CopyEffects(a, viaCatalog);
+  CatalogCache::Builder sideBuilder(WireFormat::EFFECT_FIELD_COUNT);
+  EnumerateDirect(source, direct, sideBuilder);
+  CatalogCache::Catalog side;
+  ok = viaCatalog.size() == direct.size() && direct.size() == listed &&
+       side.Adopt(sideBuilder.Finish(key)) && SameCatalog(a, side);
+  for (size_t i = 0; ok && i < direct.size(); i++) {
+    ok = wcscmp(direct[i].name, viaCatalog[i].name) == 0 &&
+         wcscmp(direct[i].matchName, viaCatalog[i].matchName) == 0 &&
+         wcscmp(direct[i].category, viaCatalog[i].category) == 0 &&
+         direct[i].index == viaCatalog[i].index;
+  }
+  Check("direct items == items copied out of the catalog", ok);
+  return TestResult();
+}
@@ -0,0 +1,108 @@
+/*****************************************************************************
+ * EffectFixtures.h
+ *
+ * Synthetic effect lists shared by the CatalogCache / EffectEnumerator
+ * tests and tools/ScriptBench: effectsList() wire results, a MockSource
+ * with the same effects, and the ControlUI list the catalog is copied into.
+ *****************************************************************************/
+
+#pragma once
+
+#include "CatalogCache.h"
+#include "EffectEnumerator.h"
+#include "ScriptResult.h"
+#include "WireFormat.h"
+
+#include <string>
+#include <vector>
+
+// Same shape as ControlUI::EffectItem (what the catalog is copied into)
+struct FixtureEffectItem {
+  wchar_t name[128];
+  wchar_t matchName[128];
+  wchar_t category[64];
+  int index;
+};
+
+static const char *const kFixtureCategories[] = {
+    "Blur & Sharpen", "Color Correction", "Distort", "Generate",
+    "\xF0\x9F\x8E\xA8 Stylize", "Red Giant", "Boris FX Mocha", "Video Copilot"};
+
+// ControlUI::SetEffects equivalent: FieldInto each item
+inline size_t CopyEffects(const CatalogCache::Catalog &catalog,
+                          std::vector<FixtureEffectItem> &items) {
+  uint32_t count = catalog.RecordCount();
+  items.clear();
+  items.resize(count);
+  size_t n = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    FixtureEffectItem &item = items[i];
+    n += catalog.FieldInto(i, WireFormat::EFFECT_NAME, item.name, 128);
+    n += catalog.FieldInto(i, WireFormat::EFFECT_MATCH_NAME, item.matchName, 128);
+    n += catalog.FieldInto(i, WireFormat::EFFECT_CATEGORY_OR_INDEX, item.category, 64);
+    item.index = (int)i;
+  }
+  return n;
+}
+
+// effectsList() result: `count` effects, every third name in Korean
+inline std::string EffectsWire(uint32_t count) {
+  std::string wire;
+  WireFormat::Writer writer(wire);
+  for (uint32_t i = 0; i < count; i++) {
+    std::string name = (i % 3 == 0) ? "\xEB\xB8\x94\xEB\x9F\xAC " : "Effect ";
+    name += std::to_string(i);
+    writer.BeginRecord(3);
+    writer.String(name);
+    writer.String("ADBE Effect " + std::to_string(i));
+    writer.String(kFixtureCategories[i % 8]);
+  }
+  return wire;
+}
+
+// Installed effects for EffectEnumerator: every 50th hidden (empty
+// category). `wire` gets what effectsList() returns for the same effects.
+// @return effects listed (not hidden)
+inline size_t MakeEffectSource(size_t count, EffectEnumerator::MockSource &source,
+                               std::string &wire) {
+  wire.clear();
+  WireFormat::Writer writer(wire);
+  size_t listed = 0;
+  for (size_t i = 0; i < count; i++) {
+    std::string name = (i % 3 == 0) ? "\xEB\xB8\x94\xEB\x9F\xAC " : "Effect |;";
+    name += std::to_string(i);
+    std::string matchName = "ADBE Effect " + std::to_string(i);
+    std::string category = (i % 50 == 49) ? "" : kFixtureCategories[i % 8];
+    if (!category.empty()) {
+      writer.BeginRecord(3);
+      writer.String(name);
+      writer.String(matchName);
+      writer.String(category);
+      listed++;
+    }
+    source.Add(name, matchName, category);
+  }
+  return listed;
+}
+
+// SnapPlugin EnumerateEffects: each name widened once into its item; the
+// builder gets the same records for the cache file
+inline void EnumerateDirect(EffectEnumerator::MockSource &source,
+                            std::vector<FixtureEffectItem> &items,
+                            CatalogCache::Builder &builder) {
+  items.clear();
+  source.Rewind();
+  EffectEnumerator::Entry entry;
+  while (source.Next(entry)) {
+    if (entry.category.empty())
+      continue;
+    items.emplace_back();
+    FixtureEffectItem &item = items.back();
+    ScriptResult::WidenInto(entry.name, item.name, 128);
+    ScriptResult::WidenInto(entry.matchName, item.matchName, 128);
+    ScriptResult::WidenInto(entry.category, item.category, 64);
+    item.index = (int)items.size() - 1;
+    std::string_view fields[] = {entry.name, entry.matchName, entry.category};
+    builder.AddRecord(fields);
+  }
+}
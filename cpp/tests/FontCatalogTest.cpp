@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * FontCatalogTest.cpp
+ *
+ * FontCatalog: 50,000 synthetic fonts (long, Korean / emoji, '"' '|' ';'
+ * names) round-trip through the cache without truncation, the family
+ * fingerprint matches fontFamilies(), and an incremental merge after an
+ * installed-fonts change equals a full rebuild (order kept).
+ *****************************************************************************/
+
+#include "CatalogCache.h"
+#include "FontCatalog.h"
+#include "FontFixtures.h"
+#include "TestCheck.h"
+#include "WireFormat.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+static bool SameFonts(const CatalogCache::Catalog &catalog,
+                      const std::vector<FixtureFont> &fonts) {
+  if (catalog.RecordCount() != fonts.size())
+    return false;
+  for (uint32_t i = 0; i < fonts.size(); i++) {
+    if (catalog.Field(i, WireFormat::FONT_FAMILY) != CatalogCache::ToUtf16(fonts[i].family) ||
+        catalog.Field(i, WireFormat::FONT_STYLE) != CatalogCache::ToUtf16(fonts[i].style) ||
+        catalog.Field(i, WireFormat::FONT_POSTSCRIPT_NAME) !=
+            CatalogCache::ToUtf16(fonts[i].postScript))
+      return false;
+  }
+  return true;
+}
+
+int main() {
+  printf("FontCatalog checks\n");
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  fs::path dir = fs::temp_directory_path(ec) / "AnchorSnapTests.FontCatalog";
+  fs::path file = dir / "fonts-catalog.bin";
+
+  CatalogCache::Key key;
+  key.hostBuild = "25.0x52";
+  key.language = "ko_KR";
+
+  // fontsList() result -> catalog -> file
+  const size_t fontCount = 50000;
+  std::vector<FixtureFont> fonts = MakeFonts(fontCount);
+  std::string familiesWire = FamiliesWire(fonts);
+  CatalogCache::Builder builder(WireFormat::FONT_FIELD_COUNT);
+  bool loadOk = builder.AddFromWire(FontsWire(fonts)) == fontCount;
+  CatalogCache::Catalog built;
+  loadOk = loadOk && built.Adopt(builder.Finish(key));
+  key.fingerprint = FontCatalog::Fingerprint(built);
+  loadOk = loadOk && built.SetKey(key) &&
+           CatalogCache::WriteFile(file, built.Data(), built.Size());
+
+  CatalogCache::Catalog cached;
+  loadOk = loadOk && cached.Open(file) && cached.Matches(key, true) &&
+           SameFonts(cached, fonts);
+  Check("50,000 fonts round-trip without truncation", loadOk);
+
+  Check("fingerprint: catalog records == fontFamilies()",
+        FontCatalog::FingerprintFamilies(familiesWire) == key.fingerprint &&
+            FontCatalog::Compare(cached, familiesWire).changed == 0);
+
+  // One family removed, one gains a style, one new family mid-list
+  std::vector<FixtureFont> updated = ChangeFonts(fonts);
+  std::string updatedFamilies = FamiliesWire(updated);
+  FontCatalog::Diff diff = FontCatalog::Compare(cached, updatedFamilies);
+  size_t wanted = 0;
+  std::string changedWire = FontsOfWire(diff.changedWire, updated, &wanted);
+  bool diffOk = diff.changed == 2 && diff.removed == 1 && wanted == 2;
+
+  CatalogCache::Key updatedKey = key;
+  updatedKey.fingerprint = FontCatalog::FingerprintFamilies(updatedFamilies);
+  CatalogCache::Catalog merged;
+  diffOk = diffOk && merged.Adopt(FontCatalog::Merge(cached, updatedFamilies,
+                                                      changedWire, updatedKey));
+  diffOk = diffOk && SameFonts(merged, updated) &&
+           merged.Matches(updatedKey, true) &&
+           FontCatalog::Fingerprint(merged) == updatedKey.fingerprint;
+  Check("incremental merge == full rebuild (order kept)", diffOk);
+
+  cached.Close();
+  fs::remove_all(dir, ec);
+  return TestResult();
+}
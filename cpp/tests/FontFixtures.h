@@ -0,0 +1,120 @@
+/*****************************************************************************
+ * FontFixtures.h
+ *
+ * Synthetic font lists shared by FontCatalogTest and tools/ScriptBench:
+ * fontsList() / fontFamilies() wire results and an installed-fonts change
+ * (one family removed, one grown, one inserted mid-list).
+ *****************************************************************************/
+
+#pragma once
+
+#include "WireFormat.h"
+
+#include <string>
+#include <vector>
+
+struct FixtureFont {
+  std::string family, style, postScript;
+};
+
+// Synthetic font list: families of 1..12 styles, long / non-ASCII names
+inline std::vector<FixtureFont> MakeFonts(size_t count) {
+  static const char *const kStyles[] = {
+      "Regular", "Bold", "Italic", "Bold Italic", "Light", "Medium",
+      "SemiBold", "Black", "Thin", "ExtraLight", "\xEB\xB3\xB4\xED\x86\xB5",
+      "Condensed \"Narrow\"|;"};
+  std::vector<FixtureFont> fonts;
+  fonts.reserve(count);
+  for (size_t family = 0; fonts.size() < count; family++) {
+    std::string name;
+    if (family % 7 == 0)
+      name = "\xEB\x82\x98\xEB\x88\x94\xEA\xB3\xA0\xEB\x94\x95 "; // Korean
+    if (family % 11 == 0)
+      name += "\xF0\x9F\x94\xA4 "; // Emoji (surrogate pair)
+    name += "Family " + std::to_string(family);
+    if (family % 97 == 0)
+      name += std::string(300, 'x'); // Longer than any old fixed buffer
+    size_t styles = 1 + family % 12;
+    for (size_t s = 0; s < styles && fonts.size() < count; s++) {
+      FixtureFont font;
+      font.family = name;
+      font.style = kStyles[s];
+      font.postScript = "PS-" + std::to_string(family) + "-" + std::to_string(s);
+      fonts.push_back(font);
+    }
+  }
+  return fonts;
+}
+
+// fontsList() result
+inline std::string FontsWire(const std::vector<FixtureFont> &fonts) {
+  std::string wire;
+  WireFormat::Writer writer(wire);
+  for (const FixtureFont &font : fonts) {
+    writer.BeginRecord(3);
+    writer.String(font.family);
+    writer.String(font.style);
+    writer.String(font.postScript);
+  }
+  return wire;
+}
+
+// fontFamilies() result (fonts are grouped by family, like app.fonts.allFonts)
+inline std::string FamiliesWire(const std::vector<FixtureFont> &fonts) {
+  std::string wire;
+  WireFormat::Writer writer(wire);
+  for (size_t i = 0; i < fonts.size();) {
+    size_t j = i;
+    while (j < fonts.size() && fonts[j].family == fonts[i].family)
+      j++;
+    writer.BeginRecord(2);
+    writer.String(fonts[i].family);
+    writer.Int((int64_t)(j - i));
+    i = j;
+  }
+  return wire;
+}
+
+// Installed fonts change: fonts[100]'s family removed, fonts[20000]'s
+// family gains a style, one new family inserted mid-list (like a new
+// install sorted by AE). Needs more than 20,000 fonts.
+inline std::vector<FixtureFont> ChangeFonts(const std::vector<FixtureFont> &fonts) {
+  std::vector<FixtureFont> updated;
+  std::string removedFamily = fonts[100].family;
+  std::string grownFamily = fonts[20000].family;
+  bool inserted = false;
+  for (size_t i = 0; i < fonts.size(); i++) {
+    if (fonts[i].family == removedFamily)
+      continue;
+    if (i >= fonts.size() / 2 && !inserted && fonts[i].family != fonts[i - 1].family) {
+      inserted = true;
+      updated.push_back({"\xEC\x83\x88 Font |;", "Regular", "NewFont-Regular"});
+      updated.push_back({"\xEC\x83\x88 Font |;", "Bold", "NewFont-Bold"});
+    }
+    updated.push_back(fonts[i]);
+    if (fonts[i].family == grownFamily &&
+        (i + 1 == fonts.size() || fonts[i + 1].family != grownFamily))
+      updated.push_back({grownFamily, "Wide", "PS-grown-wide"});
+  }
+  return updated;
+}
+
+// fontsOf(namesWire): the fonts of the named families, decoded like the
+// script side does. `count` gets the number of names.
+inline std::string FontsOfWire(std::string_view namesWire, const std::vector<FixtureFont> &fonts,
+                               size_t *count) {
+  std::vector<std::string> wanted;
+  WireFormat::Reader names(namesWire);
+  while (names.Next())
+    wanted.emplace_back(names.String(0));
+  std::vector<FixtureFont> changed;
+  for (const FixtureFont &font : fonts) {
+    for (const std::string &name : wanted) {
+      if (font.family == name)
+        changed.push_back(font);
+    }
+  }
+  if (count)
+    *count = wanted.size();
+  return FontsWire(changed);
+}
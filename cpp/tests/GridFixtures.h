@@ -0,0 +1,68 @@
+/*****************************************************************************
+ * GridFixtures.h
+ *
+ * Drives the real GridUI window (Windows only) for GridUITest and
+ * tools/ScriptBench: show a 7x7 grid at scale 1.7 and sweep the hover
+ * across it, either with the old full-window invalidation or with
+ * UpdateHover's own hover rects. UpdateWindow paints synchronously, so the
+ * "paint.grid" / "paint.grid.static" Profiler sites count every frame.
+ *****************************************************************************/
+
+#pragma once
+
+#include "GdiPlusIncludes.h"
+#include "GridUI.h"
+#include "PaintFixtures.h"
+#include "Profiler.h"
+
+#include <vector>
+
+struct SweepResult {
+  Profiler::SiteStats paint;
+  Profiler::SiteStats rebuild;
+};
+
+// 7x7 @ 1.7 at the screen center; the window or NULL
+inline HWND ShowTestGrid(RECT &window) {
+  NativeUI::GridConfig config;
+  config.gridWidth = 7;
+  config.gridHeight = 7;
+  config.cellSize = 68; // 40 * 1.7
+  config.spacing = 1;
+  config.margin = 2;
+  NativeUI::ShowGrid(GetSystemMetrics(SM_CXSCREEN) / 2, GetSystemMetrics(SM_CYSCREEN) / 2, config);
+
+  HWND hwnd = FindWindowW(L"AnchorGridClass", NULL);
+  if (!hwnd || !NativeUI::IsGridVisible() || !GetWindowRect(hwnd, &window))
+    return NULL;
+  UpdateWindow(hwnd); // First paint builds the static layer
+  return hwnd;
+}
+
+// Move the hover along `path` and paint after every move
+inline SweepResult Sweep(HWND hwnd, const std::vector<POINT> &path, int moves, bool fullRepaint) {
+  Profiler::Reset();
+  for (int i = 0; i < moves; i++) {
+    const POINT &pt = path[i % path.size()];
+    int oldX, oldY;
+    NativeUI::GetHoverCell(&oldX, &oldY);
+    NativeUI::ExtendedOption oldExt = NativeUI::GetHoverExtOption();
+    NativeUI::UpdateHover(pt.x, pt.y);
+    if (fullRepaint) {
+      int newX, newY;
+      NativeUI::GetHoverCell(&newX, &newY);
+      if (newX != oldX || newY != oldY || NativeUI::GetHoverExtOption() != oldExt)
+        NativeUI::InvalidateGrid();
+    }
+    UpdateWindow(hwnd);
+  }
+  SweepResult result;
+  result.paint = FindSite("paint.grid");
+  result.rebuild = FindSite("paint.grid.static");
+  return result;
+}
+
+inline void HideTestGrid(const RECT &window) {
+  NativeUI::HideGrid(window.left + 1, window.top + 1);
+  NativeUI::Cleanup();
+}
@@ -0,0 +1,92 @@
+/*****************************************************************************
+ * GridPaintTest.cpp
+ *
+ * GridPaint: window geometry per scale step, the color key outside the
+ * cells, cell background on / off, and a hover rendered into a cell-sized
+ * copy of the static layer matching the hover drawn over the whole window.
+ *****************************************************************************/
+
+#include "GridPaint.h"
+#include "TestCheck.h"
+
+// Every pixel of `part` equals `whole` at (x, y) + offset
+static bool SameBlock(const Canvas::Surface &part, const Canvas::Surface &whole, int x, int y) {
+  for (int row = 0; row < part.Height(); row++) {
+    for (int col = 0; col < part.Width(); col++) {
+      if (part.At(col, row) != whole.At(x + col, y + row))
+        return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  using namespace GridPaint;
+  printf("GridPaint\n");
+
+  // 7x7 @ 1.7 (GridFixtures.h's ShowTestGrid)
+  NativeUI::GridConfig config;
+  config.gridWidth = 7;
+  config.gridHeight = 7;
+  config.cellSize = 68;
+  config.spacing = 1;
+  config.margin = 2;
+  Layout layout = ComputeLayout(config);
+  Check("7x7 @ 1.7: scale, grid area, cell size, window",
+        layout.scale == 1.7f && layout.fixedGridPixels == 204 && layout.cellSize == 28 &&
+            layout.margin == 3 && layout.windowWidth == 386 && layout.windowHeight == 333);
+  Check("cells fit in the grid area",
+        layout.GridStartX() + layout.gridWidth * layout.cellSize <=
+                layout.sidePanelWidth + layout.margin + layout.fixedGridPixels &&
+            layout.GridStartY() + layout.gridHeight * layout.cellSize <=
+                layout.verticalPadding + layout.margin + layout.fixedGridPixels);
+
+  NativeUI::GridConfig small = config;
+  small.cellSize = 40;
+  NativeUI::GridConfig step = config;
+  step.cellSize = 41;
+  Check("scale steps: 40 -> 1.0, 41 -> 1.1",
+        ComputeLayout(small).scale == 1.0f && ComputeLayout(step).scale == 1.1f);
+
+  // Static layer
+  NativeUI::GridSettings settings;
+  settings.gridOpacity = 75;
+  settings.cellOpacity = 50;
+  Style style = MakeStyle(layout, settings);
+  Canvas::Surface grid;
+  grid.Resize(layout.windowWidth, layout.windowHeight);
+  DrawGrid(grid, layout, style);
+  int startX = layout.GridStartX(), startY = layout.GridStartY();
+  Check("color key outside the cells",
+        grid.At(0, 0) == COLOR_KEY && grid.At(startX - 1, startY) == COLOR_KEY &&
+            grid.At(layout.windowWidth - 1, layout.windowHeight - 1) == COLOR_KEY);
+  Canvas::Pixel cell = grid.At(startX + 1, startY + 1);
+  Check("cell background blended over the key",
+        cell != COLOR_KEY && cell == Canvas::BlendPixel(COLOR_KEY, style.cellBackground));
+
+  settings.cellOpacity = 0;
+  Canvas::Surface bare;
+  bare.Resize(layout.windowWidth, layout.windowHeight);
+  DrawGrid(bare, layout, MakeStyle(layout, settings));
+  Check("cellOpacity 0: no cell background", bare.At(startX + 1, startY + 1) == COLOR_KEY);
+
+  // Hover on the center cell: cell-sized copy + origin == drawn over the window
+  Canvas::Surface full;
+  full.Resize(grid.Width(), grid.Height());
+  full.CopyFrom(grid, 0, 0);
+  DrawCellMark(full, layout, style, 3, 3, true);
+  int left = startX + 3 * layout.cellSize - layout.cellSize / 2;
+  int top = startY + 3 * layout.cellSize - layout.cellSize / 2;
+  Canvas::Surface hover;
+  hover.Resize(layout.cellSize * 2, layout.cellSize * 2);
+  hover.CopyFrom(grid, left, top);
+  DrawCellMark(hover, layout, style, 3, 3, true, left, top);
+  int cx = layout.cellSize;  // Cell center in the hover surface
+  Check("hover glow drawn", hover.At(cx, cx) != grid.At(left + cx, top + cx));
+  Check("hover in a cell surface == hover over the window", SameBlock(hover, full, left, top));
+  int corner = layout.cellSize / 2;
+  Check("hover leaves other cells alone",
+        full.At(startX + corner, startY + corner) == grid.At(startX + corner, startY + corner) &&
+            full.At(startX + 1, startY + 1) == cell);
+  return TestResult();
+}
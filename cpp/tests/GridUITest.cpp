@@ -0,0 +1,52 @@
+/*****************************************************************************
+ * GridUITest.cpp (Windows only)
+ *
+ * GridUI retained static layer on the real grid window (7x7 @ 1.7): every
+ * hover change repaints, the old full-window invalidation rebuilds the
+ * static layer every frame, UpdateHover's hover rects never do, and a
+ * settings change rebuilds it exactly once.
+ *****************************************************************************/
+
+#include "GridFixtures.h"
+#include "GridUI.h"
+#include "Profiler.h"
+#include "TestCheck.h"
+
+#include <vector>
+
+int main() {
+  printf("GridUI checks (7x7 @ 1.7)\n");
+  Profiler::SetEnabled(true);
+
+  RECT window = {0, 0, 0, 0};
+  HWND hwnd = ShowTestGrid(window);
+  Check("grid window shown", hwnd != NULL);
+  if (hwnd) {
+    std::vector<POINT> path = RasterPath(window);
+    SweepResult full = Sweep(hwnd, path, (int)path.size(), true);
+    SweepResult retained = Sweep(hwnd, path, (int)path.size(), false);
+
+    Check("hover changes repaint", retained.paint.count > 0 && full.paint.count > 0);
+    Check("full repaint rebuilds the static layer every frame",
+          full.rebuild.count == full.paint.count);
+    Check("retained hover never rebuilds the static layer", retained.rebuild.count == 0);
+
+    // A settings change (comp mode) is caught by the layer key: one rebuild
+    NativeUI::UpdateHover(window.left + 1, window.top + 1); // No hover
+    UpdateWindow(hwnd);
+    NativeUI::GetSettings().useCompMode = !NativeUI::GetSettings().useCompMode;
+    Profiler::Reset();
+    NativeUI::UpdateHover((window.left + window.right) / 2, (window.top + window.bottom) / 2);
+    UpdateWindow(hwnd);
+    NativeUI::UpdateHover(window.left + 1, window.top + 1);
+    UpdateWindow(hwnd);
+    Check("static layer rebuilt once per settings change",
+          FindSite("paint.grid").count == 2 && FindSite("paint.grid.static").count == 1);
+    NativeUI::GetSettings().useCompMode = !NativeUI::GetSettings().useCompMode;
+  }
+
+  HideTestGrid(window);
+  Profiler::Reset();
+  Profiler::SetEnabled(false);
+  return TestResult();
+}
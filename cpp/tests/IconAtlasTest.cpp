@@ -0,0 +1,72 @@
+/*****************************************************************************
+ * IconAtlasTest.cpp (Windows only)
+ *
+ * IconAtlas on an icon bar (6 preset-style AA icons, scale 1.5): atlas
+ * cells match direct drawing, each (icon, state) is rasterized once and
+ * copied afterwards, rotated transforms are drawn directly, a scale change
+ * clears the atlas, and the atlas is freed with the GDI+ session.
+ *****************************************************************************/
+
+#include "IconAtlas.h"
+#include "PaintFixtures.h"
+#include "RenderContext.h"
+#include "TestCheck.h"
+
+using namespace Gdiplus;
+
+int main() {
+  printf("IconAtlas checks (6 icons @ %.1f)\n", BAR_SCALE);
+  using IconAtlas::GetStats;
+
+  RenderContext::Acquire();
+  IconAtlas::SetScale(IconAtlas::OWNER_CONTROL, BAR_SCALE);
+  HDC screen = GetDC(NULL);
+  {
+    PaintTarget direct(screen, BarDeviceWidth(), BarDeviceHeight());
+    PaintTarget atlas(screen, BarDeviceWidth(), BarDeviceHeight());
+    uint64_t rasterized = GetStats().rasterized;
+    PaintBar(direct.dc, false, 2);
+    PaintBar(atlas.dc, true, 2);
+    int diff = atlas.MaxDiff(direct);
+    printf("  atlas vs direct: max channel difference %d\n", diff);
+    Check("atlas icons match direct drawing (AA rounding only)", diff <= 3);
+    Check("first paint rasterizes each icon once",
+          GetStats().rasterized == rasterized + BAR_ICON_COUNT);
+
+    rasterized = GetStats().rasterized;
+    uint64_t blits = GetStats().blits;
+    PaintBar(atlas.dc, true, 2);
+    Check("repaint copies cells only",
+          GetStats().rasterized == rasterized && GetStats().blits == blits + BAR_ICON_COUNT);
+    PaintBar(atlas.dc, true, 4); // Hover moves: 2 new states
+    Check("new state rasterized once", GetStats().rasterized == rasterized + 2);
+
+    // Rotation cannot be a 1:1 copy: drawn directly
+    {
+      Graphics graphics(atlas.dc);
+      graphics.RotateTransform(30.0f);
+      Check("rotated transform drawn directly",
+            !IconAtlas::Draw(graphics, IconAtlas::OWNER_CONTROL, 0, 0,
+                             RectF(20, 4, BAR_ICON_SIZE, BAR_ICON_SIZE), RasterBarIcon));
+    }
+
+    // Hover walking along the bar once every state is warm
+    for (int i = 0; i < BAR_ICON_COUNT; i++)
+      PaintBar(atlas.dc, true, i);
+    rasterized = GetStats().rasterized;
+    for (int i = 0; i < 4 * BAR_ICON_COUNT; i++)
+      PaintBar(atlas.dc, true, i % BAR_ICON_COUNT);
+    Check("warm atlas paints rasterize nothing", GetStats().rasterized == rasterized);
+
+    // A scale change (module settings) drops every cell
+    uint64_t clears = GetStats().clears;
+    IconAtlas::SetScale(IconAtlas::OWNER_CONTROL, BAR_SCALE * 2);
+    Check("scale change clears the atlas", GetStats().clears == clears + 1 && GetStats().icons == 0);
+    IconAtlas::SetScale(IconAtlas::OWNER_CONTROL, BAR_SCALE);
+  }
+  ReleaseDC(NULL, screen);
+
+  RenderContext::Release(); // Last user: atlas freed before GdiplusShutdown
+  Check("atlas freed with the GDI+ session", GetStats().bytes == 0);
+  return TestResult();
+}
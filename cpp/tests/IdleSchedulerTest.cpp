@@ -0,0 +1,224 @@
+/*****************************************************************************
+ * IdleSchedulerTest.cpp
+ *
+ * IdleScheduler: state -> mode -> interval, the tick rate window, and a
+ * simulated AE session (background, foreground idle, trigger use) replayed
+ * against the host idle loop on a virtual clock: key wake-up latency, tick
+ * rates and the idle CPU budget vs the old fixed 33 ms interval.
+ *****************************************************************************/
+
+#include "IdleScheduler.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Input trace event (simulated AE session)
+enum TraceEvent {
+  TRACE_FOREGROUND,  // AE activated
+  TRACE_BACKGROUND,  // Another app activated
+  TRACE_KEY_DOWN,    // Trigger key pressed (UpdateMenuHook fires)
+  TRACE_KEY_UP,
+  TRACE_PANEL_SHOW,  // Grid / panel opened by the trigger
+  TRACE_PANEL_HIDE
+};
+
+struct TraceStep {
+  uint64_t atMs;
+  TraceEvent event;
+};
+
+// Modeled IdleHook cost: full polling ladder vs background early-out
+static const uint64_t kPollTickUs = 40;
+static const uint64_t kSkippedTickUs = 4;
+
+struct ReplayResult {
+  double maxKeyLatencyMs = 0;
+  double avgKeyLatencyMs = 0;
+  double backgroundTicksPerSecond = 0;
+  double idleTicksPerSecond = 0;
+  double backgroundBusyMsPerSecond = 0; // Main-thread time spent per second
+  double idleBusyMsPerSecond = 0;
+  uint64_t wakes = 0;
+};
+
+static bool s_wakePending = false;
+static void SimWaker(void *) { s_wakePending = true; }
+
+// Replays the trace against the host idle loop: the next tick comes after
+// max_sleep, or at once when the waker was called. adaptive == false
+// models the old fixed 33 ms interval with the full ladder on every tick.
+static ReplayResult ReplayTrace(const std::vector<TraceStep> &trace,
+                                uint64_t endMs, bool adaptive, bool waker,
+                                uint64_t backgroundFromMs, uint64_t backgroundToMs,
+                                uint64_t idleFromMs, uint64_t idleToMs) {
+  IdleScheduler::ResetStats();
+  IdleScheduler::SetWaker(waker ? SimWaker : nullptr, nullptr);
+  s_wakePending = false;
+
+  ReplayResult result;
+  IdleScheduler::State state;
+  int keysDown = 0;
+  size_t next = 0;
+  std::vector<uint64_t> pendingKeys; // Key-down times not yet seen by a tick
+  double latencySum = 0;
+  int latencyCount = 0;
+  uint64_t bgTicks = 0, bgBusy = 0, idleTicks = 0, idleBusy = 0;
+
+  uint64_t nowUs = 0;
+  const uint64_t endUs = endMs * 1000;
+  while (nowUs < endUs) {
+    // Tick
+    for (uint64_t keyUs : pendingKeys) {
+      double latency = (double)(nowUs - keyUs) / 1000.0;
+      latencySum += latency;
+      latencyCount++;
+      if (latency > result.maxKeyLatencyMs)
+        result.maxKeyLatencyMs = latency;
+    }
+    pendingKeys.clear();
+    s_wakePending = false;
+    state.holdPending = keysDown > 0;
+    bool skipped = adaptive && !state.foreground && !state.uiVisible;
+    uint64_t cost = skipped ? kSkippedTickUs : kPollTickUs;
+    IdleScheduler::BeginTick(nowUs);
+    int sleepMs = IdleScheduler::EndTick(state, nowUs + cost);
+    if (!adaptive)
+      sleepMs = 33;
+    if (nowUs >= backgroundFromMs * 1000 && nowUs < backgroundToMs * 1000) {
+      bgTicks++;
+      bgBusy += cost;
+    }
+    if (nowUs >= idleFromMs * 1000 && nowUs < idleToMs * 1000) {
+      idleTicks++;
+      idleBusy += cost;
+    }
+
+    // Sleep, cut short by a wake request from an input event
+    uint64_t wakeUs = nowUs + cost + (uint64_t)sleepMs * 1000;
+    while (next < trace.size() && trace[next].atMs * 1000 < wakeUs) {
+      const TraceStep &step = trace[next++];
+      uint64_t atUs = step.atMs * 1000;
+      switch (step.event) {
+      case TRACE_FOREGROUND:
+        state.foreground = true;
+        break;
+      case TRACE_BACKGROUND:
+        state.foreground = false;
+        break;
+      case TRACE_KEY_DOWN:
+        keysDown++;
+        pendingKeys.push_back(atUs);
+        if (state.foreground)
+          IdleScheduler::RequestWake(); // UpdateMenuHook
+        break;
+      case TRACE_KEY_UP:
+        keysDown--;
+        break;
+      case TRACE_PANEL_SHOW:
+        state.uiVisible = true;
+        break;
+      case TRACE_PANEL_HIDE:
+        state.uiVisible = false;
+        break;
+      }
+      if (s_wakePending) {
+        wakeUs = atUs > nowUs + cost ? atUs : nowUs + cost;
+        break;
+      }
+    }
+    nowUs = wakeUs;
+  }
+
+  IdleScheduler::SetWaker(nullptr, nullptr);
+  result.avgKeyLatencyMs = latencyCount ? latencySum / latencyCount : 0;
+  double bgSeconds = (double)(backgroundToMs - backgroundFromMs) / 1000.0;
+  double idleSeconds = (double)(idleToMs - idleFromMs) / 1000.0;
+  result.backgroundTicksPerSecond = (double)bgTicks / bgSeconds;
+  result.idleTicksPerSecond = (double)idleTicks / idleSeconds;
+  result.backgroundBusyMsPerSecond = (double)bgBusy / 1000.0 / bgSeconds;
+  result.idleBusyMsPerSecond = (double)idleBusy / 1000.0 / idleSeconds;
+  result.wakes = IdleScheduler::GetStats().wakes;
+  return result;
+}
+
+int main() {
+  printf("IdleScheduler checks\n");
+  using namespace IdleScheduler;
+
+  State state;
+  bool ok = Classify(state) == MODE_BACKGROUND;
+  state.foreground = true;
+  ok = ok && Classify(state) == MODE_IDLE;
+  state.holdPending = true;
+  ok = ok && Classify(state) == MODE_ACTIVE;
+  state = State();
+  state.uiVisible = true; // Panel shown while AE lost focus still hovers
+  ok = ok && Classify(state) == MODE_ACTIVE;
+  state = State();
+  state.workPending = true;
+  ok = ok && Classify(state) == MODE_ACTIVE &&
+       SleepFor(MODE_ACTIVE) < SleepFor(MODE_IDLE) &&
+       SleepFor(MODE_IDLE) < SleepFor(MODE_BACKGROUND);
+  Check("state -> mode -> interval", ok);
+
+  // Rate window: 100 ticks of 250 us over 2 s
+  ResetStats();
+  for (int i = 0; i < 100; i++) {
+    BeginTick((uint64_t)i * 20000);
+    EndTick(State(), (uint64_t)i * 20000 + 250);
+  }
+  Stats stats = GetStats();
+  ok = stats.ticks == 100 && stats.ticksByMode[MODE_BACKGROUND] == 100 &&
+       std::fabs(stats.ticksPerSecond - 50.0) < 1.0 &&
+       std::fabs(stats.busyUsPerTick - 250.0) < 0.5 && stats.maxTickUs == 250;
+  Check("ticks per second / busy time per tick", ok);
+
+  // Session: 20 s background, 20 s foreground idle, then trigger use
+  std::vector<TraceStep> trace;
+  trace.push_back({20000, TRACE_FOREGROUND});
+  uint64_t t = 40000;
+  for (int i = 0; i < 20; i++) {
+    uint64_t at = t + (uint64_t)i * 1500 + (uint64_t)(i * 37 % 90); // Off-grid times
+    trace.push_back({at, TRACE_KEY_DOWN});
+    if (i % 2 == 0) {
+      trace.push_back({at + 250, TRACE_PANEL_SHOW}); // Y hold -> grid
+      trace.push_back({at + 700, TRACE_KEY_UP});
+      trace.push_back({at + 701, TRACE_PANEL_HIDE});
+    } else {
+      trace.push_back({at + 90, TRACE_KEY_UP}); // Tap
+    }
+  }
+  trace.push_back({75000, TRACE_BACKGROUND});
+  const uint64_t endMs = 80000;
+
+  ReplayResult adaptive = ReplayTrace(trace, endMs, true, true, 0, 20000, 20000, 40000);
+  ReplayResult noWaker = ReplayTrace(trace, endMs, true, false, 0, 20000, 20000, 40000);
+  ReplayResult fixed = ReplayTrace(trace, endMs, false, false, 0, 20000, 20000, 40000);
+
+  Check("key wake-up latency under 1 ms with the waker",
+        adaptive.maxKeyLatencyMs < 1.0 && adaptive.wakes > 0);
+  Check("background <= 3 ticks/s, foreground idle <= 11 ticks/s",
+        adaptive.backgroundTicksPerSecond <= 3.0 && adaptive.idleTicksPerSecond <= 11.0);
+  Check("idle CPU budget (background < 0.05 ms/s, foreground idle < 0.5 ms/s)",
+        adaptive.backgroundBusyMsPerSecond < 0.05 && adaptive.idleBusyMsPerSecond < 0.5 &&
+            adaptive.idleBusyMsPerSecond < fixed.idleBusyMsPerSecond / 2);
+
+  printf("  %-20s %9s %9s %10s %11s %12s\n", "", "key avg", "key max",
+         "bg tick/s", "idle tick/s", "idle ms/s");
+  const struct {
+    const char *label;
+    const ReplayResult *r;
+  } rows[] = {{"fixed 33 ms", &fixed},
+              {"adaptive, no waker", &noWaker},
+              {"adaptive + waker", &adaptive}};
+  for (const auto &row : rows) {
+    printf("  %-20s %7.2fms %7.2fms %10.1f %11.1f %12.3f\n", row.label,
+           row.r->avgKeyLatencyMs, row.r->maxKeyLatencyMs,
+           row.r->backgroundTicksPerSecond, row.r->idleTicksPerSecond,
+           row.r->idleBusyMsPerSecond);
+  }
+  ResetStats();
+  return TestResult();
+}
@@ -0,0 +1,300 @@
+/*****************************************************************************
+ * InputEngineTest.cpp
+ *
+ * InputEngine against sampled ground-truth key edges: hold / tap /
+ * double-tap timing, the toggle latch, chords, excluded modifiers, the gate
+ * and guard, edge sources between samples, and randomized sessions with
+ * jittered sampling and script stalls (every press paired with one release).
+ *****************************************************************************/
+
+#include "InputEngine.h"
+#include "InputFixtures.h"
+#include "TestCheck.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct MockGate {
+  bool open = true;
+  int calls = 0;
+};
+
+static bool GateFn(void *context) {
+  MockGate *gate = (MockGate *)context;
+  gate->calls++;
+  return gate->open;
+}
+
+static bool GuardFn(int, void *context) { return *(bool *)context; }
+
+// Ground-truth input transition
+struct InputEdge {
+  uint64_t atMs;
+  InputEngine::Input input;
+  bool down;
+};
+
+// Samples the edges at the given times: polling sees only the level,
+// an edge source also reports pressed / released since the last sample
+static std::vector<InputEngine::Sample> SampleEdges(const std::vector<InputEdge> &edges,
+                                                    const std::vector<uint64_t> &times,
+                                                    bool edgeSource) {
+  std::vector<InputEngine::Sample> samples;
+  uint32_t down = 0;
+  size_t next = 0;
+  for (uint64_t t : times) {
+    InputEngine::Sample sample;
+    sample.timeMs = t;
+    while (next < edges.size() && edges[next].atMs <= t) {
+      uint32_t bit = InputEngine::Bit(edges[next].input);
+      if (edges[next].down) {
+        down |= bit;
+        sample.pressed |= bit;
+      } else {
+        down &= ~bit;
+        sample.released |= bit;
+      }
+      next++;
+    }
+    sample.down = down;
+    if (!edgeSource)
+      sample.pressed = sample.released = 0;
+    samples.push_back(sample);
+  }
+  return samples;
+}
+
+static std::vector<uint64_t> EveryMs(uint64_t endMs, uint64_t stepMs) {
+  std::vector<uint64_t> times;
+  for (uint64_t t = 0; t <= endMs; t += stepMs)
+    times.push_back(t);
+  return times;
+}
+
+static std::vector<InputEngine::Event> RunEngine(const std::vector<InputEngine::Sample> &samples,
+                                                 MockGate *gate = nullptr,
+                                                 bool *guard = nullptr) {
+  InputEngine::Engine engine(kTestBindings, kTestBindingCount);
+  if (gate)
+    engine.SetGate(GateFn, gate);
+  if (guard)
+    engine.SetGuard(GuardFn, guard);
+  std::vector<InputEngine::Event> events;
+  for (const InputEngine::Sample &sample : samples)
+    engine.Update(sample, events);
+  return events;
+}
+
+int main() {
+  printf("InputEngine checks\n");
+  using namespace InputEngine;
+  std::vector<uint64_t> poll = EveryMs(2000, 16);
+
+  // Y held 600 ms: press, hold at 400 ms (first sample after), release
+  std::vector<Event> events = RunEngine(SampleEdges(
+      {{100, INPUT_Y, true}, {700, INPUT_Y, false}}, poll, false));
+  uint64_t holdAt = EventTime(events, ACT_GRID, EVENT_HOLD);
+  Check("hold: press, hold after 400 ms, release",
+        EventString(events, ACT_GRID) == "PHR" && holdAt >= 500 && holdAt < 500 + 16);
+
+  // Tap, then double-tap within 250 ms, then a slow second tap
+  events = RunEngine(SampleEdges({{100, INPUT_Y, true},
+                                  {180, INPUT_Y, false},
+                                  {300, INPUT_Y, true},
+                                  {360, INPUT_Y, false},
+                                  {1000, INPUT_Y, true},
+                                  {1080, INPUT_Y, false}},
+                                 poll, false));
+  Check("tap / double-tap / slow tap", EventString(events, ACT_GRID) == "PRDRPR");
+
+  // Toggle mode: each double-tap flips the latch, the host can clear it
+  {
+    Engine engine(kTestBindings, kTestBindingCount);
+    std::vector<Sample> samples = SampleEdges({{100, INPUT_Y, true},
+                                               {180, INPUT_Y, false},
+                                               {300, INPUT_Y, true}, // Latch
+                                               {360, INPUT_Y, false},
+                                               {1000, INPUT_Y, true},
+                                               {1080, INPUT_Y, false},
+                                               {1200, INPUT_Y, true}, // Unlatch
+                                               {1260, INPUT_Y, false},
+                                               {1600, INPUT_Y, true},
+                                               {1650, INPUT_Y, false},
+                                               {1700, INPUT_Y, true}, // Latch
+                                               {1750, INPUT_Y, false}},
+                                              poll, false);
+    bool latched = false, latchOk = true;
+    int flips = 0;
+    for (const Sample &sample : samples) {
+      events.clear();
+      engine.Update(sample, events);
+      if (EventString(events, ACT_GRID).find('D') != std::string::npos) {
+        flips++;
+        latched = !latched;
+      }
+      latchOk = latchOk && engine.IsLatched(ACT_GRID) == latched &&
+                !engine.IsLatched(ACT_EFFECTS);
+    }
+    latchOk = latchOk && flips == 3 && engine.IsLatched(ACT_GRID);
+    engine.Unlatch(ACT_GRID); // Click applied the grid
+    Check("double-tap toggles the latch, Unlatch clears it",
+          latchOk && !engine.IsLatched(ACT_GRID));
+  }
+
+  // Chords in either order; left Shift does not make Right Shift+K
+  events = RunEngine(SampleEdges({{100, INPUT_SHIFT, true},
+                                  {150, INPUT_E, true},
+                                  {200, INPUT_E, false},
+                                  {250, INPUT_SHIFT, false},
+                                  {400, INPUT_E, true},
+                                  {450, INPUT_SHIFT, true},
+                                  {500, INPUT_SHIFT, false},
+                                  {520, INPUT_E, false},
+                                  {600, INPUT_SHIFT, true},
+                                  {650, INPUT_K, true},
+                                  {700, INPUT_K, false},
+                                  {720, INPUT_SHIFT, false},
+                                  {800, INPUT_RSHIFT, true},
+                                  {800, INPUT_SHIFT, true},
+                                  {850, INPUT_K, true},
+                                  {900, INPUT_K, false}},
+                                 poll, false));
+  Check("chords in either order, right Shift only for K",
+        EventString(events, ACT_EFFECTS) == "TT" && EventString(events, ACT_KEYFRAME) == "T");
+
+  // D: no trigger with Alt, none when Alt is released while D stays down
+  events = RunEngine(SampleEdges({{100, INPUT_ALT, true},
+                                  {150, INPUT_D, true},
+                                  {200, INPUT_ALT, false},
+                                  {300, INPUT_D, false},
+                                  {400, INPUT_D, true},
+                                  {450, INPUT_D, false}},
+                                 poll, false));
+  Check("excluded modifiers block the press edge", EventString(events, ACT_DMENU) == "T");
+
+  // Closed gate: nothing fires, and opening it while held does not fire late.
+  // The gate runs once per sample with an edge, not once per binding.
+  MockGate gate;
+  gate.open = false;
+  std::vector<Sample> samples = SampleEdges({{100, INPUT_D, true},
+                                             {100, INPUT_Y, true},
+                                             {100, INPUT_SHIFT, true},
+                                             {100, INPUT_E, true},
+                                             {900, INPUT_D, false}},
+                                            poll, false);
+  InputEngine::Engine engine(kTestBindings, kTestBindingCount);
+  engine.SetGate(GateFn, &gate);
+  events.clear();
+  for (const Sample &sample : samples) {
+    if (sample.timeMs >= 300)
+      gate.open = true;
+    engine.Update(sample, events);
+  }
+  Check("gate: closed edges are dropped, one gate call per sample",
+        events.empty() && gate.calls == 1);
+
+  bool guard = false;
+  events = RunEngine(SampleEdges({{100, INPUT_Y, true}, {700, INPUT_Y, false}}, poll, false),
+                     nullptr, &guard);
+  Check("guard: refused press has no hold or release", EventString(events, ACT_GRID).empty());
+
+  // Held before the first sample: not a press
+  events = RunEngine(SampleEdges({{0, INPUT_D, true}, {100, INPUT_D, false}}, poll, false));
+  Check("keys held at startup do not trigger", events.empty());
+
+  // Release + re-press and a full tap between two samples (33 ms polling)
+  std::vector<InputEdge> quick = {{100, INPUT_Y, true},  {600, INPUT_Y, false},
+                                  {610, INPUT_Y, true},  {1200, INPUT_Y, false},
+                                  {1500, INPUT_Y, true}, {1510, INPUT_Y, false}};
+  std::vector<uint64_t> slow = EveryMs(2000, 33);
+  std::string polled = EventString(RunEngine(SampleEdges(quick, slow, false)), ACT_GRID);
+  std::string edged = EventString(RunEngine(SampleEdges(quick, slow, true)), ACT_GRID);
+  Check("edge samples: re-press between samples is release + double-tap, "
+        "tap between samples is seen",
+        polled == "PHR" && edged == "PHRDRPR");
+
+  // Randomized sessions: Y holds / taps / quick re-presses and chords,
+  // sampled with jitter and occasional script stalls
+  uint32_t seed = 12345;
+  auto rnd = [&seed](uint32_t range) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) % range;
+  };
+  const int sessions = 200;
+  struct Mode {
+    const char *label;
+    bool edgeSource;
+    uint64_t stepMs;
+  } modes[] = {{"polling 16 ms", false, 16}, {"polling 33 ms", false, 33},
+               {"edge samples 33 ms", true, 33}};
+  uint64_t seenByMode[3] = {};
+  for (size_t m = 0; m < 3; m++) {
+    const Mode &mode = modes[m];
+    uint64_t truePresses = 0, seenPresses = 0, pairingErrors = 0;
+    double latencySum = 0, latencyMax = 0;
+    uint64_t latencyCount = 0;
+    for (int sIdx = 0; sIdx < sessions; sIdx++) {
+      std::vector<InputEdge> edges;
+      std::vector<uint64_t> pressTimes;
+      uint64_t t = 50;
+      for (int g = 0; g < 20; g++) {
+        uint64_t len = (rnd(4) == 0) ? 5 + rnd(20) : 60 + rnd(700); // Some very short taps
+        edges.push_back({t, INPUT_Y, true});
+        edges.push_back({t + len, INPUT_Y, false});
+        pressTimes.push_back(t);
+        t += len + 5 + rnd(400);
+      }
+      std::vector<uint64_t> times;
+      for (uint64_t now = 0; now <= t + 100;) {
+        times.push_back(now);
+        now += mode.stepMs + rnd(6);
+        if (rnd(50) == 0)
+          now += 80 + rnd(120); // Script round-trip stall
+      }
+      times.push_back(t + 400); // Final sample after the last release
+      events = RunEngine(SampleEdges(edges, times, mode.edgeSource));
+
+      // Every accepted press (P / D) is followed by exactly one release
+      // before the next press; holds only inside a press
+      bool open = false;
+      size_t pressIndex = 0;
+      for (const Event &event : events) {
+        if (event.type == EVENT_PRESS || event.type == EVENT_DOUBLE_TAP) {
+          if (open)
+            pairingErrors++;
+          open = true;
+          seenPresses++;
+          // Latency vs the true press this event belongs to
+          while (pressIndex + 1 < pressTimes.size() && pressTimes[pressIndex + 1] <= event.timeMs)
+            pressIndex++;
+          double latency = (double)(event.timeMs - pressTimes[pressIndex]);
+          latencySum += latency;
+          latencyCount++;
+          if (latency > latencyMax)
+            latencyMax = latency;
+        } else if (event.type == EVENT_RELEASE) {
+          if (!open)
+            pairingErrors++;
+          open = false;
+        } else if (event.type == EVENT_HOLD && !open) {
+          pairingErrors++;
+        }
+      }
+      if (open)
+        pairingErrors++;
+      truePresses += pressTimes.size();
+    }
+    char label[96];
+    snprintf(label, sizeof(label), "%s: every press paired with one release", mode.label);
+    Check(label, pairingErrors == 0);
+    seenByMode[m] = seenPresses;
+    printf("    presses %llu/%llu seen, decision latency avg %.1f ms, max %.0f ms\n",
+           (unsigned long long)seenPresses, (unsigned long long)truePresses,
+           latencyCount ? latencySum / (double)latencyCount : 0.0, latencyMax);
+  }
+  // Edge samples only lose presses when several taps fall into one sample
+  Check("edge samples see more presses than 16 ms polling", seenByMode[2] > seenByMode[0]);
+  return TestResult();
+}
@@ -0,0 +1,117 @@
+/*****************************************************************************
+ * InputFixtures.h
+ *
+ * SnapPlugin's trigger binding table, event summaries and the threaded
+ * InputQueue producer / consumer run shared by the InputEngine / InputQueue
+ * tests and tools/ScriptBench.
+ *****************************************************************************/
+
+#pragma once
+
+#include "InputEngine.h"
+#include "InputQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum TestAction { ACT_GRID, ACT_EFFECTS, ACT_KEYFRAME, ACT_DMENU, ACT_COUNT };
+
+// Same table as SnapPlugin (Y hold/double-tap, Shift+E, RShift+K, D)
+static const InputEngine::Binding kTestBindings[] = {
+    {ACT_GRID, InputEngine::GESTURE_HOLD, InputEngine::INPUT_Y, 0,
+     InputEngine::Bit(InputEngine::INPUT_ALT), true, 400, 250, true},
+    {ACT_EFFECTS, InputEngine::GESTURE_CHORD, InputEngine::INPUT_E,
+     InputEngine::Bit(InputEngine::INPUT_SHIFT), 0, true, 0, 0, false},
+    {ACT_KEYFRAME, InputEngine::GESTURE_CHORD, InputEngine::INPUT_K,
+     InputEngine::Bit(InputEngine::INPUT_RSHIFT), 0, true, 0, 0, false},
+    {ACT_DMENU, InputEngine::GESTURE_PRESS, InputEngine::INPUT_D, 0,
+     InputEngine::Bit(InputEngine::INPUT_ALT) | InputEngine::Bit(InputEngine::INPUT_SHIFT) |
+         InputEngine::Bit(InputEngine::INPUT_CTRL),
+     true, 0, 0, false},
+};
+static const size_t kTestBindingCount = sizeof(kTestBindings) / sizeof(kTestBindings[0]);
+
+// "P H R" style summary of one action's events
+inline std::string EventString(const std::vector<InputEngine::Event> &events, int action) {
+  static const char kCodes[] = {'T', 'P', 'H', 'D', 'R'};
+  std::string out;
+  for (const InputEngine::Event &event : events) {
+    if (event.action == action)
+      out += kCodes[event.type];
+  }
+  return out;
+}
+
+inline uint64_t EventTime(const std::vector<InputEngine::Event> &events, int action,
+                          InputEngine::EventType type) {
+  for (const InputEngine::Event &event : events) {
+    if (event.action == action && event.type == type)
+      return event.timeMs;
+  }
+  return UINT64_MAX;
+}
+
+inline InputQueue::KeyEvent QueueEvent(uint64_t timeUs, InputEngine::Input input, bool down) {
+  InputQueue::KeyEvent event;
+  event.timeUs = timeUs;
+  event.input = (uint8_t)input;
+  event.down = down;
+  return event;
+}
+
+// Producer thread pushes `count` events (sequence number in timeUs), one
+// every `intervalNs` (0 = as fast as it can); the consumer pops every
+// `pauseUs` (0 = spin)
+struct QueueRun {
+  uint64_t popped = 0;
+  uint64_t dropped = 0;
+  uint64_t orderErrors = 0;
+  double seconds = 0;
+};
+
+inline QueueRun RunQueueThreads(uint64_t count, int intervalNs, int pauseUs) {
+  std::unique_ptr<InputQueue::Ring> ring(new InputQueue::Ring());
+  std::atomic<bool> done{false};
+  QueueRun run;
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+  std::thread producer([&]() {
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    for (uint64_t seq = 1; seq <= count; seq++) {
+      if (intervalNs > 0) {
+        // Sleep (not spin) so a single-core consumer still gets its ticks
+        next += std::chrono::nanoseconds(intervalNs);
+        std::this_thread::sleep_until(next);
+      }
+      ring->Push(QueueEvent(seq, InputEngine::INPUT_Y, (seq & 1) != 0));
+    }
+    done = true;
+  });
+
+  uint64_t last = 0;
+  InputQueue::KeyEvent event;
+  for (;;) {
+    bool finished = done.load();
+    while (ring->Pop(event)) {
+      if (event.timeUs <= last)
+        run.orderErrors++;
+      last = event.timeUs;
+      run.popped++;
+    }
+    if (finished)
+      break;
+    if (pauseUs > 0)
+      std::this_thread::sleep_for(std::chrono::microseconds(pauseUs));
+  }
+  producer.join();
+  while (ring->Pop(event))
+    run.popped++;
+  run.dropped = ring->Dropped();
+  run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  return run;
+}
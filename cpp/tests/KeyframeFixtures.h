@@ -0,0 +1,169 @@
+/*****************************************************************************
+ * KeyframeFixtures.h
+ *
+ * Mock AE host for KeyframeSelection, shared by KeyframeSelectionTest and
+ * tools/ScriptBench: the selected keys of comp.selectedProperties,
+ * keyframeInfo() and applyEase() (one undo group per apply).
+ *****************************************************************************/
+
+#pragma once
+
+#include "CurveFixtures.h"
+#include "EaseModel.h"
+#include "WireFormat.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Mock AE: the selected keys of comp.selectedProperties
+struct MockKey {
+  int index; // AE key index (all keys selected: position + 1)
+  double time;
+  int inType, outType;
+  double value[EaseModel::MAX_DIMENSIONS]; // Per ease dimension (spatial: path position)
+  EaseModel::Ease in[EaseModel::MAX_DIMENSIONS];
+  EaseModel::Ease out[EaseModel::MAX_DIMENSIONS];
+};
+
+struct MockKeyProperty {
+  std::string name;
+  std::string matchName;
+  int dims;
+  std::vector<MockKey> keys;
+};
+
+struct MockKeyHost {
+  std::vector<MockKeyProperty> props;
+  int calls = 0;
+  int undoGroups = 0;
+  int easeWrites = 0; // setTemporalEaseAtKey
+};
+
+// Keys split over the properties by share; one property with a single
+// selected key (not sent), one 3D property with a flat dimension
+inline MockKeyHost MakeKeyHost(int keyCount, uint32_t &rng) {
+  static const struct {
+    const char *name;
+    const char *matchName;
+    int dims;
+    int share; // Tenths of keyCount (0: one key)
+  } kProps[] = {
+      {"Position", "ADBE Position", 1, 4},
+      {"Scale", "ADBE Scale", 3, 3},
+      {"Anchor Point", "ADBE Anchor Point", 1, 0},
+      {"\xED\x88\xAC\xEB\xAA\x85\xEB\x8F\x84", "ADBE Opacity", 1, 2}, // "투명도"
+      {"Rotation", "ADBE Rotate Z", 1, 1},
+  };
+  MockKeyHost host;
+  for (const auto &def : kProps) {
+    MockKeyProperty prop;
+    prop.name = def.name;
+    prop.matchName = def.matchName;
+    prop.dims = def.dims;
+    int n = def.share ? std::max(2, keyCount * def.share / 10) : 1;
+    double time = 0;
+    for (int i = 0; i < n; i++) {
+      MockKey key = {};
+      key.index = i + 1;
+      key.time = time;
+      time += (1 + rng % 60) / 30.0;
+      rng = rng * 1664525u + 1013904223u;
+      float u = NextUnit(rng);
+      key.inType = u < 0.02f ? EaseModel::INTERP_HOLD
+                             : (u < 0.1f ? EaseModel::INTERP_LINEAR : EaseModel::INTERP_BEZIER);
+      key.outType = NextUnit(rng) < 0.08f ? EaseModel::INTERP_LINEAR : EaseModel::INTERP_BEZIER;
+      for (int d = 0; d < prop.dims; d++) {
+        double step = (1 + NextUnit(rng) * 499) * (NextUnit(rng) < 0.5f ? -1 : 1);
+        key.value[d] = i == 0 || d == 2 ? 100.0 : prop.keys.back().value[d] + step;
+      }
+      prop.keys.push_back(key);
+    }
+    // Eases relative to the average speed of the pair on each side
+    for (int i = 0; i < n; i++) {
+      MockKey &key = prop.keys[i];
+      for (int d = 0; d < prop.dims; d++) {
+        double before = 0, after = 0;
+        if (i > 0)
+          before = (key.value[d] - prop.keys[i - 1].value[d]) / (key.time - prop.keys[i - 1].time);
+        if (i + 1 < n)
+          after = (prop.keys[i + 1].value[d] - key.value[d]) / (prop.keys[i + 1].time - key.time);
+        key.in[d] = {RandomSlope(rng) * before, 0.1 + NextUnit(rng) * 99.9};
+        key.out[d] = {RandomSlope(rng) * after, 0.1 + NextUnit(rng) * 99.9};
+      }
+    }
+    host.props.push_back(std::move(prop));
+  }
+  return host;
+}
+
+// keyframeInfo() against the mock
+inline std::string MockKeyframeInfo(MockKeyHost &host) {
+  host.calls++;
+  std::string wire;
+  WireFormat::Writer writer(wire);
+  for (size_t p = 0; p < host.props.size(); p++) {
+    const MockKeyProperty &prop = host.props[p];
+    if (prop.keys.size() < 2)
+      continue;
+    writer.BeginRecord(WireFormat::KEY_PROP_FIELD_COUNT);
+    writer.String(prop.name);
+    writer.String(prop.matchName);
+    writer.Int((int64_t)p);
+    writer.Int(prop.dims);
+    writer.Int((int64_t)prop.keys.size());
+    for (size_t j = 0; j < prop.keys.size(); j++) {
+      const MockKey &key = prop.keys[j];
+      writer.BeginRecord(WireFormat::KEY_DIMENSION + prop.dims * WireFormat::KEY_DIM_FIELD_COUNT);
+      writer.Int(key.index);
+      writer.Double(key.time);
+      writer.Int(key.inType);
+      writer.Int(key.outType);
+      for (int d = 0; d < prop.dims; d++) {
+        writer.Double(j + 1 < prop.keys.size() ? prop.keys[j + 1].value[d] - key.value[d] : 0.0);
+        writer.Double(key.in[d].speed);
+        writer.Double(key.in[d].influence);
+        writer.Double(key.out[d].speed);
+        writer.Double(key.out[d].influence);
+      }
+    }
+  }
+  return wire;
+}
+
+// applyEase() against the mock: one undo group, properties matched by
+// position and matchName
+inline int MockApplyEase(MockKeyHost &host, std::string_view payload) {
+  host.calls++;
+  host.undoGroups++;
+  WireFormat::Reader reader(payload);
+  MockKeyProperty *prop = nullptr;
+  int dims = 0, pairs = 0;
+  while (reader.Next()) {
+    if (reader.Type(0) == WireFormat::FIELD_STRING) {
+      size_t position = (size_t)reader.Int(WireFormat::EASE_PROP_POSITION, -1);
+      prop = position < host.props.size() &&
+                     host.props[position].matchName == reader.String(WireFormat::EASE_PROP_MATCH_NAME)
+                 ? &host.props[position]
+                 : nullptr;
+      dims = reader.Int(WireFormat::EASE_PROP_DIMENSIONS, 0);
+      continue;
+    }
+    size_t k1 = (size_t)reader.Int(WireFormat::EASE_KEY1, 0) - 1;
+    size_t k2 = (size_t)reader.Int(WireFormat::EASE_KEY2, 0) - 1;
+    if (!prop || k1 >= prop->keys.size() || k2 >= prop->keys.size())
+      continue;
+    for (int d = 0; d < dims && d < prop->dims; d++) {
+      size_t base = WireFormat::EASE_DIMENSION + d * WireFormat::EASE_DIM_FIELD_COUNT;
+      prop->keys[k1].out[d] = {reader.Number(base + WireFormat::EASE_DIM_OUT_SPEED, 0),
+                               reader.Number(base + WireFormat::EASE_DIM_OUT_INFLUENCE, 0)};
+      prop->keys[k2].in[d] = {reader.Number(base + WireFormat::EASE_DIM_IN_SPEED, 0),
+                              reader.Number(base + WireFormat::EASE_DIM_IN_INFLUENCE, 0)};
+    }
+    host.easeWrites += 2;
+    pairs++;
+  }
+  return reader.Failed() ? -1 : pairs;
+}
+
@@ -0,0 +1,179 @@
+/*****************************************************************************
+ * KeyframeSelectionTest.cpp
+ *
+ * KeyframeSelection against a mock AE: one info call loads every selected
+ * key exactly, one apply call / undo group eases the whole selection with
+ * per-pair curves, stale properties are skipped, malformed info rejected,
+ * and a 10,000-key selection reloads with the applied curve on every pair.
+ *****************************************************************************/
+
+#include "EaseModel.h"
+#include "KeyframeFixtures.h"
+#include "KeyframeSelection.h"
+#include "TestCheck.h"
+#include "WireFormat.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// What a reload shows after applying `edit`: linear sides stay straight
+static EaseModel::Handles ExpectedCurve(const EaseModel::Segment &seg, EaseModel::Handles edit) {
+  if (seg.outType == EaseModel::INTERP_LINEAR)
+    edit.x1 = edit.y1 = (float)(1.0 / 3.0);
+  if (seg.inType == EaseModel::INTERP_LINEAR) {
+    edit.x2 = (float)(1.0 - 1.0 / 3.0);
+    edit.y2 = (float)(1.0 - 1.0 / 3.0);
+  }
+  return edit;
+}
+
+// Every pair shows its expected curve in every moving dimension; hold pairs
+// and flat dimensions kept their eases. `curveOf` gives the applied curve
+template <typename CurveOf>
+static bool ReloadMatches(const KeyframeSelection::Selection &before,
+                          const KeyframeSelection::Selection &after, CurveOf curveOf) {
+  using namespace KeyframeSelection;
+  if (after.PairCount() != before.PairCount())
+    return false;
+  for (size_t pair = 0; pair < after.PairCount(); pair++) {
+    int dims = after.props[after.pairProp[pair]].dimensions;
+    for (int d = 0; d < dims; d++) {
+      EaseModel::Segment was = PairSegment(before, pair, d), now = PairSegment(after, pair, d);
+      EaseModel::Shape shape = EaseModel::Classify(was);
+      if (shape == EaseModel::SHAPE_HOLD) {
+        if (now.out.speed != was.out.speed || now.out.influence != was.out.influence ||
+            now.in.speed != was.in.speed || now.in.influence != was.in.influence)
+          return false;
+      } else if (shape == EaseModel::SHAPE_FLAT) {
+        if (now.out.speed != was.out.speed || now.in.speed != was.in.speed)
+          return false;
+      } else {
+        EaseModel::Handles shown;
+        EaseModel::ToHandles(now, shown);
+        if (!(shown == ExpectedCurve(now, curveOf(pair))))
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+int main() {
+  printf("KeyframeSelection checks\n");
+  using namespace KeyframeSelection;
+  uint32_t rng = 0x2545F491u;
+
+  // Load: one call, every selected key of every property
+  MockKeyHost host = MakeKeyHost(600, rng);
+  Selection sel;
+  bool ok = Parse(MockKeyframeInfo(host), sel) && host.calls == 1 && sel.props.size() == 4;
+  size_t pairs = 0;
+  for (size_t p = 0; ok && p < sel.props.size(); p++) {
+    const Property &prop = sel.props[p];
+    const MockKeyProperty &mock = host.props[(size_t)prop.position];
+    ok = prop.matchName == mock.matchName && prop.name == mock.name && prop.dimensions == mock.dims &&
+         prop.keyCount == (int)mock.keys.size();
+    for (int j = 0; ok && j < prop.keyCount; j++) {
+      size_t k = (size_t)(prop.firstKey + j);
+      const MockKey &key = mock.keys[(size_t)j];
+      ok = sel.keyIndex[k] == key.index && sel.keyTime[k] == key.time &&
+           sel.keyInType[k] == key.inType && sel.keyOutType[k] == key.outType;
+      for (int d = 0; ok && d < prop.dimensions; d++) {
+        size_t i = k * EaseModel::MAX_DIMENSIONS + d;
+        ok = sel.inSpeed[i] == key.in[d].speed && sel.inInfluence[i] == key.in[d].influence &&
+             sel.outSpeed[i] == key.out[d].speed && sel.outInfluence[i] == key.out[d].influence;
+      }
+    }
+    pairs += (size_t)prop.keyCount - 1;
+  }
+  ok = ok && sel.PairCount() == pairs && sel.props[2].position == 3; // Anchor Point skipped
+  Check("one info call: every key of every property, exact", ok);
+
+  std::string payload;
+  Check("nothing edited: nothing to apply", !BuildApply(sel, payload) && payload.empty());
+
+  // One edit eases the whole selection, each pair with its own speeds
+  EaseModel::Handles easeInOut = {0.42f, 0.0f, 0.58f, 1.0f};
+  size_t viewed = pairs / 3;
+  SetCurve(sel, viewed, easeInOut);
+  int calls = host.calls;
+  int written = BuildApply(sel, payload) ? MockApplyEase(host, payload) : -1;
+  Selection reload;
+  ok = Parse(MockKeyframeInfo(host), reload) && host.calls == calls + 2 && host.undoGroups == 1;
+  int holds = 0;
+  for (size_t pair = 0; pair < sel.PairCount(); pair++)
+    holds += EaseModel::Classify(PairSegment(sel, pair, 0)) == EaseModel::SHAPE_HOLD;
+  ok = ok && written == (int)pairs - holds && host.easeWrites == 2 * written;
+  Check("one edit: every non-hold pair written in one call / undo group", ok);
+  Check("reload shows the edit on every pair and moving dimension",
+        ReloadMatches(sel, reload, [&](size_t) { return easeInOut; }));
+
+  // Per-pair edits: pairs never edited follow the latest edit
+  sel = reload;
+  EaseModel::Handles first = {0.2f, 0.6f, 0.9f, 0.95f}, second = {0.05f, -0.3f, 0.5f, 1.4f};
+  size_t a = 1, b = pairs - 2, c = pairs / 2;
+  SetCurve(sel, a, first);
+  SetCurve(sel, c, Curve(sel, c)); // Viewed without an edit
+  SetCurve(sel, b, second);
+  ok = Curve(sel, a) == first && Curve(sel, b) == second && Curve(sel, c) == second &&
+       sel.edited[a] && sel.edited[b] && !sel.edited[c];
+  written = BuildApply(sel, payload) ? MockApplyEase(host, payload) : -1;
+  ok = ok && Parse(MockKeyframeInfo(host), reload) && written == (int)pairs - holds &&
+       host.undoGroups == 2;
+  Check("per-pair curves: edited pairs keep theirs, others follow the latest", ok);
+  Check("reload shows each pair's own curve", ReloadMatches(sel, reload, [&](size_t pair) {
+          return pair == a ? first : second;
+        }));
+
+  // Selection changed in AE (another property at that position): skipped
+  sel = reload;
+  SetCurve(sel, 0, easeInOut);
+  BuildApply(sel, payload);
+  std::swap(host.props[0].matchName, host.props[1].matchName);
+  written = MockApplyEase(host, payload);
+  std::swap(host.props[0].matchName, host.props[1].matchName);
+  int others = 0;
+  for (size_t pair = 0; pair < sel.PairCount(); pair++)
+    others += sel.pairProp[pair] > 1 &&
+              EaseModel::Classify(PairSegment(sel, pair, 0)) != EaseModel::SHAPE_HOLD;
+  ok = Parse(MockKeyframeInfo(host), reload) && written == others;
+  for (size_t pair = 0; ok && pair < sel.PairCount(); pair++) {
+    if (sel.pairProp[pair] > 1)
+      continue;
+    EaseModel::Segment was = PairSegment(sel, pair, 0), now = PairSegment(reload, pair, 0);
+    ok = now.out.speed == was.out.speed && now.in.influence == was.in.influence;
+  }
+  Check("property matched by position + matchName (stale selection skipped)", ok);
+
+  // Malformed / partial input
+  std::string info = MockKeyframeInfo(host);
+  ok = !Parse(std::string_view(info).substr(0, info.size() / 2), sel) && sel.PairCount() == 0 &&
+       sel.props.empty() && sel.lastEdited == -1;
+  std::string keyOnly;
+  WireFormat::Writer keyWriter(keyOnly);
+  keyWriter.BeginRecord(WireFormat::KEY_DIMENSION);
+  for (int i = 0; i < 4; i++)
+    keyWriter.Int(1);
+  ok = ok && !Parse(keyOnly, sel) && !Parse("", sel);
+  Check("malformed info rejected, keys without a property ignored", ok);
+
+  // 10,000 selected keys through the mock host
+  const int KEYS = 10000;
+  MockKeyHost big = MakeKeyHost(KEYS, rng);
+  size_t keyTotal = 0;
+  for (const MockKeyProperty &prop : big.props)
+    keyTotal += prop.keys.size() > 1 ? prop.keys.size() : 0;
+  ok = Parse(MockKeyframeInfo(big), sel);
+  SetCurve(sel, sel.PairCount() / 2, easeInOut);
+  Selection before = sel;
+  ok = ok && BuildApply(sel, payload);
+  written = MockApplyEase(big, payload);
+  ok = ok && Parse(MockKeyframeInfo(big), reload) && big.calls == 3 && big.undoGroups == 1 &&
+       sel.PairCount() == keyTotal - (big.props.size() - 1) &&
+       ReloadMatches(before, reload, [&](size_t) { return easeInOut; });
+  Check("10,000 keys: applied in one call, reload shows the curve on every pair", ok);
+  return TestResult();
+}
@@ -0,0 +1,152 @@
+/*****************************************************************************
+ * LoggerTest.cpp
+ *
+ * Logger: level specs, binary records round-trip (multi-slot, multi-line,
+ * truncated, filtered), the damaged-tail decoder, the per-category rate
+ * limit, and a burst where every message is written or counted as dropped.
+ *****************************************************************************/
+
+#include "Logger.h"
+#include "TestCheck.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static std::string ReadWholeFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+// Decoded log: records of the last session, lost sequence numbers
+struct DecodedRecord {
+  Logger::RecordHeader header;
+  std::string text; // Copy: Logger::Record points into the file buffer
+};
+
+struct DecodedLog {
+  std::vector<DecodedRecord> records;
+  uint64_t lost = 0;
+  uint32_t next = 0; // Sequence after the last caller record
+  bool damaged = false;
+};
+
+static DecodedLog DecodeLog(const std::string &data) {
+  DecodedLog log;
+  size_t offset = 0;
+  while (offset < data.size()) {
+    Logger::FileHeader header;
+    if (Logger::ReadFileHeader(data.data(), data.size(), offset, header)) {
+      log = DecodedLog();
+      continue;
+    }
+    Logger::Record record;
+    if (!Logger::ReadRecord(data.data(), data.size(), offset, record)) {
+      log.damaged = true;
+      break;
+    }
+    if (record.header.sequence != UINT32_MAX) {
+      if (record.header.sequence > log.next)
+        log.lost += record.header.sequence - log.next;
+      log.next = record.header.sequence + 1;
+    }
+    log.records.push_back({record.header, std::string(record.text)});
+  }
+  return log;
+}
+
+int main() {
+  printf("Logger checks\n");
+  namespace fs = std::filesystem;
+  const std::string path = (fs::temp_directory_path() / "AnchorSnapTests.aslog").string();
+  std::error_code ec;
+  fs::remove(path, ec);
+
+  // Levels
+  Check("levels: default info, spec parsing",
+        !Logger::ShouldLog(Logger::CAT_INPUT, Logger::LEVEL_DEBUG) &&
+            Logger::ParseLevels("input=debug,Script=WARN") &&
+            Logger::ShouldLog(Logger::CAT_INPUT, Logger::LEVEL_DEBUG) &&
+            !Logger::ShouldLog(Logger::CAT_SCRIPT, Logger::LEVEL_INFO) &&
+            !Logger::ParseLevels("bogus=debug,*=info") &&
+            Logger::GetLevel(Logger::CAT_SCRIPT) == Logger::LEVEL_INFO);
+  Check("not started: messages are ignored",
+        !Logger::Log(Logger::CAT_GENERAL, Logger::LEVEL_INFO, "early"));
+
+  // Round trip: short, multi-slot, multi-line, over-long, filtered
+  Logger::ResetStats();
+  Logger::SetRateLimit(0);
+  Check("start", Logger::Start(path));
+  std::string longText(5000, 'x');
+  longText += " | ; \" \xED\x95\x9C\xEA\xB8\x80 end";
+  std::string tooLong(Logger::MAX_MESSAGE + 100, 'y');
+  Logger::Log(Logger::CAT_INPUT, Logger::LEVEL_WARN, "key %c held %d ms", 'Y', 420);
+  Logger::LogText(Logger::CAT_PROFILE, Logger::LEVEL_INFO, longText);
+  Logger::LogText(Logger::CAT_SCRIPT, Logger::LEVEL_INFO, "line 1\nline 2");
+  Logger::LogText(Logger::CAT_CATALOG, Logger::LEVEL_INFO, tooLong);
+  Logger::Log(Logger::CAT_IDLE, Logger::LEVEL_DEBUG, "filtered");
+  Logger::Stop();
+
+  DecodedLog log = DecodeLog(ReadWholeFile(path));
+  bool roundTrip = !log.damaged && log.records.size() == 4 &&
+                   log.records[0].text == "key Y held 420 ms" &&
+                   log.records[0].header.level == Logger::LEVEL_WARN &&
+                   log.records[0].header.category == Logger::CAT_INPUT &&
+                   log.records[1].text == longText && log.records[2].text == "line 1\nline 2" &&
+                   log.records[3].text.size() == Logger::MAX_MESSAGE && log.lost == 0;
+  Check("records round-trip (multi-slot, multi-line, truncated, filtered)", roundTrip);
+  Check("stats: logged / written / filtered",
+        Logger::GetStats().logged == 4 && Logger::GetStats().written == 4 &&
+            Logger::GetStats().filtered == 1);
+  Check("formatted line",
+        !log.records.empty() &&
+            Logger::FormatRecord({log.records[0].header, log.records[0].text}).find("WARN  input   key Y held") !=
+                std::string::npos);
+
+  // Damaged tail is detected
+  std::string data = ReadWholeFile(path);
+  data.resize(data.size() - 3);
+  Check("truncated file stops the decoder", DecodeLog(data).damaged);
+
+  // Rate limit: 50/s per category, the rest dropped and reported
+  Logger::ResetStats();
+  Logger::SetRateLimit(50);
+  Logger::Start(path);
+  for (int i = 0; i < 200; i++)
+    Logger::Log(Logger::CAT_INPUT, Logger::LEVEL_INFO, "burst %d", i);
+  Logger::Log(Logger::CAT_SCRIPT, Logger::LEVEL_INFO, "other category");
+  Logger::Stop();
+  log = DecodeLog(ReadWholeFile(path));
+  bool reported = false;
+  for (const DecodedRecord &record : log.records)
+    reported = reported || record.text.find("logger: dropped") != std::string::npos;
+  // A second boundary inside the burst may let up to 2 windows through
+  Logger::Stats rateStats = Logger::GetStats();
+  Check("rate limit drops the excess and reports it",
+        rateStats.droppedRate >= 100 && rateStats.logged <= 101 && reported && log.lost == 0);
+
+  // Burst faster than the flusher: every message is written or counted as
+  // dropped (ring full), drops after the last written record leave no gap
+  Logger::ResetStats();
+  Logger::SetRateLimit(0);
+  const int count = 200000;
+  Logger::Start(path);
+  for (int i = 0; i < count; i++)
+    Logger::Log(Logger::CAT_INPUT, Logger::LEVEL_INFO, "sample %d down=0x%x t=%llu", i,
+                i & 0x1ff, (unsigned long long)i * 16);
+  Logger::Stop();
+  Logger::Stats burstStats = Logger::GetStats();
+  log = DecodeLog(ReadWholeFile(path));
+  uint64_t trailing = (uint64_t)count - log.next;
+  Check("burst: every message written or counted as dropped",
+        !log.damaged && burstStats.logged + burstStats.droppedFull == (uint64_t)count &&
+            burstStats.written >= burstStats.logged &&
+            log.lost + trailing == burstStats.droppedFull);
+  fs::remove(path, ec);
+  Logger::SetRateLimit(1000);
+  Logger::ParseLevels("*=info");
+  return TestResult();
+}
@@ -0,0 +1,71 @@
+/*****************************************************************************
+ * ModuleRegistryTest.cpp
+ *
+ * ModuleRegistry: registration does not initialize, Ensure initializes
+ * once, failed init is reported and retried, re-entrant Ensure fails
+ * instead of recursing, and shutdown runs in reverse init order.
+ *****************************************************************************/
+
+#include "ModuleRegistry.h"
+#include "TestCheck.h"
+
+#include <string>
+
+static std::string s_moduleLog;  // "i<name> s<name> ..." in call order
+static int s_failuresLeft = 0;   // Flaky module: fails this many times
+static int s_reentrantId = -1;
+
+static bool InitA() { s_moduleLog += "iA "; return true; }
+static bool InitB() { s_moduleLog += "iB "; return true; }
+static bool InitFlaky() {
+  s_moduleLog += "iF ";
+  return s_failuresLeft-- <= 0;
+}
+static bool InitReentrant() {
+  s_moduleLog += "iR ";
+  return !ModuleRegistry::Ensure(s_reentrantId); // Must not recurse
+}
+static void ShutdownA() { s_moduleLog += "sA "; }
+static void ShutdownB() { s_moduleLog += "sB "; }
+static void ShutdownFlaky() { s_moduleLog += "sF "; }
+
+int main() {
+  printf("ModuleRegistry checks\n");
+  using namespace ModuleRegistry;
+  Reset();
+  s_moduleLog.clear();
+
+  int a = Register("A", InitA, ShutdownA);
+  int b = Register("B", InitB, ShutdownB);
+  int flaky = Register("Flaky", InitFlaky, ShutdownFlaky);
+  s_reentrantId = Register("Reentrant", InitReentrant, nullptr);
+  Check("registration does not initialize",
+        s_moduleLog.empty() && GetState(a) == STATE_REGISTERED && b == 1);
+
+  bool first = Ensure(b), second = Ensure(b);
+  Check("first Ensure initializes once", first && second && s_moduleLog == "iB " &&
+                                             GetState(b) == STATE_READY &&
+                                             GetStats()[b].attempts == 1);
+
+  s_failuresLeft = 1;
+  bool failed = !Ensure(flaky) && GetState(flaky) == STATE_FAILED;
+  bool retried = Ensure(flaky) && GetState(flaky) == STATE_READY && GetStats()[flaky].attempts == 2;
+  Check("failed init is reported and retried", failed && retried);
+
+  Check("re-entrant Ensure fails instead of recursing",
+        Ensure(s_reentrantId) && GetStats()[s_reentrantId].attempts == 1);
+  Check("unknown id", !Ensure(99) && GetState(-1) == STATE_FAILED);
+
+  Ensure(a);
+  s_moduleLog.clear();
+  ShutdownAll();
+  Check("shutdown in reverse init order, ready modules only",
+        s_moduleLog == "sA sF sB " && GetState(a) == STATE_SHUT_DOWN && !Ensure(a));
+  std::string report = FormatReport();
+  Check("report lists every module",
+        report.find("4 registered") != std::string::npos &&
+            report.find("Flaky") != std::string::npos);
+
+  Reset();
+  return TestResult();
+}
@@ -0,0 +1,523 @@
+/*****************************************************************************
+ * PaintFixtures.h
+ *
+ * GDI+ paint fixtures (Windows only) shared by RenderContextTest /
+ * IconAtlasTest / GridUITest and tools/ScriptBench:
+ *   - PaintTarget: top-down 32-bit DIB whose pixels can be compared
+ *   - a representative panel (header, 12 rows, icons, right-aligned text)
+ *     painted the old way (per-paint memory DC, fresh resources) and with
+ *     RenderContext (Backbuffer, pooled resources)
+ *   - the same comparison per module (Grid, Control, Keyframe, Align, Text,
+ *     Shape, Comp, DMenu) from each module's own paint profile
+ *   - an icon bar (6 preset-style AA icons) drawn directly or via IconAtlas
+ *   - a hover sweep over the real GridUI window, timed by its Profiler sites
+ *****************************************************************************/
+
+#pragma once
+
+#include "GdiPlusIncludes.h"
+#include "IconAtlas.h"
+#include "Profiler.h"
+#include "RenderContext.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// Window stand-in: a top-down 32-bit DIB
+struct PaintTarget {
+  int width = 0;
+  int height = 0;
+  HDC dc = NULL;
+  HBITMAP bitmap = NULL;
+  HGDIOBJ old = NULL;
+  void *bits = nullptr;
+
+  PaintTarget(HDC screen, int w, int h) : width(w), height(h) {
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = width;
+    info.bmiHeader.biHeight = -height;
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+    dc = CreateCompatibleDC(screen);
+    bitmap = CreateDIBSection(screen, &info, DIB_RGB_COLORS, &bits, NULL, 0);
+    old = SelectObject(dc, bitmap);
+  }
+  ~PaintTarget() {
+    SelectObject(dc, old);
+    DeleteObject(bitmap);
+    DeleteDC(dc);
+  }
+  PaintTarget(const PaintTarget &) = delete;
+  PaintTarget &operator=(const PaintTarget &) = delete;
+
+  bool SamePixels(const PaintTarget &other) const { return MaxDiff(other) == 0; }
+
+  // Largest channel difference (AA edges round differently through the atlas)
+  int MaxDiff(const PaintTarget &other) const {
+    GdiFlush();
+    if (!bits || !other.bits || width != other.width || height != other.height)
+      return 255;
+    const BYTE *a = (const BYTE *)bits;
+    const BYTE *b = (const BYTE *)other.bits;
+    int worst = 0;
+    for (size_t i = 0; i < (size_t)width * height * 4; i++) {
+      int d = abs((int)a[i] - (int)b[i]);
+      if (d > worst)
+        worst = d;
+    }
+    return worst;
+  }
+};
+
+/*****************************************************************************
+ * Panel: fresh resources vs RenderContext
+ *****************************************************************************/
+static const int PANEL_WIDTH = 280;
+static const int PANEL_HEIGHT = 420;
+static const int PANEL_ROW_COUNT = 12;
+static const int PANEL_ROW_HEIGHT = 28;
+
+static const Gdiplus::Color PANEL_BG(255, 30, 30, 36);
+static const Gdiplus::Color PANEL_BORDER(255, 60, 60, 70);
+static const Gdiplus::Color PANEL_TEXT(255, 220, 220, 220);
+static const Gdiplus::Color PANEL_TEXT_DIM(255, 140, 140, 140);
+static const Gdiplus::Color PANEL_ACCENT(255, 74, 158, 255);
+static const Gdiplus::Color PANEL_HOVER(255, 50, 50, 60);
+
+static const wchar_t *const PANEL_ROW_NAMES[PANEL_ROW_COUNT] = {
+    L"Gaussian Blur", L"Drop Shadow", L"Glow",      L"Curves",   L"Levels",  L"Fill",
+    L"Stroke",        L"Turbulent Displace", L"Fast Box Blur", L"Tint", L"Exposure", L"Echo"};
+
+// Module-style paint: every resource constructed where it is used
+inline void DrawPanelFresh(HDC hdc, int hoverRow) {
+  using namespace Gdiplus;
+  Graphics graphics(hdc);
+  graphics.SetSmoothingMode(SmoothingModeAntiAlias);
+  graphics.SetTextRenderingHint(TextRenderingHintClearTypeGridFit);
+
+  SolidBrush bgBrush(PANEL_BG);
+  graphics.FillRectangle(&bgBrush, 0, 0, PANEL_WIDTH, PANEL_HEIGHT);
+  Pen borderPen(PANEL_BORDER, 1);
+  graphics.DrawRectangle(&borderPen, 0, 0, PANEL_WIDTH - 1, PANEL_HEIGHT - 1);
+
+  FontFamily fontFamily(L"Segoe UI");
+  Font headerFont(&fontFamily, 12, FontStyleBold, UnitPixel);
+  SolidBrush textBrush(PANEL_TEXT);
+  StringFormat sf;
+  sf.SetAlignment(StringAlignmentNear);
+  sf.SetLineAlignment(StringAlignmentCenter);
+  graphics.DrawString(L"Effects", -1, &headerFont, RectF(8, 4, 200, 24), &sf, &textBrush);
+
+  for (int i = 0; i < PANEL_ROW_COUNT; i++) {
+    REAL y = (REAL)(36 + i * PANEL_ROW_HEIGHT);
+    if (i == hoverRow) {
+      SolidBrush hoverBrush(PANEL_HOVER);
+      graphics.FillRectangle(&hoverBrush, RectF(4, y, PANEL_WIDTH - 8, PANEL_ROW_HEIGHT));
+    }
+    Pen iconPen(i == hoverRow ? PANEL_ACCENT : PANEL_TEXT_DIM, 1.5f);
+    graphics.DrawEllipse(&iconPen, 10.0f, y + 8, 12.0f, 12.0f);
+
+    Font itemFont(&fontFamily, 12, FontStyleRegular, UnitPixel);
+    SolidBrush itemBrush(PANEL_TEXT);
+    StringFormat itemFormat;
+    itemFormat.SetAlignment(StringAlignmentNear);
+    itemFormat.SetLineAlignment(StringAlignmentCenter);
+    graphics.DrawString(PANEL_ROW_NAMES[i], -1, &itemFont, RectF(30, y, 160, PANEL_ROW_HEIGHT),
+                        &itemFormat, &itemBrush);
+
+    Font indexFont(&fontFamily, 10, FontStyleRegular, UnitPixel);
+    SolidBrush dimBrush(PANEL_TEXT_DIM);
+    StringFormat sfRight;
+    sfRight.SetAlignment(StringAlignmentFar);
+    sfRight.SetLineAlignment(StringAlignmentCenter);
+    wchar_t index[8];
+    swprintf(index, 8, L"%d", i + 1);
+    graphics.DrawString(index, -1, &indexFont, RectF(200, y, 70, PANEL_ROW_HEIGHT), &sfRight,
+                        &dimBrush);
+  }
+}
+
+// Same panel with pooled resources
+inline void DrawPanelPooled(HDC hdc, int hoverRow) {
+  using namespace Gdiplus;
+  Graphics graphics(hdc);
+  graphics.SetSmoothingMode(SmoothingModeAntiAlias);
+  graphics.SetTextRenderingHint(TextRenderingHintClearTypeGridFit);
+
+  graphics.FillRectangle(RenderContext::Brush(PANEL_BG), 0, 0, PANEL_WIDTH, PANEL_HEIGHT);
+  graphics.DrawRectangle(RenderContext::Pen(PANEL_BORDER, 1), 0, 0, PANEL_WIDTH - 1,
+                         PANEL_HEIGHT - 1);
+
+  const StringFormat *sf = RenderContext::Format(StringAlignmentNear);
+  const SolidBrush *textBrush = RenderContext::Brush(PANEL_TEXT);
+  graphics.DrawString(L"Effects", -1, RenderContext::Font(12, FontStyleBold), RectF(8, 4, 200, 24),
+                      sf, textBrush);
+
+  for (int i = 0; i < PANEL_ROW_COUNT; i++) {
+    REAL y = (REAL)(36 + i * PANEL_ROW_HEIGHT);
+    if (i == hoverRow)
+      graphics.FillRectangle(RenderContext::Brush(PANEL_HOVER),
+                             RectF(4, y, PANEL_WIDTH - 8, PANEL_ROW_HEIGHT));
+    graphics.DrawEllipse(RenderContext::Pen(i == hoverRow ? PANEL_ACCENT : PANEL_TEXT_DIM, 1.5f),
+                         10.0f, y + 8, 12.0f, 12.0f);
+    graphics.DrawString(PANEL_ROW_NAMES[i], -1, RenderContext::Font(12),
+                        RectF(30, y, 160, PANEL_ROW_HEIGHT), sf, textBrush);
+    wchar_t index[8];
+    swprintf(index, 8, L"%d", i + 1);
+    graphics.DrawString(index, -1, RenderContext::Font(10), RectF(200, y, 70, PANEL_ROW_HEIGHT),
+                        RenderContext::Format(StringAlignmentFar),
+                        RenderContext::Brush(PANEL_TEXT_DIM));
+  }
+}
+
+// Before: the per-paint double buffer every WM_PAINT used
+inline void PaintPanelBefore(HDC target, int hoverRow) {
+  HDC memDC = CreateCompatibleDC(target);
+  HBITMAP memBitmap = CreateCompatibleBitmap(target, PANEL_WIDTH, PANEL_HEIGHT);
+  HGDIOBJ oldBitmap = SelectObject(memDC, memBitmap);
+  DrawPanelFresh(memDC, hoverRow);
+  BitBlt(target, 0, 0, PANEL_WIDTH, PANEL_HEIGHT, memDC, 0, 0, SRCCOPY);
+  SelectObject(memDC, oldBitmap);
+  DeleteObject(memBitmap);
+  DeleteDC(memDC);
+}
+
+inline void PaintPanelAfter(RenderContext::Backbuffer &backbuffer, HDC target, int hoverRow) {
+  HDC memDC = backbuffer.Begin(target, PANEL_WIDTH, PANEL_HEIGHT);
+  DrawPanelPooled(memDC, hoverRow);
+  backbuffer.Present(target, PANEL_WIDTH, PANEL_HEIGHT);
+}
+
+/*****************************************************************************
+ * Module paints: fresh resources vs RenderContext
+ *****************************************************************************/
+// One module's WM_PAINT before the shared render context, reduced to what it
+// cost: the client area at scale 1.0, a header (background, border, title
+// bar buttons, the module's fixed sections) and `items` repeated rows /
+// buttons / cells, with the SolidBrush / Pen / Font / StringFormat /
+// FontFamily objects each part constructed per paint, counted from the
+// module's draw functions
+struct ModulePaint {
+  const char *name;
+  int width, height;
+  int columns; // Items per row (1: list)
+  int items;
+  int headerBrushes, headerPens, headerFonts, headerFormats, headerFamilies, headerStrings;
+  int itemBrushes, itemPens, itemFonts, itemFormats, itemStrings; // Per item
+};
+
+static const ModulePaint MODULE_PAINTS[] = {
+    // Grid 7x7 @ 1.7: per-cell mark pen + dot brush, 8 side / copy-paste
+    // icons (pen + brushes, numbered ones with font + format)
+    {"Grid", 386, 333, 7, 49, 18, 10, 3, 3, 3, 3, 1, 1, 0, 0, 0},
+    // Control Mode 2: header, 6 preset buttons + icons, save, search;
+    // 8 effect rows (expand, index, name, delete pen)
+    {"Control", 320, 388, 1, 8, 19, 14, 3, 2, 1, 2, 0, 1, 0, 0, 3},
+    // Keyframe: header, nav, velocity graph, lock, value, save / apply /
+    // load; 12 preset thumbnails (background, curve and border)
+    {"Keyframe", 400, 460, 6, 12, 26, 17, 5, 5, 2, 8, 1, 3, 0, 0, 0},
+    // Align: header tabs, pin, close; 6 align buttons (background, icon)
+    {"Align", 280, 180, 3, 6, 9, 3, 1, 1, 1, 4, 2, 1, 0, 0, 0},
+    // Text: header, font / color / value sections with their value boxes;
+    // 7 align buttons
+    {"Text", 280, 195, 7, 7, 26, 9, 11, 6, 8, 14, 2, 1, 0, 0, 0},
+    // Shape: header, expanded appearance section; 3 section headers
+    {"Shape", 300, 320, 1, 3, 13, 3, 3, 0, 2, 7, 2, 0, 2, 0, 2},
+    // Comp: header, pin; 6 action buttons (label, shortcut, description)
+    {"Comp", 280, 288, 1, 6, 6, 2, 2, 1, 1, 2, 4, 0, 3, 0, 3},
+    // DMenu: 5 items sharing the paint's fonts and brushes
+    {"DMenu", 140, 154, 1, 5, 4, 1, 2, 0, 1, 0, 0, 0, 0, 0, 2},
+};
+static const int MODULE_PAINT_COUNT = (int)(sizeof(MODULE_PAINTS) / sizeof(MODULE_PAINTS[0]));
+
+// Objects one paint constructed before RenderContext (hover brush included)
+inline int ModulePaintResources(const ModulePaint &m) {
+  int perItem = m.itemBrushes + m.itemPens + m.itemFonts + m.itemFormats + (m.itemFonts ? 1 : 0);
+  return m.headerBrushes + m.headerPens + m.headerFonts + m.headerFormats + m.headerFamilies +
+         m.items * perItem + 1;
+}
+
+// Resources constructed where they are used, freed at the end of the paint
+struct FreshResources {
+  std::vector<std::unique_ptr<Gdiplus::SolidBrush>> brushes;
+  std::vector<std::unique_ptr<Gdiplus::Pen>> pens;
+  std::vector<std::unique_ptr<Gdiplus::FontFamily>> families;
+  std::vector<std::unique_ptr<Gdiplus::Font>> fonts;
+  std::vector<std::unique_ptr<Gdiplus::StringFormat>> formats;
+
+  void Family() { families.emplace_back(new Gdiplus::FontFamily(L"Segoe UI")); }
+  const Gdiplus::SolidBrush *Brush(const Gdiplus::Color &color) {
+    brushes.emplace_back(new Gdiplus::SolidBrush(color));
+    return brushes.back().get();
+  }
+  const Gdiplus::Pen *Pen(const Gdiplus::Color &color, Gdiplus::REAL width) {
+    pens.emplace_back(new Gdiplus::Pen(color, width));
+    return pens.back().get();
+  }
+  const Gdiplus::Font *Font(Gdiplus::REAL size, INT style) {
+    fonts.emplace_back(new Gdiplus::Font(families.back().get(), size, style, Gdiplus::UnitPixel));
+    return fonts.back().get();
+  }
+  const Gdiplus::StringFormat *Format(Gdiplus::StringAlignment align) {
+    formats.emplace_back(new Gdiplus::StringFormat());
+    formats.back()->SetAlignment(align);
+    formats.back()->SetLineAlignment(Gdiplus::StringAlignmentCenter);
+    return formats.back().get();
+  }
+};
+
+// The same lookups through the pools
+struct PooledResources {
+  void Family() {}
+  const Gdiplus::SolidBrush *Brush(const Gdiplus::Color &color) {
+    return RenderContext::Brush(color);
+  }
+  const Gdiplus::Pen *Pen(const Gdiplus::Color &color, Gdiplus::REAL width) {
+    return RenderContext::Pen(color, width);
+  }
+  const Gdiplus::Font *Font(Gdiplus::REAL size, INT style) {
+    return RenderContext::Font(size, style);
+  }
+  const Gdiplus::StringFormat *Format(Gdiplus::StringAlignment align) {
+    return RenderContext::Format(align);
+  }
+};
+
+// Resource i of a part (region 0: header, 1: items)
+inline Gdiplus::Color ModuleColor(int region, int i) {
+  return Gdiplus::Color(255, (BYTE)(30 + (37 * i + 90 * region) % 200),
+                        (BYTE)(40 + (53 * i) % 180), (BYTE)(50 + (71 * i + 30 * region) % 170));
+}
+inline Gdiplus::REAL ModulePenWidth(int i) { return i % 3 == 0 ? 1.0f : i % 3 == 1 ? 1.5f : 2.0f; }
+inline Gdiplus::REAL ModuleFontSize(int i) { return (Gdiplus::REAL)(9 + i % 4); }
+inline Gdiplus::StringAlignment ModuleAlign(int i) {
+  return i % 3 == 0 ? Gdiplus::StringAlignmentNear
+         : i % 3 == 1 ? Gdiplus::StringAlignmentCenter
+                      : Gdiplus::StringAlignmentFar;
+}
+
+template <typename Resources>
+inline void DrawModulePaint(HDC hdc, const ModulePaint &m, int hoverItem, Resources &res) {
+  using namespace Gdiplus;
+  const int HEADER = 28, PAD = 8, GAP = 4;
+  Graphics graphics(hdc);
+  graphics.SetSmoothingMode(SmoothingModeAntiAlias);
+  graphics.SetTextRenderingHint(TextRenderingHintClearTypeGridFit);
+
+  // Header: background, title bar, swatches / buttons, border and strokes
+  std::vector<const SolidBrush *> headerBrushes;
+  for (int b = 0; b < m.headerBrushes; b++)
+    headerBrushes.push_back(res.Brush(ModuleColor(0, b)));
+  graphics.FillRectangle(headerBrushes[0], 0, 0, m.width, m.height);
+  for (int b = 1; b < m.headerBrushes; b++)
+    graphics.FillRectangle(headerBrushes[b], RectF((REAL)(m.width - 10 * b - 4), 8, 8, 12));
+  for (int p = 0; p < m.headerPens; p++) {
+    const Gdiplus::Pen *pen = res.Pen(ModuleColor(0, p + 7), ModulePenWidth(p));
+    if (p == 0)
+      graphics.DrawRectangle(pen, 0, 0, m.width - 1, m.height - 1);
+    else
+      graphics.DrawLine(pen, (REAL)(PAD + 9 * p), 6.0f, (REAL)(PAD + 9 * p + 6), 22.0f);
+  }
+  std::vector<const Gdiplus::Font *> headerFonts;
+  std::vector<const StringFormat *> headerFormats;
+  for (int f = 0; f < m.headerFamilies; f++)
+    res.Family();
+  for (int f = 0; f < m.headerFonts; f++)
+    headerFonts.push_back(res.Font(ModuleFontSize(f), f == 0 ? FontStyleBold : FontStyleRegular));
+  for (int f = 0; f < m.headerFormats; f++)
+    headerFormats.push_back(res.Format(ModuleAlign(f)));
+  for (int s = 0; s < m.headerStrings; s++) {
+    const Gdiplus::Font *font = headerFonts[s % m.headerFonts];
+    const SolidBrush *brush = headerBrushes[(s + 1) % m.headerBrushes];
+    const wchar_t *text = PANEL_ROW_NAMES[s % PANEL_ROW_COUNT];
+    if (m.headerFormats)
+      graphics.DrawString(text, -1, font, RectF((REAL)PAD, 4, (REAL)(m.width / 2), 20),
+                          headerFormats[s % m.headerFormats], brush);
+    else
+      graphics.DrawString(text, -1, font, PointF((REAL)PAD, 6), brush);
+  }
+
+  // Items
+  int rows = (m.items + m.columns - 1) / m.columns;
+  REAL itemW = (REAL)(m.width - PAD * 2 - GAP * (m.columns - 1)) / m.columns;
+  REAL itemH = (REAL)(m.height - HEADER - PAD - GAP * (rows - 1)) / rows;
+  if (itemH > 32)
+    itemH = 32;
+  for (int i = 0; i < m.items; i++) {
+    REAL x = PAD + (i % m.columns) * (itemW + GAP), y = HEADER + (i / m.columns) * (itemH + GAP);
+    std::vector<const SolidBrush *> brushes;
+    for (int b = 0; b < m.itemBrushes; b++)
+      brushes.push_back(res.Brush(ModuleColor(1, b)));
+    if (i == hoverItem)
+      graphics.FillRectangle(res.Brush(PANEL_HOVER), RectF(x, y, itemW, itemH));
+    else if (m.itemBrushes)
+      graphics.FillRectangle(brushes[0], RectF(x, y, itemW, itemH));
+    for (int b = 1; b < m.itemBrushes; b++)
+      graphics.FillEllipse(brushes[b], x + 4 + 8 * (b - 1), y + 4, 6.0f, 6.0f);
+    for (int p = 0; p < m.itemPens; p++) {
+      const Gdiplus::Pen *pen = res.Pen(ModuleColor(1, p + 5), ModulePenWidth(p));
+      if (p == 0)
+        graphics.DrawRectangle(pen, x, y, itemW - 1, itemH - 1);
+      else
+        graphics.DrawBezier(pen, x + 4, y + itemH - 4, x + itemW / 3, y + 4, x + itemW * 2 / 3,
+                            y + itemH - 4, x + itemW - 4, y + 4);
+    }
+    std::vector<const Gdiplus::Font *> fonts;
+    if (m.itemFonts)
+      res.Family();
+    for (int f = 0; f < m.itemFonts; f++)
+      fonts.push_back(res.Font(ModuleFontSize(f + 1), FontStyleRegular));
+    std::vector<const StringFormat *> formats;
+    for (int f = 0; f < m.itemFormats; f++)
+      formats.push_back(res.Format(ModuleAlign(f)));
+    for (int s = 0; s < m.itemStrings; s++) {
+      const Gdiplus::Font *font = m.itemFonts ? fonts[s % m.itemFonts]
+                                              : headerFonts[(s + 1) % m.headerFonts];
+      const SolidBrush *brush = m.itemBrushes > 1 ? brushes[1 + s % (m.itemBrushes - 1)]
+                                                  : headerBrushes[(s + 2) % m.headerBrushes];
+      const StringFormat *format = m.itemFormats   ? formats[s % m.itemFormats]
+                                   : m.headerFormats ? headerFormats[s % m.headerFormats]
+                                                     : nullptr;
+      const wchar_t *text = PANEL_ROW_NAMES[(i + s) % PANEL_ROW_COUNT];
+      REAL lineH = itemH / m.itemStrings;
+      if (format)
+        graphics.DrawString(text, -1, font, RectF(x + 16, y + s * lineH, itemW - 20, lineH), format,
+                            brush);
+      else
+        graphics.DrawString(text, -1, font, PointF(x + 16, y + s * lineH), brush);
+    }
+  }
+}
+
+// Before: per-paint double buffer + fresh resources
+inline void PaintModuleBefore(HDC target, const ModulePaint &m, int hoverItem) {
+  HDC memDC = CreateCompatibleDC(target);
+  HBITMAP memBitmap = CreateCompatibleBitmap(target, m.width, m.height);
+  HGDIOBJ oldBitmap = SelectObject(memDC, memBitmap);
+  {
+    FreshResources res;
+    DrawModulePaint(memDC, m, hoverItem, res);
+  }
+  BitBlt(target, 0, 0, m.width, m.height, memDC, 0, 0, SRCCOPY);
+  SelectObject(memDC, oldBitmap);
+  DeleteObject(memBitmap);
+  DeleteDC(memDC);
+}
+
+// After: the window's Backbuffer + pooled resources
+inline void PaintModuleAfter(RenderContext::Backbuffer &backbuffer, HDC target,
+                             const ModulePaint &m, int hoverItem) {
+  HDC memDC = backbuffer.Begin(target, m.width, m.height);
+  PooledResources res;
+  DrawModulePaint(memDC, m, hoverItem, res);
+  backbuffer.Present(target, m.width, m.height);
+}
+
+/*****************************************************************************
+ * Icon bar: direct vs IconAtlas
+ *****************************************************************************/
+static const int BAR_WIDTH = 200;
+static const int BAR_HEIGHT = 40;
+static const int BAR_ICON_COUNT = 6;
+static const float BAR_ICON_SIZE = 28.0f;
+static const float BAR_SCALE = 1.5f;
+
+// Preset-style icons: star, bolt, concentric circles, wave (state: filled)
+inline void RasterBarIcon(Gdiplus::Graphics &graphics, int icon, uint32_t state,
+                          const Gdiplus::RectF &rect) {
+  using namespace Gdiplus;
+  float cx = rect.X + rect.Width / 2;
+  float cy = rect.Y + rect.Height / 2;
+  float r = rect.Width / 2 - 4;
+  Color color = state ? Color(255, 255, 255, 255) : Color(255, 100, 100, 110);
+  const Pen *pen = RenderContext::Pen(color, 2);
+  const SolidBrush *brush = RenderContext::Brush(color);
+
+  switch (icon % 4) {
+  case 0: {
+    PointF star[10];
+    for (int i = 0; i < 10; i++) {
+      float angle = (i * 36.0f - 90.0f) * 3.14159f / 180.0f;
+      float sr = (i % 2 == 0) ? r : r * 0.45f;
+      star[i] = PointF(cx + cosf(angle) * sr, cy + sinf(angle) * sr);
+    }
+    GraphicsPath path;
+    path.AddPolygon(star, 10);
+    graphics.FillPath(brush, &path);
+    break;
+  }
+  case 1: {
+    PointF bolt[] = {PointF(cx + r * 0.2f, cy - r),        PointF(cx - r * 0.3f, cy - r * 0.1f),
+                     PointF(cx + r * 0.1f, cy - r * 0.1f), PointF(cx - r * 0.2f, cy + r),
+                     PointF(cx + r * 0.3f, cy + r * 0.1f), PointF(cx - r * 0.1f, cy + r * 0.1f)};
+    GraphicsPath path;
+    path.AddPolygon(bolt, 6);
+    graphics.FillPath(brush, &path);
+    break;
+  }
+  case 2:
+    graphics.DrawEllipse(pen, cx - r, cy - r, r * 2, r * 2);
+    graphics.DrawEllipse(pen, cx - r * 0.6f, cy - r * 0.6f, r * 1.2f, r * 1.2f);
+    graphics.DrawEllipse(pen, cx - r * 0.25f, cy - r * 0.25f, r * 0.5f, r * 0.5f);
+    break;
+  default: {
+    PointF wave[7];
+    for (int i = 0; i < 7; i++)
+      wave[i] = PointF(cx - r + r * 2 * i / 6.0f, cy + sinf(i * 3.14159f / 2) * r * 0.5f);
+    graphics.DrawCurve(pen, wave, 7, 0.5f);
+    break;
+  }
+  }
+}
+
+// One bar paint; `hover`: filled icon
+inline void PaintBar(HDC hdc, bool atlas, int hover) {
+  using namespace Gdiplus;
+  Graphics graphics(hdc);
+  graphics.SetSmoothingMode(SmoothingModeAntiAlias);
+  graphics.ScaleTransform(BAR_SCALE, BAR_SCALE);
+  graphics.FillRectangle(RenderContext::Brush(PANEL_BG), 0, 0, BAR_WIDTH, BAR_HEIGHT);
+  for (int i = 0; i < BAR_ICON_COUNT; i++) {
+    RectF rect(4.0f + i * (BAR_ICON_SIZE + 4.0f), 4.0f, BAR_ICON_SIZE, BAR_ICON_SIZE);
+    uint32_t state = i == hover ? 1 : 0;
+    if (atlas)
+      IconAtlas::Draw(graphics, IconAtlas::OWNER_CONTROL, i, state, rect, RasterBarIcon);
+    else
+      RasterBarIcon(graphics, i, state, rect);
+  }
+}
+
+inline int BarDeviceWidth() { return (int)(BAR_WIDTH * BAR_SCALE); }
+inline int BarDeviceHeight() { return (int)(BAR_HEIGHT * BAR_SCALE); }
+
+/*****************************************************************************
+ * Profiler sites of a real window's paints
+ *****************************************************************************/
+inline Profiler::SiteStats FindSite(const char *label) {
+  for (const Profiler::SiteStats &site : Profiler::GetStats()) {
+    if (site.label == label)
+      return site;
+  }
+  return Profiler::SiteStats();
+}
+
+inline double MeanUs(const Profiler::SiteStats &site) {
+  return site.count ? (double)site.totalNs / 1e3 / site.count : 0.0;
+}
+
+// Raster over a window: cells, side icons, copy / paste, gaps
+inline std::vector<POINT> RasterPath(const RECT &window) {
+  std::vector<POINT> path;
+  for (LONG y = window.top + 3; y < window.bottom; y += 13) {
+    for (LONG x = window.left + 3; x < window.right; x += 11)
+      path.push_back({x, y});
+  }
+  return path;
+}
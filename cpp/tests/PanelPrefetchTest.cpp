@@ -0,0 +1,62 @@
+/*****************************************************************************
+ * PanelPrefetchTest.cpp
+ *
+ * PanelPrefetch against a mock panelSnapshot(): sections equal the single
+ * info calls, the selection section refreshes ContextCache, and stale,
+ * discarded, failed or short snapshots fall back to the per-panel calls.
+ *****************************************************************************/
+
+#include "ContextCache.h"
+#include "ContextFixtures.h"
+#include "PanelPrefetch.h"
+#include "TestCheck.h"
+#include "WireFormat.h"
+
+#include <string>
+#include <string_view>
+
+int main() {
+  printf("PanelPrefetch checks\n");
+  MockContextHost host;
+  host.wire = PanelSnapshotWire();
+  PanelPrefetch::SetQuery(MockContextQuery, &host);
+  PanelPrefetch::ResetStats();
+  ContextCache::ResetStats();
+
+  bool found = true;
+  PanelPrefetch::Section(WireFormat::PANEL_TEXT, found);
+  bool ok = !found && !PanelPrefetch::IsPending();
+  PanelPrefetch::Arm();
+  ok = ok && PanelPrefetch::IsPending() && PanelPrefetch::Run() && host.calls == 1;
+  for (int f = WireFormat::PANEL_TEXT; f < WireFormat::PANEL_FIELD_COUNT; f++) {
+    std::string_view section = PanelPrefetch::Section((WireFormat::PanelField)f, found);
+    ok = ok && found && section == PanelRecord((WireFormat::PanelField)f);
+  }
+  Check("snapshot sections match the single info calls", ok);
+
+  // The selection section refreshed ContextCache (no selectionContext() call)
+  ok = ContextCache::IsValid() && ContextCache::Get().HasSelected(ContextCache::LAYER_TEXT) &&
+       ContextCache::GetStats().refreshes == 0;
+  Check("selection section adopted by ContextCache", ok);
+
+  ContextCache::Invalidate(); // E.g. a click in AE while the menu is up
+  PanelPrefetch::Section(WireFormat::PANEL_SHAPE, found);
+  ok = !found && PanelPrefetch::GetStats().stale == 1;
+  PanelPrefetch::Discard();
+  PanelPrefetch::Section(WireFormat::PANEL_SHAPE, found);
+  ok = ok && !found;
+  Check("stale or discarded snapshot falls back", ok);
+
+  host.fail = true;
+  PanelPrefetch::Arm();
+  ok = !PanelPrefetch::Run() && !PanelPrefetch::IsPending();
+  PanelPrefetch::Section(WireFormat::PANEL_TEXT, found);
+  ok = ok && !found && PanelPrefetch::GetStats().failures == 1;
+  host.fail = false;
+  host.wire = "R2:s0:s0:"; // Too few sections
+  PanelPrefetch::Arm();
+  ok = ok && !PanelPrefetch::Run();
+  Check("failed or short snapshot is not used", ok);
+  PanelPrefetch::SetQuery(nullptr, nullptr);
+  return TestResult();
+}
@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * ProfilerTest.cpp
+ *
+ * Profiler: log-linear buckets (contiguous, <= 6.25% wide), percentiles
+ * within one bucket, scoped probes / sections only while enabled, per call
+ * site, and the bounded site table.
+ *****************************************************************************/
+
+#include "Profiler.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+int main() {
+  printf("Profiler checks\n");
+  Profiler::Reset();
+
+  // Every value falls inside its bucket; bucket width <= 1/16 of its start
+  bool inside = true, narrow = true, ordered = true;
+  uint32_t seed = 99;
+  for (int i = 0; i < 200000; i++) {
+    seed = seed * 1664525u + 1013904223u;
+    uint64_t v = ((uint64_t)seed << 8) >> (seed % 40);
+    int b = Profiler::BucketFor(v);
+    inside = inside && Profiler::BucketLow(b) <= v && v <= Profiler::BucketHigh(b);
+  }
+  for (int b = 16; b < Profiler::BUCKET_COUNT - 1; b++) {
+    uint64_t low = Profiler::BucketLow(b), high = Profiler::BucketHigh(b);
+    narrow = narrow && (double)(high - low + 1) <= (double)low / 16.0;
+    ordered = ordered && Profiler::BucketLow(b + 1) == high + 1;
+  }
+  Check("values fall inside their bucket", inside);
+  Check("buckets are contiguous and within 6.25% wide", narrow && ordered);
+  Check("huge values land in the last bucket",
+        Profiler::BucketFor(UINT64_MAX) == Profiler::BUCKET_COUNT - 1);
+
+  // Uniform 1..100000 ns: p50 ~ 50 us, p99 ~ 99 us, exact max
+  static const char kUniform[] = "test.uniform";
+  for (uint64_t v = 1; v <= 100000; v++)
+    Profiler::Record(kUniform, 0, v);
+  uint64_t p50 = Profiler::Percentile(kUniform, 0, 0.50);
+  uint64_t p99 = Profiler::Percentile(kUniform, 0, 0.99);
+  uint64_t p100 = Profiler::Percentile(kUniform, 0, 1.0);
+  Check("percentiles within one bucket of the exact value",
+        fabs((double)p50 - 50000.0) <= 50000.0 / 16.0 &&
+            fabs((double)p99 - 99000.0) <= 99000.0 / 16.0 && p100 == 100000);
+
+  // Scoped probes only record while enabled; sections end each other
+  static const char kScope[] = "test.scope";
+  { Profiler::Scope scope(kScope); }
+  Profiler::SetEnabled(true);
+  { Profiler::Scope scope(kScope); }
+  { Profiler::Scope scope(kScope, 42); } // Same label, other call site
+  {
+    Profiler::Sections sections;
+    sections.Enter("test.section.a");
+    sections.Enter("test.section.b");
+  }
+  Profiler::SetEnabled(false);
+  std::vector<Profiler::SiteStats> stats = Profiler::GetStats();
+  auto countOf = [&stats](const char *label) -> uint64_t {
+    for (const Profiler::SiteStats &entry : stats) {
+      if (entry.label == label)
+        return entry.count;
+    }
+    return UINT64_MAX;
+  };
+  Check("probes record only while enabled, per call site",
+        countOf("test.scope") == 1 && countOf("test.scope:42") == 1);
+  Check("sections end each other and on scope exit",
+        countOf("test.section.a") == 1 && countOf("test.section.b") == 1);
+  Check("sites sorted by total time", !stats.empty() && stats[0].label == kUniform);
+
+  // Site table is bounded: extra sites are dropped and reported
+  static const char kManySites[] = "test.site";
+  for (int line = 1; line <= Profiler::MAX_SITES + 10; line++)
+    Profiler::Record(kManySites, line, 100);
+  std::string report = Profiler::FormatReport();
+  Check("site limit: extra sites dropped and reported",
+        Profiler::DroppedSites() > 0 && report.find("dropped") != std::string::npos &&
+            report.find("test.uniform") != std::string::npos);
+  Profiler::Reset();
+  return TestResult();
+}
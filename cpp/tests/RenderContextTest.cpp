@@ -0,0 +1,98 @@
+/*****************************************************************************
+ * RenderContextTest.cpp (Windows only)
+ *
+ * RenderContext: one GDI+ session for every module, brushes / pens / fonts /
+ * string formats pooled by their keys, the pooled panel paint (and every
+ * module's paint profile) and the reused Backbuffer draw the same pixels as
+ * the old per-paint resources, LRU eviction never drops what the current
+ * paint looked up, and the last release ends the session.
+ *****************************************************************************/
+
+#include "PaintFixtures.h"
+#include "RenderContext.h"
+#include "TestCheck.h"
+
+using namespace Gdiplus;
+
+int main() {
+  printf("RenderContext checks (GDI+)\n");
+  using RenderContext::GetStats;
+
+  bool first = RenderContext::Acquire();
+  bool second = RenderContext::Acquire(); // A second module
+  Check("one GDI+ session for every module",
+        first && second && GetStats().users == 2 && GetStats().sessions == 1);
+
+  Color red(255, 255, 0, 0), blue(255, 0, 0, 255);
+  Check("brushes pooled by color",
+        RenderContext::Brush(red) == RenderContext::Brush(red) &&
+            RenderContext::Brush(red) != RenderContext::Brush(blue));
+  Check("pens pooled by color and width * scale",
+        RenderContext::Pen(red, 1.0f, 2.0f) == RenderContext::Pen(red, 2.0f) &&
+            RenderContext::Pen(red, 1.0f) != RenderContext::Pen(red, 1.5f) &&
+            RenderContext::Pen(red, 1.0f) != RenderContext::Pen(blue, 1.0f));
+  Check("fonts pooled by size * scale and style",
+        RenderContext::Font(12, FontStyleBold) == RenderContext::Font(6, FontStyleBold, 2.0f) &&
+            RenderContext::Font(12) != RenderContext::Font(12, FontStyleBold));
+  Check("string formats pooled by alignment and trimming",
+        RenderContext::Format(StringAlignmentCenter) ==
+                RenderContext::Format(StringAlignmentCenter, StringAlignmentCenter) &&
+            RenderContext::Format(StringAlignmentCenter) !=
+                RenderContext::Format(StringAlignmentCenter, StringAlignmentCenter, true));
+
+  HDC screen = GetDC(NULL);
+  {
+    PaintTarget before(screen, PANEL_WIDTH, PANEL_HEIGHT), after(screen, PANEL_WIDTH, PANEL_HEIGHT);
+    RenderContext::Backbuffer backbuffer;
+    uint32_t bitmaps = GetStats().bitmaps;
+    PaintPanelBefore(before.dc, 3);
+    PaintPanelAfter(backbuffer, after.dc, 3);
+    Check("pooled paint draws the same pixels", before.SamePixels(after));
+    PaintPanelBefore(before.dc, 5);
+    PaintPanelAfter(backbuffer, after.dc, 5);
+    Check("reused backbuffer draws the same pixels", before.SamePixels(after));
+    Check("backbuffer bitmap created once", GetStats().bitmaps == bitmaps + 1);
+
+    // Unbounded colors (animations, pickers): the least recently used are
+    // evicted between paints, never the ones the current paint looked up
+    for (int i = 0; i <= RenderContext::MAX_POOLED; i++)
+      RenderContext::Brush(Color(255, (BYTE)i, (BYTE)(i >> 8), 7));
+    uint32_t evicted = GetStats().evicted;
+    PaintPanelAfter(backbuffer, after.dc, 3);
+    bool kept = GetStats().evicted == evicted; // Looked up since the last Begin
+    uint64_t misses = GetStats().misses;
+    PaintPanelAfter(backbuffer, after.dc, 3);
+    Check("oversized pool evicts least recently used entries, keeps the panel's",
+          kept && GetStats().evicted > evicted && GetStats().misses == misses &&
+              GetStats().pooled <= (uint32_t)RenderContext::MAX_POOLED);
+
+    // Hover walking down the rows like a mouse move
+    misses = GetStats().misses;
+    for (int i = 0; i < 4 * PANEL_ROW_COUNT; i++)
+      PaintPanelAfter(backbuffer, after.dc, i % PANEL_ROW_COUNT);
+    Check("pooled paints create no resources once warm", GetStats().misses == misses);
+  }
+
+  // Every module's paint profile
+  bool samePixels = true, warm = true;
+  for (int i = 0; i < MODULE_PAINT_COUNT; i++) {
+    const ModulePaint &m = MODULE_PAINTS[i];
+    PaintTarget before(screen, m.width, m.height), after(screen, m.width, m.height);
+    RenderContext::Backbuffer backbuffer;
+    PaintModuleBefore(before.dc, m, 1);
+    PaintModuleAfter(backbuffer, after.dc, m, 1);
+    samePixels = samePixels && before.SamePixels(after);
+    uint64_t misses = GetStats().misses;
+    PaintModuleAfter(backbuffer, after.dc, m, 2);
+    warm = warm && GetStats().misses == misses;
+  }
+  Check("module paints: pooled draws the same pixels", samePixels);
+  Check("module paints: no resources created once warm", warm);
+  ReleaseDC(NULL, screen);
+
+  RenderContext::Release();
+  RenderContext::Release();
+  RenderContext::Release(); // Extra release is ignored
+  Check("last release ends the session", GetStats().users == 0 && GetStats().pooled == 0);
+  return TestResult();
+}
@@ -0,0 +1,418 @@
+/*****************************************************************************
+ * ScriptBatchTest.cpp
+ *
+ * ScriptBatch against a mock AEGP_ExecuteScript: result split and escaping,
+ * per-call isolation, statement scripts, deferred call order, and recovery
+ * after a host error (no call runs twice).
+ *****************************************************************************/
+
+#include "ScriptBatch.h"
+#include "TestCheck.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Mock AEGP_UtilitySuite6 host. Scripts are told apart by shape: the batch
+// layout of ComposeScript, the recovery probe, or a single call. A call is
+// a script of op('arg') steps run in order ("var r=echo('a');if(r){...}");
+// its value is the last step's:
+//   echo   returns arg             set     journals arg (mutating step)
+//   fail   throws arg              abort   host stops before this step
+//   syntax syntax error: nothing in the call runs
+struct MockScriptHost {
+  std::vector<std::string> journal; // Executed steps "op:arg", in order
+  uint32_t batchId = 0;             // $.global.__asBatch
+  std::vector<std::string> out;
+  int executions = 0;
+  bool parseError = false;       // Next batch: the whole script fails to parse
+  bool loseResult = false;       // Next script: host error after it ran
+  bool errorAfterResult = false; // Next script: result kept, error reported
+  bool probeFails = false;       // Recovery probes fail
+};
+
+struct MockStep {
+  std::string op, arg;
+};
+
+// Every op('arg') in the script, with \xNN, \\ and \' escapes in arg
+static std::vector<MockStep> ParseMockSteps(const std::string &script) {
+  std::vector<MockStep> steps;
+  for (size_t open = script.find("('"); open != std::string::npos;
+       open = script.find("('", open + 2)) {
+    size_t start = open;
+    while (start > 0 && script[start - 1] >= 'a' && script[start - 1] <= 'z')
+      start--;
+    MockStep step;
+    step.op = script.substr(start, open - start);
+    size_t i = open + 2;
+    for (; i < script.size() && script[i] != '\''; i++) {
+      if (script[i] == '\\' && i + 1 < script.size()) {
+        if (script[i + 1] == 'x' && i + 3 < script.size()) {
+          step.arg += (char)strtol(script.substr(i + 2, 2).c_str(), nullptr, 16);
+          i += 3;
+        } else {
+          step.arg += script[++i];
+        }
+      } else {
+        step.arg += script[i];
+      }
+    }
+    steps.push_back(step);
+    open = i;
+  }
+  return steps;
+}
+
+// JS single-quoted literal starting at script[pos] -> its text; pos moves
+// past the closing quote
+static std::string MockUnquote(const std::string &script, size_t &pos) {
+  std::string text;
+  for (pos++; pos < script.size() && script[pos] != '\''; pos++) {
+    if (script[pos] != '\\' || pos + 1 >= script.size()) {
+      text += script[pos];
+      continue;
+    }
+    char c = script[++pos];
+    if (c == 'n') {
+      text += '\n';
+    } else if (c == 'r') {
+      text += '\r';
+    } else if (c == 'x') {
+      text += (char)strtol(script.substr(pos + 1, 2).c_str(), nullptr, 16);
+      pos += 2;
+    } else if (c == 'u') {
+      // Only U+2028 / U+2029 are escaped this way
+      text += (script.compare(pos + 1, 4, "2028") == 0) ? "\xE2\x80\xA8" : "\xE2\x80\xA9";
+      pos += 4;
+    } else {
+      text += c;
+    }
+  }
+  pos++;
+  return text;
+}
+
+// JS single-quoted literal for ParseMockSteps
+static std::string MockQuote(const std::string &text) {
+  std::string out = "'";
+  for (unsigned char c : text) {
+    if (c < 0x20 || c == '\'' || c == '\\') {
+      char hex[8];
+      snprintf(hex, sizeof(hex), "\\x%02x", c);
+      out += hex;
+    } else {
+      out += (char)c;
+    }
+  }
+  return out + "'";
+}
+
+static std::string MockEscape(const std::string &text) {
+  std::string out;
+  for (char c : text) {
+    if (c == '\x1b' || c == '\x1e')
+      out += '\x1b';
+    out += c;
+  }
+  return out;
+}
+
+static std::string JoinRecords(const std::vector<std::string> &records) {
+  std::string out;
+  for (size_t i = 0; i < records.size(); i++)
+    out += (i ? "\x1e" : "") + records[i];
+  return out;
+}
+
+static bool HasSyntaxError(const std::vector<MockStep> &steps) {
+  for (const MockStep &step : steps)
+    if (step.op == "syntax")
+      return true;
+  return false;
+}
+
+// Runs one call's steps; returns false if the host stopped
+static bool RunMockCall(MockScriptHost &host, const std::vector<MockStep> &steps,
+                        std::string &value, bool &threw) {
+  threw = false;
+  value.clear();
+  for (const MockStep &step : steps) {
+    if (step.op == "abort")
+      return false;
+    host.journal.push_back(step.op + ":" + step.arg);
+    if (step.op == "fail") {
+      threw = true;
+      value = step.arg;
+      break;
+    }
+    value = (step.op == "set") ? "" : step.arg;
+  }
+  return true;
+}
+
+// AEGP_ExecuteScript: result / error string handles, A_Err
+static int MockExecuteScript(MockScriptHost &host, const char *scriptZ, std::string *resultP,
+                             std::string *errorP) {
+  static const char kBatchStart[] = "(function(){var __b=$.global.__asBatch={id:";
+  static const char kCallStart[] = "try{__o.push('\\x06'+__q(__e(";
+  static const char kRecovery[] = "(function(){var b=$.global.__asBatch;return(b&&b.id===";
+  std::string script = scriptZ;
+  host.executions++;
+  bool loseResult = host.loseResult, errorAfterResult = host.errorAfterResult;
+  host.loseResult = host.errorAfterResult = false;
+
+  if (script.compare(0, sizeof(kRecovery) - 1, kRecovery) == 0) {
+    if (host.probeFails) {
+      *errorP = "Host not responding";
+      return 0;
+    }
+    uint32_t id = (uint32_t)strtoul(script.c_str() + sizeof(kRecovery) - 1, nullptr, 10);
+    *resultP = (id == host.batchId) ? "\x02" + JoinRecords(host.out) : "";
+    return 0;
+  }
+
+  std::string value;
+  bool threw = false;
+  if (script.compare(0, sizeof(kBatchStart) - 1, kBatchStart) != 0) {
+    std::vector<MockStep> steps = ParseMockSteps(script);
+    if (HasSyntaxError(steps)) {
+      *errorP = "SyntaxError: Expected: )";
+      return 0;
+    }
+    if (!RunMockCall(host, steps, value, threw)) {
+      *errorP = "Script execution aborted";
+      return 0;
+    }
+    if (threw)
+      *errorP = value;
+    else
+      *resultP = value;
+    return 0;
+  }
+
+  if (host.parseError) {
+    host.parseError = false;
+    *errorP = "SyntaxError: Expected: )";
+    return 0;
+  }
+  host.batchId = (uint32_t)strtoul(script.c_str() + sizeof(kBatchStart) - 1, nullptr, 10);
+  host.out.clear();
+  for (size_t pos = script.find(kCallStart); pos != std::string::npos;
+       pos = script.find(kCallStart, pos)) {
+    pos += sizeof(kCallStart) - 1;
+    // eval: a syntax error throws inside the call's own try/catch
+    std::vector<MockStep> steps = ParseMockSteps(MockUnquote(script, pos));
+    if (HasSyntaxError(steps)) {
+      host.out.push_back("\x15SyntaxError: Expected: )");
+      continue;
+    }
+    if (!RunMockCall(host, steps, value, threw)) {
+      *errorP = "Script execution aborted";
+      return 0;
+    }
+    host.out.push_back((threw ? "\x15" : "\x06") + MockEscape(value));
+  }
+  if (loseResult) {
+    *errorP = "Internal error after execution";
+    return 0;
+  }
+  *resultP = JoinRecords(host.out);
+  if (errorAfterResult)
+    *errorP = "Internal error after execution";
+  return 0;
+}
+
+// SnapPlugin's RunHostScript against the mock suite
+static bool MockRunHostScript(const char *script, std::string &result, void *context) {
+  std::string resultH, errorH;
+  bool ok = MockExecuteScript(*(MockScriptHost *)context, script, &resultH, &errorH) == 0;
+  result = resultH;
+  if (!errorH.empty()) {
+    ok = false;
+    if (result.empty())
+      result = errorH;
+  }
+  return ok;
+}
+
+static std::string MockOp(const char *op, const std::string &arg) {
+  return std::string(op) + "(" + MockQuote(arg) + ");";
+}
+
+static std::string JournalString(const MockScriptHost &host) {
+  std::string out;
+  for (const std::string &entry : host.journal)
+    out += entry + " ";
+  return out;
+}
+
+static void CheckSplit(MockScriptHost &host) {
+  // Separators, escapes and markers inside results
+  const std::string payloads[] = {"", "plain", "\x1e", "\x1b", "a\x1b\x1e" "b\x1b",
+                                  "\x06\x15", "\x1e\x1e", "\xEC\xA0\x9C|;"};
+  const size_t payloadCount = sizeof(payloads) / sizeof(payloads[0]);
+  host = MockScriptHost();
+  std::vector<ScriptBatch::Future> futures;
+  for (size_t i = 0; i < payloadCount; i++)
+    futures.push_back(ScriptBatch::Enqueue("echo", MockOp("echo", payloads[i]).c_str()));
+  bool ok = ScriptBatch::Flush() == (int)payloadCount && host.executions == 1;
+  for (size_t i = 0; i < payloadCount; i++)
+    ok = ok && futures[i].Succeeded() && futures[i].Get() == payloads[i];
+  Check("results split back exactly (RS / ESC / markers inside results)", ok);
+
+  std::string results[3];
+  bool succeeded[3];
+  ok = ScriptBatch::SplitResult("", results, succeeded, 0) &&
+       ScriptBatch::SplitResult("\x06" "a\x1b\x1e\x1e\x15" "b", results, succeeded, 2) &&
+       results[0] == "a\x1e" && succeeded[0] && results[1] == "b" && !succeeded[1] &&
+       !ScriptBatch::SplitResult("", results, succeeded, 2) &&
+       !ScriptBatch::SplitResult("\x06" "a", results, succeeded, 2) &&
+       !ScriptBatch::SplitResult("\x06" "a\x1e", results, succeeded, 1) &&
+       !ScriptBatch::SplitResult("a\x1e\x06" "b", results, succeeded, 2) &&
+       !ScriptBatch::SplitResult("\x06" "a\x1e\x06" "b\x1e\x06" "c", results, succeeded, 2);
+  Check("SplitResult rejects missing / extra records and markers", ok);
+}
+
+static void CheckIsolation(MockScriptHost &host) {
+  // A throwing call fails alone, in the same round-trip
+  host = MockScriptHost();
+  ScriptBatch::ResetStats();
+  ScriptBatch::Future a = ScriptBatch::Enqueue("a", MockOp("echo", "A").c_str());
+  ScriptBatch::Future b = ScriptBatch::Enqueue("b", MockOp("fail", "boom").c_str());
+  ScriptBatch::Future c = ScriptBatch::Enqueue("c", MockOp("echo", "C").c_str());
+  bool ok = c.Get() == "C" && a.Get() == "A" && !b.Succeeded() && b.Error() == "boom" &&
+            b.Get().empty() && host.executions == 1 && ScriptBatch::GetStats().fallbacks == 0;
+  Check("a throwing call fails alone, one round-trip", ok);
+
+  // A syntax error in one call is its own exception (eval), not a batch
+  // parse error
+  host = MockScriptHost();
+  ScriptBatch::ResetStats();
+  a = ScriptBatch::Enqueue("a", MockOp("set", "a").c_str());
+  b = ScriptBatch::Enqueue("b", "syntax('x'");
+  c = ScriptBatch::Enqueue("c", MockOp("set", "c").c_str());
+  ScriptBatch::Flush();
+  ok = JournalString(host) == "set:a set:c " && a.Succeeded() && !b.Succeeded() &&
+       b.Error().find("SyntaxError") == 0 && c.Succeeded() && host.executions == 1 &&
+       ScriptBatch::GetStats().recoveries == 0;
+  Check("a call with a syntax error fails alone, one round-trip", ok);
+}
+
+static void CheckStatements(MockScriptHost &host) {
+  // Statement scripts are not expressions: they must not break the batch
+  host = MockScriptHost();
+  ScriptBatch::ResetStats();
+  ScriptBatch::Future a = ScriptBatch::Enqueue("a", "var r=echo('x');\nif(r){echo('y');}");
+  ScriptBatch::Future b = ScriptBatch::Enqueue("b", "(function(){return echo('iife');})();");
+  ScriptBatch::Future c = ScriptBatch::Enqueue("c", "var n=set('1');\r\n\tset('2');\n");
+  ScriptBatch::Future d = ScriptBatch::Enqueue("d", MockOp("echo", "expr").c_str());
+  ScriptBatch::Flush();
+  bool ok = a.Succeeded() && a.Get() == "y" && b.Get() == "iife" && c.Succeeded() &&
+            d.Get() == "expr" && host.executions == 1 &&
+            JournalString(host) == "echo:x echo:y echo:iife set:1 set:2 echo:expr " &&
+            ScriptBatch::GetStats().recoveries == 0;
+  Check("statement scripts (var / if / newlines) run in the batch, value of the last one", ok);
+
+  // Quotes, backslashes, line breaks and U+2028 in a call survive as a
+  // single-line literal
+  const std::string scripts[] = {"echo('it\\'s \\\\ ok')\n", "echo('\xE2\x80\xA8\xE2\x80\xA9')"};
+  std::string composed = ScriptBatch::ComposeScript(scripts, 2, 1);
+  ok = composed.find('\n') == std::string::npos &&
+       composed.find("\xE2\x80\xA8") == std::string::npos &&
+       composed.find("\xE2\x80\xA9") == std::string::npos;
+  host = MockScriptHost();
+  a = ScriptBatch::Enqueue("a", scripts[0].c_str());
+  b = ScriptBatch::Enqueue("b", scripts[1].c_str());
+  ok = ok && a.Get() == "it's \\ ok" && b.Get() == "\xE2\x80\xA8\xE2\x80\xA9" &&
+       host.executions == 1;
+  Check("call text is quoted for eval: no raw line break / U+2028 in the batch", ok);
+}
+
+static void CheckOrdering(MockScriptHost &host) {
+  // Fire-and-forget calls are deferred and run before the query that
+  // flushes them; later ones wait for the end of the tick
+  host = MockScriptHost();
+  ScriptBatch::Enqueue("ExecuteScript", MockOp("set", "1").c_str());
+  ScriptBatch::Enqueue("ExecuteScript", MockOp("set", "2").c_str());
+  bool ok = host.executions == 0 && ScriptBatch::PendingCount() == 2;
+  ok = ok && ScriptBatch::Enqueue("QueryScript", MockOp("echo", "q").c_str()).Get() == "q" &&
+       host.executions == 1;
+  ScriptBatch::Enqueue("ExecuteScript", MockOp("set", "3").c_str());
+  ok = ok && ScriptBatch::PendingCount() == 1 && host.executions == 1;
+  ScriptBatch::Flush(); // End of tick
+  ok = ok && host.executions == 2 && JournalString(host) == "set:1 set:2 echo:q set:3 ";
+  Check("deferred calls run in call order around result-returning calls", ok);
+}
+
+static void CheckRecovery(MockScriptHost &host) {
+  // Parse error: the batch never ran, every call is re-run alone
+  host = MockScriptHost();
+  ScriptBatch::ResetStats();
+  host.parseError = true;
+  ScriptBatch::Future a = ScriptBatch::Enqueue("a", MockOp("set", "a").c_str());
+  ScriptBatch::Future b = ScriptBatch::Enqueue("b", MockOp("set", "b").c_str());
+  ScriptBatch::Future c = ScriptBatch::Enqueue("c", MockOp("set", "c").c_str());
+  ScriptBatch::Flush();
+  ScriptBatch::Stats stats = ScriptBatch::GetStats();
+  bool ok = JournalString(host) == "set:a set:b set:c " && a.Succeeded() && b.Succeeded() &&
+            c.Succeeded() && stats.recoveries == 1 && stats.fallbacks == 1 &&
+            host.executions == 5;
+  Check("batch parse error: calls re-run one by one, each once", ok);
+
+  // Host error after the batch ran: results recovered, nothing re-run
+  host = MockScriptHost();
+  ScriptBatch::ResetStats();
+  a = ScriptBatch::Enqueue("a", MockOp("set", "a").c_str());
+  b = ScriptBatch::Enqueue("b", MockOp("set", "b").c_str());
+  c = ScriptBatch::Enqueue("c", MockOp("echo", "C").c_str());
+  host.loseResult = true;
+  ScriptBatch::Flush();
+  stats = ScriptBatch::GetStats();
+  ok = JournalString(host) == "set:a set:b echo:C " && a.Succeeded() && b.Succeeded() &&
+       c.Get() == "C" && stats.recoveries == 1 && stats.fallbacks == 0 && host.executions == 2;
+  host = MockScriptHost();
+  a = ScriptBatch::Enqueue("a", MockOp("set", "a").c_str());
+  b = ScriptBatch::Enqueue("b", MockOp("echo", "B").c_str());
+  host.errorAfterResult = true; // Complete result despite the error
+  ok = ok && b.Get() == "B" && a.Succeeded() && host.executions == 1 &&
+       JournalString(host) == "set:a echo:B ";
+  Check("host error after execution: mutating calls are not re-run", ok);
+
+  // Host stopped mid-batch: only the calls without a record are re-run
+  host = MockScriptHost();
+  ScriptBatch::ResetStats();
+  a = ScriptBatch::Enqueue("a", MockOp("set", "a").c_str());
+  b = ScriptBatch::Enqueue("b", MockOp("abort", "b").c_str());
+  c = ScriptBatch::Enqueue("c", MockOp("set", "c").c_str());
+  ScriptBatch::Flush();
+  stats = ScriptBatch::GetStats();
+  ok = JournalString(host) == "set:a set:c " && a.Succeeded() && !b.Succeeded() &&
+       c.Succeeded() && stats.fallbacks == 1 && host.executions == 4;
+  Check("host stopped mid-batch: only unrecorded calls re-run", ok);
+
+  // Progress unknown (probe failed): fail the calls rather than risk a rerun
+  host = MockScriptHost();
+  host.loseResult = true;
+  host.probeFails = true;
+  a = ScriptBatch::Enqueue("a", MockOp("set", "a").c_str());
+  b = ScriptBatch::Enqueue("b", MockOp("set", "b").c_str());
+  ScriptBatch::Flush();
+  ok = JournalString(host) == "set:a set:b " && !a.Succeeded() && !b.Succeeded() &&
+       a.Error() == "Internal error after execution" && host.executions == 2;
+  Check("unknown progress: nothing re-run, calls fail with the host error", ok);
+}
+
+int main() {
+  printf("ScriptBatch checks\n");
+  MockScriptHost host;
+  ScriptBatch::SetRunner(MockRunHostScript, &host);
+  CheckSplit(host);
+  CheckIsolation(host);
+  CheckStatements(host);
+  CheckOrdering(host);
+  CheckRecovery(host);
+  ScriptBatch::SetRunner(nullptr, nullptr);
+  return TestResult();
+}
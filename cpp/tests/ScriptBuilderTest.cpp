@@ -0,0 +1,48 @@
+/*****************************************************************************
+ * ScriptBuilderTest.cpp
+ *
+ * ScriptBuilder::Render escaping: quotes, backslashes, control characters,
+ * UTF-8 / UTF-16 non-ASCII input, invalid UTF-8 and mixed slot types.
+ *****************************************************************************/
+
+#include "ScriptBuilder.h"
+#include "TestCheck.h"
+
+#include <cstring>
+
+SCRIPT_TEMPLATE(EscapeCheck, "f(${s})");
+SCRIPT_TEMPLATE(MixedCheck, "g(${i},${f},${b},${j})");
+
+// Check with the rendered and expected script on failure
+static void Expect(const char *label, const char *actual, const char *expected) {
+  bool ok = strcmp(actual, expected) == 0;
+  Check(label, ok);
+  if (!ok)
+    printf("         got      %s\n         expected %s\n", actual, expected);
+}
+
+int main() {
+  printf("ScriptBuilder escaping checks\n");
+  ScriptBuilder::Arena arena;
+  Expect("quote", ScriptBuilder::Render<EscapeCheck>(arena, "it's"),
+         "f('it\\'s')");
+  Expect("backslash", ScriptBuilder::Render<EscapeCheck>(arena, "C:\\a\\b"),
+         "f('C:\\\\a\\\\b')");
+  Expect("control", ScriptBuilder::Render<EscapeCheck>(arena, "a\nb\tc\x01"),
+         "f('a\\nb\\tc\\u0001')");
+  Expect("utf8 korean",
+         ScriptBuilder::Render<EscapeCheck>(arena, "\xEB\xA7\x91\xEC\x9D\x80"),
+         "f('\\ub9d1\\uc740')");
+  Expect("utf8 emoji",
+         ScriptBuilder::Render<EscapeCheck>(arena, "\xF0\x9F\x98\x80"),
+         "f('\\ud83d\\ude00')");
+  Expect("utf16 name", ScriptBuilder::Render<EscapeCheck>(arena, L"\uB9D1 Go"),
+         "f('\\ub9d1 Go')");
+  Expect("invalid utf8", ScriptBuilder::Render<EscapeCheck>(arena, "a\xFF"),
+         "f('a\\ufffd')");
+  Expect("mixed",
+         ScriptBuilder::Render<MixedCheck>(arena, -3, 0.5f, true,
+                                           ScriptBuilder::Json("{\"a\":'x'}")),
+         "g(-3,0.5,true,JSON.parse('{\"a\":\\'x\\'}'))");
+  return TestResult();
+}
@@ -0,0 +1,88 @@
+/*****************************************************************************
+ * ScriptFixtures.h
+ *
+ * ExtendScript front-end stand-in (tokens and bracket nesting of a script)
+ * and the mock host ScriptLibrary calls run against, shared by
+ * ScriptLibraryTest and tools/ScriptBench.
+ *****************************************************************************/
+
+#pragma once
+
+#include "ScriptLibrary.h"
+
+#include <cctype>
+#include <string>
+
+// Stand-in for the ExtendScript front end: tokenizes the script (strings,
+// numbers, names, punctuation) and checks bracket nesting. Parse cost is
+// linear in the tokens, so tokens and lex time compare the two forms.
+struct LexResult {
+  size_t tokens = 0;
+  bool balanced = false;
+};
+
+inline LexResult MockLex(const std::string &script) {
+  LexResult lex;
+  std::string stack;
+  size_t i = 0, n = script.size();
+  while (i < n) {
+    char c = script[i];
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+      i++;
+      continue;
+    }
+    lex.tokens++;
+    if (c == '\'' || c == '"') {
+      for (i++; i < n && script[i] != c; i++) {
+        if (script[i] == '\\')
+          i++;
+      }
+      if (i >= n)
+        return lex; // Unterminated string
+      i++;
+    } else if (isalnum((unsigned char)c) || c == '_' || c == '$' || c == '.') {
+      while (i < n && (isalnum((unsigned char)script[i]) || script[i] == '_' ||
+                       script[i] == '$' || script[i] == '.'))
+        i++;
+    } else {
+      if (c == '(' || c == '[' || c == '{')
+        stack += c;
+      else if (c == ')' || c == ']' || c == '}') {
+        char open = (c == ')') ? '(' : (c == ']') ? '[' : '{';
+        if (stack.empty() || stack.back() != open)
+          return lex;
+        stack.pop_back();
+      }
+      i++;
+    }
+  }
+  lex.balanced = stack.empty();
+  return lex;
+}
+
+struct MockLibraryHost {
+  bool installed = false;
+  int installs = 0;
+  int calls = 0;
+  size_t tokens = 0;
+  bool balanced = true;
+};
+
+// Lexes every script; the namespace exists only after the bootstrap ran
+inline bool MockLibraryRunner(const char *script, std::string &result, void *context) {
+  MockLibraryHost *host = (MockLibraryHost *)context;
+  std::string text = script;
+  LexResult lex = MockLex(text);
+  host->tokens += lex.tokens;
+  host->balanced = host->balanced && lex.balanced;
+  std::string global = std::string("(function(){$.global.") + ScriptLibrary::NAMESPACE + "={";
+  if (text.compare(0, global.size(), global) == 0) {
+    host->installed = true;
+    host->installs++;
+    result = "ok";
+    return true;
+  }
+  host->calls++;
+  result = (!host->installed && text.find("($.global.") == 0) ? "\x18" : "";
+  return true;
+}
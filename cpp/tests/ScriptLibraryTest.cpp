@@ -0,0 +1,68 @@
+/*****************************************************************************
+ * ScriptLibraryTest.cpp
+ *
+ * ScriptLibrary against a mock host: namespace / bootstrap version, the
+ * missing-namespace install + retry after an engine reset, and every
+ * library call lexing smaller than its inline body.
+ *****************************************************************************/
+
+#include "ScriptBatch.h"
+#include "ScriptFixtures.h"
+#include "ScriptLibrary.h"
+#include "TestCheck.h"
+
+#include <string>
+
+int main() {
+  printf("ScriptLibrary checks\n");
+  using namespace ScriptLibrary;
+  std::string bootstrap = BuildBootstrap();
+  std::string version = std::to_string(VERSION);
+  bool ok = std::string(NAMESPACE) == "AnchorSnap_v" + version &&
+            bootstrap.find(std::string("$.global.") + NAMESPACE + "={") != std::string::npos &&
+            bootstrap.find("version:" + version + "}") != std::string::npos;
+  Check("namespace and bootstrap version follow one constant", ok);
+
+  MockLibraryHost host;
+  ScriptBatch::SetRunner(MockLibraryRunner, &host);
+  ScriptBatch::Flush();
+  std::string result = Call<HostInfoCall>(); // Engine reset: namespace missing
+  ok = host.installs == 1 && host.calls == 2 && result.empty() && !IsMissing(result);
+  Call<HostInfoCall>();
+  ok = ok && host.installs == 1 && host.calls == 3 && host.balanced;
+  Check("missing namespace: installed once, call retried", ok);
+
+  // Inline body vs library call: both lex, the call is smaller
+  struct Sample {
+    const char *fn, *args;
+  };
+  static const Sample kSamples[] = {
+      {"applyAnchor", "1,1,3,3,false,false"},
+      {"applyCustomAnchor", "0.5000,0.5000"},
+      {"deleteEffect", "0"},
+      {"addEffect", "'ADBE Gaussian Blur 2'"},
+      {"effectsList", ""},
+      {"keyframeInfo", ""},
+      {"applyEase", "''"},
+      {"textInfo", ""},
+      {"shapeInfo", ""},
+      {"panelSnapshot", ""},
+      {"align", "false,0"},
+      {"distribute", "false,true"},
+  };
+  bool smaller = true, lexes = true;
+  for (const Sample &sample : kSamples) {
+    std::string rendered = std::string(sample.fn) + "(" + sample.args + ")";
+    std::string inlineScript = BuildInline(sample.fn, sample.args);
+    std::string callScript = BuildCallScript(rendered.c_str());
+    LexResult inlineLex = MockLex(inlineScript), callLex = MockLex(callScript);
+    lexes = lexes && !inlineScript.empty() && inlineLex.balanced && callLex.balanced;
+    smaller = smaller && callScript.size() < inlineScript.size() &&
+              callLex.tokens < inlineLex.tokens;
+  }
+  Check("bootstrap and inline scripts lex with balanced brackets",
+        lexes && MockLex(bootstrap).balanced);
+  Check("every library call sends fewer bytes and tokens than its inline body", smaller);
+  ScriptBatch::SetRunner(nullptr, nullptr);
+  return TestResult();
+}
@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * ScriptResultTest.cpp
+ *
+ * ScriptResult against a mock memory suite (handle lifetime, moves, owned
+ * strings) and UTF-8 -> wchar_t widening.
+ *****************************************************************************/
+
+#include "ScriptResult.h"
+#include "TestCheck.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Mirrors AEGP_NewMemHandle / Lock / Unlock / Free bookkeeping
+struct MockMemory {
+  int allocated = 0;
+  int locked = 0;
+  int freed = 0;
+};
+
+struct MockHandle {
+  std::vector<char> bytes;
+  bool locked = false;
+};
+
+static void MockRelease(void *handle, void *context) {
+  MockMemory *mem = static_cast<MockMemory *>(context);
+  MockHandle *h = static_cast<MockHandle *>(handle);
+  if (h->locked) {
+    h->locked = false;
+    mem->locked--;
+  }
+  mem->freed++;
+  delete h;
+}
+
+// Host-side equivalent of RunScript: allocate, lock, adopt
+static ScriptResult::Result MockRun(MockMemory &mem, const std::string &text) {
+  MockHandle *h = new MockHandle;
+  h->bytes.assign(text.begin(), text.end());
+  h->bytes.push_back('\0');
+  h->locked = true;
+  mem.allocated++;
+  mem.locked++;
+  return ScriptResult::Result(h->bytes.data(), strnlen(h->bytes.data(), h->bytes.size()),
+                              true, h, MockRelease, &mem);
+}
+
+static void CheckHandles() {
+  MockMemory mem;
+  {
+    ScriptResult::Result r = MockRun(mem, "a|b|c;;d|e");
+    Check("view over locked handle", r.Succeeded() && r.View() == "a|b|c;;d|e");
+    ScriptResult::Result moved = std::move(r);
+    Check("move keeps one owner", r.View().empty() && moved.View().size() == 10 &&
+                                      mem.locked == 1);
+    moved = MockRun(mem, "x");
+    Check("assign releases previous", mem.freed == 1 && moved.View() == "x");
+  }
+  Check("all handles released", mem.allocated == 2 && mem.freed == 2 &&
+                                    mem.locked == 0);
+
+  ScriptResult::Result s = ScriptResult::Result::FromString("short", true);
+  ScriptResult::Result t = std::move(s);
+  Check("owned string survives move", t.View() == "short");
+  ScriptResult::Result e = ScriptResult::Result::FromString("boom", false);
+  Check("failed result has no view", e.View().empty() && e.Error() == "boom");
+}
+
+static void CheckWiden() {
+  wchar_t small[4];
+  size_t n = ScriptResult::WidenInto("ab\xF0\x9F\x98\x80", small, 4);
+  bool ok = n == 2 && small[2] == L'\0';
+  if (sizeof(wchar_t) == 4)
+    ok = n == 3 && small[2] == (wchar_t)0x1F600;
+  Check("widen never splits a surrogate pair", ok);
+  std::wstring w = ScriptResult::Widen("\xEB\xB8\x94");
+  Check("widen korean", w.size() == 1 && w[0] == (wchar_t)0xBE14);
+}
+
+int main() {
+  printf("ScriptResult checks\n");
+  CheckHandles();
+  CheckWiden();
+  return TestResult();
+}
@@ -0,0 +1,22 @@
+/*****************************************************************************
+ * TestCheck.h
+ *
+ * Check helper shared by the component tests. Each test is its own
+ * executable (one per core component, registered with ctest): it prints a
+ * PASS / FAIL line per check and exits 1 if any check failed.
+ *****************************************************************************/
+
+#pragma once
+
+#include <cstdio>
+
+static int s_failures = 0;
+
+static void Check(const char *label, bool ok) {
+  if (!ok)
+    s_failures++;
+  printf("  [%s] %s\n", ok ? "PASS" : "FAIL", label);
+}
+
+// main()'s exit code
+static int TestResult() { return s_failures == 0 ? 0 : 1; }
@@ -0,0 +1,187 @@
+/*****************************************************************************
+ * TracerTest.cpp
+ *
+ * Tracer: Chrome trace JSON output (nested scopes balanced, arguments and
+ * escaped text, instants), nothing recorded outside a session, full-buffer
+ * drops keep begin / end balanced, per-thread buffers and names.
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "Tracer.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One event line of the JSON output ("" if the field is missing)
+static std::string TraceField(const std::string &line, const char *key) {
+  std::string pattern = std::string("\"") + key + "\":";
+  size_t at = line.find(pattern);
+  if (at == std::string::npos)
+    return "";
+  at += pattern.size();
+  if (line[at] == '"') {
+    size_t end = at + 1;
+    while (end < line.size() && line[end] != '"')
+      end += line[end] == '\\' ? 2 : 1;
+    return line.substr(at + 1, end - at - 1);
+  }
+  size_t end = line.find_first_of(",}", at);
+  return line.substr(at, end - at);
+}
+
+struct TraceSummary {
+  bool wellFormed = false;
+  bool balanced = true;   // Every E closes the innermost B of its thread
+  bool monotonic = true;  // Timestamps never go back within a thread
+  int begins = 0, ends = 0, instants = 0, threadNames = 0;
+  std::vector<std::string> lines;
+};
+
+static TraceSummary ReadTrace(const std::string &path) {
+  TraceSummary summary;
+  std::ifstream file(path);
+  std::string line;
+  std::map<std::string, std::vector<std::string>> open; // tid -> B names
+  std::map<std::string, double> lastTs;
+  bool first = true, closed = false;
+  while (std::getline(file, line)) {
+    if (first) {
+      summary.wellFormed = line.rfind("{\"displayTimeUnit\"", 0) == 0;
+      first = false;
+      continue;
+    }
+    if (line.rfind("],\"otherData\"", 0) == 0) {
+      closed = true;
+      continue;
+    }
+    if (!line.empty() && line[0] == ',')
+      line.erase(0, 1);
+    summary.lines.push_back(line);
+    std::string ph = TraceField(line, "ph"), tid = TraceField(line, "tid");
+    if (ph == "M") {
+      summary.threadNames += TraceField(line, "name") == "thread_name";
+      continue;
+    }
+    double ts = atof(TraceField(line, "ts").c_str());
+    summary.monotonic = summary.monotonic && (!lastTs.count(tid) || ts >= lastTs[tid]);
+    lastTs[tid] = ts;
+    if (ph == "B") {
+      summary.begins++;
+      open[tid].push_back(TraceField(line, "name"));
+    } else if (ph == "E") {
+      summary.ends++;
+      std::vector<std::string> &stack = open[tid];
+      summary.balanced =
+          summary.balanced && !stack.empty() && stack.back() == TraceField(line, "name");
+      if (!stack.empty())
+        stack.pop_back();
+    } else if (ph == "i") {
+      summary.instants++;
+    }
+  }
+  for (const auto &entry : open)
+    summary.balanced = summary.balanced && entry.second.empty();
+  summary.wellFormed = summary.wellFormed && closed;
+  return summary;
+}
+
+int main() {
+  printf("Tracer checks\n");
+  namespace fs = std::filesystem;
+  const std::string path = (fs::temp_directory_path() / "AnchorSnapTests.trace.json").string();
+
+  // Nesting, arguments (escaped text), instants
+  { TRACE_SCOPE("test", "not.recorded"); }
+  Check("start", Tracer::Start(path));
+  Check("one session at a time", !Tracer::Start(path));
+  Tracer::SetThreadName("test \"main\"");
+  {
+    Tracer::Scope outer("idle", "IdleHook");
+    {
+      Tracer::Scope call("script", "ExecuteScript");
+      call.Arg("site", "Run\"Quoted\"");
+      call.Arg("bytesIn", 1234);
+      call.Arg("bytesOut", -5);
+      call.Arg("ignored", 1); // Over MAX_ARGS
+    }
+    Tracer::Instant("input", "trigger", "key", 'Y');
+  }
+  Check("stop writes the file", Tracer::Stop());
+  Check("stop twice fails", !Tracer::Stop());
+  { TRACE_SCOPE("test", "not.recorded"); }
+  TraceSummary trace = ReadTrace(path);
+  bool args = false, escaped = false;
+  for (const std::string &line : trace.lines) {
+    args = args || (line.find("\"args\":{\"site\":\"Run\\\"Quoted\\\"\",\"bytesIn\":1234,"
+                              "\"bytesOut\":-5}") != std::string::npos);
+    escaped = escaped || line.find("test \\\"main\\\"") != std::string::npos;
+  }
+  Check("nested scopes balanced, instant recorded",
+        trace.wellFormed && trace.balanced && trace.monotonic && trace.begins == 2 &&
+            trace.ends == 2 && trace.instants == 1);
+  Check("end arguments (max 3) and escaped text", args && escaped);
+  Check("nothing recorded outside the session", Tracer::GetStats().events == 5);
+
+  // Full buffer: new scopes / instants dropped, recorded begins still end
+  Tracer::Start(path, 16);
+  {
+    std::vector<std::unique_ptr<Tracer::Scope>> nested;
+    for (int i = 0; i < 12; i++) {
+      nested.emplace_back(new Tracer::Scope("test", "nested"));
+      Tracer::Instant("test", "tick");
+    }
+    while (!nested.empty())
+      nested.pop_back();
+  }
+  Tracer::Stats full = Tracer::GetStats();
+  Tracer::Stop();
+  trace = ReadTrace(path);
+  Check("full buffer: drops counted, begin / end stay balanced",
+        trace.wellFormed && trace.balanced && full.events <= 16 && full.dropped > 0 &&
+            trace.begins == trace.ends && trace.begins > 0);
+
+  // Threads: own buffer and name each, a new session forgets the old one
+  const int threads = 4, perThread = 2000;
+  Tracer::Start(path);
+  std::vector<std::thread> workers;
+  static const char *kNames[threads] = {"worker 1", "worker 2", "worker 3", "worker 4"};
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([t]() {
+      Tracer::SetThreadName(kNames[t]);
+      for (int i = 0; i < perThread; i++) {
+        Tracer::Scope scope("test", "work");
+        scope.Arg("i", i);
+      }
+    });
+  }
+  for (std::thread &worker : workers)
+    worker.join();
+  Tracer::Stats threaded = Tracer::GetStats();
+  Tracer::Stop();
+  trace = ReadTrace(path);
+  Check("threads: one buffer each, all events kept",
+        threaded.threads == threads + 1 && threaded.events == (uint64_t)threads * perThread * 2 &&
+            trace.balanced && trace.threadNames == threads + 1 &&
+            trace.begins == threads * perThread);
+
+  // Up to half the default capacity of begin / end pairs: nothing dropped
+  const int recorded = (int)(Tracer::DEFAULT_CAPACITY / 2 - 1);
+  Tracer::Start(path);
+  for (int i = 0; i < recorded; i++) {
+    TRACE_SCOPE("test", "recorded");
+  }
+  Tracer::Stats capacity = Tracer::GetStats();
+  Tracer::Stop();
+  Check("recording never drops below capacity",
+        capacity.dropped == 0 && capacity.events == (uint64_t)recorded * 2);
+  std::error_code ec;
+  fs::remove(path, ec);
+  return TestResult();
+}
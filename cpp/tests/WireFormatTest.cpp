@@ -0,0 +1,172 @@
+/*****************************************************************************
+ * WireFormatTest.cpp
+ *
+ * WireFormat: adversarial names and numbers round-trip, string lengths in
+ * UTF-16 units, exact doubles (same text as the library's wDbl), fallbacks
+ * for mistyped fields, malformed input stops the reader, and a multi-MB
+ * effects-list payload comes back without truncation.
+ *****************************************************************************/
+
+#include "TestCheck.h"
+#include "WireFormat.h"
+
+#include <cmath>
+#include <string>
+
+static void CheckStrings() {
+  // Names that broke the old '|' / ';' / JSON parsing
+  static const char *const kNames[] = {
+      "Blur|Sharpen", "a;b;c", "say \"hi\"", "it's", "back\\slash",
+      "line\nbreak", "\xF0\x9F\x8E\xA8 emoji", "\xEB\xB8\x94\xEB\x9F\xAC", "",
+      "R3:s1:x", "}{][,:",
+  };
+  const size_t nameCount = sizeof(kNames) / sizeof(kNames[0]);
+  {
+    std::string wire;
+    WireFormat::Writer writer(wire);
+    for (size_t i = 0; i < nameCount; i++) {
+      writer.BeginRecord(3);
+      writer.String(kNames[i]);
+      writer.Int((int64_t)i - 5);
+      writer.Bool(i % 2 == 0);
+    }
+    WireFormat::Reader reader(wire);
+    size_t n = 0;
+    bool ok = true;
+    while (reader.Next()) {
+      ok = ok && n < nameCount && reader.FieldCount() == 3 &&
+           reader.String(0) == kNames[n] && reader.Int(1, 99) == (int)n - 5 &&
+           reader.Bool(2, false) == (n % 2 == 0);
+      n++;
+    }
+    Check("adversarial names round-trip", ok && n == nameCount && !reader.Failed());
+  }
+
+  {
+    // 's' lengths count UTF-16 units like ExtendScript's String.length
+    bool ok = WireFormat::Utf16Length("\xF0\x9F\x8E\xA8") == 2 &&
+              WireFormat::Utf16Length("\xEB\xB8\x94") == 1 &&
+              WireFormat::Utf16Length("abc") == 3;
+    WireFormat::Reader reader("R1:s2:\xF0\x9F\x8E\xA8R1:s3:a|b");
+    ok = ok && reader.Next() && reader.String(0) == "\xF0\x9F\x8E\xA8";
+    ok = ok && reader.Next() && reader.String(0) == "a|b";
+    Check("string length in UTF-16 units", ok && !reader.Next());
+  }
+}
+
+static void CheckNumbers() {
+  {
+    static const double kValues[] = {0.0, 1.0, -1.0, 33.33, 0.00005,
+                                     -123456.7891, 1e11, 72.5};
+    std::string wire;
+    WireFormat::Writer writer(wire);
+    writer.BeginRecord(sizeof(kValues) / sizeof(kValues[0]) + 2);
+    for (double v : kValues)
+      writer.Fixed(v);
+    writer.Fixed(NAN);
+    writer.Fixed(1e20);
+    WireFormat::Reader reader(wire);
+    bool ok = reader.Next();
+    for (size_t i = 0; ok && i < sizeof(kValues) / sizeof(kValues[0]); i++)
+      ok = std::fabs(reader.Number(i, -1) - kValues[i]) <= 0.5 / WireFormat::FIXED_SCALE;
+    ok = ok && reader.Number(8, -1) == 0.0 && reader.Number(9, -1) == 1e11;
+    Check("fixed-point numbers (4 places, clamped)", ok);
+  }
+
+  {
+    // 'd': bit-exact (key times such as 1/30 s, ease speeds)
+    static const double kValues[] = {1.0 / 30.0, -1.0 / 3.0, 0.1, 1e-300, 123456789.123456789,
+                                     -4503599627370497.0, 5e-324};
+    const size_t count = sizeof(kValues) / sizeof(kValues[0]);
+    std::string wire;
+    WireFormat::Writer writer(wire);
+    writer.BeginRecord(count + 2);
+    for (double v : kValues)
+      writer.Double(v);
+    writer.Double(0.0);
+    writer.Double(INFINITY);
+    WireFormat::Reader reader(wire);
+    bool ok = reader.Next();
+    for (size_t i = 0; ok && i < count; i++)
+      ok = reader.Number(i, -1) == kValues[i];
+    ok = ok && reader.Number(count, -1) == 0.0 && reader.Number(count + 1, -1) == 0.0;
+    WireFormat::Reader script("R3:d20:4803839602528529p-57d4:3p-1d3:1p1");  // wDbl(1/30), 1.5, 2
+    ok = ok && script.Next() && script.Number(0, -1) == 1.0 / 30.0 &&
+         script.Number(1, -1) == 1.5 && script.Number(2, -1) == 2.0;
+    std::string compact; // Writer drops trailing zero bits like wDbl
+    WireFormat::Writer compactWriter(compact);
+    for (double v : {1.0 / 30.0, 1.5, 2.0})
+      compactWriter.Double(v);
+    ok = ok && compact == "d20:4803839602528529p-57d4:3p-1d3:1p1";
+    Check("exact doubles (mantissa p exponent, same text as wDbl)", ok);
+  }
+}
+
+static void CheckMalformed() {
+  {
+    WireFormat::Reader reader("R2:s1:xi2:42");
+    bool ok = reader.Next() && reader.Int(0, -1) == -1 &&
+              reader.String(1).empty() && reader.Float(1, 0) == 42.0f &&
+              reader.Bool(5, true) && reader.Type(7) == WireFormat::FIELD_NONE;
+    Check("mistyped / missing fields use fallback", ok);
+  }
+
+  {
+    static const char *const kMalformed[] = {
+        "R2:s1:x",          // Field count larger than the record
+        "R1:s5:abc",        // Length past the end
+        "R1:x1:a",          // Unknown tag
+        "R1:s1x",           // Missing ':'
+        "X1:s1:a",          // Not a record
+        "R99:",             // More than MAX_FIELDS
+        "R1:i9999999999:1", // Absurd length
+        "R1:s1:\xF0\x9F",   // Surrogate pair cut in half
+    };
+    bool ok = true;
+    for (const char *bad : kMalformed) {
+      WireFormat::Reader reader(bad);
+      while (reader.Next()) {
+      }
+      ok = ok && reader.Failed() && reader.FieldCount() == 0;
+    }
+    WireFormat::Reader partial("R1:s1:aR1:s9:b");
+    ok = ok && partial.Next() && partial.String(0) == "a";
+    ok = ok && !partial.Next() && partial.Failed();
+    Check("malformed / truncated input fails", ok);
+  }
+}
+
+// Multi-MB effects list with non-ASCII names: every record must come back
+static void CheckLargePayload() {
+  std::string wire;
+  WireFormat::Writer writer(wire);
+  size_t records = 0;
+  while (wire.size() < 4 * 1024 * 1024) {
+    std::string name = (records % 3 == 0) ? "\xEB\xB8\x94\xEB\x9F\xAC " : "Effect ";
+    name += std::to_string(records);
+    writer.BeginRecord(WireFormat::EFFECT_FIELD_COUNT);
+    writer.String(name);
+    writer.String("ADBE Effect " + std::to_string(records));
+    writer.String((records % 5 == 0) ? "\xF0\x9F\x8E\xA8 Stylize" : "Blur & Sharpen");
+    records++;
+  }
+  WireFormat::Reader reader(wire);
+  size_t n = 0;
+  bool ok = true;
+  wchar_t name[128];
+  while (reader.Next()) {
+    ok = ok && reader.FieldCount() == WireFormat::EFFECT_FIELD_COUNT &&
+         reader.StringInto(WireFormat::EFFECT_NAME, name, 128) > 0;
+    n++;
+  }
+  Check("4 MB payload, no truncation", ok && n == records && !reader.Failed());
+}
+
+int main() {
+  printf("WireFormat checks\n");
+  CheckStrings();
+  CheckNumbers();
+  CheckMalformed();
+  CheckLargePayload();
+  return TestResult();
+}
@@ -0,0 +1,148 @@
+/*****************************************************************************
+ * LogDecoder.cpp
+ *
+ * Prints an AnchorSnap binary log (Logger) as text
+ *
+ * Usage: LogDecoder <file.aslog> [--level L] [--category a,b] [--stats]
+ *   - one line per record: "[seconds.micros] LEVEL category text"
+ *   - a separator per session (file header)
+ *   - sequence gaps (records dropped because the ring was full)
+ *   - stops at a damaged / truncated record and reports the offset
+ *****************************************************************************/
+
+#include "Logger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+static bool ParseLevel(const char *text, Logger::Level &level) {
+  for (int l = Logger::LEVEL_DEBUG; l < Logger::LEVEL_OFF; l++) {
+    const char *name = Logger::LevelName((Logger::Level)l);
+    size_t i = 0;
+    while (name[i] && text[i] && (name[i] | 0x20) == (text[i] | 0x20))
+      i++;
+    if (!name[i] && !text[i]) {
+      level = (Logger::Level)l;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Category mask from "input,script"
+static bool ParseCategories(const char *text, uint32_t &mask) {
+  mask = 0;
+  std::stringstream list(text);
+  std::string item;
+  while (std::getline(list, item, ',')) {
+    bool found = false;
+    for (int c = 0; c < Logger::CAT_COUNT; c++) {
+      if (item == Logger::CategoryName((Logger::Category)c)) {
+        mask |= 1u << c;
+        found = true;
+      }
+    }
+    if (!found)
+      return false;
+  }
+  return mask != 0;
+}
+
+static int Usage() {
+  fprintf(stderr, "usage: LogDecoder <file.aslog> [--level debug|info|warn|error] "
+                  "[--category general,input,script,catalog,idle,profile] [--stats]\n");
+  return 2;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2)
+    return Usage();
+
+  Logger::Level minLevel = Logger::LEVEL_DEBUG;
+  uint32_t categories = ~0u;
+  bool stats = false;
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+      if (!ParseLevel(argv[++i], minLevel))
+        return Usage();
+    } else if (strcmp(argv[i], "--category") == 0 && i + 1 < argc) {
+      if (!ParseCategories(argv[++i], categories))
+        return Usage();
+    } else if (strcmp(argv[i], "--stats") == 0) {
+      stats = true;
+    } else {
+      return Usage();
+    }
+  }
+
+  std::ifstream file(argv[1], std::ios::binary);
+  if (!file) {
+    fprintf(stderr, "cannot open %s\n", argv[1]);
+    return 1;
+  }
+  std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+  uint64_t countByLevel[Logger::LEVEL_OFF] = {};
+  uint64_t countByCategory[Logger::CAT_COUNT] = {};
+  uint64_t lost = 0, sessions = 0;
+  bool haveSequence = false;
+  uint32_t nextSequence = 0;
+  size_t offset = 0;
+  int result = 0;
+
+  while (offset < data.size()) {
+    Logger::FileHeader header;
+    if (Logger::ReadFileHeader(data.data(), data.size(), offset, header)) {
+      sessions++;
+      haveSequence = false;
+      printf("=== session %llu ===\n", (unsigned long long)sessions);
+      continue;
+    }
+    Logger::Record record;
+    size_t at = offset;
+    if (sessions == 0 || !Logger::ReadRecord(data.data(), data.size(), offset, record)) {
+      fprintf(stderr, "damaged or truncated record at offset %zu (%zu bytes left)\n", at,
+              data.size() - at);
+      result = 1;
+      break;
+    }
+
+    // Logger's own drop reports carry UINT32_MAX. Records of concurrent
+    // threads can land slightly out of order: a late one fills its gap.
+    uint32_t sequence = record.header.sequence;
+    if (sequence != UINT32_MAX) {
+      if (haveSequence && (int32_t)(sequence - nextSequence) > 0) {
+        uint32_t gap = sequence - nextSequence;
+        lost += gap;
+        printf("--- %u records lost ---\n", gap);
+      } else if (haveSequence && (int32_t)(sequence - nextSequence) < 0 && lost > 0) {
+        lost--;
+      }
+      if (!haveSequence || (int32_t)(sequence - nextSequence) >= 0)
+        nextSequence = sequence + 1;
+      haveSequence = true;
+    }
+
+    countByLevel[record.header.level]++;
+    countByCategory[record.header.category]++;
+    if (record.header.level >= minLevel && (categories & (1u << record.header.category)))
+      printf("%s\n", Logger::FormatRecord(record).c_str());
+  }
+
+  if (stats) {
+    printf("\n%llu sessions, %llu records lost\n", (unsigned long long)sessions,
+           (unsigned long long)lost);
+    for (int l = 0; l < Logger::LEVEL_OFF; l++)
+      printf("  %-7s %llu\n", Logger::LevelName((Logger::Level)l),
+             (unsigned long long)countByLevel[l]);
+    for (int c = 0; c < Logger::CAT_COUNT; c++)
+      printf("  %-7s %llu\n", Logger::CategoryName((Logger::Category)c),
+             (unsigned long long)countByCategory[c]);
+  }
+  return result;
+}
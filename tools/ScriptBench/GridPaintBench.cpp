@@ -0,0 +1,65 @@
+/*****************************************************************************
+ * GridPaintBench.cpp
+ *
+ * ScriptBench section 18 (Windows only): grid window frame time, 7x7 grid
+ * at scale 1.7, while the hover sweeps across cells and icons:
+ *   - full repaint: every hover change invalidates the whole window and
+ *     redraws cells, marks and icons (InvalidateGrid, the old UpdateHover)
+ *   - retained:     UpdateHover invalidates the old and new hover rects,
+ *     WM_PAINT copies the cached static layer and draws the hover on top
+ *
+ * Drives the real GridUI window and reads the frame times from the
+ * "paint.grid" Profiler site. The static layer checks are
+ * cpp/tests/GridUITest.
+ *****************************************************************************/
+
+#include "GridFixtures.h"
+#include "GridUI.h"
+#include "Profiler.h"
+
+#include <cstdio>
+#include <vector>
+
+static int s_failures = 0;
+
+static void Check(const char *label, bool ok) {
+  if (!ok)
+    s_failures++;
+  printf("  [%s] %s\n", ok ? "PASS" : "FAIL", label);
+}
+
+int RunGridPaintBench(int iterations) {
+  printf("\nGrid paint (7x7 @ 1.7)\n");
+
+  bool wasEnabled = Profiler::IsEnabled();
+  Profiler::SetEnabled(true);
+
+  RECT window = {0, 0, 0, 0};
+  HWND hwnd = ShowTestGrid(window);
+  if (hwnd) {
+    std::vector<POINT> path = RasterPath(window);
+    int moves = iterations / 100;
+    if (moves < (int)path.size())
+      moves = (int)path.size();
+    if (moves > 4 * (int)path.size())
+      moves = 4 * (int)path.size();
+
+    SweepResult full = Sweep(hwnd, path, moves, true);
+    SweepResult retained = Sweep(hwnd, path, moves, false);
+    double fullUs = MeanUs(full.paint);
+    double retainedUs = MeanUs(retained.paint);
+    printf("  hover sweep x%d moves, %llu frames: full repaint %.1f us (p50 %.1f), "
+           "retained %.1f us (p50 %.1f), %.2fx\n",
+           moves, (unsigned long long)retained.paint.count, fullUs,
+           (double)full.paint.p50Ns / 1e3, retainedUs, (double)retained.paint.p50Ns / 1e3,
+           retainedUs > 0 ? fullUs / retainedUs : 0.0);
+    Check("retained frame cheaper than a full repaint", retainedUs < fullUs);
+  } else {
+    Check("grid window shown", false);
+  }
+
+  HideTestGrid(window);
+  Profiler::Reset();
+  Profiler::SetEnabled(wasEnabled);
+  return s_failures;
+}
@@ -0,0 +1,61 @@
+/*****************************************************************************
+ * IconAtlasBench.cpp
+ *
+ * ScriptBench section 20 (Windows only): paint time of an icon bar (6
+ * preset-style icons, AA paths, scale 1.5):
+ *   - direct: every paint rebuilds and fills the vector shapes
+ *   - atlas:  first paint rasterizes each (icon, state), later paints copy
+ * The atlas checks are cpp/tests/IconAtlasTest.
+ *
+ * Kept in its own translation unit: windows.h / gdiplus.h stay out of
+ * ScriptBench.cpp (min / max macros).
+ *****************************************************************************/
+
+#include "IconAtlas.h"
+#include "PaintFixtures.h"
+#include "RenderContext.h"
+
+#include <chrono>
+#include <cstdio>
+
+typedef std::chrono::steady_clock Clock;
+
+static double PaintUs(Clock::time_point start, int paints) {
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() /
+         1e3 / paints;
+}
+
+int RunIconAtlasBench(int iterations) {
+  printf("\nIcon bar paint (6 icons @ %.1f)\n", BAR_SCALE);
+
+  RenderContext::Acquire();
+  IconAtlas::SetScale(IconAtlas::OWNER_CONTROL, BAR_SCALE);
+  HDC screen = GetDC(NULL);
+  {
+    PaintTarget direct(screen, BarDeviceWidth(), BarDeviceHeight());
+    PaintTarget atlas(screen, BarDeviceWidth(), BarDeviceHeight());
+
+    // Hover walking along the bar
+    int paints = iterations / 500;
+    if (paints < 50)
+      paints = 50;
+    if (paints > 2000)
+      paints = 2000;
+    for (int i = 0; i < BAR_ICON_COUNT; i++)
+      PaintBar(atlas.dc, true, i); // Warm every hover state
+    Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < paints; i++)
+      PaintBar(direct.dc, false, i % BAR_ICON_COUNT);
+    double directUs = PaintUs(t0, paints);
+    t0 = Clock::now();
+    for (int i = 0; i < paints; i++)
+      PaintBar(atlas.dc, true, i % BAR_ICON_COUNT);
+    double atlasUs = PaintUs(t0, paints);
+    printf("  icon bar paint x%d: direct %.1f us, atlas %.1f us (%.2fx)\n", paints, directUs,
+           atlasUs, atlasUs > 0 ? directUs / atlasUs : 0.0);
+    printf("  %s", IconAtlas::FormatReport().c_str());
+  }
+  ReleaseDC(NULL, screen);
+  RenderContext::Release();
+  return 0;
+}
@@ -0,0 +1,93 @@
+/*****************************************************************************
+ * PaintBench.cpp
+ *
+ * ScriptBench section 13 (Windows only): paint time before and after the
+ * shared render context, for a representative panel (header, 12 rows,
+ * icons, right-aligned text) and for each module that moved to it (Grid,
+ * Control, Keyframe, Align, Text, Shape, Comp, DMenu, from their paint
+ * profiles in PaintFixtures.h):
+ *   - before: memory DC + bitmap and fresh brushes / pens / fonts /
+ *     StringFormats on every paint (what each module's WM_PAINT did)
+ *   - after:  Backbuffer reused across paints, pooled resources
+ * The pooling / pixel checks are cpp/tests/RenderContextTest. The real grid
+ * window is timed in GridPaintBench.cpp; in AE, each module's WM_PAINT
+ * reports its "paint.<module>" Profiler site.
+ *
+ * Kept in its own translation unit: windows.h / gdiplus.h stay out of
+ * ScriptBench.cpp (min / max macros).
+ *****************************************************************************/
+
+#include "PaintFixtures.h"
+#include "RenderContext.h"
+
+#include <chrono>
+#include <cstdio>
+
+typedef std::chrono::steady_clock Clock;
+
+static double PaintUs(Clock::time_point start, int paints) {
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count() /
+         1e3 / paints;
+}
+
+int RunPaintBench(int iterations) {
+  printf("\nPanel paint (GDI+)\n");
+  using RenderContext::GetStats;
+
+  RenderContext::Acquire();
+  HDC screen = GetDC(NULL);
+  {
+    PaintTarget before(screen, PANEL_WIDTH, PANEL_HEIGHT), after(screen, PANEL_WIDTH, PANEL_HEIGHT);
+    RenderContext::Backbuffer backbuffer;
+    PaintPanelAfter(backbuffer, after.dc, 0); // Warm the pool
+
+    // The same panel, alternating hover rows like a mouse move
+    int paints = iterations / 500;
+    if (paints < 50)
+      paints = 50;
+    if (paints > 2000)
+      paints = 2000;
+    Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < paints; i++)
+      PaintPanelBefore(before.dc, i % PANEL_ROW_COUNT);
+    double beforeUs = PaintUs(t0, paints);
+    uint64_t misses = GetStats().misses;
+    t0 = Clock::now();
+    for (int i = 0; i < paints; i++)
+      PaintPanelAfter(backbuffer, after.dc, i % PANEL_ROW_COUNT);
+    double afterUs = PaintUs(t0, paints);
+    printf("  panel paint x%d: before %.1f us, after %.1f us (%.2fx), %llu resources created\n",
+           paints, beforeUs, afterUs, afterUs > 0 ? beforeUs / afterUs : 0.0,
+           (unsigned long long)(GetStats().misses - misses));
+  }
+
+  // Per module: its paint profile, hover moving over the items
+  int paints = iterations / 2000;
+  if (paints < 20)
+    paints = 20;
+  if (paints > 500)
+    paints = 500;
+  printf("  %-9s %9s %10s %10s %10s %7s\n", "module", "size", "objects", "before", "after",
+         "speedup");
+  for (int i = 0; i < MODULE_PAINT_COUNT; i++) {
+    const ModulePaint &m = MODULE_PAINTS[i];
+    PaintTarget before(screen, m.width, m.height), after(screen, m.width, m.height);
+    RenderContext::Backbuffer backbuffer;
+    PaintModuleAfter(backbuffer, after.dc, m, 0); // Warm the pool
+    Clock::time_point t0 = Clock::now();
+    for (int p = 0; p < paints; p++)
+      PaintModuleBefore(before.dc, m, p % m.items);
+    double beforeUs = PaintUs(t0, paints);
+    t0 = Clock::now();
+    for (int p = 0; p < paints; p++)
+      PaintModuleAfter(backbuffer, after.dc, m, p % m.items);
+    double afterUs = PaintUs(t0, paints);
+    char size[16];
+    snprintf(size, sizeof(size), "%dx%d", m.width, m.height);
+    printf("  %-9s %9s %10d %8.1f us %7.1f us %6.2fx\n", m.name, size, ModulePaintResources(m),
+           beforeUs, afterUs, afterUs > 0 ? beforeUs / afterUs : 0.0);
+  }
+  ReleaseDC(NULL, screen);
+  RenderContext::Release();
+  return 0;
+}
@@ -0,0 +1,1412 @@
+/*****************************************************************************
+ * ScriptBench.cpp
+ *
+ * Micro-benchmark: ScriptBuilder::Render vs snprintf into a fixed buffer,
+ * and the timing of every component that replaced an older path. The
+ * behaviour checks live in cpp/tests (one test per component); the few
+ * checks left here compare two timings.
+ *
+ * Usage: ScriptBench [iterations]
+ *   1. Timing of two script shapes used by the plugin:
+ *      - long text-layer script with one string + one float slot
+ *      - short library call with ints and bools
+ *   2. ScriptBatch: one D-menu tick sent call by call vs one batch at the
+ *      modeled host round-trip, and compose + split overhead per call
+ *   3. WireFormat: a multi-MB effects-list payload timed against the old
+ *      "a|b|c;" widen + wstring::substr parsing
+ *   4. CatalogCache: cold vs warm startup with a 5,000-effect catalog
+ *   5. FontCatalog: 50,000 fonts cold build, warm map, list copy and
+ *      revalidation (unchanged / 3 families changed)
+ *   6. EffectEnumerator: native build vs the script path, and cold start to
+ *      the ControlUI list: via the catalog vs widened directly
+ *   7. PanelPrefetch: D-menu choice -> panel paint latency, per-panel
+ *      script vs one snapshot, against a mock host
+ *   8. InputQueue: unpaced producer thread against a spinning consumer
+ *   9. Profiler: probe overhead disabled (< 20 ns) vs enabled
+ *  10. Logger: 1M-message records written per second and caller tail
+ *      latency against the old fprintf + fflush per line
+ *  11. Tracer: scope overhead disabled / recording, and stop cost
+ *  12. ModuleRegistry: registration vs first-show cost
+ *  13. Paint time before / after pooled resources, a representative panel
+ *      and each module's paint profile (Windows only, PaintBench.cpp)
+ *  14. Grid window frame time, 7x7 @ 1.7, hover sweep: full repaint vs
+ *      cached static layer + dirty rects (Windows only, GridPaintBench.cpp)
+ *  15. Canvas: GridUI / ControlUI paint paths (GridPaint, ControlPaint)
+ *      rendered headless to PNG with static / hover / panel frame cost, and
+ *      blend throughput SSE2 vs scalar
+ *  16. Icon bar paint time direct vs atlas (Windows only,
+ *      IconAtlasBench.cpp)
+ *  17. Keyframe curve drag-frame cost with all 12 presets visible, before /
+ *      after the tessellation cache
+ *  18. Timing curve throughput (x -> t, value, integral, SIMD batch) and
+ *      exact integral vs the old Simpson rule
+ *  19. AE ease <-> timing curve conversions per second vs the old heuristic
+ *  20. KeyframeSelection: 10,000 selected keys parse + apply cost against a
+ *      mock AE host
+ *  21. ScriptLibrary: bytes / tokens / lex cost per call, inline scripts vs
+ *      library calls (RunBenchmark against a mock host)
+ *****************************************************************************/
+
+#include "Canvas.h"
+#include "CatalogCache.h"
+#include "ContextCache.h"
+#include "ControlPaint.h"
+#include "CurveMath.h"
+#include "EaseModel.h"
+#include "EffectEnumerator.h"
+#include "FontCatalog.h"
+#include "GridPaint.h"
+#include "KeyframeSelection.h"
+#include "Logger.h"
+#include "ModuleRegistry.h"
+#include "Tracer.h"
+#include "PanelPrefetch.h"
+#include "Profiler.h"
+#include "ScriptBatch.h"
+#include "ScriptBuilder.h"
+#include "ScriptLibrary.h"
+#include "ScriptResult.h"
+#include "WireFormat.h"
+
+#include "ContextFixtures.h"
+#include "CurveFixtures.h"
+#include "EffectFixtures.h"
+#include "FontFixtures.h"
+#include "InputFixtures.h"
+#include "KeyframeFixtures.h"
+#include "ScriptFixtures.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <cwctype>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+int RunPaintBench(int iterations); // PaintBench.cpp: failure count
+int RunGridPaintBench(int iterations); // GridPaintBench.cpp: failure count
+int RunIconAtlasBench(int iterations); // IconAtlasBench.cpp: failure count
+#endif
+
+#define TEXT_DOC_SCRIPT(assign)                                              \
+  "(function(){"                                                             \
+  "try{"                                                                     \
+  "var c=app.project.activeItem;"                                            \
+  "if(!c||!(c instanceof CompItem))return;"                                  \
+  "var sel=c.selectedLayers;"                                                \
+  "for(var i=0;i<sel.length;i++){"                                           \
+  "if(!(sel[i] instanceof TextLayer))continue;"                              \
+  "var txt=sel[i].text.sourceText;"                                          \
+  "var doc=txt.value;" assign "txt.setValue(doc);"                           \
+  "}"                                                                        \
+  "}catch(e){}"                                                              \
+  "})();"
+
+SCRIPT_TEMPLATE(TextPropertyScript, TEXT_DOC_SCRIPT("doc[${s}]=${f};"));
+static const char *const kTextPropertyFormat = TEXT_DOC_SCRIPT("doc.%s=%f;");
+
+SCRIPT_TEMPLATE(ApplyAnchorCall, "applyAnchor(${i},${i},${i},${i},${b},${b})");
+
+/*****************************************************************************
+ * Timing
+ *****************************************************************************/
+typedef std::chrono::high_resolution_clock Clock;
+
+static double ElapsedNs(Clock::time_point start, int iterations) {
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                Clock::now() - start).count();
+  return (double)ns / iterations;
+}
+
+// Consume output so the loops are not optimized away
+static volatile size_t s_sink = 0;
+
+// Mock AEGP_ExecuteScript round-trip (assumed cost, busy-wait for accuracy)
+static const double kHostRoundTripMs = 4.0;
+
+static void SpinFor(double ms) {
+  auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                std::chrono::duration<double, std::milli>(ms));
+  while (Clock::now() < end) {
+  }
+}
+
+static void RunBenchmark(int iterations) {
+  ScriptBuilder::Arena arena;
+  char buffer[1024];
+  printf("Benchmark (%d iterations, ns per script)\n", iterations);
+
+  auto t0 = Clock::now();
+  for (int i = 0; i < iterations; i++) {
+    snprintf(buffer, sizeof(buffer), kTextPropertyFormat, "fontSize",
+             12.0f + (i & 7));
+    s_sink += (size_t)buffer[40];
+  }
+  double textPrintf = ElapsedNs(t0, iterations);
+
+  t0 = Clock::now();
+  for (int i = 0; i < iterations; i++) {
+    const char *s = ScriptBuilder::Render<TextPropertyScript>(
+        arena, "fontSize", 12.0f + (i & 7));
+    s_sink += (size_t)s[40];
+  }
+  double textRender = ElapsedNs(t0, iterations);
+
+  t0 = Clock::now();
+  for (int i = 0; i < iterations; i++) {
+    snprintf(buffer, sizeof(buffer), "applyAnchor(%d,%d,%d,%d,%s,%s)", i & 3,
+             (i >> 2) & 3, 3, 3, (i & 1) ? "true" : "false", "false");
+    s_sink += (size_t)buffer[12];
+  }
+  double callPrintf = ElapsedNs(t0, iterations);
+
+  t0 = Clock::now();
+  for (int i = 0; i < iterations; i++) {
+    const char *s = ScriptBuilder::Render<ApplyAnchorCall>(
+        arena, i & 3, (i >> 2) & 3, 3, 3, (i & 1) != 0, false);
+    s_sink += (size_t)s[12];
+  }
+  double callRender = ElapsedNs(t0, iterations);
+
+  printf("  %-14s %10s %10s\n", "script", "snprintf", "Render");
+  printf("  %-14s %10.1f %10.1f\n", "text property", textPrintf, textRender);
+  printf("  %-14s %10.1f %10.1f\n", "library call", callPrintf, callRender);
+}
+
+/*****************************************************************************
+ * ScriptBatch
+ *****************************************************************************/
+struct BatchHost {
+  double roundTripMs = 0;
+};
+
+// Answers every call of a batch with an ACK record ("\x06ok", RS joined);
+// a single script gets its result as is
+static bool BatchRunner(const char *script, std::string &result, void *context) {
+  const BatchHost &host = *(const BatchHost *)context;
+  SpinFor(host.roundTripMs);
+  static const char kCall[] = "try{__o.push('\\x06'";
+  size_t calls = 0;
+  for (const char *p = strstr(script, kCall); p; p = strstr(p + 1, kCall))
+    calls++;
+  result.clear();
+  if (calls == 0) {
+    result = "ok";
+    return true;
+  }
+  for (size_t i = 0; i < calls; i++) {
+    if (i)
+      result += '\x1e';
+    result += "\x06ok";
+  }
+  return true;
+}
+
+static void RunScriptBatchBench(int iterations) {
+  printf("\nScriptBatch\n");
+  BatchHost host;
+  ScriptBatch::SetRunner(BatchRunner, &host);
+
+  // Round trips: one tick of the D menu / control panel, calls sent one by
+  // one (before) vs one batch (after), at the modeled host round-trip
+  host.roundTripMs = kHostRoundTripMs;
+  const int ticks = 20, callsPerTick = 6;
+  auto runTicks = [&](bool batched) {
+    ScriptBatch::ResetStats();
+    auto t0 = Clock::now();
+    for (int t = 0; t < ticks; t++) {
+      for (int i = 0; i < callsPerTick - 1; i++) {
+        std::string script = "set(" + std::to_string(i) + ")";
+        ScriptBatch::Enqueue("ExecuteScript", script.c_str());
+        if (!batched)
+          ScriptBatch::Flush();
+      }
+      s_sink += ScriptBatch::Enqueue("QueryScript", "state()").Get().size();
+    }
+    return ElapsedNs(t0, ticks) / 1e6;
+  };
+  double singleMs = runTicks(false);
+  ScriptBatch::Stats single = ScriptBatch::GetStats();
+  double batchMs = runTicks(true);
+  ScriptBatch::Stats batched = ScriptBatch::GetStats();
+  printf("  %d calls / tick at %.1f ms per round-trip: one by one %.1f ms (%llu round-trips, "
+         "%.0f B sent / call), batched %.1f ms (%llu round-trips, %.0f B sent / call)\n",
+         callsPerTick, kHostRoundTripMs, singleMs, (unsigned long long)single.batches,
+         (double)single.bytesSent / single.calls, batchMs, (unsigned long long)batched.batches,
+         (double)batched.bytesSent / batched.calls);
+  Check("batched tick: one round-trip, faster than one by one",
+        batched.batches == (uint64_t)ticks && batchMs < singleMs);
+
+  // Compose + host + split cost per call, host round-trip excluded
+  host.roundTripMs = 0;
+  int rounds = std::max(1, iterations / 100);
+  auto t0 = Clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < 8; i++)
+      ScriptBatch::Enqueue("bench", "echo('x\x1ey')");
+    ScriptBatch::Flush();
+  }
+  printf("  batch overhead (compose + mock host + split): %.0f ns / call\n",
+         ElapsedNs(t0, rounds * 8));
+  ScriptBatch::SetRunner(nullptr, nullptr);
+  ScriptBatch::ResetStats();
+}
+
+/*****************************************************************************
+ * WireFormat
+ *****************************************************************************/
+// Effects list with non-ASCII names mixed in, in both formats:
+// legacy "name|ADBE matchName|category;" text and wire records
+static void MakeEffectsPayload(size_t targetBytes, std::string &legacy,
+                               std::string &wire, size_t &records) {
+  legacy.clear();
+  wire.clear();
+  legacy.reserve(targetBytes + 128);
+  wire.reserve(targetBytes + targetBytes / 4);
+  WireFormat::Writer writer(wire);
+  records = 0;
+  while (legacy.size() < targetBytes) {
+    std::string name = (records % 3 == 0) ? "\xEB\xB8\x94\xEB\x9F\xAC " : "Effect ";
+    name += std::to_string(records);
+    std::string matchName = "ADBE Effect " + std::to_string(records);
+    const char *category =
+        (records % 5 == 0) ? "\xF0\x9F\x8E\xA8 Stylize" : "Blur & Sharpen";
+
+    if (records)
+      legacy += ';';
+    legacy += name + '|' + matchName + '|' + category;
+
+    writer.BeginRecord(WireFormat::EFFECT_FIELD_COUNT);
+    writer.String(name);
+    writer.String(matchName);
+    writer.String(category);
+    records++;
+  }
+}
+
+static void RunWireBench(int iterations) {
+  printf("\nWireFormat\n");
+  size_t records = 0;
+  std::string legacy, wire;
+  MakeEffectsPayload(4 * 1024 * 1024, legacy, wire, records);
+
+  int runs = iterations / 100000;
+  if (runs < 3)
+    runs = 3;
+
+  // Old path: widen the whole result, then wstring find/substr per field
+  auto t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    std::wstring list = ScriptResult::Widen(legacy);
+    size_t pos = 0, n = 0;
+    while (pos < list.length()) {
+      size_t end = list.find(L';', pos);
+      if (end == std::wstring::npos)
+        end = list.length();
+      std::wstring item = list.substr(pos, end - pos);
+      size_t sep1 = item.find(L'|');
+      size_t sep2 = item.find(L'|', sep1 + 1);
+      std::wstring a = item.substr(0, sep1);
+      std::wstring b = item.substr(sep1 + 1, sep2 - sep1 - 1);
+      std::wstring c = item.substr(sep2 + 1);
+      n += a.size() + b.size() + c.size();
+      pos = end + 1;
+    }
+    s_sink += n;
+  }
+  double oldMs = ElapsedNs(t0, runs) / 1e6;
+
+  // Framing only: walk the records without widening (reader overhead)
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    WireFormat::Reader reader(wire);
+    size_t n = 0;
+    while (reader.Next())
+      n += reader.String(WireFormat::EFFECT_NAME).size();
+    s_sink += n;
+  }
+  double frameMs = ElapsedNs(t0, runs) / 1e6;
+
+  // New path: read in place, widen each field once into its slot
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    WireFormat::Reader reader(wire);
+    wchar_t a[128], b[128], c[64];
+    size_t n = 0;
+    while (reader.Next()) {
+      n += reader.StringInto(WireFormat::EFFECT_NAME, a, 128);
+      n += reader.StringInto(WireFormat::EFFECT_MATCH_NAME, b, 128);
+      n += reader.StringInto(WireFormat::EFFECT_CATEGORY_OR_INDEX, c, 64);
+    }
+    s_sink += n;
+  }
+  double newMs = ElapsedNs(t0, runs) / 1e6;
+
+  printf("  %.1f MB (wire %.1f MB), %zu records, ms per parse: "
+         "substr %.2f, wire framing %.2f, wire + widen %.2f\n",
+         legacy.size() / (1024.0 * 1024.0), wire.size() / (1024.0 * 1024.0),
+         records, oldMs, frameMs, newMs);
+}
+
+/*****************************************************************************
+ * CatalogCache
+ *****************************************************************************/
+static void RunCatalogBench(int iterations) {
+  printf("\nCatalogCache\n");
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  fs::path dir = fs::temp_directory_path(ec) / "ScriptBench";
+  fs::create_directories(dir, ec);
+  fs::path file = dir / "effects-catalog.bin";
+
+  CatalogCache::Key key;
+  key.hostBuild = "25.0x52";
+  key.language = "ko_KR";
+  key.fingerprint = 0x1234;
+
+  const uint32_t effectCount = 5000;
+  std::string wire = EffectsWire(effectCount);
+
+  int runs = iterations / 10000;
+  if (runs < 5)
+    runs = 5;
+  std::vector<FixtureEffectItem> items;
+
+  // Cold: effectsList() result -> catalog -> items, then write the cache
+  auto t0 = Clock::now();
+  size_t fileBytes = 0;
+  for (int r = 0; r < runs; r++) {
+    CatalogCache::Builder builder(WireFormat::EFFECT_FIELD_COUNT);
+    builder.AddFromWire(wire);
+    CatalogCache::Catalog catalog;
+    catalog.Adopt(builder.Finish(key));
+    s_sink += CopyEffects(catalog, items);
+    CatalogCache::WriteFile(file, catalog.Data(), catalog.Size());
+    fileBytes = catalog.Size();
+  }
+  double coldMs = ElapsedNs(t0, runs) / 1e6;
+
+  // Warm: map the cache file -> items
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    CatalogCache::Catalog catalog;
+    if (catalog.Open(file) && catalog.Matches(key, false))
+      s_sink += CopyEffects(catalog, items);
+  }
+  double warmMs = ElapsedNs(t0, runs) / 1e6;
+
+  // Warm, map only (what blocks the first idle tick before ControlUI copies)
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    CatalogCache::Catalog catalog;
+    catalog.Open(file);
+    s_sink += catalog.RecordCount();
+  }
+  double mapUs = ElapsedNs(t0, runs) / 1e3;
+
+  printf("  %u effects, wire %.0f KB, cache %.0f KB\n", effectCount,
+         wire.size() / 1024.0, fileBytes / 1024.0);
+  printf("  startup ms (excluding the effectsList() script itself): "
+         "cold %.2f, warm %.2f (map %.1f us)\n",
+         coldMs, warmMs, mapUs);
+
+  fs::remove_all(dir, ec);
+}
+
+/*****************************************************************************
+ * FontCatalog
+ *****************************************************************************/
+// TextUI::SetFonts equivalent (wstring copies + lowercased search key)
+static size_t CopyFonts(const CatalogCache::Catalog &catalog,
+                        std::vector<std::wstring> &display) {
+  uint32_t count = catalog.RecordCount();
+  display.clear();
+  display.resize(count);
+  size_t n = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    std::wstring family = catalog.WideField(i, WireFormat::FONT_FAMILY);
+    std::wstring style = catalog.WideField(i, WireFormat::FONT_STYLE);
+    std::wstring ps = catalog.WideField(i, WireFormat::FONT_POSTSCRIPT_NAME);
+    display[i] = family + L" " + style;
+    for (auto &c : display[i])
+      c = towlower(c);
+    n += display[i].size() + ps.size();
+  }
+  return n;
+}
+
+static void RunFontCatalogBench(int iterations) {
+  printf("\nFontCatalog\n");
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  fs::path dir = fs::temp_directory_path(ec) / "ScriptBench";
+  fs::path file = dir / "fonts-catalog.bin";
+
+  CatalogCache::Key key;
+  key.hostBuild = "25.0x52";
+  key.language = "ko_KR";
+
+  const size_t fontCount = 50000;
+  std::vector<FixtureFont> fonts = MakeFonts(fontCount);
+  std::string fontsWire = FontsWire(fonts);
+  std::string familiesWire = FamiliesWire(fonts);
+
+  // Cached catalog as the last session left it
+  CatalogCache::Builder builder(WireFormat::FONT_FIELD_COUNT);
+  builder.AddFromWire(fontsWire);
+  CatalogCache::Catalog cached;
+  cached.Adopt(builder.Finish(key));
+  key.fingerprint = FontCatalog::Fingerprint(cached);
+  cached.SetKey(key);
+  CatalogCache::WriteFile(file, cached.Data(), cached.Size());
+
+  // One family removed, one gains a style, one new family
+  std::vector<FixtureFont> updated = ChangeFonts(fonts);
+  std::string updatedFamilies = FamiliesWire(updated);
+  FontCatalog::Diff diff = FontCatalog::Compare(cached, updatedFamilies);
+  std::string changedWire = FontsOfWire(diff.changedWire, updated, nullptr);
+  CatalogCache::Key updatedKey = key;
+  updatedKey.fingerprint = FontCatalog::FingerprintFamilies(updatedFamilies);
+
+  int runs = iterations / 20000;
+  if (runs < 3)
+    runs = 3;
+  std::vector<std::wstring> display;
+
+  auto t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    CatalogCache::Builder b(WireFormat::FONT_FIELD_COUNT);
+    b.AddFromWire(fontsWire);
+    CatalogCache::Catalog catalog;
+    catalog.Adopt(b.Finish(key));
+    s_sink += FontCatalog::Fingerprint(catalog);
+    s_sink += catalog.Size();
+  }
+  double coldMs = ElapsedNs(t0, runs) / 1e6;
+
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    CatalogCache::Catalog catalog;
+    catalog.Open(file);
+    s_sink += catalog.RecordCount();
+  }
+  double mapUs = ElapsedNs(t0, runs) / 1e3;
+
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++)
+    s_sink += CopyFonts(cached, display);
+  double copyMs = ElapsedNs(t0, runs) / 1e6;
+
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++)
+    s_sink += FontCatalog::FingerprintFamilies(familiesWire);
+  double checkMs = ElapsedNs(t0, runs) / 1e6;
+
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    FontCatalog::Diff d = FontCatalog::Compare(cached, updatedFamilies);
+    std::vector<uint8_t> image =
+        FontCatalog::Merge(cached, updatedFamilies, changedWire, updatedKey);
+    s_sink += d.changed + image.size();
+  }
+  double mergeMs = ElapsedNs(t0, runs) / 1e6;
+
+  printf("  %zu fonts, %zu families wire %.0f KB, fontsList wire %.0f KB, "
+         "cache %.0f KB\n",
+         fontCount, diff.families, updatedFamilies.size() / 1024.0,
+         fontsWire.size() / 1024.0, cached.Size() / 1024.0);
+  printf("  ms (excluding scripts): cold build %.2f, warm map %.3f, "
+         "list copy %.2f\n",
+         coldMs, mapUs / 1000.0, copyMs);
+  printf("  revalidate ms: unchanged %.2f, 3 families changed %.2f\n",
+         checkMs, mergeMs);
+
+  fs::remove_all(dir, ec);
+}
+
+/*****************************************************************************
+ * EffectEnumerator
+ *****************************************************************************/
+static void RunEnumeratorBench(int iterations) {
+  printf("\nEffectEnumerator\n");
+  CatalogCache::Key key;
+  key.hostBuild = "25.0x52";
+  key.language = "ko_KR";
+
+  // 5,000 installed effects, every 50th hidden (empty category)
+  const size_t effectCount = 5000;
+  EffectEnumerator::MockSource source;
+  std::string wire; // What effectsList() returns for the same effects
+  size_t listed = MakeEffectSource(effectCount, source, wire);
+
+  int runs = iterations / 5000;
+  if (runs < 5)
+    runs = 5;
+
+  // Script path, host side excluded: the joined result is re-parsed
+  auto t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    CatalogCache::Builder builder(WireFormat::EFFECT_FIELD_COUNT);
+    builder.AddFromWire(wire);
+    s_sink += builder.Finish(key).size();
+  }
+  double scriptMs = ElapsedNs(t0, runs) / 1e6;
+
+  // Native path: records go straight into the builder
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    source.Rewind();
+    CatalogCache::Builder builder(WireFormat::EFFECT_FIELD_COUNT);
+    EffectEnumerator::BuildCatalog(source, builder);
+    s_sink += builder.Finish(key).size();
+  }
+  double nativeMs = ElapsedNs(t0, runs) / 1e6;
+
+  printf("  %zu effects (%zu listed), catalog build ms: from script result %.2f, "
+         "native %.2f\n",
+         effectCount, listed, scriptMs, nativeMs);
+  printf("  (the script path also pays app.effects walk + ExecuteScript in AE)\n");
+
+  // Cold start to the ControlUI list. Before: source -> catalog (UTF-16
+  // pool) -> FieldInto each item. After (SnapPlugin EnumerateEffects): each
+  // name widened once into the item; the catalog only feeds the cache file.
+  std::vector<FixtureEffectItem> viaCatalog, direct;
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    source.Rewind();
+    CatalogCache::Builder builder(WireFormat::EFFECT_FIELD_COUNT);
+    EffectEnumerator::BuildCatalog(source, builder);
+    CatalogCache::Catalog catalog;
+    catalog.Adopt(builder.Finish(key));
+    s_sink += CopyEffects(catalog, viaCatalog);
+  }
+  double viaCatalogMs = ElapsedNs(t0, runs) / 1e6;
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    CatalogCache::Builder builder(WireFormat::EFFECT_FIELD_COUNT);
+    EnumerateDirect(source, direct, builder);
+    s_sink += builder.Finish(key).size(); // Cache image, as the plugin keeps it
+  }
+  double directMs = ElapsedNs(t0, runs) / 1e6;
+
+  printf("  cold start to the panel list ms: via catalog %.2f, direct (plus the cache "
+         "image) %.2f\n",
+         viaCatalogMs, directMs);
+}
+
+/*****************************************************************************
+ * PanelPrefetch
+ *****************************************************************************/
+// Stand-in for Set*Info + first paint: decode every field of the record
+static size_t PaintPanel(std::string_view info) {
+  size_t sum = 0;
+  WireFormat::Reader reader(info);
+  while (reader.Next()) {
+    for (size_t f = 0; f < reader.FieldCount(); f++)
+      sum += reader.String(f).size() + (size_t)reader.Int(f, 0);
+  }
+  return sum;
+}
+
+// panelSnapshot() at the modeled host round-trip
+static bool MockPanelQuery(std::string &wire, void *context) {
+  SpinFor(kHostRoundTripMs);
+  return MockContextQuery(wire, context);
+}
+
+static void RunPrefetchBench() {
+  printf("\nPanelPrefetch\n");
+  MockContextHost host;
+  host.wire = PanelSnapshotWire();
+  PanelPrefetch::SetQuery(MockPanelQuery, &host);
+
+  // Latency: D-menu choice -> panel painted, per panel.
+  // Before: the panel's own info script runs after the choice.
+  // After: the snapshot ran while the menu was open; the choice reads memory.
+  const int rounds = 10;
+  double beforeMs = 0.0, afterMs = 0.0;
+  bool found = false;
+  for (int r = 0; r < rounds; r++) {
+    for (int f = WireFormat::PANEL_TEXT; f < WireFormat::PANEL_FIELD_COUNT; f++) {
+      WireFormat::PanelField field = (WireFormat::PanelField)f;
+      std::string record = PanelRecord(field);
+
+      auto t0 = Clock::now();
+      SpinFor(kHostRoundTripMs); // Info script round-trip
+      std::string fetched = record;
+      s_sink += PaintPanel(fetched);
+      beforeMs += ElapsedNs(t0, 1) / 1e6;
+
+      PanelPrefetch::Arm();
+      PanelPrefetch::Run(); // Menu open, user still choosing
+      t0 = Clock::now();
+      std::string_view section = PanelPrefetch::Section(field, found);
+      s_sink += PaintPanel(section);
+      afterMs += ElapsedNs(t0, 1) / 1e6;
+      PanelPrefetch::Discard();
+    }
+  }
+  int samples = rounds * (WireFormat::PANEL_FIELD_COUNT - WireFormat::PANEL_TEXT);
+  PanelPrefetch::SetQuery(nullptr, nullptr);
+  ContextCache::Invalidate();
+  printf("  choice -> paint ms (mock host round-trip %.1f ms): per-panel script %.3f, "
+         "prefetched %.4f\n",
+         kHostRoundTripMs, beforeMs / samples, afterMs / samples);
+  printf("  (the snapshot itself costs one round-trip while the menu is open)\n");
+}
+
+/*****************************************************************************
+ * InputQueue
+ *****************************************************************************/
+static void RunInputQueueBench(int iterations) {
+  printf("\nInputQueue\n");
+  // Producer thread as fast as it can, consumer spinning: ring throughput
+  uint64_t count = (uint64_t)iterations * 4;
+  if (count < 100000)
+    count = 100000;
+  QueueRun run = RunQueueThreads(count, 0, 0);
+  printf("  unpaced producer, spinning consumer: %llu delivered, %llu dropped, "
+         "%.2f Mevents/s\n",
+         (unsigned long long)run.popped, (unsigned long long)run.dropped,
+         (double)count / run.seconds / 1e6);
+}
+
+/*****************************************************************************
+ * Profiler
+ *****************************************************************************/
+#ifdef _MSC_VER
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+// Stand-in for an IdleHook section: a little work, with and without probes
+static BENCH_NOINLINE void ProbeWork(int i) { s_sink += (size_t)i * 3; }
+
+static BENCH_NOINLINE void ProbedWork(int i) {
+  PROFILE_SCOPE("bench.probe");
+  ProbeWork(i);
+}
+
+static double ProbeOverheadNs(int iterations) {
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < iterations; i++)
+    ProbeWork(i);
+  double bare = ElapsedNs(t0, iterations);
+  t0 = Clock::now();
+  for (int i = 0; i < iterations; i++)
+    ProbedWork(i);
+  double probed = ElapsedNs(t0, iterations);
+  return probed > bare ? probed - bare : 0.0;
+}
+
+static void RunProfilerBench(int iterations) {
+  printf("\nProfiler\n");
+  // Probe overhead (probe + ProbedWork call vs ProbeWork alone)
+  Profiler::Reset();
+  int runs = iterations * 10;
+  double disabledNs = ProbeOverheadNs(runs);
+  Profiler::SetEnabled(true);
+  double enabledNs = ProbeOverheadNs(runs);
+  Profiler::SetEnabled(false);
+  Profiler::Reset();
+  printf("  probe overhead: disabled %.2f ns, enabled %.1f ns (%d runs)\n", disabledNs,
+         enabledNs, runs);
+  Check("disabled probe costs < 20 ns", disabledNs < 20.0);
+}
+
+/*****************************************************************************
+ * Logger
+ *****************************************************************************/
+// Per-call latency percentiles through the profiler's histogram buckets
+struct LatencyHistogram {
+  std::vector<uint64_t> buckets = std::vector<uint64_t>(Profiler::BUCKET_COUNT);
+  uint64_t count = 0, maxNs = 0, totalNs = 0;
+  void Add(uint64_t ns) {
+    buckets[Profiler::BucketFor(ns)]++;
+    count++;
+    totalNs += ns;
+    if (ns > maxNs)
+      maxNs = ns;
+  }
+  uint64_t Percentile(double q) const {
+    uint64_t rank = (uint64_t)(q * (double)count), seen = 0;
+    for (int b = 0; b < Profiler::BUCKET_COUNT; b++) {
+      seen += buckets[b];
+      if (seen > rank)
+        return std::min(Profiler::BucketHigh(b), maxNs);
+    }
+    return maxNs;
+  }
+};
+
+static uint64_t SinceNs(Clock::time_point t0) {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0)
+      .count();
+}
+
+static void RunLoggerBench(int iterations) {
+  printf("\nLogger\n");
+  namespace fs = std::filesystem;
+  const std::string path = (fs::temp_directory_path() / "ScriptBench.aslog").string();
+  std::error_code ec;
+  fs::remove(path, ec);
+
+  // 1M messages: caller latency and records written per second (until
+  // Stop returns: every record on disk), async vs fprintf + fflush
+  Logger::ResetStats();
+  Logger::SetRateLimit(0);
+  int count = iterations >= 250000 ? 1000000 : iterations * 4;
+  Logger::Start(path);
+  LatencyHistogram async;
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < count; i++) {
+    Clock::time_point c0 = Clock::now();
+    Logger::Log(Logger::CAT_INPUT, Logger::LEVEL_INFO, "sample %d down=0x%x t=%llu", i,
+                i & 0x1ff, (unsigned long long)i * 16);
+    async.Add(SinceNs(c0));
+  }
+  Logger::Stop();
+  double asyncSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+  Logger::Stats asyncStats = Logger::GetStats();
+
+  // Old LogToFile: format + fprintf + fflush per line on the caller
+  int syncCount = count / 10;
+  FILE *file = fopen(path.c_str(), "w");
+  LatencyHistogram sync;
+  t0 = Clock::now();
+  for (int i = 0; file && i < syncCount; i++) {
+    Clock::time_point c0 = Clock::now();
+    fprintf(file, "sample %d down=0x%x t=%llu", i, i & 0x1ff, (unsigned long long)i * 16);
+    fprintf(file, "\n");
+    fflush(file);
+    sync.Add(SinceNs(c0));
+  }
+  double syncSeconds = std::chrono::duration<double>(Clock::now() - t0).count();
+  if (file)
+    fclose(file);
+  fs::remove(path, ec);
+
+  printf("  %-24s %10s %9s %9s %9s %9s %9s %11s\n", "", "written", "avg", "p50", "p99", "p99.9",
+         "max", "written/s");
+  printf("  %-24s %10llu %7.0fns %7lluns %7lluns %7lluns %7lluus %11.0f\n", "async ring",
+         (unsigned long long)asyncStats.logged, (double)async.totalNs / (double)async.count,
+         (unsigned long long)async.Percentile(0.5), (unsigned long long)async.Percentile(0.99),
+         (unsigned long long)async.Percentile(0.999), (unsigned long long)async.maxNs / 1000,
+         (double)asyncStats.logged / asyncSeconds);
+  printf("  %-24s %10d %7.0fns %7lluns %7lluns %7lluns %7lluus %11.0f\n", "fprintf + fflush",
+         syncCount, (double)sync.totalNs / (double)sync.count,
+         (unsigned long long)sync.Percentile(0.5), (unsigned long long)sync.Percentile(0.99),
+         (unsigned long long)sync.Percentile(0.999), (unsigned long long)sync.maxNs / 1000,
+         (double)syncCount / syncSeconds);
+  printf("  async: %d calls, %llu written, %llu dropped (ring full)\n", count,
+         (unsigned long long)asyncStats.logged, (unsigned long long)asyncStats.droppedFull);
+  Check("1M: the flusher keeps up (< 1% dropped)",
+        asyncStats.droppedFull * 100 < (uint64_t)count);
+  // Worst-case caller cost: the tail, not the median. The max is the
+  // scheduler's (caller preempted by the flusher on a busy core)
+  Check("async caller p99.9 <= 10 us", async.Percentile(0.999) <= 10000);
+  Logger::SetRateLimit(1000);
+}
+
+/*****************************************************************************
+ * Tracer
+ *****************************************************************************/
+static BENCH_NOINLINE void TracedWork(int i) {
+  TRACE_SCOPE("bench", "bench.traced");
+  ProbeWork(i);
+}
+
+static double TraceOverheadNs(int iterations) {
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < iterations; i++)
+    ProbeWork(i);
+  double bare = ElapsedNs(t0, iterations);
+  t0 = Clock::now();
+  for (int i = 0; i < iterations; i++)
+    TracedWork(i);
+  double traced = ElapsedNs(t0, iterations);
+  return traced > bare ? traced - bare : 0.0;
+}
+
+static void RunTracerBench(int iterations) {
+  printf("\nTracer\n");
+  namespace fs = std::filesystem;
+  const std::string path = (fs::temp_directory_path() / "ScriptBench.trace.json").string();
+
+  // Overhead per scope: disabled (atomic load) and recording
+  int runs = iterations * 10;
+  double disabledNs = TraceOverheadNs(runs);
+  int recorded = (int)std::min<size_t>((size_t)runs, Tracer::DEFAULT_CAPACITY / 2 - 1);
+  Tracer::Start(path);
+  double enabledNs = TraceOverheadNs(recorded);
+  Tracer::Stats overhead = Tracer::GetStats();
+  Clock::time_point t0 = Clock::now();
+  Tracer::Stop();
+  double stopMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+  Tracer::Stats written = Tracer::GetStats();
+  printf("  scope overhead: disabled %.2f ns, recording %.1f ns (%d scopes)\n", disabledNs,
+         enabledNs, recorded);
+  printf("  stop: %llu events -> %.1f KB JSON in %.1f ms\n",
+         (unsigned long long)overhead.events, (double)written.bytes / 1024.0, stopMs);
+  Check("disabled scope overhead < 20 ns", disabledNs < 20.0);
+  std::error_code ec;
+  fs::remove(path, ec);
+}
+
+/*****************************************************************************
+ * ModuleRegistry
+ *****************************************************************************/
+// Stand-in for a module's Initialize (GDI+, window class, preset file)
+static bool InitSlow() {
+  Clock::time_point until = Clock::now() + std::chrono::microseconds(300);
+  while (Clock::now() < until)
+    s_sink++;
+  return true;
+}
+
+static void RunModuleRegistryBench() {
+  printf("\nModuleRegistry\n");
+  using namespace ModuleRegistry;
+
+  // Launch cost: 8 registrations vs 8 eager initializations
+  const int modules = 8;
+  Reset();
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < modules; i++)
+    Register("Slow", InitSlow, nullptr);
+  double registerUs = ElapsedNs(t0, 1) / 1e3;
+  t0 = Clock::now();
+  for (int i = 0; i < modules; i++)
+    Ensure(i);
+  double eagerUs = ElapsedNs(t0, 1) / 1e3;
+  printf("  launch: register %d modules %.1f us, initialize all %.1f us\n", modules, registerUs,
+         eagerUs);
+  Check("registration is cheaper than initialization", registerUs * 10.0 < eagerUs);
+  Reset();
+}
+
+/*****************************************************************************
+ * Canvas
+ *****************************************************************************/
+// GridUI's grid window (7x7 @ 1.7, GridFixtures.h's ShowTestGrid)
+static GridPaint::Layout BenchGridLayout() {
+  NativeUI::GridConfig config;
+  config.gridWidth = 7;
+  config.gridHeight = 7;
+  config.cellSize = 68;
+  config.spacing = 1;
+  config.margin = 2;
+  return GridPaint::ComputeLayout(config);
+}
+
+// One hover frame as GridUI's DrawHoverLayer: the cell's hover rect copied
+// from the static layer, the glowing mark drawn over it
+static void RenderGridHover(Canvas::Surface &hover, const Canvas::Surface &grid,
+                            const GridPaint::Layout &layout, const GridPaint::Style &style,
+                            int cellX, int cellY) {
+  int left = layout.GridStartX() + cellX * layout.cellSize - 2;
+  int top = layout.GridStartY() + cellY * layout.cellSize - 2;
+  hover.Resize(layout.cellSize + 4, layout.cellSize + 4);
+  hover.CopyFrom(grid, left, top);
+  GridPaint::DrawCellMark(hover, layout, style, cellX, cellY, true, left, top);
+}
+
+// ControlUI's panels: 8 search results (Mode 1), 8 layer effects with 3
+// presets saved (Mode 2)
+static std::vector<ControlUI::EffectItem> BenchEffectItems() {
+  static const wchar_t *const NAMES[8][2] = {
+      {L"Gaussian Blur", L"Blur & Sharpen"}, {L"Drop Shadow", L"Perspective"},
+      {L"Glow", L"Stylize"},                 {L"Curves", L"Color Correction"},
+      {L"Levels", L"Color Correction"},      {L"Turbulent Displace", L"Distort"},
+      {L"Fast Box Blur", L"Blur & Sharpen"}, {L"Exposure", L"Color Correction"}};
+  std::vector<ControlUI::EffectItem> items(8);
+  for (int i = 0; i < 8; i++) {
+    ControlUI::EffectItem &item = items[i];
+    item = {};
+    wcsncpy(item.name, NAMES[i][0], 127);
+    wcsncpy(item.category, NAMES[i][1], 63);
+    item.index = i;
+  }
+  return items;
+}
+
+static void RunCanvasBench(int iterations) {
+  printf("\nCanvas\n");
+  using namespace Canvas;
+  namespace fs = std::filesystem;
+
+  // Grid: the static layer and a hover frame, through GridPaint
+  GridPaint::Layout layout = BenchGridLayout();
+  NativeUI::GridSettings settings;
+  settings.gridOpacity = 75;
+  settings.cellOpacity = 50;
+  GridPaint::Style style = GridPaint::MakeStyle(layout, settings);
+  Surface grid, hover;
+  grid.Resize(layout.windowWidth, layout.windowHeight);
+  GridPaint::DrawGrid(grid, layout, style);
+
+  // Control: both modes through ControlPaint (built-in text face; the
+  // preset / save icons are IconAtlas's, drawn by ControlUI after the blit)
+  std::vector<ControlUI::EffectItem> items = BenchEffectItems();
+  ControlPaint::PresetIcon presets[ControlPaint::PRESET_SLOT_COUNT] = {
+      ControlPaint::ICON_BLUR, ControlPaint::ICON_COLOR, ControlPaint::ICON_STAR,
+      ControlPaint::ICON_NONE, ControlPaint::ICON_NONE,  ControlPaint::ICON_NONE};
+  ControlPaint::PanelState search;
+  search.query = L"bl";
+  search.cursorPosition = 2;
+  search.cursorVisible = true;
+  search.searchResults = &items;
+  search.hoverIndex = 2;
+  search.scale = 1.5f;
+  ControlPaint::PanelState effects = search;
+  effects.mode = ControlUI::MODE_EFFECTS;
+  effects.query = L"";
+  effects.layerName = L"Shape Layer 1";
+  effects.labelColor = 8;
+  effects.layerEffects = &items;
+  effects.presetIcons = presets;
+  int listHeight = ControlPaint::MAX_VISIBLE_ITEMS * ControlPaint::ITEM_HEIGHT;
+  int searchWidth = (int)(ControlPaint::WINDOW_WIDTH * search.scale);
+  int searchHeight = (int)((ControlPaint::PADDING * 3 + ControlPaint::SEARCH_HEIGHT + listHeight) *
+                           search.scale);
+  int effectsHeight = (int)((ControlPaint::PADDING * 3 + ControlPaint::HEADER_HEIGHT + 4 +
+                             ControlPaint::PRESET_BAR_HEIGHT + ControlPaint::SEARCH_HEIGHT +
+                             listHeight) *
+                            effects.scale);
+  ControlPaint::IconSlot icons[ControlPaint::PRESET_SLOT_COUNT + 1];
+  Surface searchPanel, effectsPanel;
+  searchPanel.Resize(searchWidth, searchHeight);
+  ControlPaint::DrawSearchPanel(searchPanel, search);
+  effectsPanel.Resize(searchWidth, effectsHeight);
+  int iconCount = ControlPaint::DrawEffectsPanel(effectsPanel, effects, icons);
+
+  // PNG files: the grid with the center cell hovered, both control panels
+  Surface gridShot;
+  gridShot.Resize(grid.Width(), grid.Height());
+  gridShot.CopyFrom(grid, 0, 0);
+  GridPaint::DrawCellMark(gridShot, layout, style, 3, 3, true);
+  const fs::path dir = fs::temp_directory_path();
+  const std::string gridPath = (dir / "ScriptBench.grid.png").string();
+  const std::string searchPath = (dir / "ScriptBench.control.png").string();
+  const std::string effectsPath = (dir / "ScriptBench.effects.png").string();
+  if (WritePng(gridShot, gridPath) && WritePng(searchPanel, searchPath) &&
+      WritePng(effectsPanel, effectsPath))
+    printf("  wrote %s (%dx%d), %s (%dx%d), %s (%dx%d)\n", gridPath.c_str(), gridShot.Width(),
+           gridShot.Height(), searchPath.c_str(), searchPanel.Width(), searchPanel.Height(),
+           effectsPath.c_str(), effectsPanel.Width(), effectsPanel.Height());
+
+  int frames = std::max(20, std::min(2000, iterations / 500));
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < frames; i++) {
+    grid.Resize(layout.windowWidth, layout.windowHeight);
+    GridPaint::DrawGrid(grid, layout, GridPaint::MakeStyle(layout, settings));
+  }
+  double staticUs = ElapsedNs(t0, frames) / 1e3;
+  t0 = Clock::now();
+  for (int i = 0; i < frames; i++) {
+    int cell = i % (layout.gridWidth * layout.gridHeight);
+    RenderGridHover(hover, grid, layout, style, cell % layout.gridWidth,
+                    cell / layout.gridWidth);
+    s_sink += hover.At(1, 1);
+  }
+  double hoverUs = ElapsedNs(t0, frames) / 1e3;
+  printf("  grid 7x7 @ 1.7 (GridPaint, %dx%d) x%d: static layer %.1f us, hover frame %.2f us\n",
+         grid.Width(), grid.Height(), frames, staticUs, hoverUs);
+
+  t0 = Clock::now();
+  for (int i = 0; i < frames; i++) {
+    search.hoverIndex = i % ControlPaint::MAX_VISIBLE_ITEMS;
+    searchPanel.Resize(searchWidth, searchHeight);
+    ControlPaint::DrawSearchPanel(searchPanel, search);
+  }
+  double searchUs = ElapsedNs(t0, frames) / 1e3;
+  t0 = Clock::now();
+  for (int i = 0; i < frames; i++) {
+    effects.hoverIndex = i % ControlPaint::MAX_VISIBLE_ITEMS;
+    effectsPanel.Resize(searchWidth, effectsHeight);
+    iconCount = ControlPaint::DrawEffectsPanel(effectsPanel, effects, icons);
+  }
+  double effectsUs = ElapsedNs(t0, frames) / 1e3;
+  printf("  control @ 1.5 (ControlPaint) x%d: search %dx%d %.1f us, effects %dx%d %.1f us "
+         "(%d icon slots left to IconAtlas)\n",
+         frames, searchWidth, searchHeight, searchUs, searchWidth, effectsHeight, effectsUs,
+         iconCount);
+
+  // Span throughput: 1920x1080 half-transparent blend, SIMD vs scalar
+  Surface screen(1920, 1080);
+  int blends = std::max(5, std::min(200, iterations / 5000));
+  double ns[2] = {0, 0};
+  for (int pass = 0; pass < 2; pass++) {
+    SetSimdEnabled(pass == 0);
+    t0 = Clock::now();
+    for (int i = 0; i < blends; i++)
+      BlendRect(screen, 0, 0, 1920, 1080, Argb(128, (uint32_t)i, 60, 90));
+    ns[pass] = ElapsedNs(t0, blends);
+  }
+  SetSimdEnabled(true);
+  double mpix = 1920.0 * 1080.0 / 1e6;
+  printf("  blend 1920x1080 x%d: %s %.0f Mpx/s, scalar %.0f Mpx/s\n", blends,
+         HasSimd() ? "SSE2" : "(no SIMD)", mpix / (ns[0] / 1e9), mpix / (ns[1] / 1e9));
+  s_sink += screen.At(7, 7);
+}
+
+/*****************************************************************************
+ * Keyframe curve tessellation
+ *****************************************************************************/
+// The paint-time tessellation before the cache: 51 fixed samples for the
+// graph, 21 per preset thumbnail, fresh vectors every paint
+static size_t OldDragFrame(const CurveMath::Cubic &graph, const CurveMath::Cubic *presets,
+                           int presetCount) {
+  size_t points = 0;
+  auto sample = [&](const CurveMath::Cubic &c, int segments) {
+    std::vector<CurveMath::Point> out;
+    for (int i = 0; i <= segments; i++) {
+      float t = (float)i / segments, u = 1.0f - t;
+      float b0 = u * u * u, b1 = 3 * u * u * t, b2 = 3 * u * t * t, b3 = t * t * t;
+      out.push_back({b0 * c.x0 + b1 * c.x1 + b2 * c.x2 + b3 * c.x3,
+                     b0 * c.y0 + b1 * c.y1 + b2 * c.y2 + b3 * c.y3});
+    }
+    points += out.size();
+    s_sink += (size_t)out.back().x;
+  };
+  sample(graph, 50);
+  for (int i = 0; i < presetCount; i++)
+    sample(presets[i], 20);
+  return points;
+}
+
+static void RunCurveBench(int iterations) {
+  printf("\nKeyframe curve tessellation\n");
+  using namespace CurveMath;
+  const float tolerance = 0.25f;
+  Cubic ease = {0, 160, 105, 160, 151, 0, 260, 0};
+
+  // Drag frame: the graph curve changes every frame; with all 12 presets
+  // visible the thumbnails used to be re-tessellated too
+  Cubic presets[12];
+  for (int i = 0; i < 12; i++) {
+    float a = 0.1f + 0.07f * i, b = 0.9f - 0.05f * i;
+    presets[i] = {4, 40, 4 + a * 36, 40 - a * 36, 4 + b * 36, 40 - b * 36, 40, 4};
+  }
+  int frames = std::max(1000, std::min(200000, iterations / 5));
+  std::vector<Point> flat;
+  Clock::time_point t0 = Clock::now();
+  for (int i = 0; i < frames; i++) {
+    Cubic graph = ease;
+    graph.x1 += (i % 100) * 0.5f;
+    OldDragFrame(graph, presets, 12);
+  }
+  double oldNs = ElapsedNs(t0, frames);
+  t0 = Clock::now();
+  for (int i = 0; i < frames; i++) {
+    Cubic graph = ease;
+    graph.x1 += (i % 100) * 0.5f;
+    Flatten(graph, tolerance, flat); // Thumbnails: cached bitmaps, no tessellation
+    s_sink += (size_t)flat.back().x;
+  }
+  double newNs = ElapsedNs(t0, frames);
+  t0 = Clock::now();
+  for (int i = 0; i < frames; i++) {
+    for (int p = 0; p < 12; p++)
+      Flatten(presets[p], tolerance, flat);
+    s_sink += (size_t)flat.back().x;
+  }
+  double thumbsNs = ElapsedNs(t0, frames);
+  printf("  drag frame x%d (graph + 12 presets): before %.0f ns, after %.0f ns (%.1fx); "
+         "re-tessellating all 12 thumbnails (first paint / preset save) %.0f ns\n",
+         frames, oldNs, newNs, newNs > 0 ? oldNs / newNs : 0.0, thumbsNs);
+  Check("drag frame tessellation cheaper than before", newNs < oldNs);
+}
+
+/*****************************************************************************
+ * Keyframe timing curve math
+ *****************************************************************************/
+// The integration before CurveMath: Simpson in t over y(t), no x(t)
+static float OldIntegrate(const CurveMath::Cubic &c, float t) {
+  const int N = 100;
+  float h = t / N, sum = 0;
+  for (int i = 0; i <= N; i++) {
+    float ti = i * h, u = 1 - ti;
+    float v = 3 * u * u * ti * c.y1 + 3 * u * ti * ti * c.y2 + ti * ti * ti;
+    sum += (i == 0 || i == N) ? v : (i % 2 ? 4 * v : 2 * v);
+  }
+  return h / 3 * sum;
+}
+
+static void RunCurveMathBench(int iterations) {
+  printf("\nKeyframe timing curve (%s)\n", CurveMath::SimdName());
+  using namespace CurveMath;
+  Cubic inOut = TimingCubic(0.42f, 0.0f, 0.58f, 1.0f);
+  Cubic easeIn = TimingCubic(0.42f, 0.0f, 1.0f, 1.0f);
+
+  // Throughput: value at 1024 times, scalar vs SIMD; integral old vs exact
+  const int COUNT = 1024;
+  std::vector<float> xs(COUNT), ys(COUNT);
+  for (int i = 0; i < COUNT; i++)
+    xs[i] = (i + 0.5f) / COUNT;
+  int rounds = std::max(20, std::min(2000, iterations / 500));
+  double ns[2] = {0, 0};
+  for (int pass = 0; pass < 2; pass++) {
+    SetSimdEnabled(pass == 0);
+    Clock::time_point t0 = Clock::now();
+    for (int r = 0; r < rounds; r++)
+      ValueAtBatch(inOut, xs.data(), COUNT, ys.data());
+    ns[pass] = ElapsedNs(t0, rounds * COUNT);
+    s_sink += (size_t)(ys[COUNT / 2] * 100);
+  }
+  SetSimdEnabled(true);
+  int calls = std::max(1000, std::min(1000000, iterations));
+  Clock::time_point t0 = Clock::now();
+  float oldSum = 0;
+  for (int i = 0; i < calls; i++)
+    oldSum += OldIntegrate(easeIn, (i % 100) / 100.0f);
+  double oldNs = ElapsedNs(t0, calls);
+  t0 = Clock::now();
+  double newSum = 0;
+  for (int i = 0; i < calls; i++)
+    newSum += Integral(easeIn, (i % 100) / 100.0f);
+  double newNs = ElapsedNs(t0, calls);
+  s_sink += (size_t)(oldSum + newSum);
+  printf("  ease-in area over time: exact %.6f, old Simpson over t %.6f\n",
+         Integral(easeIn, 1.0f), OldIntegrate(easeIn, 1.0f));
+  printf("  value at time x%d: %s %.1f ns, scalar %.1f ns (%.1fx); integral: Simpson %.0f ns, "
+         "exact %.0f ns\n",
+         rounds * COUNT, SimdName(), ns[0], ns[1], ns[0] > 0 ? ns[1] / ns[0] : 0.0, oldNs, newNs);
+  Check("exact integral cheaper than 101-sample Simpson", newNs < oldNs);
+}
+
+/*****************************************************************************
+ * AE ease <-> timing curve conversion
+ *****************************************************************************/
+// The conversion before EaseModel: |average|, handle y clamped to
+// [-0.5, 1.5], slopes to +-100, speeds to >= 0 (float)
+static void OldRoundTrip(const EaseModel::Segment &seg, double &outSpeed, double &inSpeed) {
+  float average = (float)std::fabs(seg.delta / seg.duration);
+  float outInf = std::max(0.01f, std::min(100.0f, (float)seg.out.influence));
+  float inInf = std::max(0.01f, std::min(100.0f, (float)seg.in.influence));
+  float x1 = outInf / 100.0f, x2 = 1.0f - inInf / 100.0f;
+  float y1 = std::max(-0.5f, std::min(1.5f, x1 * ((float)seg.out.speed / average)));
+  float y2 = std::max(-0.5f, std::min(1.5f, 1.0f - (1.0f - x2) * ((float)seg.in.speed / average)));
+  float outSlope = std::max(-100.0f, std::min(100.0f, y1 / x1));
+  float inSlope = std::max(-100.0f, std::min(100.0f, (1.0f - y2) / (1.0f - x2)));
+  outSpeed = std::max(0.0f, std::min(10000000.0f, outSlope * average));
+  inSpeed = std::max(0.0f, std::min(10000000.0f, inSlope * average));
+}
+
+static void RunEaseModelBench(int iterations) {
+  printf("\nKeyframe ease conversion\n");
+  using namespace EaseModel;
+  uint32_t rng = 0x9E3779B9u;
+
+  // What the old conversion did to AE's eases after load -> apply
+  const int pairs = 100000;
+  int oldDrift = 0;
+  for (int n = 0; n < pairs; n++) {
+    Segment seg = RandomSegment(rng);
+    double oldOut = 0, oldIn = 0;
+    OldRoundTrip(seg, oldOut, oldIn);
+    double scale = std::fabs(seg.delta / seg.duration) + std::fabs(seg.out.speed) + std::fabs(seg.in.speed);
+    if (std::fabs(oldOut - seg.out.speed) > 0.01 * scale || std::fabs(oldIn - seg.in.speed) > 0.01 * scale)
+      oldDrift++;
+  }
+  printf("  old conversion: %d of %d pairs (%.1f%%) off by more than 1%% after load -> apply\n",
+         oldDrift, pairs, 100.0 * oldDrift / pairs);
+
+  // Throughput
+  const int COUNT = 4096;
+  std::vector<Segment> segs(COUNT);
+  std::vector<Handles> hs(COUNT);
+  for (int i = 0; i < COUNT; i++)
+    segs[i] = RandomSegment(rng);
+  int rounds = std::max(20, std::min(2000, iterations / 500));
+  Clock::time_point t0 = Clock::now();
+  for (int r = 0; r < rounds; r++)
+    for (int i = 0; i < COUNT; i++)
+      ToHandles(segs[i], hs[i]);
+  double toNs = ElapsedNs(t0, rounds * COUNT);
+  double sum = 0;
+  t0 = Clock::now();
+  for (int r = 0; r < rounds; r++)
+    for (int i = 0; i < COUNT; i++)
+      sum += FromHandles(segs[i], hs[i]).out.speed;
+  double fromNs = ElapsedNs(t0, rounds * COUNT);
+  t0 = Clock::now();
+  for (int r = 0; r < rounds; r++)
+    for (int i = 0; i < COUNT; i++) {
+      double o, in;
+      OldRoundTrip(segs[i], o, in);
+      sum += o;
+    }
+  double oldNs = ElapsedNs(t0, rounds * COUNT);
+  s_sink += (size_t)(sum != 0);
+  printf("  x%d: AE -> handles %.1f ns, handles -> AE %.1f ns (%.1f M round trips/s); old round "
+         "trip %.1f ns\n",
+         rounds * COUNT, toNs, fromNs, 1e3 / (toNs + fromNs), oldNs);
+}
+
+/*****************************************************************************
+ * Keyframe selection: every selected key, per-pair curves, one apply
+ *****************************************************************************/
+static void RunKeyframeSelectionBench(int iterations) {
+  printf("\nKeyframe selection\n");
+  using namespace KeyframeSelection;
+  uint32_t rng = 0x2545F491u;
+  EaseModel::Handles easeInOut = {0.42f, 0.0f, 0.58f, 1.0f};
+
+  // 10,000 selected keys through the mock host
+  const int KEYS = 10000;
+  MockKeyHost big = MakeKeyHost(KEYS, rng);
+  size_t keyTotal = 0;
+  for (const MockKeyProperty &prop : big.props)
+    keyTotal += prop.keys.size() > 1 ? prop.keys.size() : 0;
+  std::string bigInfo = MockKeyframeInfo(big);
+  Selection sel;
+  std::string payload;
+  int runs = std::max(3, std::min(50, iterations / 5000));
+  Clock::time_point t0 = Clock::now();
+  for (int r = 0; r < runs; r++)
+    Parse(bigInfo, sel);
+  double parseMs = ElapsedNs(t0, runs) / 1e6;
+  t0 = Clock::now();
+  for (int r = 0; r < runs; r++) {
+    sel.lastEdited = -1;
+    std::fill(sel.edited.begin(), sel.edited.end(), 0);
+    SetCurve(sel, (size_t)r % sel.PairCount(), easeInOut);
+    BuildApply(sel, payload);
+  }
+  double buildMs = ElapsedNs(t0, runs) / 1e6;
+  int written = MockApplyEase(big, payload);
+  printf("  %zu keys, %zu pairs, %zu properties: info %.0f KB parsed in %.2f ms, apply %.0f KB "
+         "built in %.2f ms\n",
+         keyTotal, sel.PairCount(), sel.props.size(), bigInfo.size() / 1024.0, parseMs,
+         payload.size() / 1024.0, buildMs);
+  printf("  host: 1 info + 1 apply call, 1 undo group, %d pairs written (one call per pair: "
+         "%.1f s at %.0f ms; before: 10 pairs of the first property viewed)\n",
+         written, sel.PairCount() * kHostRoundTripMs / 1000.0, kHostRoundTripMs);
+  Check("10,000 keys: parse + build under 50 ms", parseMs + buildMs < 50.0);
+}
+
+/*****************************************************************************
+ * ScriptLibrary: bytes sent and parse cost, inline scripts vs library calls
+ *****************************************************************************/
+static void RunScriptLibraryBench(int iterations) {
+  printf("\nScriptLibrary\n");
+  using namespace ScriptLibrary;
+  std::string bootstrap = BuildBootstrap();
+
+  // Bytes and tokens per call, inline body vs library call
+  struct Sample {
+    const char *fn, *args;
+  };
+  static const Sample kSamples[] = {
+      {"applyAnchor", "1,1,3,3,false,false"},
+      {"applyCustomAnchor", "0.5000,0.5000"},
+      {"deleteEffect", "0"},
+      {"addEffect", "'ADBE Gaussian Blur 2'"},
+      {"effectsList", ""},
+      {"keyframeInfo", ""},
+      {"applyEase", "''"},
+      {"textInfo", ""},
+      {"shapeInfo", ""},
+      {"panelSnapshot", ""},
+      {"align", "false,0"},
+      {"distribute", "false,true"},
+  };
+  printf("  %-16s %8s %7s %8s %7s\n", "function", "inlineB", "callB", "inlineT", "callT");
+  size_t inlineBytes = 0, callBytes = 0, inlineTokens = 0, callTokens = 0;
+  std::vector<std::string> inlineScripts, callScripts;
+  for (const Sample &sample : kSamples) {
+    std::string rendered = std::string(sample.fn) + "(" + sample.args + ")";
+    std::string inlineScript = BuildInline(sample.fn, sample.args);
+    std::string callScript = BuildCallScript(rendered.c_str());
+    LexResult inlineLex = MockLex(inlineScript), callLex = MockLex(callScript);
+    printf("  %-16s %8zu %7zu %8zu %7zu\n", sample.fn, inlineScript.size(), callScript.size(),
+           inlineLex.tokens, callLex.tokens);
+    inlineBytes += inlineScript.size();
+    callBytes += callScript.size();
+    inlineTokens += inlineLex.tokens;
+    callTokens += callLex.tokens;
+    inlineScripts.push_back(inlineScript);
+    callScripts.push_back(callScript);
+  }
+  LexResult bootLex = MockLex(bootstrap);
+
+  // Parse cost: lex time of the scripts sent per use (the bootstrap is sent
+  // once per engine)
+  int rounds = std::max(1, iterations / 1000);
+  auto t0 = Clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (const std::string &script : inlineScripts)
+      s_sink += MockLex(script).tokens;
+  }
+  double inlineNs = ElapsedNs(t0, rounds * (int)inlineScripts.size());
+  t0 = Clock::now();
+  for (int r = 0; r < rounds; r++) {
+    for (const std::string &script : callScripts)
+      s_sink += MockLex(script).tokens;
+  }
+  double callNs = ElapsedNs(t0, rounds * (int)callScripts.size());
+  printf("  per call: inline %zu B / %zu tokens / lex %.0f ns, library %zu B / %zu tokens / "
+         "lex %.0f ns (bootstrap once: %zu B, %zu tokens)\n",
+         inlineBytes / inlineScripts.size(), inlineTokens / inlineScripts.size(), inlineNs,
+         callBytes / callScripts.size(), callTokens / callScripts.size(), callNs,
+         bootstrap.size(), bootLex.tokens);
+  Check("library calls lex at least 10x faster than the inline scripts", callNs * 10 < inlineNs);
+
+  // The in-AE benchmark (ANCHORSNAP_SCRIPT_BENCH) against the mock host
+  MockLibraryHost host;
+  ScriptBatch::SetRunner(MockLibraryRunner, &host);
+  std::string report = ScriptLibrary::RunBenchmark(std::max(1, iterations / 10000));
+  printf("  RunBenchmark (mock host, lex only):\n");
+  for (size_t pos = 0; pos < report.size();) {
+    size_t end = report.find('\n', pos);
+    printf("    %s\n", report.substr(pos, end - pos).c_str());
+    pos = (end == std::string::npos) ? report.size() : end + 1;
+  }
+  ScriptBatch::SetRunner(nullptr, nullptr);
+}
+
+int main(int argc, char **argv) {
+  int iterations = (argc > 1) ? atoi(argv[1]) : 1000000;
+  if (iterations <= 0)
+    iterations = 1000000;
+
+  RunBenchmark(iterations);
+  RunScriptBatchBench(iterations);
+  RunWireBench(iterations);
+  RunCatalogBench(iterations);
+  RunFontCatalogBench(iterations);
+  RunEnumeratorBench(iterations);
+  RunPrefetchBench();
+  RunInputQueueBench(iterations);
+  RunProfilerBench(iterations);
+  RunLoggerBench(iterations);
+  RunTracerBench(iterations);
+  RunModuleRegistryBench();
+#ifdef _WIN32
+  s_failures += RunPaintBench(iterations);
+  s_failures += RunGridPaintBench(iterations);
+#endif
+  RunCanvasBench(iterations);
+#ifdef _WIN32
+  s_failures += RunIconAtlasBench(iterations);
+#endif
+  RunCurveBench(iterations);
+  RunCurveMathBench(iterations);
+  RunEaseModelBench(iterations);
+  RunKeyframeSelectionBench(iterations);
+  RunScriptLibraryBench(iterations);
+  return TestResult();
+}